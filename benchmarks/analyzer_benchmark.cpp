@@ -0,0 +1,115 @@
+/**
+ * @file analyzer_benchmark.cpp
+ * @brief End-to-end benchmarks for the analyzer
+ *
+ * A model is trained once on a generated corpus and reused by every
+ * benchmark in this file.
+ */
+
+#include "corpus.hpp"
+#include "blahajpi/analyzer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Number of documents used to train the shared model
+constexpr size_t TRAINING_DOCS = 5000;
+
+/**
+ * @brief Gets an analyzer with a trained model
+ * @return Shared analyzer, or nullptr if training failed
+ */
+blahajpi::Analyzer* trainedAnalyzer() {
+    static std::unique_ptr<blahajpi::Analyzer> analyzer = [] {
+        auto corpus = blahajpi::bench::makeCorpus(TRAINING_DOCS, 7);
+        std::string dataPath = blahajpi::bench::tempPath("analyzer_train.csv");
+        if (!blahajpi::bench::writeCsv(corpus, dataPath)) {
+            return std::unique_ptr<blahajpi::Analyzer>();
+        }
+
+        auto result = std::make_unique<blahajpi::Analyzer>();
+        result->setConfig("max-features", "5000");
+        result->setConfig("max-df", "0.9");
+        if (!result->trainModel(dataPath, blahajpi::bench::tempPath("analyzer_model"))) {
+            return std::unique_ptr<blahajpi::Analyzer>();
+        }
+        return result;
+    }();
+    return analyzer.get();
+}
+
+/**
+ * @brief Analyzes texts one call at a time
+ */
+void BM_Analyze(benchmark::State& state) {
+    auto* analyzer = trainedAnalyzer();
+    if (analyzer == nullptr) {
+        state.SkipWithError("Training the benchmark model failed");
+        return;
+    }
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (const auto& text : corpus.texts) {
+            benchmark::DoNotOptimize(analyzer->analyze(text));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_Analyze)->RangeMultiplier(10)->Range(10, 1000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Analyzes texts as one batch
+ */
+void BM_AnalyzeMultiple(benchmark::State& state) {
+    auto* analyzer = trainedAnalyzer();
+    if (analyzer == nullptr) {
+        state.SkipWithError("Training the benchmark model failed");
+        return;
+    }
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer->analyzeMultiple(corpus.texts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_AnalyzeMultiple)->RangeMultiplier(10)->Range(10, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Analyzes raid-like traffic with and without the result cache
+ *
+ * The batch repeats a few distinct messages with case and punctuation
+ * changes that preprocessing removes. The argument turns the cache on.
+ */
+void BM_AnalyzeRepeated(benchmark::State& state) {
+    auto* analyzer = trainedAnalyzer();
+    if (analyzer == nullptr) {
+        state.SkipWithError("Training the benchmark model failed");
+        return;
+    }
+    const auto& corpus = blahajpi::bench::cachedCorpus(20);
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string text = corpus.texts[i % corpus.texts.size()];
+        texts.push_back(i % 2 ? text + "!!!" : text);
+    }
+
+    analyzer->setConfig("result-cache-size", state.range(0) ? "10000" : "0");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer->analyzeMultiple(texts));
+    }
+    analyzer->setConfig("result-cache-size", "0");
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(texts.size()));
+}
+BENCHMARK(BM_AnalyzeRepeated)->Arg(0)->Arg(1)->ArgName("cache")->Unit(benchmark::kMillisecond);
+
+} // namespace
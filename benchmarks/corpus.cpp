@@ -0,0 +1,164 @@
+/**
+ * @file corpus.cpp
+ * @brief Implementation of the synthetic benchmark corpora
+ */
+
+#include "corpus.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+
+namespace blahajpi {
+namespace bench {
+
+namespace {
+
+/// Number of distinct ordinary words
+constexpr size_t VOCABULARY_SIZE = 5000;
+
+/// Words that make a text lean harmful
+const std::vector<std::string> HARMFUL_WORDS = {
+    "awful", "hate", "gross", "stupid", "disgusting", "pathetic",
+    "worthless", "idiot", "loser", "trash", "ugly", "horrible"
+};
+
+/// Syllables combined into pseudo-words
+const std::vector<std::string> SYLLABLES = {
+    "ba", "ko", "ri", "shu", "ta", "mel", "don", "li", "ve", "sa",
+    "qua", "ne", "dor", "pi", "gu", "fen", "lo", "ha", "jo", "wen"
+};
+
+/**
+ * @brief Builds a deterministic vocabulary of pseudo-words
+ * @return Words ordered from most to least frequent
+ */
+std::vector<std::string> makeVocabulary() {
+    std::vector<std::string> words;
+    words.reserve(VOCABULARY_SIZE);
+    for (size_t i = 0; words.size() < VOCABULARY_SIZE; ++i) {
+        std::string word;
+        size_t value = i;
+        do {
+            word += SYLLABLES[value % SYLLABLES.size()];
+            value /= SYLLABLES.size();
+        } while (value > 0);
+        words.push_back(word);
+    }
+    return words;
+}
+
+} // namespace
+
+Corpus makeCorpus(size_t size, unsigned int seed) {
+    static const std::vector<std::string> vocabulary = makeVocabulary();
+
+    // Zipf-like word ranks
+    std::vector<double> weights(vocabulary.size());
+    for (size_t r = 0; r < weights.size(); ++r) {
+        weights[r] = 1.0 / static_cast<double>(r + 1);
+    }
+
+    std::mt19937 rng(seed);
+    std::discrete_distribution<size_t> wordDist(weights.begin(), weights.end());
+    std::uniform_int_distribution<size_t> lengthDist(6, 30);
+    std::uniform_int_distribution<size_t> harmfulDist(0, HARMFUL_WORDS.size() - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    Corpus corpus;
+    corpus.texts.reserve(size);
+    corpus.labels.reserve(size);
+
+    for (size_t i = 0; i < size; ++i) {
+        bool harmful = percent(rng) < 40;
+        size_t length = lengthDist(rng);
+
+        std::string text;
+        if (percent(rng) < 30) {
+            text += "@user" + std::to_string(wordDist(rng)) + " ";
+        }
+        for (size_t w = 0; w < length; ++w) {
+            int roll = percent(rng);
+            if (harmful && roll < 15) {
+                text += HARMFUL_WORDS[harmfulDist(rng)];
+            } else if (roll < 2) {
+                text += "sooooo";
+            } else if (roll < 4) {
+                text += std::to_string(roll * 7);
+            } else if (roll < 7) {
+                text += "don't";
+            } else {
+                const std::string& word = vocabulary[wordDist(rng)];
+                text += (roll < 10) ? "#" + word : word;
+            }
+            text += (roll % 11 == 0) ? "! " : " ";
+        }
+        if (percent(rng) < 20) {
+            text += "https://example.com/" + std::to_string(i);
+        }
+
+        corpus.texts.push_back(std::move(text));
+        corpus.labels.push_back(harmful ? 4 : 0);
+    }
+
+    return corpus;
+}
+
+const Corpus& cachedCorpus(size_t size) {
+    static std::map<size_t, Corpus> cache;
+    auto it = cache.find(size);
+    if (it == cache.end()) {
+        it = cache.emplace(size, makeCorpus(size)).first;
+    }
+    return it->second;
+}
+
+bool writeCsv(const Corpus& corpus, const std::string& filePath) {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "label,text\n";
+    for (size_t i = 0; i < corpus.texts.size(); ++i) {
+        std::string escaped;
+        for (char c : corpus.texts[i]) {
+            escaped += c;
+            if (c == '"') {
+                escaped += '"';
+            }
+        }
+        file << corpus.labels[i] << ",\"" << escaped << "\"\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+std::string tempPath(const std::string& name) {
+    auto dir = std::filesystem::temp_directory_path() / "blahajpi_benchmarks";
+    std::filesystem::create_directories(dir);
+    return (dir / name).string();
+}
+
+size_t maxCorpusSize() {
+    const char* value = std::getenv("BLAHAJPI_BENCH_MAX_DOCS");
+    if (value != nullptr) {
+        long parsed = std::strtol(value, nullptr, 10);
+        if (parsed > 0) {
+            return static_cast<size_t>(parsed);
+        }
+    }
+    return 10000;
+}
+
+size_t totalBytes(const std::vector<std::string>& texts) {
+    size_t bytes = 0;
+    for (const auto& text : texts) {
+        bytes += text.size();
+    }
+    return bytes;
+}
+
+} // namespace bench
+} // namespace blahajpi
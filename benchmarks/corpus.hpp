@@ -0,0 +1,81 @@
+/**
+ * @file corpus.hpp
+ * @brief Synthetic tweet corpora for the benchmark suite
+ *
+ * Benchmarks run on generated data so results are reproducible and do not
+ * depend on a dataset being present. Word frequencies follow a Zipf-like
+ * distribution and texts include the URLs, mentions, hashtags, numbers
+ * and elongated words the preprocessing pipeline has to handle.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace blahajpi {
+namespace bench {
+
+/**
+ * @brief Labeled synthetic texts
+ */
+struct Corpus {
+    std::vector<std::string> texts;  ///< Tweet-like texts
+    std::vector<int> labels;         ///< 0 = safe, 4 = harmful
+};
+
+/**
+ * @brief Generates a labeled corpus
+ *
+ * The same size and seed always produce the same corpus. Harmful texts
+ * draw extra words from a small harmful lexicon so models have a signal
+ * to learn.
+ *
+ * @param size Number of texts
+ * @param seed Random seed
+ * @return Generated corpus
+ */
+Corpus makeCorpus(size_t size, unsigned int seed = 42);
+
+/**
+ * @brief Gets a corpus generated once per size with the default seed
+ * @param size Number of texts
+ * @return Shared corpus (valid for the lifetime of the program)
+ */
+const Corpus& cachedCorpus(size_t size);
+
+/**
+ * @brief Writes a corpus as a CSV file with "label" and "text" columns
+ * @param corpus Corpus to write
+ * @param filePath Destination path
+ * @return True if the file was written
+ */
+bool writeCsv(const Corpus& corpus, const std::string& filePath);
+
+/**
+ * @brief Gets a path for a temporary benchmark file
+ * @param name File name
+ * @return Path inside the system temporary directory
+ */
+std::string tempPath(const std::string& name);
+
+/**
+ * @brief Gets the largest corpus size to benchmark
+ *
+ * Read from the BLAHAJPI_BENCH_MAX_DOCS environment variable so larger
+ * runs need no rebuild (default 10000).
+ *
+ * @return Maximum number of documents
+ */
+size_t maxCorpusSize();
+
+/**
+ * @brief Gets the total size of a set of texts
+ * @param texts Texts to measure
+ * @return Number of bytes
+ */
+size_t totalBytes(const std::vector<std::string>& texts);
+
+} // namespace bench
+} // namespace blahajpi
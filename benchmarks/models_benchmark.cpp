@@ -0,0 +1,174 @@
+/**
+ * @file models_benchmark.cpp
+ * @brief Benchmarks for classifier training and prediction
+ */
+
+#include "corpus.hpp"
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/models/mlp_model.hpp"
+#include "blahajpi/models/sgd.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <map>
+#include <vector>
+
+namespace {
+
+using blahajpi::models::LinearModel;
+using blahajpi::models::MlpModel;
+using blahajpi::models::SGDClassifier;
+using blahajpi::preprocessing::SparseVector;
+using blahajpi::preprocessing::TfidfVectorizer;
+
+/// Vocabulary size used by the model benchmarks
+constexpr size_t MAX_FEATURES = 2000;
+
+/// Largest corpus used with dense rows (size x MAX_FEATURES doubles)
+constexpr size_t MAX_DENSE_DOCS = 5000;
+
+/**
+ * @brief Vectorized corpus shared by the model benchmarks
+ */
+struct Features {
+    std::vector<std::vector<double>> dense;  ///< Dense TF-IDF rows
+    std::vector<SparseVector> sparse;        ///< Sparse TF-IDF rows
+    std::vector<int> labels;                 ///< Labels of each row
+    size_t numFeatures = 0;                  ///< Vocabulary size
+};
+
+/**
+ * @brief Vectorizes the cached corpus of a given size once
+ * @param size Number of documents
+ * @return Shared features
+ */
+const Features& featuresOf(size_t size) {
+    static std::map<size_t, Features> cache;
+    auto it = cache.find(size);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    const auto& corpus = blahajpi::bench::cachedCorpus(size);
+    TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+    vectorizer.fit(corpus.texts);
+
+    Features features;
+    features.sparse = vectorizer.transformSparse(corpus.texts);
+    if (size <= MAX_DENSE_DOCS) {
+        features.dense = vectorizer.transform(corpus.texts);
+    }
+    features.labels = corpus.labels;
+    features.numFeatures = vectorizer.getNumFeatures();
+    return cache.emplace(size, std::move(features)).first->second;
+}
+
+/**
+ * @brief Gets the largest corpus size used with dense rows
+ */
+int64_t maxDenseSize() {
+    return static_cast<int64_t>(std::min(blahajpi::bench::maxCorpusSize(), MAX_DENSE_DOCS));
+}
+
+/**
+ * @brief Trains the dense SGD classifier
+ */
+void BM_SgdFit(benchmark::State& state) {
+    const auto& features = featuresOf(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        SGDClassifier model("log", 0.0001, 5);
+        model.fit(features.dense, features.labels);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_SgdFit)->RangeMultiplier(10)->Range(100, maxDenseSize())->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Predicts with the dense SGD classifier
+ */
+void BM_SgdPredictProbability(benchmark::State& state) {
+    const auto& features = featuresOf(static_cast<size_t>(state.range(0)));
+    SGDClassifier model("log", 0.0001, 5);
+    model.fit(features.dense, features.labels);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(model.predictProbability(features.dense));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_SgdPredictProbability)->RangeMultiplier(10)->Range(100, maxDenseSize())->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Trains the sparse linear model
+ */
+void BM_LinearModelFit(benchmark::State& state) {
+    const auto& features = featuresOf(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        LinearModel model("log", 0.0001, 5);
+        model.fit(features.sparse, features.labels, features.numFeatures);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_LinearModelFit)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Trains the sparse linear model in mini-batches across threads
+ */
+void BM_LinearModelFitThreads(benchmark::State& state) {
+    const auto& features = featuresOf(blahajpi::bench::maxCorpusSize());
+
+    for (auto _ : state) {
+        LinearModel model("log", 0.0001, 5);
+        model.setTrainingOptions({.batchSize = 512, .threads = static_cast<size_t>(state.range(0))});
+        model.fit(features.sparse, features.labels, features.numFeatures);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_LinearModelFitThreads)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Predicts with the sparse linear model
+ */
+void BM_LinearModelPredictProbability(benchmark::State& state) {
+    const auto& features = featuresOf(static_cast<size_t>(state.range(0)));
+    LinearModel model("log", 0.0001, 5);
+    model.fit(features.sparse, features.labels, features.numFeatures);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(model.predictProbability(features.sparse));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_LinearModelPredictProbability)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scores with the sparse-input network in double and float32 precision
+ */
+void BM_MlpModelDecision(benchmark::State& state) {
+    const auto& features = featuresOf(blahajpi::bench::maxCorpusSize());
+    MlpModel model(2, 64, 1, 0.05);
+    model.fit(features.sparse, features.labels, features.numFeatures);
+    model.setFloat32(state.range(0) != 0);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(model.decisionFunction(features.sparse));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.labels.size()));
+}
+BENCHMARK(BM_MlpModelDecision)->Arg(0)->Arg(1)->ArgName("float32")->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,101 @@
+/**
+ * @file preprocessing_benchmark.cpp
+ * @brief Benchmarks for the text preprocessing pipeline
+ */
+
+#include "corpus.hpp"
+#include "blahajpi/preprocessing/text_processor.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+using blahajpi::preprocessing::TextProcessor;
+
+/**
+ * @brief Preprocesses a corpus with the allocating interface
+ */
+void BM_Preprocess(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    TextProcessor processor;
+
+    for (auto _ : state) {
+        for (const auto& text : corpus.texts) {
+            benchmark::DoNotOptimize(processor.preprocess(text));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(corpus.texts)));
+}
+BENCHMARK(BM_Preprocess)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Preprocesses a corpus into a reused output buffer
+ */
+void BM_PreprocessInto(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    TextProcessor processor;
+    std::string output;
+
+    for (auto _ : state) {
+        for (const auto& text : corpus.texts) {
+            processor.preprocessInto(text, output);
+            benchmark::DoNotOptimize(output.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(corpus.texts)));
+}
+BENCHMARK(BM_PreprocessInto)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Runs one character-level step over long-form posts
+ *
+ * Joins corpus texts into documents of about 4 KB, the size where the
+ * byte-class kernels dominate the per-call overhead.
+ */
+void BM_CharacterStep(benchmark::State& state, const std::string& step) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(1000);
+    std::vector<std::string> documents(1);
+    for (const auto& text : corpus.texts) {
+        if (documents.back().size() >= 4096) {
+            documents.emplace_back();
+        }
+        documents.back().append(text).push_back(' ');
+    }
+    TextProcessor processor;
+    const std::vector<std::string> steps = {step};
+
+    for (auto _ : state) {
+        for (const auto& document : documents) {
+            benchmark::DoNotOptimize(processor.preprocess(document, steps));
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(documents)));
+}
+BENCHMARK_CAPTURE(BM_CharacterStep, lowercase, std::string("lowercase"));
+BENCHMARK_CAPTURE(BM_CharacterStep, remove_punctuation, std::string("remove_punctuation"));
+BENCHMARK_CAPTURE(BM_CharacterStep, remove_numbers, std::string("remove_numbers"));
+BENCHMARK_CAPTURE(BM_CharacterStep, remove_non_ascii, std::string("remove_non_ascii"));
+BENCHMARK_CAPTURE(BM_CharacterStep, normalize_whitespace, std::string("normalize_whitespace"));
+BENCHMARK_CAPTURE(BM_CharacterStep, normalize_repeated_chars, std::string("normalize_repeated_chars"));
+
+/**
+ * @brief Constructs a processor with the built-in word lists
+ */
+void BM_ConstructProcessor(benchmark::State& state) {
+    for (auto _ : state) {
+        TextProcessor processor;
+        benchmark::DoNotOptimize(&processor);
+    }
+}
+BENCHMARK(BM_ConstructProcessor);
+
+} // namespace
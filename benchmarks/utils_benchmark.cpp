@@ -0,0 +1,137 @@
+/**
+ * @file utils_benchmark.cpp
+ * @brief Benchmarks for dataset loading, metrics and word clouds
+ */
+
+#include "corpus.hpp"
+#include "blahajpi/evaluation/metrics.hpp"
+#include "blahajpi/utils/dataset.hpp"
+#include "blahajpi/utils/word_cloud.hpp"
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Writes the cached corpus of a given size to a CSV file once
+ * @param size Number of documents
+ * @return Path of the CSV file
+ */
+const std::string& csvOf(size_t size) {
+    static std::map<size_t, std::string> paths;
+    auto it = paths.find(size);
+    if (it == paths.end()) {
+        std::string path = blahajpi::bench::tempPath("dataset_" + std::to_string(size) + ".csv");
+        blahajpi::bench::writeCsv(blahajpi::bench::cachedCorpus(size), path);
+        it = paths.emplace(size, path).first;
+    }
+    return it->second;
+}
+
+/**
+ * @brief Loads a CSV dataset into memory
+ */
+void BM_DatasetLoadCsv(benchmark::State& state) {
+    const std::string& path = csvOf(static_cast<size_t>(state.range(0)));
+    auto bytes = static_cast<int64_t>(std::filesystem::file_size(path));
+
+    for (auto _ : state) {
+        blahajpi::utils::Dataset dataset;
+        if (!dataset.loadFromFile(path)) {
+            state.SkipWithError("Loading the benchmark dataset failed");
+            break;
+        }
+        benchmark::DoNotOptimize(dataset.size());
+    }
+
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_DatasetLoadCsv)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize());
+
+/**
+ * @brief Computes the area under the ROC curve
+ */
+void BM_AreaUnderRoc(benchmark::State& state) {
+    auto size = static_cast<size_t>(state.range(0));
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> noise(0.0, 1.0);
+
+    std::vector<int> yTrue(size);
+    std::vector<double> scores(size);
+    for (size_t i = 0; i < size; ++i) {
+        yTrue[i] = (i % 5 < 2) ? 4 : 0;
+        scores[i] = noise(rng) + (yTrue[i] != 0 ? 0.3 : 0.0);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(blahajpi::evaluation::Metrics::areaUnderROC(yTrue, scores));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_AreaUnderRoc)->RangeMultiplier(10)->Range(1000, 100000);
+
+/**
+ * @brief Computes AUC, precision-recall points and the best threshold in one pass
+ */
+void BM_Evaluate(benchmark::State& state) {
+    auto size = static_cast<size_t>(state.range(0));
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> noise(0.0, 1.0);
+
+    std::vector<int> yTrue(size);
+    std::vector<double> scores(size);
+    for (size_t i = 0; i < size; ++i) {
+        yTrue[i] = (i % 5 < 2) ? 4 : 0;
+        scores[i] = noise(rng) + (yTrue[i] != 0 ? 0.3 : 0.0);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(blahajpi::evaluation::Metrics::evaluate(yTrue, scores));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+BENCHMARK(BM_Evaluate)->RangeMultiplier(10)->Range(1000, 1000000);
+
+/**
+ * @brief Builds a word cloud, dominated by word frequency counting
+ */
+void BM_WordCloud(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    blahajpi::utils::WordCloud cloud;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cloud.generateWordCloud(corpus.texts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(corpus.texts)));
+}
+BENCHMARK(BM_WordCloud)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Counts cloud words in sharded passes; the second argument is the thread count
+ */
+void BM_WordCountSharded(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    blahajpi::utils::WordCloud cloud;
+    size_t threads = static_cast<size_t>(state.range(1));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cloud.countWords(std::span{corpus.texts}, threads).top(50));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(corpus.texts)));
+}
+BENCHMARK(BM_WordCountSharded)->ArgsProduct({{static_cast<int64_t>(blahajpi::bench::maxCorpusSize())}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
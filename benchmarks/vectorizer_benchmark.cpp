@@ -0,0 +1,123 @@
+/**
+ * @file vectorizer_benchmark.cpp
+ * @brief Benchmarks for tokenization and TF-IDF / hashing vectorization
+ */
+
+#include "corpus.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+using blahajpi::preprocessing::HashingVectorizer;
+using blahajpi::preprocessing::TfidfVectorizer;
+
+/// Vocabulary size used by the TF-IDF benchmarks
+constexpr size_t MAX_FEATURES = 5000;
+
+/**
+ * @brief Splits a corpus into words and n-grams
+ */
+void BM_Tokenize(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+
+    for (auto _ : state) {
+        for (const auto& text : corpus.texts) {
+            benchmark::DoNotOptimize(vectorizer.tokenize(text));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blahajpi::bench::totalBytes(corpus.texts)));
+}
+BENCHMARK(BM_Tokenize)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize());
+
+/**
+ * @brief Builds a TF-IDF vocabulary
+ */
+void BM_TfidfFit(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+        vectorizer.fit(corpus.texts);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_TfidfFit)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Builds a TF-IDF vocabulary on several fit threads
+ */
+void BM_TfidfFitThreads(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(blahajpi::bench::maxCorpusSize());
+
+    for (auto _ : state) {
+        TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+        vectorizer.setFitThreads(static_cast<size_t>(state.range(0)));
+        vectorizer.fit(corpus.texts);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_TfidfFitThreads)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * @brief Transforms a corpus into dense TF-IDF rows
+ */
+void BM_TfidfTransform(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+    vectorizer.fit(corpus.texts);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vectorizer.transform(corpus.texts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_TfidfTransform)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Transforms a corpus into sparse TF-IDF rows
+ */
+void BM_TfidfTransformSparse(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+    TfidfVectorizer vectorizer(true, 0.9, MAX_FEATURES);
+    vectorizer.fit(corpus.texts);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vectorizer.transformSparse(corpus.texts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_TfidfTransformSparse)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Fits and applies the hashing vectorizer in sparse form
+ */
+void BM_HashingFitTransformSparse(benchmark::State& state) {
+    const auto& corpus = blahajpi::bench::cachedCorpus(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        HashingVectorizer vectorizer(true, 18);
+        vectorizer.fit(corpus.texts);
+        benchmark::DoNotOptimize(vectorizer.transformSparse(corpus.texts));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(corpus.texts.size()));
+}
+BENCHMARK(BM_HashingFitTransformSparse)->RangeMultiplier(10)->Range(100, blahajpi::bench::maxCorpusSize())
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,209 @@
+"""
+blahajpi.py - Python binding for the Blahaj PI C API
+
+Loads the shared libblahajpi through ctypes and wraps the functions
+declared in lib/include/blahajpi/c_api.h. A batch crosses the boundary
+as one UTF-8 buffer plus an offsets array, and results are written
+straight into caller-owned arrays (array.array, numpy arrays or any
+other writable buffer), so scoring allocates nothing per message.
+ctypes releases the GIL for the duration of each call, letting other
+Python threads run while a batch is scored.
+
+Quick usage example:
+    import blahajpi
+    analyzer = blahajpi.Analyzer()
+    analyzer.load_model("models/twitter")
+    scores, probabilities, labels = analyzer.score_batch(["some text", "another"])
+
+The library is looked up in BLAHAJPI_LIBRARY first, then on the
+system library path.
+"""
+
+import ctypes
+import ctypes.util
+import os
+from array import array
+
+ABI_VERSION = 1
+
+OK = 0
+INVALID_ARGUMENT = 1
+NO_MODEL = 2
+FAILED = 3
+
+
+class BlahajError(RuntimeError):
+    """Error reported by the C API"""
+
+    def __init__(self, status, message):
+        super().__init__(message)
+        self.status = status
+
+
+def _load_library():
+    """Load libblahajpi and declare the function signatures"""
+    path = os.environ.get("BLAHAJPI_LIBRARY") or ctypes.util.find_library("blahajpi")
+    if not path:
+        raise OSError("libblahajpi not found; set BLAHAJPI_LIBRARY to its path")
+    lib = ctypes.CDLL(path)
+
+    lib.bpi_abi_version.restype = ctypes.c_uint32
+    lib.bpi_abi_version.argtypes = []
+    lib.bpi_create.restype = ctypes.c_void_p
+    lib.bpi_create.argtypes = [ctypes.c_char_p]
+    lib.bpi_destroy.restype = None
+    lib.bpi_destroy.argtypes = [ctypes.c_void_p]
+    lib.bpi_set_config.restype = ctypes.c_int
+    lib.bpi_set_config.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p]
+    lib.bpi_load_model.restype = ctypes.c_int
+    lib.bpi_load_model.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+    lib.bpi_model_version.restype = ctypes.c_uint64
+    lib.bpi_model_version.argtypes = [ctypes.c_void_p]
+    lib.bpi_score_batch.restype = ctypes.c_int
+    lib.bpi_score_batch.argtypes = [
+        ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t,
+        ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p
+    ]
+    lib.bpi_last_error.restype = ctypes.c_char_p
+    lib.bpi_last_error.argtypes = []
+
+    if lib.bpi_abi_version() < ABI_VERSION:
+        raise OSError(f"{path} provides ABI version {lib.bpi_abi_version()}, need {ABI_VERSION}")
+    return lib
+
+
+_lib = None
+
+
+def _library():
+    """Get the loaded library, loading it on first use"""
+    global _lib
+    if _lib is None:
+        _lib = _load_library()
+    return _lib
+
+
+def _check(status):
+    """Raise the thread's last error for a failed status"""
+    if status != OK:
+        raise BlahajError(status, _library().bpi_last_error().decode("utf-8", "replace"))
+
+
+def _pointer(buffer, itemsize, count, name, writable):
+    """
+    Get an argument pointing at a contiguous buffer without copying it
+
+    Accepts anything with the buffer protocol whose items are itemsize
+    bytes, such as array.array, bytearray, memoryview or numpy arrays.
+    Inputs may also be bytes; other read-only inputs are copied once.
+    """
+    if buffer is None:
+        return None
+    view = memoryview(buffer)
+    if not view.c_contiguous or view.itemsize != itemsize or view.nbytes < itemsize * count:
+        raise ValueError(f"{name} must be a contiguous buffer of at least {count} {itemsize}-byte items")
+    if isinstance(buffer, bytes) and not writable:
+        return buffer
+    if view.readonly:
+        if writable:
+            raise ValueError(f"{name} must be writable")
+        return (ctypes.c_char * view.nbytes).from_buffer_copy(view)
+    return (ctypes.c_char * view.nbytes).from_buffer(view)
+
+
+def pack(texts):
+    """
+    Join texts into one UTF-8 buffer and its offsets
+
+    @param texts Iterable of str or bytes
+    @return (data, offsets) where text i is data[offsets[i]:offsets[i + 1]]
+    """
+    encoded = [t.encode("utf-8") if isinstance(t, str) else bytes(t) for t in texts]
+    offsets = array("Q", [0])
+    total = 0
+    for text in encoded:
+        total += len(text)
+        offsets.append(total)
+    return b"".join(encoded), offsets
+
+
+class Analyzer:
+    """Handle to one analyzer in the C library"""
+
+    def __init__(self, config_path=None):
+        self._handle = None
+        lib = _library()
+        self._handle = lib.bpi_create(config_path.encode() if config_path else None)
+        if not self._handle:
+            raise BlahajError(FAILED, lib.bpi_last_error().decode("utf-8", "replace"))
+
+    def close(self):
+        """Destroy the analyzer; further calls fail"""
+        if self._handle:
+            _library().bpi_destroy(self._handle)
+            self._handle = None
+
+    def __del__(self):
+        self.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def set_config(self, key, value):
+        """Set one configuration value"""
+        _check(_library().bpi_set_config(self._handle, str(key).encode(), str(value).encode()))
+
+    def load_model(self, model_path):
+        """Load a trained model, keeping the old one on failure"""
+        _check(_library().bpi_load_model(self._handle, os.fsencode(model_path)))
+
+    @property
+    def model_version(self):
+        """Version of the model scores come from (0 before any is loaded)"""
+        return _library().bpi_model_version(self._handle)
+
+    def score_buffer(self, data, offsets, count, scores=None, probabilities=None, labels=None):
+        """
+        Score texts packed in one buffer into caller-owned arrays
+
+        Nothing is copied or allocated per text: data, offsets and the
+        outputs are passed to the library as they are.
+
+        @param data UTF-8 bytes of all texts (bytes, bytearray, ...)
+        @param offsets count + 1 unsigned 64-bit offsets into data
+        @param count Number of texts
+        @param scores Writable buffer of count doubles, or None
+        @param probabilities Writable buffer of count doubles, or None
+        @param labels Writable buffer of count bytes, or None
+        """
+        if count and len(memoryview(offsets)) < count + 1:
+            raise ValueError(f"offsets must hold {count + 1} entries")
+        if count and memoryview(offsets)[count] > memoryview(data).nbytes:
+            raise ValueError("offsets run past the end of data")
+        status = _library().bpi_score_batch(
+            self._handle,
+            _pointer(data, 1, 0, "data", False),
+            _pointer(offsets, 8, count + 1, "offsets", False),
+            count,
+            _pointer(scores, 8, count, "scores", True),
+            _pointer(probabilities, 8, count, "probabilities", True),
+            _pointer(labels, 1, count, "labels", True))
+        _check(status)
+
+    def score_batch(self, texts):
+        """
+        Score a list of texts
+
+        @param texts Iterable of str or bytes
+        @return (scores, probabilities, labels) as array('d'), array('d') and array('B')
+        """
+        data, offsets = pack(texts)
+        count = len(offsets) - 1
+        scores = array("d", bytes(8 * count))
+        probabilities = array("d", bytes(8 * count))
+        labels = array("B", bytes(count))
+        self.score_buffer(data, offsets, count, scores, probabilities, labels)
+        return scores, probabilities, labels
@@ -0,0 +1,126 @@
+/**
+ * @file bounded_queue.hpp
+ * @brief Blocking FIFO with a fixed capacity for CLI pipelines
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace bpicli {
+
+/**
+ * @brief Bounded FIFO between producer and consumer threads
+ *
+ * Producers block while the queue is full, which is what keeps every
+ * stage of a pipeline within its configured depth.
+ *
+ * @tparam T Movable item type
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Maximum queued items (at least 1)
+     */
+    explicit BoundedQueue(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+    /**
+     * @brief Adds an item, blocking while the queue is full
+     * @param item Item to add
+     * @return False if the queue was closed
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Takes the next item, blocking while the queue is empty
+     * @param item Receives the item
+     * @return False once the queue is closed and empty
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Takes the next batch of items
+     *
+     * Waits for a first item, then up to maxWait for the batch to fill.
+     *
+     * @param batch Output items (cleared first)
+     * @param maxBatch Maximum number of items
+     * @param maxWait Longest time to wait after the first item
+     * @return False once the queue is closed and empty
+     */
+    bool popBatch(std::vector<T>& batch, size_t maxBatch, std::chrono::milliseconds maxWait) {
+        batch.clear();
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + maxWait;
+        notEmpty.wait_until(lock, deadline, [&] { return closed || items.size() >= maxBatch; });
+
+        size_t count = std::min(maxBatch, items.size());
+        for (size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(items.front()));
+            items.pop_front();
+        }
+        notFull.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief Wakes all waiters; queued items are still handed out
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    /**
+     * @brief Checks whether close() has been called
+     * @return True once the queue is closed
+     */
+    bool isClosed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed;
+    }
+
+private:
+    size_t capacity;                      ///< Maximum queued items
+    std::deque<T> items;                  ///< Queued items
+    bool closed = false;                  ///< Whether producers have finished or the pipeline stopped
+    mutable std::mutex mutex;             ///< Guards items and closed
+    std::condition_variable notEmpty;     ///< Signaled when items arrive
+    std::condition_variable notFull;      ///< Signaled when space frees up
+};
+
+} // namespace bpicli
@@ -43,6 +43,14 @@ int handleAnalyze(const std::vector<std::string>& args, blahajpi::Analyzer& anal
  */
 int handleBatch(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
 
+/**
+ * @brief Handle the compact command
+ * @param args Command arguments
+ * @param analyzer Analyzer instance
+ * @return Exit code
+ */
+int handleCompact(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
+
 /**
  * @brief Handle the config command
  * @param args Command arguments
@@ -59,6 +67,22 @@ int handleConfig(const std::vector<std::string>& args, blahajpi::Analyzer& analy
  */
 int handleHelp(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
 
+/**
+ * @brief Handle the merge command
+ * @param args Command arguments
+ * @param analyzer Analyzer instance
+ * @return Exit code
+ */
+int handleMerge(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
+
+/**
+ * @brief Handle the serve command
+ * @param args Command arguments
+ * @param analyzer Analyzer instance
+ * @return Exit code
+ */
+int handleServe(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
+
 /**
  * @brief Handle the train command
  * @param args Command arguments
@@ -67,6 +91,14 @@ int handleHelp(const std::vector<std::string>& args, blahajpi::Analyzer& analyze
  */
 int handleTrain(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
 
+/**
+ * @brief Handle the tune command
+ * @param args Command arguments
+ * @param analyzer Analyzer instance
+ * @return Exit code
+ */
+int handleTune(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer);
+
 /**
  * @brief Handle the version command
  * @param args Command arguments
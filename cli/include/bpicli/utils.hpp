@@ -7,6 +7,7 @@
 
 #include "blahajpi/analyzer.hpp"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
@@ -20,8 +21,22 @@ namespace utils {
  */
 std::unordered_map<std::string, std::string> parseArgs(const std::vector<std::string>& args);
 
+/**
+ * @brief Reads a positive integer option
+ * @param parsedArgs Parsed arguments
+ * @param key Option name
+ * @param defaultValue Value used when the option is absent
+ * @param value Output value
+ * @return False (after reporting an error) if the option is not a positive integer
+ */
+bool positiveOption(const std::unordered_map<std::string, std::string>& parsedArgs, const std::string& key,
+                    long defaultValue, long& value);
+
 /**
  * @brief Load content from a file
+ * 
+ * Regular files are read with a single call into a buffer of their size.
+ * 
  * @param filePath Path to the file
  * @return Content as string
  * @throws std::runtime_error If file cannot be opened
@@ -56,6 +71,62 @@ void printTable(
  */
 std::string formatResult(const blahajpi::AnalysisResult& result, bool verbose = false);
 
+/**
+ * @brief Quote and escape text as a JSON string
+ * @param text Text to encode (UTF-8)
+ * @return JSON string literal including the quotes
+ */
+std::string jsonQuote(std::string_view text);
+
+/**
+ * @brief Split a single-line JSON object into its members
+ * 
+ * Values are kept as raw JSON (strings keep their quotes), so they can be
+ * echoed back unchanged or decoded with decodeJsonString().
+ * 
+ * @param line JSON object text
+ * @param members Output map of member names to raw values (cleared first)
+ * @return True if the line is one well-formed JSON object
+ */
+bool parseJsonObject(std::string_view line, std::unordered_map<std::string, std::string>& members);
+
+/**
+ * @brief Decode a raw JSON string value
+ * @param raw Raw value including the quotes
+ * @param value Output decoded text (UTF-8)
+ * @return True if raw is a valid JSON string
+ */
+bool decodeJsonString(std::string_view raw, std::string& value);
+
+/**
+ * @brief Check a raw request "id" and get the JSON to echo for it
+ * 
+ * Only strings and numbers are accepted, so a malformed id can never
+ * break the response line it is echoed into. Strings are re-encoded
+ * with jsonQuote(); numbers are kept as written.
+ * 
+ * @param raw Raw value from parseJsonObject()
+ * @param id Output JSON text to echo
+ * @return True if raw is a JSON string or number
+ */
+bool readJsonId(std::string_view raw, std::string& id);
+
+/**
+ * @brief Format an analysis result as a single-line JSON object
+ * @param result Analysis result to format
+ * @param id Raw JSON value echoed as the "id" member (omitted if empty)
+ * @return JSON text without a trailing newline
+ */
+std::string resultToJson(const blahajpi::AnalysisResult& result, const std::string& id = "");
+
+/**
+ * @brief Format an error as a single-line JSON object
+ * @param message Error message
+ * @param id Raw JSON value echoed as the "id" member (omitted if empty)
+ * @return JSON text without a trailing newline
+ */
+std::string errorToJson(const std::string& message, const std::string& id = "");
+
 /**
  * @brief Read input from file or standard input
  * @param prompt Prompt to display (if reading from stdin)
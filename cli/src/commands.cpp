@@ -24,6 +24,11 @@ std::unordered_map<std::string, Command> createCommandRegistry() {
         handleBatch
     };
     
+    commands["compact"] = {
+        "Drop low-weight features from a trained model",
+        handleCompact
+    };
+    
     commands["config"] = {
         "Manage configuration settings",
         handleConfig
@@ -34,11 +39,26 @@ std::unordered_map<std::string, Command> createCommandRegistry() {
         handleHelp
     };
     
+    commands["merge"] = {
+        "Combine the summaries of sharded batch runs",
+        handleMerge
+    };
+    
+    commands["serve"] = {
+        "Serve analysis requests from a loaded model",
+        handleServe
+    };
+    
     commands["train"] = {
         "Train a new sentiment analysis model",
         handleTrain
     };
     
+    commands["tune"] = {
+        "Cross-validate a grid of training settings",
+        handleTune
+    };
+    
     commands["version"] = {
         "Display version information",
         handleVersion
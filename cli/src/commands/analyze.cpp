@@ -1,18 +1,231 @@
 /**
  * @file analyze.cpp
  * @brief Implementation of the analyze command
+ *
+ * Besides single texts, --stream analyzes newline-delimited input from
+ * stdin or a file: a reader thread parses lines into a bounded queue and
+ * the calling thread scores them in batches, writing one JSON result per
+ * line as it goes, so memory does not grow with the input.
  */
 
 #include "bpicli/commands.hpp"
+#include "bpicli/bounded_queue.hpp"
 #include "bpicli/utils.hpp"
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 #include <filesystem>
 
 namespace bpicli {
 
+namespace {
+
+/// Default upper bound on records per analyzeMultiple() call
+constexpr size_t DEFAULT_STREAM_BATCH = 64;
+
+/// Default number of parsed records waiting to be scored
+constexpr size_t DEFAULT_STREAM_QUEUE = 1024;
+
+/**
+ * @brief One input line of a stream
+ */
+struct StreamRecord {
+    std::string id;      ///< Raw JSON id to echo (the line number for plain text)
+    std::string text;    ///< Text to analyze
+    std::string error;   ///< Why the line could not be used, if it cannot
+};
+
+/**
+ * @brief Turns one input line into a record
+ * @param line Input line without its newline
+ * @param lineNumber One-based line number
+ * @param json Whether lines are JSON objects with a "text" member
+ * @return Record, possibly carrying an error
+ */
+StreamRecord parseStreamLine(std::string_view line, size_t lineNumber, bool json) {
+    StreamRecord record;
+    if (!json) {
+        record.id = std::to_string(lineNumber);
+        record.text.assign(line);
+        return record;
+    }
+
+    std::unordered_map<std::string, std::string> members;
+    if (!utils::parseJsonObject(line, members)) {
+        record.error = "Line " + std::to_string(lineNumber) + " is not a JSON object";
+        return record;
+    }
+
+    auto id = members.find("id");
+    if (id != members.end() && !utils::readJsonId(id->second, record.id)) {
+        record.error = "Line " + std::to_string(lineNumber) + " has an \"id\" that is not a string or number";
+        return record;
+    }
+
+    auto text = members.find("text");
+    if (text == members.end() || !utils::decodeJsonString(text->second, record.text)) {
+        record.error = "Line " + std::to_string(lineNumber) + " needs a \"text\" string";
+    }
+    return record;
+}
+
+/**
+ * @brief Reads input lines into the queue until the input ends or the queue is closed
+ *
+ * Blocks on the queue when it is full, which stops reading the input.
+ * The queue is shared so a reader left blocked on stdin can outlive the
+ * command.
+ *
+ * @param input Input stream
+ * @param format "text", "json" or "auto" (decided by the first non-blank line)
+ * @param queue Queue that receives the records
+ */
+void readStream(std::istream& input, std::string format, std::shared_ptr<BoundedQueue<StreamRecord>> queue) {
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (!queue->isClosed() && std::getline(input, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            continue;
+        }
+        if (format == "auto") {
+            format = line[first] == '{' ? "json" : "text";
+        }
+        if (!queue->push(parseStreamLine(line, lineNumber, format == "json"))) {
+            break;
+        }
+    }
+
+    queue->close();
+}
+
+/**
+ * @brief Analyzes newline-delimited input and writes NDJSON results
+ * @param parsedArgs Parsed arguments
+ * @param analyzer Analyzer to score with
+ * @return Exit code
+ */
+int streamAnalyze(std::unordered_map<std::string, std::string>& parsedArgs, blahajpi::Analyzer& analyzer) {
+    std::string format = parsedArgs.count("format") > 0 ? parsedArgs["format"] : "auto";
+    if (format != "auto" && format != "text" && format != "json") {
+        utils::showError("Unknown stream format '" + format + "' (use text, json or auto)");
+        return 1;
+    }
+
+    long maxBatch = 0;
+    long queueSize = 0;
+    if (!utils::positiveOption(parsedArgs, "max-batch", DEFAULT_STREAM_BATCH, maxBatch) ||
+        !utils::positiveOption(parsedArgs, "queue-size", DEFAULT_STREAM_QUEUE, queueSize)) {
+        return 1;
+    }
+
+    std::ifstream inputFile;
+    if (parsedArgs.count("file") > 0) {
+        inputFile.open(parsedArgs["file"], std::ios::binary);
+        if (!inputFile.is_open()) {
+            utils::showError("File not found: " + parsedArgs["file"]);
+            return 1;
+        }
+    }
+    std::istream& input = inputFile.is_open() ? static_cast<std::istream&>(inputFile) : std::cin;
+
+    std::ofstream outputFile;
+    if (parsedArgs.count("output") > 0) {
+        outputFile.open(parsedArgs["output"]);
+        if (!outputFile.is_open()) {
+            utils::showError("Failed to open output file: " + parsedArgs["output"]);
+            return 1;
+        }
+    }
+    std::ostream& output = outputFile.is_open() ? static_cast<std::ostream&>(outputFile) : std::cout;
+
+    // Records in flight are bounded by the queue plus the batch being scored
+    auto queue = std::make_shared<BoundedQueue<StreamRecord>>(static_cast<size_t>(queueSize));
+    std::thread reader(readStream, std::ref(input), format, queue);
+
+    // The input and cleaned texts are never echoed back, so they are not kept
+    uint32_t fields = parsedArgs.count("scores-only") > 0
+        ? blahajpi::AnalysisResult::SCORES_ONLY
+        : blahajpi::AnalysisResult::EXPLANATION | blahajpi::AnalysisResult::KEY_TERMS;
+
+    std::vector<StreamRecord> batch;
+    std::vector<std::string> texts;
+    std::string line;
+    bool sawHarmful = false;
+    bool writeFailed = false;
+
+    // Score whatever has been read rather than waiting for a full batch
+    while (queue->popBatch(batch, static_cast<size_t>(maxBatch), std::chrono::milliseconds(0))) {
+        texts.clear();
+        for (auto& record : batch) {
+            if (record.error.empty()) {
+                texts.push_back(std::move(record.text));
+            }
+        }
+
+        std::vector<blahajpi::AnalysisResult> results;
+        std::string failure;
+        try {
+            results = analyzer.analyzeMultiple(texts, fields);
+        } catch (const std::exception& e) {
+            failure = e.what();
+        }
+
+        size_t next = 0;
+        for (const auto& record : batch) {
+            if (!record.error.empty()) {
+                output << utils::errorToJson(record.error, record.id) << '\n';
+            } else if (!failure.empty()) {
+                output << utils::errorToJson("Analysis failed: " + failure, record.id) << '\n';
+            } else {
+                const auto& result = results[next++];
+                sawHarmful = sawHarmful || result.sentiment == "Harmful";
+                line.clear();
+                result.appendJson(line, record.id);
+                line += '\n';
+                output << line;
+            }
+        }
+
+        // Downstream consumers see each batch as soon as it is scored
+        output.flush();
+        if (!output) {
+            writeFailed = true;
+            queue->close();
+            break;
+        }
+    }
+
+    // A reader blocked on stdin would keep a broken pipe waiting for more input
+    if (writeFailed && &input == &std::cin) {
+        reader.detach();
+    } else {
+        reader.join();
+    }
+
+    if (writeFailed) {
+        utils::showError("Failed to write results");
+        return 1;
+    }
+    if (parsedArgs.count("exit-on-harmful") > 0 && sawHarmful) {
+        return 2;  // Use exit code 2 to indicate harmful content
+    }
+    return 0;
+}
+
+} // namespace
+
 int handleAnalyze(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
     // Parse arguments
     auto parsedArgs = utils::parseArgs(args);
@@ -23,6 +236,11 @@ int handleAnalyze(const std::vector<std::string>& args, blahajpi::Analyzer& anal
     bool verbose = parsedArgs.count("verbose") > 0 || parsedArgs.count("v") > 0;
     bool exitOnHarmful = parsedArgs.count("exit-on-harmful") > 0;
     
+    // Newline-delimited input from stdin or a file
+    if (parsedArgs.count("stream") > 0) {
+        return streamAnalyze(parsedArgs, analyzer);
+    }
+    
     // Get input text from file or command line argument
     if (parsedArgs.count("file") > 0) {
         std::string filePath = parsedArgs["file"];
@@ -50,6 +268,8 @@ int handleAnalyze(const std::vector<std::string>& args, blahajpi::Analyzer& anal
         std::cout << "  --output <path>       Save analysis result to a file\n";
         std::cout << "  --verbose, -v         Show detailed analysis information\n";
         std::cout << "  --exit-on-harmful     Return non-zero exit code if harmful content detected\n";
+        std::cout << "  --stream              Analyze one text per line from stdin or --file, writing NDJSON\n";
+        std::cout << "  --scores-only         Leave explanations and key terms out of streamed results\n";
         return 1;
     }
     
@@ -1,88 +1,353 @@
 /**
  * @file batch.cpp
  * @brief Implementation of the batch command
+ *
+ * Files flow through a bounded pipeline so that reading and scoring
+ * overlap: one thread walks the input and queues paths, a pool of reader
+ * threads loads the files, one thread scores them in batches with
+ * analyzeMultiple(), and the calling thread writes results in input order
+ * as they complete. Every queue has a configurable depth, and the number of
+ * files between the walker and the writer is capped, so memory stays
+ * bounded however many files the input names.
+ *
+ * With --shard i/N, the walker keeps only the files a hash of their name
+ * assigns to shard i, so N nodes given the same input split it without
+ * coordination. Each run can save its BatchSummary, and the merge command
+ * combines the summaries of all shards into the report one run prints.
  */
 
 #include "bpicli/commands.hpp"
+#include "bpicli/bounded_queue.hpp"
 #include "bpicli/utils.hpp"
+#include "blahajpi/config.hpp"
+#include "blahajpi/utils/batch_summary.hpp"
+#include "blahajpi/utils/csv_parser.hpp"
+#include "blahajpi/utils/word_cloud.hpp"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <semaphore>
+#include <thread>
+#include <unordered_map>
 
 namespace bpicli {
 
-int handleBatch(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
-    // Parse arguments
-    auto parsedArgs = utils::parseArgs(args);
-    
-    // Variables to hold input and options
-    std::vector<std::string> filePaths;
-    std::string outputPath;
-    bool recursive = parsedArgs.count("recursive") > 0;
-    bool showHarmful = parsedArgs.count("show-harmful") > 0;
-    
-    // Get input source
-    if (parsedArgs.count("input-dir") > 0) {
-        std::string dirPath = parsedArgs["input-dir"];
-        
-        // Verify directory exists
-        if (!std::filesystem::exists(dirPath) || !std::filesystem::is_directory(dirPath)) {
-            utils::showError("Directory not found: " + dirPath);
-            return 1;
+namespace {
+
+/// Default number of files read and analyzed together
+constexpr size_t DEFAULT_BATCH_SIZE = 256;
+
+/// Default number of reader threads; reads are latency-bound, not CPU-bound
+constexpr size_t DEFAULT_READERS = 16;
+
+/// Default depth of the queue of paths waiting to be read
+constexpr size_t DEFAULT_PATH_QUEUE = 4096;
+
+/// Default depth of the queue of loaded files waiting to be scored
+constexpr size_t DEFAULT_READ_QUEUE = 1024;
+
+/// Default depth of the queue of results waiting to be written
+constexpr size_t DEFAULT_RESULT_QUEUE = 1024;
+
+/// Files written between progress updates
+constexpr size_t PROGRESS_INTERVAL = 256;
+
+/**
+ * @brief A file on its way through the pipeline
+ */
+struct BatchItem {
+    size_t index = 0;                  ///< Position in the input, used to restore order
+    std::string path;                  ///< File path
+    std::string key;                   ///< Name the shard and label are looked up by
+    std::string content;               ///< File contents once read
+    std::string error;                 ///< Why the file could not be read or scored
+    blahajpi::AnalysisResult result;   ///< Analysis result once scored
+};
+
+/// Queue between two pipeline stages
+using ItemQueue = BoundedQueue<BatchItem>;
+
+/**
+ * @brief Quotes a CSV field
+ * @param field Field text
+ * @return Field in double quotes with inner quotes doubled
+ */
+std::string csvQuote(const std::string& field) {
+    std::string quoted = "\"";
+    for (char c : field) {
+        if (c == '"') {
+            quoted += '"';
         }
-        
-        // Collect files from directory
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+/**
+ * @brief Parses a shard option such as "2/8"
+ * @param text Option value
+ * @param shardIndex Receives the zero-based shard index
+ * @param shardCount Receives the number of shards
+ * @return False unless text is "i/N" with 0 <= i < N
+ */
+bool parseShard(const std::string& text, size_t& shardIndex, size_t& shardCount) {
+    size_t slash = text.find('/');
+    if (slash == std::string::npos) {
+        return false;
+    }
+    try {
+        size_t usedIndex = 0;
+        size_t usedCount = 0;
+        std::string indexText = text.substr(0, slash);
+        std::string countText = text.substr(slash + 1);
+        long index = std::stol(indexText, &usedIndex);
+        long count = std::stol(countText, &usedCount);
+        if (usedIndex != indexText.size() || usedCount != countText.size() || index < 0 || count < 1 ||
+            index >= count) {
+            return false;
+        }
+        shardIndex = static_cast<size_t>(index);
+        shardCount = static_cast<size_t>(count);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Reads true labels from a CSV file of names and labels
+ *
+ * Each record is a file's name as the shard key sees it (the path
+ * relative to --input-dir, or the line of --input-file) followed by its
+ * label (0 = safe, anything else = harmful). A first record whose label
+ * is not a number is taken as a header.
+ *
+ * @param filePath CSV file
+ * @param labels Receives the label of each name
+ * @return False if the file cannot be read or a label is not a number
+ */
+bool loadLabels(const std::string& filePath, std::unordered_map<std::string, int>& labels) {
+    std::string content;
+    try {
+        content = utils::loadFileContent(filePath);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    blahajpi::utils::DelimitedParser parser(content, ',', true);
+    std::vector<blahajpi::utils::DelimitedField> fields;
+    bool first = true;
+    while (parser.next(fields)) {
+        if (fields.size() < 2) {
+            continue;
+        }
+        std::string label = fields[1].value();
         try {
-            if (recursive) {
-                for (const auto& entry : std::filesystem::recursive_directory_iterator(dirPath)) {
-                    if (entry.is_regular_file()) {
-                        filePaths.push_back(entry.path().string());
-                    }
-                }
-            } else {
-                for (const auto& entry : std::filesystem::directory_iterator(dirPath)) {
-                    if (entry.is_regular_file()) {
-                        filePaths.push_back(entry.path().string());
-                    }
-                }
+            size_t used = 0;
+            int value = std::stoi(label, &used);
+            if (used != label.size()) {
+                throw std::invalid_argument(label);
+            }
+            labels[fields[0].value()] = value;
+        } catch (const std::exception&) {
+            if (!first) {
+                return false;
             }
-        } catch (const std::exception& e) {
-            utils::showError("Error reading directory: " + std::string(e.what()));
-            return 1;
         }
-    } else if (parsedArgs.count("input-file") > 0) {
-        std::string listPath = parsedArgs["input-file"];
-        
-        // Verify file exists
-        if (!std::filesystem::exists(listPath)) {
-            utils::showError("File not found: " + listPath);
-            return 1;
+        first = false;
+    }
+    return true;
+}
+
+/**
+ * @brief Queues the files of a directory or file list in input order
+ *
+ * Each path takes a slot of @p inFlight before it is queued; the writer
+ * gives the slot back once the file's result is written. Files of other
+ * shards are skipped before they take a slot.
+ *
+ * @param source Directory or list file
+ * @param fromList Whether source is a list file rather than a directory
+ * @param recursive Whether to descend into subdirectories
+ * @param shardIndex Shard to keep
+ * @param shardCount Number of shards the input is split into
+ * @param paths Queue that receives the paths
+ * @param inFlight Slots limiting the files between walker and writer
+ * @param walked Receives the number of files queued so far
+ * @param walkError Receives the error that stopped the walk, if any
+ */
+void walkInput(const std::string& source, bool fromList, bool recursive, size_t shardIndex, size_t shardCount,
+               ItemQueue& paths, std::counting_semaphore<>& inFlight, std::atomic<size_t>& walked,
+               std::string& walkError) {
+    auto enqueue = [&](std::string path, std::string key) {
+        if (blahajpi::utils::shardOf(key, shardCount) != shardIndex) {
+            return true;
         }
-        
-        // Read file paths from list file
-        try {
-            std::ifstream file(listPath);
+        inFlight.acquire();
+        BatchItem item;
+        item.index = walked.fetch_add(1);
+        item.path = std::move(path);
+        item.key = std::move(key);
+        return paths.push(std::move(item));
+    };
+
+    // Directory entries are keyed relative to the directory, so nodes may mount it anywhere
+    auto enqueueEntry = [&](const std::filesystem::directory_entry& entry) {
+        return enqueue(entry.path().string(), entry.path().lexically_relative(source).generic_string());
+    };
+
+    try {
+        if (fromList) {
+            std::ifstream file(source);
             std::string line;
-            
+
             while (std::getline(file, line)) {
                 // Skip empty lines and comments
                 if (line.empty() || line[0] == '#') {
                     continue;
                 }
-                
+
                 // Trim whitespace
                 line.erase(0, line.find_first_not_of(" \t"));
                 line.erase(line.find_last_not_of(" \t") + 1);
-                
-                if (!line.empty()) {
-                    filePaths.push_back(line);
+
+                if (!line.empty() && !enqueue(line, line)) {
+                    break;
+                }
+            }
+        } else if (recursive) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(source)) {
+                if (entry.is_regular_file() && !enqueueEntry(entry)) {
+                    break;
+                }
+            }
+        } else {
+            for (const auto& entry : std::filesystem::directory_iterator(source)) {
+                if (entry.is_regular_file() && !enqueueEntry(entry)) {
+                    break;
                 }
             }
+        }
+    } catch (const std::exception& e) {
+        walkError = e.what();
+    }
+
+    paths.close();
+}
+
+/**
+ * @brief Loads queued files until the path queue is drained
+ * @param paths Queue of paths to read
+ * @param loaded Queue that receives the loaded files
+ */
+void readFiles(ItemQueue& paths, ItemQueue& loaded) {
+    BatchItem item;
+    while (paths.pop(item)) {
+        try {
+            if (!std::filesystem::exists(item.path)) {
+                item.error = "File not found";
+            } else {
+                item.content = utils::loadFileContent(item.path);
+            }
         } catch (const std::exception& e) {
-            utils::showError("Error reading file list: " + std::string(e.what()));
+            item.error = e.what();
+        }
+        loaded.push(std::move(item));
+    }
+}
+
+/**
+ * @brief Scores loaded files in batches until the read queue is drained
+ *
+ * Words of harmful files are counted here, so cleaned texts are dropped
+ * before results reach the writer.
+ *
+ * @param loaded Queue of loaded files
+ * @param scored Queue that receives the scored files
+ * @param analyzer Analyzer to score with
+ * @param batchSize Largest number of files per analyzeMultiple() call
+ * @param fields AnalysisResult::Field bits to fill in (must include CLEANED_TEXT)
+ * @param words Receives the words of harmful files
+ */
+void scoreFiles(ItemQueue& loaded, ItemQueue& scored, blahajpi::Analyzer& analyzer, size_t batchSize,
+                uint32_t fields, blahajpi::utils::CloudAggregator& words) {
+    std::vector<BatchItem> batch;
+    std::vector<std::string> contents;
+
+    // Score whatever is ready rather than waiting for a full batch
+    while (loaded.popBatch(batch, batchSize, std::chrono::milliseconds(0))) {
+        contents.clear();
+        for (auto& item : batch) {
+            if (item.error.empty()) {
+                contents.push_back(std::move(item.content));
+            }
+        }
+
+        try {
+            std::vector<blahajpi::AnalysisResult> results = analyzer.analyzeMultiple(contents, fields);
+            words.add(results);
+            size_t next = 0;
+            for (auto& item : batch) {
+                if (item.error.empty()) {
+                    item.result = std::move(results[next++]);
+                    item.result.cleanedText.clear();
+                }
+            }
+        } catch (const std::exception& e) {
+            for (auto& item : batch) {
+                if (item.error.empty()) {
+                    item.error = e.what();
+                }
+            }
+        }
+
+        for (auto& item : batch) {
+            scored.push(std::move(item));
+        }
+    }
+
+    scored.close();
+}
+
+} // namespace
+
+int handleBatch(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    // Parse arguments
+    auto parsedArgs = utils::parseArgs(args);
+
+    // Variables to hold input and options
+    std::string source;
+    bool fromList = false;
+    std::string outputPath;
+    bool recursive = parsedArgs.count("recursive") > 0;
+    bool showHarmful = parsedArgs.count("show-harmful") > 0;
+    bool scoresOnly = parsedArgs.count("scores-only") > 0;
+    size_t shardIndex = 0;
+    size_t shardCount = 1;
+
+    // Get input source
+    if (parsedArgs.count("input-dir") > 0) {
+        source = parsedArgs["input-dir"];
+
+        // Verify directory exists
+        if (!std::filesystem::exists(source) || !std::filesystem::is_directory(source)) {
+            utils::showError("Directory not found: " + source);
+            return 1;
+        }
+    } else if (parsedArgs.count("input-file") > 0) {
+        source = parsedArgs["input-file"];
+        fromList = true;
+
+        // Verify file exists
+        if (!std::filesystem::exists(source)) {
+            utils::showError("File not found: " + source);
             return 1;
         }
     } else {
@@ -94,148 +359,231 @@ int handleBatch(const std::vector<std::string>& args, blahajpi::Analyzer& analyz
         std::cout << "  --output <path>       Save batch analysis results to a file\n";
         std::cout << "  --recursive           Process files in subdirectories (with --input-dir)\n";
         std::cout << "  --show-harmful        Display detailed report for harmful content\n";
+        std::cout << "  --scores-only         Skip explanations and write only scores\n";
+        std::cout << "  --shard <i/N>         Process only shard i (0-based) of N of the input\n";
+        std::cout << "  --summary <path>      Save the run's summary for the merge command\n";
+        std::cout << "  --labels <path>       CSV of file names and true labels; adds classification metrics\n";
+        std::cout << "  --readers <n>         Files read concurrently (default: 16)\n";
+        std::cout << "  --batch-size <n>      Most files analyzed together (default: 256)\n";
+        std::cout << "  --path-queue <n>      Paths queued ahead of the readers (default: 4096)\n";
+        std::cout << "  --read-queue <n>      Read files queued ahead of scoring (default: 1024)\n";
+        std::cout << "  --result-queue <n>    Results queued ahead of the writer (default: 1024)\n";
         return 1;
     }
-    
-    // Get output path if specified
+
+    long readers = 0;
+    long batchSize = 0;
+    long pathQueueSize = 0;
+    long readQueueSize = 0;
+    long resultQueueSize = 0;
+    if (!utils::positiveOption(parsedArgs, "readers", DEFAULT_READERS, readers) ||
+        !utils::positiveOption(parsedArgs, "batch-size", DEFAULT_BATCH_SIZE, batchSize) ||
+        !utils::positiveOption(parsedArgs, "path-queue", DEFAULT_PATH_QUEUE, pathQueueSize) ||
+        !utils::positiveOption(parsedArgs, "read-queue", DEFAULT_READ_QUEUE, readQueueSize) ||
+        !utils::positiveOption(parsedArgs, "result-queue", DEFAULT_RESULT_QUEUE, resultQueueSize)) {
+        return 1;
+    }
+    if (parsedArgs.count("shard") > 0 && !parseShard(parsedArgs["shard"], shardIndex, shardCount)) {
+        utils::showError("Invalid --shard (expected i/N with 0 <= i < N): " + parsedArgs["shard"]);
+        return 1;
+    }
+
+    std::unordered_map<std::string, int> labels;
+    if (parsedArgs.count("labels") > 0 && !loadLabels(parsedArgs["labels"], labels)) {
+        utils::showError("Failed to read labels from: " + parsedArgs["labels"]);
+        return 1;
+    }
+
+    // Results carry a near-duplicate cluster when the analyzer forms them
+    blahajpi::Config settings;
+    settings.set("near-duplicates", analyzer.getConfig()["near-duplicates"]);
+    bool clusterColumn = settings.getBool("near-duplicates", false);
+
+    // Open the output first so a bad path fails before any work is done
+    std::ofstream outFile;
     if (parsedArgs.count("output") > 0) {
         outputPath = parsedArgs["output"];
+        outFile.open(outputPath);
+        if (!outFile.is_open()) {
+            utils::showError("Failed to open output file: " + outputPath);
+            return 1;
+        }
+        outFile << (scoresOnly ? "file,sentiment,score,confidence" : "file,sentiment,score,confidence,explanation")
+                << (clusterColumn ? ",cluster\n" : "\n");
     }
-    
-    // Exit if no files were found
-    if (filePaths.empty()) {
-        utils::showWarning("No files found to process.");
-        return 0;
-    }
-    
-    std::cout << "Processing " << filePaths.size() << " files..." << std::endl;
-    
-    // Prepare result storage
-    std::vector<std::pair<std::string, blahajpi::AnalysisResult>> results;
-    results.reserve(filePaths.size());
-    
-    int harmfulCount = 0;
-    int errorCount = 0;
-    
+
+    if (shardCount > 1) {
+        std::cout << "Processing shard " << shardIndex << " of " << shardCount << " from " << source << "..." << std::endl;
+    } else {
+        std::cout << "Processing files from " << source << "..." << std::endl;
+    }
+
+    // Files between the walker and the writer: everything the queues, the
+    // readers and one batch can hold, so the reorder buffer stays bounded too
+    size_t inFlightLimit = static_cast<size_t>(pathQueueSize + readQueueSize + resultQueueSize + readers + batchSize);
+    std::counting_semaphore<> inFlight(static_cast<std::ptrdiff_t>(inFlightLimit));
+
+    ItemQueue paths(static_cast<size_t>(pathQueueSize));
+    ItemQueue loaded(static_cast<size_t>(readQueueSize));
+    ItemQueue scored(static_cast<size_t>(resultQueueSize));
+
+    std::atomic<size_t> walked{0};
+    std::string walkError;
+
     // Record start time
     auto startTime = std::chrono::high_resolution_clock::now();
-    
-    // Process each file
-    for (size_t i = 0; i < filePaths.size(); ++i) {
-        const auto& path = filePaths[i];
-        
-        // Show progress
-        if (i % 10 == 0 || i == filePaths.size() - 1) {
-            std::cout << "\rProcessing file " << (i + 1) << " of " << filePaths.size() 
-                     << " (" << (i * 100 / filePaths.size()) << "%)..." << std::flush;
-        }
-        
-        try {
-            // Check if file exists
-            if (!std::filesystem::exists(path)) {
-                std::cerr << "\nWarning: File not found: " << path << std::endl;
-                errorCount++;
-                continue;
+
+    std::thread walker(walkInput, std::cref(source), fromList, recursive, shardIndex, shardCount, std::ref(paths),
+                       std::ref(inFlight), std::ref(walked), std::ref(walkError));
+
+    std::vector<std::thread> readerThreads;
+    std::atomic<long> activeReaders{readers};
+    for (long i = 0; i < readers; ++i) {
+        readerThreads.emplace_back([&]() {
+            readFiles(paths, loaded);
+            // The last reader out ends the scoring stage's input
+            if (activeReaders.fetch_sub(1) == 1) {
+                loaded.close();
             }
-            
-            // Read file content
-            std::string content = utils::loadFileContent(path);
-            
-            // Analyze the content
-            blahajpi::AnalysisResult result = analyzer.analyze(content);
-            
-            // Store the result
-            results.emplace_back(path, result);
-            
-            // Count harmful content
-            if (result.sentiment == "Harmful") {
-                harmfulCount++;
+        });
+    }
+
+    // File contents and key terms are never written, so they are not kept; cleaned
+    // texts only live until their words are counted
+    uint32_t fields = (scoresOnly ? blahajpi::AnalysisResult::SCORES_ONLY : blahajpi::AnalysisResult::EXPLANATION) |
+                      blahajpi::AnalysisResult::CLEANED_TEXT;
+    blahajpi::utils::CloudAggregator words(true, blahajpi::utils::BatchSummary::TERM_CAPACITY);
+    std::thread scorer(scoreFiles, std::ref(loaded), std::ref(scored), std::ref(analyzer),
+                       static_cast<size_t>(batchSize), fields, std::ref(words));
+
+    // Write results in input order; later files wait here for earlier ones
+    std::map<size_t, BatchItem> pending;
+    std::vector<BatchItem> harmfulItems;
+    size_t written = 0;
+    blahajpi::utils::BatchSummary summary(shardIndex, shardCount);
+
+    BatchItem item;
+    while (scored.pop(item)) {
+        size_t index = item.index;
+        pending.emplace(index, std::move(item));
+
+        for (auto next = pending.find(written); next != pending.end(); next = pending.find(written)) {
+            BatchItem& ready = next->second;
+
+            if (!ready.error.empty()) {
+                std::cerr << "\nError processing file " << ready.path << ": " << ready.error << std::endl;
+                summary.addError();
+            } else {
+                auto label = labels.find(ready.key);
+                if (label != labels.end()) {
+                    summary.add(ready.result, label->second);
+                } else {
+                    summary.add(ready.result);
+                }
+                if (showHarmful && ready.result.sentiment == "Harmful") {
+                    harmfulItems.push_back(ready);
+                }
+
+                if (outFile.is_open()) {
+                    outFile << csvQuote(ready.path) << ","
+                            << csvQuote(ready.result.sentiment) << ","
+                            << ready.result.harmScore << ","
+                            << ready.result.confidence;
+                    if (!scoresOnly) {
+                        outFile << "," << csvQuote(ready.result.explanation);
+                    }
+                    if (clusterColumn) {
+                        outFile << "," << blahajpi::AnalysisResult::formatCluster(ready.result.cluster);
+                    }
+                    outFile << "\n";
+                }
+            }
+
+            pending.erase(next);
+            inFlight.release();
+            ++written;
+
+            // Show progress
+            if (written % PROGRESS_INTERVAL == 0) {
+                std::cout << "\rProcessed " << written << " of " << walked.load() << " files..." << std::flush;
             }
-        } catch (const std::exception& e) {
-            std::cerr << "\nError processing file " << path << ": " << e.what() << std::endl;
-            errorCount++;
         }
     }
-    
+
+    walker.join();
+    for (auto& thread : readerThreads) {
+        thread.join();
+    }
+    scorer.join();
+
     // Calculate elapsed time
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
-    
+
+    if (!walkError.empty()) {
+        utils::showError("Error reading " + std::string(fromList ? "file list" : "directory") + ": " + walkError);
+        return 1;
+    }
+
+    // An empty shard still saves its summary, so the merge sees every shard
+    auto saveSummary = [&]() {
+        if (parsedArgs.count("summary") == 0) {
+            return true;
+        }
+        if (!summary.save(parsedArgs["summary"])) {
+            utils::showError("Failed to write summary to: " + parsedArgs["summary"]);
+            return false;
+        }
+        utils::showSuccess("Summary saved to: " + parsedArgs["summary"]);
+        return true;
+    };
+
+    // Exit if no files were found
+    size_t totalFiles = walked.load();
+    if (totalFiles == 0) {
+        utils::showWarning("No files found to process.");
+        return saveSummary() ? 0 : 1;
+    }
+
+    std::cout << "\rProcessed " << written << " of " << totalFiles << " files." << std::endl;
     std::cout << "\nCompleted in " << duration.count() << " seconds." << std::endl;
-    
+
     // Print summary
-    std::cout << "\nAnalysis Summary:\n";
-    std::cout << "Total files: " << filePaths.size() << std::endl;
-    std::cout << "Harmful content: " << harmfulCount << " files (" 
-              << (filePaths.size() > 0 ? (harmfulCount * 100 / filePaths.size()) : 0) << "%)" << std::endl;
-    std::cout << "Safe content: " << (filePaths.size() - harmfulCount - errorCount) 
-              << " files" << std::endl;
-    
-    if (errorCount > 0) {
-        std::cout << "Errors: " << errorCount << " files" << std::endl;
-    }
-    
+    summary.addTerms(words.getCounts());
+    std::cout << "\n" << summary.report();
+    if (!labels.empty() && summary.getLabeled() < summary.getFiles() - summary.getErrors()) {
+        utils::showWarning(std::to_string(summary.getFiles() - summary.getErrors() - summary.getLabeled()) +
+                           " scored files have no label in " + parsedArgs["labels"]);
+    }
+
     // Show harmful content details if requested
-    if (showHarmful && harmfulCount > 0) {
+    if (showHarmful && !harmfulItems.empty()) {
         std::cout << "\nHarmful Content Details:\n";
         std::cout << "------------------------\n";
-        
-        for (const auto& [path, result] : results) {
-            if (result.sentiment == "Harmful") {
-                std::cout << "File: " << path << std::endl;
-                std::cout << "Score: " << result.harmScore << std::endl;
-                std::cout << "Explanation: " << result.explanation << std::endl;
-                std::cout << "------------------------\n";
-            }
+
+        for (const auto& harmful : harmfulItems) {
+            std::cout << "File: " << harmful.path << std::endl;
+            std::cout << "Score: " << harmful.result.harmScore << std::endl;
+            std::cout << "Explanation: "
+                      << (scoresOnly ? harmful.result.makeExplanation() : harmful.result.explanation) << std::endl;
+            std::cout << "------------------------\n";
         }
     }
-    
-    // Save results to file if requested
-    if (!outputPath.empty()) {
-        try {
-            std::ofstream outFile(outputPath);
-            if (!outFile.is_open()) {
-                utils::showError("Failed to open output file: " + outputPath);
-                return 1;
-            }
-            
-            // Write CSV header
-            outFile << "file,sentiment,score,confidence,explanation\n";
-            
-            // Write results
-            for (const auto& [path, result] : results) {
-                // Escape commas and quotes in fields
-                std::string escapedPath = path;
-                std::string escapedExplanation = result.explanation;
-                
-                // Replace quotes with double quotes for CSV
-                size_t pos = 0;
-                while ((pos = escapedPath.find('"', pos)) != std::string::npos) {
-                    escapedPath.replace(pos, 1, "\"\"");
-                    pos += 2;
-                }
-                
-                pos = 0;
-                while ((pos = escapedExplanation.find('"', pos)) != std::string::npos) {
-                    escapedExplanation.replace(pos, 1, "\"\"");
-                    pos += 2;
-                }
-                
-                outFile << "\"" << escapedPath << "\","
-                        << "\"" << result.sentiment << "\","
-                        << result.harmScore << ","
-                        << result.confidence << ","
-                        << "\"" << escapedExplanation << "\"\n";
-            }
-            
-            outFile.close();
-            utils::showSuccess("Results saved to: " + outputPath);
-        } catch (const std::exception& e) {
-            utils::showError("Error saving results: " + std::string(e.what()));
+
+    if (!saveSummary()) {
+        return 1;
+    }
+
+    // Finish the streamed results
+    if (outFile.is_open()) {
+        outFile.close();
+        if (outFile.fail()) {
+            utils::showError("Error saving results to: " + outputPath);
             return 1;
         }
+        utils::showSuccess("Results saved to: " + outputPath);
     }
-    
+
     return 0;
 }
 
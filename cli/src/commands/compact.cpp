@@ -0,0 +1,81 @@
+/**
+ * @file compact.cpp
+ * @brief Implementation of the compact command
+ */
+
+#include "bpicli/commands.hpp"
+#include "bpicli/utils.hpp"
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+
+namespace bpicli {
+
+namespace {
+
+/**
+ * @brief Gets the size of a model directory's bundle
+ * @param modelDir Model directory
+ * @return Size of model.bpi in bytes (0 if it is missing)
+ */
+uintmax_t bundleSize(const std::string& modelDir) {
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(std::filesystem::path(modelDir) / "model.bpi", error);
+    return error ? 0 : size;
+}
+
+} // namespace
+
+int handleCompact(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    auto parsedArgs = utils::parseArgs(args);
+
+    if (parsedArgs.count("threshold") == 0 || parsedArgs.count("output") == 0) {
+        utils::showError("Missing required arguments: --threshold and --output");
+        std::cout << "Usage: blahajpi compact --threshold <weight> --output <dir> [--model <dir>] [--dataset <path>]" << std::endl;
+        return 1;
+    }
+
+    double threshold = 0.0;
+    try {
+        size_t used = 0;
+        threshold = std::stod(parsedArgs["threshold"], &used);
+        if (used != parsedArgs["threshold"].size() || threshold <= 0.0) {
+            throw std::invalid_argument("not a positive number");
+        }
+    } catch (const std::exception&) {
+        utils::showError("Invalid --threshold (expected a positive weight): " + parsedArgs["threshold"]);
+        return 1;
+    }
+
+    std::string modelDir = parsedArgs.count("model") > 0 ? parsedArgs["model"] : analyzer.getConfig()["model-dir"];
+    if (parsedArgs.count("model") > 0 && !analyzer.loadModel(modelDir)) {
+        utils::showError("Failed to load model from: " + modelDir);
+        return 1;
+    }
+
+    std::string datasetPath = parsedArgs.count("dataset") > 0 ? parsedArgs["dataset"] : "";
+    if (!datasetPath.empty() && !std::filesystem::exists(datasetPath)) {
+        utils::showError("Dataset file not found: " + datasetPath);
+        return 1;
+    }
+
+    std::string outputDir = parsedArgs["output"];
+    uintmax_t sizeBefore = bundleSize(modelDir);
+    if (!analyzer.compactModel(outputDir, threshold, datasetPath)) {
+        utils::showError("Model not compacted; nothing was saved");
+        return 1;
+    }
+
+    uintmax_t sizeAfter = bundleSize(outputDir);
+    if (sizeBefore > 0 && sizeAfter > 0) {
+        std::cout << "Bundle size: " << sizeBefore << " -> " << sizeAfter << " bytes" << std::endl;
+    }
+    utils::showSuccess("Compacted model saved to: " + outputDir);
+    return 0;
+}
+
+} // namespace bpicli
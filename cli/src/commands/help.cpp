@@ -28,11 +28,17 @@ static void showCommandHelp(const std::string& command) {
         std::cout << "  --text <text>         Analyze the provided text\n";
         std::cout << "  --output <path>       Save analysis result to a file\n";
         std::cout << "  --verbose, -v         Show detailed analysis information\n";
-        std::cout << "  --exit-on-harmful     Return non-zero exit code if harmful content detected\n\n";
+        std::cout << "  --exit-on-harmful     Return non-zero exit code if harmful content detected\n";
+        std::cout << "  --stream              Analyze one text per line from stdin or --file, writing NDJSON\n";
+        std::cout << "  --format <fmt>        Stream lines as text, json ({\"id\":..,\"text\":..}) or auto\n";
+        std::cout << "  --max-batch <n>       Most stream lines analyzed together (default: 64)\n";
+        std::cout << "  --scores-only         Leave explanations and key terms out of streamed results\n";
+        std::cout << "  --queue-size <n>      Stream lines read ahead of scoring (default: 1024)\n\n";
         std::cout << "Examples:\n";
         std::cout << "  blahajpi analyze --file input.txt\n";
         std::cout << "  blahajpi analyze --text \"Text to analyze\"\n";
         std::cout << "  blahajpi analyze --file input.txt --output result.txt\n";
+        std::cout << "  cat messages.ndjson | blahajpi analyze --stream --format json\n";
     } else if (command == "batch") {
         std::cout << "Batch process multiple files\n\n";
         std::cout << "Usage: blahajpi batch [options]\n\n";
@@ -41,10 +47,42 @@ static void showCommandHelp(const std::string& command) {
         std::cout << "  --input-file <path>   Process files listed in a file (one per line)\n";
         std::cout << "  --output <path>       Save batch analysis results to a file\n";
         std::cout << "  --recursive           Process files in subdirectories (with --input-dir)\n";
-        std::cout << "  --show-harmful        Display detailed report for harmful content\n\n";
+        std::cout << "  --show-harmful        Display detailed report for harmful content\n";
+        std::cout << "  --scores-only         Skip explanations and write only scores\n";
+        std::cout << "  --shard <i/N>         Process only shard i (0-based) of N of the input\n";
+        std::cout << "  --summary <path>      Save the run's summary for the merge command\n";
+        std::cout << "  --labels <path>       CSV of file names and true labels; adds classification metrics\n";
+        std::cout << "  --readers <n>         Files read concurrently (default: 16)\n";
+        std::cout << "  --batch-size <n>      Most files analyzed together (default: 256)\n";
+        std::cout << "  --path-queue <n>      Paths queued ahead of the readers (default: 4096)\n";
+        std::cout << "  --read-queue <n>      Read files queued ahead of scoring (default: 1024)\n";
+        std::cout << "  --result-queue <n>    Results queued ahead of the writer (default: 1024)\n\n";
+        std::cout << "Files are read, scored and written concurrently; results keep the input order\n";
+        std::cout << "and are streamed to the output file as they complete.\n\n";
+        std::cout << "A file belongs to a shard by a hash of its name: its path relative to\n";
+        std::cout << "--input-dir, or its line in --input-file. The same names key --labels.\n\n";
+        std::cout << "With near-duplicates = true in the config, lightly edited copies share the\n";
+        std::cout << "result of the first one scored; the output gets a cluster column and the\n";
+        std::cout << "summary lists the largest clusters.\n\n";
         std::cout << "Examples:\n";
         std::cout << "  blahajpi batch --input-dir ./documents --output results.csv\n";
         std::cout << "  blahajpi batch --input-file file_list.txt --show-harmful\n";
+        std::cout << "  blahajpi batch --input-dir ./corpus --shard 0/4 --summary shard0.sum --output shard0.csv\n";
+    } else if (command == "compact") {
+        std::cout << "Drop low-weight features from a trained model\n\n";
+        std::cout << "Usage: blahajpi compact [options]\n\n";
+        std::cout << "Options:\n";
+        std::cout << "  --threshold <weight>   Remove features whose absolute weight is below this\n";
+        std::cout << "  --output <dir>         Directory to save the compacted model\n";
+        std::cout << "  --model <dir>          Model directory (default: model-dir from config)\n";
+        std::cout << "  --dataset <path>       Labeled dataset to measure the accuracy change on\n\n";
+        std::cout << "Only linear models on TF-IDF features can be compacted. Removed terms are\n";
+        std::cout << "dropped from the vocabulary and the remaining weights are renumbered, so the\n";
+        std::cout << "bundle loads faster and takes less memory. Training does the same when\n";
+        std::cout << "compact-threshold is set.\n\n";
+        std::cout << "Examples:\n";
+        std::cout << "  blahajpi compact --model models/default --threshold 0.01 --output models/compact\n";
+        std::cout << "  blahajpi compact --threshold 0.05 --dataset data.csv --output models/compact\n";
     } else if (command == "config") {
         std::cout << "Manage configuration settings\n\n";
         std::cout << "Usage: blahajpi config [command] [options]\n\n";
@@ -60,6 +98,38 @@ static void showCommandHelp(const std::string& command) {
         std::cout << "  blahajpi config get model-dir\n";
         std::cout << "  blahajpi config set max-features 20000\n";
         std::cout << "  blahajpi config load ./configs/fast_model.conf\n";
+    } else if (command == "merge") {
+        std::cout << "Combine the summaries of sharded batch runs\n\n";
+        std::cout << "Usage: blahajpi merge <summary>... [options]\n\n";
+        std::cout << "Options:\n";
+        std::cout << "  --output <path>        Save the merged summary\n";
+        std::cout << "  --top-words <n>        Most frequent harmful words to list (default: 10)\n\n";
+        std::cout << "Prints the summary a single batch run over the whole input would print.\n";
+        std::cout << "Summaries of the same shard, or of inputs split differently, are refused.\n\n";
+        std::cout << "Examples:\n";
+        std::cout << "  blahajpi merge shard0.sum shard1.sum shard2.sum shard3.sum\n";
+        std::cout << "  blahajpi merge node*/shard.sum --output corpus.sum\n";
+    } else if (command == "serve") {
+        std::cout << "Serve analysis requests from a loaded model\n\n";
+        std::cout << "Usage: blahajpi serve [options]\n\n";
+        std::cout << "Options:\n";
+        std::cout << "  --socket <path>        Unix socket to listen on (default: /tmp/blahajpi.sock)\n";
+        std::cout << "  --model <dir>          Model directory (default: model-dir from config)\n";
+        std::cout << "  --max-batch <n>        Maximum texts analyzed together (default: 64)\n";
+        std::cout << "  --max-wait-ms <ms>     Time a request waits for a batch to fill (default: 5)\n";
+        std::cout << "  --queue-size <n>       Queued requests before reading pauses (default: 1024)\n";
+        std::cout << "  --save-every <n>       Save the model directory after n feedback samples (default: never)\n\n";
+        std::cout << "Protocol (one JSON object per line):\n";
+        std::cout << "  {\"id\": 1, \"text\": \"...\"}   ->  {\"id\":1,\"sentiment\":...,\"harm_score\":...}\n";
+        std::cout << "  {\"text\": \"...\", \"label\": 0} ->  {\"updated\":true,\"model_version\":...}\n";
+        std::cout << "  {\"command\": \"stats\"}        ->  {\"stats\":{...}[,\"clusters\":[...]]}\n\n";
+        std::cout << "With near-duplicates = true in the config, results carry a \"cluster\" ID shared\n";
+        std::cout << "by lightly edited copies, and stats list the largest clusters.\n\n";
+        std::cout << "Labeled requests update a linear model in place. Send SIGHUP to reload the\n";
+        std::cout << "model directory without dropping requests (unsaved updates are discarded).\n\n";
+        std::cout << "Examples:\n";
+        std::cout << "  blahajpi serve --model ./models/default --socket /run/blahajpi.sock\n";
+        std::cout << "  echo '{\"text\":\"hello\"}' | nc -U /tmp/blahajpi.sock\n";
     } else if (command == "train") {
         std::cout << "Train a new sentiment analysis model\n\n";
         std::cout << "Usage: blahajpi train [options]\n\n";
@@ -74,6 +144,22 @@ static void showCommandHelp(const std::string& command) {
         std::cout << "Examples:\n";
         std::cout << "  blahajpi train --dataset data.csv --output models/custom_model\n";
         std::cout << "  blahajpi train --dataset data.csv --alpha 0.0001 --epochs 15\n";
+    } else if (command == "tune") {
+        std::cout << "Cross-validate a grid of training settings\n\n";
+        std::cout << "Usage: blahajpi tune [options]\n\n";
+        std::cout << "Options:\n";
+        std::cout << "  --dataset <path>       Path to labeled dataset\n";
+        std::cout << "  --folds <n>            Number of folds (default: cv-folds from config, or 5)\n";
+        std::cout << "  --alpha <list>         Comma-separated regularization strengths (default: from config)\n";
+        std::cout << "  --eta0 <list>          Comma-separated learning rates (default: from config)\n";
+        std::cout << "  --epochs <list>        Comma-separated epoch counts (default: from config)\n";
+        std::cout << "  --output <path>        Save the results as CSV\n\n";
+        std::cout << "Each text is preprocessed once and each fold's features are extracted once;\n";
+        std::cout << "all settings then train in parallel on the cached features. Settings are\n";
+        std::cout << "listed best macro F1 first. The saved model is not changed.\n\n";
+        std::cout << "Examples:\n";
+        std::cout << "  blahajpi tune --dataset data.csv --alpha 0.0001,0.0003,0.001 --eta0 0.01,0.03\n";
+        std::cout << "  blahajpi tune --dataset data.csv --folds 10 --epochs 5,10,15 --output tuning.csv\n";
     } else if (command == "version") {
         std::cout << "Display version information\n\n";
         std::cout << "Usage: blahajpi version\n\n";
@@ -115,6 +201,8 @@ int handleHelp(const std::vector<std::string>& args, blahajpi::Analyzer& analyze
         
         std::cout << "Global Options:\n";
         std::cout << "  --config <file>    Specify configuration file\n";
+        std::cout << "  --stats <format>   Print analyzer timings to stderr (json or prometheus)\n";
+        std::cout << "  --stats-out <file> Write analyzer timings to a file instead\n";
         std::cout << "  --version          Display version information\n";
         std::cout << "  --help, -h         Display this help message\n\n";
         
@@ -0,0 +1,80 @@
+/**
+ * @file merge.cpp
+ * @brief Implementation of the merge command
+ */
+
+#include "bpicli/commands.hpp"
+#include "bpicli/utils.hpp"
+#include "blahajpi/utils/batch_summary.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace bpicli {
+
+int handleMerge(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    // Silence unused parameter warning
+    (void)analyzer;
+
+    auto parsedArgs = utils::parseArgs(args);
+
+    // Summary files are the positional arguments
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i].rfind("--", 0) == 0) {
+            if (args[i].find('=') == std::string::npos && i + 1 < args.size() && args[i + 1][0] != '-') {
+                ++i;
+            }
+        } else {
+            inputs.push_back(args[i]);
+        }
+    }
+    if (inputs.empty()) {
+        utils::showError("No summaries to merge");
+        std::cout << "Usage: blahajpi merge <summary>... [--output <path>] [--top-words <n>]" << std::endl;
+        return 1;
+    }
+
+    long topWords = 0;
+    if (!utils::positiveOption(parsedArgs, "top-words", 10, topWords)) {
+        return 1;
+    }
+
+    blahajpi::utils::BatchSummary merged;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        blahajpi::utils::BatchSummary shard;
+        if (!shard.load(inputs[i])) {
+            utils::showError("Not a batch summary: " + inputs[i]);
+            return 1;
+        }
+        if (i == 0) {
+            merged = std::move(shard);
+            continue;
+        }
+        try {
+            merged.merge(shard);
+        } catch (const std::invalid_argument& e) {
+            utils::showError("Cannot merge " + inputs[i] + ": " + e.what());
+            return 1;
+        }
+    }
+
+    std::cout << merged.report(static_cast<size_t>(topWords));
+    if (!merged.isComplete()) {
+        utils::showWarning("Merged " + std::to_string(merged.getShards().size()) + " of " +
+                           std::to_string(merged.getShardCount()) + " shards; the totals are partial");
+    }
+
+    if (parsedArgs.count("output") > 0) {
+        if (!merged.save(parsedArgs["output"])) {
+            utils::showError("Failed to write summary to: " + parsedArgs["output"]);
+            return 1;
+        }
+        utils::showSuccess("Merged summary saved to: " + parsedArgs["output"]);
+    }
+
+    return 0;
+}
+
+} // namespace bpicli
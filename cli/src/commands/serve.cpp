@@ -0,0 +1,531 @@
+/**
+ * @file serve.cpp
+ * @brief Implementation of the serve command
+ *
+ * Keeps one analyzer and its model loaded and answers newline-delimited
+ * JSON requests on a Unix domain socket. Each connection has a reader
+ * thread that parses request lines into a bounded queue; one batching
+ * thread drains the queue into analyzeMultiple() calls and writes the
+ * responses back in request order. SIGHUP reloads the model from disk
+ * while requests keep being answered with the previous one. Requests that
+ * carry a label are reviewer feedback and update the live model.
+ */
+
+#include "bpicli/commands.hpp"
+#include "bpicli/bounded_queue.hpp"
+#include "bpicli/utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BPICLI_HAVE_UNIX_SOCKETS 1
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace bpicli {
+
+#ifdef BPICLI_HAVE_UNIX_SOCKETS
+
+namespace {
+
+/// Default socket path
+constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/blahajpi.sock";
+
+/// Default upper bound on texts per analyzeMultiple() call
+constexpr size_t DEFAULT_MAX_BATCH = 64;
+
+/// Default time the first request of a batch waits for company
+constexpr int DEFAULT_MAX_WAIT_MS = 5;
+
+/// Default number of queued requests before readers stop reading
+constexpr size_t DEFAULT_QUEUE_SIZE = 1024;
+
+/// Longest accepted request line
+constexpr size_t MAX_LINE_BYTES = 1 << 20;
+
+/// Set by SIGINT and SIGTERM
+volatile std::sig_atomic_t stopRequested = 0;
+
+/// Set by SIGHUP
+volatile std::sig_atomic_t reloadRequested = 0;
+
+/**
+ * @brief Signal handler that asks the server to stop
+ */
+extern "C" void onStopSignal(int) {
+    stopRequested = 1;
+}
+
+/**
+ * @brief Signal handler that asks the server to reload its model
+ */
+extern "C" void onReloadSignal(int) {
+    reloadRequested = 1;
+}
+
+/**
+ * @brief A client connection shared by its reader and the batcher
+ *
+ * The socket is closed when the last reference goes away, so responses
+ * to requests still in the queue are delivered after the client stops
+ * sending.
+ */
+struct Connection {
+    int fd;                    ///< Connected socket
+    std::mutex writeMutex;     ///< Serializes response writes
+
+    explicit Connection(int socketFd) : fd(socketFd) {}
+    ~Connection() { ::close(fd); }
+
+    /**
+     * @brief Writes one response line
+     * @param line Response without the trailing newline
+     * @return False if the client has gone away
+     */
+    bool send(const std::string& line) {
+        std::string data = line + "\n";
+        std::lock_guard<std::mutex> lock(writeMutex);
+        size_t written = 0;
+        while (written < data.size()) {
+#ifdef MSG_NOSIGNAL
+            ssize_t n = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+#else
+            ssize_t n = ::send(fd, data.data() + written, data.size() - written, 0);
+#endif
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief A parsed request waiting for the batcher
+ *
+ * Malformed requests carry their error response already, so every reply
+ * still goes out in request order.
+ */
+struct Request {
+    std::shared_ptr<Connection> connection;   ///< Where to send the response
+    std::string id;                           ///< Raw JSON id to echo (may be empty)
+    std::string text;                         ///< Text to analyze
+    std::string response;                     ///< Precomputed response, if any
+    bool stats = false;                       ///< Whether to reply with the analyzer counters
+    bool feedback = false;                    ///< Whether the text is a labeled sample to learn from
+    int label = 0;                            ///< Label of a feedback sample
+};
+
+/// Bounded FIFO between the connection readers and the batcher
+using RequestQueue = BoundedQueue<Request>;
+
+/**
+ * @brief Turns one request line into a queued request
+ *
+ * Lines are objects with a "text" member and an optional string or
+ * number "id" that is echoed back; a "label" member turns the text into
+ * feedback for the model, and {"command":"stats"} returns the analyzer
+ * counters.
+ *
+ * @param line Request line
+ * @param connection Connection the line came from
+ * @return Request, possibly with a precomputed error response
+ */
+Request parseRequest(std::string_view line, const std::shared_ptr<Connection>& connection) {
+    Request request;
+    request.connection = connection;
+
+    std::unordered_map<std::string, std::string> members;
+    if (!utils::parseJsonObject(line, members)) {
+        request.response = utils::errorToJson("Request is not a JSON object");
+        return request;
+    }
+
+    auto id = members.find("id");
+    if (id != members.end() && !utils::readJsonId(id->second, request.id)) {
+        request.response = utils::errorToJson("\"id\" must be a string or number");
+        return request;
+    }
+
+    auto command = members.find("command");
+    if (command != members.end()) {
+        std::string name;
+        if (utils::decodeJsonString(command->second, name) && name == "stats") {
+            request.stats = true;
+        } else {
+            request.response = utils::errorToJson("Unknown command", request.id);
+        }
+        return request;
+    }
+
+    auto text = members.find("text");
+    if (text == members.end() || !utils::decodeJsonString(text->second, request.text)) {
+        request.response = utils::errorToJson("Request needs a \"text\" string", request.id);
+        return request;
+    }
+
+    auto label = members.find("label");
+    if (label != members.end()) {
+        const std::string& raw = label->second;
+        auto [end, error] = std::from_chars(raw.data(), raw.data() + raw.size(), request.label);
+        if (error != std::errc() || end != raw.data() + raw.size()) {
+            request.response = utils::errorToJson("\"label\" must be an integer", request.id);
+        }
+        request.feedback = true;
+    }
+    return request;
+}
+
+/**
+ * @brief Reads request lines from a connection into the queue
+ *
+ * Blocks on the queue when it is full, which stops reading from the
+ * socket and pushes back on the client.
+ *
+ * @param connection Client connection
+ * @param queue Request queue
+ */
+void readRequests(std::shared_ptr<Connection> connection, RequestQueue& queue) {
+    std::string buffer;
+    char chunk[65536];
+
+    while (true) {
+        ssize_t n = ::recv(connection->fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+
+        size_t start = 0;
+        size_t newline;
+        while ((newline = buffer.find('\n', start)) != std::string::npos) {
+            std::string_view line(buffer.data() + start, newline - start);
+            start = newline + 1;
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (line.find_first_not_of(" \t") == std::string_view::npos) {
+                continue;
+            }
+            if (!queue.push(parseRequest(line, connection))) {
+                return;
+            }
+        }
+        buffer.erase(0, start);
+
+        if (buffer.size() > MAX_LINE_BYTES) {
+            Request request;
+            request.connection = connection;
+            request.response = utils::errorToJson("Request line too long");
+            queue.push(std::move(request));
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Writes the updated model if enough feedback has accumulated
+ * @param analyzer Analyzer holding the updated model
+ * @param savePath Directory to save into
+ * @param unsaved Feedback samples since the last save (reset once saved)
+ * @param threshold Samples needed before saving
+ */
+void saveFeedback(blahajpi::Analyzer& analyzer, const std::string& savePath, size_t& unsaved, size_t threshold) {
+    if (unsaved < std::max<size_t>(threshold, 1)) {
+        return;
+    }
+    if (analyzer.saveModel(savePath)) {
+        unsaved = 0;
+    } else {
+        utils::showError("Failed to save the updated model to " + savePath);
+    }
+}
+
+/**
+ * @brief Answers queued requests in batches until the queue closes
+ *
+ * Feedback samples of a batch are learned in one update after the
+ * batch's texts are analyzed.
+ *
+ * @param queue Request queue
+ * @param analyzer Analyzer with a loaded model
+ * @param maxBatch Maximum texts per analyzeMultiple() call
+ * @param maxWait Longest time a request waits for a batch to fill
+ * @param savePath Directory the updated model is saved to
+ * @param saveEvery Feedback samples between saves (0 = never save)
+ */
+void processBatches(RequestQueue& queue, blahajpi::Analyzer& analyzer, size_t maxBatch,
+                    std::chrono::milliseconds maxWait, const std::string& savePath, size_t saveEvery) {
+    std::vector<Request> batch;
+    std::vector<std::string> texts;
+    std::vector<std::string> feedbackTexts;
+    std::vector<int> feedbackLabels;
+    size_t unsaved = 0;
+
+    while (queue.popBatch(batch, maxBatch, maxWait)) {
+        texts.clear();
+        feedbackTexts.clear();
+        feedbackLabels.clear();
+        for (const auto& request : batch) {
+            if (!request.response.empty() || request.stats) {
+                continue;
+            }
+            if (request.feedback) {
+                feedbackTexts.push_back(request.text);
+                feedbackLabels.push_back(request.label);
+            } else {
+                texts.push_back(request.text);
+            }
+        }
+
+        std::vector<blahajpi::AnalysisResult> results;
+        std::string failure;
+        if (!texts.empty()) {
+            try {
+                // Responses carry no input or cleaned text, so neither is kept
+                results = analyzer.analyzeMultiple(
+                    texts, blahajpi::AnalysisResult::EXPLANATION | blahajpi::AnalysisResult::KEY_TERMS);
+            } catch (const std::exception& e) {
+                failure = e.what();
+            }
+        }
+
+        bool updated = false;
+        std::string updateFailure;
+        if (!feedbackTexts.empty()) {
+            try {
+                updated = analyzer.update(feedbackTexts, feedbackLabels);
+                if (!updated) {
+                    updateFailure = "The loaded model cannot be updated; train it with model-type = linear";
+                }
+            } catch (const std::exception& e) {
+                updateFailure = std::string("Update failed: ") + e.what();
+            }
+            if (updated) {
+                unsaved += feedbackTexts.size();
+                if (saveEvery > 0) {
+                    saveFeedback(analyzer, savePath, unsaved, saveEvery);
+                }
+            }
+        }
+        std::string version = std::to_string(analyzer.getModelVersion());
+
+        size_t next = 0;
+        for (auto& request : batch) {
+            if (request.response.empty() && request.feedback) {
+                if (!updated) {
+                    request.response = utils::errorToJson(updateFailure, request.id);
+                } else {
+                    request.response = request.id.empty()
+                        ? "{\"updated\":true,\"model_version\":" + version + "}"
+                        : "{\"id\":" + request.id + ",\"updated\":true,\"model_version\":" + version + "}";
+                }
+            } else if (request.stats) {
+                // Counters as of this batch, after everything queued before it
+                std::string stats = analyzer.getStats().toJson();
+                auto clusters = analyzer.getNearDuplicateClusters();
+                if (!clusters.empty()) {
+                    stats += ",\"clusters\":[";
+                    for (size_t i = 0; i < clusters.size(); ++i) {
+                        stats += (i > 0 ? ",{\"cluster\":\"" : "{\"cluster\":\"") +
+                                 blahajpi::AnalysisResult::formatCluster(clusters[i].first) +
+                                 "\",\"members\":" + std::to_string(clusters[i].second) + "}";
+                    }
+                    stats += ']';
+                }
+                request.response = request.id.empty()
+                    ? "{\"stats\":" + stats + "}"
+                    : "{\"id\":" + request.id + ",\"stats\":" + stats + "}";
+            } else if (request.response.empty()) {
+                request.response = failure.empty()
+                    ? utils::resultToJson(results[next], request.id)
+                    : utils::errorToJson("Analysis failed: " + failure, request.id);
+                ++next;
+            }
+            // A client that went away just loses its responses
+            request.connection->send(request.response);
+        }
+        batch.clear();
+    }
+
+    // Keep the feedback learned since the last save
+    if (saveEvery > 0) {
+        saveFeedback(analyzer, savePath, unsaved, 1);
+    }
+}
+
+} // namespace
+
+int handleServe(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    auto parsedArgs = utils::parseArgs(args);
+
+    std::string socketPath = parsedArgs.count("socket") > 0 ? parsedArgs["socket"] : DEFAULT_SOCKET_PATH;
+    long maxBatch = 0;
+    long maxWaitMs = 0;
+    long queueSize = 0;
+    long saveEvery = 0;
+    if (!utils::positiveOption(parsedArgs, "max-batch", DEFAULT_MAX_BATCH, maxBatch) ||
+        !utils::positiveOption(parsedArgs, "max-wait-ms", DEFAULT_MAX_WAIT_MS, maxWaitMs) ||
+        !utils::positiveOption(parsedArgs, "queue-size", DEFAULT_QUEUE_SIZE, queueSize) ||
+        !utils::positiveOption(parsedArgs, "save-every", 0, saveEvery)) {
+        return 1;
+    }
+
+    // Load the model once; without one every request would fail
+    if (parsedArgs.count("model") > 0 && !analyzer.loadModel(parsedArgs["model"])) {
+        utils::showError("Failed to load model from: " + parsedArgs["model"]);
+        return 1;
+    }
+    if (analyzer.getModelVersion() == 0) {
+        utils::showError("No model loaded. Use --model <dir> or set model-dir.");
+        return 1;
+    }
+
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        utils::showError("Socket path is too long: " + socketPath);
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        utils::showError("Could not create socket");
+        return 1;
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        utils::showError("Could not listen on socket: " + socketPath);
+        ::close(listenFd);
+        return 1;
+    }
+
+    // Reloads read the same directory the model was first loaded from
+    std::string modelPath = parsedArgs.count("model") > 0 ? parsedArgs["model"] : analyzer.getConfig()["model-dir"];
+    if (saveEvery > 0 && modelPath.empty()) {
+        utils::showError("--save-every needs a model directory; use --model <dir> or set model-dir");
+        ::close(listenFd);
+        ::unlink(socketPath.c_str());
+        return 1;
+    }
+
+    stopRequested = 0;
+    reloadRequested = 0;
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    std::signal(SIGHUP, onReloadSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Serving on " << socketPath << " (max batch " << maxBatch
+              << ", max wait " << maxWaitMs << " ms). Press Ctrl+C to stop." << std::endl;
+
+    RequestQueue queue(static_cast<size_t>(queueSize));
+    std::thread batcher(processBatches, std::ref(queue), std::ref(analyzer),
+                        static_cast<size_t>(maxBatch), std::chrono::milliseconds(maxWaitMs),
+                        std::cref(modelPath), static_cast<size_t>(saveEvery));
+
+    // Reader threads and the connection each one serves; finished readers are joined as we go
+    struct Reader {
+        std::thread thread;
+        std::weak_ptr<Connection> connection;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+    std::list<Reader> readers;
+
+    while (!stopRequested) {
+        pollfd pending{listenFd, POLLIN, 0};
+        int ready = ::poll(&pending, 1, 200);
+
+        for (auto it = readers.begin(); it != readers.end();) {
+            if (it->done->load()) {
+                it->thread.join();
+                it = readers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // The batcher keeps scoring with the old model while this one loads
+        if (reloadRequested) {
+            reloadRequested = 0;
+            if (modelPath.empty()) {
+                utils::showWarning("Reload requested, but the model was not loaded from a directory");
+            } else if (analyzer.loadModel(modelPath)) {
+                utils::showSuccess("Reloaded model from " + modelPath + " (version " +
+                                   std::to_string(analyzer.getModelVersion()) + ")");
+            } else {
+                utils::showError("Failed to reload model from " + modelPath + "; still serving the previous model");
+            }
+        }
+
+        if (ready <= 0) {
+            continue;
+        }
+        int clientFd = ::accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            continue;
+        }
+
+        auto connection = std::make_shared<Connection>(clientFd);
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        std::thread thread([connection, done, &queue]() mutable {
+            readRequests(std::move(connection), queue);
+            done->store(true);
+        });
+        readers.push_back({std::move(thread), connection, done});
+    }
+
+    std::cout << "\nShutting down..." << std::endl;
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+
+    // Stop reading, answer what is already queued, then stop batching
+    for (auto& reader : readers) {
+        if (auto connection = reader.connection.lock()) {
+            ::shutdown(connection->fd, SHUT_RD);
+        }
+    }
+    for (auto& reader : readers) {
+        reader.thread.join();
+    }
+    queue.close();
+    batcher.join();
+
+    return 0;
+}
+
+#else
+
+int handleServe(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    (void)args;
+    (void)analyzer;
+    utils::showError("The serve command needs Unix domain sockets, which this platform does not provide");
+    return 1;
+}
+
+#endif
+
+} // namespace bpicli
@@ -7,6 +7,7 @@
 #include "bpicli/utils.hpp"
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
 #include <chrono>
@@ -66,26 +67,17 @@ int handleTrain(const std::vector<std::string>& args, blahajpi::Analyzer& analyz
         textColumn = textIt->second;
     }
     
-    // Set column names in configuration
-    analyzer.setConfig("label-column", labelColumn);
-    analyzer.setConfig("text-column", textColumn);
-    
-    // Apply any overrides to the configuration
-    if (parsedArgs.count("alpha") > 0) {
-        analyzer.setConfig("alpha", parsedArgs["alpha"]);
-    }
-    
-    if (parsedArgs.count("eta0") > 0) {
-        analyzer.setConfig("eta0", parsedArgs["eta0"]);
-    }
-    
-    if (parsedArgs.count("epochs") > 0) {
-        analyzer.setConfig("epochs", parsedArgs["epochs"]);
-    }
-    
-    if (parsedArgs.count("seed") > 0) {
-        analyzer.setConfig("seed", parsedArgs["seed"]);
+    // Set column names and any overrides in one configuration change
+    std::unordered_map<std::string, std::string> settings = {
+        {"label-column", labelColumn},
+        {"text-column", textColumn}
+    };
+    for (const char* key : {"alpha", "eta0", "epochs", "seed"}) {
+        if (parsedArgs.count(key) > 0) {
+            settings[key] = parsedArgs[key];
+        }
     }
+    analyzer.setConfig(settings);
     
     // Show training configuration
     auto updatedConfig = analyzer.getConfig();
@@ -0,0 +1,161 @@
+/**
+ * @file tune.cpp
+ * @brief Implementation of the tune command
+ */
+
+#include "bpicli/commands.hpp"
+#include "bpicli/utils.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <iomanip>
+#include <type_traits>
+
+namespace bpicli {
+
+namespace {
+
+/**
+ * @brief Parses a comma-separated list of numbers
+ * @tparam T Number type (double or int)
+ * @param text List such as "0.0001,0.001"
+ * @param values Receives the parsed values
+ * @return False if any entry is not a number
+ */
+template <typename T>
+bool parseList(const std::string& text, std::vector<T>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        try {
+            size_t used = 0;
+            T value;
+            if constexpr (std::is_same_v<T, int>) {
+                value = std::stoi(item, &used);
+            } else {
+                value = std::stod(item, &used);
+            }
+            if (used != item.size()) {
+                return false;
+            }
+            values.push_back(value);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !values.empty();
+}
+
+/**
+ * @brief Formats a metric with a fixed number of decimals
+ * @param value Metric value
+ * @return Formatted value
+ */
+std::string formatMetric(double value) {
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(4) << value;
+    return stream.str();
+}
+
+} // namespace
+
+int handleTune(const std::vector<std::string>& args, blahajpi::Analyzer& analyzer) {
+    auto parsedArgs = utils::parseArgs(args);
+
+    if (parsedArgs.count("dataset") == 0) {
+        utils::showError("Missing required argument: --dataset");
+        std::cout << "Usage: blahajpi tune --dataset <path> [--alpha <list>] [--eta0 <list>] [--epochs <list>]" << std::endl;
+        return 1;
+    }
+
+    std::string datasetPath = parsedArgs["dataset"];
+    if (!std::filesystem::exists(datasetPath)) {
+        utils::showError("Dataset file not found: " + datasetPath);
+        return 1;
+    }
+
+    blahajpi::TuningGrid grid;
+    if (parsedArgs.count("alpha") > 0 && !parseList(parsedArgs["alpha"], grid.alphas)) {
+        utils::showError("Invalid --alpha list: " + parsedArgs["alpha"]);
+        return 1;
+    }
+    if (parsedArgs.count("eta0") > 0 && !parseList(parsedArgs["eta0"], grid.eta0s)) {
+        utils::showError("Invalid --eta0 list: " + parsedArgs["eta0"]);
+        return 1;
+    }
+    if (parsedArgs.count("epochs") > 0 && !parseList(parsedArgs["epochs"], grid.epochs)) {
+        utils::showError("Invalid --epochs list: " + parsedArgs["epochs"]);
+        return 1;
+    }
+
+    long folds = 0;
+    if (!utils::positiveOption(parsedArgs, "folds", 0, folds)) {
+        return 1;
+    }
+    if (folds > 0) {
+        analyzer.setConfig("cv-folds", std::to_string(folds));
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<blahajpi::TuningResult> results;
+    try {
+        results = analyzer.tune(datasetPath, grid);
+    } catch (const std::exception& e) {
+        utils::showError("Tuning error: " + std::string(e.what()));
+        return 1;
+    }
+
+    if (results.empty()) {
+        utils::showError("Tuning failed");
+        return 1;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
+
+    std::vector<std::vector<std::string>> rows;
+    std::ostringstream csv;
+    csv << "alpha,eta0,epochs,accuracy,accuracy_std,macro_precision,macro_recall,macro_f1,f1_harmful\n";
+    for (const auto& result : results) {
+        std::ostringstream alpha;
+        alpha << result.alpha;
+        std::ostringstream eta0;
+        eta0 << result.eta0;
+
+        rows.push_back({
+            alpha.str(), eta0.str(), std::to_string(result.epochs),
+            formatMetric(result.metrics.at("accuracy")) + " +/- " + formatMetric(result.accuracyStdDev),
+            formatMetric(result.metrics.at("macro_f1")),
+            formatMetric(result.metrics.at("f1_harmful"))
+        });
+        csv << alpha.str() << "," << eta0.str() << "," << result.epochs << ","
+            << result.metrics.at("accuracy") << "," << result.accuracyStdDev << ","
+            << result.metrics.at("macro_precision") << "," << result.metrics.at("macro_recall") << ","
+            << result.metrics.at("macro_f1") << "," << result.metrics.at("f1_harmful") << "\n";
+    }
+
+    std::cout << std::endl;
+    utils::printTable({"alpha", "eta0", "epochs", "accuracy", "macro F1", "harmful F1"}, rows);
+    std::cout << "\nTuning completed in " << duration.count() << " seconds" << std::endl;
+
+    const auto& best = results.front();
+    std::cout << "Best setting: alpha = " << best.alpha << ", eta0 = " << best.eta0
+              << ", epochs = " << best.epochs << std::endl;
+
+    if (parsedArgs.count("output") > 0) {
+        if (!utils::saveToFile(csv.str(), parsedArgs["output"])) {
+            utils::showError("Failed to write results to: " + parsedArgs["output"]);
+            return 1;
+        }
+        utils::showSuccess("Results saved to: " + parsedArgs["output"]);
+    }
+
+    return 0;
+}
+
+} // namespace bpicli
@@ -5,6 +5,7 @@
 
 #include "blahajpi/analyzer.hpp"
 #include "bpicli/commands.hpp"
+#include "bpicli/utils.hpp"
 #include <iostream>
 #include <string>
 #include <unordered_map>
@@ -28,12 +29,18 @@ int main(int argc, char* argv[]) {
     // Process command line arguments
     std::vector<std::string> args;
     std::string configPath;
+    std::string statsFormat;
+    std::string statsPath;
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
         
         if (arg == "--config" && i + 1 < argc) {
             configPath = argv[++i];
+        } else if (arg == "--stats" && i + 1 < argc) {
+            statsFormat = argv[++i];
+        } else if (arg == "--stats-out" && i + 1 < argc) {
+            statsPath = argv[++i];
         } else if (arg == "--version") {
             blahajpi::Analyzer analyzer;
             return bpicli::handleVersion({}, analyzer);
@@ -45,6 +52,14 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (!statsFormat.empty() && statsFormat != "json" && statsFormat != "prometheus") {
+        std::cerr << "Error: Unknown stats format '" << statsFormat << "' (use json or prometheus)" << std::endl;
+        return 1;
+    }
+    if (!statsPath.empty() && statsFormat.empty()) {
+        statsFormat = "json";
+    }
+    
     // If no command specified, show help
     if (args.empty()) {
         blahajpi::Analyzer analyzer;
@@ -69,7 +84,20 @@ int main(int argc, char* argv[]) {
     // Execute command
     auto it = commands.find(command);
     if (it != commands.end()) {
-        return it->second.handler(args, analyzer);
+        int exitCode = it->second.handler(args, analyzer);
+        
+        // Dump instrumentation counters; stderr keeps them out of piped results
+        if (!statsFormat.empty()) {
+            blahajpi::utils::AnalyzerStats stats = analyzer.getStats();
+            std::string dump = statsFormat == "prometheus" ? stats.toPrometheus() : stats.toJson() + "\n";
+            if (statsPath.empty()) {
+                std::cerr << dump;
+            } else if (!bpicli::utils::saveToFile(dump, statsPath)) {
+                std::cerr << "Error: Failed to write stats to " << statsPath << std::endl;
+            }
+        }
+        
+        return exitCode;
     } else {
         std::cerr << "Error: Unknown command '" << command << "'" << std::endl;
         std::cerr << "Run 'blahajpi --help' for usage information" << std::endl;
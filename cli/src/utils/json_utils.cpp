@@ -0,0 +1,334 @@
+/**
+ * @file json_utils.cpp
+ * @brief Implementation of the line-oriented JSON helpers
+ *
+ * Only what newline-delimited JSON requests need: flat objects whose
+ * members are read as raw values, string decoding and result encoding.
+ */
+
+#include "bpicli/utils.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+
+namespace bpicli {
+namespace utils {
+
+namespace {
+
+/**
+ * @brief Skips JSON whitespace
+ * @param text Text being parsed
+ * @param pos Position, advanced past the whitespace
+ */
+void skipSpace(std::string_view text, size_t& pos) {
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+        ++pos;
+    }
+}
+
+/**
+ * @brief Skips a string literal
+ * @param text Text being parsed
+ * @param pos Position of the opening quote, advanced past the closing quote
+ * @return True if the string is terminated
+ */
+bool skipString(std::string_view text, size_t& pos) {
+    for (++pos; pos < text.size(); ++pos) {
+        if (text[pos] == '\\') {
+            ++pos;
+        } else if (text[pos] == '"') {
+            ++pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Skips one JSON value of any type
+ * @param text Text being parsed
+ * @param pos Position of the value, advanced past it
+ * @return True if a value was found
+ */
+bool skipValue(std::string_view text, size_t& pos) {
+    if (pos >= text.size()) {
+        return false;
+    }
+
+    char c = text[pos];
+    if (c == '"') {
+        return skipString(text, pos);
+    }
+
+    if (c == '{' || c == '[') {
+        // Nested containers are kept raw; only brackets outside strings count
+        int depth = 0;
+        while (pos < text.size()) {
+            char d = text[pos];
+            if (d == '"') {
+                if (!skipString(text, pos)) return false;
+                continue;
+            }
+            if (d == '{' || d == '[') ++depth;
+            if (d == '}' || d == ']') --depth;
+            ++pos;
+            if (depth == 0) return true;
+        }
+        return false;
+    }
+
+    // Numbers, true, false and null run until a delimiter
+    size_t start = pos;
+    while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+           text[pos] != ' ' && text[pos] != '\t' && text[pos] != '\r' && text[pos] != '\n') {
+        ++pos;
+    }
+    return pos > start;
+}
+
+/**
+ * @brief Appends a code point as UTF-8
+ * @param codePoint Unicode code point
+ * @param out Output text
+ */
+void appendUtf8(uint32_t codePoint, std::string& out) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+/**
+ * @brief Reads four hex digits of a \u escape
+ * @param text Text being decoded
+ * @param pos Position of the first digit
+ * @param value Output value
+ * @return True if four hex digits were read
+ */
+bool readHex4(std::string_view text, size_t pos, uint32_t& value) {
+    if (pos + 4 > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        char c = text[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::string jsonQuote(std::string_view text) {
+    std::string out;
+    out.reserve(text.size() + 2);
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[7];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escape;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+bool parseJsonObject(std::string_view line, std::unordered_map<std::string, std::string>& members) {
+    members.clear();
+
+    size_t pos = 0;
+    skipSpace(line, pos);
+    if (pos >= line.size() || line[pos] != '{') {
+        return false;
+    }
+    ++pos;
+    skipSpace(line, pos);
+
+    if (pos < line.size() && line[pos] == '}') {
+        ++pos;
+    } else {
+        while (true) {
+            // Member name
+            skipSpace(line, pos);
+            size_t nameStart = pos;
+            if (pos >= line.size() || line[pos] != '"' || !skipString(line, pos)) {
+                return false;
+            }
+            std::string name;
+            if (!decodeJsonString(line.substr(nameStart, pos - nameStart), name)) {
+                return false;
+            }
+
+            skipSpace(line, pos);
+            if (pos >= line.size() || line[pos] != ':') {
+                return false;
+            }
+            ++pos;
+            skipSpace(line, pos);
+
+            // Raw value
+            size_t valueStart = pos;
+            if (!skipValue(line, pos)) {
+                return false;
+            }
+            members[name] = std::string(line.substr(valueStart, pos - valueStart));
+
+            skipSpace(line, pos);
+            if (pos < line.size() && line[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos < line.size() && line[pos] == '}') {
+                ++pos;
+                break;
+            }
+            return false;
+        }
+    }
+
+    skipSpace(line, pos);
+    return pos == line.size();
+}
+
+bool decodeJsonString(std::string_view raw, std::string& value) {
+    value.clear();
+    if (raw.size() < 2 || raw.front() != '"' || raw.back() != '"') {
+        return false;
+    }
+
+    std::string_view body = raw.substr(1, raw.size() - 2);
+    value.reserve(body.size());
+    for (size_t i = 0; i < body.size(); ++i) {
+        char c = body[i];
+        if (c != '\\') {
+            value += c;
+            continue;
+        }
+
+        if (++i >= body.size()) {
+            return false;
+        }
+        switch (body[i]) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                uint32_t codePoint = 0;
+                if (!readHex4(body, i + 1, codePoint)) {
+                    return false;
+                }
+                i += 4;
+
+                // Surrogate pairs encode code points above the BMP
+                uint32_t low = 0;
+                if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 2 < body.size() &&
+                    body[i + 1] == '\\' && body[i + 2] == 'u' && readHex4(body, i + 3, low) &&
+                    low >= 0xDC00 && low < 0xE000) {
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(codePoint, value);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool readJsonId(std::string_view raw, std::string& id) {
+    id.clear();
+    std::string decoded;
+    if (decodeJsonString(raw, decoded)) {
+        id = jsonQuote(decoded);
+        return true;
+    }
+
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t pos = 0;
+    auto digits = [&]() {
+        size_t start = pos;
+        while (pos < raw.size() && raw[pos] >= '0' && raw[pos] <= '9') {
+            ++pos;
+        }
+        return pos > start;
+    };
+    if (pos < raw.size() && raw[pos] == '-') {
+        ++pos;
+    }
+    if (pos < raw.size() && raw[pos] == '0') {
+        ++pos;
+    } else if (!digits()) {
+        return false;
+    }
+    if (pos < raw.size() && raw[pos] == '.') {
+        ++pos;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (pos < raw.size() && (raw[pos] == 'e' || raw[pos] == 'E')) {
+        ++pos;
+        if (pos < raw.size() && (raw[pos] == '+' || raw[pos] == '-')) {
+            ++pos;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (pos != raw.size()) {
+        return false;
+    }
+    id.assign(raw);
+    return true;
+}
+
+std::string resultToJson(const blahajpi::AnalysisResult& result, const std::string& id) {
+    std::string out;
+    result.appendJson(out, id);
+    return out;
+}
+
+std::string errorToJson(const std::string& message, const std::string& id) {
+    std::string response = "{";
+    if (!id.empty()) {
+        response += "\"id\":" + id + ",";
+    }
+    return response + "\"error\":" + jsonQuote(message) + "}";
+}
+
+} // namespace utils
+} // namespace bpicli
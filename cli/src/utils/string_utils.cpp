@@ -61,14 +61,30 @@ std::unordered_map<std::string, std::string> parseArgs(const std::vector<std::st
 }
 
 std::string loadFileContent(const std::string& filePath) {
-    std::ifstream file(filePath);
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(filePath, error);
+    
+    std::ifstream file(filePath, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Could not open file: " + filePath);
     }
     
+    // Read regular files with a single call into a buffer of the right size
+    std::string content;
+    if (!error && fileSize > 0) {
+        content.resize(static_cast<size_t>(fileSize));
+        file.read(content.data(), static_cast<std::streamsize>(content.size()));
+        content.resize(static_cast<size_t>(file.gcount()));
+        if (file.gcount() < static_cast<std::streamsize>(fileSize) || file.peek() == std::ifstream::traits_type::eof()) {
+            return content;
+        }
+    }
+    
+    // Files whose size is unknown (pipes, /proc) or that grew while reading
     std::stringstream buffer;
     buffer << file.rdbuf();
-    return buffer.str();
+    content += buffer.str();
+    return content;
 }
 
 bool saveToFile(const std::string& content, const std::string& filePath) {
@@ -164,6 +180,25 @@ std::string formatResult(const blahajpi::AnalysisResult& result, bool verbose) {
     return output.str();
 }
 
+bool positiveOption(const std::unordered_map<std::string, std::string>& parsedArgs, const std::string& key,
+                    long defaultValue, long& value) {
+    auto it = parsedArgs.find(key);
+    if (it == parsedArgs.end()) {
+        value = defaultValue;
+        return true;
+    }
+    try {
+        value = std::stol(it->second);
+    } catch (const std::exception&) {
+        value = 0;
+    }
+    if (value <= 0) {
+        utils::showError("--" + key + " needs a positive integer");
+        return false;
+    }
+    return true;
+}
+
 std::string readInput(const std::string& prompt, const std::string& filePath) {
     if (!filePath.empty()) {
         return loadFileContent(filePath);
@@ -11,10 +11,15 @@
 
 #pragma once
 
+#include "blahajpi/utils/stats.hpp"
+
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <memory>
+#include <span>
 #include <unordered_map>
 
 namespace blahajpi {
@@ -40,8 +45,24 @@ namespace utils {
  * 
  * Contains the analysis result including sentiment classification,
  * confidence score, and explanatory details.
+ * 
+ * The sentiment and scores are always filled in. The other parts cost as
+ * much to produce as the score itself in high-volume use, so callers can
+ * ask for only some of them; `fields` records which ones a result holds.
  */
 struct AnalysisResult {
+    /**
+     * @brief Optional parts of a result, combined with |
+     */
+    enum Field : uint32_t {
+        TEXT = 1u << 0,           ///< Copy of the input text
+        CLEANED_TEXT = 1u << 1,   ///< Preprocessed text
+        KEY_TERMS = 1u << 2,      ///< Terms that contributed to the classification
+        EXPLANATION = 1u << 3,    ///< Human-readable explanation
+        SCORES_ONLY = 0u,         ///< Sentiment, harm score and confidence only
+        ALL_FIELDS = TEXT | CLEANED_TEXT | KEY_TERMS | EXPLANATION  ///< Everything
+    };
+    
     std::string text;             ///< Original input text
     std::string cleanedText;      ///< Preprocessed text
     std::string sentiment;        ///< "Harmful" or "Safe"
@@ -49,9 +70,42 @@ struct AnalysisResult {
     double confidence;            ///< Confidence in the classification (0-1)
     std::string explanation;      ///< Human-readable explanation of the result
     std::vector<std::string> keyTerms; ///< Terms that contributed to the classification
+    uint32_t fields = ALL_FIELDS; ///< Field bits of the optional parts that were filled in
+    uint64_t cluster = 0;         ///< Near-duplicate cluster of the text (0 = none, or the stage is off)
+    
+    /**
+     * @brief Builds the explanation text from the score, confidence and key terms
+     * 
+     * This is what the analyzer stores in `explanation` when asked to, so
+     * results produced without EXPLANATION can still be explained later.
+     * 
+     * @return Human-readable explanation
+     */
+    std::string makeExplanation() const;
+    
+    /**
+     * @brief Formats a near-duplicate cluster for output
+     * @param cluster Cluster ID
+     * @return Cluster as 16 hex digits, or empty for 0 (no cluster)
+     */
+    static std::string formatCluster(uint64_t cluster);
+    
+    /**
+     * @brief Appends the result as one JSON object
+     * 
+     * Writes the sentiment and scores, plus the explanation and key terms
+     * when the result holds them, without going through toMap().
+     * 
+     * @param out String to append to
+     * @param id Raw JSON value to store as "id" (omitted if empty)
+     */
+    void appendJson(std::string& out, std::string_view id = {}) const;
     
     /**
      * @brief Convert result to a map for serialization
+     * 
+     * Optional parts whose field bits are not set are left out of the map.
+     * 
      * @return Map representation of the result
      */
     std::unordered_map<std::string, std::string> toMap() const;
@@ -64,6 +118,29 @@ struct AnalysisResult {
     static AnalysisResult fromMap(const std::unordered_map<std::string, std::string>& map);
 };
 
+/**
+ * @brief Hyperparameter values searched by Analyzer::tune()
+ * 
+ * Every combination of the listed values is cross-validated. An empty
+ * list searches only the configured value.
+ */
+struct TuningGrid {
+    std::vector<double> alphas;   ///< Regularization strengths
+    std::vector<double> eta0s;    ///< Initial learning rates
+    std::vector<int> epochs;      ///< Numbers of training epochs
+};
+
+/**
+ * @brief Cross-validated performance of one hyperparameter setting
+ */
+struct TuningResult {
+    double alpha = 0.0;           ///< Regularization strength
+    double eta0 = 0.0;            ///< Initial learning rate
+    int epochs = 0;               ///< Number of training epochs
+    std::unordered_map<std::string, double> metrics; ///< Metrics::calculateMetrics() over all out-of-fold predictions
+    double accuracyStdDev = 0.0;  ///< Standard deviation of the per-fold accuracy
+};
+
 // Forward declaration of implementation class
 class AnalyzerImpl;
 
@@ -72,6 +149,11 @@ class AnalyzerImpl;
  * 
  * The Analyzer class provides methods to analyze text content for
  * potentially harmful content targeting transgender individuals.
+ * 
+ * Analysis may run on several threads while another thread loads or
+ * trains a model or changes the configuration. The model is swapped in
+ * atomically, analyses never wait for the swap, and calls that are
+ * already running finish with the model they started on.
  */
 class Analyzer {
 public:
@@ -94,24 +176,64 @@ public:
     /**
      * @brief Analyze text for harmful content
      * @param text Text to analyze
+     * @param fields AnalysisResult::Field bits of the optional parts to fill in
      * @return Analysis result
      */
-    AnalysisResult analyze(const std::string& text);
+    AnalysisResult analyze(const std::string& text, uint32_t fields = AnalysisResult::ALL_FIELDS);
     
     /**
      * @brief Analyze multiple texts
+     * 
+     * With fewer fields, the work for the parts left out is skipped: no
+     * key terms are searched for without KEY_TERMS or EXPLANATION, and the
+     * input text is not copied without TEXT (results stay in input order).
+     * 
      * @param texts Collection of texts to analyze
+     * @param fields AnalysisResult::Field bits of the optional parts to fill in
      * @return Vector of analysis results
      */
-    std::vector<AnalysisResult> analyzeMultiple(const std::vector<std::string>& texts);
+    std::vector<AnalysisResult> analyzeMultiple(
+        const std::vector<std::string>& texts,
+        uint32_t fields = AnalysisResult::ALL_FIELDS);
+    
+    /**
+     * @brief Score texts held in caller-owned memory
+     * 
+     * The zero-copy counterpart of analyzeMultiple() with SCORES_ONLY
+     * fields: texts are read in place and only their numbers are written
+     * out, so scoring a batch allocates nothing per text. A text is
+     * harmful when its score is above 0.
+     * 
+     * @param texts Texts to score
+     * @param scores Receives one decision score per text (empty = not wanted)
+     * @param probabilities Receives one harmful-class probability per text (empty = not wanted)
+     * @throws std::invalid_argument If an output is neither empty nor texts.size() long
+     * @throws std::runtime_error If no model is loaded
+     */
+    void scoreBatch(
+        std::span<const std::string_view> texts,
+        std::span<double> scores,
+        std::span<double> probabilities = {});
     
     /**
      * @brief Load a model from a specified path
+     * 
+     * The current model keeps serving while the new one is read and is
+     * replaced only once loading succeeds, so this can be used to hot
+     * reload a retrained model. Both models are in memory during the swap.
+     * 
      * @param modelPath Path to the model directory
-     * @return True if loading was successful
+     * @return True if loading was successful (the old model stays otherwise)
      */
     bool loadModel(const std::string& modelPath);
     
+    /**
+     * @brief Get the version of the model analyses currently use
+     * @return 0 before any model is available, incremented each time a
+     *         trained or loaded model is swapped in
+     */
+    uint64_t getModelVersion() const;
+    
     /**
      * @brief Train a new model from labeled data
      * @param dataPath Path to labeled dataset file
@@ -120,6 +242,62 @@ public:
      */
     bool trainModel(const std::string& dataPath, const std::string& outputPath);
     
+    /**
+     * @brief Cross-validate a grid of linear model settings
+     * 
+     * Splits the dataset into `cv-folds` stratified folds. Every text is
+     * preprocessed once and each fold's features are extracted once, then
+     * every setting is trained on every fold in parallel across the
+     * configured threads. The published model and the configuration are
+     * left unchanged.
+     * 
+     * @param dataPath Path to labeled dataset file
+     * @param grid Values to search
+     * @return One result per setting, best macro F1 first (empty if the
+     *         dataset could not be loaded or has fewer samples than folds)
+     */
+    std::vector<TuningResult> tune(const std::string& dataPath, const TuningGrid& grid);
+    
+    /**
+     * @brief Apply incremental training steps to the live model
+     * 
+     * Runs one SGD pass over the samples on a copy of the current linear
+     * model and swaps the copy in, so analyses never wait for an update.
+     * The vectorizer stays frozen: with TF-IDF features, terms outside the
+     * trained vocabulary are ignored, while hashed features cover every
+     * term. Updates live in memory until saveModel() writes them out.
+     * 
+     * @param texts Raw texts
+     * @param labels Labels for each text (0 = safe, non-zero = harmful)
+     * @return True if the model was updated (false if no linear model is loaded)
+     * @throws std::invalid_argument If texts and labels have different sizes
+     */
+    bool update(const std::vector<std::string>& texts, const std::vector<int>& labels);
+    
+    /**
+     * @brief Save the model analyses currently use
+     * @param outputPath Directory to save into (loadModel() reads it back)
+     * @return True if saving was successful
+     */
+    bool saveModel(const std::string& outputPath) const;
+    
+    /**
+     * @brief Drop the features the loaded linear model barely uses
+     * 
+     * Removes every vocabulary term whose absolute weight is below the
+     * threshold, renumbers the remaining weights, publishes the smaller
+     * model and saves it. With a dataset, the texts are scored before and
+     * after, and the change in accuracy and macro F1 is printed. Training
+     * does the same when `compact-threshold` is set.
+     * 
+     * @param outputPath Directory to save the compacted model into
+     * @param threshold Smallest absolute weight a feature keeps
+     * @param dataPath Labeled dataset to measure the change on (empty = not measured)
+     * @return True if the model was compacted and saved (false without a
+     *         linear model on TF-IDF features, or if no feature was pruned)
+     */
+    bool compactModel(const std::string& outputPath, double threshold, const std::string& dataPath = "");
+    
     /**
      * @brief Generate a word cloud visualization
      * @param analysisResults Analysis results to visualize
@@ -154,17 +332,59 @@ public:
     
     /**
      * @brief Set a configuration parameter
+     * 
+     * Only the components the key affects are rebuilt; the model is
+     * reloaded only when model-dir or a setting read while loading it
+     * (model-type, hidden-layers, hidden-size, nn-float32) changes.
+     * 
      * @param key Parameter name
      * @param value Parameter value
      */
     void setConfig(const std::string& key, const std::string& value);
     
+    /**
+     * @brief Set several configuration parameters at once
+     * 
+     * Applies the new values together, so components affected by more
+     * than one of them are rebuilt once.
+     * 
+     * @param values Parameter names and values
+     */
+    void setConfig(const std::unordered_map<std::string, std::string>& values);
+    
     /**
      * @brief Load configuration from a file
      * @param configPath Path to the configuration file
      * @return True if loading was successful
      */
     bool loadConfig(const std::string& configPath);
+    
+    /**
+     * @brief Get per-stage latency and throughput counters
+     * 
+     * Safe to call while other threads analyze. Counters cover the time
+     * since construction or the last resetStats().
+     * 
+     * @return Snapshot of the counters (enabled = false when the library
+     *         was built with ENABLE_STATS=OFF)
+     */
+    utils::AnalyzerStats getStats() const;
+    
+    /**
+     * @brief Reset the latency and throughput counters
+     */
+    void resetStats();
+    
+    /**
+     * @brief Get the largest near-duplicate clusters of the current model
+     * 
+     * Clusters are only formed with near-duplicates = true and start over
+     * when a model is loaded or the configuration changes.
+     * 
+     * @param maxClusters Largest number of clusters to return
+     * @return Pairs of cluster ID and member count, largest first (only clusters of two or more texts)
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> getNearDuplicateClusters(size_t maxClusters = 10) const;
 
 private:
     // Implementation details are in a separate class
@@ -0,0 +1,130 @@
+/**
+ * @file c_api.h
+ * @brief Stable C interface to the analyzer
+ *
+ * A plain C ABI for callers that cannot use the C++ classes, such as
+ * language bindings loading the shared library at run time. Analyzers
+ * are opaque handles, failures are reported as status codes with a
+ * message from bpi_last_error(), and batches are passed as one UTF-8
+ * buffer plus an offsets array so no per-message objects are built on
+ * either side of the boundary.
+ *
+ * Functions are only ever added to this header; BPI_ABI_VERSION is
+ * raised when that happens so callers can check for them at run time.
+ */
+
+#ifndef BLAHAJPI_C_API_H
+#define BLAHAJPI_C_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define BPI_API __attribute__((visibility("default")))
+#else
+#define BPI_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the functions and types declared here */
+#define BPI_ABI_VERSION 1
+
+/**
+ * @brief Status codes returned by the functions below
+ */
+enum bpi_status {
+    BPI_OK = 0,               /**< Success */
+    BPI_INVALID_ARGUMENT = 1, /**< A null handle, bad offsets or similar */
+    BPI_NO_MODEL = 2,         /**< Scoring was asked for before a model was loaded */
+    BPI_FAILED = 3            /**< Any other failure; see bpi_last_error() */
+};
+
+/**
+ * @brief Opaque analyzer handle
+ */
+typedef struct bpi_analyzer bpi_analyzer;
+
+/**
+ * @brief Gets the ABI version of the loaded library
+ * @return BPI_ABI_VERSION the library was built with
+ */
+BPI_API uint32_t bpi_abi_version(void);
+
+/**
+ * @brief Creates an analyzer
+ * @param config_path Configuration file to load, or NULL for the defaults
+ * @return New handle, or NULL if the configuration could not be loaded
+ */
+BPI_API bpi_analyzer* bpi_create(const char* config_path);
+
+/**
+ * @brief Destroys an analyzer
+ * @param analyzer Handle from bpi_create() (NULL is ignored)
+ */
+BPI_API void bpi_destroy(bpi_analyzer* analyzer);
+
+/**
+ * @brief Sets one configuration value
+ * @param analyzer Analyzer handle
+ * @param key Parameter name
+ * @param value Parameter value
+ * @return BPI_OK or an error status
+ */
+BPI_API int bpi_set_config(bpi_analyzer* analyzer, const char* key, const char* value);
+
+/**
+ * @brief Loads a trained model, replacing the current one on success
+ * @param analyzer Analyzer handle
+ * @param model_path Model directory
+ * @return BPI_OK or an error status (the old model stays on failure)
+ */
+BPI_API int bpi_load_model(bpi_analyzer* analyzer, const char* model_path);
+
+/**
+ * @brief Gets the version of the model scores currently come from
+ * @param analyzer Analyzer handle
+ * @return 0 before any model is loaded or for a NULL handle
+ */
+BPI_API uint64_t bpi_model_version(const bpi_analyzer* analyzer);
+
+/**
+ * @brief Scores a batch of texts held in one buffer
+ *
+ * Text i is the bytes data[offsets[i]] to data[offsets[i + 1]], so
+ * offsets holds count + 1 non-decreasing entries. Results are written
+ * to the caller's arrays, each count entries long; any of them may be
+ * NULL when not wanted. Nothing is allocated per text, and several
+ * threads may score with the same handle at once.
+ *
+ * @param analyzer Analyzer handle
+ * @param data Concatenated UTF-8 texts (may be NULL when count is 0)
+ * @param offsets Start of each text, then the end of the last one
+ * @param count Number of texts
+ * @param scores Receives the decision scores (harmful when above 0)
+ * @param probabilities Receives the harmful-class probabilities
+ * @param labels Receives 1 for harmful texts and 0 for safe ones
+ * @return BPI_OK or an error status (outputs are unspecified on error)
+ */
+BPI_API int bpi_score_batch(
+    bpi_analyzer* analyzer,
+    const char* data,
+    const uint64_t* offsets,
+    size_t count,
+    double* scores,
+    double* probabilities,
+    uint8_t* labels);
+
+/**
+ * @brief Gets the message of the last error on the calling thread
+ * @return Message, or an empty string; valid until the next call on the thread
+ */
+BPI_API const char* bpi_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BLAHAJPI_C_API_H */
@@ -16,6 +16,21 @@
 namespace blahajpi {
 namespace evaluation {
 
+/**
+ * @brief Results of one sweep over scores sorted by decreasing value
+ * 
+ * Thresholds follow findOptimalThreshold(): a text is predicted harmful
+ * when its score is strictly greater than the threshold.
+ */
+struct Evaluation {
+    double auc = 0.5;                                    ///< Area under the ROC curve (0.5 if only one class is present)
+    std::unordered_map<double, double> precisionAtRecall; ///< Interpolated precision at each requested recall level (empty without positives)
+    double threshold = 0.0;                              ///< Threshold that maximizes the chosen metric
+    double thresholdMetric = 0.0;                        ///< Value of the chosen metric at that threshold
+    std::vector<std::vector<int>> confusion;             ///< [[TN, FP], [FN, TP]] at that threshold
+    std::unordered_map<std::string, double> metrics;     ///< calculateMetrics() values at that threshold
+};
+
 /**
  * @brief Contains methods for evaluating classification performance
  * 
@@ -121,6 +136,40 @@ public:
         const std::string& metric = "f1"
     );
 
+    /**
+     * @brief Computes every score-based metric from a single sort
+     * 
+     * Scores are sorted once (in parallel for large inputs) and one sweep
+     * over the cumulative true and false positive counts yields the AUC,
+     * the precision-recall curve, the best threshold for the chosen metric
+     * and the confusion matrix at that threshold. Tied scores are treated
+     * as one step of the curves.
+     * 
+     * @param yTrue Ground truth labels (0 = safe, anything else = harmful)
+     * @param scores Predicted scores or probabilities
+     * @param metric Metric to optimize ("f1", "accuracy", "precision", "recall")
+     * @param recallLevels Recall levels at which to report precision
+     * @param threads Threads for sorting (0 = all hardware threads)
+     * @return Evaluation results
+     */
+    static Evaluation evaluate(
+        const std::vector<int>& yTrue,
+        const std::vector<double>& scores,
+        const std::string& metric = "f1",
+        const std::vector<double>& recallLevels = {0.25, 0.5, 0.75, 0.9, 0.95},
+        size_t threads = 0
+    );
+
+    /**
+     * @brief Computes the calculateMetrics() values from confusion counts
+     * @param tn True negatives
+     * @param fp False positives
+     * @param fn False negatives
+     * @param tp True positives
+     * @return Map containing all computed metrics
+     */
+    static std::unordered_map<std::string, double> calculateMetricsFromCounts(int tn, int fp, int fn, int tp);
+
 private:
     /**
      * @brief Calculates precision score
@@ -156,5 +205,70 @@ private:
     static double accuracy(int tp, int tn, int total);
 };
 
+/**
+ * @brief Fixed-size binned score counts for approximate evaluation
+ * 
+ * Keeps positive and negative counts per score bin instead of the scores
+ * themselves, so score sets too large for memory can be evaluated in a
+ * stream, and histograms filled by different threads can be merged.
+ * Every bin acts as one tied group at its lower edge, so the AUC is
+ * exact up to ordering within a bin and thresholds are bin edges.
+ */
+class ScoreHistogram {
+public:
+    /**
+     * @brief Constructor
+     * @param minScore Lower edge of the first bin (lower scores are counted in it)
+     * @param maxScore Upper edge of the last bin (higher scores are counted in it)
+     * @param bins Number of bins (at least 1)
+     * @throws std::invalid_argument If maxScore is not greater than minScore
+     */
+    explicit ScoreHistogram(double minScore = 0.0, double maxScore = 1.0, size_t bins = 4096);
+    
+    /**
+     * @brief Counts one scored sample
+     * @param label Ground truth label (0 = safe)
+     * @param score Predicted score
+     */
+    void add(int label, double score);
+    
+    /**
+     * @brief Counts a batch of scored samples
+     * @param yTrue Ground truth labels
+     * @param scores Predicted scores
+     */
+    void add(const std::vector<int>& yTrue, const std::vector<double>& scores);
+    
+    /**
+     * @brief Adds the counts of another histogram with the same bins
+     * @param other Histogram to merge
+     * @throws std::invalid_argument If the bins differ
+     */
+    void merge(const ScoreHistogram& other);
+    
+    /**
+     * @brief Gets the number of counted samples
+     * @return Sample count
+     */
+    size_t size() const;
+    
+    /**
+     * @brief Evaluates the counted samples like Metrics::evaluate()
+     * @param metric Metric to optimize ("f1", "accuracy", "precision", "recall")
+     * @param recallLevels Recall levels at which to report precision
+     * @return Approximate evaluation results
+     */
+    Evaluation evaluate(
+        const std::string& metric = "f1",
+        const std::vector<double>& recallLevels = {0.25, 0.5, 0.75, 0.9, 0.95}
+    ) const;
+
+private:
+    double minScore;                 ///< Lower edge of the first bin
+    double binWidth;                 ///< Width of every bin
+    std::vector<size_t> positives;   ///< Harmful samples per bin
+    std::vector<size_t> negatives;   ///< Safe samples per bin
+};
+
 } // namespace evaluation
 } // namespace blahajpi
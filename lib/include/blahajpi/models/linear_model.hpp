@@ -0,0 +1,339 @@
+/**
+ * @file linear_model.hpp
+ * @brief Linear classifier operating directly on sparse feature vectors
+ *
+ * This file provides a linear model trained with stochastic gradient
+ * descent that consumes the sparse output of the vectorizer, so neither
+ * training nor scoring has to walk the zero entries of a TF-IDF vector.
+ */
+
+#pragma once
+
+#include "blahajpi/models/quantization.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <string>
+#include <vector>
+
+namespace blahajpi {
+
+namespace utils {
+class BundleWriter;
+class BundleReader;
+} // namespace utils
+
+namespace models {
+
+/**
+ * @brief Sparse linear classifier trained with SGD
+ *
+ * Uses the same hyperparameters as SGDClassifier (loss, alpha, epochs,
+ * eta0) but keeps per-sample work proportional to the number of non-zero
+ * features. L2 regularization is applied through a global weight scale so
+ * each update only touches the features present in the sample.
+ *
+ * Labels follow the dataset convention: 0 is safe and any other value is
+ * harmful. predict() returns 0 or the positive label seen during fit().
+ *
+ * With a batch size above 1 each update sums the gradients of a mini-batch
+ * scored against the same weights, which lets the batch be scored and
+ * applied by several threads. Mini-batch results do not depend on the
+ * thread count.
+ */
+class LinearModel {
+public:
+    /**
+     * @brief Settings for mini-batch training and early stopping
+     */
+    struct TrainingOptions {
+        size_t batchSize = 1;             ///< Samples per weight update (1 = per-sample SGD)
+        size_t threads = 1;               ///< Worker threads per mini-batch (ignored when batchSize is 1)
+        double validationFraction = 0.0;  ///< Share of fit() rows held out for early stopping (0 = off)
+        int patience = 5;                 ///< Epochs without improvement before fit() stops
+        double tolerance = 1e-4;          ///< Smallest validation loss decrease that counts as improvement
+    };
+
+    /**
+     * @brief Constructor with customizable parameters
+     * @param loss Loss function ("log" for logistic regression or "hinge" for a linear SVM)
+     * @param alpha L2 regularization strength
+     * @param epochs Number of passes over the training data
+     * @param eta0 Initial learning rate
+     * @param seed Random seed used to shuffle samples between epochs
+     * @throws std::invalid_argument If the loss function is not supported
+     */
+    LinearModel(
+        const std::string& loss = "log",
+        double alpha = 0.0001,
+        int epochs = 5,
+        double eta0 = 0.01,
+        unsigned int seed = 42
+    );
+
+    /**
+     * @brief Sets how fit() and partialFit() apply updates
+     * @param options Training settings
+     * @throws std::invalid_argument If the validation fraction is outside [0, 1)
+     */
+    void setTrainingOptions(const TrainingOptions& options);
+
+    /**
+     * @brief Gets the training settings
+     * @return Current settings
+     */
+    const TrainingOptions& getTrainingOptions() const;
+
+    /**
+     * @brief Quantizes the weights for export
+     *
+     * Rounds every weight to the nearest value the precision can store, so
+     * the in-memory model scores exactly like the one writeBundle() writes.
+     * Bundles of a non-double model store the weights in that precision
+     * with a per-tensor scale. The regular file format (save()) always
+     * stores doubles.
+     *
+     * @param precision Storage precision of the weights
+     */
+    void setWeightPrecision(WeightPrecision precision);
+
+    /**
+     * @brief Gets the storage precision of the weights
+     * @return Precision set by setWeightPrecision() or read from a bundle
+     */
+    WeightPrecision getWeightPrecision() const;
+
+    /**
+     * @brief Renumbers the weights after features were removed
+     *
+     * Weights of removed features are dropped; the bias is unchanged.
+     *
+     * @param newIndex New index of each feature (-1 = removed), as
+     *        returned by TfidfVectorizer::compact()
+     * @param numFeatures Number of features kept
+     * @throws std::invalid_argument If newIndex does not cover every weight
+     */
+    void compactFeatures(const std::vector<int>& newIndex, size_t numFeatures);
+
+    /**
+     * @brief Trains the model on sparse feature vectors
+     *
+     * When early stopping is enabled, a seeded random share of the rows
+     * is held out, training stops once the mean validation loss has not
+     * improved for `patience` epochs, and the weights of the best epoch
+     * are kept.
+     *
+     * @param X Sparse feature rows
+     * @param y Labels (0 = safe, non-zero = harmful)
+     * @param numFeatures Dimension of the feature space
+     * @throws std::invalid_argument If X and y have different sizes
+     */
+    void fit(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        size_t numFeatures
+    );
+
+    /**
+     * @brief Continues training with one pass over a batch
+     *
+     * The first call (or the first after fit() with a different dimension)
+     * starts from zero weights; later calls carry on the learning-rate
+     * schedule, so calling it once per batch and epoch trains on data
+     * that does not fit in memory. Early stopping does not apply.
+     *
+     * @param X Sparse feature rows of the batch
+     * @param y Labels (0 = safe, non-zero = harmful)
+     * @param numFeatures Dimension of the feature space
+     * @throws std::invalid_argument If X and y have different sizes, or the
+     *         dimension differs from the one training started with
+     */
+    void partialFit(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        size_t numFeatures
+    );
+
+    /**
+     * @brief Computes raw decision scores (positive = harmful)
+     * @param X Sparse feature rows
+     * @return Decision score for each row
+     */
+    std::vector<double> decisionFunction(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Computes the probability of the harmful class
+     * @param X Sparse feature rows
+     * @return Probability for each row (logistic of the decision score)
+     */
+    std::vector<double> predictProbability(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Predicts class labels
+     * @param X Sparse feature rows
+     * @return 0 or the positive label for each row
+     */
+    std::vector<int> predict(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Computes accuracy on labeled data
+     * @param X Sparse feature rows
+     * @param y True labels
+     * @return Fraction of rows whose predicted class matches the label
+     */
+    double score(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y
+    ) const;
+
+    /**
+     * @brief Computes the decision score of a single row
+     * @param x Sparse feature row
+     * @return Decision score (positive = harmful)
+     */
+    double decision(const preprocessing::SparseVector& x) const;
+
+    /**
+     * @brief Gets the learned feature weights
+     * @return Weight for each feature
+     */
+    const std::vector<double>& getWeights() const;
+
+    /**
+     * @brief Gets the learned intercept
+     * @return Bias term
+     */
+    double getBias() const;
+
+    /**
+     * @brief Gets the number of epochs the last fit() ran
+     * @return Epochs trained (below the configured count if training stopped early)
+     */
+    int getEpochsRun() const;
+
+    /**
+     * @brief Gets the dimension of the feature space
+     * @return Number of weights
+     */
+    size_t getNumFeatures() const;
+
+    /**
+     * @brief Serializes the model to a file
+     * @param filePath Path where the model should be saved
+     * @return True if serialization was successful
+     */
+    bool save(const std::string& filePath) const;
+
+    /**
+     * @brief Loads a model from a file
+     * @param filePath Path to the saved model
+     * @return True if loading was successful
+     */
+    bool load(const std::string& filePath);
+
+    /**
+     * @brief Adds the model's sections to a model bundle
+     * @param bundle Bundle being assembled
+     */
+    void writeBundle(utils::BundleWriter& bundle) const;
+    
+    /**
+     * @brief Restores the model from a model bundle
+     * @param bundle Open bundle
+     * @return True if the bundle holds a valid linear model
+     */
+    bool readBundle(const utils::BundleReader& bundle);
+    
+    /**
+     * @brief Checks whether a file was written by LinearModel::save()
+     * @param filePath Path to check
+     * @return True if the file starts with the linear model header
+     */
+    static bool isModelFile(const std::string& filePath);
+
+private:
+    std::string loss;              ///< Loss function name
+    double alpha;                  ///< L2 regularization strength
+    int epochs;                    ///< Number of training epochs
+    double eta0;                   ///< Initial learning rate
+    unsigned int seed;             ///< Shuffle seed
+    std::vector<double> weights;   ///< Feature weights
+    double bias;                   ///< Intercept
+    int positiveLabel;             ///< Label reported for the harmful class
+    size_t step;                   ///< Samples trained on, drives the learning-rate schedule
+    TrainingOptions options;       ///< Mini-batch and early stopping settings
+    int epochsRun;                 ///< Epochs completed by the last fit()
+    WeightPrecision precision;     ///< Storage precision used by writeBundle()
+
+    /**
+     * @brief Runs one SGD pass over the rows in the given order
+     * @param X Sparse feature rows
+     * @param y Labels
+     * @param order Row indices to visit
+     * @param scale Current weight scale (true weights are scale * weights)
+     */
+    void runEpoch(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        const std::vector<size_t>& order,
+        double& scale
+    );
+
+    /**
+     * @brief Runs one pass of mini-batch updates over the rows in the given order
+     *
+     * Each batch is scored in parallel against the weights at its start.
+     * Each worker then applies the updates of the features it owns, in
+     * sample order, so the result is the same for any thread count.
+     *
+     * @param X Sparse feature rows
+     * @param y Labels
+     * @param order Row indices to visit
+     * @param scale Current weight scale (true weights are scale * weights)
+     */
+    void runMiniBatches(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        const std::vector<size_t>& order,
+        double& scale
+    );
+
+    /**
+     * @brief Computes the mean loss over a set of rows
+     * @param X Sparse feature rows
+     * @param y Labels
+     * @param rows Row indices to evaluate
+     * @param scale Current weight scale
+     * @return Mean loss of the rows
+     */
+    double meanLoss(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        const std::vector<size_t>& rows,
+        double scale
+    ) const;
+
+    /**
+     * @brief Computes the loss of one sample
+     * @param score Decision score
+     * @param target 1 for harmful samples, 0 for safe ones
+     * @return Loss at the given score
+     */
+    double lossValue(double score, int target) const;
+
+    /**
+     * @brief Computes the loss gradient with respect to the decision score
+     * @param score Current decision score
+     * @param target 1 for harmful samples, 0 for safe ones
+     * @return Derivative of the loss at the given score
+     */
+    double lossGradient(double score, int target) const;
+};
+
+} // namespace models
+} // namespace blahajpi
@@ -0,0 +1,197 @@
+/**
+ * @file linear_scorer.hpp
+ * @brief Fused TF-IDF and dot-product scoring for linear models
+ *
+ * This file provides a scorer that turns cleaned text into the decision
+ * score of a linear model in one pass over the terms the text contains.
+ * IDF weights are folded into the model weights when the scorer is built
+ * and L2 normalization is applied as a single scalar correction, so no
+ * feature vector is materialized and scoring cost does not depend on the
+ * size of the vocabulary.
+ */
+
+#pragma once
+
+#include "blahajpi/models/classifier.hpp"
+#include "blahajpi/models/quantization.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <cmath>
+#include <string_view>
+#include <vector>
+
+namespace blahajpi {
+
+namespace utils {
+class BundleWriter;
+class BundleReader;
+} // namespace utils
+
+namespace models {
+
+/**
+ * @brief How much one term moved a document's decision score
+ */
+struct TermContribution {
+    std::string_view term;   ///< Term as it appears in the scored text
+    double contribution;     ///< Feature value times model weight (positive = toward harmful)
+};
+
+/**
+ * @brief Scores cleaned text against a linear model without building features
+ *
+ * For a document with term counts c_j the vectorizer produces
+ * x_j = tf(c_j) * idf_j / ||tf * idf||, so the decision of a linear model is
+ *
+ *   bias + sum_j tf(c_j) * (w_j * idf_j) / sqrt(sum_j (tf(c_j) * idf_j)^2)
+ *
+ * which only needs the counted terms and the folded weights w_j * idf_j.
+ *
+ * The folded weights can be stored as int8 or float16 to shrink the
+ * table that every lookup touches; the norm is always computed from the
+ * vectorizer's double precision IDF weights.
+ *
+ * The scorer keeps a reference to the vectorizer it was built for; it has
+ * to be rebuilt (or reset) whenever that vectorizer or the model changes.
+ */
+class LinearScorer {
+public:
+    /**
+     * @brief Prepares the scorer for a vectorizer and linear weights
+     * @param vectorizer Fitted vectorizer (must outlive the scorer)
+     * @param weights Weight for each feature of the vectorizer
+     * @param bias Intercept
+     * @param precision Storage precision of the folded weights
+     * @return True if the scorer is ready, false if the sizes do not match
+     */
+    bool build(
+        const preprocessing::Vectorizer& vectorizer,
+        const std::vector<double>& weights,
+        double bias,
+        WeightPrecision precision = WeightPrecision::Double
+    );
+
+    /**
+     * @brief Computes the decision score of a cleaned document
+     * @param cleanedText Preprocessed text
+     * @param coverage Optional output for the number of terms looked up and matched
+     * @return Decision score (positive = harmful)
+     */
+    double decision(std::string_view cleanedText, preprocessing::TermCoverage* coverage = nullptr) const;
+
+    /**
+     * @brief Computes the decision score and the terms that drove it
+     *
+     * Each counted feature contributes its TF-IDF value times its model
+     * weight to the score. The strongest contributions are kept in small
+     * fixed-size heaps during the scoring pass; the terms returned are the
+     * ones that pushed the score toward the predicted class, strongest
+     * first. No extra pass over the text is made.
+     *
+     * @param cleanedText Preprocessed text (the returned terms point into it)
+     * @param maxTerms Maximum number of terms to return
+     * @param terms Output contributions, strongest first (cleared first)
+     * @param coverage Optional output for the number of terms looked up and matched
+     * @return Decision score (positive = harmful)
+     */
+    double explain(
+        std::string_view cleanedText,
+        size_t maxTerms,
+        std::vector<TermContribution>& terms,
+        preprocessing::TermCoverage* coverage = nullptr
+    ) const;
+
+    /**
+     * @brief Checks whether build() succeeded
+     * @return True if decision() can be used
+     */
+    bool isReady() const;
+
+    /**
+     * @brief Releases the folded weights and the vectorizer reference
+     */
+    void reset();
+
+    /**
+     * @brief Gets the unfolded model weights
+     * @return Weight for each feature
+     */
+    const std::vector<double>& getWeights() const;
+
+    /**
+     * @brief Gets the intercept
+     * @return Bias term
+     */
+    double getBias() const;
+
+    /**
+     * @brief Gets the storage precision of the folded weights
+     * @return Precision passed to build()
+     */
+    WeightPrecision getPrecision() const;
+
+    /**
+     * @brief Adds the scorer's weights to a model bundle
+     *
+     * Only needed for models that cannot write their own linear weights,
+     * so loading them skips extractWeights().
+     *
+     * @param bundle Bundle being assembled
+     */
+    void writeBundle(utils::BundleWriter& bundle) const;
+
+    /**
+     * @brief Rebuilds the scorer from weights stored in a model bundle
+     * @param bundle Open bundle
+     * @param vectorizer Vectorizer restored from the same bundle
+     * @return True if the bundle holds matching scorer weights
+     */
+    bool readBundle(const utils::BundleReader& bundle, const preprocessing::Vectorizer& vectorizer);
+
+    /**
+     * @brief Recovers the weights of a classifier that is linear in its input
+     *
+     * Evaluates the classifier at the origin and at each basis vector, then
+     * checks on random sparse rows that the decision function really is
+     * linear and that probabilities are the logistic of the decision score.
+     * Classifiers that fail the check (e.g. neural networks) are rejected.
+     *
+     * @param model Trained classifier
+     * @param numFeatures Dimension of the classifier's input
+     * @param weights Recovered weight for each feature
+     * @param bias Recovered intercept
+     * @return True if the classifier behaves as a logistic linear model
+     */
+    static bool extractWeights(
+        const Classifier& model,
+        size_t numFeatures,
+        std::vector<double>& weights,
+        double& bias
+    );
+
+    /**
+     * @brief Numerically stable logistic function
+     *
+     * Shared by every model with a logistic output, so scores and
+     * probabilities agree across them bit for bit.
+     *
+     * @param score Decision score
+     * @return Probability in (0, 1)
+     */
+    static double logistic(double score) {
+        if (score >= 0.0) {
+            return 1.0 / (1.0 + std::exp(-score));
+        }
+        double e = std::exp(score);
+        return e / (1.0 + e);
+    }
+
+private:
+    const preprocessing::Vectorizer* vectorizer = nullptr;  ///< Feature extractor the weights belong to
+    std::vector<double> weights;                            ///< Model weights
+    QuantizedWeights foldedWeights;                         ///< weights[j] * idf[j]
+    double bias = 0.0;                                      ///< Intercept
+};
+
+} // namespace models
+} // namespace blahajpi
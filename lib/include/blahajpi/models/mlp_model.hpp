@@ -0,0 +1,244 @@
+/**
+ * @file mlp_model.hpp
+ * @brief Multi-layer perceptron operating directly on sparse feature vectors
+ *
+ * This file provides a small feed-forward network whose first layer reads
+ * the sparse output of the vectorizer. All weights live in contiguous
+ * arrays, and inference runs a block of rows through each layer together
+ * so every weight matrix is streamed once per block instead of once per
+ * row.
+ */
+
+#pragma once
+
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace blahajpi {
+
+namespace utils {
+class BundleWriter;
+class BundleReader;
+} // namespace utils
+
+namespace models {
+
+/**
+ * @brief Sparse-input neural network classifier
+ *
+ * Uses the same hyperparameters as NeuralNetworkClassifier (hidden layers,
+ * hidden size, epochs, learning rate) with ReLU hidden units and a
+ * logistic output. The first layer only visits the non-zero features of
+ * a row, so its cost is proportional to the text rather than the
+ * vocabulary.
+ *
+ * Labels follow the dataset convention: 0 is safe and any other value is
+ * harmful. predict() returns 0 or the positive label seen during fit().
+ */
+class MlpModel {
+public:
+    /**
+     * @brief Constructor with customizable parameters
+     * @param hiddenLayers Number of hidden layers (at least 1)
+     * @param hiddenSize Units per hidden layer
+     * @param epochs Number of passes over the training data
+     * @param learningRate SGD step size
+     * @param seed Random seed for weight initialization and shuffling
+     * @throws std::invalid_argument If the layer count or size is not positive
+     */
+    MlpModel(
+        int hiddenLayers = 1,
+        int hiddenSize = 16,
+        int epochs = 10,
+        double learningRate = 0.01,
+        unsigned int seed = 42
+    );
+
+    /**
+     * @brief Trains the network on sparse feature vectors
+     * @param X Sparse feature rows
+     * @param y Labels (0 = safe, non-zero = harmful)
+     * @param numFeatures Dimension of the feature space
+     * @throws std::invalid_argument If X and y have different sizes
+     */
+    void fit(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y,
+        size_t numFeatures
+    );
+
+    /**
+     * @brief Computes raw decision scores (positive = harmful)
+     * @param X Sparse feature rows
+     * @return Output pre-activation for each row
+     */
+    std::vector<double> decisionFunction(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Computes the probability of the harmful class
+     * @param X Sparse feature rows
+     * @return Probability for each row (logistic of the decision score)
+     */
+    std::vector<double> predictProbability(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Predicts class labels
+     * @param X Sparse feature rows
+     * @return 0 or the positive label for each row
+     */
+    std::vector<int> predict(
+        const std::vector<preprocessing::SparseVector>& X
+    ) const;
+
+    /**
+     * @brief Computes accuracy on labeled data
+     * @param X Sparse feature rows
+     * @param y True labels
+     * @return Fraction of rows whose predicted class matches the label
+     */
+    double score(
+        const std::vector<preprocessing::SparseVector>& X,
+        const std::vector<int>& y
+    ) const;
+
+    /**
+     * @brief Selects single precision for inference
+     *
+     * Keeps a float32 copy of the weights, which halves the memory
+     * traffic of the forward pass and doubles the SIMD width. Training
+     * and serialization always use the double precision weights.
+     *
+     * @param enabled Whether decisionFunction() uses float32 weights
+     */
+    void setFloat32(bool enabled);
+
+    /**
+     * @brief Checks whether inference uses float32 weights
+     * @return True if setFloat32(true) is in effect
+     */
+    bool usesFloat32() const;
+
+    /**
+     * @brief Gets the dimension of the feature space
+     * @return Number of input features
+     */
+    size_t getNumFeatures() const;
+
+    /**
+     * @brief Gets the number of hidden layers
+     * @return Hidden layer count
+     */
+    int getHiddenLayers() const;
+
+    /**
+     * @brief Gets the width of the hidden layers
+     * @return Units per hidden layer
+     */
+    int getHiddenSize() const;
+
+    /**
+     * @brief Serializes the model to a file
+     *
+     * The file is a model bundle holding only the network's sections.
+     *
+     * @param filePath Path where the model should be saved
+     * @return True if serialization was successful
+     */
+    bool save(const std::string& filePath) const;
+
+    /**
+     * @brief Loads a model from a file
+     * @param filePath Path to the saved model
+     * @return True if loading was successful
+     */
+    bool load(const std::string& filePath);
+
+    /**
+     * @brief Adds the model's sections to a model bundle
+     * @param bundle Bundle being assembled
+     */
+    void writeBundle(utils::BundleWriter& bundle) const;
+
+    /**
+     * @brief Restores the model from a model bundle
+     * @param bundle Open bundle
+     * @return True if the bundle holds a valid network
+     */
+    bool readBundle(const utils::BundleReader& bundle);
+
+    /**
+     * @brief Checks whether a bundle holds an MlpModel
+     * @param bundle Open bundle
+     * @return True if the network's sections are present
+     */
+    static bool hasModel(const utils::BundleReader& bundle);
+
+    /**
+     * @brief Checks whether a file was written by MlpModel::save()
+     * @param filePath Path to check
+     * @return True if the file is a bundle holding a network
+     */
+    static bool isModelFile(const std::string& filePath);
+
+private:
+    /**
+     * @brief Weights of every layer in one precision
+     *
+     * Each matrix has one contiguous row per input unit, so a layer adds
+     * scaled rows into its output and the inner loop runs over output
+     * units without a reduction.
+     */
+    template <typename T>
+    struct Parameters {
+        std::vector<T> input;                ///< numFeatures x hiddenSize
+        std::vector<std::vector<T>> hidden;  ///< hiddenSize x hiddenSize per layer after the first
+        std::vector<std::vector<T>> biases;  ///< hiddenSize per hidden layer
+        std::vector<T> output;               ///< hiddenSize output weights
+        T outputBias = 0;                    ///< Output intercept
+    };
+
+    int hiddenLayers;                  ///< Number of hidden layers
+    int hiddenSize;                    ///< Units per hidden layer
+    int epochs;                        ///< Number of training epochs
+    double learningRate;               ///< SGD step size
+    unsigned int seed;                 ///< Initialization and shuffle seed
+    size_t numFeatures;                ///< Input dimension
+    int positiveLabel;                 ///< Label reported for the harmful class
+    Parameters<double> weights;        ///< Trained weights
+    Parameters<float> floatWeights;    ///< float32 copy used when float32 is set
+    bool float32;                      ///< Whether inference uses floatWeights
+
+    /**
+     * @brief Draws the initial weights for a feature dimension
+     * @param dimension Number of input features
+     */
+    void initialize(size_t dimension);
+
+    /**
+     * @brief Rebuilds the float32 copy from the trained weights
+     */
+    void refreshFloatWeights();
+
+    /**
+     * @brief Scores a block of rows
+     * @param params Weights to use
+     * @param rows Rows of the block
+     * @param scores Output decision score for each row
+     */
+    template <typename T>
+    void forwardBlock(
+        const Parameters<T>& params,
+        std::span<const preprocessing::SparseVector> rows,
+        double* scores
+    ) const;
+};
+
+} // namespace models
+} // namespace blahajpi
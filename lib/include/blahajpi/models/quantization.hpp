@@ -0,0 +1,163 @@
+/**
+ * @file quantization.hpp
+ * @brief Reduced-precision storage for model weight tensors
+ *
+ * This file provides post-training quantization of weight vectors to
+ * int8 with a per-tensor scale or to IEEE-754 half precision. Quantized
+ * tensors are 4-8x smaller than doubles, which keeps the weights of a
+ * large vocabulary resident in cache while scoring.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blahajpi {
+
+namespace utils {
+class SectionWriter;
+class SectionReader;
+} // namespace utils
+
+namespace models {
+
+/**
+ * @brief Storage precision of a weight tensor
+ */
+enum class WeightPrecision : uint8_t {
+    Double = 0,   ///< 64-bit IEEE-754 (no quantization)
+    Float16 = 1,  ///< 16-bit IEEE-754 half precision
+    Int8 = 2      ///< Signed 8-bit integers times a per-tensor scale
+};
+
+/**
+ * @brief Parses a precision name
+ * @param name "double", "float16" or "int8"
+ * @return The precision, or std::nullopt for an unknown name
+ */
+std::optional<WeightPrecision> parseWeightPrecision(std::string_view name);
+
+/**
+ * @brief Gets the configuration name of a precision
+ * @param precision Precision to name
+ * @return "double", "float16" or "int8"
+ */
+std::string weightPrecisionName(WeightPrecision precision);
+
+/**
+ * @brief A weight vector stored in reduced precision
+ *
+ * Int8 tensors store round(w / scale) with scale = max|w| / 127, so the
+ * largest weight is represented exactly and every other weight is within
+ * scale / 2. Float16 tensors round each weight to the nearest half.
+ */
+class QuantizedWeights {
+public:
+    /**
+     * @brief Quantizes a weight vector
+     * @param values Weights to quantize
+     * @param precision Target precision
+     * @return The quantized tensor
+     */
+    static QuantizedWeights quantize(std::span<const double> values, WeightPrecision precision);
+
+    /**
+     * @brief Gets the storage precision
+     * @return Precision the values are stored in
+     */
+    WeightPrecision getPrecision() const;
+
+    /**
+     * @brief Gets the number of weights
+     * @return Tensor length
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the per-tensor scale
+     * @return Factor applied to every stored value (1 for non-int8 tensors)
+     */
+    double getScale() const;
+
+    /**
+     * @brief Gets one weight in double precision
+     * @param index Weight index
+     * @return Dequantized weight
+     */
+    double value(size_t index) const;
+
+    /**
+     * @brief Converts the whole tensor back to doubles
+     * @return Dequantized weights
+     */
+    std::vector<double> dequantize() const;
+
+    /**
+     * @brief Gets the stored double values
+     * @return Weights (empty unless the precision is Double)
+     */
+    const std::vector<double>& doubleValues() const;
+
+    /**
+     * @brief Gets the stored int8 values
+     * @return Values to multiply by getScale() (empty unless the precision is Int8)
+     */
+    const std::vector<int8_t>& int8Values() const;
+
+    /**
+     * @brief Gets the stored half-precision bit patterns
+     * @return Raw binary16 values (empty unless the precision is Float16)
+     */
+    const std::vector<uint16_t>& halfValues() const;
+
+    /**
+     * @brief Gets the memory used by the stored values
+     * @return Bytes of weight storage
+     */
+    size_t byteSize() const;
+
+    /**
+     * @brief Appends the tensor to a bundle section
+     *
+     * Layout: u8 precision, f64 scale, u64 count, then the raw values.
+     *
+     * @param section Section being written
+     */
+    void write(utils::SectionWriter& section) const;
+
+    /**
+     * @brief Reads a tensor written by write()
+     * @param section Section positioned at the tensor
+     * @return True if a complete tensor was read
+     */
+    bool read(utils::SectionReader& section);
+
+    /**
+     * @brief Converts a double to the nearest half-precision value
+     * @param value Value to convert
+     * @return binary16 bit pattern (round to nearest even)
+     */
+    static uint16_t toHalf(double value);
+
+    /**
+     * @brief Converts a half-precision value to double
+     * @param bits binary16 bit pattern
+     * @return Exact double value
+     */
+    static double fromHalf(uint16_t bits);
+
+private:
+    WeightPrecision precision = WeightPrecision::Double;  ///< Storage precision
+    double scale = 1.0;                                   ///< Int8 scale
+    std::vector<double> doubles;                          ///< Values for Double tensors
+    std::vector<int8_t> bytes;                            ///< Values for Int8 tensors
+    std::vector<uint16_t> halves;                         ///< Values for Float16 tensors
+};
+
+} // namespace models
+} // namespace blahajpi
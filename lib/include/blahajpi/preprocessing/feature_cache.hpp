@@ -0,0 +1,92 @@
+/**
+ * @file feature_cache.hpp
+ * @brief On-disk cache of preprocessed and vectorized training data
+ *
+ * Training runs that only change model hyperparameters produce the same
+ * cleaned texts and feature rows every time. This file provides a cache
+ * that stores them, together with the fitted vectorizer, in a model
+ * bundle keyed by a hash of the dataset contents and of every setting
+ * that affects preprocessing, splitting and feature extraction. Feature
+ * rows are stored in CSR layout (row offsets, indices, values), so a
+ * cache file is read from a memory mapping with bulk copies.
+ */
+
+#pragma once
+
+#include "blahajpi/preprocessing/vectorizer.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blahajpi {
+namespace preprocessing {
+
+/**
+ * @brief Everything a training run needs before fitting a model
+ */
+struct FeatureSet {
+    std::vector<SparseVector> trainFeatures;   ///< Feature rows of the training split
+    std::vector<int> trainLabels;              ///< Labels of the training split
+    std::vector<std::string> testTexts;        ///< Cleaned texts of the test split
+    std::vector<SparseVector> testFeatures;    ///< Feature rows of the test split
+    std::vector<int> testLabels;               ///< Labels of the test split
+    std::unique_ptr<Vectorizer> vectorizer;    ///< Vectorizer fitted on the training split
+};
+
+/**
+ * @brief Content-addressed store of FeatureSet files in one directory
+ *
+ * Entries are never modified: a changed dataset or setting gives a new
+ * key. Writes go through BundleWriter, so concurrent runs never read a
+ * partially written entry.
+ */
+class FeatureCache {
+public:
+    /// Version of the entry layout; part of every key
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Constructor
+     * @param directory Directory holding the cache entries (created on first store)
+     */
+    explicit FeatureCache(std::string directory);
+
+    /**
+     * @brief Computes the key of a dataset and its settings
+     * @param dataPath Path to the dataset file
+     * @param settings Every setting that affects the cached data, serialized
+     * @return Hexadecimal key, or an empty string if the dataset cannot be read
+     */
+    static std::string makeKey(const std::string& dataPath, std::string_view settings);
+
+    /**
+     * @brief Gets the file an entry is stored in
+     * @param key Entry key
+     * @return Path of the entry
+     */
+    std::string pathFor(const std::string& key) const;
+
+    /**
+     * @brief Reads an entry
+     * @param key Entry key
+     * @param features Receives the cached data
+     * @return True on a hit (false if missing or unreadable)
+     */
+    bool load(const std::string& key, FeatureSet& features) const;
+
+    /**
+     * @brief Writes an entry
+     * @param key Entry key
+     * @param features Data to store (the vectorizer must be fitted)
+     * @return True if the entry was written
+     */
+    bool store(const std::string& key, const FeatureSet& features) const;
+
+private:
+    std::string directory;  ///< Directory holding the entries
+};
+
+} // namespace preprocessing
+} // namespace blahajpi
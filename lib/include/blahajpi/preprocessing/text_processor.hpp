@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "blahajpi/utils/static_lexicon.hpp"
 #include <string>
 #include <string_view>
 #include <vector>
@@ -53,6 +54,41 @@ public:
     std::string preprocess(std::string_view text, 
                          const std::vector<std::string>& steps = {}) const;
     
+    /**
+     * @brief Applies the active pipeline, writing into a reusable buffer
+     * 
+     * Equivalent to preprocess(text) but reuses the capacity of @p output,
+     * which avoids allocations when processing many texts in a loop.
+     * 
+     * @param text Input text to process
+     * @param output Buffer that receives the preprocessed text
+     */
+    void preprocessInto(std::string_view text, std::string& output) const;
+    
+    /**
+     * @brief Selects and compiles the pipeline used when no steps are given
+     * 
+     * When the steps end with the standard token-level sequence (lowercase
+     * through normalize_repeated_chars), that sequence is replaced by a
+     * fused stage that makes a single pass over the text and produces the
+     * same output as running the steps one by one.
+     * 
+     * @param steps Preprocessing step names, empty for the default pipeline
+     */
+    void setPipeline(const std::vector<std::string>& steps);
+    
+    /**
+     * @brief Gets the step names of the active pipeline
+     * @return Step names in execution order
+     */
+    const std::vector<std::string>& getPipeline() const;
+    
+    /**
+     * @brief Gets the default preprocessing pipeline
+     * @return Step names of the default pipeline
+     */
+    static const std::vector<std::string>& getDefaultPipeline();
+    
     /**
      * @brief Get all available preprocessing functions
      * @return Map of function names to implementation functions
@@ -94,20 +130,68 @@ private:
     std::unordered_map<std::string, PreprocessingFunc> preprocessingFunctions;
     
     /**
-     * @brief Set of stopwords to remove during preprocessing
+     * @brief Stopwords to remove during preprocessing
+     * 
+     * The default constructor uses the built-in compile-time table; words
+     * from addStopwords() are kept in a runtime overlay.
+     */
+    utils::WordList stopwords;
+    
+    /**
+     * @brief Words that indicate negation
+     */
+    utils::WordList negationWords;
+    
+    /**
+     * @brief Step names of the active pipeline
      */
-    std::unordered_set<std::string> stopwords;
+    std::vector<std::string> pipelineSteps;
     
     /**
-     * @brief Set of words that indicate negation
+     * @brief Resolved functions for the steps that run before the fused stage
      */
-    std::unordered_set<std::string> negationWords;
+    std::vector<PreprocessingFunc> compiledSteps;
+    
+    /**
+     * @brief Whether the active pipeline ends with the fused token stage
+     */
+    bool useFusedStage = false;
+    
+    /**
+     * @brief Built-in step names replaced through addPreprocessingStep()
+     */
+    std::unordered_set<std::string> overriddenSteps;
     
     /**
      * @brief Initialize default preprocessing functions
      */
     void initializePreprocessingFunctions();
     
+    /**
+     * @brief Resolves the active pipeline into compiled steps
+     */
+    void compilePipeline();
+    
+    /**
+     * @brief Runs the compiled pipeline
+     * @param text Input text
+     * @param output Buffer that receives the result
+     */
+    void runCompiledPipeline(std::string_view text, std::string& output) const;
+    
+    /**
+     * @brief Single-pass equivalent of the standard token-level steps
+     * 
+     * Produces the output of lowercase, expand_abbreviations,
+     * handle_negations, remove_punctuation, remove_numbers,
+     * normalize_whitespace, remove_stopwords and normalize_repeated_chars
+     * applied in that order.
+     * 
+     * @param text Input text
+     * @param output Buffer that receives the result (cleared first)
+     */
+    void runFusedStage(std::string_view text, std::string& output) const;
+    
     // Standard preprocessing functions
     
     /**
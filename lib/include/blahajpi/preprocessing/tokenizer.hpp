@@ -0,0 +1,224 @@
+/**
+ * @file tokenizer.hpp
+ * @brief Allocation-free tokenization and hashed term identifiers
+ *
+ * This file provides a tokenizer that splits cleaned text into
+ * std::string_view words and computes n-gram identifiers as rolling
+ * hashes, along with an integer-keyed index for vocabulary lookup. The
+ * vectorizer uses these to count terms without building token strings.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace blahajpi {
+namespace preprocessing {
+
+/**
+ * @brief Hashed identifier of a term (word or n-gram)
+ */
+using TermId = uint64_t;
+
+/**
+ * @brief Splits text into words and enumerates hashed n-gram identifiers
+ *
+ * Words are separated by whitespace, matching stream extraction. The
+ * identifier of an n-gram is the 64-bit FNV-1a hash of its joined form
+ * ("w1_w2"), extended one word at a time, so hashTerm() of a stored
+ * vocabulary string gives the same identifier without any concatenation
+ * on the hot path.
+ */
+class Tokenizer {
+public:
+    /**
+     * @brief Constructor with n-gram range
+     * @param minNgram Minimum n-gram length
+     * @param maxNgram Maximum n-gram length
+     */
+    explicit Tokenizer(size_t minNgram = 1, size_t maxNgram = 1);
+
+    /**
+     * @brief Splits text into whitespace-separated words
+     * @param text Input text
+     * @param words Output views into text (cleared first)
+     */
+    static void splitWords(std::string_view text, std::vector<std::string_view>& words);
+
+    /**
+     * @brief Hashes a term string
+     * @param term Word or underscore-joined n-gram
+     * @return Term identifier
+     */
+    static TermId hashTerm(std::string_view term);
+
+    /**
+     * @brief Extends a term hash with more bytes
+     * @param hash Hash of the bytes seen so far
+     * @param bytes Bytes to append
+     * @return Hash of the concatenation
+     */
+    static TermId extendHash(TermId hash, std::string_view bytes);
+
+    /**
+     * @brief Builds the string form of an n-gram
+     * @param words Words of the document
+     * @param start Index of the first word
+     * @param length Number of words in the n-gram
+     * @return Words joined with underscores
+     */
+    static std::string joinTerm(
+        const std::vector<std::string_view>& words,
+        size_t start,
+        size_t length
+    );
+
+    /**
+     * @brief Calls a function for every n-gram in the configured range
+     *
+     * N-grams are visited by start position, shortest first. The callback
+     * receives the term identifier, the index of the first word and the
+     * n-gram length.
+     *
+     * @param words Words of the document
+     * @param callback Function invoked as callback(TermId, size_t start, size_t length)
+     */
+    template <typename Callback>
+    void forEachTerm(const std::vector<std::string_view>& words, Callback&& callback) const {
+        for (size_t start = 0; start < words.size(); ++start) {
+            size_t longest = std::min(maxNgram, words.size() - start);
+            TermId hash = hashTerm(words[start]);
+
+            for (size_t length = 1; length <= longest; ++length) {
+                if (length > 1) {
+                    hash = extendHash(hash, "_");
+                    hash = extendHash(hash, words[start + length - 1]);
+                }
+                if (length >= minNgram) {
+                    callback(hash, start, length);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the minimum n-gram length
+     * @return Minimum n-gram length
+     */
+    size_t getMinNgram() const;
+
+    /**
+     * @brief Gets the maximum n-gram length
+     * @return Maximum n-gram length
+     */
+    size_t getMaxNgram() const;
+
+private:
+    size_t minNgram;  ///< Minimum n-gram length
+    size_t maxNgram;  ///< Maximum n-gram length
+};
+
+/**
+ * @brief Open-addressing map from term identifiers to feature indices
+ *
+ * Built once from the vocabulary and only read afterwards, so lookups are
+ * a few integer probes in a flat array instead of hashing a string. The
+ * slot array can be serialized and later used in place from a mapped
+ * model bundle; copies of an index share the same immutable slots.
+ */
+class TermIndex {
+public:
+    /// Bytes per serialized slot: little-endian u64 ID, i32 index, 4 padding bytes
+    static constexpr size_t SERIALIZED_SLOT_SIZE = 16;
+
+    /**
+     * @brief Rebuilds the index from a vocabulary
+     * @param vocabulary Map of terms to feature indices
+     */
+    void build(const std::unordered_map<std::string, int>& vocabulary);
+
+    /**
+     * @brief Looks up the feature index of a term
+     * @param id Term identifier
+     * @return Feature index, or -1 if the term is not in the vocabulary
+     */
+    int find(TermId id) const {
+        if (!slots) {
+            return -1;
+        }
+
+        for (size_t pos = slotFor(id);; pos = (pos + 1) & mask) {
+            const Slot& slot = slots.get()[pos];
+            if (slot.index < 0) {
+                return -1;
+            }
+            if (slot.id == id) {
+                return slot.index;
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the number of indexed terms
+     * @return Number of terms
+     */
+    size_t size() const;
+
+    /**
+     * @brief Removes all terms
+     */
+    void clear();
+
+    /**
+     * @brief Encodes the slot array
+     * @return SERIALIZED_SLOT_SIZE bytes per slot
+     */
+    std::vector<unsigned char> serialize() const;
+
+    /**
+     * @brief Restores an index from serialize() output
+     *
+     * On little-endian hosts with suitably aligned input the bytes are used
+     * in place and owner is kept alive for as long as the index needs them;
+     * otherwise they are decoded into a private copy.
+     *
+     * @param bytes Serialized slot array
+     * @param featureCount Number of features; every stored index must be below it
+     * @param owner Object that keeps bytes valid (may be null if bytes outlive the index)
+     * @return True if the input is a well-formed slot array
+     */
+    bool deserialize(
+        std::span<const unsigned char> bytes,
+        size_t featureCount,
+        std::shared_ptr<const void> owner
+    );
+
+private:
+    struct Slot {
+        TermId id = 0;   ///< Term identifier
+        int index = -1;  ///< Feature index (-1 = empty slot)
+    };
+
+    /**
+     * @brief Gets the first slot to probe for a term
+     * @param id Term identifier
+     * @return Slot position
+     */
+    size_t slotFor(TermId id) const {
+        return static_cast<size_t>(id ^ (id >> 32)) & mask;
+    }
+
+    std::shared_ptr<const Slot> slots;  ///< Power-of-two sized slot array (shared, immutable)
+    size_t mask = 0;                    ///< Slot count - 1
+    size_t count = 0;                   ///< Number of occupied slots
+};
+
+} // namespace preprocessing
+} // namespace blahajpi
@@ -5,10 +5,17 @@
  * This file provides functionality to convert text data into numerical
  * feature vectors using the Term Frequency-Inverse Document Frequency
  * (TF-IDF) approach, which helps capture the importance of words in documents.
+ * Features come either from a learned vocabulary (TfidfVectorizer) or from
+ * hashing n-grams into a fixed number of buckets (HashingVectorizer).
  */
 
 #pragma once
 
+#include "blahajpi/preprocessing/tokenizer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -16,8 +23,260 @@
 #include <string_view>
 
 namespace blahajpi {
+
+namespace utils {
+class BundleWriter;
+class BundleReader;
+} // namespace utils
+
 namespace preprocessing {
 
+/**
+ * @brief Sparse feature vector stored as parallel index/value arrays
+ * 
+ * A document only touches a few dozen of the vocabulary's features, so
+ * only the non-zero entries are kept. Indices are sorted in ascending
+ * order; every index that is not listed is implicitly zero.
+ */
+struct SparseVector {
+    std::vector<int> indices;     ///< Feature indices of non-zero entries (ascending)
+    std::vector<double> values;   ///< Values of the non-zero entries
+    
+    /**
+     * @brief Gets the number of stored (non-zero) entries
+     * @return Number of non-zero entries
+     */
+    size_t nonZeroCount() const;
+    
+    /**
+     * @brief Expands the vector into a dense representation
+     * @param dimension Length of the dense vector (number of features)
+     * @return Dense feature vector
+     */
+    std::vector<double> toDense(size_t dimension) const;
+    
+    /**
+     * @brief Computes the dot product with a dense weight vector
+     * @param weights Dense weights indexed by feature
+     * @return Sum of value * weight over the non-zero entries
+     */
+    double dot(const std::vector<double>& weights) const;
+};
+
+/**
+ * @brief Expands sparse rows into a dense feature matrix
+ * 
+ * Only needed at the boundary with classifiers that take dense input.
+ * 
+ * @param rows Sparse feature rows
+ * @param dimension Number of features per row
+ * @return Dense feature matrix
+ */
+std::vector<std::vector<double>> toDenseMatrix(
+    const std::vector<SparseVector>& rows,
+    size_t dimension
+);
+
+/**
+ * @brief A feature hit by a document together with its raw term count
+ * 
+ * Counts are signed when a hashing vectorizer hashes the sign of terms.
+ */
+struct FeatureCount {
+    int index;  ///< Feature index
+    int count;  ///< Summed (possibly signed) occurrences, never zero
+};
+
+/**
+ * @brief Where the first term mapped to a feature occurs in a document
+ * 
+ * N-grams span from the start of their first word to the end of their
+ * last, so the span can be shown as the text the feature came from.
+ */
+struct FeatureSpan {
+    uint32_t offset;  ///< Byte offset of the term in the document
+    uint32_t length;  ///< Length of the term in bytes
+};
+
+/**
+ * @brief Number of terms in a document and how many of them hit a feature
+ */
+struct TermCoverage {
+    size_t terms = 0;    ///< Words and n-grams looked up
+    size_t matched = 0;  ///< Terms mapped to a feature (all of them when hashing)
+};
+
+/**
+ * @brief Abstract base class for text vectorizers
+ * 
+ * Defines the interface the analyzer uses to fit, apply and persist a
+ * feature extractor, independent of how terms are mapped to features.
+ */
+class Vectorizer {
+public:
+    /**
+     * @brief Virtual destructor for proper inheritance
+     */
+    virtual ~Vectorizer() = default;
+    
+    /**
+     * @brief Learns feature statistics from a collection of documents
+     * @param texts Collection of documents to analyze
+     */
+    virtual void fit(const std::vector<std::string>& texts) = 0;
+    
+    /**
+     * @brief Starts an incremental fit, discarding learned statistics
+     * 
+     * Calling beginFit(), then partialFit() for each batch and finally
+     * finishFit() learns the same statistics as fit() on all batches at
+     * once, without holding the corpus in memory.
+     */
+    virtual void beginFit() = 0;
+    
+    /**
+     * @brief Accumulates document frequencies from a batch of documents
+     * @param texts Batch of documents
+     */
+    virtual void partialFit(const std::vector<std::string>& texts) = 0;
+    
+    /**
+     * @brief Completes an incremental fit and makes the vectorizer usable
+     */
+    virtual void finishFit() = 0;
+    
+    /**
+     * @brief Sets how many worker threads fit() and partialFit() may use
+     * 
+     * The learned statistics are the same for any thread count. Small
+     * batches are always counted on the calling thread.
+     * 
+     * @param threads Worker threads (0 or 1 = fit on the calling thread)
+     */
+    void setFitThreads(size_t threads);
+    
+    /**
+     * @brief Transforms documents into dense feature vectors
+     * @param texts Collection of documents to transform
+     * @return Matrix of features (one vector per document)
+     */
+    virtual std::vector<std::vector<double>> transform(
+        const std::vector<std::string>& texts
+    ) const = 0;
+    
+    /**
+     * @brief Transforms documents into sparse feature vectors
+     * @param texts Collection of documents to transform
+     * @return Sparse features (one vector per document)
+     */
+    virtual std::vector<SparseVector> transformSparse(
+        const std::vector<std::string>& texts
+    ) const = 0;
+    
+    /**
+     * @brief Get the dimension of the feature space
+     * @return Number of features
+     */
+    virtual size_t getNumFeatures() const = 0;
+    
+    /**
+     * @brief Counts the features a document hits
+     * 
+     * This is the allocation-free core of transformSparse(): the feature
+     * value of each entry is termFrequencyWeight(count) * getIdfWeights()[index],
+     * before L2 normalization.
+     * 
+     * @param text Document to analyze
+     * @param counts Output entries with ascending feature indices (cleared first)
+     * @param spans Optional output with the first occurrence of each entry's
+     *              feature, aligned with counts
+     * @return Number of terms looked up and matched
+     */
+    virtual TermCoverage countFeatures(
+        std::string_view text,
+        std::vector<FeatureCount>& counts,
+        std::vector<FeatureSpan>* spans = nullptr
+    ) const = 0;
+    
+    /**
+     * @brief Get the precomputed IDF weight of each feature
+     * @return IDF weights (empty before fit)
+     */
+    virtual const std::vector<double>& getIdfWeights() const = 0;
+    
+    /**
+     * @brief Checks whether term frequencies are scaled sublinearly
+     * @return True if tf is replaced by 1 + log(tf)
+     */
+    virtual bool usesSublinearTf() const = 0;
+    
+    /**
+     * @brief Converts a raw term count into a term-frequency weight
+     * @param count Raw (possibly signed) term count
+     * @param sublinearTf Whether to apply sublinear scaling
+     * @return Term-frequency weight carrying the sign of count
+     */
+    static double termFrequencyWeight(int count, bool sublinearTf);
+    
+    /**
+     * @brief Serializes the vectorizer to a file
+     * @param filePath Path where the vectorizer should be saved
+     * @return True if serialization was successful
+     */
+    virtual bool save(const std::string& filePath) const = 0;
+    
+    /**
+     * @brief Loads a vectorizer from a file
+     * @param filePath Path to the saved vectorizer
+     * @return True if loading was successful
+     */
+    virtual bool load(const std::string& filePath) = 0;
+    
+    /**
+     * @brief Adds the vectorizer's sections to a model bundle
+     * @param bundle Bundle being assembled
+     */
+    virtual void writeBundle(utils::BundleWriter& bundle) const = 0;
+    
+    /**
+     * @brief Restores the vectorizer from a model bundle
+     * @param bundle Open bundle
+     * @return True if the bundle holds a valid vectorizer of this kind
+     */
+    virtual bool readBundle(const utils::BundleReader& bundle) = 0;
+    
+    /**
+     * @brief Loads a saved vectorizer of whichever kind wrote the file
+     * @param filePath Path to the saved vectorizer
+     * @return Loaded vectorizer, or nullptr if loading failed
+     */
+    static std::unique_ptr<Vectorizer> loadFromFile(const std::string& filePath);
+    
+    /**
+     * @brief Loads the vectorizer stored in a model bundle
+     * @param bundle Open bundle
+     * @return Loaded vectorizer, or nullptr if the bundle has none
+     */
+    static std::unique_ptr<Vectorizer> loadFromBundle(const utils::BundleReader& bundle);
+    
+protected:
+    size_t fitThreads = 1;  ///< Worker threads for fitting
+    
+    /**
+     * @brief Builds the normalized sparse feature vector of a document
+     * @param text Document to transform
+     * @return Sparse feature vector with ascending indices
+     */
+    SparseVector buildFeatureVector(std::string_view text) const;
+    
+    /**
+     * @brief Gets the number of workers worth using to fit a batch
+     * @param documents Number of documents in the batch
+     * @return Worker count between 1 and fitThreads
+     */
+    size_t fitWorkers(size_t documents) const;
+};
+
 /**
  * @brief Converts text into numerical feature vectors using TF-IDF
  * 
@@ -26,7 +285,7 @@ namespace preprocessing {
  * provides methods to build vocabulary, compute TF-IDF scores, and transform
  * documents into feature vectors.
  */
-class TfidfVectorizer {
+class TfidfVectorizer : public Vectorizer {
 public:
     /**
      * @brief Constructor with customizable parameters
@@ -46,11 +305,73 @@ public:
     
     /**
      * @brief Tokenizes text into words and n-grams
+     * 
+     * Builds a string per token, so it is meant for inspection and tests.
+     * fit() and transform() count hashed term IDs from the Tokenizer instead.
+     * 
      * @param text Input text to tokenize
-     * @return Vector of tokens
+     * @return Vector of tokens, grouped by n-gram length
      */
     std::vector<std::string> tokenize(std::string_view text) const;
     
+    /**
+     * @brief Builds vocabulary using the constructor's thresholds
+     * @param texts Collection of documents to analyze
+     */
+    void fit(const std::vector<std::string>& texts) override;
+    
+    /**
+     * @brief Clears the vocabulary and the pending term counts
+     */
+    void beginFit() override;
+    
+    /**
+     * @brief Counts the document frequency of every term in a batch
+     * 
+     * Document frequencies are counted per term ID; a term's string is
+     * only built the first time it is seen. With several fit threads,
+     * each worker counts a slice of the batch into private shards, and
+     * the shards are then merged in parallel, one shard per task.
+     * 
+     * @param texts Batch of documents
+     */
+    void partialFit(const std::vector<std::string>& texts) override;
+    
+    /**
+     * @brief Selects the vocabulary from the pending counts
+     * 
+     * Applies the minDf, maxDf and maxFeatures thresholds and releases the
+     * counts. The maxFeatures most frequent terms are selected without
+     * sorting the rest. Terms with equal document frequency are ordered by
+     * their text, so feature indices do not depend on hash map order or
+     * thread count.
+     */
+    void finishFit() override;
+    
+    /**
+     * @brief Sets the minimum document frequency of vocabulary terms
+     * 
+     * Values below 1 are a fraction of the fitted documents, 1 and above
+     * an absolute count. Applies to the next fit and is not saved.
+     * 
+     * @param minDf Minimum document frequency (1 keeps every term)
+     */
+    void setMinDf(double minDf);
+    
+    /**
+     * @brief Bounds the number of distinct terms counted during a fit
+     * 
+     * Whenever more terms are pending than the limit, the least frequent
+     * ones are dropped so that at most half the limit remain (lossy
+     * counting). A dropped term that shows up again starts over, so
+     * frequencies can be undercounted by the highest pruned frequency,
+     * which finishFit() reports. Pruning runs at fixed document intervals,
+     * so the result does not depend on the thread count.
+     * 
+     * @param maxTerms Maximum pending terms (0 = count every term exactly)
+     */
+    void setMaxPendingTerms(size_t maxTerms);
+    
     /**
      * @brief Builds vocabulary and calculates document frequencies
      * @param texts Collection of documents to analyze
@@ -59,7 +380,7 @@ public:
      */
     void fit(
         const std::vector<std::string>& texts,
-        double maxDf = 0.5,
+        double maxDf,
         size_t maxFeatures = 10000
     );
     
@@ -70,7 +391,21 @@ public:
      */
     std::vector<std::vector<double>> transform(
         const std::vector<std::string>& texts
-    ) const;
+    ) const override;
+    
+    /**
+     * @brief Transforms documents into sparse TF-IDF feature vectors
+     * 
+     * Produces the same values as transform() without materializing the
+     * zero entries, so the cost depends on document length rather than
+     * vocabulary size.
+     * 
+     * @param texts Collection of documents to transform
+     * @return Sparse TF-IDF features (one vector per document)
+     */
+    std::vector<SparseVector> transformSparse(
+        const std::vector<std::string>& texts
+    ) const override;
     
     /**
      * @brief Fits vocabulary and transforms documents in one step
@@ -93,60 +428,130 @@ public:
      */
     const std::vector<int>& getDocumentFrequencies() const;
     
+    /**
+     * @brief Removes vocabulary terms and renumbers the rest
+     * 
+     * Kept terms keep their relative order and their document
+     * frequencies, so their IDF weights do not change. Documents are
+     * still normalized to unit length, now over the kept terms only.
+     * 
+     * @param keep One flag per feature index (true = keep the term)
+     * @return New index of each old feature (-1 for removed ones)
+     */
+    std::vector<int> compact(const std::vector<bool>& keep);
+    
     /**
      * @brief Get the number of features (vocabulary size)
      * @return Vocabulary size
      */
-    size_t getNumFeatures() const;
+    size_t getNumFeatures() const override;
+    
+    /**
+     * @brief Counts the vocabulary terms a document contains
+     * @param text Document to analyze
+     * @param counts Output entries with ascending feature indices
+     * @param spans Optional output with the first occurrence of each entry
+     */
+    TermCoverage countFeatures(
+        std::string_view text,
+        std::vector<FeatureCount>& counts,
+        std::vector<FeatureSpan>* spans = nullptr
+    ) const override;
+    
+    /**
+     * @brief Get the IDF weight of each vocabulary term
+     * @return IDF weights computed once after fit() or load()
+     */
+    const std::vector<double>& getIdfWeights() const override;
+    
+    /**
+     * @brief Checks whether term frequencies are scaled sublinearly
+     * @return True if tf is replaced by 1 + log(tf)
+     */
+    bool usesSublinearTf() const override;
     
     /**
      * @brief Serializes the vectorizer to a file
      * @param filePath Path where the vectorizer should be saved
      * @return True if serialization was successful
      */
-    bool save(const std::string& filePath) const;
+    bool save(const std::string& filePath) const override;
     
     /**
      * @brief Loads a vectorizer from a file
      * @param filePath Path to the saved vectorizer
      * @return True if loading was successful
      */
-    bool load(const std::string& filePath);
+    bool load(const std::string& filePath) override;
+    
+    /**
+     * @brief Adds the vectorizer's sections to a model bundle
+     * @param bundle Bundle being assembled
+     */
+    void writeBundle(utils::BundleWriter& bundle) const override;
+    
+    /**
+     * @brief Restores the vectorizer from a model bundle
+     * @param bundle Open bundle
+     * @return True if the bundle holds a valid vectorizer of this kind
+     */
+    bool readBundle(const utils::BundleReader& bundle) override;
     
 private:
     bool sublinearTf;                           ///< Whether to apply sublinear TF scaling
     double maxDf;                               ///< Maximum document frequency
+    double minDf = 1.0;                         ///< Minimum document frequency (fit only)
     size_t maxFeatures;                         ///< Maximum vocabulary size
+    size_t maxPendingTerms = 0;                 ///< Pending term limit during fit (0 = none)
+    int prunedDocFreq = 0;                      ///< Highest document frequency dropped by pruning
     size_t minNgram;                            ///< Minimum n-gram length
     size_t maxNgram;                            ///< Maximum n-gram length
     std::unordered_map<std::string, int> vocabulary; ///< Maps terms to feature indices
     std::vector<int> documentFrequencies;       ///< Document frequency for each term
     int totalDocuments;                         ///< Total number of documents seen during fit
+    std::vector<double> idfWeights;             ///< Smoothed IDF for each term
+    Tokenizer tokenizer;                        ///< Word splitter and n-gram hasher
+    TermIndex termIndex;                        ///< Term ID to feature index lookup
     
     /**
-     * @brief Transforms a single document into a TF-IDF feature vector
-     * @param text Document to transform
-     * @return TF-IDF feature vector
+     * @brief Document frequency and string form of a term seen during fit
      */
-    std::vector<double> transformSingleDocument(const std::string& text) const;
+    struct PendingTerm {
+        int docFreq = 0;   ///< Number of documents containing the term
+        std::string term;  ///< Term text, built on first sight
+    };
+    
+    /// Number of pending count shards (selected by the top bits of the term ID)
+    static constexpr size_t PENDING_SHARD_BITS = 6;
+    
+    /// Pending counts split by term ID so shards can be merged independently
+    using PendingShards = std::array<std::unordered_map<TermId, PendingTerm>, size_t{1} << PENDING_SHARD_BITS>;
+    
+    PendingShards pendingTerms; ///< Counts collected by partialFit()
     
     /**
-     * @brief Normalizes a vector to unit length (L2 norm)
-     * @param vector Vector to normalize
+     * @brief Counts the document frequencies of a slice of documents
+     * @param texts Documents to count
+     * @param shards Counts to add to
      */
-    void normalizeVector(std::vector<double>& vector) const;
+    void countDocuments(std::span<const std::string> texts, PendingShards& shards) const;
     
     /**
-     * @brief Builds vocabulary from tokenized documents
-     * @param tokenizedDocs Collection of tokenized documents
-     * @param maxDf Maximum document frequency threshold
-     * @param maxFeatures Maximum vocabulary size
+     * @brief Drops the least frequent pending terms once there are too many
+     * @param workers Number of worker threads to prune with
      */
-    void buildVocabulary(
-        const std::vector<std::vector<std::string>>& tokenizedDocs,
-        double maxDf,
-        size_t maxFeatures
-    );
+    void prunePendingTerms(size_t workers);
+    
+    /**
+     * @brief Recomputes the IDF table from the document frequencies
+     */
+    void updateIdfWeights();
+    
+    /**
+     * @brief Normalizes a vector to unit length (L2 norm)
+     * @param vector Vector to normalize (dense values or sparse non-zeros)
+     */
+    void normalizeVector(std::vector<double>& vector) const;
     
     /**
      * @brief Calculates TF-IDF score for a term
@@ -158,5 +563,180 @@ private:
     double calculateTfIdf(int termFreq, int docFreq, int totalDocs) const;
 };
 
+/**
+ * @brief Converts text into TF-IDF features by hashing n-grams into buckets
+ * 
+ * Each n-gram is mapped straight to one of 2^hashBits buckets with a
+ * seeded hash, so no vocabulary is stored and memory during fit() is
+ * bounded by the bucket count rather than by the number of distinct
+ * n-grams in the corpus. With signed hashing, a second hash bit picks
+ * the sign of each contribution so that colliding terms tend to cancel
+ * instead of piling up. Document frequencies and IDF weights are kept
+ * per bucket, and the saved file has a fixed size for a given hashBits.
+ */
+class HashingVectorizer : public Vectorizer {
+public:
+    /**
+     * @brief Constructor with customizable parameters
+     * @param sublinearTf Whether to apply sublinear scaling to term frequencies
+     * @param hashBits Number of hash bits (the feature space has 2^hashBits buckets)
+     * @param minNgram Minimum n-gram length
+     * @param maxNgram Maximum n-gram length
+     * @param signedHash Whether to hash the sign of each contribution
+     * @param seed Seed mixed into the bucket hash
+     * @throws std::invalid_argument If hashBits is outside [1, 30]
+     */
+    HashingVectorizer(
+        bool sublinearTf = true,
+        size_t hashBits = 20,
+        size_t minNgram = 1,
+        size_t maxNgram = 2,
+        bool signedHash = true,
+        uint64_t seed = 0
+    );
+    
+    /**
+     * @brief Counts document frequencies per bucket
+     * @param texts Collection of documents to analyze
+     */
+    void fit(const std::vector<std::string>& texts) override;
+    
+    /**
+     * @brief Resets the per-bucket document frequencies
+     */
+    void beginFit() override;
+    
+    /**
+     * @brief Adds the buckets each document of a batch hits
+     * @param texts Batch of documents
+     */
+    void partialFit(const std::vector<std::string>& texts) override;
+    
+    /**
+     * @brief Computes the IDF weights from the accumulated counts
+     */
+    void finishFit() override;
+    
+    /**
+     * @brief Transforms documents into dense hashed TF-IDF vectors
+     * @param texts Collection of documents to transform
+     * @return Matrix of features (one vector per document)
+     */
+    std::vector<std::vector<double>> transform(
+        const std::vector<std::string>& texts
+    ) const override;
+    
+    /**
+     * @brief Transforms documents into sparse hashed TF-IDF vectors
+     * @param texts Collection of documents to transform
+     * @return Sparse features with ascending bucket indices
+     */
+    std::vector<SparseVector> transformSparse(
+        const std::vector<std::string>& texts
+    ) const override;
+    
+    /**
+     * @brief Get the number of buckets
+     * @return 2^hashBits
+     */
+    size_t getNumFeatures() const override;
+    
+    /**
+     * @brief Counts the buckets a document hits
+     * @param text Document to analyze
+     * @param counts Output entries with ascending bucket indices; signed
+     *               collisions that cancel out are dropped
+     * @param spans Optional output with the first occurrence of each entry
+     */
+    TermCoverage countFeatures(
+        std::string_view text,
+        std::vector<FeatureCount>& counts,
+        std::vector<FeatureSpan>* spans = nullptr
+    ) const override;
+    
+    /**
+     * @brief Get the IDF weight of each bucket
+     * @return IDF weights computed once after fit() or load()
+     */
+    const std::vector<double>& getIdfWeights() const override;
+    
+    /**
+     * @brief Checks whether term frequencies are scaled sublinearly
+     * @return True if tf is replaced by 1 + log(tf)
+     */
+    bool usesSublinearTf() const override;
+    
+    /**
+     * @brief Gets the bucket a term is hashed into
+     * @param term Word or underscore-joined n-gram
+     * @return Bucket index
+     */
+    int getBucket(std::string_view term) const;
+    
+    /**
+     * @brief Get the document frequency of each bucket
+     * @return Vector of document frequencies
+     */
+    const std::vector<int>& getDocumentFrequencies() const;
+    
+    /**
+     * @brief Serializes the vectorizer to a file
+     * @param filePath Path where the vectorizer should be saved
+     * @return True if serialization was successful
+     */
+    bool save(const std::string& filePath) const override;
+    
+    /**
+     * @brief Loads a vectorizer from a file
+     * @param filePath Path to the saved vectorizer
+     * @return True if loading was successful
+     */
+    bool load(const std::string& filePath) override;
+    
+    /**
+     * @brief Adds the vectorizer's sections to a model bundle
+     * @param bundle Bundle being assembled
+     */
+    void writeBundle(utils::BundleWriter& bundle) const override;
+    
+    /**
+     * @brief Restores the vectorizer from a model bundle
+     * @param bundle Open bundle
+     * @return True if the bundle holds a valid vectorizer of this kind
+     */
+    bool readBundle(const utils::BundleReader& bundle) override;
+    
+    /**
+     * @brief Checks whether a file was written by HashingVectorizer::save()
+     * @param filePath Path to check
+     * @return True if the file starts with the hashing vectorizer header
+     */
+    static bool isVectorizerFile(const std::string& filePath);
+    
+private:
+    bool sublinearTf;                      ///< Whether to apply sublinear TF scaling
+    size_t hashBits;                       ///< Number of hash bits
+    size_t minNgram;                       ///< Minimum n-gram length
+    size_t maxNgram;                       ///< Maximum n-gram length
+    bool signedHash;                       ///< Whether contributions carry a hashed sign
+    uint64_t seed;                         ///< Bucket hash seed
+    int totalDocuments;                    ///< Total number of documents seen during fit
+    std::vector<int> documentFrequencies;  ///< Document frequency for each bucket
+    std::vector<double> idfWeights;        ///< Smoothed IDF for each bucket
+    Tokenizer tokenizer;                   ///< Word splitter and n-gram hasher
+    
+    /**
+     * @brief Mixes a term ID with the seed
+     * @param id Term identifier
+     * @return Hash whose low bits select the bucket and top bit the sign
+     */
+    uint64_t mixTerm(TermId id) const;
+    
+    /**
+     * @brief Recomputes the IDF table from the document frequencies
+     */
+    void updateIdfWeights();
+};
+
 } // namespace preprocessing
 } // namespace blahajpi
@@ -0,0 +1,210 @@
+/**
+ * @file batch_summary.hpp
+ * @brief Mergeable summary of a batch scoring run
+ *
+ * This file provides the aggregate view a batch run prints: file and
+ * harmful counts, a histogram of harm probabilities, the most frequent
+ * words of harmful texts, the largest near-duplicate clusters, and
+ * classification metrics when labels are known. Every part is a count that adds up, so runs over disjoint shards
+ * of an input can be saved, merged and reported as if one node had
+ * processed the whole input.
+ */
+
+#pragma once
+
+#include "blahajpi/utils/word_counter.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace blahajpi {
+
+struct AnalysisResult;
+
+namespace utils {
+
+/**
+ * @brief Picks the shard an input belongs to
+ *
+ * Uses a hash of the key rather than its position, so every node assigns
+ * an input to the same shard whatever order it lists the inputs in.
+ *
+ * @param key Stable name of the input (e.g. its path relative to the input directory)
+ * @param shardCount Number of shards (at least 1)
+ * @return Shard index in [0, shardCount)
+ */
+size_t shardOf(std::string_view key, size_t shardCount);
+
+/**
+ * @brief Counts of a batch run over one or more shards of an input
+ *
+ * A summary of an unsharded run covers shard 0 of 1. Summaries of shards
+ * of the same input merge into one; merging overlapping shards, or shards
+ * of differently split inputs, is refused so files are never counted
+ * twice. The word counts are a bounded WordCounter, so the top words of a
+ * merged summary are accurate to the same share of the total weight as
+ * those of a single run.
+ */
+class BatchSummary {
+public:
+    /// Harm probability bins of the score histogram, each 1 / SCORE_BINS wide
+    static constexpr size_t SCORE_BINS = 10;
+
+    /// Words kept by the word counts of harmful texts
+    static constexpr size_t TERM_CAPACITY = 1024;
+
+    /// Clusters kept by the near-duplicate cluster counts
+    static constexpr size_t CLUSTER_CAPACITY = 1024;
+
+    /**
+     * @brief Constructor
+     * @param shardIndex Shard this summary covers
+     * @param shardCount Number of shards the input is split into
+     * @throws std::invalid_argument If shardIndex is not below shardCount
+     */
+    explicit BatchSummary(size_t shardIndex = 0, size_t shardCount = 1);
+
+    /**
+     * @brief Counts a scored file
+     * @param result Analysis result (harm score, confidence and near-duplicate cluster)
+     */
+    void add(const AnalysisResult& result);
+
+    /**
+     * @brief Counts a scored file whose true label is known
+     * @param result Analysis result
+     * @param label True label (0 = safe, anything else = harmful)
+     */
+    void add(const AnalysisResult& result, int label);
+
+    /**
+     * @brief Counts a file that could not be read or scored
+     */
+    void addError();
+
+    /**
+     * @brief Adds word counts of harmful texts
+     * @param counts Counts to fold into the bounded word counts
+     */
+    void addTerms(const WordCounter& counts);
+
+    /**
+     * @brief Adds the counts of a summary of other shards
+     * @param other Summary of the same input split the same way
+     * @throws std::invalid_argument If the splits differ or the shards overlap
+     */
+    void merge(const BatchSummary& other);
+
+    /**
+     * @brief Gets the number of files counted, including errors
+     * @return File count
+     */
+    uint64_t getFiles() const { return files; }
+
+    /**
+     * @brief Gets the number of files scored as harmful
+     * @return Harmful count
+     */
+    uint64_t getHarmful() const { return harmful; }
+
+    /**
+     * @brief Gets the number of files that could not be read or scored
+     * @return Error count
+     */
+    uint64_t getErrors() const { return errors; }
+
+    /**
+     * @brief Gets the number of scored files with a known label
+     * @return Labeled count
+     */
+    uint64_t getLabeled() const { return tn + fp + fn + tp; }
+
+    /**
+     * @brief Gets the number of scored files per harm probability bin
+     * @return Counts, lowest probabilities first
+     */
+    const std::array<uint64_t, SCORE_BINS>& getScoreBins() const { return scoreBins; }
+
+    /**
+     * @brief Gets the word counts of harmful texts
+     * @return Bounded word counts
+     */
+    const WordCounter& getTerms() const { return terms; }
+
+    /**
+     * @brief Gets the number of files per near-duplicate cluster
+     *
+     * Cluster IDs come from the analyzer of each run, so near duplicates
+     * scored by different shards count under different IDs.
+     *
+     * @return Bounded counts keyed by AnalysisResult::formatCluster()
+     */
+    const WordCounter& getClusters() const { return clusters; }
+
+    /**
+     * @brief Computes classification metrics over the labeled files
+     * @return Metrics::calculateMetricsFromCounts() values (empty without labels)
+     */
+    std::unordered_map<std::string, double> getMetrics() const;
+
+    /**
+     * @brief Gets the number of shards the input is split into
+     * @return Shard count
+     */
+    size_t getShardCount() const { return shardCount; }
+
+    /**
+     * @brief Gets the shards this summary covers
+     * @return Shard indices in ascending order
+     */
+    const std::vector<size_t>& getShards() const { return shards; }
+
+    /**
+     * @brief Checks whether every shard of the input is covered
+     * @return True if the summary stands for the whole input
+     */
+    bool isComplete() const { return shards.size() == shardCount; }
+
+    /**
+     * @brief Formats the summary printed at the end of a batch run
+     * @param topTerms Most frequent words of harmful texts to list
+     * @param topClusters Largest near-duplicate clusters to list
+     * @return Multi-line report
+     */
+    std::string report(size_t topTerms = 10, size_t topClusters = 5) const;
+
+    /**
+     * @brief Writes the summary to a text file
+     * @param filePath Destination path
+     * @return True if the file was written
+     */
+    bool save(const std::string& filePath) const;
+
+    /**
+     * @brief Reads a summary written by save()
+     * @param filePath Source path
+     * @return True if the file holds a valid summary (the summary is unchanged otherwise)
+     */
+    bool load(const std::string& filePath);
+
+private:
+    size_t shardCount;                         ///< Number of shards the input is split into
+    std::vector<size_t> shards;                ///< Shards covered, ascending
+    uint64_t files = 0;                        ///< Files counted, including errors
+    uint64_t harmful = 0;                      ///< Files scored as harmful
+    uint64_t errors = 0;                       ///< Files that could not be read or scored
+    std::array<uint64_t, SCORE_BINS> scoreBins{};  ///< Scored files per harm probability bin
+    uint64_t tn = 0;                           ///< Labeled safe, scored safe
+    uint64_t fp = 0;                           ///< Labeled safe, scored harmful
+    uint64_t fn = 0;                           ///< Labeled harmful, scored safe
+    uint64_t tp = 0;                           ///< Labeled harmful, scored harmful
+    WordCounter terms{TERM_CAPACITY};          ///< Word counts of harmful texts
+    WordCounter clusters{CLUSTER_CAPACITY};    ///< Files per near-duplicate cluster
+};
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,78 @@
+/**
+ * @file byte_kernels.hpp
+ * @brief Vectorized byte-class filters behind the character-level steps
+ *
+ * Lowercasing, dropping punctuation, digits or non-ASCII bytes, collapsing
+ * whitespace and collapsing repeated characters each look at one byte at
+ * a time and keep or change it by its class. This file provides kernels
+ * that classify 16 or 32 bytes per instruction (SSE2, AVX2 or NEON, chosen
+ * at run time) and copy whole blocks when nothing in them changes, with a
+ * table-driven scalar path for the tails and for other targets.
+ *
+ * Classes follow the "C" locale that the rest of the preprocessing uses:
+ * bytes from 0x80 up are neither letters, digits, punctuation nor space.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Byte classes the kernels filter on, combined with |
+ */
+enum ByteClass : uint8_t {
+    BYTE_UPPER = 1u << 0,      ///< A-Z
+    BYTE_DIGIT = 1u << 1,      ///< 0-9
+    BYTE_PUNCT = 1u << 2,      ///< Printable ASCII other than letters, digits and space (std::ispunct)
+    BYTE_SPACE = 1u << 3,      ///< Space, \\t, \\n, \\v, \\f and \\r (std::isspace)
+    BYTE_NON_ASCII = 1u << 4   ///< 0x80-0xFF
+};
+
+/**
+ * @brief Appends text with some byte classes dropped, optionally lowercased
+ *
+ * Lowercasing happens first, so dropping BYTE_UPPER has no effect when
+ * lowercase is set. With no classes and no lowercasing this is a copy.
+ *
+ * @param text Text to filter
+ * @param dropClasses ByteClass bits of the bytes to drop
+ * @param lowercase Whether to map A-Z to a-z
+ * @param output String to append to
+ */
+void appendFiltered(std::string_view text, uint8_t dropClasses, bool lowercase, std::string& output);
+
+/**
+ * @brief Appends text with whitespace runs collapsed to single spaces
+ *
+ * Leading and trailing whitespace of text is dropped.
+ *
+ * @param text Text to normalize
+ * @param output String to append to
+ */
+void appendCollapsedWhitespace(std::string_view text, std::string& output);
+
+/**
+ * @brief Appends text with runs of one character cut to two
+ *
+ * A character is dropped when it repeats the one before it in text and
+ * the characters kept for text so far are fewer than two or end in a pair
+ * ("soooo" becomes "soo", "aaa" becomes "a").
+ *
+ * @param text Text to normalize
+ * @param output String to append to
+ */
+void appendCollapsedRepeats(std::string_view text, std::string& output);
+
+/**
+ * @brief Gets the instruction set the kernels were dispatched to
+ * @return "avx2", "sse2", "neon" or "scalar"
+ */
+const char* byteKernelIsa();
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,92 @@
+/**
+ * @file csv_parser.hpp
+ * @brief Zero-copy parser for delimited text (CSV and TSV)
+ *
+ * This file provides a record parser that works in place over a buffer,
+ * usually a memory-mapped dataset. Fields are returned as views into the
+ * buffer; only fields the caller asks for are unescaped into strings.
+ * Delimiters and line breaks are located with SSE2 where available.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief One field of a delimited record
+ */
+struct DelimitedField {
+    std::string_view raw;   ///< Field bytes, without the enclosing quotes
+    bool escaped = false;   ///< Whether raw contains doubled quotes ("")
+
+    /**
+     * @brief Gets the field value with doubled quotes collapsed
+     * @return Unescaped value
+     */
+    std::string value() const;
+};
+
+/**
+ * @brief Splits a buffer of delimited text into records
+ *
+ * With quoting enabled, fields follow RFC 4180: a field that starts with
+ * a double quote runs to the matching closing quote, may contain
+ * delimiters and line breaks, and writes a literal quote as "". Quotes
+ * inside an unquoted field are ordinary characters. Records end at LF or
+ * CRLF. A field whose closing quote is followed by more text is read
+ * verbatim up to the next delimiter, quotes included.
+ */
+class DelimitedParser {
+public:
+    /**
+     * @brief Constructor
+     * @param data Buffer to parse (must outlive the parser and its fields)
+     * @param delimiter Field separator
+     * @param quoting Whether double quotes delimit fields (false for TSV)
+     */
+    DelimitedParser(std::string_view data, char delimiter, bool quoting);
+
+    /**
+     * @brief Parses the next record
+     * @param fields Output fields (cleared first)
+     * @return False once the end of the buffer is reached
+     */
+    bool next(std::vector<DelimitedField>& fields);
+
+    /**
+     * @brief Gets the offset of the next unparsed byte
+     * @return Byte offset into the buffer
+     */
+    size_t position() const;
+
+    /**
+     * @brief Moves to a record boundary returned by position()
+     * @param offset Byte offset into the buffer
+     */
+    void seek(size_t offset);
+
+private:
+    std::string_view data;  ///< Buffer being parsed
+    size_t pos = 0;         ///< Offset of the next record
+    char delimiter;         ///< Field separator
+    bool quoting;           ///< Whether quoted fields are recognized
+};
+
+/**
+ * @brief Finds the first byte equal to either of two values
+ * @param begin First byte to examine
+ * @param end One past the last byte
+ * @param first First value to look for
+ * @param second Second value to look for
+ * @return Pointer to the match, or end if there is none
+ */
+const char* findEither(const char* begin, const char* end, char first, char second);
+
+} // namespace utils
+} // namespace blahajpi
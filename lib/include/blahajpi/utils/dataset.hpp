@@ -5,10 +5,16 @@
  * This file provides functionality for loading, preprocessing, and managing
  * datasets for training and evaluation. It handles data from various social
  * media sources and supports splitting data for training and testing.
+ * Samples are stored column by column, and train, test and per-label
+ * subsets are exposed as views that index into the stored columns
+ * instead of copying them.
  */
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <span>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -19,6 +25,103 @@
 namespace blahajpi {
 namespace utils {
 
+/**
+ * @brief Read-only view of the column elements selected by a list of indices
+ * 
+ * Neither the column nor the indices are copied, so a view is only valid
+ * while the Dataset it came from is alive and unchanged.
+ * 
+ * @tparam T Element type of the column
+ */
+template <typename T>
+class IndexedView {
+public:
+    /**
+     * @brief Iterator over the selected elements, in index order
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        
+        Iterator() = default;
+        
+        /**
+         * @brief Constructor
+         * @param column Column being indexed
+         * @param position Current position in the index list
+         */
+        Iterator(const T* column, const size_t* position) : column(column), position(position) {}
+        
+        reference operator*() const { return column[*position]; }
+        pointer operator->() const { return column + *position; }
+        Iterator& operator++() { ++position; return *this; }
+        Iterator operator++(int) { Iterator previous = *this; ++position; return previous; }
+        bool operator==(const Iterator& other) const { return position == other.position; }
+        
+    private:
+        const T* column = nullptr;          ///< Column being indexed
+        const size_t* position = nullptr;   ///< Current position in the index list
+    };
+    
+    IndexedView() = default;
+    
+    /**
+     * @brief Constructor
+     * @param column Column to select from
+     * @param indices Positions in the column, in view order
+     */
+    IndexedView(std::span<const T> column, std::span<const size_t> indices)
+        : column(column), indices(indices) {}
+    
+    /**
+     * @brief Gets the number of selected elements
+     * @return Element count
+     */
+    size_t size() const { return indices.size(); }
+    
+    /**
+     * @brief Checks whether nothing is selected
+     * @return True if the view is empty
+     */
+    bool empty() const { return indices.empty(); }
+    
+    /**
+     * @brief Gets a selected element
+     * @param i Position in the view
+     * @return Element at that position
+     */
+    const T& operator[](size_t i) const { return column[indices[i]]; }
+    
+    /**
+     * @brief Gets the column positions the view selects
+     * @return Indices into the dataset, in view order
+     */
+    std::span<const size_t> getIndices() const { return indices; }
+    
+    Iterator begin() const { return Iterator(column.data(), indices.data()); }
+    Iterator end() const { return Iterator(column.data(), indices.data() + indices.size()); }
+    
+    /**
+     * @brief Copies the selected elements
+     * @return Vector of the elements in view order
+     */
+    std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+    
+private:
+    std::span<const T> column;          ///< Column being indexed
+    std::span<const size_t> indices;    ///< Selected positions
+};
+
+/// View of selected texts of a dataset
+using TextView = IndexedView<std::string>;
+
+/// View of selected labels of a dataset
+using LabelView = IndexedView<int>;
+
 /**
  * @brief Manages data for content analysis and model training
  * 
@@ -86,6 +189,49 @@ public:
         unsigned int randomSeed = 42
     );
     
+    /**
+     * @brief Views the training texts without copying them
+     * @return Texts of the training split (empty before splitTrainTest())
+     */
+    TextView viewTrainTexts() const;
+    
+    /**
+     * @brief Views the training labels without copying them
+     * @return Labels of the training split, aligned with viewTrainTexts()
+     */
+    LabelView viewTrainLabels() const;
+    
+    /**
+     * @brief Views the test texts without copying them
+     * @return Texts of the test split (empty before splitTrainTest())
+     */
+    TextView viewTestTexts() const;
+    
+    /**
+     * @brief Views the test labels without copying them
+     * @return Labels of the test split, aligned with viewTestTexts()
+     */
+    LabelView viewTestLabels() const;
+    
+    /**
+     * @brief Views the texts with a specific label without copying them
+     * @param label Label value to filter by
+     * @return Texts with that label, in dataset order
+     */
+    TextView viewTextsWithLabel(int label) const;
+    
+    /**
+     * @brief Gets the text column
+     * @return Every text in dataset order
+     */
+    std::span<const std::string> textColumn() const;
+    
+    /**
+     * @brief Gets the label column
+     * @return Every label in dataset order
+     */
+    std::span<const int> labelColumn() const;
+    
     /**
      * @brief Gets training data
      * @return Vector of (label, text) pairs for training
@@ -122,6 +268,39 @@ public:
      */
     std::vector<int> getTestLabels() const;
     
+    /**
+     * @brief Gets all texts in dataset order
+     * @return Vector of every text sample
+     */
+    std::vector<std::string> getTexts() const;
+    
+    /**
+     * @brief Gets all labels in dataset order
+     * @return Vector of every label
+     */
+    std::vector<int> getLabels() const;
+    
+    /**
+     * @brief Assigns every sample to a cross-validation fold
+     * 
+     * Samples are shuffled and dealt round-robin, so fold sizes differ by
+     * at most one. With stratification each label is dealt separately,
+     * which keeps the class distribution of every fold close to the
+     * whole dataset's. Unlike splitTrainTest(), this does not change the
+     * train/test split.
+     * 
+     * @param folds Number of folds (at least 2, at most size())
+     * @param stratify Whether to maintain class distribution
+     * @param randomSeed Seed for random number generation
+     * @return Fold number (0 to folds - 1) of each sample, in dataset order
+     * @throws std::invalid_argument If the fold count is out of range
+     */
+    std::vector<size_t> assignFolds(
+        size_t folds,
+        bool stratify = true,
+        unsigned int randomSeed = 42
+    ) const;
+    
     /**
      * @brief Gets texts with a specific label
      * @param label Label value to filter by
@@ -148,12 +327,19 @@ public:
     std::unordered_map<std::string, std::string> getStatistics() const;
 
 private:
-    std::vector<std::pair<int, std::string>> data;      ///< Raw data (label, text)
-    std::vector<std::string> cleanedTexts;              ///< Preprocessed texts
-    std::vector<int> labels;                           ///< Extracted labels
+    std::vector<std::string> texts;                    ///< Text of every sample
+    std::vector<int> labels;                           ///< Label of every sample
+    std::vector<std::pair<int, std::vector<size_t>>> labelGroups; ///< Sample indices per label, by increasing label
     std::vector<size_t> trainIndices;                  ///< Indices for training samples
     std::vector<size_t> testIndices;                   ///< Indices for test samples
     
+    /**
+     * @brief Rebuilds the per-label index lists after the samples change
+     * 
+     * Also clears the train/test split, which referred to the old samples.
+     */
+    void indexLabels();
+    
     /**
      * @brief Loads data from a CSV file
      * @param filePath Path to the CSV file
@@ -192,6 +378,21 @@ private:
         const std::string& labelColumn,
         const std::string& textColumn
     );
+    
+    /**
+     * @brief Loads a CSV or TSV file through the delimited-text parser
+     * @param filePath Path to the data file
+     * @param format CSV or TSV
+     * @param labelColumn Name of the column containing labels
+     * @param textColumn Name of the column containing text
+     * @return True if loading was successful
+     */
+    bool loadDelimited(
+        const std::string& filePath,
+        Format format,
+        const std::string& labelColumn,
+        const std::string& textColumn
+    );
 };
 
 } // namespace utils
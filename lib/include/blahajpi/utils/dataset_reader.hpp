@@ -0,0 +1,112 @@
+/**
+ * @file dataset_reader.hpp
+ * @brief Streaming reader for labeled datasets
+ *
+ * This file provides a reader that yields (label, text) samples from a
+ * CSV or TSV file in fixed-size batches, so training can make several
+ * passes over datasets that do not fit in memory. The file is memory
+ * mapped and parsed in place; only the label and text columns of each
+ * row are copied out.
+ */
+
+#pragma once
+
+#include "blahajpi/utils/csv_parser.hpp"
+#include "blahajpi/utils/dataset.hpp"
+#include "blahajpi/utils/mapped_file.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Reads labeled samples from disk one batch at a time
+ *
+ * CSV files follow RFC 4180 (quoted fields may span lines); TSV files
+ * are split at tabs without quoting. Header names are matched without
+ * regard to case or spaces. JSON files are not supported because the
+ * JSON format is a single array.
+ */
+class DatasetReader {
+public:
+    /**
+     * @brief Opens a dataset file and locates the label and text columns
+     * @param filePath Path to the data file
+     * @param format Format of the data file (AUTO uses the extension)
+     * @param labelColumn Name of the column containing labels
+     * @param textColumn Name of the column containing text
+     * @return True if the file was opened and both columns were found
+     */
+    bool open(
+        const std::string& filePath,
+        Dataset::Format format = Dataset::Format::AUTO,
+        const std::string& labelColumn = "label",
+        const std::string& textColumn = "text"
+    );
+
+    /**
+     * @brief Reads the next batch of samples
+     *
+     * Rows with too few columns or an unparsable label are skipped.
+     *
+     * @param batch Output samples (cleared first)
+     * @param maxSamples Maximum number of samples to read
+     * @return Number of samples read (0 at the end of the file)
+     */
+    size_t readBatch(std::vector<std::pair<int, std::string>>& batch, size_t maxSamples);
+
+    /**
+     * @brief Returns to the first data row for another pass
+     * @return True if the reader is positioned at the first row
+     */
+    bool rewind();
+
+    /**
+     * @brief Checks whether a file is open
+     * @return True after a successful open()
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Gets the number of samples read since open() or rewind()
+     * @return Sample count
+     */
+    size_t getSamplesRead() const;
+
+    /**
+     * @brief Assigns a sample to the held-out split by its position
+     *
+     * Streaming cannot shuffle the whole file, so the split is a seeded
+     * hash of the sample index: the same sample lands in the same split on
+     * every pass.
+     *
+     * @param sampleIndex Position of the sample in the file
+     * @param testSize Fraction of samples to hold out (0.0-1.0)
+     * @param seed Split seed
+     * @return True if the sample belongs to the test split
+     */
+    static bool isHeldOut(size_t sampleIndex, double testSize, unsigned int seed);
+
+private:
+    std::shared_ptr<const MappedFile> file;       ///< Mapped dataset
+    DelimitedParser parser{{}, ',', true};        ///< Record parser over the mapping
+    std::vector<DelimitedField> fields;           ///< Fields of the current row
+    size_t labelIdx = 0;                          ///< Column index of the label
+    size_t textIdx = 0;                           ///< Column index of the text
+    size_t dataStart = 0;                         ///< Offset of the first data row
+    size_t samplesRead = 0;                       ///< Samples returned since open() or rewind()
+
+    /**
+     * @brief Converts the parsed fields of a row into a sample
+     * @param sample Output sample
+     * @return True if the row has both columns and a numeric label
+     */
+    bool parseRow(std::pair<int, std::string>& sample) const;
+};
+
+} // namespace utils
+} // namespace blahajpi
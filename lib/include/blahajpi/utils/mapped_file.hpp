@@ -0,0 +1,72 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped files
+ *
+ * This file provides a small RAII wrapper that maps a file into memory so
+ * that several processes loading the same model share one page-cache copy.
+ * On platforms without mmap the file is read into a private buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Read-only view of a whole file
+ *
+ * Instances are handed out through shared pointers so that objects built
+ * on top of the mapping (for example a vocabulary index) can keep it
+ * alive for as long as they use it.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps a file into memory
+     * @param filePath Path to the file
+     * @return Mapped file, or nullptr if the file could not be opened
+     */
+    static std::shared_ptr<const MappedFile> open(const std::string& filePath);
+
+    /**
+     * @brief Unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Gets the file contents
+     * @return Pointer to the first byte (page aligned when mapped)
+     */
+    const unsigned char* data() const;
+
+    /**
+     * @brief Gets the file size
+     * @return Size in bytes
+     */
+    size_t size() const;
+
+    /**
+     * @brief Checks whether the contents are backed by a shared mapping
+     * @return True if mmap was used, false for the buffered fallback
+     */
+    bool isMapped() const;
+
+private:
+    MappedFile() = default;
+
+    const unsigned char* bytes = nullptr;  ///< File contents
+    size_t length = 0;                     ///< Size in bytes
+    bool mapped = false;                   ///< Whether bytes came from mmap
+    std::vector<unsigned char> buffer;     ///< Storage for the buffered fallback
+};
+
+} // namespace utils
+} // namespace blahajpi
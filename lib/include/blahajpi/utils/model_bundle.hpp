@@ -0,0 +1,254 @@
+/**
+ * @file model_bundle.hpp
+ * @brief Versioned single-file container for trained models
+ *
+ * This file provides the writer and reader for model bundles (model.bpi).
+ * A bundle is a small header followed by a table of tagged sections, each
+ * aligned to 64 bytes and protected by a CRC-32. All fields are fixed
+ * width and little-endian, so bundles move freely between build hosts,
+ * and the reader works directly on a memory-mapped file.
+ *
+ * Layout:
+ *   header   magic "BLAHAJPI", u32 version, u32 section count,
+ *            u64 file size, u32 CRC-32 of the section table, u32 reserved
+ *   table    per section: char tag[4], u32 CRC-32, u64 offset, u64 size,
+ *            u64 reserved
+ *   sections section payloads, each starting on a 64-byte boundary
+ */
+
+#pragma once
+
+#include "blahajpi/utils/mapped_file.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Computes the CRC-32 (IEEE 802.3) of a byte range
+ * @param data First byte
+ * @param size Number of bytes
+ * @return Checksum
+ */
+uint32_t crc32(const unsigned char* data, size_t size);
+
+/**
+ * @brief Little-endian encoder for the payload of one section
+ */
+class SectionWriter {
+public:
+    /// @brief Appends an unsigned 8-bit value
+    void writeU8(uint8_t value);
+    /// @brief Appends an unsigned 32-bit value
+    void writeU32(uint32_t value);
+    /// @brief Appends a signed 32-bit value
+    void writeI32(int32_t value);
+    /// @brief Appends an unsigned 64-bit value
+    void writeU64(uint64_t value);
+    /// @brief Appends a signed 64-bit value
+    void writeI64(int64_t value);
+    /// @brief Appends an IEEE-754 double
+    void writeF64(double value);
+    /// @brief Appends a length-prefixed (u32) string
+    void writeString(std::string_view value);
+    /// @brief Appends raw bytes
+    void writeBytes(const void* data, size_t size);
+    /// @brief Appends each value as a signed 32-bit integer (no length prefix)
+    void writeI32Array(const std::vector<int>& values);
+    /// @brief Appends each value as a double (no length prefix)
+    void writeF64Array(const std::vector<double>& values);
+
+    /**
+     * @brief Gets the encoded payload
+     * @return Payload bytes
+     */
+    const std::vector<unsigned char>& bytes() const;
+
+private:
+    std::vector<unsigned char> buffer;  ///< Encoded payload
+};
+
+/**
+ * @brief Bounds-checked little-endian decoder for one section
+ *
+ * Reads past the end return zero values and mark the reader as failed,
+ * so callers can decode a whole record and check ok() once.
+ */
+class SectionReader {
+public:
+    /**
+     * @brief Constructor
+     * @param bytes Section payload
+     */
+    explicit SectionReader(std::span<const unsigned char> bytes = {});
+
+    /// @brief Reads an unsigned 8-bit value
+    uint8_t readU8();
+    /// @brief Reads an unsigned 32-bit value
+    uint32_t readU32();
+    /// @brief Reads a signed 32-bit value
+    int32_t readI32();
+    /// @brief Reads an unsigned 64-bit value
+    uint64_t readU64();
+    /// @brief Reads a signed 64-bit value
+    int64_t readI64();
+    /// @brief Reads an IEEE-754 double
+    double readF64();
+    /// @brief Reads a length-prefixed (u32) string
+    std::string readString();
+
+    /**
+     * @brief Consumes raw bytes without copying them
+     * @param size Number of bytes
+     * @return View of the bytes (empty on failure)
+     */
+    std::span<const unsigned char> readBytes(size_t size);
+
+    /**
+     * @brief Reads signed 32-bit integers
+     * @param count Number of values
+     * @return Decoded values (empty on failure)
+     */
+    std::vector<int> readI32Array(size_t count);
+
+    /**
+     * @brief Reads doubles
+     * @param count Number of values
+     * @return Decoded values (empty on failure)
+     */
+    std::vector<double> readF64Array(size_t count);
+
+    /**
+     * @brief Gets the number of unread bytes
+     * @return Remaining size
+     */
+    size_t remaining() const;
+
+    /**
+     * @brief Checks whether every read so far was in bounds
+     * @return True if no read ran past the end
+     */
+    bool ok() const;
+
+private:
+    std::span<const unsigned char> data;  ///< Section payload
+    size_t position = 0;                  ///< Read offset
+    bool failed = false;                  ///< Whether a read ran past the end
+
+    /**
+     * @brief Reserves the next bytes for a read
+     * @param size Number of bytes
+     * @return Pointer to the bytes, or nullptr if out of bounds
+     */
+    const unsigned char* take(size_t size);
+};
+
+/**
+ * @brief Assembles sections and writes a bundle file
+ */
+class BundleWriter {
+public:
+    /**
+     * @brief Adds a section
+     * @param tag Four-character section tag
+     * @return Writer for the section payload (stays valid while the bundle lives)
+     * @throws std::invalid_argument If the tag is not four characters or already used
+     */
+    SectionWriter& addSection(const std::string& tag);
+
+    /**
+     * @brief Writes the bundle
+     *
+     * The file is written next to its destination and renamed into place,
+     * so readers never observe a partially written bundle.
+     *
+     * @param filePath Destination path
+     * @return True if the bundle was written
+     */
+    bool write(const std::string& filePath) const;
+
+private:
+    std::deque<std::pair<std::string, SectionWriter>> sections;  ///< Tagged sections in file order
+};
+
+/**
+ * @brief Validates and exposes the sections of a bundle file
+ */
+class BundleReader {
+public:
+    /// Newest format version this build can read
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /// Alignment of every section payload
+    static constexpr size_t SECTION_ALIGNMENT = 64;
+
+    /**
+     * @brief Maps a bundle and checks its header, layout and checksums
+     * @param filePath Path to the bundle
+     * @return True if the bundle is valid
+     */
+    bool open(const std::string& filePath);
+
+    /**
+     * @brief Checks whether a section is present
+     * @param tag Four-character section tag
+     * @return True if the section exists
+     */
+    bool hasSection(const std::string& tag) const;
+
+    /**
+     * @brief Gets the payload of a section
+     * @param tag Four-character section tag
+     * @return Payload bytes (empty if the section is missing)
+     */
+    std::span<const unsigned char> section(const std::string& tag) const;
+
+    /**
+     * @brief Creates a decoder for a section
+     * @param tag Four-character section tag
+     * @return Reader over the payload (empty if the section is missing)
+     */
+    SectionReader reader(const std::string& tag) const;
+
+    /**
+     * @brief Gets the format version of the open bundle
+     * @return Version number
+     */
+    uint32_t getVersion() const;
+
+    /**
+     * @brief Gets the underlying file
+     *
+     * Objects that keep pointers into a section hold on to this.
+     *
+     * @return Mapped file
+     */
+    const std::shared_ptr<const MappedFile>& getFile() const;
+
+    /**
+     * @brief Checks whether a file starts with the bundle magic
+     * @param filePath Path to check
+     * @return True if the file looks like a bundle
+     */
+    static bool isBundleFile(const std::string& filePath);
+
+private:
+    struct Section {
+        std::string tag;                       ///< Four-character tag
+        std::span<const unsigned char> bytes;  ///< Payload
+    };
+
+    std::shared_ptr<const MappedFile> file;  ///< Bundle contents
+    std::vector<Section> sections;           ///< Validated sections
+    uint32_t version = 0;                    ///< Format version
+};
+
+} // namespace utils
+} // namespace blahajpi
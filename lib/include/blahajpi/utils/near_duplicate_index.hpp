@@ -0,0 +1,385 @@
+/**
+ * @file near_duplicate_index.hpp
+ * @brief MinHash signatures and a bounded LSH index of near-duplicate clusters
+ *
+ * Campaigns post many lightly edited copies of one message. This file
+ * provides a MinHash signature of a text's hashed terms, whose matching
+ * slots estimate the Jaccard similarity of two texts' term sets, and an
+ * index that finds a stored signature similar to a new one without
+ * comparing against every entry. The analyzer keeps one result per
+ * cluster in it, so variants reuse the result of the text that started
+ * their cluster.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/// Min-hashes in a signature
+constexpr size_t MINHASH_SIZE = 64;
+
+/// Min-hashes per LSH band; MINHASH_SIZE / MINHASH_BAND_ROWS bands
+constexpr size_t MINHASH_BAND_ROWS = 4;
+
+/**
+ * @brief Smallest hash of a text's terms under each of MINHASH_SIZE hash functions
+ */
+using MinHashSignature = std::array<uint32_t, MINHASH_SIZE>;
+
+namespace detail {
+
+/**
+ * @brief Scrambles a 64-bit value (the splitmix64 finalizer)
+ * @param value Value to scramble
+ * @return Scrambled value
+ */
+constexpr uint64_t mix64(uint64_t value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Odd multipliers of the multiply-shift hash functions, one per slot
+ */
+constexpr std::array<uint64_t, MINHASH_SIZE> MINHASH_MULTIPLIERS = [] {
+    std::array<uint64_t, MINHASH_SIZE> multipliers{};
+    for (size_t i = 0; i < MINHASH_SIZE; ++i) {
+        multipliers[i] = mix64(0x9e3779b97f4a7c15ULL * (i + 1)) | 1;
+    }
+    return multipliers;
+}();
+
+} // namespace detail
+
+/**
+ * @brief Computes the MinHash signature of a set of term hashes
+ *
+ * Each slot keeps the smallest value of one multiply-shift hash function
+ * over the terms. The share of slots two signatures agree on estimates
+ * the Jaccard similarity of their term sets; repeated terms change
+ * nothing.
+ *
+ * @param termHashes Hashes of the text's terms (at least one)
+ * @return Signature
+ */
+inline MinHashSignature minHash(std::span<const uint64_t> termHashes) {
+    MinHashSignature signature;
+    signature.fill(std::numeric_limits<uint32_t>::max());
+    for (uint64_t hash : termHashes) {
+        // Term IDs are FNV-1a hashes; remix them so the high bits are unbiased (offset so 0 is not a fixed point)
+        hash = detail::mix64(hash + 0x9e3779b97f4a7c15ULL);
+        for (size_t i = 0; i < MINHASH_SIZE; ++i) {
+            uint32_t value = static_cast<uint32_t>((hash * detail::MINHASH_MULTIPLIERS[i]) >> 32);
+            signature[i] = std::min(signature[i], value);
+        }
+    }
+    return signature;
+}
+
+/**
+ * @brief Estimates the Jaccard similarity of the term sets behind two signatures
+ * @param a First signature
+ * @param b Second signature
+ * @return Share of matching slots in [0, 1]
+ */
+inline double similarity(const MinHashSignature& a, const MinHashSignature& b) {
+    size_t matching = 0;
+    for (size_t i = 0; i < MINHASH_SIZE; ++i) {
+        matching += a[i] == b[i];
+    }
+    return static_cast<double>(matching) / MINHASH_SIZE;
+}
+
+/**
+ * @brief Bounded, thread-safe index of clusters of similar signatures
+ *
+ * Each cluster keeps the signature of the text that started it, one value
+ * and a member count, and is identified by a nonzero hash of that
+ * signature. A signature belongs to the most similar cluster whose
+ * estimated similarity reaches the threshold. Signatures are split into
+ * bands of MINHASH_BAND_ROWS slots and lookups only compare against
+ * entries that agree on a whole band, which texts with a Jaccard
+ * similarity of 0.8 almost always do (1 - (1 - 0.8^4)^16 > 0.999) and
+ * unrelated texts almost never do. Beyond the capacity, the least
+ * recently matched cluster is dropped.
+ *
+ * @tparam Value Copyable value kept per cluster
+ */
+template <typename Value>
+class NearDuplicateIndex {
+public:
+    /**
+     * @brief Size of one cluster
+     */
+    struct Cluster {
+        uint64_t id;       ///< Cluster ID
+        uint64_t members;  ///< Texts assigned to the cluster
+    };
+
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of clusters (at least 1)
+     * @param threshold Smallest estimated similarity within a cluster (clamped to [0, 1])
+     */
+    NearDuplicateIndex(size_t capacity, double threshold)
+        : capacity(std::max<size_t>(1, capacity)), threshold(std::clamp(threshold, 0.0, 1.0)) {}
+
+    /**
+     * @brief Gets the ID of the cluster a signature starts
+     * @param signature Signature of the first text
+     * @return Nonzero hash of the signature
+     */
+    static uint64_t clusterId(const MinHashSignature& signature) {
+        uint64_t id = 0;
+        for (uint32_t value : signature) {
+            id = detail::mix64(id ^ value);
+        }
+        return id != 0 ? id : 1;
+    }
+
+    /**
+     * @brief Looks up the cluster of a signature and counts it as a member
+     * @param signature Signature to look up
+     * @param value Receives a copy of the cluster's value on a hit
+     * @param cluster Receives the cluster ID on a hit
+     * @return True if a similar enough cluster was found
+     */
+    bool find(const MinHashSignature& signature, Value& value, uint64_t& cluster) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = nearest(signature);
+        if (entry == entries.end()) {
+            return false;
+        }
+
+        ++entry->members;
+        entries.splice(entries.begin(), entries, entry);
+        value = entry->value;
+        cluster = entry->id;
+        return true;
+    }
+
+    /**
+     * @brief Adds texts as a new cluster, or to the most similar existing one
+     *
+     * Another thread may have started a similar cluster since the
+     * signature was looked up; the texts then join that cluster and its
+     * value is replaced.
+     *
+     * @param signature Signature of the texts
+     * @param value Value to keep for the cluster
+     * @param members Number of texts to count
+     * @return ID of the cluster the texts belong to
+     */
+    uint64_t insert(const MinHashSignature& signature, Value value, uint64_t members = 1) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto entry = nearest(signature);
+        if (entry != entries.end()) {
+            entry->value = std::move(value);
+            entry->members += members;
+            entries.splice(entries.begin(), entries, entry);
+            return entry->id;
+        }
+
+        if (entries.size() >= capacity) {
+            erase(std::prev(entries.end()));
+            ++evictions;
+        }
+
+        // IDs of distinct signatures practically never collide; if they do, the newer cluster answers addMembers()
+        uint64_t id = clusterId(signature);
+        entries.push_front(Entry{signature, id, std::move(value), members});
+        byId[id] = entries.begin();
+        for (size_t band = 0; band < BAND_COUNT; ++band) {
+            bands[band].emplace(bandKey(signature, band), entries.begin());
+        }
+        return id;
+    }
+
+    /**
+     * @brief Counts more texts as members of a cluster
+     * @param cluster Cluster ID (ignored if the cluster was dropped)
+     * @param members Number of texts to count
+     */
+    void addMembers(uint64_t cluster, uint64_t members) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = byId.find(cluster);
+        if (found != byId.end()) {
+            found->second->members += members;
+        }
+    }
+
+    /**
+     * @brief Replaces the value of a cluster and counts more texts as members
+     * @param cluster Cluster ID
+     * @param value New value for the cluster
+     * @param members Number of texts to count
+     * @return False if the cluster was dropped, leaving the index unchanged
+     */
+    bool update(uint64_t cluster, const Value& value, uint64_t members = 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = byId.find(cluster);
+        if (found == byId.end()) {
+            return false;
+        }
+
+        Iterator entry = found->second;
+        entry->value = value;
+        entry->members += members;
+        entries.splice(entries.begin(), entries, entry);
+        return true;
+    }
+
+    /**
+     * @brief Lists the largest clusters
+     * @param maxClusters Largest number of clusters to return
+     * @param minMembers Fewest members a listed cluster has
+     * @return Clusters, largest first
+     */
+    std::vector<Cluster> clusters(size_t maxClusters, uint64_t minMembers = 2) const {
+        std::vector<Cluster> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& entry : entries) {
+                if (entry.members >= minMembers) {
+                    result.push_back(Cluster{entry.id, entry.members});
+                }
+            }
+        }
+
+        auto larger = [](const Cluster& a, const Cluster& b) {
+            return a.members != b.members ? a.members > b.members : a.id < b.id;
+        };
+        size_t kept = std::min(maxClusters, result.size());
+        std::partial_sort(result.begin(), result.begin() + kept, result.end(), larger);
+        result.resize(kept);
+        return result;
+    }
+
+    /**
+     * @brief Counts the clusters held
+     * @return Number of clusters
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    /**
+     * @brief Gets the maximum number of clusters
+     * @return Capacity passed to the constructor
+     */
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the smallest similarity within a cluster
+     * @return Threshold after clamping
+     */
+    double getThreshold() const {
+        return threshold;
+    }
+
+    /// @brief Gets the number of clusters dropped to make room
+    uint64_t getEvictions() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return evictions;
+    }
+
+private:
+    /// Number of LSH bands
+    static constexpr size_t BAND_COUNT = MINHASH_SIZE / MINHASH_BAND_ROWS;
+
+    /**
+     * @brief One cluster
+     */
+    struct Entry {
+        MinHashSignature signature;  ///< Signature of the text that started the cluster
+        uint64_t id;                 ///< Cluster ID
+        Value value;                 ///< Value kept for the cluster
+        uint64_t members;            ///< Texts assigned to the cluster
+    };
+
+    using Iterator = typename std::list<Entry>::iterator;
+
+    /**
+     * @brief Hashes one band of a signature
+     * @param signature Signature
+     * @param band Band index
+     * @return Hash of the band's slots
+     */
+    static uint64_t bandKey(const MinHashSignature& signature, size_t band) {
+        uint64_t key = band;
+        for (size_t row = 0; row < MINHASH_BAND_ROWS; ++row) {
+            key = detail::mix64(key ^ signature[band * MINHASH_BAND_ROWS + row]);
+        }
+        return key;
+    }
+
+    /**
+     * @brief Finds the most similar cluster above the threshold; the mutex must be held
+     * @param signature Signature to match
+     * @return Most similar entry, or entries.end() if none is similar enough
+     */
+    Iterator nearest(const MinHashSignature& signature) {
+        Iterator best = entries.end();
+        double bestSimilarity = threshold;
+        for (size_t band = 0; band < BAND_COUNT && bestSimilarity < 1.0; ++band) {
+            auto [first, last] = bands[band].equal_range(bandKey(signature, band));
+            for (auto candidate = first; candidate != last; ++candidate) {
+                double candidateSimilarity = similarity(signature, candidate->second->signature);
+                if (candidateSimilarity > bestSimilarity ||
+                    (candidateSimilarity == bestSimilarity && best == entries.end())) {
+                    best = candidate->second;
+                    bestSimilarity = candidateSimilarity;
+                }
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Removes a cluster; the mutex must be held
+     * @param entry Cluster to remove
+     */
+    void erase(Iterator entry) {
+        for (size_t band = 0; band < BAND_COUNT; ++band) {
+            auto [first, last] = bands[band].equal_range(bandKey(entry->signature, band));
+            for (auto candidate = first; candidate != last; ++candidate) {
+                if (candidate->second == entry) {
+                    bands[band].erase(candidate);
+                    break;
+                }
+            }
+        }
+        auto found = byId.find(entry->id);
+        if (found != byId.end() && found->second == entry) {
+            byId.erase(found);
+        }
+        entries.erase(entry);
+    }
+
+    size_t capacity;                                                ///< Maximum number of clusters
+    double threshold;                                               ///< Smallest similarity within a cluster
+    mutable std::mutex mutex;                                       ///< Guards everything below
+    std::list<Entry> entries;                                       ///< Most recently matched first
+    std::unordered_map<uint64_t, Iterator> byId;                    ///< Cluster ID to entry
+    std::array<std::unordered_multimap<uint64_t, Iterator>, BAND_COUNT> bands; ///< Band hash to entries, one map per band
+    uint64_t evictions = 0;                                         ///< Clusters dropped for capacity
+};
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,39 @@
+/**
+ * @file parallel.hpp
+ * @brief Minimal data-parallel helpers shared by the library
+ * 
+ * This file provides a parallel loop used for batch scoring and other
+ * embarrassingly parallel work. It uses OpenMP when the build found it
+ * and falls back to a small std::thread pool otherwise.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Resolves a configured thread count to an actual worker count
+ * @param requested Requested number of threads (0 or negative = all hardware threads)
+ * @return Number of worker threads to use (at least 1)
+ */
+size_t resolveThreadCount(int requested);
+
+/**
+ * @brief Runs a function for every index in [0, count) across worker threads
+ * 
+ * Indices are handed out dynamically so uneven work items balance out.
+ * The first exception thrown by any call is rethrown on the calling
+ * thread after all workers have stopped.
+ * 
+ * @param count Number of work items
+ * @param threads Number of worker threads (1 runs inline)
+ * @param body Function invoked with each index
+ */
+void parallelFor(size_t count, size_t threads, const std::function<void(size_t)>& body);
+
+} // namespace utils
+} // namespace blahajpi
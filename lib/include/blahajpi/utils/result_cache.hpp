@@ -0,0 +1,218 @@
+/**
+ * @file result_cache.hpp
+ * @brief Bounded, thread-safe LRU cache keyed by text
+ *
+ * This file provides the cache the analyzer uses to answer repeated
+ * messages without scoring them again. Entries are spread over shards by
+ * a hash of the key, each shard has its own lock and LRU list, so
+ * concurrent lookups of different texts rarely contend.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Sharded LRU cache with optional time-to-live
+ *
+ * Keys are looked up by their std::hash and confirmed by comparing the
+ * stored key, so hash collisions cause a miss rather than a wrong value.
+ * Each shard holds at most ceil(capacity / shards) entries and evicts its
+ * least recently used entry when full, so eviction order is only exact
+ * within a shard. Entries older than the TTL are
+ * dropped when they are next looked up.
+ *
+ * @tparam Value Copyable cached value
+ */
+template <typename Value>
+class ResultCache {
+public:
+    using Clock = std::chrono::steady_clock;  ///< Clock used for TTL expiry
+
+    /// Shards used when the constructor is not given a count
+    static constexpr size_t DEFAULT_SHARDS = 16;
+
+    /// Fewest entries per shard; smaller caches use fewer shards so LRU order stays meaningful
+    static constexpr size_t MIN_SHARD_CAPACITY = 64;
+
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of entries (at least 1)
+     * @param ttl Lifetime of an entry (zero = entries do not expire)
+     * @param shards Largest number of independently locked shards
+     */
+    explicit ResultCache(size_t capacity, Clock::duration ttl = Clock::duration::zero(), size_t shards = DEFAULT_SHARDS)
+        : capacity(std::max<size_t>(1, capacity)),
+          ttl(ttl),
+          shardCount(std::clamp<size_t>(this->capacity / MIN_SHARD_CAPACITY, 1, std::max<size_t>(1, shards))),
+          shards(std::make_unique<Shard[]>(shardCount)) {
+        size_t perShard = (this->capacity + shardCount - 1) / shardCount;
+        for (size_t i = 0; i < shardCount; ++i) {
+            this->shards[i].capacity = perShard;
+        }
+    }
+
+    /**
+     * @brief Looks up a key and marks it as recently used
+     * @param key Key to look up
+     * @param value Receives a copy of the cached value on a hit
+     * @return True if the key was cached and has not expired
+     */
+    bool find(std::string_view key, Value& value) {
+        uint64_t hash = std::hash<std::string_view>{}(key);
+        Shard& shard = shardFor(hash);
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(hash);
+        if (found == shard.index.end() || found->second->key != key) {
+            return false;
+        }
+
+        auto entry = found->second;
+        if (ttl != Clock::duration::zero() && Clock::now() >= entry->expires) {
+            shard.index.erase(found);
+            shard.entries.erase(entry);
+            expirations.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+        value = entry->value;
+        return true;
+    }
+
+    /**
+     * @brief Adds or replaces an entry
+     *
+     * Evicts the shard's least recently used entry if the shard is full.
+     *
+     * @param key Key to store under
+     * @param value Value to cache
+     */
+    void insert(std::string_view key, Value value) {
+        uint64_t hash = std::hash<std::string_view>{}(key);
+        Shard& shard = shardFor(hash);
+        Clock::time_point expires = ttl != Clock::duration::zero() ? Clock::now() + ttl : Clock::time_point::max();
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(hash);
+        if (found != shard.index.end()) {
+            // Same key refreshes the entry; a colliding key takes over the slot
+            auto entry = found->second;
+            entry->key.assign(key);
+            entry->value = std::move(value);
+            entry->expires = expires;
+            shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+            return;
+        }
+
+        if (shard.entries.size() >= shard.capacity) {
+            shard.index.erase(shard.entries.back().hash);
+            shard.entries.pop_back();
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shard.entries.push_front(Entry{hash, std::string(key), std::move(value), expires});
+        shard.index.emplace(hash, shard.entries.begin());
+    }
+
+    /**
+     * @brief Removes every entry
+     */
+    void clear() {
+        for (size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            shards[i].entries.clear();
+            shards[i].index.clear();
+        }
+    }
+
+    /**
+     * @brief Counts the cached entries
+     * @return Entries across all shards (including expired ones not yet looked up)
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shardCount; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].entries.size();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Gets the maximum number of entries
+     * @return Capacity passed to the constructor
+     */
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the entry lifetime
+     * @return TTL (zero = entries do not expire)
+     */
+    Clock::duration getTtl() const {
+        return ttl;
+    }
+
+    /// @brief Gets the number of entries dropped to make room
+    uint64_t getEvictions() const { return evictions.load(std::memory_order_relaxed); }
+    /// @brief Gets the number of entries dropped because they expired
+    uint64_t getExpirations() const { return expirations.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief One cached key and value
+     */
+    struct Entry {
+        uint64_t hash;                ///< Hash of key
+        std::string key;              ///< Full key, compared on lookup
+        Value value;                  ///< Cached value
+        Clock::time_point expires;    ///< Time after which the entry is stale
+    };
+
+    /**
+     * @brief Independently locked part of the cache
+     */
+    struct Shard {
+        mutable std::mutex mutex;                                                ///< Guards the shard
+        std::list<Entry> entries;                                                ///< Most recently used first
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index; ///< Hash to entry
+        size_t capacity = 1;                                                     ///< Maximum entries in the shard
+    };
+
+    /**
+     * @brief Picks the shard for a hash
+     * @param hash Key hash
+     * @return Shard holding the key
+     */
+    Shard& shardFor(uint64_t hash) {
+        // The index uses the low bits, so shard on the high ones
+        return shards[(hash >> 32) % shardCount];
+    }
+
+    size_t capacity;                      ///< Maximum number of entries
+    Clock::duration ttl;                  ///< Entry lifetime (zero = no expiry)
+    size_t shardCount;                    ///< Number of shards
+    std::unique_ptr<Shard[]> shards;      ///< Shards of the cache
+    std::atomic<uint64_t> evictions{0};   ///< Entries dropped for capacity
+    std::atomic<uint64_t> expirations{0}; ///< Entries dropped for age
+};
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,91 @@
+/**
+ * @file scratch_arena.hpp
+ * @brief Per-thread monotonic arena for short-lived intermediates
+ *
+ * Scoring a chunk of texts builds cleaned texts, index lists, scores and
+ * key-term lists that are all dropped when the chunk is done. This file
+ * provides an arena that backs such std::pmr containers with a block the
+ * calling thread keeps between uses, so they cost neither calls into the
+ * global allocator nor its lock contention, and are released in one step.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Monotonic arena over a block reused by the calling thread
+ *
+ * Everything allocated through resource() is freed together when the
+ * arena is destroyed. The first arena alive on a thread is backed by that
+ * thread's block; when it needs more, the overflow comes from the global
+ * allocator and the block grows to cover it for the next arena, up to
+ * MAX_BLOCK_BYTES, so steady-state work stays inside the block. An arena
+ * created while another one is alive on the same thread uses the global
+ * allocator for everything, but still frees it in one step.
+ *
+ * An arena must be destroyed on the thread that created it.
+ */
+class ScratchArena {
+public:
+    /// Size of a thread's block before any arena has outgrown it
+    static constexpr size_t INITIAL_BLOCK_BYTES = 64 * 1024;
+
+    /// Largest block a thread keeps between arenas
+    static constexpr size_t MAX_BLOCK_BYTES = 16 * 1024 * 1024;
+
+    /**
+     * @brief Constructor
+     */
+    ScratchArena();
+
+    /**
+     * @brief Destructor; frees everything and grows the block if it overflowed
+     */
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Gets the memory resource to build containers with
+     * @return Arena resource, valid until the arena is destroyed
+     */
+    std::pmr::memory_resource* resource() { return &arena; }
+
+    /**
+     * @brief Gets the bytes requested from the global allocator so far
+     * @return Overflow beyond the thread's block
+     */
+    size_t overflowBytes() const { return upstream.bytes; }
+
+private:
+    /**
+     * @brief Forwards to the global allocator and counts the bytes taken
+     */
+    struct CountingResource : std::pmr::memory_resource {
+        size_t bytes = 0;  ///< Bytes allocated so far
+
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    /**
+     * @brief Claims the thread's block if no other arena holds it
+     * @return Block memory, or an empty span
+     */
+    static std::span<std::byte> claimBlock();
+
+    std::span<std::byte> block;   ///< The thread's block while this arena holds it
+    CountingResource upstream;    ///< Source of memory beyond the block
+    std::pmr::monotonic_buffer_resource arena;  ///< Resource handed out to containers
+};
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,412 @@
+/**
+ * @file static_lexicon.hpp
+ * @brief Compile-time perfect-hash word tables
+ *
+ * This file provides the tables behind the built-in word lists (stopwords,
+ * negations, abbreviations and the word cloud categories). The tables are
+ * built by the compiler, live in read-only data and are looked up by
+ * std::string_view with one hash and at most one string comparison, so
+ * neither construction nor lookup allocates.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Hashes a key for the lexicon tables
+ *
+ * 64-bit FNV-1a followed by the splitmix64 finalizer, so that every bit of
+ * the result depends on every byte of the key.
+ *
+ * @param key Key to hash
+ * @return Well-mixed 64-bit hash
+ */
+constexpr uint64_t lexiconHash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * @brief Read-only view of a StaticLexicon that does not depend on its size
+ *
+ * A key is assigned to a bucket by its hash, and each bucket stores the
+ * displacement that places all of its keys in distinct slots. A lookup
+ * therefore probes exactly one slot.
+ */
+class LexiconView {
+public:
+    /// Marks a slot that holds no key
+    static constexpr uint16_t EMPTY_SLOT = 0xFFFF;
+
+    /**
+     * @brief Constructs an empty view that contains nothing
+     */
+    constexpr LexiconView() = default;
+
+    /**
+     * @brief Constructor
+     * @param keys Distinct keys
+     * @param values Value of each key
+     * @param slots Key index per slot (power-of-two size), EMPTY_SLOT if free
+     * @param displacements Displacement per bucket (power-of-two size)
+     */
+    constexpr LexiconView(
+        std::span<const std::string_view> keys,
+        std::span<const std::string_view> values,
+        std::span<const uint16_t> slots,
+        std::span<const uint16_t> displacements
+    ) : keys(keys), values(values), slots(slots), displacements(displacements) {
+    }
+
+    /**
+     * @brief Gets the slot a key occupies for a given displacement
+     * @param hash Hash of the key from lexiconHash()
+     * @param displacement Displacement of the key's bucket
+     * @param slotMask Number of slots minus one
+     * @return Slot index
+     */
+    static constexpr size_t slotFor(uint64_t hash, uint64_t displacement, size_t slotMask) {
+        // Remix per displacement, so keys that collide for one displacement
+        // are independent for the next
+        uint64_t mixed = hash ^ (displacement * 0x9e3779b97f4a7c15ULL);
+        mixed = (mixed ^ (mixed >> 32)) * 0xd6e8feb86659fd93ULL;
+        return static_cast<size_t>((mixed ^ (mixed >> 32)) & slotMask);
+    }
+
+    /**
+     * @brief Gets the bucket of a key
+     * @param hash Hash of the key from lexiconHash()
+     * @param bucketMask Number of buckets minus one
+     * @return Bucket index
+     */
+    static constexpr size_t bucketFor(uint64_t hash, size_t bucketMask) {
+        return static_cast<size_t>(hash >> 48) & bucketMask;
+    }
+
+    /**
+     * @brief Looks up a key
+     * @param key Key to look up
+     * @return Pointer to the key's value, or nullptr if it is not present
+     */
+    constexpr const std::string_view* find(std::string_view key) const {
+        if (keys.empty()) {
+            return nullptr;
+        }
+
+        uint64_t hash = lexiconHash(key);
+        uint16_t displacement = displacements[bucketFor(hash, displacements.size() - 1)];
+        uint16_t index = slots[slotFor(hash, displacement, slots.size() - 1)];
+        if (index == EMPTY_SLOT || keys[index] != key) {
+            return nullptr;
+        }
+        return &values[index];
+    }
+
+    /**
+     * @brief Checks whether a key is present
+     * @param key Key to look up
+     * @return True if the key is present
+     */
+    constexpr bool contains(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * @brief Gets the number of distinct keys
+     * @return Number of keys
+     */
+    constexpr size_t size() const {
+        return keys.size();
+    }
+
+    /**
+     * @brief Gets the distinct keys in their original order
+     * @return Keys
+     */
+    constexpr std::span<const std::string_view> getKeys() const {
+        return keys;
+    }
+
+private:
+    std::span<const std::string_view> keys;        ///< Distinct keys
+    std::span<const std::string_view> values;      ///< Value per key
+    std::span<const uint16_t> slots;               ///< Key index per slot
+    std::span<const uint16_t> displacements;       ///< Displacement per bucket
+};
+
+/**
+ * @brief Perfect-hash table of up to N string keys built at compile time
+ *
+ * Duplicate keys are dropped, keeping the first, like constructing a
+ * std::unordered_map from an initializer list. The table has at least
+ * twice as many slots as keys, which keeps the displacement search short;
+ * a key set for which no displacement is found fails to compile.
+ *
+ * @tparam N Number of entries the table is built from
+ */
+template <size_t N>
+class StaticLexicon {
+public:
+    static_assert(N > 0 && N < LexiconView::EMPTY_SLOT, "lexicon size out of range");
+
+    /// Number of slots, a power of two
+    static constexpr size_t SLOT_COUNT = std::bit_ceil(2 * N);
+
+    /// Number of buckets, a power of two averaging about two keys each
+    static constexpr size_t BUCKET_COUNT = std::bit_ceil((N + 1) / 2);
+
+    /// Largest displacement tried for a bucket
+    static constexpr size_t MAX_DISPLACEMENT = LexiconView::EMPTY_SLOT;
+
+    /**
+     * @brief Builds the table
+     * @param entries Key and value of each entry
+     */
+    consteval explicit StaticLexicon(const std::array<std::pair<std::string_view, std::string_view>, N>& entries) {
+        // Keep the first occurrence of each key
+        for (const auto& [key, value] : entries) {
+            bool duplicate = false;
+            for (size_t i = 0; i < count; ++i) {
+                duplicate = duplicate || keys[i] == key;
+            }
+            if (!duplicate) {
+                keys[count] = key;
+                values[count] = value;
+                hashes[count] = lexiconHash(key);
+                ++count;
+            }
+        }
+
+        slots.fill(LexiconView::EMPTY_SLOT);
+        displacements.fill(0);
+
+        // Place the largest buckets first, while most slots are still free
+        std::array<size_t, BUCKET_COUNT> bucketSizes{};
+        size_t largestBucket = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t size = ++bucketSizes[LexiconView::bucketFor(hashes[i], BUCKET_COUNT - 1)];
+            largestBucket = size > largestBucket ? size : largestBucket;
+        }
+
+        for (size_t size = largestBucket; size > 0; --size) {
+            for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+                if (bucketSizes[bucket] == size) {
+                    placeBucket(bucket);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets a size-independent view of the table
+     * @return View over this table, valid while the table exists
+     */
+    constexpr LexiconView view() const {
+        return LexiconView(
+            std::span<const std::string_view>(keys.data(), count),
+            std::span<const std::string_view>(values.data(), count),
+            slots,
+            displacements
+        );
+    }
+
+    /**
+     * @brief Looks up a key
+     * @param key Key to look up
+     * @return Pointer to the key's value, or nullptr if it is not present
+     */
+    constexpr const std::string_view* find(std::string_view key) const {
+        return view().find(key);
+    }
+
+    /**
+     * @brief Checks whether a key is present
+     * @param key Key to look up
+     * @return True if the key is present
+     */
+    constexpr bool contains(std::string_view key) const {
+        return view().contains(key);
+    }
+
+    /**
+     * @brief Gets the number of distinct keys
+     * @return Number of keys
+     */
+    constexpr size_t size() const {
+        return count;
+    }
+
+private:
+    /**
+     * @brief Finds a displacement that puts every key of a bucket in a free slot
+     * @param bucket Bucket to place
+     */
+    consteval void placeBucket(size_t bucket) {
+        std::array<size_t, N> members{};
+        size_t memberCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (LexiconView::bucketFor(hashes[i], BUCKET_COUNT - 1) == bucket) {
+                members[memberCount++] = i;
+            }
+        }
+
+        for (size_t displacement = 0; displacement < MAX_DISPLACEMENT; ++displacement) {
+            bool fits = true;
+            for (size_t m = 0; m < memberCount && fits; ++m) {
+                size_t slot = LexiconView::slotFor(hashes[members[m]], displacement, SLOT_COUNT - 1);
+                fits = slots[slot] == LexiconView::EMPTY_SLOT;
+                // Keys of the same bucket must not share a slot either
+                for (size_t other = 0; other < m && fits; ++other) {
+                    fits = slot != LexiconView::slotFor(hashes[members[other]], displacement, SLOT_COUNT - 1);
+                }
+            }
+
+            if (fits) {
+                for (size_t m = 0; m < memberCount; ++m) {
+                    size_t slot = LexiconView::slotFor(hashes[members[m]], displacement, SLOT_COUNT - 1);
+                    slots[slot] = static_cast<uint16_t>(members[m]);
+                }
+                displacements[bucket] = static_cast<uint16_t>(displacement);
+                return;
+            }
+        }
+
+        // Not a constant expression, so reaching this fails the build
+        throw "no perfect-hash displacement found for lexicon bucket";
+    }
+
+    std::array<std::string_view, N> keys{};                ///< Distinct keys, then unused entries
+    std::array<std::string_view, N> values{};              ///< Value per key
+    std::array<uint64_t, N> hashes{};                      ///< lexiconHash() per key
+    std::array<uint16_t, SLOT_COUNT> slots{};              ///< Key index per slot
+    std::array<uint16_t, BUCKET_COUNT> displacements{};    ///< Displacement per bucket
+    size_t count = 0;                                      ///< Number of distinct keys
+};
+
+/**
+ * @brief Builds a compile-time word set
+ *
+ * Used to initialize a constexpr variable; every value is empty.
+ *
+ * @param words Words of the set, duplicates allowed
+ * @return Perfect-hash table of the words
+ */
+template <size_t N>
+consteval StaticLexicon<N> makeWordSet(const std::string_view (&words)[N]) {
+    std::array<std::pair<std::string_view, std::string_view>, N> entries{};
+    for (size_t i = 0; i < N; ++i) {
+        entries[i].first = words[i];
+    }
+    return StaticLexicon<N>(entries);
+}
+
+/**
+ * @brief Builds a compile-time word map
+ *
+ * Used to initialize a constexpr variable.
+ *
+ * @param entries Key and value of each entry, duplicate keys allowed
+ * @return Perfect-hash table of the entries
+ */
+template <size_t N>
+consteval StaticLexicon<N> makeWordMap(const std::pair<std::string_view, std::string_view> (&entries)[N]) {
+    std::array<std::pair<std::string_view, std::string_view>, N> copy{};
+    for (size_t i = 0; i < N; ++i) {
+        copy[i] = entries[i];
+    }
+    return StaticLexicon<N>(copy);
+}
+
+/**
+ * @brief Word set made of an optional built-in lexicon and runtime additions
+ *
+ * Membership tests take a std::string_view and do not allocate. Words
+ * added at runtime go to a small overlay set that is only consulted when
+ * it is not empty.
+ */
+class WordList {
+public:
+    /**
+     * @brief Constructs an empty list
+     */
+    WordList() = default;
+
+    /**
+     * @brief Constructs a list backed by a built-in lexicon
+     * @param builtin View of a lexicon with static storage duration
+     */
+    explicit WordList(LexiconView builtin) : builtin(builtin) {
+    }
+
+    /**
+     * @brief Constructs a list from runtime words only
+     * @param words Words of the list
+     */
+    explicit WordList(const std::unordered_set<std::string>& words)
+        : overlay(words.begin(), words.end()) {
+    }
+
+    /**
+     * @brief Checks whether a word is in the list
+     * @param word Word to look up
+     * @return True if the word is built in or was added
+     */
+    bool contains(std::string_view word) const {
+        return builtin.contains(word) || (!overlay.empty() && overlay.find(word) != overlay.end());
+    }
+
+    /**
+     * @brief Adds a word to the list
+     * @param word Word to add
+     */
+    void insert(std::string_view word) {
+        if (!builtin.contains(word)) {
+            overlay.emplace(word);
+        }
+    }
+
+    /**
+     * @brief Gets the number of words in the list
+     * @return Number of words
+     */
+    size_t size() const {
+        return builtin.size() + overlay.size();
+    }
+
+private:
+    /**
+     * @brief Hash that lets the overlay be searched with a std::string_view
+     */
+    struct OverlayHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view word) const noexcept {
+            return std::hash<std::string_view>{}(word);
+        }
+    };
+
+    LexiconView builtin;                                                    ///< Built-in words
+    std::unordered_set<std::string, OverlayHash, std::equal_to<>> overlay;  ///< Words added at runtime
+};
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,264 @@
+/**
+ * @file stats.hpp
+ * @brief Low-overhead latency and throughput counters for the analyzer
+ *
+ * This file provides the counters the analyzer updates while it works and
+ * the snapshot it hands out through Analyzer::getStats(). Counters are
+ * relaxed atomics updated once per chunk of texts, so recording does not
+ * serialize the worker threads. Building with ENABLE_STATS=OFF removes
+ * every recording call from the analyzer; snapshots then report
+ * enabled = false and zero counts.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Stages of analyzing one document
+ */
+enum class Stage {
+    Preprocess,       ///< Text cleaning
+    NearDuplicates,   ///< Near-duplicate signatures and cluster lookup
+    Vectorize,        ///< Feature extraction (part of Score when scoring is fused)
+    Cascade,          ///< First-stage model evaluation of a model cascade
+    Score,            ///< Model evaluation
+    KeyTerms,         ///< Key term extraction
+    Explanation       ///< Explanation text
+};
+
+/// Number of values in Stage
+constexpr size_t STAGE_COUNT = 7;
+
+/// Upper bounds of the latency histogram buckets in nanoseconds (1-2.5-5 steps from 1us to 2.5s)
+constexpr std::array<uint64_t, 20> LATENCY_BUCKETS = {
+    1'000, 2'500, 5'000, 10'000, 25'000, 50'000, 100'000, 250'000, 500'000,
+    1'000'000, 2'500'000, 5'000'000, 10'000'000, 25'000'000, 50'000'000,
+    100'000'000, 250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000
+};
+
+/**
+ * @brief Gets the metric name of a stage
+ * @param stage Stage
+ * @return Lowercase name such as "preprocess" or "key_terms"
+ */
+const char* stageName(Stage stage);
+
+/**
+ * @brief Per-document latency distribution of one stage
+ */
+struct StageStats {
+    uint64_t documents = 0;   ///< Documents that went through the stage
+    uint64_t totalNanos = 0;  ///< Time spent in the stage
+    uint64_t maxNanos = 0;    ///< Slowest recorded per-document time
+    std::array<uint64_t, LATENCY_BUCKETS.size() + 1> buckets{}; ///< Documents per bucket (last = overflow)
+
+    /**
+     * @brief Gets the mean time per document
+     * @return Mean time in microseconds (0 if nothing was recorded)
+     */
+    double meanMicros() const;
+
+    /**
+     * @brief Estimates a latency percentile from the histogram
+     * @param quantile Quantile in [0, 1], e.g. 0.99
+     * @return Upper bound of the bucket holding the quantile, in microseconds
+     */
+    double percentileMicros(double quantile) const;
+};
+
+/**
+ * @brief Point-in-time copy of the analyzer counters
+ */
+struct AnalyzerStats {
+    bool enabled = false;             ///< Whether the library was built with instrumentation
+    double uptimeSeconds = 0.0;       ///< Time since the counters were created or reset
+    uint64_t documents = 0;           ///< Documents analyzed
+    uint64_t bytes = 0;               ///< Bytes of input text analyzed
+    uint64_t termsSeen = 0;           ///< Terms looked up during fused scoring
+    uint64_t termsMatched = 0;        ///< Looked-up terms found in the vocabulary
+    uint64_t cacheHits = 0;           ///< Documents answered from the result cache
+    uint64_t cacheMisses = 0;         ///< Result cache lookups that had to be scored
+    uint64_t cacheEntries = 0;        ///< Results currently cached
+    uint64_t cascadeChecked = 0;      ///< Documents scored by the first stage of a cascade
+    uint64_t cascadeExits = 0;        ///< Documents answered by the first stage
+    uint64_t nearDuplicatesChecked = 0; ///< Documents looked up in the near-duplicate index
+    uint64_t nearDuplicatesReused = 0;  ///< Documents answered with the result of a near duplicate
+    uint64_t modelLoads = 0;          ///< Successful model loads
+    double modelLoadSeconds = 0.0;    ///< Duration of the most recent model load
+    std::array<StageStats, STAGE_COUNT> stages{}; ///< Indexed by Stage
+
+    /**
+     * @brief Gets the statistics of one stage
+     * @param stage Stage
+     * @return Stage statistics
+     */
+    const StageStats& stage(Stage stage) const;
+
+    /**
+     * @brief Gets the average throughput since the counters were reset
+     * @return Documents per second of uptime
+     */
+    double documentsPerSecond() const;
+
+    /**
+     * @brief Gets the fraction of looked-up terms present in the vocabulary
+     * @return Hit rate in [0, 1] (0 if no terms were looked up)
+     */
+    double vocabularyHitRate() const;
+
+    /**
+     * @brief Gets the fraction of result cache lookups that hit
+     * @return Hit rate in [0, 1] (0 if the cache was not used)
+     */
+    double cacheHitRate() const;
+
+    /**
+     * @brief Gets the fraction of first-stage documents that exited early
+     * @return Exit rate in [0, 1] (0 if no cascade ran); the rest went to the full model
+     */
+    double cascadeExitRate() const;
+
+    /**
+     * @brief Gets the fraction of near-duplicate lookups answered without scoring
+     * @return Reuse rate in [0, 1] (0 if the stage is off)
+     */
+    double nearDuplicateReuseRate() const;
+
+    /**
+     * @brief Formats the statistics as a JSON object
+     * @return JSON text
+     */
+    std::string toJson() const;
+
+    /**
+     * @brief Formats the statistics in the Prometheus text exposition format
+     * @return Metrics text with "blahajpi_" prefixed names
+     */
+    std::string toPrometheus() const;
+};
+
+/**
+ * @brief Thread-safe counters behind AnalyzerStats
+ */
+class StatsRecorder {
+public:
+    /**
+     * @brief Creates zeroed counters and starts the uptime clock
+     */
+    StatsRecorder();
+
+    /**
+     * @brief Records time spent in a stage for a group of documents
+     *
+     * Each document is counted in the histogram bucket of the group's
+     * average time.
+     *
+     * @param stage Stage
+     * @param nanos Time spent on the whole group
+     * @param documents Number of documents in the group
+     */
+    void recordStage(Stage stage, uint64_t nanos, uint64_t documents);
+
+    /**
+     * @brief Records analyzed documents
+     * @param documents Number of documents
+     * @param bytes Total size of their text
+     */
+    void recordDocuments(uint64_t documents, uint64_t bytes);
+
+    /**
+     * @brief Records vocabulary lookups
+     * @param seen Terms looked up
+     * @param matched Terms found in the vocabulary
+     */
+    void recordTerms(uint64_t seen, uint64_t matched);
+
+    /**
+     * @brief Records result cache lookups
+     * @param hits Lookups answered from the cache
+     * @param misses Lookups that had to be scored
+     */
+    void recordCache(uint64_t hits, uint64_t misses);
+
+    /**
+     * @brief Records first-stage decisions of a model cascade
+     * @param checked Documents the first stage scored
+     * @param exits Documents it answered without the full model
+     */
+    void recordCascade(uint64_t checked, uint64_t exits);
+
+    /**
+     * @brief Records near-duplicate lookups
+     * @param checked Documents looked up
+     * @param reused Documents that reused the result of a near duplicate
+     */
+    void recordNearDuplicates(uint64_t checked, uint64_t reused);
+
+    /**
+     * @brief Records a successful model load
+     * @param nanos Time the load took
+     */
+    void recordModelLoad(uint64_t nanos);
+
+    /**
+     * @brief Copies the current counters
+     *
+     * Counters are read one at a time, so a snapshot taken while other
+     * threads record may be off by the work of a few in-flight chunks.
+     *
+     * @param enabled Value reported as AnalyzerStats::enabled
+     * @return Snapshot
+     */
+    AnalyzerStats snapshot(bool enabled) const;
+
+    /**
+     * @brief Zeroes the document, term and stage counters and restarts the uptime clock
+     *
+     * Model load counters describe the loaded model rather than a time
+     * window, so they are kept.
+     */
+    void reset();
+
+    /**
+     * @brief Reads the monotonic clock used for all timings
+     * @return Nanoseconds since an arbitrary epoch
+     */
+    static uint64_t now();
+
+private:
+    /**
+     * @brief Counters of one stage
+     */
+    struct StageCounters {
+        std::atomic<uint64_t> documents{0};   ///< Documents recorded
+        std::atomic<uint64_t> totalNanos{0};  ///< Summed group times
+        std::atomic<uint64_t> maxNanos{0};    ///< Largest per-document time
+        std::array<std::atomic<uint64_t>, LATENCY_BUCKETS.size() + 1> buckets{}; ///< Documents per bucket
+    };
+
+    std::array<StageCounters, STAGE_COUNT> stages;   ///< Indexed by Stage
+    std::atomic<uint64_t> documents{0};              ///< Documents analyzed
+    std::atomic<uint64_t> bytes{0};                  ///< Bytes of input text
+    std::atomic<uint64_t> termsSeen{0};              ///< Vocabulary lookups
+    std::atomic<uint64_t> termsMatched{0};           ///< Vocabulary hits
+    std::atomic<uint64_t> cacheHits{0};              ///< Result cache hits
+    std::atomic<uint64_t> cacheMisses{0};            ///< Result cache misses
+    std::atomic<uint64_t> cascadeChecked{0};         ///< First-stage documents
+    std::atomic<uint64_t> cascadeExits{0};           ///< First-stage early exits
+    std::atomic<uint64_t> nearDuplicatesChecked{0};  ///< Near-duplicate lookups
+    std::atomic<uint64_t> nearDuplicatesReused{0};   ///< Results reused from near duplicates
+    std::atomic<uint64_t> modelLoads{0};             ///< Successful model loads
+    std::atomic<uint64_t> lastModelLoadNanos{0};     ///< Duration of the latest load
+    std::atomic<uint64_t> startNanos{0};             ///< Clock reading at creation or reset
+};
+
+} // namespace utils
+} // namespace blahajpi
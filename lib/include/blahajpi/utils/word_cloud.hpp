@@ -1,13 +1,20 @@
 /**
  * @file word_cloud.hpp
  * @brief ASCII art word cloud generator for text visualization
+ *
+ * Word frequencies are gathered in WordCounter tables, either in one call
+ * over a set of texts or incrementally through a CloudAggregator that is
+ * fed analysis results while a batch or stream is still running.
  */
 
 #pragma once
 
 #include "blahajpi/analyzer.hpp"
+#include "blahajpi/utils/static_lexicon.hpp"
+#include "blahajpi/utils/word_counter.hpp"
+#include <mutex>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include <unordered_set>
 #include <span>
@@ -54,6 +61,40 @@ public:
         bool isHarmful = true
     );
 
+    /**
+     * @brief Generates a customized word cloud from counted words
+     */
+    std::string generateCustomCloud(
+        const WordCounter& counter,
+        const CloudConfig& config,
+        bool isHarmful = true
+    );
+
+    /**
+     * @brief Adds the weighted words of one text to a counter
+     *
+     * Words shorter than three characters and common words are skipped;
+     * harmful words weigh 3 and safe words 2.
+     */
+    void countWords(std::string_view text, WordCounter& counter) const;
+
+    /**
+     * @brief Counts the weighted words of many texts
+     *
+     * Large inputs are split into contiguous shards counted on separate
+     * threads and merged.
+     *
+     * @param texts Texts to count
+     * @param threads Worker threads (1 counts inline)
+     * @param capacity Entries kept per counter (0 = exact counts)
+     * @return Word counts
+     */
+    WordCounter countWords(
+        std::span<const std::string> texts,
+        size_t threads = 1,
+        size_t capacity = 0
+    ) const;
+
     /**
      * @brief Displays a word cloud directly to the console
      */
@@ -74,28 +115,13 @@ public:
     );
 
 private:
-    /**
-     * @brief Counts word frequencies in a collection of texts
-     */
-    std::unordered_map<std::string, int> countWordFrequencies(
-        std::span<const std::string> texts
-    );
-
-    /**
-     * @brief Gets the most frequent words
-     */
-    std::vector<std::pair<std::string, int>> getTopWords(
-        const std::unordered_map<std::string, int>& wordFreqs, 
-        size_t maxWords
-    );
-
     /**
      * @brief Formats a word for display in the word cloud
      */
     std::string formatWord(
         const std::string& word, 
-        int freq, 
-        int maxFreq,
+        int64_t freq, 
+        int64_t maxFreq,
         bool isHarmful
     );
 
@@ -103,8 +129,8 @@ private:
      * @brief Gets ANSI color code based on frequency and sentiment
      */
     std::string getColorCode(
-        int freq, 
-        int maxFreq, 
+        int64_t freq, 
+        int64_t maxFreq, 
         bool isHarmful, 
         const std::string& word = ""
     ) const;
@@ -114,9 +140,79 @@ private:
      */
     static std::string resetColor();
     
-    std::unordered_set<std::string> commonWords;  ///< Common words to filter out
-    std::unordered_set<std::string> harmfulWords; ///< Words indicating harmful content
-    std::unordered_set<std::string> safeWords;    ///< Words indicating safe content
+    WordList commonWords;  ///< Common words to filter out
+    WordList harmfulWords; ///< Words indicating harmful content
+    WordList safeWords;    ///< Words indicating safe content
+};
+
+/**
+ * @brief Word cloud counts fed with analysis results as they arrive
+ *
+ * Each call counts its results into a private counter, in parallel shards
+ * for large batches, and only takes the lock to merge it, so several
+ * producer threads can feed one aggregator. With a capacity the counts
+ * stay within a fixed amount of memory however many results arrive.
+ * Results must hold their cleaned text (AnalysisResult::CLEANED_TEXT).
+ */
+class CloudAggregator {
+public:
+    /**
+     * @brief Constructor
+     * @param harmfulOnly Whether to count only results labeled harmful
+     * @param capacity Words kept (0 = exact counts of every word)
+     * @param threads Worker threads for large batches
+     * @param cloud Word lists and rendering to use
+     */
+    explicit CloudAggregator(
+        bool harmfulOnly = true,
+        size_t capacity = 0,
+        size_t threads = 1,
+        WordCloud cloud = WordCloud()
+    );
+
+    /**
+     * @brief Counts one result
+     * @param result Analysis result
+     */
+    void add(const AnalysisResult& result);
+
+    /**
+     * @brief Counts a batch of results
+     * @param results Analysis results
+     */
+    void add(std::span<const AnalysisResult> results);
+
+    /**
+     * @brief Gets the number of results counted so far
+     * @return Number of counted texts
+     */
+    size_t getTextCount() const;
+
+    /**
+     * @brief Gets a copy of the current counts
+     * @return Word counts
+     */
+    WordCounter getCounts() const;
+
+    /**
+     * @brief Renders the current counts
+     * @param config Cloud settings
+     * @return Rendered cloud
+     */
+    std::string render(const CloudConfig& config);
+
+    /**
+     * @brief Forgets everything counted so far
+     */
+    void clear();
+
+private:
+    WordCloud cloud;            ///< Word lists and rendering
+    bool harmfulOnly;           ///< Whether safe results are skipped
+    size_t threads;             ///< Worker threads for large batches
+    mutable std::mutex mutex;   ///< Guards counts and textCount
+    WordCounter counts;         ///< Merged counts
+    size_t textCount = 0;       ///< Results counted
 };
 
 } // namespace utils
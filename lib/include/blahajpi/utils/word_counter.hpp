@@ -0,0 +1,123 @@
+/**
+ * @file word_counter.hpp
+ * @brief Mergeable word frequency table with an optional memory bound
+ *
+ * This file provides the counts behind word clouds. Counters are cheap to
+ * fill on one thread and to merge, so large inputs are counted in shards
+ * and combined. A bounded counter keeps a fixed number of entries and
+ * only tracks the heavy hitters, which lets a cloud cover a stream of any
+ * length.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+/**
+ * @brief Weighted word counts, exact or limited to the heaviest words
+ *
+ * An unbounded counter keeps every word. A bounded counter runs the
+ * Misra-Gries frequent-items summary: once it holds twice its capacity,
+ * the (capacity + 1)-th largest count is subtracted from every entry and
+ * entries that reach zero are dropped. A word's count is then low by at
+ * most total() / (capacity + 1), so every word above that share of the
+ * total weight is kept. Merging two bounded summaries keeps the same
+ * guarantee.
+ */
+class WordCounter {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Entries a bounded counter keeps (0 = count every word exactly)
+     */
+    explicit WordCounter(size_t capacity = 0);
+
+    /**
+     * @brief Adds weight to a word
+     * @param word Word to count
+     * @param weight Weight to add (ignored unless positive)
+     */
+    void add(std::string_view word, int64_t weight = 1);
+
+    /**
+     * @brief Adds the counts of another counter
+     * @param other Counter to fold in (its capacity is ignored)
+     */
+    void merge(const WordCounter& other);
+
+    /**
+     * @brief Gets the heaviest words
+     *
+     * Selects the words with a partial sort, so the cost grows with the
+     * number of entries rather than their full sort. Ties are ordered by
+     * word so the result does not depend on hash order.
+     *
+     * @param maxWords Largest number of words to return
+     * @return Words and counts, heaviest first
+     */
+    std::vector<std::pair<std::string, int64_t>> top(size_t maxWords) const;
+
+    /**
+     * @brief Gets the count of a word
+     * @param word Word to look up
+     * @return Count (a lower bound for a bounded counter; 0 if not held)
+     */
+    int64_t count(std::string_view word) const;
+
+    /**
+     * @brief Gets the weight added so far, including weight pruned away
+     * @return Total weight
+     */
+    int64_t total() const { return totalWeight; }
+
+    /**
+     * @brief Gets the number of words held
+     * @return Number of entries
+     */
+    size_t size() const { return counts.size(); }
+
+    /**
+     * @brief Gets the entry limit
+     * @return Capacity (0 = unbounded)
+     */
+    size_t getCapacity() const { return capacity; }
+
+    /**
+     * @brief Removes every word
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Hash that lets the table be searched with a std::string_view
+     */
+    struct WordHash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view word) const noexcept {
+            return std::hash<std::string_view>{}(word);
+        }
+    };
+
+    /**
+     * @brief Shrinks a bounded counter once it holds twice its capacity
+     */
+    void prune();
+
+    size_t capacity;          ///< Entries kept after pruning (0 = unbounded)
+    int64_t totalWeight = 0;  ///< Weight added so far
+    std::unordered_map<std::string, int64_t, WordHash, std::equal_to<>> counts;  ///< Count per word
+};
+
+} // namespace utils
+} // namespace blahajpi
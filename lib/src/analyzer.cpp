@@ -12,20 +12,341 @@
 #include "blahajpi/analyzer.hpp"
 #include "blahajpi/config.hpp"
 #include "blahajpi/models/sgd.hpp"
+#include "blahajpi/models/neural_network.hpp"
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/models/mlp_model.hpp"
+#include "blahajpi/models/linear_scorer.hpp"
 #include "blahajpi/preprocessing/text_processor.hpp"
 #include "blahajpi/preprocessing/vectorizer.hpp"
+#include "blahajpi/preprocessing/feature_cache.hpp"
+#include "blahajpi/preprocessing/tokenizer.hpp"
 #include "blahajpi/utils/dataset.hpp"
+#include "blahajpi/utils/dataset_reader.hpp"
 #include "blahajpi/utils/word_cloud.hpp"
+#include "blahajpi/utils/parallel.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include "blahajpi/utils/near_duplicate_index.hpp"
+#include "blahajpi/utils/result_cache.hpp"
+#include "blahajpi/utils/scratch_arena.hpp"
 #include "blahajpi/evaluation/metrics.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// Instrumentation is on unless the build passes BLAHAJPI_ENABLE_STATS=0
+#ifndef BLAHAJPI_ENABLE_STATS
+#define BLAHAJPI_ENABLE_STATS 1
+#endif
 
 namespace blahajpi {
 
+namespace {
+
+/// Whether analysis records latency and throughput counters
+constexpr bool STATS_ENABLED = BLAHAJPI_ENABLE_STATS != 0;
+
+/// Mini-batch size used for multi-threaded training when batch-size is 0
+constexpr size_t DEFAULT_TRAIN_BATCH_SIZE = 512;
+
+/// Key terms reported per analyzed text
+constexpr size_t MAX_KEY_TERMS = 5;
+
+/// Fewest words a text needs to join a near-duplicate cluster (shorter texts are scored on their own)
+constexpr size_t MIN_NEAR_DUPLICATE_WORDS = 5;
+
+/// Settings that change the cleaned texts, the split or the features, and so key the feature cache
+constexpr const char* FEATURE_CACHE_SETTINGS[] = {
+    "label-column", "text-column", "preprocessing-pipeline", "vectorizer", "use-sublinear-tf",
+    "max-df", "max-features", "min-df", "min-ngram", "max-ngram", "max-pending-terms",
+    "hash-bits", "hash-signed", "seed"
+};
+
+/**
+ * @brief Measures consecutive intervals for stage timing
+ * 
+ * Reads the clock only when instrumentation is compiled in.
+ */
+class StageClock {
+public:
+    StageClock() {
+        if constexpr (STATS_ENABLED) {
+            last = utils::StatsRecorder::now();
+        }
+    }
+    
+    /**
+     * @brief Gets the time since construction or the previous lap
+     * @return Elapsed nanoseconds (0 when instrumentation is compiled out)
+     */
+    uint64_t lap() {
+        if constexpr (STATS_ENABLED) {
+            uint64_t now = utils::StatsRecorder::now();
+            uint64_t elapsed = now - last;
+            last = now;
+            return elapsed;
+        }
+        return 0;
+    }
+    
+private:
+    uint64_t last = 0;  ///< Clock reading at the previous lap
+};
+
+/**
+ * @brief Cached analysis results of one model
+ * 
+ * Exact repeats skip preprocessing through the first level; texts that
+ * preprocess to the same cleaned text share an entry in the second.
+ */
+struct AnalysisCache {
+    /**
+     * @brief Constructor
+     * @param capacity Entries in each level
+     * @param ttl Lifetime of an entry (zero = no expiry)
+     */
+    AnalysisCache(size_t capacity, std::chrono::steady_clock::duration ttl)
+        : cleanedTexts(capacity, ttl), results(capacity, ttl) {}
+    
+    utils::ResultCache<std::string> cleanedTexts;  ///< Raw text to cleaned text
+    utils::ResultCache<AnalysisResult> results;    ///< Cleaned text to result (without the raw text)
+};
+
+/**
+ * @brief Results of one model per near-duplicate cluster
+ * 
+ * The stored results hold neither the raw nor the cleaned text, which
+ * differ between the members of a cluster.
+ */
+using NearDuplicates = utils::NearDuplicateIndex<AnalysisResult>;
+
+/**
+ * @brief Everything needed to score texts, published as one immutable unit
+ * 
+ * Analysis calls take a reference to the current snapshot and use it for
+ * the whole call. Loading or training builds a new snapshot next to the
+ * old one and swaps it in, so running analyses never see a half-replaced
+ * model and the old components are freed when the last reader lets go.
+ * Each published snapshot gets its own empty result cache and
+ * near-duplicate index, so cached results never outlive the model that
+ * produced them.
+ */
+struct ModelSnapshot {
+    std::shared_ptr<const preprocessing::TextProcessor> textProcessor; ///< Text preprocessing engine
+    std::shared_ptr<const preprocessing::Vectorizer> vectorizer;       ///< Feature extraction engine
+    std::shared_ptr<const models::Classifier> model;                   ///< Classification model (dense input)
+    std::shared_ptr<const models::LinearModel> linearModel;            ///< Sparse linear model (model-type = linear)
+    std::shared_ptr<const models::MlpModel> mlpModel;                  ///< Sparse neural network (model-type = mlp)
+    std::shared_ptr<const models::LinearScorer> scorer;                ///< Fused scorer, if available (refers to vectorizer)
+    std::shared_ptr<AnalysisCache> resultCache;                        ///< Results of this model (null = caching off)
+    std::shared_ptr<NearDuplicates> nearDuplicates;                    ///< Clusters of texts this model scored (null = stage off)
+    std::shared_ptr<const ModelSnapshot> firstStage;                   ///< Cheap model tried first (null = no cascade)
+    double cascadeLow = 0.0;                                           ///< First-stage probabilities below this exit as safe
+    double cascadeHigh = 1.0;                                          ///< First-stage probabilities above this exit as harmful
+    bool fusedScoring = true;                                          ///< Setting the scorer was built for
+    uint64_t version = 0;                                              ///< Incremented for each published model
+    
+    /**
+     * @brief Checks whether the snapshot can score texts
+     * @return True if a model has been trained or loaded
+     */
+    bool hasModel() const {
+        return model || linearModel || mlpModel;
+    }
+};
+
+/**
+ * @brief Features of one cross-validation fold, extracted once and shared by every tuned setting
+ */
+struct FoldFeatures {
+    std::vector<preprocessing::SparseVector> train;  ///< Rows of the other folds
+    std::vector<int> trainLabels;                    ///< Labels of the training rows
+    std::vector<preprocessing::SparseVector> test;   ///< Rows of this fold
+    std::vector<int> testLabels;                     ///< Labels of the test rows
+    size_t numFeatures = 0;                          ///< Dimension of the fold's vectorizer
+};
+
+/**
+ * @brief Appends a JSON string literal
+ * @param out String to append to
+ * @param text Text to quote and escape
+ */
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escape[7];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escape;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Appends a number the way a stream with precision 9 prints it
+ * @param out String to append to
+ * @param value Number to format
+ */
+void appendJsonNumber(std::string& out, double value) {
+    char buffer[32];
+    auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 9);
+    out.append(buffer, error == std::errc() ? end : buffer);
+}
+
+/**
+ * @brief Clears the optional parts of a result that were not requested
+ * @param result Result holding at least the requested parts
+ * @param fields Requested AnalysisResult::Field bits
+ */
+void dropUnrequested(AnalysisResult& result, uint32_t fields) {
+    if (!(fields & AnalysisResult::CLEANED_TEXT)) {
+        result.cleanedText.clear();
+    }
+    if (!(fields & AnalysisResult::KEY_TERMS)) {
+        result.keyTerms.clear();
+    }
+    if (!(fields & AnalysisResult::EXPLANATION)) {
+        result.explanation.clear();
+    }
+    result.fields &= fields;
+}
+
+/**
+ * @brief Computes the near-duplicate signature of a cleaned text
+ * 
+ * Hashes the words and word pairs of the text, the terms the default
+ * vectorizer counts, without building their strings.
+ * 
+ * @param cleanedText Preprocessed text
+ * @param signature Receives the MinHash signature
+ * @return False if the text is too short to cluster
+ */
+bool nearDuplicateSignature(std::string_view cleanedText, utils::MinHashSignature& signature) {
+    static const preprocessing::Tokenizer tokenizer(1, 2);
+    thread_local std::vector<std::string_view> words;
+    thread_local std::vector<preprocessing::TermId> terms;
+    
+    preprocessing::Tokenizer::splitWords(cleanedText, words);
+    if (words.size() < MIN_NEAR_DUPLICATE_WORDS) {
+        return false;
+    }
+    terms.clear();
+    tokenizer.forEachTerm(words, [](preprocessing::TermId term, size_t, size_t) {
+        terms.push_back(term);
+    });
+    signature = utils::minHash(terms);
+    return true;
+}
+
+/// Settings read when a model is loaded; the rest only matter for training
+constexpr std::array<std::string_view, 4> MODEL_LOAD_KEYS = {
+    "model-type", "hidden-layers", "hidden-size", "nn-float32"
+};
+
+/**
+ * @brief Configuration values the analyzer serves with, parsed once
+ * 
+ * Read from the Config after each change and compared with the previous
+ * values, so only the components whose settings changed are rebuilt.
+ */
+struct AnalyzerSettings {
+    std::vector<std::string> pipeline;          ///< Preprocessing steps (empty = default)
+    size_t threads = 1;                         ///< Worker threads for batch scoring
+    bool fusedScoring = true;                   ///< Whether snapshots get a fused scorer
+    size_t resultCacheSize = 0;                 ///< Entries in each snapshot's result cache (0 = off)
+    std::chrono::steady_clock::duration resultCacheTtl{}; ///< Lifetime of cached results (zero = no expiry)
+    size_t nearDuplicateCapacity = 0;           ///< Clusters in each snapshot's near-duplicate index (0 = off)
+    double nearDuplicateSimilarity = 0.7;       ///< Smallest estimated similarity within a cluster
+    std::string modelDir;                       ///< Model loaded with the configuration (empty = none)
+    std::string cascadeDir;                     ///< First-stage model (empty = no cascade)
+    double cascadeLow = 0.1;                    ///< Lower edge of the first stage's uncertainty band
+    double cascadeHigh = 0.9;                   ///< Upper edge of the first stage's uncertainty band
+    std::vector<std::string> modelLoading;      ///< Values of MODEL_LOAD_KEYS
+    
+    /**
+     * @brief Parses the settings from a configuration
+     * @param config Configuration to read
+     * @return Parsed settings
+     */
+    static AnalyzerSettings read(const Config& config) {
+        AnalyzerSettings settings;
+        
+        std::stringstream pipelineStream(config.getString("preprocessing-pipeline", ""));
+        std::string step;
+        while (std::getline(pipelineStream, step, ',')) {
+            step.erase(0, step.find_first_not_of(" \t"));
+            step.erase(step.find_last_not_of(" \t") + 1);
+            if (!step.empty()) {
+                settings.pipeline.push_back(step);
+            }
+        }
+        
+        settings.threads = utils::resolveThreadCount(config.getInt("threads", 0));
+        settings.fusedScoring = config.getBool("fused-scoring", true);
+        settings.resultCacheSize = static_cast<size_t>(std::max(0, config.getInt("result-cache-size", 0)));
+        settings.resultCacheTtl = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(std::max(0.0, config.getDouble("result-cache-ttl", 0.0))));
+        settings.nearDuplicateCapacity = config.getBool("near-duplicates", false)
+            ? static_cast<size_t>(std::max(1, config.getInt("near-duplicate-capacity", 10000))) : 0;
+        settings.nearDuplicateSimilarity = config.getDouble("near-duplicate-similarity", 0.7);
+        settings.modelDir = config.getString("model-dir", "");
+        settings.cascadeDir = config.getString("cascade-model-dir", "");
+        settings.cascadeLow = std::clamp(config.getDouble("cascade-low", 0.1), 0.0, 1.0);
+        settings.cascadeHigh = std::clamp(config.getDouble("cascade-high", 0.9), settings.cascadeLow, 1.0);
+        for (std::string_view key : MODEL_LOAD_KEYS) {
+            settings.modelLoading.push_back(config.getString(std::string(key), ""));
+        }
+        return settings;
+    }
+    
+    /**
+     * @brief Checks whether cached results stay valid under other settings
+     * @param other Settings to compare with
+     * @return True if texts would be scored the same way and the caches are sized the same
+     */
+    bool sameResults(const AnalyzerSettings& other) const {
+        return pipeline == other.pipeline && fusedScoring == other.fusedScoring &&
+               resultCacheSize == other.resultCacheSize && resultCacheTtl == other.resultCacheTtl &&
+               nearDuplicateCapacity == other.nearDuplicateCapacity &&
+               nearDuplicateSimilarity == other.nearDuplicateSimilarity &&
+               cascadeDir == other.cascadeDir && cascadeLow == other.cascadeLow &&
+               cascadeHigh == other.cascadeHigh && modelLoading == other.modelLoading;
+    }
+};
+
+} // namespace
+
 // ==========================================
 // AnalysisResult Implementation
 // ==========================================
@@ -36,25 +357,121 @@ namespace blahajpi {
  */
 std::unordered_map<std::string, std::string> AnalysisResult::toMap() const {
     std::unordered_map<std::string, std::string> map;
+    map.reserve(7);
     
-    map["text"] = text;
-    map["cleaned_text"] = cleanedText;
+    // Parts the result was produced without are left out rather than stored empty
+    if (fields & TEXT) {
+        map["text"] = text;
+    }
+    if (fields & CLEANED_TEXT) {
+        map["cleaned_text"] = cleanedText;
+    }
     map["sentiment"] = sentiment;
     map["harm_score"] = std::to_string(harmScore);
     map["confidence"] = std::to_string(confidence);
-    map["explanation"] = explanation;
+    if (fields & EXPLANATION) {
+        map["explanation"] = explanation;
+    }
     
     // Convert key terms to a comma-separated string
-    std::stringstream termsStream;
-    for (size_t i = 0; i < keyTerms.size(); ++i) {
-        if (i > 0) termsStream << ",";
-        termsStream << keyTerms[i];
+    if (fields & KEY_TERMS) {
+        std::string terms;
+        for (size_t i = 0; i < keyTerms.size(); ++i) {
+            if (i > 0) terms += ',';
+            terms += keyTerms[i];
+        }
+        map["key_terms"] = std::move(terms);
+    }
+    
+    if (cluster != 0) {
+        map["cluster"] = formatCluster(cluster);
     }
-    map["key_terms"] = termsStream.str();
     
     return map;
 }
 
+std::string AnalysisResult::formatCluster(uint64_t cluster) {
+    if (cluster == 0) {
+        return {};
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(cluster));
+    return buffer;
+}
+
+std::string AnalysisResult::makeExplanation() const {
+    std::string explanation;
+    
+    // Determine sentiment description based on score
+    if (harmScore > 0.5) {
+        explanation = "This content appears to be highly harmful";
+    } else if (harmScore > 0.0) {
+        explanation = "This content may contain harmful elements";
+    } else if (harmScore > -0.5) {
+        explanation = "This content appears to be mostly safe";
+    } else {
+        explanation = "This content appears to be safe";
+    }
+    
+    // Add confidence information
+    explanation += " (confidence: ";
+    if (confidence > 0.9) {
+        explanation += "very high";
+    } else if (confidence > 0.7) {
+        explanation += "high";
+    } else if (confidence > 0.5) {
+        explanation += "moderate";
+    } else {
+        explanation += "low";
+    }
+    explanation += ").";
+    
+    // Add key terms
+    if (!keyTerms.empty()) {
+        explanation += " Key terms detected: ";
+        for (size_t i = 0; i < keyTerms.size(); ++i) {
+            if (i > 0) explanation += ", ";
+            explanation += keyTerms[i];
+        }
+        explanation += ".";
+    }
+    
+    return explanation;
+}
+
+void AnalysisResult::appendJson(std::string& out, std::string_view id) const {
+    out += '{';
+    if (!id.empty()) {
+        out += "\"id\":";
+        out += id;
+        out += ',';
+    }
+    out += "\"sentiment\":";
+    appendJsonString(out, sentiment);
+    out += ",\"harm_score\":";
+    appendJsonNumber(out, harmScore);
+    out += ",\"confidence\":";
+    appendJsonNumber(out, confidence);
+    if (fields & EXPLANATION) {
+        out += ",\"explanation\":";
+        appendJsonString(out, explanation);
+    }
+    if (fields & KEY_TERMS) {
+        out += ",\"key_terms\":[";
+        for (size_t i = 0; i < keyTerms.size(); ++i) {
+            if (i > 0) out += ',';
+            appendJsonString(out, keyTerms[i]);
+        }
+        out += ']';
+    }
+    if (cluster != 0) {
+        out += ",\"cluster\":\"";
+        out += formatCluster(cluster);
+        out += '"';
+    }
+    out += '}';
+}
+
 /**
  * @brief Creates an AnalysisResult from a map representation
  * @param map Map containing result properties
@@ -88,6 +505,18 @@ AnalysisResult AnalysisResult::fromMap(const std::unordered_map<std::string, std
     
     result.explanation = getMapValue("explanation");
     
+    // Parts missing from the map were not part of the original result
+    result.fields = SCORES_ONLY;
+    for (auto [key, field] : {std::pair<const char*, Field>{"text", TEXT}, {"cleaned_text", CLEANED_TEXT},
+                              {"explanation", EXPLANATION}, {"key_terms", KEY_TERMS}}) {
+        if (map.count(key) > 0) {
+            result.fields |= field;
+        }
+    }
+    
+    std::string clusterStr = getMapValue("cluster");
+    std::from_chars(clusterStr.data(), clusterStr.data() + clusterStr.size(), result.cluster, 16);
+    
     // Parse key terms from comma-separated string
     std::string termsStr = getMapValue("key_terms");
     std::stringstream termsStream(termsStr);
@@ -115,8 +544,10 @@ public:
     /**
      * @brief Default constructor
      */
-    AnalyzerImpl() : config_(), textProcessor_(), vectorizer_(true, 0.5, 10000, 1, 2) {
-        // Initialize with defaults
+    AnalyzerImpl() : config_(), textProcessor_(std::make_shared<preprocessing::TextProcessor>()),
+                     threads_(utils::resolveThreadCount(0)) {
+        // Start without a model
+        snapshot_.store(newSnapshot());
     }
     
     /**
@@ -124,139 +555,370 @@ public:
      * @param configPath Path to configuration file
      */
     AnalyzerImpl(const std::string& configPath) : config_(configPath), 
-                                         textProcessor_(), 
-                                         vectorizer_(true, 0.5, 10000, 1, 2) {
+                                         textProcessor_(std::make_shared<preprocessing::TextProcessor>()),
+                                         threads_(utils::resolveThreadCount(0)) {
+        snapshot_.store(newSnapshot());
+        
         // Apply configuration
+        std::lock_guard<std::mutex> lock(updateMutex_);
         applyConfig();
     }
     
     /**
      * @brief Applies current configuration settings to components
+     * 
+     * The caller must hold updateMutex_. Only components whose settings
+     * changed since the last call are rebuilt: the model is reloaded
+     * when model-dir or a setting read while loading changes, and the
+     * caches start over when results could differ. Vectorizer settings
+     * take effect at the next training run; the loaded model keeps the
+     * vectorizer it was trained with.
      */
     void applyConfig() {
-        // Configure vectorizer from settings
-        bool sublinearTf = config_.getBool("use-sublinear-tf", true);
-        double maxDf = config_.getDouble("max-df", 0.5);
-        int maxFeatures = config_.getInt("max-features", 10000);
-        int minNgram = config_.getInt("min-ngram", 1);
-        int maxNgram = config_.getInt("max-ngram", 2);
+        AnalyzerSettings previous = std::exchange(settings_, AnalyzerSettings::read(config_));
+        bool initial = !configApplied_;
+        configApplied_ = true;
         
-        // Create a new vectorizer with these settings
-        vectorizer_ = preprocessing::TfidfVectorizer(
-            sublinearTf, maxDf, maxFeatures, minNgram, maxNgram);
+        bool pipelineChanged = initial || settings_.pipeline != previous.pipeline;
+        bool scoringChanged = settings_.fusedScoring != previous.fusedScoring;
+        bool loadingChanged = settings_.modelLoading != previous.modelLoading;
+        bool modelChanged = initial || loadingChanged || settings_.modelDir != previous.modelDir;
+        bool cascadeChanged = initial || loadingChanged || settings_.cascadeDir != previous.cascadeDir;
+        bool resultsChanged = initial || !settings_.sameResults(previous);
         
-        // If model path is specified, try to load the model
-        std::string modelDir = config_.getString("model-dir", "");
-        if (!modelDir.empty()) {
-            loadModel(modelDir);
-        }
-    }
-    
-    /**
-     * @brief Analyzes text content for harmful material
-     * @param text Text to analyze
-     * @return Analysis result
-     */
-    AnalysisResult analyze(const std::string& text) {
-        if (!model_) {
-            throw std::runtime_error("No model loaded. Call loadModel() first.");
+        // Preprocessing steps, compiled once instead of resolved per call;
+        // readers may still use the current processor, so build a new one
+        if (pipelineChanged) {
+            auto textProcessor = std::make_shared<preprocessing::TextProcessor>();
+            textProcessor->setPipeline(settings_.pipeline);
+            textProcessor_ = std::move(textProcessor);
         }
         
-        AnalysisResult result;
-        result.text = text;
-        
-        // Preprocess the text
-        result.cleanedText = textProcessor_.preprocess(text);
+        // Worker threads for batch scoring (0 = all hardware threads)
+        threads_.store(settings_.threads, std::memory_order_relaxed);
         
-        // Extract features
-        std::vector<std::string> texts = {result.cleanedText};
-        std::vector<std::vector<double>> features = vectorizer_.transform(texts);
-        
-        if (features.empty() || features[0].empty()) {
-            // Handle empty features case
-            result.sentiment = "Safe";
-            result.harmScore = 0.0;
-            result.confidence = 0.5;
-            result.explanation = "Unable to analyze text (no features extracted).";
-            return result;
+        if (cascadeChanged) {
+            applyCascadeConfig();
+        } else if (cascade_ && (pipelineChanged || scoringChanged)) {
+            // The first stage shares the preprocessing pipeline of the full model
+            auto stage = std::make_shared<ModelSnapshot>(*cascade_);
+            stage->textProcessor = textProcessor_;
+            if (scoringChanged) {
+                updateScorer(*stage);
+            }
+            cascade_ = std::move(stage);
         }
         
-        // Get raw score from model
-        std::vector<double> scores = model_->decisionFunction(features);
-        result.harmScore = scores[0];
-        
-        // Get probabilities
-        std::vector<double> probs = model_->predictProbability(features);
-        result.confidence = probs[0];
+        // Load the configured model when it or the way it is loaded changed
+        if (modelChanged && !settings_.modelDir.empty() && loadModelLocked(settings_.modelDir)) {
+            return;
+        }
+        if (!resultsChanged) {
+            return;
+        }
         
-        // Determine sentiment label
-        if (result.harmScore > 0.0) {
-            result.sentiment = "Harmful";
-        } else {
-            result.sentiment = "Safe";
+        // Otherwise keep the current model with the new settings
+        auto next = std::make_shared<ModelSnapshot>(*snapshot_.load());
+        next->textProcessor = textProcessor_;
+        if (next->fusedScoring != settings_.fusedScoring) {
+            updateScorer(*next);
         }
         
-        // Extract key terms that contributed to classification
-        result.keyTerms = extractKeyTerms(result.cleanedText, result.harmScore);
+        // Cached results may come from the old preprocessing settings
+        next->resultCache = makeResultCache();
+        next->nearDuplicates = makeNearDuplicates();
+        attachCascade(*next);
+        snapshot_.store(std::move(next));
+    }
+    
+    /**
+     * @brief Loads the configured first-stage model
+     * 
+     * The first stage is a separately trained model directory, typically
+     * a small model like the one fast_model.conf trains. It shares the
+     * preprocessing pipeline of the full model, so each text is cleaned
+     * once. If it cannot be loaded, texts go straight to the full model.
+     * The caller must hold updateMutex_.
+     */
+    void applyCascadeConfig() {
+        if (settings_.cascadeDir.empty()) {
+            cascade_.reset();
+            return;
+        }
         
-        // Generate explanation
-        result.explanation = generateExplanation(result.harmScore, result.confidence, result.keyTerms);
+        std::shared_ptr<ModelSnapshot> stage = newSnapshot();
+        if (!loadModelFiles(settings_.cascadeDir, *stage)) {
+            std::cerr << "Warning: Cascade disabled; could not load the first-stage model from: "
+                      << settings_.cascadeDir << std::endl;
+            cascade_.reset();
+            return;
+        }
+        cascade_ = std::move(stage);
+    }
+    
+    /**
+     * @brief Gives a snapshot the configured first stage
+     * @param snapshot Snapshot about to be published
+     */
+    void attachCascade(ModelSnapshot& snapshot) const {
+        snapshot.firstStage = cascade_;
+        snapshot.cascadeLow = settings_.cascadeLow;
+        snapshot.cascadeHigh = settings_.cascadeHigh;
+    }
+    
+    /**
+     * @brief Analyzes text content for harmful material
+     * @param text Text to analyze
+     * @param fields AnalysisResult::Field bits to fill in
+     * @return Analysis result
+     */
+    AnalysisResult analyze(const std::string& text, uint32_t fields) {
+        std::shared_ptr<const ModelSnapshot> snapshot = snapshot_.load();
+        requireModel(*snapshot);
         
+        AnalysisResult result;
+        std::string_view view(text);
+        analyzeChunk(*snapshot, std::span<const std::string_view>(&view, 1), &result, fields);
         return result;
     }
     
     /**
      * @brief Analyzes multiple texts in batch
+     * 
+     * Texts are split into chunks that are preprocessed, vectorized and
+     * scored on the worker threads. The whole batch is scored with the
+     * snapshot that was current when the call started, and each chunk
+     * writes to its own slice of the output, so results stay in input
+     * order.
+     * 
      * @param texts Collection of texts to analyze
+     * @param fields AnalysisResult::Field bits to fill in
      * @return Vector of analysis results
      */
-    std::vector<AnalysisResult> analyzeMultiple(const std::vector<std::string>& texts) {
-        std::vector<AnalysisResult> results;
-        results.reserve(texts.size());
-        
-        for (const auto& text : texts) {
-            results.push_back(analyze(text));
+    std::vector<AnalysisResult> analyzeMultiple(const std::vector<std::string>& texts, uint32_t fields) {
+        std::vector<AnalysisResult> results(texts.size());
+        if (texts.empty()) {
+            return results;
         }
         
+        std::shared_ptr<const ModelSnapshot> snapshot = snapshot_.load();
+        requireModel(*snapshot);
+        
+        std::vector<std::string_view> views(texts.begin(), texts.end());
+        std::span<const std::string_view> input(views);
+        forEachChunk(texts.size(), [&](size_t begin, size_t count) {
+            analyzeChunk(*snapshot, input.subspan(begin, count), results.data() + begin, fields);
+        });
+        
         return results;
     }
     
     /**
-     * @brief Loads a trained model from disk
+     * @brief Scores texts held in caller-owned memory
+     * 
+     * Runs the same chunks as analyzeMultiple() with only the scores
+     * filled in, and copies them out of a per-thread result buffer, so
+     * neither the texts nor the results are allocated per call.
+     * 
+     * @param texts Texts to score
+     * @param scores Receives one decision score per text (empty = not wanted)
+     * @param probabilities Receives one harmful-class probability per text (empty = not wanted)
+     */
+    void scoreBatch(std::span<const std::string_view> texts, std::span<double> scores, std::span<double> probabilities) {
+        if ((!scores.empty() && scores.size() != texts.size()) ||
+            (!probabilities.empty() && probabilities.size() != texts.size())) {
+            throw std::invalid_argument("Output arrays must hold one value per text");
+        }
+        if (texts.empty()) {
+            return;
+        }
+        
+        std::shared_ptr<const ModelSnapshot> snapshot = snapshot_.load();
+        requireModel(*snapshot);
+        
+        forEachChunk(texts.size(), [&](size_t begin, size_t count) {
+            // Slots are reused across calls, so nothing of an earlier text may carry over
+            thread_local std::vector<AnalysisResult> results;
+            results.assign(count, AnalysisResult{});
+            analyzeChunk(*snapshot, texts.subspan(begin, count), results.data(), AnalysisResult::SCORES_ONLY);
+            for (size_t i = 0; i < count; ++i) {
+                if (!scores.empty()) {
+                    scores[begin + i] = results[i].harmScore;
+                }
+                if (!probabilities.empty()) {
+                    probabilities[begin + i] = results[i].confidence;
+                }
+            }
+        });
+    }
+    
+    /**
+     * @brief Loads a trained model from disk and swaps it in
      * @param modelPath Path to the model directory
      * @return True if loading was successful
      */
     bool loadModel(const std::string& modelPath) {
-        // Try to determine model type from path or configuration
-        std::string modelType = "sgd"; // Default model type
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        return loadModelLocked(modelPath);
+    }
+    
+    /**
+     * @brief Gets the version of the model analyses currently use
+     * @return 0 before any model is published, then incremented per model
+     */
+    uint64_t getModelVersion() const {
+        return snapshot_.load()->version;
+    }
+    
+    /**
+     * @brief Applies incremental SGD steps to the live model
+     * 
+     * Copies the current linear model, runs one partialFit() pass over the
+     * samples with the frozen vectorizer and swaps the result in. Analyses
+     * keep using the previous model until the swap.
+     * 
+     * @param texts Raw texts
+     * @param labels Labels (0 = safe, non-zero = harmful)
+     * @return True if the model was updated
+     * @throws std::invalid_argument If texts and labels have different sizes
+     */
+    bool update(const std::vector<std::string>& texts, const std::vector<int>& labels) {
+        if (texts.size() != labels.size()) {
+            throw std::invalid_argument("Texts and labels must have the same size");
+        }
         
-        // Create appropriate model based on type
-        if (modelType == "sgd") {
-            model_ = std::make_unique<models::SGDClassifier>();
-        } else {
-            // Use SGD as default if model type is not recognized
-            model_ = std::make_unique<models::SGDClassifier>();
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        std::shared_ptr<const ModelSnapshot> current = snapshot_.load();
+        if (!current->linearModel) {
+            std::cerr << "Error: Incremental updates need a trained linear model (model-type = linear)" << std::endl;
+            return false;
+        }
+        if (texts.empty()) {
+            return true;
         }
         
-        // Try to load the model
-        std::string modelFilePath = modelPath + "/model.bin";
-        bool modelLoaded = model_->load(modelFilePath);
+        std::vector<std::string> cleanedTexts;
+        cleanedTexts.reserve(texts.size());
+        for (const auto& text : texts) {
+            cleanedTexts.push_back(current->textProcessor->preprocess(text));
+        }
         
-        if (!modelLoaded) {
-            std::cerr << "Failed to load model from: " << modelFilePath << std::endl;
+        // Terms outside a TF-IDF vocabulary are ignored; hashed features cover every term
+        auto model = std::make_shared<models::LinearModel>(*current->linearModel);
+        model->setTrainingOptions(makeTrainingOptions(false));
+        model->partialFit(current->vectorizer->transformSparse(cleanedTexts), labels,
+                          current->vectorizer->getNumFeatures());
+        
+        auto next = std::make_shared<ModelSnapshot>(*current);
+        next->linearModel = std::move(model);
+        updateScorer(*next);
+        publishModel(next);
+        return true;
+    }
+    
+    /**
+     * @brief Saves the model analyses currently use
+     * @param outputPath Directory to save into
+     * @return True if everything was saved
+     */
+    bool saveModel(const std::string& outputPath) const {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        std::shared_ptr<const ModelSnapshot> current = snapshot_.load();
+        if (!current->hasModel()) {
+            std::cerr << "Error: No model to save" << std::endl;
+            return false;
+        }
+        return saveModel(outputPath, *current, std::nullopt);
+    }
+    
+    /**
+     * @brief Drops low-weight features from the current model and saves it
+     * @param outputPath Directory to save into
+     * @param threshold Smallest absolute weight a feature keeps
+     * @param dataPath Labeled dataset to measure the change on (may be empty)
+     * @return True if the model was compacted and saved
+     */
+    bool compactModel(const std::string& outputPath, double threshold, const std::string& dataPath) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        std::shared_ptr<const ModelSnapshot> current = snapshot_.load();
+        if (!current->linearModel) {
+            std::cerr << "Error: Compaction needs a loaded model of type 'linear'" << std::endl;
+            return false;
+        }
+        if (!dynamic_cast<const preprocessing::TfidfVectorizer*>(current->vectorizer.get())) {
+            std::cerr << "Error: Compaction needs a tfidf vocabulary; hashed features have none to prune" << std::endl;
             return false;
         }
         
-        // Try to load the vectorizer
-        std::string vectorizerPath = modelPath + "/vectorizer.bin";
-        bool vectorizerLoaded = vectorizer_.load(vectorizerPath);
+        auto next = std::make_shared<ModelSnapshot>(*current);
+        std::optional<double> accuracy;
+        bool compacted = false;
+        if (dataPath.empty()) {
+            compacted = compactSnapshot(*next, threshold) > 0;
+        } else {
+            std::string labelColumn = config_.getString("label-column", "sentiment_label");
+            std::string textColumn = config_.getString("text-column", "tweet_text");
+            utils::Dataset dataset;
+            if (!dataset.loadFromFile(dataPath, utils::Dataset::Format::AUTO, labelColumn, textColumn)) {
+                std::cerr << "Failed to load dataset from: " << dataPath << std::endl;
+                return false;
+            }
+            
+            std::span<const std::string> rawTexts = dataset.textColumn();
+            std::vector<std::string> cleanedTexts(rawTexts.size());
+            utils::parallelFor(cleanedTexts.size(), threads_.load(std::memory_order_relaxed), [&](size_t i) {
+                cleanedTexts[i] = next->textProcessor->preprocess(rawTexts[i]);
+            });
+            std::vector<int> labels(dataset.labelColumn().begin(), dataset.labelColumn().end());
+            std::vector<preprocessing::SparseVector> features = next->vectorizer->transformSparse(cleanedTexts);
+            accuracy = compactForExport(*next, threshold, cleanedTexts, features, labels);
+            // compactSnapshot() only swaps in a new model when it prunes
+            compacted = next->linearModel != current->linearModel;
+        }
         
-        if (!vectorizerLoaded) {
-            std::cerr << "Failed to load vectorizer from: " << vectorizerPath << std::endl;
+        // Keep the current model, its version and its caches when nothing changed
+        if (!compacted) {
+            std::cerr << "No features were pruned; the model was not compacted" << std::endl;
             return false;
         }
-        
-        return true;
+        publishModel(next);
+        return saveModel(outputPath, *next, accuracy);
+    }
+    
+    /**
+     * @brief Gets a snapshot of the instrumentation counters
+     * @return Counter snapshot
+     */
+    utils::AnalyzerStats getStats() const {
+        utils::AnalyzerStats stats = stats_.snapshot(STATS_ENABLED);
+        std::shared_ptr<const ModelSnapshot> snapshot = snapshot_.load();
+        if (STATS_ENABLED && snapshot->resultCache) {
+            stats.cacheEntries = snapshot->resultCache->results.size();
+        }
+        return stats;
+    }
+    
+    /**
+     * @brief Resets the instrumentation counters
+     */
+    void resetStats() {
+        stats_.reset();
+    }
+    
+    /**
+     * @brief Lists the largest near-duplicate clusters of the current snapshot
+     * @param maxClusters Largest number of clusters to return
+     * @return Pairs of cluster ID and member count, largest first
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> getNearDuplicateClusters(size_t maxClusters) const {
+        std::vector<std::pair<uint64_t, uint64_t>> clusters;
+        std::shared_ptr<const ModelSnapshot> snapshot = snapshot_.load();
+        if (snapshot->nearDuplicates) {
+            for (const auto& cluster : snapshot->nearDuplicates->clusters(maxClusters)) {
+                clusters.emplace_back(cluster.id, cluster.members);
+            }
+        }
+        return clusters;
     }
     
     /**
@@ -266,265 +928,1785 @@ public:
      * @return True if training was successful
      */
     bool trainModel(const std::string& dataPath, const std::string& outputPath) {
-        // Get column names from configuration
-        std::string labelColumn = config_.getString("label-column", "sentiment_label");
-        std::string textColumn = config_.getString("text-column", "tweet_text");
+        std::lock_guard<std::mutex> lock(updateMutex_);
         
-        // Debug output to verify configuration
-        std::cout << "Using column names for training: " << std::endl;
-        std::cout << "  Label column: '" << labelColumn << "'" << std::endl;
-        std::cout << "  Text column: '" << textColumn << "'" << std::endl;
+        // Datasets too large for memory are streamed from disk instead
+        int streamBatchSize = config_.getInt("stream-batch-size", 0);
+        if (streamBatchSize > 0) {
+            return trainModelStreaming(dataPath, outputPath, static_cast<size_t>(streamBatchSize));
+        }
         
-        // Load dataset with explicit column names
-        utils::Dataset dataset;
-        if (!dataset.loadFromFile(dataPath, utils::Dataset::Format::AUTO, labelColumn, textColumn)) {
-            std::cerr << "Failed to load dataset from: " << dataPath << std::endl;
+        preprocessing::FeatureSet prepared;
+        if (!prepareFeatures(dataPath, prepared)) {
             return false;
         }
+        std::unique_ptr<preprocessing::Vectorizer> vectorizer = std::move(prepared.vectorizer);
+        std::vector<preprocessing::SparseVector>& features = prepared.trainFeatures;
+        const std::vector<int>& trainLabels = prepared.trainLabels;
+        
+        // Create and train model
+        std::string modelType = config_.getString("model-type", "sgd");
+        double alpha = config_.getDouble("alpha", 0.0001);
+        double eta0 = config_.getDouble("eta0", 0.01);
+        int epochs = config_.getInt("epochs", 10);
+        unsigned int seed = static_cast<unsigned int>(config_.getInt("seed", 42));
+        
+        // Expanding 2^hash-bits columns per row is not practical for dense models
+        bool hashedFeatures = dynamic_cast<preprocessing::HashingVectorizer*>(vectorizer.get()) != nullptr;
+        if (hashedFeatures && modelType != "linear" && modelType != "mlp") {
+            std::cerr << "Warning: model-type '" << modelType
+                      << "' needs dense features; training a linear model on hashed features" << std::endl;
+            modelType = "linear";
+        }
+        
+        std::shared_ptr<ModelSnapshot> next = newSnapshot();
+        if (modelType == "linear") {
+            // Trains straight from the sparse rows
+            auto linearModel = std::make_unique<models::LinearModel>("log", alpha, epochs, eta0, seed);
+            linearModel->setTrainingOptions(makeTrainingOptions(true));
+            linearModel->fit(features, trainLabels, vectorizer->getNumFeatures());
+            if (linearModel->getEpochsRun() < epochs) {
+                std::cout << "Early stopping after " << linearModel->getEpochsRun() << " of " << epochs << " epochs" << std::endl;
+            }
+            next->linearModel = std::move(linearModel);
+        } else if (modelType == "mlp") {
+            // The network's first layer also reads the sparse rows
+            auto mlpModel = makeMlpModel();
+            mlpModel->fit(features, trainLabels, vectorizer->getNumFeatures());
+            next->mlpModel = std::move(mlpModel);
+        } else {
+            if (config_.getInt("train-threads", 1) != 1 || config_.getBool("early-stopping", false)) {
+                std::cerr << "Warning: train-threads, batch-size and early-stopping only apply to model-type 'linear'" << std::endl;
+            }
+
+            // Classifiers only accept dense rows, so expand at the boundary
+            auto model = makeClassifier(modelType);
+            model->fit(preprocessing::toDenseMatrix(features, vectorizer->getNumFeatures()), trainLabels);
+            next->model = std::move(model);
+        }
+        next->vectorizer = std::move(vectorizer);
+        features.clear();
+        updateScorer(*next);
+        
+        // Evaluate model on test data
+        const std::vector<std::string>& cleanedTestTexts = prepared.testTexts;
+        std::vector<preprocessing::SparseVector>& testFeatures = prepared.testFeatures;
+        const std::vector<int>& testLabels = prepared.testLabels;
+        double accuracy = 0.0;
+        if (next->linearModel) {
+            accuracy = next->linearModel->score(testFeatures, testLabels);
+        } else if (next->mlpModel) {
+            accuracy = next->mlpModel->score(testFeatures, testLabels);
+        } else {
+            accuracy = next->model->score(preprocessing::toDenseMatrix(testFeatures, next->vectorizer->getNumFeatures()), testLabels);
+        }
+        
+        std::cout << "Model training complete. Test accuracy: " << accuracy << std::endl;
+        
+        // Features the model barely uses are dropped before export
+        double compactThreshold = config_.getDouble("compact-threshold", 0.0);
+        if (compactThreshold > 0.0) {
+            if (next->linearModel) {
+                accuracy = compactForExport(*next, compactThreshold, cleanedTestTexts, testFeatures, testLabels);
+            } else {
+                std::cerr << "Warning: compact-threshold only applies to model-type 'linear'" << std::endl;
+            }
+        }
+        
+        // Post-training quantization only applies to the linear model's weights
+        models::WeightPrecision precision = makeWeightPrecision();
+        if (precision != models::WeightPrecision::Double) {
+            if (next->linearModel) {
+                accuracy = quantizeForExport(*next, precision, cleanedTestTexts, testFeatures, testLabels);
+            } else {
+                std::cerr << "Warning: weight-precision only applies to model-type 'linear'" << std::endl;
+            }
+        }
+        
+        publishModel(next);
+        return saveModel(outputPath, *next, accuracy);
+    }
+    
+    /**
+     * @brief Loads, splits, preprocesses and vectorizes a training dataset
+     * 
+     * With feature-cache-dir set, the result is looked up by a hash of the
+     * dataset contents and every setting in FEATURE_CACHE_SETTINGS, and
+     * stored there after a miss, so runs that only change model settings
+     * go straight to fitting.
+     * 
+     * @param dataPath Path to labeled dataset file
+     * @param prepared Receives the split features and the fitted vectorizer
+     * @return True if the dataset could be loaded
+     */
+    bool prepareFeatures(const std::string& dataPath, preprocessing::FeatureSet& prepared) const {
+        std::string cacheDir = config_.getString("feature-cache-dir", "");
+        preprocessing::FeatureCache cache(cacheDir);
+        std::string cacheKey;
+        if (!cacheDir.empty()) {
+            std::string settings;
+            for (const char* key : FEATURE_CACHE_SETTINGS) {
+                settings += std::string(key) + "=" + config_.getString(key, "") + "\n";
+            }
+            cacheKey = preprocessing::FeatureCache::makeKey(dataPath, settings);
+            if (!cacheKey.empty() && cache.load(cacheKey, prepared)) {
+                std::cout << "Using cached features from: " << cache.pathFor(cacheKey) << std::endl;
+                return true;
+            }
+        }
+        
+        // Get column names from configuration
+        std::string labelColumn = config_.getString("label-column", "sentiment_label");
+        std::string textColumn = config_.getString("text-column", "tweet_text");
+        
+        // Debug output to verify configuration
+        std::cout << "Using column names for training: " << std::endl;
+        std::cout << "  Label column: '" << labelColumn << "'" << std::endl;
+        std::cout << "  Text column: '" << textColumn << "'" << std::endl;
+        
+        // Load dataset with explicit column names
+        utils::Dataset dataset;
+        if (!dataset.loadFromFile(dataPath, utils::Dataset::Format::AUTO, labelColumn, textColumn)) {
+            std::cerr << "Failed to load dataset from: " << dataPath << std::endl;
+            return false;
+        }
+        
+        // Split data for training and testing
+        dataset.splitTrainTest(0.2);
+        
+        // Preprocess texts straight from the dataset's columns
+        utils::TextView trainTexts = dataset.viewTrainTexts();
+        utils::TextView testTexts = dataset.viewTestTexts();
+        std::vector<std::string> cleanedTexts;
+        cleanedTexts.reserve(trainTexts.size());
+        for (const auto& text : trainTexts) {
+            cleanedTexts.push_back(textProcessor_->preprocess(text));
+        }
+        prepared.testTexts.reserve(testTexts.size());
+        for (const auto& text : testTexts) {
+            prepared.testTexts.push_back(textProcessor_->preprocess(text));
+        }
+        prepared.trainLabels = dataset.viewTrainLabels().toVector();
+        prepared.testLabels = dataset.viewTestLabels().toVector();
+        
+        // The raw texts are no longer needed once cleaned
+        dataset = utils::Dataset();
+        
+        // Extract features with a fresh vectorizer; the published one stays in use until the swap
+        prepared.vectorizer = makeVectorizer();
+        prepared.vectorizer->fit(cleanedTexts);
+        prepared.trainFeatures = prepared.vectorizer->transformSparse(cleanedTexts);
+        prepared.testFeatures = prepared.vectorizer->transformSparse(prepared.testTexts);
+        
+        if (!cacheKey.empty()) {
+            if (cache.store(cacheKey, prepared)) {
+                std::cout << "Cached features in: " << cache.pathFor(cacheKey) << std::endl;
+            } else {
+                std::cerr << "Warning: Failed to write feature cache: " << cache.pathFor(cacheKey) << std::endl;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Trains a linear model by streaming the dataset from disk
+     * 
+     * Makes one pass to count document frequencies, one pass per epoch to
+     * train, and a final pass to evaluate on the held-out samples. Only
+     * one batch of samples is in memory at a time. The caller must hold
+     * updateMutex_.
+     * 
+     * @param dataPath Path to labeled CSV or TSV dataset file
+     * @param outputPath Path to save the trained model
+     * @param batchSize Number of samples per batch
+     * @return True if training was successful
+     */
+    bool trainModelStreaming(const std::string& dataPath, const std::string& outputPath, size_t batchSize) {
+        std::string labelColumn = config_.getString("label-column", "sentiment_label");
+        std::string textColumn = config_.getString("text-column", "tweet_text");
+        
+        utils::DatasetReader reader;
+        if (!reader.open(dataPath, utils::Dataset::Format::AUTO, labelColumn, textColumn)) {
+            std::cerr << "Failed to load dataset from: " << dataPath << std::endl;
+            return false;
+        }
+        
+        std::string modelType = config_.getString("model-type", "sgd");
+        double alpha = config_.getDouble("alpha", 0.0001);
+        double eta0 = config_.getDouble("eta0", 0.01);
+        int epochs = config_.getInt("epochs", 10);
+        unsigned int seed = static_cast<unsigned int>(config_.getInt("seed", 42));
+        constexpr double testSize = 0.2;
+        
+        // Only the linear model can be trained batch by batch
+        if (modelType != "linear") {
+            std::cerr << "Warning: model-type '" << modelType
+                      << "' cannot be trained incrementally; training a linear model" << std::endl;
+        }
+        
+        std::vector<std::pair<int, std::string>> batch;
+        std::vector<std::string> cleanedTexts;
+        std::vector<int> batchLabels;
+        
+        // Reads the next batch and keeps the samples of one split
+        auto nextBatch = [&](bool heldOut) {
+            cleanedTexts.clear();
+            batchLabels.clear();
+            while (cleanedTexts.empty()) {
+                size_t first = reader.getSamplesRead();
+                size_t count = reader.readBatch(batch, batchSize);
+                if (count == 0) {
+                    return false;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    if (utils::DatasetReader::isHeldOut(first + i, testSize, seed) == heldOut) {
+                        cleanedTexts.push_back(textProcessor_->preprocess(batch[i].second));
+                        batchLabels.push_back(batch[i].first);
+                    }
+                }
+            }
+            return true;
+        };
+        
+        // Document frequency pass
+        std::unique_ptr<preprocessing::Vectorizer> vectorizer = makeVectorizer();
+        vectorizer->beginFit();
+        size_t trainSamples = 0;
+        while (nextBatch(false)) {
+            vectorizer->partialFit(cleanedTexts);
+            trainSamples += cleanedTexts.size();
+        }
+        vectorizer->finishFit();
+        
+        if (trainSamples == 0) {
+            std::cerr << "No training samples in: " << dataPath << std::endl;
+            return false;
+        }
+        if (vectorizer->getNumFeatures() == 0) {
+            std::cerr << "Vocabulary is empty after min-df/max-df filtering; no features to train on" << std::endl;
+            return false;
+        }
+        std::cout << "Streaming " << trainSamples << " training samples in batches of " << batchSize << std::endl;
+        
+        // One training pass over the file per epoch (early stopping needs the rows in memory, so it does not apply)
+        auto linearModel = std::make_unique<models::LinearModel>("log", alpha, epochs, eta0, seed);
+        linearModel->setTrainingOptions(makeTrainingOptions(false));
+        for (int epoch = 0; epoch < epochs; ++epoch) {
+            reader.rewind();
+            while (nextBatch(false)) {
+                linearModel->partialFit(vectorizer->transformSparse(cleanedTexts), batchLabels,
+                                        vectorizer->getNumFeatures());
+            }
+        }
+        
+        // Evaluate on the held-out samples
+        size_t correct = 0;
+        size_t testSamples = 0;
+        reader.rewind();
+        while (nextBatch(true)) {
+            double batchAccuracy = linearModel->score(vectorizer->transformSparse(cleanedTexts), batchLabels);
+            correct += static_cast<size_t>(std::lround(batchAccuracy * static_cast<double>(batchLabels.size())));
+            testSamples += batchLabels.size();
+        }
+        double accuracy = testSamples > 0 ? static_cast<double>(correct) / testSamples : 0.0;
+        
+        std::cout << "Model training complete. Test accuracy: " << accuracy << std::endl;
+        
+        std::shared_ptr<ModelSnapshot> next = newSnapshot();
+        next->vectorizer = std::move(vectorizer);
+        next->linearModel = std::move(linearModel);
+        updateScorer(*next);
+        
+        // Measuring these costs needs the test set in memory; as in trainModel(), compaction sees the unrounded weights
+        double compactThreshold = config_.getDouble("compact-threshold", 0.0);
+        if (compactThreshold > 0.0) {
+            std::cerr << "Warning: Accuracy change from compact-threshold is not measured when streaming" << std::endl;
+            compactSnapshot(*next, compactThreshold);
+        }
+        
+        models::WeightPrecision precision = makeWeightPrecision();
+        if (precision != models::WeightPrecision::Double) {
+            std::cerr << "Warning: Accuracy change from weight-precision is not measured when streaming" << std::endl;
+            auto quantized = std::make_unique<models::LinearModel>(*next->linearModel);
+            quantized->setWeightPrecision(precision);
+            next->linearModel = std::move(quantized);
+            updateScorer(*next);
+        }
+        publishModel(next);
+        return saveModel(outputPath, *next, accuracy);
+    }
+    
+    /**
+     * @brief Cross-validates a grid of linear model settings
+     * 
+     * Preprocessing does not depend on the fold, so every text is cleaned
+     * once. Each fold's vectorizer is fitted on the other folds only, and
+     * its features are kept for the whole grid. Every (setting, fold) pair
+     * is then trained as its own single-threaded task.
+     * 
+     * @param dataPath Path to labeled dataset file
+     * @param grid Values to search
+     * @return One result per setting, best macro F1 first
+     */
+    std::vector<TuningResult> tune(const std::string& dataPath, const TuningGrid& grid) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        
+        std::string labelColumn = config_.getString("label-column", "sentiment_label");
+        std::string textColumn = config_.getString("text-column", "tweet_text");
+        
+        utils::Dataset dataset;
+        if (!dataset.loadFromFile(dataPath, utils::Dataset::Format::AUTO, labelColumn, textColumn)) {
+            std::cerr << "Failed to load dataset from: " << dataPath << std::endl;
+            return {};
+        }
+        
+        size_t folds = static_cast<size_t>(std::max(2, config_.getInt("cv-folds", 5)));
+        if (dataset.size() < folds) {
+            std::cerr << "Dataset has fewer samples than cv-folds (" << folds << ")" << std::endl;
+            return {};
+        }
+        unsigned int seed = static_cast<unsigned int>(config_.getInt("seed", 42));
+        size_t threads = threads_.load(std::memory_order_relaxed);
+        
+        std::vector<size_t> foldOf = dataset.assignFolds(folds, true, seed);
+        std::span<const int> labels = dataset.labelColumn();
+        std::span<const std::string> rawTexts = dataset.textColumn();
+        std::vector<std::string> cleanedTexts(rawTexts.size());
+        utils::parallelFor(cleanedTexts.size(), threads, [&](size_t i) {
+            cleanedTexts[i] = textProcessor_->preprocess(rawTexts[i]);
+        });
+        
+        std::vector<FoldFeatures> foldFeatures(folds);
+        for (size_t fold = 0; fold < folds; ++fold) {
+            FoldFeatures& features = foldFeatures[fold];
+            std::vector<std::string> trainTexts;
+            std::vector<std::string> testTexts;
+            for (size_t i = 0; i < cleanedTexts.size(); ++i) {
+                if (foldOf[i] == fold) {
+                    testTexts.push_back(cleanedTexts[i]);
+                    features.testLabels.push_back(labels[i]);
+                } else {
+                    trainTexts.push_back(cleanedTexts[i]);
+                    features.trainLabels.push_back(labels[i]);
+                }
+            }
+            
+            std::unique_ptr<preprocessing::Vectorizer> vectorizer = makeVectorizer();
+            vectorizer->fit(trainTexts);
+            features.train = vectorizer->transformSparse(trainTexts);
+            features.test = vectorizer->transformSparse(testTexts);
+            features.numFeatures = vectorizer->getNumFeatures();
+        }
+        
+        std::vector<double> alphas = grid.alphas;
+        if (alphas.empty()) {
+            alphas.push_back(config_.getDouble("alpha", 0.0001));
+        }
+        std::vector<double> eta0s = grid.eta0s;
+        if (eta0s.empty()) {
+            eta0s.push_back(config_.getDouble("eta0", 0.01));
+        }
+        std::vector<int> epochCounts = grid.epochs;
+        if (epochCounts.empty()) {
+            epochCounts.push_back(config_.getInt("epochs", 10));
+        }
+        
+        std::vector<TuningResult> results;
+        for (double alpha : alphas) {
+            for (double eta0 : eta0s) {
+                for (int epochs : epochCounts) {
+                    TuningResult result;
+                    result.alpha = alpha;
+                    result.eta0 = eta0;
+                    result.epochs = epochs;
+                    results.push_back(std::move(result));
+                }
+            }
+        }
+        std::cout << "Cross-validating " << results.size() << " settings on " << folds << " folds of "
+                  << dataset.size() << " samples" << std::endl;
+        
+        // Tasks already fill the workers, so each model trains on one thread
+        // with the batch size train would use
+        models::LinearModel::TrainingOptions options = makeTrainingOptions(false);
+        options.threads = 1;
+        
+        std::vector<std::vector<int>> predictions(results.size() * folds);
+        utils::parallelFor(predictions.size(), threads, [&](size_t task) {
+            const TuningResult& setting = results[task / folds];
+            const FoldFeatures& features = foldFeatures[task % folds];
+            models::LinearModel model("log", setting.alpha, setting.epochs, setting.eta0, seed);
+            model.setTrainingOptions(options);
+            model.fit(features.train, features.trainLabels, features.numFeatures);
+            predictions[task] = model.predict(features.test);
+        });
+        
+        for (size_t setting = 0; setting < results.size(); ++setting) {
+            std::vector<int> yTrue;
+            std::vector<int> yPred;
+            std::vector<double> accuracies;
+            for (size_t fold = 0; fold < folds; ++fold) {
+                const std::vector<int>& foldPredictions = predictions[setting * folds + fold];
+                const std::vector<int>& foldLabels = foldFeatures[fold].testLabels;
+                yTrue.insert(yTrue.end(), foldLabels.begin(), foldLabels.end());
+                yPred.insert(yPred.end(), foldPredictions.begin(), foldPredictions.end());
+                accuracies.push_back(evaluation::Metrics::calculateMetrics(foldLabels, foldPredictions)["accuracy"]);
+            }
+            
+            double mean = 0.0;
+            for (double accuracy : accuracies) {
+                mean += accuracy;
+            }
+            mean /= static_cast<double>(accuracies.size());
+            double variance = 0.0;
+            for (double accuracy : accuracies) {
+                variance += (accuracy - mean) * (accuracy - mean);
+            }
+            
+            results[setting].metrics = evaluation::Metrics::calculateMetrics(yTrue, yPred);
+            results[setting].accuracyStdDev = std::sqrt(variance / static_cast<double>(accuracies.size()));
+        }
+        
+        std::stable_sort(results.begin(), results.end(), [](const TuningResult& a, const TuningResult& b) {
+            return a.metrics.at("macro_f1") > b.metrics.at("macro_f1");
+        });
+        return results;
+    }
+    
+    /**
+     * @brief Writes the trained model, vectorizer, bundle and model info
+     * @param outputPath Directory to save into (nothing is saved if empty)
+     * @param snapshot Snapshot holding the trained model
+     * @param accuracy Test accuracy recorded in the model info (unknown for updated models)
+     * @return True if everything was saved
+     */
+    bool saveModel(const std::string& outputPath, const ModelSnapshot& snapshot, std::optional<double> accuracy) const {
+        double alpha = config_.getDouble("alpha", 0.0001);
+        double eta0 = config_.getDouble("eta0", 0.01);
+        int epochs = config_.getInt("epochs", 10);
+        const preprocessing::Vectorizer& vectorizer = *snapshot.vectorizer;
+        bool hashedFeatures = dynamic_cast<const preprocessing::HashingVectorizer*>(&vectorizer) != nullptr;
+        
+        // Save model and vectorizer
+        if (!outputPath.empty()) {
+            // Create directory if it doesn't exist
+            std::filesystem::create_directories(outputPath);
+            
+            // Save model
+            std::string modelPath = outputPath + "/model.bin";
+            bool modelSaved = false;
+            if (snapshot.linearModel) {
+                modelSaved = snapshot.linearModel->save(modelPath);
+            } else if (snapshot.mlpModel) {
+                modelSaved = snapshot.mlpModel->save(modelPath);
+            } else {
+                modelSaved = snapshot.model->save(modelPath);
+            }
+            if (!modelSaved) {
+                std::cerr << "Failed to save model to: " << modelPath << std::endl;
+                return false;
+            }
+            
+            // Save vectorizer
+            std::string vectorizerPath = outputPath + "/vectorizer.bin";
+            if (!vectorizer.save(vectorizerPath)) {
+                std::cerr << "Failed to save vectorizer to: " << vectorizerPath << std::endl;
+                return false;
+            }
+            
+            // Save the bundle that loadModel() prefers
+            utils::BundleWriter bundle;
+            vectorizer.writeBundle(bundle);
+            if (snapshot.linearModel) {
+                snapshot.linearModel->writeBundle(bundle);
+            } else if (snapshot.mlpModel) {
+                snapshot.mlpModel->writeBundle(bundle);
+            } else if (snapshot.scorer) {
+                // Cache the probed weights so loading skips the probe
+                snapshot.scorer->writeBundle(bundle);
+            }
+            std::string bundlePath = outputPath + "/model.bpi";
+            if (!bundle.write(bundlePath)) {
+                std::cerr << "Failed to save model bundle to: " << bundlePath << std::endl;
+                return false;
+            }
+            
+            // Save model info
+            std::string infoPath = outputPath + "/model_info.txt";
+            std::ofstream infoFile(infoPath);
+            if (infoFile.is_open()) {
+                infoFile << "Model Type: " << modelTypeName(snapshot) << "\n";
+                if (snapshot.linearModel && snapshot.linearModel->getWeightPrecision() != models::WeightPrecision::Double) {
+                    infoFile << "Weight Precision: "
+                             << models::weightPrecisionName(snapshot.linearModel->getWeightPrecision()) << "\n";
+                }
+                infoFile << "Training Date: " << getCurrentDateString() << "\n";
+                if (accuracy) {
+                    infoFile << "Accuracy: " << *accuracy << "\n";
+                }
+                infoFile << "Parameters:\n";
+                infoFile << "  alpha: " << alpha << "\n";
+                infoFile << "  eta0: " << eta0 << "\n";
+                infoFile << "  epochs: " << epochs << "\n";
+                infoFile << "  vectorizer: " << (hashedFeatures ? "hashing" : "tfidf") << "\n";
+                infoFile << "  vocabulary size: " << vectorizer.getNumFeatures() << "\n";
+                infoFile.close();
+            }
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief Generates a word cloud visualization
+     * @param analysisResults Analysis results to visualize
+     * @param outputPath Path to save the visualization
+     * @param harmfulOnly Whether to include only harmful content
+     * @return True if generation was successful
+     */
+    bool generateVisualization(
+        const std::vector<AnalysisResult>& analysisResults,
+        const std::string& outputPath,
+        bool harmfulOnly = true) {
+        
+        // Configure word cloud
+        utils::CloudConfig config;
+        config.maxWords = 50;
+        config.width = 80;
+        config.height = 20;
+        config.useColor = true;
+        config.showFrequencies = true;
+        
+        return generateCustomVisualization(analysisResults, outputPath, harmfulOnly, config);
+    }
+    
+    /**
+     * @brief Generates a word cloud visualization with custom config
+     * @param analysisResults Analysis results to visualize
+     * @param outputPath Path to save the visualization
+     * @param harmfulOnly Whether to include only harmful content
+     * @param config Custom configuration for the visualization
+     * @return True if generation was successful
+     */
+    bool generateCustomVisualization(
+        const std::vector<AnalysisResult>& analysisResults,
+        const std::string& outputPath,
+        bool harmfulOnly,
+        const utils::CloudConfig& config) {
+        
+        // Count words straight from the results, on the batch scoring threads
+        utils::CloudAggregator aggregator(harmfulOnly, 0, threads_.load(std::memory_order_relaxed));
+        aggregator.add(std::span{analysisResults});
+        
+        if (aggregator.getTextCount() == 0) {
+            std::cerr << "No content to visualize." << std::endl;
+            return false;
+        }
+        
+        std::cout << "Generating visualization for " << aggregator.getTextCount() << " texts..." << std::endl;
+        
+        // Generate word cloud with passed configuration
+        std::string cloud = aggregator.render(config);
+        
+        // Save to file if path provided
+        if (!outputPath.empty()) {
+            return utils::WordCloud::saveWordCloud(cloud, outputPath);
+        }
+        
+        // Otherwise, display to console
+        std::cout << cloud << std::endl;
+        return true;
+    }
+    
+    /**
+     * @brief Gets the current configuration
+     * @return Map of configuration key-value pairs
+     */
+    std::unordered_map<std::string, std::string> getConfig() const {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        return config_.getAll();
+    }
+    
+    /**
+     * @brief Sets a configuration parameter
+     * @param key Parameter name
+     * @param value Parameter value
+     */
+    void setConfig(const std::string& key, const std::string& value) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        config_.set(key, value);
+        
+        // Apply any configuration changes that affect components
+        applyConfig();
+    }
+    
+    /**
+     * @brief Sets several configuration parameters, applying them once
+     * @param values Parameter names and values
+     */
+    void setConfig(const std::unordered_map<std::string, std::string>& values) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        for (const auto& [key, value] : values) {
+            config_.set(key, value);
+        }
+        applyConfig();
+    }
+    
+    /**
+     * @brief Loads configuration from a file
+     * @param configPath Path to the configuration file
+     * @return True if loading was successful
+     */
+    bool loadConfig(const std::string& configPath) {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        bool success = config_.loadFromFile(configPath);
+        if (success) {
+            applyConfig();
+        }
+        return success;
+    }
+
+private:
+    Config config_;                                ///< Configuration manager
+    std::shared_ptr<const preprocessing::TextProcessor> textProcessor_; ///< Processor for training and new snapshots
+    std::atomic<size_t> threads_;                  ///< Worker threads for batch scoring
+    AnalyzerSettings settings_;                    ///< Parsed configuration the components were built with
+    bool configApplied_ = false;                   ///< Whether settings_ has been applied once
+    std::shared_ptr<const ModelSnapshot> cascade_; ///< Loaded first-stage model attached to new snapshots
+    std::atomic<std::shared_ptr<const ModelSnapshot>> snapshot_; ///< Model that analyses use
+    mutable std::mutex updateMutex_;               ///< Serializes configuration, loading and training (never taken by analysis)
+    mutable utils::StatsRecorder stats_;           ///< Latency and throughput counters
+    
+    /// Upper bound on texts scored together by one worker
+    static constexpr size_t MAX_CHUNK_SIZE = 256;
+    
+    /**
+     * @brief Runs a function over chunks of a batch on the worker threads
+     * 
+     * Aims for a few chunks per worker so uneven texts balance out, while
+     * keeping chunks large enough to batch model calls.
+     * 
+     * @param size Number of texts in the batch
+     * @param function Called as function(begin, count) once per chunk
+     */
+    template <typename Function>
+    void forEachChunk(size_t size, Function&& function) const {
+        size_t threads = threads_.load(std::memory_order_relaxed);
+        size_t chunkSize = (size + threads * 4 - 1) / (threads * 4);
+        chunkSize = std::clamp<size_t>(chunkSize, 1, MAX_CHUNK_SIZE);
+        size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+        
+        utils::parallelFor(chunkCount, threads, [&](size_t chunk) {
+            size_t begin = chunk * chunkSize;
+            function(begin, std::min(chunkSize, size - begin));
+        });
+    }
+    
+    /**
+     * @brief Creates an empty snapshot with the current preprocessing settings
+     * @return Snapshot without a model
+     */
+    std::shared_ptr<ModelSnapshot> newSnapshot() const {
+        auto snapshot = std::make_shared<ModelSnapshot>();
+        snapshot->textProcessor = textProcessor_;
+        snapshot->fusedScoring = settings_.fusedScoring;
+        return snapshot;
+    }
+    
+    /**
+     * @brief Creates an empty result cache with the configured size and TTL
+     * @return New cache, or nullptr if caching is off
+     */
+    std::shared_ptr<AnalysisCache> makeResultCache() const {
+        if (settings_.resultCacheSize == 0) {
+            return nullptr;
+        }
+        return std::make_shared<AnalysisCache>(settings_.resultCacheSize, settings_.resultCacheTtl);
+    }
+    
+    /**
+     * @brief Creates an empty near-duplicate index with the configured size and similarity
+     * @return New index, or nullptr if the stage is off
+     */
+    std::shared_ptr<NearDuplicates> makeNearDuplicates() const {
+        if (settings_.nearDuplicateCapacity == 0) {
+            return nullptr;
+        }
+        return std::make_shared<NearDuplicates>(settings_.nearDuplicateCapacity, settings_.nearDuplicateSimilarity);
+    }
+    
+    /**
+     * @brief Makes a snapshot holding a new model the current one
+     * 
+     * Analyses that already took the previous snapshot finish on it. The
+     * caller must hold updateMutex_.
+     * 
+     * @param snapshot Fully built snapshot
+     */
+    void publishModel(const std::shared_ptr<ModelSnapshot>& snapshot) {
+        snapshot->version = snapshot_.load()->version + 1;
+        snapshot->resultCache = makeResultCache();
+        snapshot->nearDuplicates = makeNearDuplicates();
+        attachCascade(*snapshot);
+        snapshot_.store(snapshot);
+    }
+    
+    /**
+     * @brief Creates an unfitted vectorizer from the configured settings
+     * @return New vectorizer
+     */
+    std::unique_ptr<preprocessing::Vectorizer> makeVectorizer() const {
+        bool sublinearTf = config_.getBool("use-sublinear-tf", true);
+        double maxDf = config_.getDouble("max-df", 0.5);
+        int maxFeatures = config_.getInt("max-features", 10000);
+        int minNgram = config_.getInt("min-ngram", 1);
+        int maxNgram = config_.getInt("max-ngram", 2);
+        
+        std::unique_ptr<preprocessing::Vectorizer> vectorizer;
+        if (config_.getString("vectorizer", "tfidf") == "hashing") {
+            int hashBits = config_.getInt("hash-bits", 20);
+            bool signedHash = config_.getBool("hash-signed", true);
+            uint64_t seed = static_cast<uint64_t>(config_.getInt("seed", 42));
+            vectorizer = std::make_unique<preprocessing::HashingVectorizer>(
+                sublinearTf, hashBits, minNgram, maxNgram, signedHash, seed);
+        } else {
+            auto tfidf = std::make_unique<preprocessing::TfidfVectorizer>(
+                sublinearTf, maxDf, maxFeatures, minNgram, maxNgram);
+            tfidf->setMinDf(config_.getDouble("min-df", 1.0));
+            tfidf->setMaxPendingTerms(static_cast<size_t>(std::max(0, config_.getInt("max-pending-terms", 0))));
+            vectorizer = std::move(tfidf);
+        }
+        
+        // Counting document frequencies uses the same workers as scoring
+        vectorizer->setFitThreads(threads_.load(std::memory_order_relaxed));
+        return vectorizer;
+    }
+    
+    /**
+     * @brief Reads the mini-batch and early stopping settings of the linear model
+     * @param earlyStopping Whether to honor the early-stopping setting
+     * @return Training options
+     */
+    models::LinearModel::TrainingOptions makeTrainingOptions(bool earlyStopping) const {
+        models::LinearModel::TrainingOptions options;
+        options.threads = utils::resolveThreadCount(config_.getInt("train-threads", 1));
+        
+        // Multi-threaded training needs batches to split; 0 picks a size that does not depend on the thread count
+        int batchSize = config_.getInt("batch-size", 0);
+        options.batchSize = batchSize > 0 ? static_cast<size_t>(batchSize)
+                                          : (options.threads > 1 ? DEFAULT_TRAIN_BATCH_SIZE : 1);
+        
+        if (earlyStopping && config_.getBool("early-stopping", false)) {
+            double fraction = config_.getDouble("validation-fraction", 0.1);
+            if (fraction <= 0.0 || fraction >= 1.0) {
+                std::cerr << "Warning: validation-fraction must be between 0 and 1; using 0.1" << std::endl;
+                fraction = 0.1;
+            }
+            options.validationFraction = fraction;
+            options.patience = config_.getInt("n-iter-no-change", 5);
+            options.tolerance = config_.getDouble("tol", 0.0001);
+        }
+        
+        return options;
+    }
+    
+    /**
+     * @brief Creates an untrained dense-input classifier
+     * @param modelType "nn" for the neural network; anything else gives the SGD classifier
+     * @return New classifier
+     */
+    std::unique_ptr<models::Classifier> makeClassifier(const std::string& modelType) const {
+        double alpha = config_.getDouble("alpha", 0.0001);
+        double eta0 = config_.getDouble("eta0", 0.01);
+        int epochs = config_.getInt("epochs", 10);
+        
+        if (modelType == "nn") {
+            return std::make_unique<models::NeuralNetworkClassifier>(
+                config_.getInt("hidden-layers", 1), config_.getInt("hidden-size", 16), epochs, eta0);
+        }
+        
+        // Use SGD as default if model type is not recognized
+        return std::make_unique<models::SGDClassifier>("log", alpha, epochs, eta0);
+    }
+    
+    /**
+     * @brief Creates an untrained sparse-input network from the configured settings
+     * @return New network
+     */
+    std::unique_ptr<models::MlpModel> makeMlpModel() const {
+        auto model = std::make_unique<models::MlpModel>(
+            std::max(1, config_.getInt("hidden-layers", 1)),
+            std::max(1, config_.getInt("hidden-size", 16)),
+            config_.getInt("epochs", 10),
+            config_.getDouble("eta0", 0.01),
+            static_cast<unsigned int>(config_.getInt("seed", 42)));
+        model->setFloat32(config_.getBool("nn-float32", false));
+        return model;
+    }
+    
+    /**
+     * @brief Reads the precision trained linear weights are exported in
+     * @return Configured precision (double if the setting is not recognized)
+     */
+    models::WeightPrecision makeWeightPrecision() const {
+        std::string name = config_.getString("weight-precision", "double");
+        std::optional<models::WeightPrecision> precision = models::parseWeightPrecision(name);
+        if (!precision) {
+            std::cerr << "Warning: Unknown weight-precision '" << name << "'; using double" << std::endl;
+            return models::WeightPrecision::Double;
+        }
+        return *precision;
+    }
+    
+    /**
+     * @brief Predicts test labels the way a snapshot serves them
+     * @param snapshot Snapshot with a linear model
+     * @param cleanedTexts Preprocessed test texts
+     * @param features Sparse features of the same texts
+     * @return 0 (safe) or 1 (harmful) for each text
+     */
+    static std::vector<int> servedLabels(
+        const ModelSnapshot& snapshot,
+        const std::vector<std::string>& cleanedTexts,
+        const std::vector<preprocessing::SparseVector>& features
+    ) {
+        std::vector<int> labels(features.size());
+        if (snapshot.scorer) {
+            for (size_t i = 0; i < cleanedTexts.size(); ++i) {
+                labels[i] = snapshot.scorer->decision(cleanedTexts[i]) > 0.0 ? 1 : 0;
+            }
+        } else {
+            std::vector<double> scores = snapshot.linearModel->decisionFunction(features);
+            for (size_t i = 0; i < scores.size(); ++i) {
+                labels[i] = scores[i] > 0.0 ? 1 : 0;
+            }
+        }
+        return labels;
+    }
+    
+    /**
+     * @brief Replaces a snapshot's linear model with a quantized copy and reports the cost
+     * 
+     * Scores the test set before and after quantization through the path
+     * the snapshot serves with, and prints the change in accuracy and
+     * macro F1 from Metrics::calculateMetrics().
+     * 
+     * @param snapshot Snapshot with a trained linear model (not yet published)
+     * @param precision Export precision (not double)
+     * @param cleanedTexts Preprocessed test texts
+     * @param features Sparse features of the same texts
+     * @param labels True test labels
+     * @return Test accuracy of the quantized model
+     */
+    double quantizeForExport(
+        ModelSnapshot& snapshot,
+        models::WeightPrecision precision,
+        const std::vector<std::string>& cleanedTexts,
+        const std::vector<preprocessing::SparseVector>& features,
+        const std::vector<int>& labels
+    ) const {
+        std::vector<int> before = servedLabels(snapshot, cleanedTexts, features);
+        
+        auto quantized = std::make_unique<models::LinearModel>(*snapshot.linearModel);
+        quantized->setWeightPrecision(precision);
+        snapshot.linearModel = std::move(quantized);
+        updateScorer(snapshot);
+        
+        std::vector<int> after = servedLabels(snapshot, cleanedTexts, features);
+        
+        auto original = evaluation::Metrics::calculateMetrics(labels, before);
+        auto reduced = evaluation::Metrics::calculateMetrics(labels, after);
+        std::cout << "Quantized weights to " << models::weightPrecisionName(precision) << ": accuracy "
+                  << original["accuracy"] << " -> " << reduced["accuracy"] << " (delta "
+                  << reduced["accuracy"] - original["accuracy"] << "), macro F1 "
+                  << original["macro_f1"] << " -> " << reduced["macro_f1"] << " (delta "
+                  << reduced["macro_f1"] - original["macro_f1"] << ")" << std::endl;
+        
+        return reduced["accuracy"];
+    }
+    
+    /**
+     * @brief Removes the features a snapshot's linear model barely uses
+     * 
+     * Terms whose absolute weight is below the threshold are dropped from
+     * a copy of the TF-IDF vocabulary and the weights are renumbered to
+     * match, so the bundle, the term lookup and the fused scorer all
+     * shrink. The snapshot is left alone if nothing would be removed, if
+     * everything would be, or if its features are hashed.
+     * 
+     * @param snapshot Snapshot with a linear model (not yet published)
+     * @param threshold Smallest absolute weight a feature keeps
+     * @return Number of features removed
+     */
+    size_t compactSnapshot(ModelSnapshot& snapshot, double threshold) const {
+        auto* tfidf = dynamic_cast<const preprocessing::TfidfVectorizer*>(snapshot.vectorizer.get());
+        if (!tfidf) {
+            std::cerr << "Warning: Hashed features have no vocabulary to compact; keeping every bucket" << std::endl;
+            return 0;
+        }
+        
+        const std::vector<double>& weights = snapshot.linearModel->getWeights();
+        size_t original = weights.size();
+        std::vector<bool> keep(original);
+        size_t kept = 0;
+        for (size_t i = 0; i < original; ++i) {
+            keep[i] = std::abs(weights[i]) >= threshold;
+            kept += keep[i] ? 1 : 0;
+        }
+        if (kept == original) {
+            std::cout << "Every feature weighs at least " << threshold << "; nothing to compact" << std::endl;
+            return 0;
+        }
+        if (kept == 0) {
+            std::cerr << "Warning: Every feature weighs less than " << threshold << "; keeping the model as is" << std::endl;
+            return 0;
+        }
+        
+        auto vectorizer = std::make_shared<preprocessing::TfidfVectorizer>(*tfidf);
+        std::vector<int> newIndex = vectorizer->compact(keep);
+        auto linearModel = std::make_shared<models::LinearModel>(*snapshot.linearModel);
+        linearModel->compactFeatures(newIndex, kept);
+        snapshot.vectorizer = std::move(vectorizer);
+        snapshot.linearModel = std::move(linearModel);
+        updateScorer(snapshot);
+        
+        std::cout << "Compacted vocabulary from " << original << " to " << kept << " features (|weight| < "
+                  << threshold << " removed)" << std::endl;
+        return original - kept;
+    }
+    
+    /**
+     * @brief Compacts a snapshot's linear model and reports the cost
+     * 
+     * Scores the test set before and after compaction through the path
+     * the snapshot serves with, and prints the change in accuracy and
+     * macro F1 from Metrics::calculateMetrics().
+     * 
+     * @param snapshot Snapshot with a trained linear model (not yet published)
+     * @param threshold Smallest absolute weight a feature keeps
+     * @param cleanedTexts Preprocessed test texts
+     * @param features Sparse features of the same texts, replaced by the compacted ones
+     * @param labels True test labels
+     * @return Test accuracy of the compacted model
+     */
+    double compactForExport(
+        ModelSnapshot& snapshot,
+        double threshold,
+        const std::vector<std::string>& cleanedTexts,
+        std::vector<preprocessing::SparseVector>& features,
+        const std::vector<int>& labels
+    ) const {
+        std::vector<int> before = servedLabels(snapshot, cleanedTexts, features);
+        auto original = evaluation::Metrics::calculateMetrics(labels, before);
+        if (compactSnapshot(snapshot, threshold) == 0) {
+            return original["accuracy"];
+        }
+        
+        features = snapshot.vectorizer->transformSparse(cleanedTexts);
+        std::vector<int> after = servedLabels(snapshot, cleanedTexts, features);
+        
+        auto reduced = evaluation::Metrics::calculateMetrics(labels, after);
+        std::cout << "Compaction changed accuracy " << original["accuracy"] << " -> " << reduced["accuracy"]
+                  << " (delta " << reduced["accuracy"] - original["accuracy"] << "), macro F1 "
+                  << original["macro_f1"] << " -> " << reduced["macro_f1"] << " (delta "
+                  << reduced["macro_f1"] - original["macro_f1"] << ")" << std::endl;
+        
+        return reduced["accuracy"];
+    }
+    
+    /**
+     * @brief Describes the kind of model a snapshot holds
+     * @param snapshot Snapshot with a model
+     * @return Model type recorded in the model info
+     */
+    static std::string modelTypeName(const ModelSnapshot& snapshot) {
+        if (snapshot.linearModel) {
+            return "Linear Model (sparse SGD)";
+        }
+        if (snapshot.mlpModel) {
+            return "Neural Network (sparse input, " + std::to_string(snapshot.mlpModel->getHiddenLayers()) +
+                   " x " + std::to_string(snapshot.mlpModel->getHiddenSize()) + " hidden)";
+        }
+        if (dynamic_cast<const models::NeuralNetworkClassifier*>(snapshot.model.get())) {
+            return "Neural Network Classifier";
+        }
+        return "SGD Classifier";
+    }
+    
+    /**
+     * @brief Loads a model into a new snapshot and publishes it
+     * 
+     * The current model keeps serving while the files are read, and stays
+     * in place if loading fails. The caller must hold updateMutex_.
+     * 
+     * @param modelPath Path to the model directory
+     * @return True if loading was successful
+     */
+    bool loadModelLocked(const std::string& modelPath) {
+        StageClock clock;
+        std::shared_ptr<ModelSnapshot> next = newSnapshot();
+        if (!loadModelFiles(modelPath, *next)) {
+            return false;
+        }
+        publishModel(next);
+        if constexpr (STATS_ENABLED) {
+            stats_.recordModelLoad(clock.lap());
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Loads a trained model from disk
+     * @param modelPath Path to the model directory
+     * @param next Snapshot that receives the model and vectorizer
+     * @return True if loading was successful
+     */
+    bool loadModelFiles(const std::string& modelPath, ModelSnapshot& next) const {
+        // Prefer the single-file bundle; the separate files are kept for
+        // older builds and as a fallback
+        if (std::filesystem::exists(modelPath + "/model.bpi")) {
+            if (loadBundle(modelPath, next)) {
+                return true;
+            }
+            std::cerr << "Warning: Falling back to model.bin and vectorizer.bin in: " << modelPath << std::endl;
+        }
+        
+        std::string modelFilePath = modelPath + "/model.bin";
+        
+        // Sparse models carry their own file header; anything else is
+        // handed to the classifier named by the configuration
+        std::string modelType = config_.getString("model-type", "sgd");
+        if (models::LinearModel::isModelFile(modelFilePath)) {
+            modelType = "linear";
+        } else if (models::MlpModel::isModelFile(modelFilePath)) {
+            modelType = "mlp";
+        }
+        
+        bool modelLoaded = false;
+        next.model.reset();
+        next.linearModel.reset();
+        next.mlpModel.reset();
+        if (modelType == "linear") {
+            auto linearModel = std::make_unique<models::LinearModel>();
+            modelLoaded = linearModel->load(modelFilePath);
+            next.linearModel = std::move(linearModel);
+        } else if (modelType == "mlp") {
+            auto mlpModel = makeMlpModel();
+            modelLoaded = mlpModel->load(modelFilePath);
+            next.mlpModel = std::move(mlpModel);
+        } else {
+            auto model = makeClassifier(modelType);
+            modelLoaded = model->load(modelFilePath);
+            next.model = std::move(model);
+        }
+        
+        if (!modelLoaded) {
+            std::cerr << "Failed to load model from: " << modelFilePath << std::endl;
+            return false;
+        }
+        
+        // Try to load the vectorizer; the file says which kind it is
+        std::string vectorizerPath = modelPath + "/vectorizer.bin";
+        auto vectorizer = preprocessing::Vectorizer::loadFromFile(vectorizerPath);
+        
+        if (!vectorizer) {
+            std::cerr << "Failed to load vectorizer from: " << vectorizerPath << std::endl;
+            return false;
+        }
+        next.vectorizer = std::move(vectorizer);
+        updateScorer(next);
+        
+        return true;
+    }
+    
+    /**
+     * @brief Loads the model and vectorizer from a model bundle
+     * 
+     * Linear models and networks are stored in the bundle itself. Other
+     * classifiers keep their weights in model.bin, and only the vectorizer
+     * and the cached scorer weights come from the bundle.
+     * 
+     * @param modelPath Path to the model directory
+     * @param next Snapshot that receives the model and vectorizer
+     * @return True if loading was successful
+     */
+    bool loadBundle(const std::string& modelPath, ModelSnapshot& next) const {
+        std::string bundlePath = modelPath + "/model.bpi";
+        utils::BundleReader bundle;
+        if (!bundle.open(bundlePath)) {
+            return false;
+        }
+        
+        auto vectorizer = preprocessing::Vectorizer::loadFromBundle(bundle);
+        if (!vectorizer) {
+            std::cerr << "Failed to load vectorizer from: " << bundlePath << std::endl;
+            return false;
+        }
+        
+        if (bundle.hasSection("LMOD")) {
+            auto linearModel = std::make_unique<models::LinearModel>();
+            if (!linearModel->readBundle(bundle)) {
+                std::cerr << "Failed to load model from: " << bundlePath << std::endl;
+                return false;
+            }
+            next.linearModel = std::move(linearModel);
+            next.model.reset();
+            next.mlpModel.reset();
+        } else if (models::MlpModel::hasModel(bundle)) {
+            auto mlpModel = makeMlpModel();
+            if (!mlpModel->readBundle(bundle)) {
+                std::cerr << "Failed to load model from: " << bundlePath << std::endl;
+                return false;
+            }
+            next.mlpModel = std::move(mlpModel);
+            next.model.reset();
+            next.linearModel.reset();
+        } else {
+            std::string modelFilePath = modelPath + "/model.bin";
+            auto model = makeClassifier(config_.getString("model-type", "sgd"));
+            if (!model->load(modelFilePath)) {
+                std::cerr << "Failed to load model from: " << modelFilePath << std::endl;
+                return false;
+            }
+            next.model = std::move(model);
+            next.linearModel.reset();
+            next.mlpModel.reset();
+        }
+        
+        next.vectorizer = std::move(vectorizer);
+        next.fusedScoring = settings_.fusedScoring;
+        next.scorer.reset();
+        if (settings_.fusedScoring && next.model) {
+            auto scorer = std::make_shared<models::LinearScorer>();
+            if (scorer->readBundle(bundle, *next.vectorizer)) {
+                next.scorer = std::move(scorer);
+                return true;
+            }
+        }
+        updateScorer(next);
+        return true;
+    }
+    
+    /**
+     * @brief Rebuilds the fused scorer for a snapshot's model and vectorizer
+     * 
+     * Linear models hand over their weights directly, and a quantized model
+     * gets a scorer with folded weights in the same precision. Other classifiers are
+     * probed, and keep the dense scoring path if they turn out not to be
+     * linear.
+     * 
+     * @param snapshot Snapshot to update (not yet published)
+     */
+    void updateScorer(ModelSnapshot& snapshot) const {
+        snapshot.scorer.reset();
+        snapshot.fusedScoring = settings_.fusedScoring;
+        if (!settings_.fusedScoring || !snapshot.vectorizer) {
+            return;
+        }
         
-        // Split data for training and testing
-        dataset.splitTrainTest(0.2);
+        auto scorer = std::make_shared<models::LinearScorer>();
+        if (snapshot.linearModel) {
+            scorer->build(*snapshot.vectorizer, snapshot.linearModel->getWeights(), snapshot.linearModel->getBias(),
+                          snapshot.linearModel->getWeightPrecision());
+        } else if (snapshot.model) {
+            std::vector<double> weights;
+            double bias = 0.0;
+            if (models::LinearScorer::extractWeights(*snapshot.model, snapshot.vectorizer->getNumFeatures(), weights, bias)) {
+                scorer->build(*snapshot.vectorizer, weights, bias);
+            }
+        }
+        if (scorer->isReady()) {
+            snapshot.scorer = std::move(scorer);
+        }
+    }
+    
+    /**
+     * @brief Throws if no model has been trained or loaded
+     * @param snapshot Snapshot about to be used
+     * @throws std::runtime_error If no model is available
+     */
+    static void requireModel(const ModelSnapshot& snapshot) {
+        if (!snapshot.hasModel()) {
+            throw std::runtime_error("No model loaded. Call loadModel() first.");
+        }
+    }
+    
+    /**
+     * @brief Analyzes a contiguous chunk of texts
+     * 
+     * Only reads the snapshot, so chunks can run on different threads.
+     * With a result cache, exact repeats are not preprocessed again and
+     * texts whose cleaned form was analyzed before are answered from the
+     * cache; only the rest are scored. With near-duplicate clustering,
+     * texts close to one scored before, in this chunk or an earlier call,
+     * take its result and only the first text of each cluster is scored.
+     * With a cascade, the first-stage
+     * model scores them first and only the texts it is unsure about are
+     * scored by the full model. Intermediates live in a scratch arena
+     * released when the chunk is done; only the parts handed out in the
+     * results are allocated on the heap.
+     * 
+     * @param snapshot Model to score with
+     * @param texts Texts to analyze
+     * @param results Output array with one slot per text
+     * @param fields AnalysisResult::Field bits to fill in
+     */
+    void analyzeChunk(
+        const ModelSnapshot& snapshot,
+        std::span<const std::string_view> texts,
+        AnalysisResult* results,
+        uint32_t fields) const {
         
-        // Get training data
-        auto trainData = dataset.getTrainData();
-        auto trainTexts = dataset.getTrainTexts();
-        auto trainLabels = dataset.getTrainLabels();
+        // Key terms are needed for themselves and inside the explanation
+        bool wantTerms = (fields & (AnalysisResult::KEY_TERMS | AnalysisResult::EXPLANATION)) != 0;
+        StageClock clock;
+        utils::ScratchArena arena;
         
-        // Preprocess texts
-        std::vector<std::string> cleanedTexts;
-        cleanedTexts.reserve(trainTexts.size());
+        // Reused across chunks on the same thread; cleaned texts are copied into the arena
+        thread_local std::string cleaned;
         
-        for (const auto& text : trainTexts) {
-            cleanedTexts.push_back(textProcessor_.preprocess(text));
+        AnalysisCache* cache = snapshot.resultCache.get();
+        std::pmr::vector<std::pmr::string> cleanedTexts(arena.resource());
+        cleanedTexts.reserve(texts.size());
+        size_t preprocessed = 0;
+        for (const auto& text : texts) {
+            if (!cache || !cache->cleanedTexts.find(text, cleaned)) {
+                snapshot.textProcessor->preprocessInto(text, cleaned);
+                ++preprocessed;
+                if (cache) {
+                    cache->cleanedTexts.insert(text, cleaned);
+                }
+            }
+            cleanedTexts.emplace_back(cleaned);
         }
+        recordStage(utils::Stage::Preprocess, clock.lap(), preprocessed);
         
-        // Extract features
-        vectorizer_.fit(cleanedTexts);
-        std::vector<std::vector<double>> features = vectorizer_.transform(cleanedTexts);
-        
-        // Create and train model
-        double alpha = config_.getDouble("alpha", 0.0001);
-        double eta0 = config_.getDouble("eta0", 0.01);
-        int epochs = config_.getInt("epochs", 10);
-        
-        model_ = std::make_unique<models::SGDClassifier>("log", alpha, epochs, eta0);
-        model_->fit(features, trainLabels);
+        size_t bytes = 0;
+        for (const auto& text : texts) {
+            bytes += text.size();
+        }
         
-        // Evaluate model on test data
-        auto testTexts = dataset.getTestTexts();
-        auto testLabels = dataset.getTestLabels();
+        // Texts still to score, and their cleaned forms moved to the front of cleanedTexts
+        std::pmr::vector<size_t> pending(arena.resource());
+        pending.reserve(texts.size());
+        AnalysisResult cached;
+        for (size_t i = 0; i < texts.size(); ++i) {
+            // Entries cached by a leaner call cannot answer a fuller one
+            if (cache && cache->results.find(cleanedTexts[i], cached) &&
+                (cached.fields & fields) == (fields & ~AnalysisResult::TEXT)) {
+                results[i] = std::move(cached);
+                if (fields & AnalysisResult::TEXT) {
+                    results[i].text = texts[i];
+                    results[i].fields |= AnalysisResult::TEXT;
+                }
+                if (snapshot.nearDuplicates && results[i].cluster != 0) {
+                    snapshot.nearDuplicates->addMembers(results[i].cluster, 1);
+                }
+                dropUnrequested(results[i], fields);
+                continue;
+            }
+            if (pending.size() != i) {
+                cleanedTexts[pending.size()] = std::move(cleanedTexts[i]);
+            }
+            // Only groupNearDuplicates() puts a scored text in a cluster
+            results[i].cluster = 0;
+            pending.push_back(i);
+        }
+        cleanedTexts.resize(pending.size());
+        if constexpr (STATS_ENABLED) {
+            if (cache) {
+                stats_.recordCache(texts.size() - pending.size(), pending.size());
+            }
+        }
         
-        std::vector<std::string> cleanedTestTexts;
-        cleanedTestTexts.reserve(testTexts.size());
+        // Texts still to score, as positions in pending and cleanedTexts
+        std::pmr::vector<size_t> rows(arena.resource());
+        NearDuplicates* nearDuplicates = snapshot.nearDuplicates.get();
+        std::pmr::vector<ClusterStart> clusterStarts(arena.resource());
+        std::pmr::vector<std::pair<size_t, size_t>> followers(arena.resource());
+        if (nearDuplicates) {
+            groupNearDuplicates(*nearDuplicates, texts, results, pending, cleanedTexts, fields,
+                                rows, clusterStarts, followers);
+        } else {
+            rows.resize(pending.size());
+            std::iota(rows.begin(), rows.end(), size_t{0});
+        }
+        ScoredRows scored(arena.resource());
         
-        for (const auto& text : testTexts) {
-            cleanedTestTexts.push_back(textProcessor_.preprocess(text));
+        // A cheap first stage answers confident texts; the uncertain rest go on
+        if (snapshot.firstStage && !rows.empty()) {
+            scoreRows(*snapshot.firstStage, cleanedTexts, rows, wantTerms, utils::Stage::Cascade, scored);
+            std::pmr::vector<size_t> exited(arena.resource());
+            std::pmr::vector<size_t> uncertain(arena.resource());
+            ScoredRows exits(arena.resource());
+            for (size_t j = 0; j < rows.size(); ++j) {
+                double probability = scored.probs[j];
+                if (probability < snapshot.cascadeLow || probability > snapshot.cascadeHigh) {
+                    exited.push_back(rows[j]);
+                    exits.append(scored, j);
+                } else {
+                    uncertain.push_back(rows[j]);
+                }
+            }
+            finishRows(texts, results, pending, cleanedTexts, exited, exits, fields, cache);
+            if constexpr (STATS_ENABLED) {
+                stats_.recordCascade(rows.size(), exited.size());
+            }
+            rows = std::move(uncertain);
+            scored.clear();
         }
         
-        std::vector<std::vector<double>> testFeatures = vectorizer_.transform(cleanedTestTexts);
-        double accuracy = model_->score(testFeatures, testLabels);
+        if (!rows.empty()) {
+            scoreRows(snapshot, cleanedTexts, rows, wantTerms, utils::Stage::Score, scored);
+            finishRows(texts, results, pending, cleanedTexts, rows, scored, fields, cache);
+        }
+        if (nearDuplicates) {
+            finishNearDuplicates(*nearDuplicates, texts, results, pending, cleanedTexts, fields,
+                                 clusterStarts, followers);
+        }
+        if constexpr (STATS_ENABLED) {
+            stats_.recordDocuments(texts.size(), bytes);
+        }
+    }
+    
+    /**
+     * @brief A text scored for its group of near duplicates in a chunk
+     */
+    struct ClusterStart {
+        size_t position;                    ///< Position in pending and cleanedTexts
+        utils::MinHashSignature signature;  ///< Signature of the text
+        uint64_t cluster;                   ///< Index cluster whose leaner result the group replaces (0 = none)
+        uint64_t counted;                   ///< Texts of the group the index already counted as members
+    };
+    
+    /**
+     * @brief Answers near duplicates of earlier texts and picks the texts to score
+     * 
+     * A text close to a cluster in the index takes its result. Among the
+     * rest, the first text of each group of near duplicates in the chunk
+     * starts a cluster and is scored; the others follow it and get its
+     * result once it is scored. A hit on a result from a leaner call is
+     * grouped the same way, and its group's result later replaces the
+     * leaner one. Texts too short for a signature are scored as usual.
+     * 
+     * @param nearDuplicates Index of the snapshot
+     * @param texts Texts of the chunk
+     * @param results Output array of the chunk
+     * @param pending Result slot of each position in cleanedTexts
+     * @param cleanedTexts Cleaned texts of the chunk
+     * @param fields AnalysisResult::Field bits to fill in
+     * @param rows Receives the positions to score
+     * @param clusterStarts Receives the texts scored for their groups
+     * @param followers Receives pairs of a position and the position it follows
+     */
+    void groupNearDuplicates(
+        NearDuplicates& nearDuplicates,
+        std::span<const std::string_view> texts,
+        AnalysisResult* results,
+        std::span<const size_t> pending,
+        const std::pmr::vector<std::pmr::string>& cleanedTexts,
+        uint32_t fields,
+        std::pmr::vector<size_t>& rows,
+        std::pmr::vector<ClusterStart>& clusterStarts,
+        std::pmr::vector<std::pair<size_t, size_t>>& followers) const {
         
-        std::cout << "Model training complete. Test accuracy: " << accuracy << std::endl;
+        StageClock clock;
+        uint32_t sharedFields = fields & ~(AnalysisResult::TEXT | AnalysisResult::CLEANED_TEXT);
         
-        // Save model and vectorizer
-        if (!outputPath.empty()) {
-            // Create directory if it doesn't exist
-            std::filesystem::create_directories(outputPath);
-            
-            // Save model
-            std::string modelPath = outputPath + "/model.bin";
-            if (!model_->save(modelPath)) {
-                std::cerr << "Failed to save model to: " << modelPath << std::endl;
-                return false;
+        // Groups of the chunk, keeping the index of their start in clusterStarts
+        utils::NearDuplicateIndex<size_t> chunkClusters(pending.size(), nearDuplicates.getThreshold());
+        utils::MinHashSignature signature;
+        AnalysisResult shared;
+        size_t checked = 0;
+        size_t reused = 0;
+        for (size_t p = 0; p < pending.size(); ++p) {
+            if (!nearDuplicateSignature(cleanedTexts[p], signature)) {
+                rows.push_back(p);
+                continue;
             }
+            ++checked;
             
-            // Save vectorizer
-            std::string vectorizerPath = outputPath + "/vectorizer.bin";
-            if (!vectorizer_.save(vectorizerPath)) {
-                std::cerr << "Failed to save vectorizer to: " << vectorizerPath << std::endl;
-                return false;
+            AnalysisResult& result = results[pending[p]];
+            uint64_t cluster = 0;
+            bool hit = nearDuplicates.find(signature, shared, cluster);
+            
+            // Cached by a leaner call: already counted in the cluster, but grouped and scored again
+            bool leaner = hit && (shared.fields & fields) != sharedFields;
+            if (hit && !leaner) {
+                result = shared;
+                result.cluster = cluster;
+                if (fields & AnalysisResult::TEXT) {
+                    result.text = texts[pending[p]];
+                    result.fields |= AnalysisResult::TEXT;
+                }
+                if (fields & AnalysisResult::CLEANED_TEXT) {
+                    result.cleanedText.assign(cleanedTexts[p]);
+                    result.fields |= AnalysisResult::CLEANED_TEXT;
+                }
+                dropUnrequested(result, fields);
+                ++reused;
+                continue;
             }
             
-            // Save model info
-            std::string infoPath = outputPath + "/model_info.txt";
-            std::ofstream infoFile(infoPath);
-            if (infoFile.is_open()) {
-                infoFile << "Model Type: SGD Classifier\n";
-                infoFile << "Training Date: " << getCurrentDateString() << "\n";
-                infoFile << "Accuracy: " << accuracy << "\n";
-                infoFile << "Parameters:\n";
-                infoFile << "  alpha: " << alpha << "\n";
-                infoFile << "  eta0: " << eta0 << "\n";
-                infoFile << "  epochs: " << epochs << "\n";
-                infoFile << "  vocabulary size: " << vectorizer_.getNumFeatures() << "\n";
-                infoFile.close();
+            size_t start = 0;
+            uint64_t chunkCluster = 0;
+            if (chunkClusters.find(signature, start, chunkCluster)) {
+                followers.emplace_back(p, clusterStarts[start].position);
+                clusterStarts[start].counted += leaner ? 1 : 0;
+                ++reused;
+                continue;
             }
+            chunkCluster = chunkClusters.insert(signature, clusterStarts.size());
+            // Set before scoring so the result cache keeps it for exact repeats
+            result.cluster = leaner ? cluster : chunkCluster;
+            clusterStarts.push_back(ClusterStart{p, signature, leaner ? cluster : 0, leaner ? 1u : 0u});
+            rows.push_back(p);
         }
         
-        return true;
+        recordStage(utils::Stage::NearDuplicates, clock.lap(), pending.size());
+        if constexpr (STATS_ENABLED) {
+            stats_.recordNearDuplicates(checked, reused);
+        }
     }
     
     /**
-     * @brief Generates a word cloud visualization
-     * @param analysisResults Analysis results to visualize
-     * @param outputPath Path to save the visualization
-     * @param harmfulOnly Whether to include only harmful content
-     * @return True if generation was successful
+     * @brief Adds the scored clusters of a chunk to the index and fills in their followers
+     * @param nearDuplicates Index of the snapshot
+     * @param texts Texts of the chunk
+     * @param results Output array of the chunk, with the cluster starts scored
+     * @param pending Result slot of each position in cleanedTexts
+     * @param cleanedTexts Cleaned texts of the chunk
+     * @param fields AnalysisResult::Field bits to fill in
+     * @param clusterStarts Texts scored for their groups
+     * @param followers Pairs of a position and the position it follows
      */
-    bool generateVisualization(
-        const std::vector<AnalysisResult>& analysisResults,
-        const std::string& outputPath,
-        bool harmfulOnly = true) {
+    void finishNearDuplicates(
+        NearDuplicates& nearDuplicates,
+        std::span<const std::string_view> texts,
+        AnalysisResult* results,
+        std::span<const size_t> pending,
+        const std::pmr::vector<std::pmr::string>& cleanedTexts,
+        uint32_t fields,
+        std::span<const ClusterStart> clusterStarts,
+        std::span<const std::pair<size_t, size_t>> followers) const {
         
-        // Extract texts based on filter
-        std::vector<std::string> textsToVisualize;
-        
-        for (const auto& result : analysisResults) {
-            if (!harmfulOnly || result.sentiment == "Harmful") {
-                textsToVisualize.push_back(result.cleanedText);
-            }
+        std::unordered_map<size_t, uint64_t> followerCounts;
+        for (const auto& [p, first] : followers) {
+            ++followerCounts[first];
         }
         
-        if (textsToVisualize.empty()) {
-            std::cerr << "No content to visualize." << std::endl;
-            return false;
+        for (const auto& start : clusterStarts) {
+            AnalysisResult& result = results[pending[start.position]];
+            AnalysisResult shared = result;
+            shared.text.clear();
+            shared.cleanedText.clear();
+            shared.fields &= ~(AnalysisResult::TEXT | AnalysisResult::CLEANED_TEXT);
+            
+            auto found = followerCounts.find(start.position);
+            uint64_t members = 1 + (found != followerCounts.end() ? found->second : 0);
+            
+            // The fuller result replaces the leaner one kept for the cluster, unless it was dropped meanwhile
+            if (start.cluster != 0 && nearDuplicates.update(start.cluster, shared, members - start.counted)) {
+                continue;
+            }
+            
+            // Another chunk may have started a close cluster meanwhile; the texts then join it
+            result.cluster = nearDuplicates.insert(start.signature, std::move(shared), members);
         }
         
-        std::cout << "Generating visualization for " << textsToVisualize.size() << " texts..." << std::endl;
-        
-        // Configure word cloud
-        utils::WordCloud wordCloud;
-        utils::CloudConfig config;
-        config.maxWords = 50;
-        config.width = 80;
-        config.height = 20;
-        config.useColor = true;
-        config.showFrequencies = true;
-        
-        // Generate word cloud
-        std::string cloud = wordCloud.generateCustomCloud(
-            textsToVisualize, config, harmfulOnly);
-        
-        // Save to file if path provided
-        if (!outputPath.empty()) {
-            return utils::WordCloud::saveWordCloud(cloud, outputPath);
+        for (const auto& [p, first] : followers) {
+            AnalysisResult& result = results[pending[p]];
+            result = results[pending[first]];
+            if (fields & AnalysisResult::TEXT) {
+                result.text = texts[pending[p]];
+            }
+            if (fields & AnalysisResult::CLEANED_TEXT) {
+                result.cleanedText.assign(cleanedTexts[p]);
+            }
         }
-        
-        // Otherwise, display to console
-        std::cout << cloud << std::endl;
-        return true;
     }
     
     /**
-     * @brief Generates a word cloud visualization with custom config
-     * @param analysisResults Analysis results to visualize
-     * @param outputPath Path to save the visualization
-     * @param harmfulOnly Whether to include only harmful content
-     * @param config Custom configuration for the visualization
-     * @return True if generation was successful
+     * @brief Scores and key terms of some of a chunk's texts, kept in its arena
      */
-    bool generateCustomVisualization(
-        const std::vector<AnalysisResult>& analysisResults,
-        const std::string& outputPath,
-        bool harmfulOnly,
-        const utils::CloudConfig& config) {
+    struct ScoredRows {
+        std::pmr::vector<double> scores;           ///< Decision scores, one per row
+        std::pmr::vector<double> probs;            ///< Harmful-class probabilities, one per row
+        std::pmr::vector<std::string_view> terms;  ///< Key terms of all rows, pointing into the cleaned texts
+        std::pmr::vector<size_t> termStarts;       ///< Row j's terms are terms[termStarts[j], termStarts[j + 1]) (empty = none picked)
         
-        // Extract texts based on filter
-        std::vector<std::string> textsToVisualize;
+        /**
+         * @brief Constructor
+         * @param resource Memory resource of the chunk
+         */
+        explicit ScoredRows(std::pmr::memory_resource* resource)
+            : scores(resource), probs(resource), terms(resource), termStarts(resource) {}
         
-        for (const auto& result : analysisResults) {
-            if (!harmfulOnly || result.sentiment == "Harmful") {
-                textsToVisualize.push_back(result.cleanedText);
+        /**
+         * @brief Copies one row of another set
+         * @param other Scored rows
+         * @param j Row to copy
+         */
+        void append(const ScoredRows& other, size_t j) {
+            scores.push_back(other.scores[j]);
+            probs.push_back(other.probs[j]);
+            if (!other.termStarts.empty()) {
+                if (termStarts.empty()) {
+                    termStarts.push_back(0);
+                }
+                terms.insert(terms.end(), other.terms.begin() + other.termStarts[j],
+                             other.terms.begin() + other.termStarts[j + 1]);
+                termStarts.push_back(terms.size());
             }
         }
         
-        if (textsToVisualize.empty()) {
-            std::cerr << "No content to visualize." << std::endl;
-            return false;
+        /**
+         * @brief Removes every row
+         */
+        void clear() {
+            scores.clear();
+            probs.clear();
+            terms.clear();
+            termStarts.clear();
         }
+    };
+    
+    /**
+     * @brief Scores some of a chunk's cleaned texts with one model
+     * @param snapshot Model to score with
+     * @param cleanedTexts Cleaned texts of the chunk
+     * @param rows Positions in cleanedTexts to score
+     * @param wantTerms Whether key terms are picked while scoring
+     * @param stage Stage the scoring time is recorded under
+     * @param scored Receives one entry per row
+     */
+    void scoreRows(
+        const ModelSnapshot& snapshot,
+        const std::pmr::vector<std::pmr::string>& cleanedTexts,
+        std::span<const size_t> rows,
+        bool wantTerms,
+        utils::Stage stage,
+        ScoredRows& scored) const {
         
-        std::cout << "Generating visualization for " << textsToVisualize.size() << " texts..." << std::endl;
-        
-        // Generate word cloud with passed configuration
-        utils::WordCloud wordCloud;
-        std::string cloud = wordCloud.generateCustomCloud(
-            textsToVisualize, config, harmfulOnly);
-        
-        // Save to file if path provided
-        if (!outputPath.empty()) {
-            return utils::WordCloud::saveWordCloud(cloud, outputPath);
+        StageClock clock;
+        scored.clear();
+        scored.scores.reserve(rows.size());
+        scored.probs.reserve(rows.size());
+        if (snapshot.scorer) {
+            // One pass over the matched terms, without building feature vectors; the
+            // terms with the largest weighted contributions are picked in the same pass
+            scored.termStarts.reserve(wantTerms ? rows.size() + 1 : 0);
+            thread_local std::vector<models::TermContribution> contributions;
+            preprocessing::TermCoverage coverage;
+            size_t termsSeen = 0;
+            size_t termsMatched = 0;
+            for (size_t row : rows) {
+                const std::pmr::string& cleanedText = cleanedTexts[row];
+                if (wantTerms) {
+                    scored.termStarts.push_back(scored.terms.size());
+                    scored.scores.push_back(snapshot.scorer->explain(cleanedText, MAX_KEY_TERMS, contributions,
+                                                                     STATS_ENABLED ? &coverage : nullptr));
+                    for (const auto& contribution : contributions) {
+                        scored.terms.push_back(contribution.term);
+                    }
+                } else {
+                    scored.scores.push_back(snapshot.scorer->decision(cleanedText, STATS_ENABLED ? &coverage : nullptr));
+                }
+                scored.probs.push_back(models::LinearScorer::logistic(scored.scores.back()));
+                termsSeen += coverage.terms;
+                termsMatched += coverage.matched;
+            }
+            if (wantTerms) {
+                scored.termStarts.push_back(scored.terms.size());
+            }
+            recordStage(stage, clock.lap(), rows.size());
+            if constexpr (STATS_ENABLED) {
+                stats_.recordTerms(termsSeen, termsMatched);
+            }
+            return;
         }
         
-        // Otherwise, display to console
-        std::cout << cloud << std::endl;
-        return true;
+        // Extract sparse features and score the rows at once
+        std::vector<std::string> documents;
+        documents.reserve(rows.size());
+        for (size_t row : rows) {
+            documents.emplace_back(cleanedTexts[row]);
+        }
+        std::vector<preprocessing::SparseVector> features = snapshot.vectorizer->transformSparse(documents);
+        recordStage(utils::Stage::Vectorize, clock.lap(), rows.size());
+        std::vector<double> scores;
+        std::vector<double> probs;
+        scoreFeatures(snapshot, features, scores, probs);
+        scored.scores.assign(scores.begin(), scores.end());
+        scored.probs.assign(probs.begin(), probs.end());
+        recordStage(stage, clock.lap(), rows.size());
     }
     
     /**
-     * @brief Gets the current configuration
-     * @return Map of configuration key-value pairs
+     * @brief Fills in the results of scored rows and caches them
+     * @param texts Texts of the chunk
+     * @param results Output array of the chunk
+     * @param pending Result slot of each position in cleanedTexts
+     * @param cleanedTexts Cleaned texts of the chunk
+     * @param rows Positions in cleanedTexts that were scored
+     * @param scored Scores and key terms, one entry per row
+     * @param fields AnalysisResult::Field bits to fill in
+     * @param cache Result cache of the snapshot (may be null)
      */
-    std::unordered_map<std::string, std::string> getConfig() const {
-        return config_.getAll();
+    void finishRows(
+        std::span<const std::string_view> texts,
+        AnalysisResult* results,
+        std::span<const size_t> pending,
+        const std::pmr::vector<std::pmr::string>& cleanedTexts,
+        std::span<const size_t> rows,
+        const ScoredRows& scored,
+        uint32_t fields,
+        AnalysisCache* cache) const {
+        
+        bool wantTerms = (fields & (AnalysisResult::KEY_TERMS | AnalysisResult::EXPLANATION)) != 0;
+        
+        // The cleaned text is only copied out when asked for or needed as a cache key
+        bool keepCleaned = cache || (fields & AnalysisResult::CLEANED_TEXT);
+        
+        StageClock clock;
+        uint64_t keyTermsNanos = 0;
+        uint64_t explanationNanos = 0;
+        for (size_t j = 0; j < rows.size(); ++j) {
+            size_t row = rows[j];
+            AnalysisResult& result = results[pending[row]];
+            if (fields & AnalysisResult::TEXT) {
+                result.text = texts[pending[row]];
+            }
+            if (keepCleaned) {
+                result.cleanedText.assign(cleanedTexts[row]);
+            }
+            result.harmScore = scored.scores[j];
+            result.confidence = scored.probs[j];
+            result.fields = fields | (keepCleaned ? AnalysisResult::CLEANED_TEXT : 0u) |
+                            (wantTerms ? AnalysisResult::KEY_TERMS : 0u);
+            
+            // Determine sentiment label
+            result.sentiment = (result.harmScore > 0.0) ? "Harmful" : "Safe";
+            
+            // Key terms come from the scoring pass when the model is linear
+            clock.lap();
+            if (!wantTerms) {
+                // Nothing to pick
+            } else if (scored.termStarts.empty()) {
+                result.keyTerms = extractKeyTerms(cleanedTexts[row], result.harmScore);
+            } else {
+                result.keyTerms.assign(scored.terms.begin() + scored.termStarts[j],
+                                       scored.terms.begin() + scored.termStarts[j + 1]);
+            }
+            keyTermsNanos += clock.lap();
+            
+            // Generate explanation
+            if (fields & AnalysisResult::EXPLANATION) {
+                result.explanation = result.makeExplanation();
+            }
+            explanationNanos += clock.lap();
+            
+            if (cache) {
+                // The raw text differs between near-duplicates, so it is filled in on each hit
+                AnalysisResult cached = result;
+                cached.text.clear();
+                cached.fields &= ~AnalysisResult::TEXT;
+                cache->results.insert(result.cleanedText, std::move(cached));
+            }
+            
+            // Parts only computed on the way to others are dropped
+            dropUnrequested(result, fields);
+        }
+        recordStage(utils::Stage::KeyTerms, keyTermsNanos, rows.size());
+        recordStage(utils::Stage::Explanation, explanationNanos, rows.size());
     }
     
     /**
-     * @brief Sets a configuration parameter
-     * @param key Parameter name
-     * @param value Parameter value
+     * @brief Records time spent in a stage when instrumentation is compiled in
+     * @param stage Stage
+     * @param nanos Time spent on the chunk
+     * @param documents Number of texts in the chunk
      */
-    void setConfig(const std::string& key, const std::string& value) {
-        config_.set(key, value);
-        
-        // Apply any configuration changes that affect components
-        applyConfig();
+    void recordStage(utils::Stage stage, uint64_t nanos, size_t documents) const {
+        if constexpr (STATS_ENABLED) {
+            stats_.recordStage(stage, nanos, documents);
+        }
     }
     
     /**
-     * @brief Loads configuration from a file
-     * @param configPath Path to the configuration file
-     * @return True if loading was successful
+     * @brief Scores sparse feature rows with the loaded model
+     * 
+     * The linear model and the network consume the sparse rows directly;
+     * classifiers that only take dense input get the rows expanded here.
+     * 
+     * @param snapshot Model to score with
+     * @param features Sparse feature rows
+     * @param scores Output decision scores
+     * @param probabilities Output harmful-class probabilities
      */
-    bool loadConfig(const std::string& configPath) {
-        bool success = config_.loadFromFile(configPath);
-        if (success) {
-            applyConfig();
+    void scoreFeatures(
+        const ModelSnapshot& snapshot,
+        const std::vector<preprocessing::SparseVector>& features,
+        std::vector<double>& scores,
+        std::vector<double>& probabilities) const {
+        
+        if (snapshot.linearModel) {
+            scores = snapshot.linearModel->decisionFunction(features);
+            probabilities = snapshot.linearModel->predictProbability(features);
+            return;
         }
-        return success;
+        
+        if (snapshot.mlpModel) {
+            // One forward pass; the probabilities follow from the scores
+            scores = snapshot.mlpModel->decisionFunction(features);
+            probabilities.resize(scores.size());
+            std::transform(scores.begin(), scores.end(), probabilities.begin(), models::LinearScorer::logistic);
+            return;
+        }
+        
+        auto dense = preprocessing::toDenseMatrix(features, snapshot.vectorizer->getNumFeatures());
+        scores = snapshot.model->decisionFunction(dense);
+        probabilities = snapshot.model->predictProbability(dense);
     }
-
-private:
-    Config config_;                                ///< Configuration manager
-    preprocessing::TextProcessor textProcessor_;   ///< Text preprocessing engine
-    preprocessing::TfidfVectorizer vectorizer_;    ///< Feature extraction engine
-    std::unique_ptr<models::Classifier> model_;    ///< Classification model
     
     /**
-     * @brief Extracts key terms that contributed to the classification
+     * @brief Picks key terms for models without per-feature weights
+     * 
+     * Linear models get their key terms from LinearScorer::explain(); other
+     * models (the neural network, dense classifiers) fall back to the first
+     * sufficiently long words.
+     * 
      * @param text Preprocessed text
      * @param score Model score - higher values indicate more harmful content
      * @return Vector of key terms
      */
-    std::vector<std::string> extractKeyTerms(const std::string& text, double score) {
-        // This is a simplified implementation
-        // In a real system, you would analyze feature coefficients
+    std::vector<std::string> extractKeyTerms(std::string_view text, double score) const {
         
         std::vector<std::string> terms;
-        std::stringstream ss(text);
-        std::string word;
         
         // Use score to adjust sensitivity for term selection
         // Higher scores (more harmful content) = more aggressive term inclusion
         double lengthThreshold = score > 0.5 ? 3.0 : 4.0;
         
-        while (ss >> word) {
+        size_t pos = 0;
+        while (pos < text.size()) {
+            // Split on whitespace like stream extraction does
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+            size_t start = pos;
+            while (pos < text.size() && !std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+            std::string_view word = text.substr(start, pos - start);
+            
             // Check if this word is long enough to be meaningful
             // More aggressive inclusion for higher harm scores
-            if (word.length() > lengthThreshold) {
-                terms.push_back(word);
+            if (!word.empty() && word.length() > lengthThreshold) {
+                terms.emplace_back(word);
                 
-                // Limit to top 5 terms
-                if (terms.size() >= 5) {
+                // Limit to the top terms
+                if (terms.size() >= MAX_KEY_TERMS) {
                     break;
                 }
             }
@@ -533,57 +2715,6 @@ private:
         return terms;
     }
     
-    /**
-     * @brief Generates an explanation of the sentiment classification
-     * @param score Model score
-     * @param confidence Model confidence
-     * @param keyTerms Key terms that contributed to classification
-     * @return Human-readable explanation
-     */
-    std::string generateExplanation(
-        double score, 
-        double confidence, 
-        const std::vector<std::string>& keyTerms) {
-        
-        std::stringstream explanation;
-        
-        // Determine sentiment description based on score
-        if (score > 0.5) {
-            explanation << "This content appears to be highly harmful";
-        } else if (score > 0.0) {
-            explanation << "This content may contain harmful elements";
-        } else if (score > -0.5) {
-            explanation << "This content appears to be mostly safe";
-        } else {
-            explanation << "This content appears to be safe";
-        }
-        
-        // Add confidence information
-        explanation << " (confidence: ";
-        if (confidence > 0.9) {
-            explanation << "very high";
-        } else if (confidence > 0.7) {
-            explanation << "high";
-        } else if (confidence > 0.5) {
-            explanation << "moderate";
-        } else {
-            explanation << "low";
-        }
-        explanation << ").";
-        
-        // Add key terms
-        if (!keyTerms.empty()) {
-            explanation << " Key terms detected: ";
-            for (size_t i = 0; i < keyTerms.size(); ++i) {
-                if (i > 0) explanation << ", ";
-                explanation << keyTerms[i];
-            }
-            explanation << ".";
-        }
-        
-        return explanation.str();
-    }
-    
     /**
      * @brief Gets the current date as a string
      * @return Current date string in YYYY-MM-DD HH:MM:SS format
@@ -620,19 +2751,34 @@ Analyzer::~Analyzer() = default;
 /**
  * @brief Analyzes text for harmful content
  * @param text Text to analyze
+ * @param fields AnalysisResult::Field bits to fill in
  * @return Analysis result
  */
-AnalysisResult Analyzer::analyze(const std::string& text) {
-    return pImpl->analyze(text);
+AnalysisResult Analyzer::analyze(const std::string& text, uint32_t fields) {
+    return pImpl->analyze(text, fields);
 }
 
 /**
  * @brief Analyzes multiple texts
  * @param texts Collection of texts to analyze
+ * @param fields AnalysisResult::Field bits to fill in
  * @return Vector of analysis results
  */
-std::vector<AnalysisResult> Analyzer::analyzeMultiple(const std::vector<std::string>& texts) {
-    return pImpl->analyzeMultiple(texts);
+std::vector<AnalysisResult> Analyzer::analyzeMultiple(const std::vector<std::string>& texts, uint32_t fields) {
+    return pImpl->analyzeMultiple(texts, fields);
+}
+
+/**
+ * @brief Scores texts held in caller-owned memory
+ * @param texts Texts to score
+ * @param scores Receives one decision score per text (empty = not wanted)
+ * @param probabilities Receives one harmful-class probability per text (empty = not wanted)
+ */
+void Analyzer::scoreBatch(
+    std::span<const std::string_view> texts,
+    std::span<double> scores,
+    std::span<double> probabilities) {
+    pImpl->scoreBatch(texts, scores, probabilities);
 }
 
 /**
@@ -644,6 +2790,54 @@ bool Analyzer::loadModel(const std::string& modelPath) {
     return pImpl->loadModel(modelPath);
 }
 
+/**
+ * @brief Gets the version of the model analyses currently use
+ * @return Model version
+ */
+uint64_t Analyzer::getModelVersion() const {
+    return pImpl->getModelVersion();
+}
+
+/**
+ * @brief Cross-validates a grid of linear model settings
+ * @param dataPath Path to labeled dataset file
+ * @param grid Values to search
+ * @return One result per setting, best macro F1 first
+ */
+std::vector<TuningResult> Analyzer::tune(const std::string& dataPath, const TuningGrid& grid) {
+    return pImpl->tune(dataPath, grid);
+}
+
+/**
+ * @brief Applies incremental training steps to the live model
+ * @param texts Raw texts
+ * @param labels Labels for each text
+ * @return True if the model was updated
+ */
+bool Analyzer::update(const std::vector<std::string>& texts, const std::vector<int>& labels) {
+    return pImpl->update(texts, labels);
+}
+
+/**
+ * @brief Saves the current model
+ * @param outputPath Directory to save into
+ * @return True if saving was successful
+ */
+bool Analyzer::saveModel(const std::string& outputPath) const {
+    return pImpl->saveModel(outputPath);
+}
+
+/**
+ * @brief Drops low-weight features from the current model and saves it
+ * @param outputPath Directory to save into
+ * @param threshold Smallest absolute weight a feature keeps
+ * @param dataPath Labeled dataset to measure the change on (may be empty)
+ * @return True if the model was compacted and saved
+ */
+bool Analyzer::compactModel(const std::string& outputPath, double threshold, const std::string& dataPath) {
+    return pImpl->compactModel(outputPath, threshold, dataPath);
+}
+
 /**
  * @brief Trains a new model from labeled data
  * @param dataPath Path to labeled dataset file
@@ -703,6 +2897,14 @@ void Analyzer::setConfig(const std::string& key, const std::string& value) {
     pImpl->setConfig(key, value);
 }
 
+/**
+ * @brief Sets several configuration parameters at once
+ * @param values Parameter names and values
+ */
+void Analyzer::setConfig(const std::unordered_map<std::string, std::string>& values) {
+    pImpl->setConfig(values);
+}
+
 /**
  * @brief Loads configuration from a file
  * @param configPath Path to the configuration file
@@ -712,4 +2914,28 @@ bool Analyzer::loadConfig(const std::string& configPath) {
     return pImpl->loadConfig(configPath);
 }
 
+/**
+ * @brief Gets per-stage latency and throughput counters
+ * @return Snapshot of the counters
+ */
+utils::AnalyzerStats Analyzer::getStats() const {
+    return pImpl->getStats();
+}
+
+/**
+ * @brief Resets the latency and throughput counters
+ */
+void Analyzer::resetStats() {
+    pImpl->resetStats();
+}
+
+/**
+ * @brief Lists the largest near-duplicate clusters of the current model
+ * @param maxClusters Largest number of clusters to return
+ * @return Pairs of cluster ID and member count, largest first
+ */
+std::vector<std::pair<uint64_t, uint64_t>> Analyzer::getNearDuplicateClusters(size_t maxClusters) const {
+    return pImpl->getNearDuplicateClusters(maxClusters);
+}
+
 } // namespace blahajpi
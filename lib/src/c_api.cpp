@@ -0,0 +1,162 @@
+/**
+ * @file c_api.cpp
+ * @brief Implementation of the C interface to the analyzer
+ */
+
+#include "blahajpi/c_api.h"
+#include "blahajpi/analyzer.hpp"
+#include <exception>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Analyzer behind a C handle
+ */
+struct bpi_analyzer {
+    blahajpi::Analyzer analyzer;  ///< Wrapped analyzer
+};
+
+namespace {
+
+/// Message of the last failed call on this thread
+thread_local std::string lastError;
+
+/**
+ * @brief Records an error for bpi_last_error()
+ * @param status Status to return
+ * @param message Error message
+ * @return status
+ */
+int fail(int status, std::string message) {
+    lastError = std::move(message);
+    return status;
+}
+
+/**
+ * @brief Runs a call, turning exceptions into status codes
+ * @param call Function returning a status
+ * @return Status of the call, or BPI_FAILED if it threw
+ */
+template <typename Call>
+int guarded(Call&& call) {
+    try {
+        return call();
+    } catch (const std::exception& e) {
+        return fail(BPI_FAILED, e.what());
+    } catch (...) {
+        return fail(BPI_FAILED, "Unknown error");
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t bpi_abi_version(void) {
+    return BPI_ABI_VERSION;
+}
+
+bpi_analyzer* bpi_create(const char* config_path) {
+    try {
+        auto handle = std::make_unique<bpi_analyzer>();
+        if (config_path && !handle->analyzer.loadConfig(config_path)) {
+            fail(BPI_FAILED, std::string("Failed to load configuration from ") + config_path);
+            return nullptr;
+        }
+        return handle.release();
+    } catch (const std::exception& e) {
+        fail(BPI_FAILED, e.what());
+        return nullptr;
+    } catch (...) {
+        fail(BPI_FAILED, "Unknown error");
+        return nullptr;
+    }
+}
+
+void bpi_destroy(bpi_analyzer* analyzer) {
+    delete analyzer;
+}
+
+int bpi_set_config(bpi_analyzer* analyzer, const char* key, const char* value) {
+    if (!analyzer || !key || !value) {
+        return fail(BPI_INVALID_ARGUMENT, "Analyzer, key and value must not be null");
+    }
+    return guarded([&]() -> int {
+        analyzer->analyzer.setConfig(key, value);
+        return BPI_OK;
+    });
+}
+
+int bpi_load_model(bpi_analyzer* analyzer, const char* model_path) {
+    if (!analyzer || !model_path) {
+        return fail(BPI_INVALID_ARGUMENT, "Analyzer and model path must not be null");
+    }
+    return guarded([&]() -> int {
+        if (!analyzer->analyzer.loadModel(model_path)) {
+            return fail(BPI_FAILED, std::string("Failed to load model from ") + model_path);
+        }
+        return BPI_OK;
+    });
+}
+
+uint64_t bpi_model_version(const bpi_analyzer* analyzer) {
+    return analyzer ? analyzer->analyzer.getModelVersion() : 0;
+}
+
+int bpi_score_batch(
+    bpi_analyzer* analyzer,
+    const char* data,
+    const uint64_t* offsets,
+    size_t count,
+    double* scores,
+    double* probabilities,
+    uint8_t* labels) {
+    if (!analyzer || !offsets || (!data && count > 0 && offsets[count] > offsets[0])) {
+        return fail(BPI_INVALID_ARGUMENT, "Analyzer, data and offsets must not be null");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            return fail(BPI_INVALID_ARGUMENT, "Offsets must not decrease (at " + std::to_string(i) + ")");
+        }
+    }
+    if (analyzer->analyzer.getModelVersion() == 0) {
+        return fail(BPI_NO_MODEL, "No model loaded");
+    }
+
+    return guarded([&]() -> int {
+        // Views and label scores live in per-thread buffers that keep their capacity between calls
+        thread_local std::vector<std::string_view> texts;
+        thread_local std::vector<double> labelScores;
+        texts.clear();
+        for (size_t i = 0; i < count; ++i) {
+            texts.emplace_back(data + offsets[i], static_cast<size_t>(offsets[i + 1] - offsets[i]));
+        }
+
+        double* scoreOutput = scores;
+        if (!scoreOutput && labels) {
+            labelScores.resize(count);
+            scoreOutput = labelScores.data();
+        }
+
+        analyzer->analyzer.scoreBatch(
+            texts,
+            scoreOutput ? std::span<double>(scoreOutput, count) : std::span<double>(),
+            probabilities ? std::span<double>(probabilities, count) : std::span<double>());
+
+        if (labels) {
+            for (size_t i = 0; i < count; ++i) {
+                labels[i] = scoreOutput[i] > 0.0 ? 1 : 0;
+            }
+        }
+        return BPI_OK;
+    });
+}
+
+const char* bpi_last_error(void) {
+    return lastError.c_str();
+}
+
+} // extern "C"
@@ -239,18 +239,35 @@ std::optional<std::pair<std::string, std::string>> Config::parseLine(const std::
 
 void Config::loadDefaults() {
     // Model settings
-    configValues["model-type"] = "sgd";             // SGD classifier by default
+    configValues["model-type"] = "sgd";             // SGD classifier by default ("linear", "nn" or "mlp" for the sparse network)
     configValues["alpha"] = "0.0001";               // Regularization strength
     configValues["eta0"] = "0.01";                  // Learning rate
     configValues["epochs"] = "10";                  // Number of training epochs
     configValues["loss"] = "log";                   // Loss function (log for logistic regression)
+    configValues["stream-batch-size"] = "0";        // Stream training data from disk in batches of this size (0 = load all)
+    configValues["train-threads"] = "1";            // Linear model training threads (0 = all hardware threads)
+    configValues["batch-size"] = "0";               // Samples per linear model update (0 = 1, or 512 with several threads)
+    configValues["early-stopping"] = "false";       // Stop linear model training when validation loss stalls
+    configValues["validation-fraction"] = "0.1";    // Training samples held out for early stopping
+    configValues["n-iter-no-change"] = "5";         // Epochs without improvement before stopping
+    configValues["tol"] = "0.0001";                 // Smallest validation loss decrease that counts as improvement
+    configValues["hidden-layers"] = "1";            // Hidden layers of the nn and mlp models
+    configValues["hidden-size"] = "16";             // Units per hidden layer
+    configValues["nn-float32"] = "false";           // Score the mlp model with float32 weights
+    configValues["weight-precision"] = "double";    // Export linear weights as double, float16 or int8
+    configValues["compact-threshold"] = "0";        // Drop features whose |weight| is below this after training (0 = keep all)
     
     // Feature extraction settings
     configValues["use-sublinear-tf"] = "true";      // Use sublinear scaling for term frequencies
     configValues["max-df"] = "0.5";                 // Maximum document frequency
+    configValues["min-df"] = "1";                   // Minimum document frequency (fraction below 1, count from 1)
     configValues["max-features"] = "10000";         // Maximum number of features
+    configValues["max-pending-terms"] = "0";        // Distinct terms counted before rare ones are pruned (0 = exact)
     configValues["min-ngram"] = "1";                // Minimum n-gram size
     configValues["max-ngram"] = "2";                // Maximum n-gram size
+    configValues["vectorizer"] = "tfidf";           // Feature extraction ("tfidf" or "hashing")
+    configValues["hash-bits"] = "20";               // Hashing vectorizer buckets (2^hash-bits)
+    configValues["hash-signed"] = "true";           // Hash the sign of each hashed feature
     
     // Text preprocessing settings
     configValues["preprocessing-pipeline"] = "remove_urls,remove_mentions,process_hashtags,lowercase,expand_abbreviations,handle_negations,remove_punctuation,remove_numbers,normalize_whitespace,remove_stopwords,normalize_repeated_chars";
@@ -258,6 +275,16 @@ void Config::loadDefaults() {
     // Analysis settings
     configValues["threshold"] = "0.5";              // Classification threshold
     configValues["confidence-scaling"] = "2.0";     // Scaling factor for confidence scores
+    configValues["threads"] = "0";                  // Batch scoring threads (0 = all hardware threads)
+    configValues["fused-scoring"] = "true";         // Score linear models without building feature vectors
+    configValues["result-cache-size"] = "0";        // Cached results for repeated messages (0 = off)
+    configValues["result-cache-ttl"] = "0";         // Seconds a cached result stays valid (0 = until the model changes)
+    configValues["cascade-model-dir"] = "";         // Cheap first-stage model tried before the full one (empty = off)
+    configValues["cascade-low"] = "0.1";            // First-stage probabilities below this are final (safe)
+    configValues["cascade-high"] = "0.9";           // First-stage probabilities above this are final (harmful)
+    configValues["near-duplicates"] = "false";      // Score one text per cluster of lightly edited copies
+    configValues["near-duplicate-similarity"] = "0.7"; // Share of terms two texts of one cluster have in common
+    configValues["near-duplicate-capacity"] = "10000"; // Clusters remembered between calls
     
     // Visualization settings
     configValues["word-cloud-max-words"] = "50";    // Maximum words in word cloud
@@ -268,6 +295,7 @@ void Config::loadDefaults() {
     // Path settings
     configValues["model-dir"] = "../models/default"; // Directory for model files
     configValues["output-dir"] = "../results";       // Directory for output files
+    configValues["feature-cache-dir"] = "";          // Reuse preprocessed training features from here (empty = off)
     
     // Dataset column settings
     configValues["label-column"] = "label";          // Default label column name
@@ -4,16 +4,206 @@
  */
 
 #include "blahajpi/evaluation/metrics.hpp"
+#include "blahajpi/utils/parallel.hpp"
 #include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <utility>
 
 namespace blahajpi {
 namespace evaluation {
 
+namespace {
+
+/// Smallest number of scores each sort worker gets; below it one thread sorts everything
+constexpr size_t MIN_SORT_CHUNK = 1 << 16;
+
+/**
+ * @brief Metric evaluated at a candidate threshold from its confusion counts
+ */
+using ThresholdMetric = double (*)(double tp, double fp, double tn, double fn);
+
+/**
+ * @brief Resolves a metric name once, before the sweep
+ * @param metric Metric name ("f1", "accuracy", "precision", "recall"; anything else means F1)
+ * @return Metric function
+ */
+ThresholdMetric resolveMetric(const std::string& metric) {
+    if (metric == "accuracy") {
+        return [](double tp, double fp, double tn, double fn) {
+            double total = tp + fp + tn + fn;
+            return total > 0 ? (tp + tn) / total : 0.0;
+        };
+    }
+    if (metric == "precision") {
+        return [](double tp, double fp, double, double) {
+            return tp + fp > 0 ? tp / (tp + fp) : 0.0;
+        };
+    }
+    if (metric == "recall") {
+        return [](double tp, double, double, double fn) {
+            return tp + fn > 0 ? tp / (tp + fn) : 0.0;
+        };
+    }
+    return [](double tp, double fp, double, double fn) {
+        double prec = tp + fp > 0 ? tp / (tp + fp) : 0.0;
+        double rec = tp + fn > 0 ? tp / (tp + fn) : 0.0;
+        return prec + rec > 0 ? 2.0 * prec * rec / (prec + rec) : 0.0;
+    };
+}
+
+/**
+ * @brief Sorts score/label pairs by decreasing score
+ * 
+ * Large inputs are split into chunks sorted by separate workers and then
+ * merged pairwise, each round of merges also running in parallel.
+ * 
+ * @param pairs Pairs to sort in place
+ * @param threads Number of worker threads
+ */
+void sortDescending(std::vector<std::pair<double, bool>>& pairs, size_t threads) {
+    auto byScore = [](const auto& a, const auto& b) { return a.first > b.first; };
+    size_t chunks = std::min(threads, pairs.size() / MIN_SORT_CHUNK);
+    if (chunks < 2) {
+        std::sort(pairs.begin(), pairs.end(), byScore);
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = pairs.size() * i / chunks;
+    }
+    utils::parallelFor(chunks, threads, [&](size_t chunk) {
+        std::sort(pairs.begin() + bounds[chunk], pairs.begin() + bounds[chunk + 1], byScore);
+    });
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        utils::parallelFor(merges, threads, [&](size_t merge) {
+            size_t first = merge * 2 * width;
+            size_t middle = std::min(first + width, chunks);
+            size_t last = std::min(first + 2 * width, chunks);
+            if (middle < last) {
+                std::inplace_merge(pairs.begin() + bounds[first], pairs.begin() + bounds[middle],
+                                   pairs.begin() + bounds[last], byScore);
+            }
+        });
+    }
+}
+
+/**
+ * @brief Accumulates ROC, precision-recall and threshold statistics in one pass
+ * 
+ * Groups of tied scores are added in decreasing score order. Each group is
+ * a candidate threshold evaluated with the counts of all strictly higher
+ * scores, the same convention findOptimalThreshold() always used.
+ */
+class CurveSweep {
+public:
+    /**
+     * @brief Constructor
+     * @param positives Total harmful samples
+     * @param negatives Total safe samples
+     * @param metric Metric to maximize
+     * @param keepCurve Whether precision-recall points are needed
+     */
+    CurveSweep(size_t positives, size_t negatives, ThresholdMetric metric, bool keepCurve)
+        : positives(positives), negatives(negatives), metric(metric), keepCurve(keepCurve) {}
+
+    /**
+     * @brief Adds a group of samples sharing one score
+     * @param score Score of the group
+     * @param pos Harmful samples in the group
+     * @param neg Safe samples in the group
+     */
+    void addGroup(double score, size_t pos, size_t neg) {
+        if (keepCurve) {
+            addPoint();
+        }
+
+        double value = metric(tp, fp, negatives - fp, positives - tp);
+        if (value > bestValue) {
+            bestValue = value;
+            bestThreshold = score;
+            bestTp = tp;
+            bestFp = fp;
+        }
+
+        // Trapezoid between this group's ROC points, in units of samples
+        area += static_cast<double>(neg) * (2.0 * tp + pos) / 2.0;
+        tp += pos;
+        fp += neg;
+    }
+
+    /**
+     * @brief Completes the curves
+     * @param recallLevels Recall levels at which to report precision
+     * @return Evaluation results
+     */
+    Evaluation finish(const std::vector<double>& recallLevels) {
+        Evaluation result;
+        if (positives > 0 && negatives > 0) {
+            result.auc = area / (static_cast<double>(positives) * negatives);
+        }
+
+        result.threshold = bestThreshold;
+        result.thresholdMetric = std::max(bestValue, 0.0);
+        int tpCount = static_cast<int>(bestTp);
+        int fpCount = static_cast<int>(bestFp);
+        int tnCount = static_cast<int>(negatives - bestFp);
+        int fnCount = static_cast<int>(positives - bestTp);
+        result.confusion = {{tnCount, fpCount}, {fnCount, tpCount}};
+        result.metrics = Metrics::calculateMetricsFromCounts(tnCount, fpCount, fnCount, tpCount);
+
+        if (positives == 0 || !keepCurve) {
+            return result;
+        }
+        addPoint();
+
+        // Interpolated precision is the best precision at any recall at least as high
+        for (size_t i = points.size() - 1; i-- > 0;) {
+            points[i].second = std::max(points[i].second, points[i + 1].second);
+        }
+        for (double target : recallLevels) {
+            auto it = std::lower_bound(points.begin(), points.end(), target,
+                                       [](const auto& point, double recall) { return point.first < recall; });
+            result.precisionAtRecall[target] = it != points.end() ? it->second : 0.0;
+        }
+        return result;
+    }
+
+private:
+    /**
+     * @brief Records the precision-recall point of the current counts
+     */
+    void addPoint() {
+        if (positives == 0) {
+            return;
+        }
+        double precision = tp > 0 ? static_cast<double>(tp) / (tp + fp) : 1.0;
+        points.emplace_back(static_cast<double>(tp) / positives, precision);
+    }
+
+    size_t positives;                                 ///< Total harmful samples
+    size_t negatives;                                 ///< Total safe samples
+    ThresholdMetric metric;                           ///< Metric to maximize
+    bool keepCurve;                                   ///< Whether points are recorded
+    size_t tp = 0;                                    ///< Harmful samples above the current group
+    size_t fp = 0;                                    ///< Safe samples above the current group
+    double area = 0.0;                                ///< Unnormalized ROC area
+    double bestValue = -1.0;                          ///< Best metric value so far
+    double bestThreshold = 0.0;                       ///< Threshold of the best value
+    size_t bestTp = 0;                                ///< True positives at the best threshold
+    size_t bestFp = 0;                                ///< False positives at the best threshold
+    std::vector<std::pair<double, double>> points;    ///< (recall, precision) in increasing recall
+};
+
+} // namespace
+
 std::vector<std::vector<int>> Metrics::confusionMatrix(
     const std::vector<int>& yTrue,
     const std::vector<int>& yPred
@@ -109,13 +299,10 @@ std::unordered_map<std::string, double> Metrics::calculateMetrics(
 ) {
     // Compute confusion matrix
     auto matrix = confusionMatrix(yTrue, yPred);
-    
-    // Get matrix values
-    int tn = matrix[0][0];  // True Negatives
-    int fp = matrix[0][1];  // False Positives
-    int fn = matrix[1][0];  // False Negatives
-    int tp = matrix[1][1];  // True Positives
-    
+    return calculateMetricsFromCounts(matrix[0][0], matrix[0][1], matrix[1][0], matrix[1][1]);
+}
+
+std::unordered_map<std::string, double> Metrics::calculateMetricsFromCounts(int tn, int fp, int fn, int tp) {
     // Calculate metrics
     double precSafe = precision(tn, fn);
     double precHarmful = precision(tp, fp);
@@ -158,61 +345,7 @@ double Metrics::areaUnderROC(
     const std::vector<int>& yTrue,
     const std::vector<double>& scores
 ) {
-    // Pair scores with truth for sorting
-    std::vector<std::pair<double, int>> scoreLabelPairs;
-    for (size_t i = 0; i < scores.size() && i < yTrue.size(); ++i) {
-        scoreLabelPairs.emplace_back(scores[i], yTrue[i]);
-    }
-    
-    // Sort by score in descending order
-    std::sort(scoreLabelPairs.begin(), scoreLabelPairs.end(),
-             [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Count positive and negative samples
-    int positiveCount = 0;
-    int negativeCount = 0;
-    
-    for (int label : yTrue) {
-        if (label != 0) {  // Assuming 0 is the negative class
-            positiveCount++;
-        } else {
-            negativeCount++;
-        }
-    }
-    
-    // If all samples are of the same class, AUC is not well-defined
-    if (positiveCount == 0 || negativeCount == 0) {
-        return 0.5;  // By convention
-    }
-    
-    // Compute AUC using the trapezoidal rule
-    double auc = 0.0;
-    double tpPrev = 0.0;
-    double fpPrev = 0.0;
-    double fpRate, tpRate;
-    
-    for (const auto& [score, label] : scoreLabelPairs) {
-        // Update true positive and false positive counts
-        if (label != 0) {  // Positive class
-            tpRate = (tpPrev + 1.0) / positiveCount;
-            fpRate = fpPrev / negativeCount;
-        } else {  // Negative class
-            tpRate = tpPrev / positiveCount;
-            fpRate = (fpPrev + 1.0) / negativeCount;
-        }
-        
-        // Add trapezoidal area
-        auc += (fpRate - fpPrev) * (tpRate + tpPrev) / 2.0;
-        
-        // Update counters for next iteration
-        if (label != 0) {
-            tpPrev += 1.0;
-        } else {
-            fpPrev += 1.0;
-        }
-    }
-    
-    return auc;
+    return evaluate(yTrue, scores, "f1", {}).auc;
 }
 
 std::unordered_map<double, double> Metrics::precisionRecallCurve(
@@ -220,156 +353,49 @@ std::unordered_map<double, double> Metrics::precisionRecallCurve(
     const std::vector<double>& scores,
     const std::vector<double>& recallLevels
 ) {
-    // Pair scores with truth for sorting
-    std::vector<std::pair<double, int>> scoreLabelPairs;
-    for (size_t i = 0; i < scores.size() && i < yTrue.size(); ++i) {
-        scoreLabelPairs.emplace_back(scores[i], yTrue[i]);
-    }
-    
-    // Sort by score in descending order
-    std::sort(scoreLabelPairs.begin(), scoreLabelPairs.end(),
-             [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Count positive samples
-    int positiveCount = 0;
-    for (int label : yTrue) {
-        if (label != 0) {  // Positive class
-            positiveCount++;
-        }
-    }
-    
-    // If no positive samples, return empty result
-    if (positiveCount == 0) {
-        return {};
-    }
-    
-    // Compute precision and recall at every threshold
-    std::vector<double> precisions;
-    std::vector<double> recalls;
-    std::vector<double> thresholds;
-    
-    int tp = 0;
-    int fp = 0;
-    double prevScore = std::numeric_limits<double>::infinity();
-    
-    for (const auto& [score, label] : scoreLabelPairs) {
-        // If score changes, save metrics at this threshold
-        if (score != prevScore) {
-            precisions.push_back(tp > 0 ? static_cast<double>(tp) / (tp + fp) : 1.0);
-            recalls.push_back(static_cast<double>(tp) / positiveCount);
-            thresholds.push_back(score);
-            prevScore = score;
-        }
-        
-        // Update counters
-        if (label != 0) {  // Positive class
-            tp++;
-        } else {  // Negative class
-            fp++;
-        }
-    }
-    
-    // Add final point
-    precisions.push_back(tp > 0 ? static_cast<double>(tp) / (tp + fp) : 1.0);
-    recalls.push_back(static_cast<double>(tp) / positiveCount);
-    
-    // Interpolate precision at given recall levels
-    std::unordered_map<double, double> precisionAtRecall;
-    
-    for (double targetRecall : recallLevels) {
-        double maxPrecision = 0.0;
-        
-        // Find the maximum precision for recall >= targetRecall
-        for (size_t i = 0; i < recalls.size(); ++i) {
-            if (recalls[i] >= targetRecall) {
-                maxPrecision = std::max(maxPrecision, precisions[i]);
-            }
-        }
-        
-        precisionAtRecall[targetRecall] = maxPrecision;
-    }
-    
-    return precisionAtRecall;
+    return evaluate(yTrue, scores, "f1", recallLevels).precisionAtRecall;
 }
 
 double Metrics::findOptimalThreshold(
     const std::vector<int>& yTrue,
     const std::vector<double>& scores,
     const std::string& metric
+) {
+    return evaluate(yTrue, scores, metric, {}).threshold;
+}
+
+Evaluation Metrics::evaluate(
+    const std::vector<int>& yTrue,
+    const std::vector<double>& scores,
+    const std::string& metric,
+    const std::vector<double>& recallLevels,
+    size_t threads
 ) {
     // Pair scores with truth for sorting
-    std::vector<std::pair<double, int>> scoreLabelPairs;
-    for (size_t i = 0; i < scores.size() && i < yTrue.size(); ++i) {
-        scoreLabelPairs.emplace_back(scores[i], yTrue[i]);
-    }
-    
-    // Sort by score in descending order
-    std::sort(scoreLabelPairs.begin(), scoreLabelPairs.end(),
-             [](const auto& a, const auto& b) { return a.first > b.first; });
-    
-    // Test each threshold (each unique score value)
-    double bestThreshold = 0.0;
-    double bestScore = -1.0;  // Start with worst possible score
-    double prevScore = std::numeric_limits<double>::infinity();
-    
-    int tp = 0, fp = 0, tn = 0, fn = 0;
-    
-    // Count total positives and negatives
-    int totalPositives = 0, totalNegatives = 0;
-    for (int label : yTrue) {
-        if (label != 0) {  // Positive class
-            totalPositives++;
-        } else {  // Negative class
-            totalNegatives++;
-        }
+    size_t count = std::min(yTrue.size(), scores.size());
+    std::vector<std::pair<double, bool>> scoreLabelPairs(count);
+    size_t positives = 0;
+    for (size_t i = 0; i < count; ++i) {
+        scoreLabelPairs[i] = {scores[i], yTrue[i] != 0};
+        positives += yTrue[i] != 0;
     }
-    
-    // Initially, all predictions are negative
-    tn = totalNegatives;
-    fn = totalPositives;
-    
-    for (const auto& [score, label] : scoreLabelPairs) {
-        // If score changes, evaluate this threshold
-        if (score != prevScore) {
-            double metricValue = 0.0;
-            
-            if (metric == "f1") {
-                double prec = (tp + fp > 0) ? static_cast<double>(tp) / (tp + fp) : 0.0;
-                double rec = (tp + fn > 0) ? static_cast<double>(tp) / (tp + fn) : 0.0;
-                metricValue = (prec + rec > 0) ? 2.0 * prec * rec / (prec + rec) : 0.0;
-            } else if (metric == "accuracy") {
-                metricValue = static_cast<double>(tp + tn) / (tp + tn + fp + fn);
-            } else if (metric == "precision") {
-                metricValue = (tp + fp > 0) ? static_cast<double>(tp) / (tp + fp) : 0.0;
-            } else if (metric == "recall") {
-                metricValue = (tp + fn > 0) ? static_cast<double>(tp) / (tp + fn) : 0.0;
-            } else {
-                // Default to F1
-                double prec = (tp + fp > 0) ? static_cast<double>(tp) / (tp + fp) : 0.0;
-                double rec = (tp + fn > 0) ? static_cast<double>(tp) / (tp + fn) : 0.0;
-                metricValue = (prec + rec > 0) ? 2.0 * prec * rec / (prec + rec) : 0.0;
-            }
-            
-            // Update best threshold if this is better
-            if (metricValue > bestScore) {
-                bestScore = metricValue;
-                bestThreshold = score;
-            }
-            
-            prevScore = score;
-        }
-        
-        // Update counters for next threshold
-        if (label != 0) {  // Positive class
-            fn--;
-            tp++;
-        } else {  // Negative class
-            tn--;
-            fp++;
+
+    sortDescending(scoreLabelPairs, utils::resolveThreadCount(static_cast<int>(threads)));
+
+    // One sweep over the groups of tied scores
+    CurveSweep sweep(positives, count - positives, resolveMetric(metric), !recallLevels.empty());
+    for (size_t begin = 0; begin < count;) {
+        double score = scoreLabelPairs[begin].first;
+        size_t pos = 0;
+        size_t end = begin;
+        for (; end < count && scoreLabelPairs[end].first == score; ++end) {
+            pos += scoreLabelPairs[end].second;
         }
+        sweep.addGroup(score, pos, end - begin - pos);
+        begin = end;
     }
-    
-    return bestThreshold;
+
+    return sweep.finish(recallLevels);
 }
 
 double Metrics::precision(int tp, int fp) {
@@ -389,5 +415,74 @@ double Metrics::accuracy(int tp, int tn, int total) {
     return (total > 0) ? static_cast<double>(tp + tn) / total : 0.0;
 }
 
+ScoreHistogram::ScoreHistogram(double minScore, double maxScore, size_t bins)
+    : minScore(minScore),
+      binWidth((maxScore - minScore) / static_cast<double>(std::max<size_t>(bins, 1))),
+      positives(std::max<size_t>(bins, 1), 0),
+      negatives(std::max<size_t>(bins, 1), 0) {
+    if (!(maxScore > minScore)) {
+        throw std::invalid_argument("Histogram score range must not be empty");
+    }
+}
+
+void ScoreHistogram::add(int label, double score) {
+    // Out-of-range (and NaN) scores are counted in the end bins
+    size_t bin = 0;
+    double offset = (score - minScore) / binWidth;
+    if (offset >= static_cast<double>(positives.size())) {
+        bin = positives.size() - 1;
+    } else if (offset > 0) {
+        bin = static_cast<size_t>(offset);
+    }
+
+    if (label != 0) {
+        ++positives[bin];
+    } else {
+        ++negatives[bin];
+    }
+}
+
+void ScoreHistogram::add(const std::vector<int>& yTrue, const std::vector<double>& scores) {
+    for (size_t i = 0; i < yTrue.size() && i < scores.size(); ++i) {
+        add(yTrue[i], scores[i]);
+    }
+}
+
+void ScoreHistogram::merge(const ScoreHistogram& other) {
+    if (other.minScore != minScore || other.binWidth != binWidth || other.positives.size() != positives.size()) {
+        throw std::invalid_argument("Cannot merge histograms with different bins");
+    }
+    for (size_t bin = 0; bin < positives.size(); ++bin) {
+        positives[bin] += other.positives[bin];
+        negatives[bin] += other.negatives[bin];
+    }
+}
+
+size_t ScoreHistogram::size() const {
+    size_t total = 0;
+    for (size_t bin = 0; bin < positives.size(); ++bin) {
+        total += positives[bin] + negatives[bin];
+    }
+    return total;
+}
+
+Evaluation ScoreHistogram::evaluate(const std::string& metric, const std::vector<double>& recallLevels) const {
+    size_t totalPositives = 0;
+    size_t totalNegatives = 0;
+    for (size_t bin = 0; bin < positives.size(); ++bin) {
+        totalPositives += positives[bin];
+        totalNegatives += negatives[bin];
+    }
+
+    // Bins are swept from the highest, each as one group at its lower edge
+    CurveSweep sweep(totalPositives, totalNegatives, resolveMetric(metric), !recallLevels.empty());
+    for (size_t bin = positives.size(); bin-- > 0;) {
+        if (positives[bin] + negatives[bin] > 0) {
+            sweep.addGroup(minScore + binWidth * static_cast<double>(bin), positives[bin], negatives[bin]);
+        }
+    }
+    return sweep.finish(recallLevels);
+}
+
 } // namespace evaluation
 } // namespace blahajpi
@@ -0,0 +1,653 @@
+/**
+ * @file linear_model.cpp
+ * @brief Implementation of the sparse linear classifier
+ */
+
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/models/linear_scorer.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include "blahajpi/utils/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace blahajpi {
+namespace models {
+
+namespace {
+
+/// File header written by LinearModel::save()
+constexpr char MODEL_MAGIC[8] = {'B', 'P', 'I', 'L', 'I', 'N', '0', '1'};
+
+/// Bundle sections written by the linear model
+constexpr const char* SECTION_MODEL = "LMOD";    ///< Hyperparameters, label and bias
+constexpr const char* SECTION_WEIGHTS = "WGHT";  ///< Feature weights
+constexpr const char* SECTION_QUANTIZED = "QWGT";  ///< Feature weights in reduced precision
+
+/// Rescale the weights when the regularization scale gets this small
+constexpr double MIN_WEIGHT_SCALE = 1e-9;
+
+/**
+ * @brief Folds a weight scale that got too small back into the weights
+ * @param weights Stored weights
+ * @param scale Current weight scale, reset to 1 when folded
+ */
+void foldSmallScale(std::vector<double>& weights, double& scale) {
+    if (scale < MIN_WEIGHT_SCALE) {
+        for (auto& w : weights) {
+            w *= scale;
+        }
+        scale = 1.0;
+    }
+}
+
+} // namespace
+
+LinearModel::LinearModel(
+    const std::string& loss,
+    double alpha,
+    int epochs,
+    double eta0,
+    unsigned int seed
+) : loss(loss),
+    alpha(alpha),
+    epochs(epochs),
+    eta0(eta0),
+    seed(seed),
+    bias(0.0),
+    positiveLabel(1),
+    step(0),
+    epochsRun(0),
+    precision(WeightPrecision::Double) {
+
+    if (loss != "log" && loss != "hinge") {
+        throw std::invalid_argument("Unsupported loss function: " + loss);
+    }
+}
+
+void LinearModel::setTrainingOptions(const TrainingOptions& options) {
+    if (!(options.validationFraction >= 0.0 && options.validationFraction < 1.0)) {
+        throw std::invalid_argument("Validation fraction must be in [0, 1)");
+    }
+
+    this->options = options;
+    this->options.batchSize = std::max<size_t>(options.batchSize, 1);
+    this->options.threads = std::max<size_t>(options.threads, 1);
+    this->options.patience = std::max(options.patience, 1);
+}
+
+const LinearModel::TrainingOptions& LinearModel::getTrainingOptions() const {
+    return options;
+}
+
+void LinearModel::setWeightPrecision(WeightPrecision precision) {
+    this->precision = precision;
+    if (precision != WeightPrecision::Double) {
+        weights = QuantizedWeights::quantize(weights, precision).dequantize();
+    }
+}
+
+WeightPrecision LinearModel::getWeightPrecision() const {
+    return precision;
+}
+
+void LinearModel::compactFeatures(const std::vector<int>& newIndex, size_t numFeatures) {
+    if (newIndex.size() != weights.size()) {
+        throw std::invalid_argument("Expected one new index per weight");
+    }
+
+    std::vector<double> kept(numFeatures, 0.0);
+    for (size_t i = 0; i < newIndex.size(); ++i) {
+        if (newIndex[i] >= 0) {
+            kept[static_cast<size_t>(newIndex[i])] = weights[i];
+        }
+    }
+    weights = std::move(kept);
+}
+
+void LinearModel::fit(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    size_t numFeatures
+) {
+    if (X.size() != y.size()) {
+        throw std::invalid_argument("Feature rows and labels must have the same size");
+    }
+
+    weights.assign(numFeatures, 0.0);
+    bias = 0.0;
+    step = 0;
+    epochsRun = 0;
+
+    for (int label : y) {
+        if (label != 0) {
+            positiveLabel = label;
+            break;
+        }
+    }
+
+    if (X.empty()) {
+        return;
+    }
+
+    std::vector<size_t> order(X.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(seed);
+
+    // Early stopping holds out a random share of the rows
+    std::vector<size_t> validation;
+    if (options.validationFraction > 0.0 && X.size() > 1) {
+        std::shuffle(order.begin(), order.end(), rng);
+        auto heldOut = static_cast<size_t>(std::llround(options.validationFraction * static_cast<double>(X.size())));
+        heldOut = std::clamp<size_t>(heldOut, 1, X.size() - 1);
+        validation.assign(order.end() - static_cast<std::ptrdiff_t>(heldOut), order.end());
+        order.resize(order.size() - heldOut);
+    }
+
+    // The true weights are scale * weights, which lets L2 decay be applied
+    // in O(1) per sample instead of touching every feature
+    double scale = 1.0;
+
+    double bestLoss = std::numeric_limits<double>::infinity();
+    std::vector<double> bestWeights;
+    double bestBias = 0.0;
+    int epochsWithoutImprovement = 0;
+
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        std::shuffle(order.begin(), order.end(), rng);
+        runEpoch(X, y, order, scale);
+        ++epochsRun;
+
+        if (validation.empty()) {
+            continue;
+        }
+
+        double validationLoss = meanLoss(X, y, validation, scale);
+        if (validationLoss < bestLoss - options.tolerance) {
+            bestLoss = validationLoss;
+            bestWeights = weights;
+            for (auto& w : bestWeights) {
+                w *= scale;
+            }
+            bestBias = bias;
+            epochsWithoutImprovement = 0;
+        } else if (++epochsWithoutImprovement >= options.patience) {
+            break;
+        }
+    }
+
+    if (!bestWeights.empty()) {
+        weights = std::move(bestWeights);
+        bias = bestBias;
+        scale = 1.0;
+    }
+
+    for (auto& w : weights) {
+        w *= scale;
+    }
+}
+
+void LinearModel::partialFit(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    size_t numFeatures
+) {
+    if (X.size() != y.size()) {
+        throw std::invalid_argument("Feature rows and labels must have the same size");
+    }
+
+    if (weights.size() != numFeatures) {
+        if (!weights.empty()) {
+            throw std::invalid_argument("Feature dimension does not match the partially trained model");
+        }
+        weights.assign(numFeatures, 0.0);
+        bias = 0.0;
+        step = 0;
+    }
+
+    for (int label : y) {
+        if (label != 0) {
+            positiveLabel = label;
+            break;
+        }
+    }
+
+    if (X.empty()) {
+        return;
+    }
+
+    // Each call gets its own shuffle, derived from how far training has come
+    std::vector<size_t> order(X.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(seed + static_cast<unsigned int>(step));
+    std::shuffle(order.begin(), order.end(), rng);
+
+    double scale = 1.0;
+    runEpoch(X, y, order, scale);
+
+    for (auto& w : weights) {
+        w *= scale;
+    }
+}
+
+void LinearModel::runEpoch(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    const std::vector<size_t>& order,
+    double& scale
+) {
+    if (options.batchSize > 1) {
+        runMiniBatches(X, y, order, scale);
+        return;
+    }
+
+    for (size_t sampleIdx : order) {
+        const auto& row = X[sampleIdx];
+        int target = (y[sampleIdx] != 0) ? 1 : 0;
+
+        double eta = eta0 / (1.0 + alpha * eta0 * static_cast<double>(step));
+        ++step;
+
+        double score = scale * row.dot(weights) + bias;
+        double gradient = lossGradient(score, target);
+
+        // Weight decay from the L2 penalty
+        scale *= (1.0 - eta * alpha);
+        foldSmallScale(weights, scale);
+
+        if (gradient != 0.0) {
+            double update = eta * gradient / scale;
+            for (size_t k = 0; k < row.indices.size(); ++k) {
+                size_t feature = static_cast<size_t>(row.indices[k]);
+                if (feature < weights.size()) {
+                    weights[feature] -= update * row.values[k];
+                }
+            }
+            bias -= eta * gradient;
+        }
+    }
+}
+
+void LinearModel::runMiniBatches(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    const std::vector<size_t>& order,
+    double& scale
+) {
+    /// Pending change of one weight
+    struct Update {
+        size_t feature;   ///< Weight index
+        double delta;     ///< Loss gradient times feature value
+    };
+
+    size_t batchSize = options.batchSize;
+    size_t workers = std::min(options.threads, batchSize);
+
+    // updates[source * workers + owner] holds the changes the source worker's
+    // slice of the batch makes to the features owned by the owner worker
+    std::vector<std::vector<Update>> updates(workers * workers);
+    std::vector<double> gradients(batchSize);
+
+    for (size_t batchStart = 0; batchStart < order.size(); batchStart += batchSize) {
+        size_t count = std::min(batchSize, order.size() - batchStart);
+        size_t sliceSize = (count + workers - 1) / workers;
+
+        double eta = eta0 / (1.0 + alpha * eta0 * static_cast<double>(step));
+        step += count;
+
+        // Score the batch against the weights at its start
+        utils::parallelFor(workers, workers, [&](size_t source) {
+            size_t begin = std::min(count, source * sliceSize);
+            size_t end = std::min(count, begin + sliceSize);
+
+            for (size_t i = begin; i < end; ++i) {
+                size_t sampleIdx = order[batchStart + i];
+                const auto& row = X[sampleIdx];
+                int target = (y[sampleIdx] != 0) ? 1 : 0;
+
+                double gradient = lossGradient(scale * row.dot(weights) + bias, target);
+                gradients[i] = gradient;
+                if (gradient == 0.0 || workers == 1) {
+                    continue;
+                }
+
+                for (size_t k = 0; k < row.indices.size(); ++k) {
+                    size_t feature = static_cast<size_t>(row.indices[k]);
+                    if (feature < weights.size()) {
+                        updates[source * workers + feature % workers].push_back({feature, gradient * row.values[k]});
+                    }
+                }
+            }
+        });
+
+        // Weight decay of every sample in the batch
+        scale *= std::pow(1.0 - eta * alpha, static_cast<double>(count));
+        foldSmallScale(weights, scale);
+
+        // Slices are visited in batch order, so each weight sees its
+        // updates in sample order whatever the number of workers
+        double factor = eta / scale;
+        if (workers == 1) {
+            // A single worker applies the rows directly in the same order
+            for (size_t i = 0; i < count; ++i) {
+                const auto& row = X[order[batchStart + i]];
+                for (size_t k = 0; gradients[i] != 0.0 && k < row.indices.size(); ++k) {
+                    size_t feature = static_cast<size_t>(row.indices[k]);
+                    if (feature < weights.size()) {
+                        weights[feature] -= factor * (gradients[i] * row.values[k]);
+                    }
+                }
+                bias -= eta * gradients[i];
+            }
+            continue;
+        }
+
+        utils::parallelFor(workers, workers, [&](size_t owner) {
+            for (size_t source = 0; source < workers; ++source) {
+                auto& pending = updates[source * workers + owner];
+                for (const auto& update : pending) {
+                    weights[update.feature] -= factor * update.delta;
+                }
+                pending.clear();
+            }
+        });
+
+        for (size_t i = 0; i < count; ++i) {
+            bias -= eta * gradients[i];
+        }
+    }
+}
+
+double LinearModel::meanLoss(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    const std::vector<size_t>& rows,
+    double scale
+) const {
+    if (rows.empty()) {
+        return 0.0;
+    }
+
+    double total = 0.0;
+    for (size_t sampleIdx : rows) {
+        int target = (y[sampleIdx] != 0) ? 1 : 0;
+        total += lossValue(scale * X[sampleIdx].dot(weights) + bias, target);
+    }
+
+    return total / static_cast<double>(rows.size());
+}
+
+std::vector<double> LinearModel::decisionFunction(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<double> scores;
+    scores.reserve(X.size());
+
+    for (const auto& row : X) {
+        scores.push_back(decision(row));
+    }
+
+    return scores;
+}
+
+std::vector<double> LinearModel::predictProbability(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<double> probabilities = decisionFunction(X);
+
+    for (auto& value : probabilities) {
+        value = LinearScorer::logistic(value);
+    }
+
+    return probabilities;
+}
+
+std::vector<int> LinearModel::predict(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<int> labels;
+    labels.reserve(X.size());
+
+    for (const auto& row : X) {
+        labels.push_back(decision(row) > 0.0 ? positiveLabel : 0);
+    }
+
+    return labels;
+}
+
+double LinearModel::score(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y
+) const {
+    if (X.empty() || X.size() != y.size()) {
+        return 0.0;
+    }
+
+    std::vector<int> predictions = predict(X);
+    size_t correct = 0;
+
+    for (size_t i = 0; i < predictions.size(); ++i) {
+        if ((predictions[i] != 0) == (y[i] != 0)) {
+            ++correct;
+        }
+    }
+
+    return static_cast<double>(correct) / static_cast<double>(predictions.size());
+}
+
+double LinearModel::decision(const preprocessing::SparseVector& x) const {
+    return x.dot(weights) + bias;
+}
+
+const std::vector<double>& LinearModel::getWeights() const {
+    return weights;
+}
+
+double LinearModel::getBias() const {
+    return bias;
+}
+
+int LinearModel::getEpochsRun() const {
+    return epochsRun;
+}
+
+size_t LinearModel::getNumFeatures() const {
+    return weights.size();
+}
+
+bool LinearModel::save(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // Fixed-width fields keep the file readable across platforms
+    uint32_t lossLength = static_cast<uint32_t>(loss.size());
+    int32_t epochCount = epochs;
+    int32_t label = positiveLabel;
+    uint64_t weightCount = weights.size();
+
+    file.write(MODEL_MAGIC, sizeof(MODEL_MAGIC));
+    file.write(reinterpret_cast<const char*>(&lossLength), sizeof(lossLength));
+    file.write(loss.data(), lossLength);
+    file.write(reinterpret_cast<const char*>(&alpha), sizeof(alpha));
+    file.write(reinterpret_cast<const char*>(&epochCount), sizeof(epochCount));
+    file.write(reinterpret_cast<const char*>(&eta0), sizeof(eta0));
+    file.write(reinterpret_cast<const char*>(&label), sizeof(label));
+    file.write(reinterpret_cast<const char*>(&bias), sizeof(bias));
+    file.write(reinterpret_cast<const char*>(&weightCount), sizeof(weightCount));
+    file.write(reinterpret_cast<const char*>(weights.data()),
+               static_cast<std::streamsize>(weights.size() * sizeof(double)));
+
+    if (!file) {
+        std::cerr << "Error: Failed to write linear model: " << filePath << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool LinearModel::load(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for reading: " << filePath << std::endl;
+        return false;
+    }
+
+    char magic[sizeof(MODEL_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0) {
+        std::cerr << "Error: Not a linear model file: " << filePath << std::endl;
+        return false;
+    }
+
+    uint32_t lossLength = 0;
+    file.read(reinterpret_cast<char*>(&lossLength), sizeof(lossLength));
+    if (!file || lossLength > 64) {
+        std::cerr << "Error: Corrupt linear model header: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string lossName(lossLength, '\0');
+    file.read(lossName.data(), lossLength);
+
+    double alphaValue = 0.0;
+    int32_t epochCount = 0;
+    double eta0Value = 0.0;
+    int32_t label = 1;
+    double biasValue = 0.0;
+    uint64_t weightCount = 0;
+
+    file.read(reinterpret_cast<char*>(&alphaValue), sizeof(alphaValue));
+    file.read(reinterpret_cast<char*>(&epochCount), sizeof(epochCount));
+    file.read(reinterpret_cast<char*>(&eta0Value), sizeof(eta0Value));
+    file.read(reinterpret_cast<char*>(&label), sizeof(label));
+    file.read(reinterpret_cast<char*>(&biasValue), sizeof(biasValue));
+    file.read(reinterpret_cast<char*>(&weightCount), sizeof(weightCount));
+
+    if (!file) {
+        std::cerr << "Error: Corrupt linear model header: " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<double> weightValues(weightCount);
+    file.read(reinterpret_cast<char*>(weightValues.data()),
+              static_cast<std::streamsize>(weightCount * sizeof(double)));
+
+    if (!file) {
+        std::cerr << "Error: Truncated linear model file: " << filePath << std::endl;
+        return false;
+    }
+
+    loss = lossName;
+    alpha = alphaValue;
+    epochs = epochCount;
+    eta0 = eta0Value;
+    positiveLabel = label;
+    bias = biasValue;
+    weights = std::move(weightValues);
+    precision = WeightPrecision::Double;
+
+    return true;
+}
+
+void LinearModel::writeBundle(utils::BundleWriter& bundle) const {
+    auto& header = bundle.addSection(SECTION_MODEL);
+    header.writeString(loss);
+    header.writeF64(alpha);
+    header.writeI32(epochs);
+    header.writeF64(eta0);
+    header.writeI32(positiveLabel);
+    header.writeF64(bias);
+    header.writeU64(weights.size());
+    
+    if (precision == WeightPrecision::Double) {
+        bundle.addSection(SECTION_WEIGHTS).writeF64Array(weights);
+    } else {
+        QuantizedWeights::quantize(weights, precision).write(bundle.addSection(SECTION_QUANTIZED));
+    }
+}
+
+bool LinearModel::readBundle(const utils::BundleReader& bundle) {
+    utils::SectionReader header = bundle.reader(SECTION_MODEL);
+    std::string lossName = header.readString();
+    double alphaValue = header.readF64();
+    int32_t epochCount = header.readI32();
+    double eta0Value = header.readF64();
+    int32_t label = header.readI32();
+    double biasValue = header.readF64();
+    uint64_t weightCount = header.readU64();
+    
+    std::vector<double> weightValues;
+    WeightPrecision storedPrecision = WeightPrecision::Double;
+    bool weightsOk = false;
+    if (bundle.hasSection(SECTION_QUANTIZED)) {
+        utils::SectionReader weightSection = bundle.reader(SECTION_QUANTIZED);
+        QuantizedWeights quantized;
+        weightsOk = quantized.read(weightSection) && quantized.size() == weightCount;
+        storedPrecision = quantized.getPrecision();
+        weightValues = quantized.dequantize();
+    } else {
+        utils::SectionReader weightSection = bundle.reader(SECTION_WEIGHTS);
+        weightValues = weightSection.readF64Array(weightCount);
+        weightsOk = weightSection.ok();
+    }
+    
+    if (!header.ok() || !weightsOk || (lossName != "log" && lossName != "hinge")) {
+        std::cerr << "Error: Invalid linear model sections in model bundle" << std::endl;
+        return false;
+    }
+    
+    loss = lossName;
+    alpha = alphaValue;
+    epochs = epochCount;
+    eta0 = eta0Value;
+    positiveLabel = label;
+    bias = biasValue;
+    weights = std::move(weightValues);
+    precision = storedPrecision;
+    
+    return true;
+}
+
+bool LinearModel::isModelFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(MODEL_MAGIC)];
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, MODEL_MAGIC, sizeof(MODEL_MAGIC)) == 0;
+}
+
+double LinearModel::lossValue(double score, int target) const {
+    double margin = (target ? 1.0 : -1.0) * score;
+    if (loss == "hinge") {
+        return std::max(0.0, 1.0 - margin);
+    }
+
+    // Logistic loss log(1 + e^-margin), written to avoid overflow
+    return margin > 0.0 ? std::log1p(std::exp(-margin)) : -margin + std::log1p(std::exp(margin));
+}
+
+double LinearModel::lossGradient(double score, int target) const {
+    if (loss == "hinge") {
+        double signedTarget = target ? 1.0 : -1.0;
+        return (signedTarget * score < 1.0) ? -signedTarget : 0.0;
+    }
+
+    // Logistic loss
+    return LinearScorer::logistic(score) - static_cast<double>(target);
+}
+
+} // namespace models
+} // namespace blahajpi
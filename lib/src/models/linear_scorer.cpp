@@ -0,0 +1,402 @@
+/**
+ * @file linear_scorer.cpp
+ * @brief Implementation of fused TF-IDF and dot-product scoring
+ */
+
+#include "blahajpi/models/linear_scorer.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+namespace blahajpi {
+namespace models {
+
+namespace {
+
+/// Bundle section holding probed weights: f64 bias, u64 count, f64 weights
+constexpr const char* SECTION_FUSED = "FUSE";
+
+/// Number of basis vectors evaluated per call while probing a classifier
+constexpr size_t PROBE_BATCH_SIZE = 256;
+
+/// Random rows used to confirm a classifier is linear
+constexpr size_t PROBE_CHECK_ROWS = 32;
+
+/// Non-zero entries in each check row
+constexpr size_t PROBE_CHECK_NONZEROS = 8;
+
+/// Probing evaluates numFeatures^2 products, so larger inputs are not probed
+constexpr size_t MAX_PROBE_FEATURES = size_t{1} << 16;
+
+/// Relative tolerance when comparing probed and reported scores
+constexpr double PROBE_TOLERANCE = 1e-6;
+
+/**
+ * @brief Accumulates the folded dot product and squared norm of counted terms
+ * @param counts Counted feature indices
+ * @param idf IDF weight for each feature
+ * @param sublinearTf Whether term frequencies are log-scaled
+ * @param folded Stored folded weights
+ * @param scale Factor applied to the stored weights
+ * @param squaredNorm Output squared norm of the TF-IDF vector
+ * @param visit Called with each entry's position in counts and its unscaled,
+ *              unnormalized term of the dot product
+ * @return Dot product of the term frequencies with the folded weights
+ */
+template <typename Weight, typename Convert, typename Visit>
+double foldedDot(
+    const std::vector<preprocessing::FeatureCount>& counts,
+    const std::vector<double>& idf,
+    bool sublinearTf,
+    const std::vector<Weight>& folded,
+    double scale,
+    Convert convert,
+    double& squaredNorm,
+    Visit visit
+) {
+    double dot = 0.0;
+    double norm = 0.0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const auto& entry = counts[i];
+        double tf = preprocessing::Vectorizer::termFrequencyWeight(entry.count, sublinearTf);
+        double value = tf * idf[entry.index];
+        double product = tf * convert(folded[entry.index]);
+        dot += product;
+        norm += value * value;
+        visit(i, product);
+    }
+
+    squaredNorm = norm;
+    return dot * scale;
+}
+
+/**
+ * @brief Scores a cleaned document with folded weights
+ * @param vectorizer Vectorizer the weights belong to
+ * @param foldedWeights Stored weights[j] * idf[j]
+ * @param bias Intercept
+ * @param cleanedText Preprocessed text
+ * @param counts Scratch buffer for the counted features
+ * @param spans Optional output with the first occurrence of each counted feature
+ * @param coverage Optional output for the number of terms looked up and matched
+ * @param visit Called with each counted entry's unscaled, unnormalized dot product term
+ * @param normOut Optional output for the L2 norm the dot product is divided by
+ * @return Decision score
+ */
+template <typename Visit>
+double scoreText(
+    const preprocessing::Vectorizer& vectorizer,
+    const QuantizedWeights& foldedWeights,
+    double bias,
+    std::string_view cleanedText,
+    std::vector<preprocessing::FeatureCount>& counts,
+    std::vector<preprocessing::FeatureSpan>* spans,
+    preprocessing::TermCoverage* coverage,
+    Visit visit,
+    double* normOut = nullptr
+) {
+    preprocessing::TermCoverage found = vectorizer.countFeatures(cleanedText, counts, spans);
+    if (coverage != nullptr) {
+        *coverage = found;
+    }
+
+    const std::vector<double>& idf = vectorizer.getIdfWeights();
+    bool sublinearTf = vectorizer.usesSublinearTf();
+
+    double dot = 0.0;
+    double squaredNorm = 0.0;
+    switch (foldedWeights.getPrecision()) {
+        case WeightPrecision::Int8:
+            // Sum the integer weights and apply the tensor scale once at the end
+            dot = foldedDot(counts, idf, sublinearTf, foldedWeights.int8Values(), foldedWeights.getScale(),
+                            [](int8_t w) { return static_cast<double>(w); }, squaredNorm, visit);
+            break;
+        case WeightPrecision::Float16:
+            dot = foldedDot(counts, idf, sublinearTf, foldedWeights.halfValues(), 1.0,
+                            QuantizedWeights::fromHalf, squaredNorm, visit);
+            break;
+        case WeightPrecision::Double:
+            dot = foldedDot(counts, idf, sublinearTf, foldedWeights.doubleValues(), 1.0,
+                            [](double w) { return w; }, squaredNorm, visit);
+            break;
+    }
+
+    // L2 normalization of the feature vector scales the dot product by 1 / norm
+    double norm = squaredNorm > 0.0 ? std::sqrt(squaredNorm) : 1.0;
+    if (normOut != nullptr) {
+        *normOut = norm;
+    }
+
+    return bias + dot / norm;
+}
+
+/**
+ * @brief Keeps the k largest and k smallest contributions seen so far
+ *
+ * Both sides are bounded heaps, so offering a value costs O(log k) and
+ * nothing is allocated once the scratch vectors have grown.
+ */
+class ContributionHeaps {
+public:
+    /**
+     * @brief Starts a new document
+     * @param k Number of entries kept on each side
+     */
+    void reset(size_t k) {
+        limit = k;
+        largest.clear();
+        smallest.clear();
+    }
+
+    /**
+     * @brief Offers an entry
+     * @param value Contribution
+     * @param entry Position of the entry in the counts
+     */
+    void offer(double value, size_t entry) {
+        if (limit == 0) {
+            return;
+        }
+        // largest is a min-heap and smallest a max-heap, so the weakest kept value is on top
+        auto greater = [](const Item& a, const Item& b) { return a.first > b.first; };
+        auto less = [](const Item& a, const Item& b) { return a.first < b.first; };
+        if (value > 0.0) {
+            push(largest, {value, entry}, greater);
+        } else if (value < 0.0) {
+            push(smallest, {value, entry}, less);
+        }
+    }
+
+    /**
+     * @brief Takes the entries on one side, strongest first
+     * @param positive Whether to take the largest positive contributions
+     * @return (contribution, entry) pairs
+     */
+    std::vector<std::pair<double, size_t>>& take(bool positive) {
+        auto& side = positive ? largest : smallest;
+        std::sort(side.begin(), side.end(), [](const Item& a, const Item& b) {
+            return std::abs(a.first) > std::abs(b.first);
+        });
+        return side;
+    }
+
+private:
+    using Item = std::pair<double, size_t>;
+
+    /**
+     * @brief Adds an item to a bounded heap, evicting the weakest if full
+     * @param heap Heap ordered so the weakest item is on top
+     * @param item Item to add
+     * @param order Heap order
+     */
+    template <typename Order>
+    void push(std::vector<Item>& heap, Item item, Order order) {
+        if (heap.size() < limit) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end(), order);
+        } else if (order(item, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), order);
+            heap.back() = item;
+            std::push_heap(heap.begin(), heap.end(), order);
+        }
+    }
+
+    size_t limit = 0;           ///< Entries kept per side
+    std::vector<Item> largest;  ///< Strongest positive contributions
+    std::vector<Item> smallest; ///< Strongest negative contributions
+};
+
+} // namespace
+
+bool LinearScorer::build(
+    const preprocessing::Vectorizer& vectorizer,
+    const std::vector<double>& weights,
+    double bias,
+    WeightPrecision precision
+) {
+    reset();
+
+    const std::vector<double>& idf = vectorizer.getIdfWeights();
+    if (weights.empty() || weights.size() != vectorizer.getNumFeatures() || idf.size() != weights.size()) {
+        return false;
+    }
+
+    this->vectorizer = &vectorizer;
+    this->weights = weights;
+    this->bias = bias;
+
+    // Fold IDF into the weights once instead of multiplying per document
+    std::vector<double> folded(weights.size());
+    for (size_t j = 0; j < weights.size(); ++j) {
+        folded[j] = weights[j] * idf[j];
+    }
+    foldedWeights = QuantizedWeights::quantize(folded, precision);
+
+    return true;
+}
+
+double LinearScorer::decision(std::string_view cleanedText, preprocessing::TermCoverage* coverage) const {
+    if (!vectorizer) {
+        return bias;
+    }
+
+    thread_local std::vector<preprocessing::FeatureCount> counts;
+    return scoreText(*vectorizer, foldedWeights, bias, cleanedText, counts, nullptr, coverage,
+                     [](size_t, double) {});
+}
+
+double LinearScorer::explain(
+    std::string_view cleanedText,
+    size_t maxTerms,
+    std::vector<TermContribution>& terms,
+    preprocessing::TermCoverage* coverage
+) const {
+    terms.clear();
+    if (!vectorizer) {
+        return bias;
+    }
+
+    thread_local std::vector<preprocessing::FeatureCount> counts;
+    thread_local std::vector<preprocessing::FeatureSpan> spans;
+    thread_local ContributionHeaps heaps;
+
+    heaps.reset(maxTerms);
+    double norm = 1.0;
+    double decisionScore = scoreText(*vectorizer, foldedWeights, bias, cleanedText, counts, &spans, coverage,
+                                     [](size_t entry, double product) { heaps.offer(product, entry); }, &norm);
+
+    // The dot product terms were ranked before scaling; convert the kept ones to contributions
+    double scale = foldedWeights.getPrecision() == WeightPrecision::Int8 ? foldedWeights.getScale() : 1.0;
+    for (const auto& [product, entry] : heaps.take(decisionScore > 0.0)) {
+        const auto& span = spans[entry];
+        terms.push_back({cleanedText.substr(span.offset, span.length), product * scale / norm});
+    }
+    return decisionScore;
+}
+
+bool LinearScorer::isReady() const {
+    return vectorizer != nullptr;
+}
+
+void LinearScorer::reset() {
+    vectorizer = nullptr;
+    weights.clear();
+    foldedWeights = QuantizedWeights();
+    bias = 0.0;
+}
+
+const std::vector<double>& LinearScorer::getWeights() const {
+    return weights;
+}
+
+double LinearScorer::getBias() const {
+    return bias;
+}
+
+WeightPrecision LinearScorer::getPrecision() const {
+    return foldedWeights.getPrecision();
+}
+
+void LinearScorer::writeBundle(utils::BundleWriter& bundle) const {
+    auto& section = bundle.addSection(SECTION_FUSED);
+    section.writeF64(bias);
+    section.writeU64(weights.size());
+    section.writeF64Array(weights);
+}
+
+bool LinearScorer::readBundle(const utils::BundleReader& bundle, const preprocessing::Vectorizer& vectorizer) {
+    if (!bundle.hasSection(SECTION_FUSED)) {
+        return false;
+    }
+
+    utils::SectionReader section = bundle.reader(SECTION_FUSED);
+    double storedBias = section.readF64();
+    uint64_t count = section.readU64();
+    std::vector<double> storedWeights;
+    if (count == vectorizer.getNumFeatures()) {
+        storedWeights = section.readF64Array(count);
+    }
+
+    if (!section.ok() || storedWeights.size() != count) {
+        std::cerr << "Warning: Ignoring invalid scorer section in model bundle" << std::endl;
+        return false;
+    }
+
+    return build(vectorizer, storedWeights, storedBias);
+}
+
+bool LinearScorer::extractWeights(
+    const Classifier& model,
+    size_t numFeatures,
+    std::vector<double>& weights,
+    double& bias
+) {
+    if (numFeatures == 0 || numFeatures > MAX_PROBE_FEATURES) {
+        return false;
+    }
+
+    // The decision at the origin is the intercept
+    std::vector<std::vector<double>> batch(1, std::vector<double>(numFeatures, 0.0));
+    std::vector<double> origin = model.decisionFunction(batch);
+    if (origin.size() != 1 || !std::isfinite(origin[0])) {
+        return false;
+    }
+    double probedBias = origin[0];
+
+    // The decision at basis vector e_j is bias + w_j
+    std::vector<double> probedWeights(numFeatures, 0.0);
+    for (size_t begin = 0; begin < numFeatures; begin += PROBE_BATCH_SIZE) {
+        size_t count = std::min(PROBE_BATCH_SIZE, numFeatures - begin);
+        batch.assign(count, std::vector<double>(numFeatures, 0.0));
+        for (size_t k = 0; k < count; ++k) {
+            batch[k][begin + k] = 1.0;
+        }
+
+        std::vector<double> scores = model.decisionFunction(batch);
+        if (scores.size() != count) {
+            return false;
+        }
+        for (size_t k = 0; k < count; ++k) {
+            probedWeights[begin + k] = scores[k] - probedBias;
+        }
+    }
+
+    // Confirm linearity and a logistic link on random sparse rows
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> featureDist(0, numFeatures - 1);
+    std::uniform_real_distribution<double> valueDist(0.0, 1.0);
+
+    batch.assign(PROBE_CHECK_ROWS, std::vector<double>(numFeatures, 0.0));
+    std::vector<double> expected(PROBE_CHECK_ROWS, probedBias);
+    for (size_t i = 0; i < PROBE_CHECK_ROWS; ++i) {
+        for (size_t k = 0; k < PROBE_CHECK_NONZEROS; ++k) {
+            size_t j = featureDist(rng);
+            double value = valueDist(rng);
+            batch[i][j] += value;
+            expected[i] += probedWeights[j] * value;
+        }
+    }
+
+    std::vector<double> scores = model.decisionFunction(batch);
+    std::vector<double> probabilities = model.predictProbability(batch);
+    if (scores.size() != PROBE_CHECK_ROWS || probabilities.size() != PROBE_CHECK_ROWS) {
+        return false;
+    }
+
+    for (size_t i = 0; i < PROBE_CHECK_ROWS; ++i) {
+        if (std::abs(scores[i] - expected[i]) > PROBE_TOLERANCE * (1.0 + std::abs(scores[i])) ||
+            std::abs(probabilities[i] - logistic(scores[i])) > PROBE_TOLERANCE) {
+            return false;
+        }
+    }
+
+    weights = std::move(probedWeights);
+    bias = probedBias;
+    return true;
+}
+
+} // namespace models
+} // namespace blahajpi
@@ -0,0 +1,480 @@
+/**
+ * @file mlp_model.cpp
+ * @brief Implementation of the sparse-input neural network classifier
+ */
+
+#include "blahajpi/models/mlp_model.hpp"
+#include "blahajpi/models/linear_scorer.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace blahajpi {
+namespace models {
+
+namespace {
+
+/// Bundle sections written by the network
+constexpr const char* SECTION_MODEL = "MLPM";    ///< Shape, hyperparameters, label and output bias
+constexpr const char* SECTION_WEIGHTS = "MLPW";  ///< Weights of every layer in order
+
+/// Rows pushed through the layers together during inference
+constexpr size_t BLOCK_ROWS = 64;
+
+/// Largest accepted hidden width when reading a saved model
+constexpr uint64_t MAX_HIDDEN_SIZE = 1 << 16;
+
+/**
+ * @brief Adds a scaled row to an accumulator (y += a * x)
+ * @param y Accumulator
+ * @param x Row to add
+ * @param a Scale factor
+ * @param n Row length
+ */
+template <typename T>
+void addScaled(T* y, const T* x, T a, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+/**
+ * @brief Applies the ReLU activation in place
+ * @param values Pre-activations
+ * @param n Number of values
+ */
+template <typename T>
+void relu(T* values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        values[i] = values[i] > T(0) ? values[i] : T(0);
+    }
+}
+
+} // namespace
+
+MlpModel::MlpModel(
+    int hiddenLayers,
+    int hiddenSize,
+    int epochs,
+    double learningRate,
+    unsigned int seed
+) : hiddenLayers(hiddenLayers),
+    hiddenSize(hiddenSize),
+    epochs(epochs),
+    learningRate(learningRate),
+    seed(seed),
+    numFeatures(0),
+    positiveLabel(1),
+    float32(false) {
+
+    if (hiddenLayers < 1 || hiddenSize < 1) {
+        throw std::invalid_argument("Hidden layer count and size must be positive");
+    }
+}
+
+void MlpModel::initialize(size_t dimension) {
+    size_t width = static_cast<size_t>(hiddenSize);
+    numFeatures = dimension;
+    std::mt19937 rng(seed);
+
+    // TF-IDF rows have unit norm, so unit-variance input weights keep the
+    // first layer's pre-activations at unit scale
+    std::uniform_real_distribution<double> inputDist(-std::sqrt(3.0), std::sqrt(3.0));
+    double hiddenLimit = std::sqrt(6.0 / static_cast<double>(width));
+    std::uniform_real_distribution<double> hiddenDist(-hiddenLimit, hiddenLimit);
+    double outputLimit = std::sqrt(6.0 / static_cast<double>(width + 1));
+    std::uniform_real_distribution<double> outputDist(-outputLimit, outputLimit);
+
+    weights.input.resize(dimension * width);
+    for (auto& w : weights.input) {
+        w = inputDist(rng);
+    }
+
+    weights.hidden.assign(static_cast<size_t>(hiddenLayers - 1), std::vector<double>(width * width));
+    for (auto& layer : weights.hidden) {
+        for (auto& w : layer) {
+            w = hiddenDist(rng);
+        }
+    }
+
+    weights.biases.assign(static_cast<size_t>(hiddenLayers), std::vector<double>(width, 0.0));
+    weights.output.resize(width);
+    for (auto& w : weights.output) {
+        w = outputDist(rng);
+    }
+    weights.outputBias = 0.0;
+}
+
+void MlpModel::fit(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y,
+    size_t numFeatures
+) {
+    if (X.size() != y.size()) {
+        throw std::invalid_argument("Feature rows and labels must have the same size");
+    }
+
+    initialize(numFeatures);
+
+    for (int label : y) {
+        if (label != 0) {
+            positiveLabel = label;
+            break;
+        }
+    }
+
+    size_t width = static_cast<size_t>(hiddenSize);
+    size_t layers = static_cast<size_t>(hiddenLayers);
+
+    // Activations of every hidden layer and the error flowing back
+    std::vector<std::vector<double>> activations(layers, std::vector<double>(width));
+    std::vector<double> delta(width);
+    std::vector<double> previousDelta(width);
+
+    std::vector<size_t> order(X.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 rng(seed + 1);
+
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        std::shuffle(order.begin(), order.end(), rng);
+
+        for (size_t sampleIdx : order) {
+            const auto& row = X[sampleIdx];
+            double target = (y[sampleIdx] != 0) ? 1.0 : 0.0;
+
+            // Forward pass
+            std::copy(weights.biases[0].begin(), weights.biases[0].end(), activations[0].begin());
+            for (size_t k = 0; k < row.indices.size(); ++k) {
+                size_t feature = static_cast<size_t>(row.indices[k]);
+                if (feature < numFeatures) {
+                    addScaled(activations[0].data(), &weights.input[feature * width], row.values[k], width);
+                }
+            }
+            relu(activations[0].data(), width);
+
+            for (size_t l = 1; l < layers; ++l) {
+                const auto& layer = weights.hidden[l - 1];
+                std::copy(weights.biases[l].begin(), weights.biases[l].end(), activations[l].begin());
+                for (size_t k = 0; k < width; ++k) {
+                    if (activations[l - 1][k] != 0.0) {
+                        addScaled(activations[l].data(), &layer[k * width], activations[l - 1][k], width);
+                    }
+                }
+                relu(activations[l].data(), width);
+            }
+
+            const auto& last = activations[layers - 1];
+            double output = weights.outputBias;
+            for (size_t j = 0; j < width; ++j) {
+                output += last[j] * weights.output[j];
+            }
+
+            // Backward pass: the logistic loss gradient at the output is p - t
+            double gradient = LinearScorer::logistic(output) - target;
+            for (size_t j = 0; j < width; ++j) {
+                delta[j] = last[j] > 0.0 ? gradient * weights.output[j] : 0.0;
+                weights.output[j] -= learningRate * gradient * last[j];
+            }
+            weights.outputBias -= learningRate * gradient;
+
+            for (size_t l = layers - 1; l >= 1; --l) {
+                auto& layer = weights.hidden[l - 1];
+                const auto& input = activations[l - 1];
+                for (size_t k = 0; k < width; ++k) {
+                    double* weightRow = &layer[k * width];
+                    double sum = 0.0;
+                    for (size_t j = 0; j < width; ++j) {
+                        sum += weightRow[j] * delta[j];
+                    }
+                    previousDelta[k] = input[k] > 0.0 ? sum : 0.0;
+                    if (input[k] != 0.0) {
+                        addScaled(weightRow, delta.data(), -learningRate * input[k], width);
+                    }
+                }
+                addScaled(weights.biases[l].data(), delta.data(), -learningRate, width);
+                delta.swap(previousDelta);
+            }
+
+            // Only the rows of features present in the sample change
+            for (size_t k = 0; k < row.indices.size(); ++k) {
+                size_t feature = static_cast<size_t>(row.indices[k]);
+                if (feature < numFeatures) {
+                    addScaled(&weights.input[feature * width], delta.data(), -learningRate * row.values[k], width);
+                }
+            }
+            addScaled(weights.biases[0].data(), delta.data(), -learningRate, width);
+        }
+    }
+
+    refreshFloatWeights();
+}
+
+template <typename T>
+void MlpModel::forwardBlock(
+    const Parameters<T>& params,
+    std::span<const preprocessing::SparseVector> rows,
+    double* scores
+) const {
+    size_t width = static_cast<size_t>(hiddenSize);
+    std::vector<T> current(rows.size() * width);
+    std::vector<T> next(hiddenLayers > 1 ? rows.size() * width : 0);
+
+    // First layer: sum the weight rows of the non-zero features
+    for (size_t r = 0; r < rows.size(); ++r) {
+        const auto& row = rows[r];
+        T* units = current.data() + r * width;
+        std::copy(params.biases[0].begin(), params.biases[0].end(), units);
+        for (size_t k = 0; k < row.indices.size(); ++k) {
+            size_t feature = static_cast<size_t>(row.indices[k]);
+            if (feature < numFeatures) {
+                addScaled(units, &params.input[feature * width], static_cast<T>(row.values[k]), width);
+            }
+        }
+        relu(units, width);
+    }
+
+    // Later layers multiply the whole block, so each weight matrix stays
+    // in cache while every row of the block passes through it
+    for (size_t l = 1; l < static_cast<size_t>(hiddenLayers); ++l) {
+        const auto& layer = params.hidden[l - 1];
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const T* input = current.data() + r * width;
+            T* units = next.data() + r * width;
+            std::copy(params.biases[l].begin(), params.biases[l].end(), units);
+            for (size_t k = 0; k < width; ++k) {
+                if (input[k] != T(0)) {
+                    addScaled(units, &layer[k * width], input[k], width);
+                }
+            }
+            relu(units, width);
+        }
+        current.swap(next);
+    }
+
+    for (size_t r = 0; r < rows.size(); ++r) {
+        const T* units = current.data() + r * width;
+        T sum = params.outputBias;
+        for (size_t j = 0; j < width; ++j) {
+            sum += units[j] * params.output[j];
+        }
+        scores[r] = static_cast<double>(sum);
+    }
+}
+
+std::vector<double> MlpModel::decisionFunction(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<double> scores(X.size(), 0.0);
+    if (weights.output.empty()) {
+        return scores;
+    }
+
+    std::span<const preprocessing::SparseVector> rows(X);
+    for (size_t begin = 0; begin < rows.size(); begin += BLOCK_ROWS) {
+        auto block = rows.subspan(begin, std::min(BLOCK_ROWS, rows.size() - begin));
+        if (float32) {
+            forwardBlock(floatWeights, block, scores.data() + begin);
+        } else {
+            forwardBlock(weights, block, scores.data() + begin);
+        }
+    }
+
+    return scores;
+}
+
+std::vector<double> MlpModel::predictProbability(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<double> probabilities = decisionFunction(X);
+
+    for (auto& value : probabilities) {
+        value = LinearScorer::logistic(value);
+    }
+
+    return probabilities;
+}
+
+std::vector<int> MlpModel::predict(
+    const std::vector<preprocessing::SparseVector>& X
+) const {
+    std::vector<double> scores = decisionFunction(X);
+    std::vector<int> labels;
+    labels.reserve(scores.size());
+
+    for (double value : scores) {
+        labels.push_back(value > 0.0 ? positiveLabel : 0);
+    }
+
+    return labels;
+}
+
+double MlpModel::score(
+    const std::vector<preprocessing::SparseVector>& X,
+    const std::vector<int>& y
+) const {
+    if (X.empty() || X.size() != y.size()) {
+        return 0.0;
+    }
+
+    std::vector<int> predictions = predict(X);
+    size_t correct = 0;
+
+    for (size_t i = 0; i < predictions.size(); ++i) {
+        if ((predictions[i] != 0) == (y[i] != 0)) {
+            ++correct;
+        }
+    }
+
+    return static_cast<double>(correct) / static_cast<double>(predictions.size());
+}
+
+void MlpModel::setFloat32(bool enabled) {
+    float32 = enabled;
+    refreshFloatWeights();
+}
+
+bool MlpModel::usesFloat32() const {
+    return float32;
+}
+
+void MlpModel::refreshFloatWeights() {
+    floatWeights = Parameters<float>();
+    if (!float32) {
+        return;
+    }
+
+    auto convert = [](const std::vector<double>& values) {
+        return std::vector<float>(values.begin(), values.end());
+    };
+
+    floatWeights.input = convert(weights.input);
+    for (const auto& layer : weights.hidden) {
+        floatWeights.hidden.push_back(convert(layer));
+    }
+    for (const auto& bias : weights.biases) {
+        floatWeights.biases.push_back(convert(bias));
+    }
+    floatWeights.output = convert(weights.output);
+    floatWeights.outputBias = static_cast<float>(weights.outputBias);
+}
+
+size_t MlpModel::getNumFeatures() const {
+    return numFeatures;
+}
+
+int MlpModel::getHiddenLayers() const {
+    return hiddenLayers;
+}
+
+int MlpModel::getHiddenSize() const {
+    return hiddenSize;
+}
+
+bool MlpModel::save(const std::string& filePath) const {
+    utils::BundleWriter bundle;
+    writeBundle(bundle);
+    return bundle.write(filePath);
+}
+
+bool MlpModel::load(const std::string& filePath) {
+    utils::BundleReader bundle;
+    if (!bundle.open(filePath)) {
+        return false;
+    }
+    return readBundle(bundle);
+}
+
+void MlpModel::writeBundle(utils::BundleWriter& bundle) const {
+    auto& header = bundle.addSection(SECTION_MODEL);
+    header.writeI32(hiddenLayers);
+    header.writeI32(hiddenSize);
+    header.writeI32(epochs);
+    header.writeF64(learningRate);
+    header.writeI32(positiveLabel);
+    header.writeU64(numFeatures);
+    header.writeF64(weights.outputBias);
+
+    auto& section = bundle.addSection(SECTION_WEIGHTS);
+    section.writeF64Array(weights.input);
+    for (const auto& layer : weights.hidden) {
+        section.writeF64Array(layer);
+    }
+    for (const auto& bias : weights.biases) {
+        section.writeF64Array(bias);
+    }
+    section.writeF64Array(weights.output);
+}
+
+bool MlpModel::readBundle(const utils::BundleReader& bundle) {
+    utils::SectionReader header = bundle.reader(SECTION_MODEL);
+    int32_t layerCount = header.readI32();
+    int32_t width = header.readI32();
+    int32_t epochCount = header.readI32();
+    double rate = header.readF64();
+    int32_t label = header.readI32();
+    uint64_t dimension = header.readU64();
+    double outputBias = header.readF64();
+
+    if (!header.ok() || layerCount < 1 || width < 1 || static_cast<uint64_t>(width) > MAX_HIDDEN_SIZE) {
+        std::cerr << "Error: Invalid neural network sections in model bundle" << std::endl;
+        return false;
+    }
+
+    // Check the weight count before allocating anything sized by the header
+    size_t units = static_cast<size_t>(width);
+    size_t layers = static_cast<size_t>(layerCount);
+    utils::SectionReader section = bundle.reader(SECTION_WEIGHTS);
+    uint64_t expected = (dimension + (layers - 1) * units + layers + 1) * units;
+    if (dimension > section.remaining() / sizeof(double) || expected * sizeof(double) != section.remaining()) {
+        std::cerr << "Error: Invalid neural network sections in model bundle" << std::endl;
+        return false;
+    }
+
+    Parameters<double> values;
+    values.input = section.readF64Array(dimension * units);
+    for (size_t l = 1; l < layers; ++l) {
+        values.hidden.push_back(section.readF64Array(units * units));
+    }
+    for (size_t l = 0; l < layers; ++l) {
+        values.biases.push_back(section.readF64Array(units));
+    }
+    values.output = section.readF64Array(units);
+    values.outputBias = outputBias;
+
+    if (!section.ok()) {
+        std::cerr << "Error: Invalid neural network sections in model bundle" << std::endl;
+        return false;
+    }
+
+    hiddenLayers = layerCount;
+    hiddenSize = width;
+    epochs = epochCount;
+    learningRate = rate;
+    positiveLabel = label;
+    numFeatures = static_cast<size_t>(dimension);
+    weights = std::move(values);
+    refreshFloatWeights();
+
+    return true;
+}
+
+bool MlpModel::hasModel(const utils::BundleReader& bundle) {
+    return bundle.hasSection(SECTION_MODEL) && bundle.hasSection(SECTION_WEIGHTS);
+}
+
+bool MlpModel::isModelFile(const std::string& filePath) {
+    if (!utils::BundleReader::isBundleFile(filePath)) {
+        return false;
+    }
+
+    utils::BundleReader bundle;
+    return bundle.open(filePath) && hasModel(bundle);
+}
+
+} // namespace models
+} // namespace blahajpi
@@ -0,0 +1,275 @@
+/**
+ * @file quantization.cpp
+ * @brief Implementation of reduced-precision weight tensors
+ */
+
+#include "blahajpi/models/quantization.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace blahajpi {
+namespace models {
+
+namespace {
+
+/// Largest magnitude stored in an int8 tensor
+constexpr double INT8_LIMIT = 127.0;
+
+/// Smallest magnitude that rounds to half-precision infinity
+constexpr double HALF_OVERFLOW = 65520.0;
+
+/// Spacing of half-precision subnormals (2^-24)
+constexpr double HALF_SUBNORMAL_STEP = 5.9604644775390625e-08;
+
+/// Smallest normal half-precision value (2^-14)
+constexpr double HALF_MIN_NORMAL = 6.103515625e-05;
+
+} // namespace
+
+std::optional<WeightPrecision> parseWeightPrecision(std::string_view name) {
+    if (name == "double") {
+        return WeightPrecision::Double;
+    }
+    if (name == "float16") {
+        return WeightPrecision::Float16;
+    }
+    if (name == "int8") {
+        return WeightPrecision::Int8;
+    }
+    return std::nullopt;
+}
+
+std::string weightPrecisionName(WeightPrecision precision) {
+    switch (precision) {
+        case WeightPrecision::Float16:
+            return "float16";
+        case WeightPrecision::Int8:
+            return "int8";
+        case WeightPrecision::Double:
+            break;
+    }
+    return "double";
+}
+
+QuantizedWeights QuantizedWeights::quantize(std::span<const double> values, WeightPrecision precision) {
+    QuantizedWeights result;
+    result.precision = precision;
+
+    switch (precision) {
+        case WeightPrecision::Double:
+            result.doubles.assign(values.begin(), values.end());
+            break;
+
+        case WeightPrecision::Float16:
+            result.halves.resize(values.size());
+            std::transform(values.begin(), values.end(), result.halves.begin(), toHalf);
+            break;
+
+        case WeightPrecision::Int8: {
+            double maxAbs = 0.0;
+            for (double v : values) {
+                if (std::isfinite(v)) {
+                    maxAbs = std::max(maxAbs, std::abs(v));
+                }
+            }
+
+            // An all-zero tensor keeps scale 1 so dequantization stays exact
+            result.scale = maxAbs > 0.0 ? maxAbs / INT8_LIMIT : 1.0;
+            result.bytes.resize(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                double q = std::isfinite(values[i]) ? std::round(values[i] / result.scale) : 0.0;
+                result.bytes[i] = static_cast<int8_t>(std::clamp(q, -INT8_LIMIT, INT8_LIMIT));
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+WeightPrecision QuantizedWeights::getPrecision() const {
+    return precision;
+}
+
+size_t QuantizedWeights::size() const {
+    switch (precision) {
+        case WeightPrecision::Float16:
+            return halves.size();
+        case WeightPrecision::Int8:
+            return bytes.size();
+        case WeightPrecision::Double:
+            break;
+    }
+    return doubles.size();
+}
+
+double QuantizedWeights::getScale() const {
+    return scale;
+}
+
+double QuantizedWeights::value(size_t index) const {
+    switch (precision) {
+        case WeightPrecision::Float16:
+            return fromHalf(halves[index]);
+        case WeightPrecision::Int8:
+            return bytes[index] * scale;
+        case WeightPrecision::Double:
+            break;
+    }
+    return doubles[index];
+}
+
+std::vector<double> QuantizedWeights::dequantize() const {
+    std::vector<double> result(size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        result[i] = value(i);
+    }
+    return result;
+}
+
+const std::vector<double>& QuantizedWeights::doubleValues() const {
+    return doubles;
+}
+
+const std::vector<int8_t>& QuantizedWeights::int8Values() const {
+    return bytes;
+}
+
+const std::vector<uint16_t>& QuantizedWeights::halfValues() const {
+    return halves;
+}
+
+size_t QuantizedWeights::byteSize() const {
+    return doubles.size() * sizeof(double) + halves.size() * sizeof(uint16_t) + bytes.size();
+}
+
+void QuantizedWeights::write(utils::SectionWriter& section) const {
+    section.writeU8(static_cast<uint8_t>(precision));
+    section.writeF64(scale);
+    section.writeU64(size());
+
+    switch (precision) {
+        case WeightPrecision::Double:
+            section.writeF64Array(doubles);
+            break;
+
+        case WeightPrecision::Float16: {
+            // Bundles are little-endian regardless of the host
+            std::vector<unsigned char> encoded(halves.size() * 2);
+            for (size_t i = 0; i < halves.size(); ++i) {
+                encoded[2 * i] = static_cast<unsigned char>(halves[i] & 0xFF);
+                encoded[2 * i + 1] = static_cast<unsigned char>(halves[i] >> 8);
+            }
+            section.writeBytes(encoded.data(), encoded.size());
+            break;
+        }
+
+        case WeightPrecision::Int8:
+            section.writeBytes(bytes.data(), bytes.size());
+            break;
+    }
+}
+
+bool QuantizedWeights::read(utils::SectionReader& section) {
+    uint8_t storedPrecision = section.readU8();
+    double storedScale = section.readF64();
+    uint64_t count = section.readU64();
+
+    if (!section.ok() || storedPrecision > static_cast<uint8_t>(WeightPrecision::Int8) ||
+        !std::isfinite(storedScale) || storedScale <= 0.0) {
+        return false;
+    }
+
+    QuantizedWeights result;
+    result.precision = static_cast<WeightPrecision>(storedPrecision);
+    result.scale = storedScale;
+
+    switch (result.precision) {
+        case WeightPrecision::Double:
+            if (count > section.remaining() / sizeof(double)) {
+                return false;
+            }
+            result.doubles = section.readF64Array(count);
+            break;
+
+        case WeightPrecision::Float16: {
+            if (count > section.remaining() / 2) {
+                return false;
+            }
+            auto raw = section.readBytes(count * 2);
+            result.halves.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                result.halves[i] = static_cast<uint16_t>(raw[2 * i] | (raw[2 * i + 1] << 8));
+            }
+            break;
+        }
+
+        case WeightPrecision::Int8: {
+            if (count > section.remaining()) {
+                return false;
+            }
+            auto raw = section.readBytes(count);
+            result.bytes.resize(count);
+            std::transform(raw.begin(), raw.end(), result.bytes.begin(),
+                           [](unsigned char b) { return static_cast<int8_t>(b); });
+            break;
+        }
+    }
+
+    if (!section.ok()) {
+        return false;
+    }
+
+    *this = std::move(result);
+    return true;
+}
+
+uint16_t QuantizedWeights::toHalf(double value) {
+    uint16_t sign = std::signbit(value) ? 0x8000 : 0x0000;
+    double magnitude = std::abs(value);
+
+    if (std::isnan(value)) {
+        return sign | 0x7E00;
+    }
+    if (magnitude >= HALF_OVERFLOW) {
+        return sign | 0x7C00;
+    }
+
+    // Subnormals are multiples of 2^-24; rounding up to 1024 steps yields the smallest normal
+    if (magnitude < HALF_MIN_NORMAL) {
+        return sign | static_cast<uint16_t>(std::nearbyint(magnitude / HALF_SUBNORMAL_STEP));
+    }
+
+    int exponent = 0;
+    double fraction = std::frexp(magnitude, &exponent);  // magnitude = fraction * 2^exponent, fraction in [0.5, 1)
+    exponent -= 1;
+
+    // (2 * fraction - 1) * 1024 is exact in double, so nearbyint rounds to nearest even once
+    double mantissa = std::nearbyint((2.0 * fraction - 1.0) * 1024.0);
+    if (mantissa >= 1024.0) {
+        mantissa = 0.0;
+        ++exponent;
+    }
+
+    return sign | static_cast<uint16_t>((exponent + 15) << 10) | static_cast<uint16_t>(mantissa);
+}
+
+double QuantizedWeights::fromHalf(uint16_t bits) {
+    uint32_t exponent = (bits >> 10) & 0x1F;
+    uint32_t mantissa = bits & 0x3FF;
+    double sign = (bits & 0x8000) ? -1.0 : 1.0;
+
+    if (exponent == 0x1F) {
+        return mantissa ? std::numeric_limits<double>::quiet_NaN() : sign * std::numeric_limits<double>::infinity();
+    }
+
+    // Shifting the half into float position and rescaling by 2^112 handles normals and subnormals alike
+    float magnitude = std::bit_cast<float>((exponent << 23) | (mantissa << 13)) * 0x1p112f;
+    return sign * static_cast<double>(magnitude);
+}
+
+} // namespace models
+} // namespace blahajpi
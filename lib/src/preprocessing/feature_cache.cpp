@@ -0,0 +1,248 @@
+/**
+ * @file feature_cache.cpp
+ * @brief Implementation of the on-disk feature cache
+ */
+
+#include "blahajpi/preprocessing/feature_cache.hpp"
+#include "blahajpi/utils/mapped_file.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace blahajpi {
+namespace preprocessing {
+
+namespace {
+
+/// Row counts: u32 format version, u64 train rows, u64 test rows, u64 stored entries
+constexpr const char* SECTION_HEADER = "FCHD";
+
+/// Labels of the training rows, then of the test rows (i32 each)
+constexpr const char* SECTION_LABELS = "FCLB";
+
+/// CSR row offsets into the entry arrays (u64, one more than the row count)
+constexpr const char* SECTION_ROWS = "FCRW";
+
+/// Feature index of every stored entry (i32)
+constexpr const char* SECTION_INDICES = "FCIX";
+
+/// Value of every stored entry (f64)
+constexpr const char* SECTION_VALUES = "FCVL";
+
+/// Cleaned test texts (length-prefixed strings)
+constexpr const char* SECTION_TEXTS = "FCTX";
+
+/// FNV-1a 64-bit offset basis
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+/// FNV-1a 64-bit prime
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * @brief Folds bytes into an FNV-1a hash
+ * @param hash Running hash
+ * @param data First byte
+ * @param size Number of bytes
+ * @return Updated hash
+ */
+uint64_t fnv1a(uint64_t hash, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Appends rows to the CSR arrays
+ * @param rows Feature rows
+ * @param offsets Row offsets (extended by one entry per row)
+ * @param indices Feature indices
+ * @param values Entry values
+ */
+void appendRows(
+    const std::vector<SparseVector>& rows,
+    std::vector<uint64_t>& offsets,
+    std::vector<int>& indices,
+    std::vector<double>& values
+) {
+    for (const auto& row : rows) {
+        indices.insert(indices.end(), row.indices.begin(), row.indices.end());
+        values.insert(values.end(), row.values.begin(), row.values.end());
+        offsets.push_back(indices.size());
+    }
+}
+
+/**
+ * @brief Rebuilds rows from the CSR arrays
+ * @param offsets Row offsets
+ * @param first Index of the first row to rebuild
+ * @param count Number of rows
+ * @param indices Feature indices
+ * @param values Entry values
+ * @return Feature rows
+ */
+std::vector<SparseVector> extractRows(
+    const std::vector<uint64_t>& offsets,
+    size_t first,
+    size_t count,
+    const std::vector<int>& indices,
+    const std::vector<double>& values
+) {
+    std::vector<SparseVector> rows(count);
+    for (size_t row = 0; row < count; ++row) {
+        uint64_t begin = offsets[first + row];
+        uint64_t end = offsets[first + row + 1];
+        rows[row].indices.assign(indices.begin() + begin, indices.begin() + end);
+        rows[row].values.assign(values.begin() + begin, values.begin() + end);
+    }
+    return rows;
+}
+
+} // namespace
+
+FeatureCache::FeatureCache(std::string directory) : directory(std::move(directory)) {}
+
+std::string FeatureCache::makeKey(const std::string& dataPath, std::string_view settings) {
+    std::shared_ptr<const utils::MappedFile> file = utils::MappedFile::open(dataPath);
+    if (!file) {
+        return "";
+    }
+
+    uint64_t hash = fnv1a(FNV_OFFSET, file->data(), file->size());
+
+    // The file size keeps the boundary between contents and settings unambiguous
+    std::ostringstream suffix;
+    suffix << '\0' << file->size() << '\0' << settings << '\0' << FORMAT_VERSION;
+    std::string tail = suffix.str();
+    hash = fnv1a(hash, reinterpret_cast<const unsigned char*>(tail.data()), tail.size());
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+std::string FeatureCache::pathFor(const std::string& key) const {
+    return (std::filesystem::path(directory) / (key + ".bpf")).string();
+}
+
+bool FeatureCache::load(const std::string& key, FeatureSet& features) const {
+    std::string path = pathFor(key);
+    if (!std::filesystem::exists(path)) {
+        return false;
+    }
+
+    utils::BundleReader bundle;
+    if (!bundle.open(path)) {
+        return false;
+    }
+
+    utils::SectionReader header = bundle.reader(SECTION_HEADER);
+    uint32_t version = header.readU32();
+    uint64_t trainRows = header.readU64();
+    uint64_t testRows = header.readU64();
+    uint64_t entries = header.readU64();
+    if (!header.ok() || version != FORMAT_VERSION) {
+        std::cerr << "Warning: Ignoring feature cache entry with an unknown layout: " << path << std::endl;
+        return false;
+    }
+
+    // Row counts are checked against the offsets section before anything is sized from them
+    uint64_t rows = trainRows + testRows;
+    if (rows < trainRows || bundle.section(SECTION_ROWS).size() / sizeof(uint64_t) != rows + 1) {
+        std::cerr << "Warning: Ignoring damaged feature cache entry: " << path << std::endl;
+        return false;
+    }
+
+    utils::SectionReader labelSection = bundle.reader(SECTION_LABELS);
+    std::vector<int> labels = labelSection.readI32Array(rows);
+
+    utils::SectionReader rowSection = bundle.reader(SECTION_ROWS);
+    std::vector<uint64_t> offsets(rows + 1);
+    for (auto& offset : offsets) {
+        offset = rowSection.readU64();
+    }
+
+    utils::SectionReader indexSection = bundle.reader(SECTION_INDICES);
+    std::vector<int> indices = indexSection.readI32Array(entries);
+    utils::SectionReader valueSection = bundle.reader(SECTION_VALUES);
+    std::vector<double> values = valueSection.readF64Array(entries);
+
+    utils::SectionReader textSection = bundle.reader(SECTION_TEXTS);
+    std::vector<std::string> testTexts(testRows);
+    for (auto& text : testTexts) {
+        text = textSection.readString();
+    }
+
+    bool offsetsValid = offsets.front() == 0 && offsets.back() == entries;
+    for (size_t row = 0; offsetsValid && row < rows; ++row) {
+        offsetsValid = offsets[row] <= offsets[row + 1];
+    }
+    if (!labelSection.ok() || !rowSection.ok() || !indexSection.ok() || !valueSection.ok() ||
+        !textSection.ok() || !offsetsValid) {
+        std::cerr << "Warning: Ignoring damaged feature cache entry: " << path << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<Vectorizer> vectorizer = Vectorizer::loadFromBundle(bundle);
+    if (!vectorizer) {
+        return false;
+    }
+
+    features.trainFeatures = extractRows(offsets, 0, trainRows, indices, values);
+    features.testFeatures = extractRows(offsets, trainRows, testRows, indices, values);
+    features.trainLabels.assign(labels.begin(), labels.begin() + trainRows);
+    features.testLabels.assign(labels.begin() + trainRows, labels.end());
+    features.testTexts = std::move(testTexts);
+    features.vectorizer = std::move(vectorizer);
+    return true;
+}
+
+bool FeatureCache::store(const std::string& key, const FeatureSet& features) const {
+    if (!features.vectorizer || features.trainLabels.size() != features.trainFeatures.size() ||
+        features.testLabels.size() != features.testFeatures.size() ||
+        features.testTexts.size() != features.testFeatures.size()) {
+        return false;
+    }
+
+    std::vector<uint64_t> offsets{0};
+    std::vector<int> indices;
+    std::vector<double> values;
+    appendRows(features.trainFeatures, offsets, indices, values);
+    appendRows(features.testFeatures, offsets, indices, values);
+
+    utils::BundleWriter bundle;
+    auto& header = bundle.addSection(SECTION_HEADER);
+    header.writeU32(FORMAT_VERSION);
+    header.writeU64(features.trainFeatures.size());
+    header.writeU64(features.testFeatures.size());
+    header.writeU64(indices.size());
+
+    auto& labels = bundle.addSection(SECTION_LABELS);
+    labels.writeI32Array(features.trainLabels);
+    labels.writeI32Array(features.testLabels);
+
+    auto& rows = bundle.addSection(SECTION_ROWS);
+    for (uint64_t offset : offsets) {
+        rows.writeU64(offset);
+    }
+    bundle.addSection(SECTION_INDICES).writeI32Array(indices);
+    bundle.addSection(SECTION_VALUES).writeF64Array(values);
+
+    auto& texts = bundle.addSection(SECTION_TEXTS);
+    for (const auto& text : features.testTexts) {
+        texts.writeString(text);
+    }
+
+    features.vectorizer->writeBundle(bundle);
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    return bundle.write(pathFor(key));
+}
+
+} // namespace preprocessing
+} // namespace blahajpi
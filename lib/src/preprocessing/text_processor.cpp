@@ -4,50 +4,213 @@
  */
 
 #include "blahajpi/preprocessing/text_processor.hpp"
+#include "blahajpi/utils/byte_kernels.hpp"
+#include "blahajpi/utils/static_lexicon.hpp"
 #include <algorithm>
 #include <cctype>
 #include <sstream>
-#include <regex>
-#include <unordered_map>
 
 namespace blahajpi {
 namespace preprocessing {
 
-TextProcessor::TextProcessor() {
-    // Initialize stopwords
-    stopwords = {
-        "a", "an", "and", "are", "as", "at", "be", "by", "for", "from",
-        "has", "he", "in", "is", "it", "its", "of", "on", "that", "the",
-        "to", "was", "were", "will", "with", "i", "me", "my", "myself",
-        "we", "our", "ours", "ourselves", "you", "your", "yours",
-        "yourself", "yourselves", "he", "him", "his", "himself", "she",
-        "her", "hers", "herself", "it", "its", "itself", "they", "them",
-        "their", "theirs", "themselves", "what", "which", "who", "whom",
-        "this", "that", "these", "those", "am", "is", "are", "was", "were",
-        "be", "been", "being", "have", "has", "had", "having", "do", "does",
-        "did", "doing", "would", "should", "could", "ought", "i'm", "you're",
-        "he's", "she's", "it's", "we're", "they're", "i've", "you've",
-        "we've", "they've", "i'd", "you'd", "he'd", "she'd", "we'd",
-        "they'd", "i'll", "you'll", "he'll", "she'll", "we'll", "they'll",
-        "isn't", "aren't", "wasn't", "weren't", "hasn't", "haven't", "hadn't",
-        "doesn't", "don't", "didn't", "won't", "wouldn't", "shan't", "shouldn't",
-        "can't", "cannot", "couldn't", "mustn't", "let's", "that's", "who's",
-        "what's", "here's", "there's", "when's", "where's", "why's", "how's",
-        "so", "than", "too", "very", "just", "but", "however", "still"
-    };
-    
-    // Initialize negation words
-    negationWords = {
-        "not", "no", "never", "neither", "none", "nobody", "nowhere",
-        "don't", "dont", "can't", "cant", "won't", "wont", "isn't", "isnt",
-        "aren't", "arent", "wasn't", "wasnt", "weren't", "werent", "hasn't",
-        "hasnt", "haven't", "havent", "hadn't", "hadnt", "doesn't", "doesnt",
-        "didn't", "didnt", "shouldn't", "shouldnt", "wouldn't", "wouldnt",
-        "couldn't", "couldnt", "nothing"
+namespace {
+
+/// Common social media abbreviations (lowercase) and their expansions
+constexpr auto ABBREVIATIONS = utils::makeWordMap({
+    {"u", "you"},
+    {"r", "are"},
+    {"ur", "your"},
+    {"n", "and"},
+    {"y", "why"},
+    {"w/", "with"},
+    {"w/o", "without"},
+    {"btw", "by the way"},
+    {"imo", "in my opinion"},
+    {"idk", "i do not know"},
+    {"lol", "laugh"},
+    {"rofl", "laugh"},
+    {"lmao", "laugh"},
+    {"b/c", "because"},
+    {"cuz", "because"},
+    {"bc", "because"},
+    {"b4", "before"},
+    {"ppl", "people"},
+    {"sry", "sorry"},
+    {"thx", "thanks"},
+    {"ty", "thank you"},
+    {"gd", "good"},
+    {"fwiw", "for what it is worth"},
+    {"tbh", "to be honest"},
+    {"iirc", "if i recall correctly"},
+    {"nvm", "never mind"},
+    {"omg", "oh my god"},
+    {"gtg", "got to go"},
+    {"brb", "be right back"},
+    {"afaik", "as far as i know"},
+    {"irl", "in real life"},
+    {"jk", "just kidding"},
+    {"tfw", "that feeling when"},
+    {"mfw", "my face when"},
+    {"rn", "right now"},
+    {"smh", "shaking my head"},
+    {"tbf", "to be fair"},
+    {"tldr", "too long did not read"},
+    {"yolo", "you only live once"},
+    {"fomo", "fear of missing out"}
+});
+
+/// Default stopwords
+constexpr auto STOPWORDS = utils::makeWordSet({
+    "a", "an", "and", "are", "as", "at", "be", "by", "for", "from",
+    "has", "he", "in", "is", "it", "its", "of", "on", "that", "the",
+    "to", "was", "were", "will", "with", "i", "me", "my", "myself",
+    "we", "our", "ours", "ourselves", "you", "your", "yours",
+    "yourself", "yourselves", "he", "him", "his", "himself", "she",
+    "her", "hers", "herself", "it", "its", "itself", "they", "them",
+    "their", "theirs", "themselves", "what", "which", "who", "whom",
+    "this", "that", "these", "those", "am", "is", "are", "was", "were",
+    "be", "been", "being", "have", "has", "had", "having", "do", "does",
+    "did", "doing", "would", "should", "could", "ought", "i'm", "you're",
+    "he's", "she's", "it's", "we're", "they're", "i've", "you've",
+    "we've", "they've", "i'd", "you'd", "he'd", "she'd", "we'd",
+    "they'd", "i'll", "you'll", "he'll", "she'll", "we'll", "they'll",
+    "isn't", "aren't", "wasn't", "weren't", "hasn't", "haven't", "hadn't",
+    "doesn't", "don't", "didn't", "won't", "wouldn't", "shan't", "shouldn't",
+    "can't", "cannot", "couldn't", "mustn't", "let's", "that's", "who's",
+    "what's", "here's", "there's", "when's", "where's", "why's", "how's",
+    "so", "than", "too", "very", "just", "but", "however", "still"
+});
+
+/// Default negation words
+constexpr auto NEGATION_WORDS = utils::makeWordSet({
+    "not", "no", "never", "neither", "none", "nobody", "nowhere",
+    "don't", "dont", "can't", "cant", "won't", "wont", "isn't", "isnt",
+    "aren't", "arent", "wasn't", "wasnt", "weren't", "werent", "hasn't",
+    "hasnt", "haven't", "havent", "hadn't", "hadnt", "doesn't", "doesnt",
+    "didn't", "didnt", "shouldn't", "shouldnt", "wouldn't", "wouldnt",
+    "couldn't", "couldnt", "nothing"
+});
+
+/**
+ * @brief Gets the token-level steps that the fused stage replaces
+ * @return Step names in the order the fused stage applies them
+ */
+const std::vector<std::string>& fusedStageSteps() {
+    static const std::vector<std::string> steps = {
+        "lowercase",
+        "expand_abbreviations",
+        "handle_negations",
+        "remove_punctuation",
+        "remove_numbers",
+        "normalize_whitespace",
+        "remove_stopwords",
+        "normalize_repeated_chars"
     };
+    return steps;
+}
+
+/**
+ * @brief Checks for a character of [a-zA-Z0-9]
+ * @param c Character to check
+ * @return True for ASCII letters and digits
+ */
+bool isAsciiAlnum(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+/**
+ * @brief Checks for a character of [a-zA-Z0-9_]
+ * @param c Character to check
+ * @return True for characters allowed in mentions and hashtags
+ */
+bool isWordChar(char c) {
+    return isAsciiAlnum(c) || c == '_';
+}
+
+/**
+ * @brief Checks for a character of [a-zA-Z0-9_./?=%&-]
+ * @param c Character to check
+ * @return True for characters allowed in a URL path
+ */
+bool isUrlPathChar(char c) {
+    switch (c) {
+        case '_': case '.': case '/': case '?': case '=': case '%': case '&': case '-':
+            return true;
+        default:
+            return isAsciiAlnum(c);
+    }
+}
+
+/**
+ * @brief Gets the end of the run of [a-zA-Z0-9] starting at a position
+ * @param text Text to scan
+ * @param pos Start of the run
+ * @return Index of the first character after the run
+ */
+size_t alnumRunEnd(std::string_view text, size_t pos) {
+    while (pos < text.size() && isAsciiAlnum(text[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+/**
+ * @brief Matches a URL host and path starting at a position
+ * 
+ * Finds the same match as ([a-zA-Z0-9]+\.)+[a-zA-Z0-9]{2,}(/[a-zA-Z0-9_./?=%&-]*)?
+ * under ECMAScript backtracking. The labels ending in '.' form a chain; the
+ * run after the last dot is the preferred top-level label, and when it is
+ * shorter than two characters the engine falls back to the last earlier
+ * label (not the first) that is, without a path.
+ * 
+ * @param text Text to scan
+ * @param pos Start of the host
+ * @param tailStart Receives the start of the run after the chain's last dot
+ * @return End of the match, or std::string_view::npos if there is none
+ */
+size_t matchUrlHost(std::string_view text, size_t pos, size_t& tailStart) {
+    size_t labels = 0;
+    size_t fallbackEnd = std::string_view::npos;
+    
+    while (true) {
+        size_t end = alnumRunEnd(text, pos);
+        if (end > pos && end < text.size() && text[end] == '.') {
+            ++labels;
+            if (labels >= 2 && end - pos >= 2) {
+                fallbackEnd = end;
+            }
+            pos = end + 1;
+            continue;
+        }
+        
+        tailStart = pos;
+        if (labels == 0) {
+            return std::string_view::npos;
+        }
+        if (end - pos < 2) {
+            return fallbackEnd;
+        }
+        
+        // Optional path
+        if (end < text.size() && text[end] == '/') {
+            ++end;
+            while (end < text.size() && isUrlPathChar(text[end])) {
+                ++end;
+            }
+        }
+        return end;
+    }
+}
+
+} // namespace
+
+TextProcessor::TextProcessor()
+    : stopwords(STOPWORDS.view()),
+      negationWords(NEGATION_WORDS.view()) {
     
     // Initialize preprocessing functions
     initializePreprocessingFunctions();
+    setPipeline({});
 }
 
 TextProcessor::TextProcessor(
@@ -58,34 +221,23 @@ TextProcessor::TextProcessor(
     
     // Initialize preprocessing functions
     initializePreprocessingFunctions();
+    setPipeline({});
 }
 
 std::string TextProcessor::preprocess(
     std::string_view text,
     const std::vector<std::string>& steps
 ) const {
-    // Use provided steps or default pipeline
-    std::vector<std::string> preprocessingSteps = steps;
-    if (preprocessingSteps.empty()) {
-        // Default pipeline
-        preprocessingSteps = {
-            "remove_urls",
-            "remove_mentions",
-            "process_hashtags",
-            "lowercase",
-            "expand_abbreviations",
-            "handle_negations",
-            "remove_punctuation",
-            "remove_numbers",
-            "normalize_whitespace",
-            "remove_stopwords",
-            "normalize_repeated_chars"
-        };
+    // The active pipeline has already been compiled
+    if (steps.empty() || steps == pipelineSteps) {
+        std::string output;
+        runCompiledPipeline(text, output);
+        return output;
     }
     
-    // Apply each preprocessing step in sequence
+    // Apply each requested step in sequence
     std::string processedText(text);
-    for (const auto& step : preprocessingSteps) {
+    for (const auto& step : steps) {
         auto it = preprocessingFunctions.find(step);
         if (it != preprocessingFunctions.end()) {
             processedText = it->second(processedText);
@@ -95,6 +247,36 @@ std::string TextProcessor::preprocess(
     return processedText;
 }
 
+void TextProcessor::preprocessInto(std::string_view text, std::string& output) const {
+    runCompiledPipeline(text, output);
+}
+
+void TextProcessor::setPipeline(const std::vector<std::string>& steps) {
+    pipelineSteps = steps.empty() ? getDefaultPipeline() : steps;
+    compilePipeline();
+}
+
+const std::vector<std::string>& TextProcessor::getPipeline() const {
+    return pipelineSteps;
+}
+
+const std::vector<std::string>& TextProcessor::getDefaultPipeline() {
+    static const std::vector<std::string> steps = {
+        "remove_urls",
+        "remove_mentions",
+        "process_hashtags",
+        "lowercase",
+        "expand_abbreviations",
+        "handle_negations",
+        "remove_punctuation",
+        "remove_numbers",
+        "normalize_whitespace",
+        "remove_stopwords",
+        "normalize_repeated_chars"
+    };
+    return steps;
+}
+
 std::unordered_map<std::string, std::function<std::string(std::string_view)>>
 TextProcessor::getPreprocessingFunctions() const {
     return preprocessingFunctions;
@@ -104,10 +286,17 @@ void TextProcessor::addPreprocessingStep(
     const std::string& name,
     std::function<std::string(std::string_view)> func
 ) {
+    if (preprocessingFunctions.count(name) > 0) {
+        overriddenSteps.insert(name);
+    }
     preprocessingFunctions[name] = std::move(func);
+    
+    // Compiled steps hold copies of the functions
+    compilePipeline();
 }
 
 void TextProcessor::addStopwords(const std::vector<std::string>& words) {
+    // Built-in words stay in the compile-time table; the rest go to the overlay
     for (const auto& word : words) {
         stopwords.insert(word);
     }
@@ -136,75 +325,182 @@ void TextProcessor::initializePreprocessingFunctions() {
     };
 }
 
+void TextProcessor::compilePipeline() {
+    compiledSteps.clear();
+    useFusedStage = false;
+    
+    // Fuse the trailing token-level steps when they appear in the standard
+    // order and still use the built-in implementations
+    const auto& fusedSteps = fusedStageSteps();
+    size_t prefixLength = pipelineSteps.size();
+    
+    if (pipelineSteps.size() >= fusedSteps.size() &&
+        std::equal(fusedSteps.begin(), fusedSteps.end(), pipelineSteps.end() - fusedSteps.size()) &&
+        std::none_of(fusedSteps.begin(), fusedSteps.end(),
+                     [this](const std::string& step) { return overriddenSteps.count(step) > 0; })) {
+        useFusedStage = true;
+        prefixLength -= fusedSteps.size();
+    }
+    
+    // Resolve the remaining steps once; unknown names are skipped as before
+    for (size_t i = 0; i < prefixLength; ++i) {
+        auto it = preprocessingFunctions.find(pipelineSteps[i]);
+        if (it != preprocessingFunctions.end()) {
+            compiledSteps.push_back(it->second);
+        }
+    }
+}
+
+void TextProcessor::runCompiledPipeline(std::string_view text, std::string& output) const {
+    if (compiledSteps.empty()) {
+        if (useFusedStage) {
+            runFusedStage(text, output);
+        } else {
+            output.assign(text);
+        }
+        return;
+    }
+    
+    std::string current = compiledSteps.front()(text);
+    for (size_t i = 1; i < compiledSteps.size(); ++i) {
+        current = compiledSteps[i](current);
+    }
+    
+    if (useFusedStage) {
+        runFusedStage(current, output);
+    } else {
+        output = std::move(current);
+    }
+}
+
+void TextProcessor::runFusedStage(std::string_view text, std::string& output) const {
+    output.clear();
+    output.reserve(text.size());
+    
+    // Per-thread scratch buffers keep the pass allocation-free in steady state
+    thread_local std::string lowered;
+    thread_local std::string token;
+    
+    constexpr int negationScope = 3;
+    bool negate = false;
+    int wordsToNegate = 0;
+    
+    bool firstWord = true;
+    char previousInput = '\0';
+    
+    // normalize_repeated_chars compares each character with the previous
+    // input character and the last two output characters
+    auto emit = [&](char c) {
+        if (output.empty() || c != previousInput ||
+            (output.size() >= 2 && output[output.size() - 1] != output[output.size() - 2])) {
+            output.push_back(c);
+        }
+        previousInput = c;
+    };
+    
+    // Negation marking, punctuation/number removal, stopword removal and
+    // emission for one word produced by abbreviation expansion
+    auto processWord = [&](std::string_view word) {
+        token.clear();
+        
+        if (negationWords.contains(word)) {
+            negate = true;
+            wordsToNegate = negationScope;
+        } else if (negate && wordsToNegate > 0) {
+            // remove_punctuation also strips the underscore of "NOT_"
+            token.append("NOT");
+            if (--wordsToNegate == 0) {
+                negate = false;
+            }
+        }
+        
+        // remove_punctuation and remove_numbers
+        utils::appendFiltered(word, utils::BYTE_PUNCT | utils::BYTE_DIGIT, false, token);
+        
+        // Empty words vanish in normalize_whitespace
+        if (token.empty() || stopwords.contains(token)) {
+            return;
+        }
+        
+        if (!firstWord) {
+            emit(' ');
+        }
+        for (char c : token) {
+            emit(c);
+        }
+        firstWord = false;
+    };
+    
+    // Lowercasing keeps whitespace where it was, so the whole text is
+    // lowered in one vectorized pass and split afterwards
+    lowered.clear();
+    utils::appendFiltered(text, 0, true, lowered);
+    std::string_view lowerText = lowered;
+    
+    size_t pos = 0;
+    while (pos < lowerText.size()) {
+        // Split on whitespace like the stream-based steps do
+        while (pos < lowerText.size() && std::isspace(static_cast<unsigned char>(lowerText[pos]))) {
+            ++pos;
+        }
+        size_t start = pos;
+        while (pos < lowerText.size() && !std::isspace(static_cast<unsigned char>(lowerText[pos]))) {
+            ++pos;
+        }
+        if (start == pos) {
+            break;
+        }
+        
+        std::string_view word = lowerText.substr(start, pos - start);
+        const std::string_view* found = ABBREVIATIONS.find(word);
+        if (found == nullptr) {
+            processWord(word);
+            continue;
+        }
+        
+        // Expansions can contain several words
+        std::string_view expansion = *found;
+        size_t wordStart = 0;
+        while (wordStart < expansion.size()) {
+            size_t wordEnd = expansion.find(' ', wordStart);
+            if (wordEnd == std::string_view::npos) {
+                wordEnd = expansion.size();
+            }
+            if (wordEnd > wordStart) {
+                processWord(expansion.substr(wordStart, wordEnd - wordStart));
+            }
+            wordStart = wordEnd + 1;
+        }
+    }
+}
+
 std::string TextProcessor::lowercase(std::string_view text) const {
-    std::string result(text);
-    std::transform(result.begin(), result.end(), result.begin(),
-                  [](unsigned char c) { return std::tolower(c); });
+    std::string result;
+    utils::appendFiltered(text, 0, true, result);
     return result;
 }
 
 std::string TextProcessor::removePunctuation(std::string_view text) const {
     std::string result;
-    result.reserve(text.size());
-    
-    for (char c : text) {
-        if (!std::ispunct(static_cast<unsigned char>(c))) {
-            result.push_back(c);
-        }
-    }
-    
+    utils::appendFiltered(text, utils::BYTE_PUNCT, false, result);
     return result;
 }
 
 std::string TextProcessor::removeNumbers(std::string_view text) const {
     std::string result;
-    result.reserve(text.size());
-    
-    for (char c : text) {
-        if (!std::isdigit(static_cast<unsigned char>(c))) {
-            result.push_back(c);
-        }
-    }
-    
+    utils::appendFiltered(text, utils::BYTE_DIGIT, false, result);
     return result;
 }
 
 std::string TextProcessor::removeNonAscii(std::string_view text) const {
     std::string result;
-    result.reserve(text.size());
-    
-    for (char c : text) {
-        if (static_cast<unsigned char>(c) < 128) {
-            result.push_back(c);
-        }
-    }
-    
+    utils::appendFiltered(text, utils::BYTE_NON_ASCII, false, result);
     return result;
 }
 
 std::string TextProcessor::normalizeWhitespace(std::string_view text) const {
     std::string result;
-    result.reserve(text.size());
-    
-    bool lastWasSpace = true;  // Start with true to trim leading spaces
-    
-    for (char c : text) {
-        if (std::isspace(static_cast<unsigned char>(c))) {
-            if (!lastWasSpace) {
-                result.push_back(' ');
-            }
-            lastWasSpace = true;
-        } else {
-            result.push_back(c);
-            lastWasSpace = false;
-        }
-    }
-    
-    // Trim trailing space if present
-    if (!result.empty() && result.back() == ' ') {
-        result.pop_back();
-    }
-    
+    utils::appendCollapsedWhitespace(text, result);
     return result;
 }
 
@@ -216,7 +512,7 @@ std::string TextProcessor::removeStopwords(std::string_view text) const {
     bool firstWord = true;
     
     while (iss >> word) {
-        if (stopwords.find(word) == stopwords.end()) {
+        if (!stopwords.contains(word)) {
             if (!firstWord) {
                 oss << ' ';
             }
@@ -241,7 +537,7 @@ std::string TextProcessor::handleNegations(std::string_view text) const {
     
     while (iss >> word) {
         // Check if this is a negation word
-        if (negationWords.find(word) != negationWords.end()) {
+        if (negationWords.contains(word)) {
             negate = true;
             wordsToNegate = negationScope;
             
@@ -272,50 +568,6 @@ std::string TextProcessor::handleNegations(std::string_view text) const {
 }
 
 std::string TextProcessor::expandAbbreviations(std::string_view text) const {
-    // Common social media abbreviations
-    static const std::unordered_map<std::string, std::string> abbreviations = {
-        {"u", "you"},
-        {"r", "are"},
-        {"ur", "your"},
-        {"n", "and"},
-        {"y", "why"},
-        {"w/", "with"},
-        {"w/o", "without"},
-        {"btw", "by the way"},
-        {"imo", "in my opinion"},
-        {"idk", "i do not know"},
-        {"lol", "laugh"},
-        {"rofl", "laugh"},
-        {"lmao", "laugh"},
-        {"b/c", "because"},
-        {"cuz", "because"},
-        {"bc", "because"},
-        {"b4", "before"},
-        {"ppl", "people"},
-        {"sry", "sorry"},
-        {"thx", "thanks"},
-        {"ty", "thank you"},
-        {"gd", "good"},
-        {"fwiw", "for what it is worth"},
-        {"tbh", "to be honest"},
-        {"iirc", "if i recall correctly"},
-        {"nvm", "never mind"},
-        {"omg", "oh my god"},
-        {"gtg", "got to go"},
-        {"brb", "be right back"},
-        {"afaik", "as far as i know"},
-        {"irl", "in real life"},
-        {"jk", "just kidding"},
-        {"tfw", "that feeling when"},
-        {"mfw", "my face when"},
-        {"rn", "right now"},
-        {"smh", "shaking my head"},
-        {"tbf", "to be fair"},
-        {"tldr", "too long did not read"},
-        {"yolo", "you only live once"},
-        {"fomo", "fear of missing out"}
-    };
-    
     std::istringstream iss{std::string(text)};
     std::ostringstream oss;
     std::string word;
@@ -328,10 +580,10 @@ std::string TextProcessor::expandAbbreviations(std::string_view text) const {
                       [](unsigned char c) { return std::tolower(c); });
         
         // Replace abbreviation if found
-        auto it = abbreviations.find(lowerWord);
-        if (it != abbreviations.end()) {
+        const std::string_view* found = ABBREVIATIONS.find(lowerWord);
+        if (found != nullptr) {
             if (!firstWord) oss << ' ';
-            oss << it->second;
+            oss << *found;
         } else {
             if (!firstWord) oss << ' ';
             oss << word;
@@ -343,91 +595,99 @@ std::string TextProcessor::expandAbbreviations(std::string_view text) const {
 }
 
 std::string TextProcessor::normalizeRepeatedChars(std::string_view text) const {
+    std::string result;
+    utils::appendCollapsedRepeats(text, result);
+    return result;
+}
+
+std::string TextProcessor::processHashtags(std::string_view text) const {
     std::string result;
     result.reserve(text.size());
     
-    if (text.empty()) {
-        return result;
-    }
-    
-    // Add first character
-    result.push_back(text[0]);
-    
-    // Add subsequent characters only if they're not repeating more than twice
-    for (size_t i = 1; i < text.size(); ++i) {
-        if (text[i] != text[i-1] || 
-            (result.size() >= 2 && result[result.size()-1] != result[result.size()-2])) {
+    // Each #word becomes its camelCase parts in lowercase ("#TransRights" -> "trans rights")
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '#' || i + 1 >= text.size() || !isWordChar(text[i + 1])) {
             result.push_back(text[i]);
+            continue;
+        }
+        
+        size_t start = i + 1;
+        size_t end = start;
+        while (end < text.size() && isWordChar(text[end])) {
+            unsigned char c = static_cast<unsigned char>(text[end]);
+            if (std::isupper(c) && end > start) {
+                result.push_back(' ');
+            }
+            result.push_back(static_cast<char>(std::tolower(c)));
+            ++end;
         }
+        i = end - 1;
     }
     
     return result;
 }
 
-std::string TextProcessor::processHashtags(std::string_view text) const {
-    std::regex hashtagPattern(R"(#([a-zA-Z0-9_]+))");
-    std::string input(text);
+std::string TextProcessor::removeMentions(std::string_view text) const {
+    std::string result;
+    result.reserve(text.size());
     
-    // Lambda function to process a hashtag match
-    auto processHashtag = [](const std::string& tag) -> std::string {
-        // Remove the # symbol
-        std::string processed = tag.substr(1);
-        
-        // Convert from camelCase to separate words
-        std::string separated;
-        for (char c : processed) {
-            if (std::isupper(c) && !separated.empty() && separated.back() != ' ') {
-                separated.push_back(' ');
+    // Drop every @ followed by [a-zA-Z0-9_]+
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '@' && i + 1 < text.size() && isWordChar(text[i + 1])) {
+            while (i + 1 < text.size() && isWordChar(text[i + 1])) {
+                ++i;
             }
-            separated.push_back(std::tolower(c));
+            continue;
         }
-        
-        return separated;
-    };
+        result.push_back(text[i]);
+    }
     
-    // Use a temporary string to build the result
-    std::string result = input;
+    return result;
+}
+
+std::string TextProcessor::removeUrls(std::string_view text) const {
+    std::string result;
+    result.reserve(text.size());
     
-    // Find all hashtags and replace them
-    std::smatch match;
-    std::string::const_iterator searchStart(input.cbegin());
+    // Hosts starting before this position are already known not to match:
+    // a failed chain also fails from any of its later labels
+    size_t noHostBefore = 0;
     
-    // Find all occurrences
-    while (std::regex_search(searchStart, input.cend(), match, hashtagPattern)) {
-        // Get the hashtag
-        std::string hashtag = match[0].str();
+    size_t i = 0;
+    while (i < text.size()) {
+        size_t tailStart = 0;
         
-        // Process it
-        std::string processed = processHashtag(hashtag);
+        // (https?://)? is tried first, and can start inside a word
+        if (text[i] == 'h') {
+            std::string_view rest = text.substr(i);
+            size_t scheme = rest.starts_with("https://") ? 8 : (rest.starts_with("http://") ? 7 : 0);
+            if (scheme > 0) {
+                size_t end = matchUrlHost(text, i + scheme, tailStart);
+                if (end != std::string_view::npos) {
+                    i = end;
+                    continue;
+                }
+                noHostBefore = std::max(noHostBefore, tailStart);
+            }
+        }
         
-        // Replace in the result string
-        size_t pos = result.find(hashtag);
-        if (pos != std::string::npos) {
-            result.replace(pos, hashtag.length(), processed);
+        // Without a scheme a match starts where an alphanumeric run starts;
+        // if it fails there, it fails from every later position in the run
+        if (isAsciiAlnum(text[i]) && i >= noHostBefore && (i == 0 || !isAsciiAlnum(text[i - 1]))) {
+            size_t end = matchUrlHost(text, i, tailStart);
+            if (end != std::string_view::npos) {
+                i = end;
+                continue;
+            }
+            noHostBefore = std::max(noHostBefore, tailStart);
         }
         
-        // Move to the next position after this match
-        searchStart = match.suffix().first;
+        result.push_back(text[i]);
+        ++i;
     }
     
     return result;
 }
 
-std::string TextProcessor::removeMentions(std::string_view text) const {
-    std::regex mentionPattern(R"(@[a-zA-Z0-9_]+)");
-    std::string input(text);
-    
-    // Replace mentions with empty string
-    return std::regex_replace(input, mentionPattern, "");
-}
-
-std::string TextProcessor::removeUrls(std::string_view text) const {
-    std::regex urlPattern(R"((https?://)?([a-zA-Z0-9]+\.)+[a-zA-Z0-9]{2,}(/[a-zA-Z0-9_./?=%&-]*)?)");
-    std::string input(text);
-    
-    // Replace URLs with empty string
-    return std::regex_replace(input, urlPattern, "");
-}
-
 } // namespace preprocessing
 } // namespace blahajpi
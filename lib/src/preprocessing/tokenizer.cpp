@@ -0,0 +1,207 @@
+/**
+ * @file tokenizer.cpp
+ * @brief Implementation of the allocation-free tokenizer
+ */
+
+#include "blahajpi/preprocessing/tokenizer.hpp"
+#include <bit>
+#include <cstdint>
+
+namespace blahajpi {
+namespace preprocessing {
+
+namespace {
+
+/// 64-bit FNV-1a parameters
+constexpr TermId FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr TermId FNV_PRIME = 1099511628211ULL;
+
+/// Same character set that stream extraction treats as whitespace
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+} // namespace
+
+Tokenizer::Tokenizer(size_t minNgram, size_t maxNgram)
+    : minNgram(minNgram < 1 ? 1 : minNgram),
+      maxNgram(maxNgram < this->minNgram ? this->minNgram : maxNgram) {
+}
+
+void Tokenizer::splitWords(std::string_view text, std::vector<std::string_view>& words) {
+    words.clear();
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && isSeparator(text[pos])) {
+            ++pos;
+        }
+
+        size_t start = pos;
+        while (pos < text.size() && !isSeparator(text[pos])) {
+            ++pos;
+        }
+
+        if (pos > start) {
+            words.push_back(text.substr(start, pos - start));
+        }
+    }
+}
+
+TermId Tokenizer::hashTerm(std::string_view term) {
+    return extendHash(FNV_OFFSET_BASIS, term);
+}
+
+TermId Tokenizer::extendHash(TermId hash, std::string_view bytes) {
+    for (char c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::string Tokenizer::joinTerm(
+    const std::vector<std::string_view>& words,
+    size_t start,
+    size_t length
+) {
+    std::string term(words[start]);
+    for (size_t i = 1; i < length; ++i) {
+        term += '_';
+        term.append(words[start + i]);
+    }
+    return term;
+}
+
+size_t Tokenizer::getMinNgram() const {
+    return minNgram;
+}
+
+size_t Tokenizer::getMaxNgram() const {
+    return maxNgram;
+}
+
+void TermIndex::build(const std::unordered_map<std::string, int>& vocabulary) {
+    clear();
+    if (vocabulary.empty()) {
+        return;
+    }
+
+    // Keep the load factor at or below one half so probe chains stay short
+    size_t capacity = 16;
+    while (capacity < vocabulary.size() * 2) {
+        capacity <<= 1;
+    }
+
+    auto storage = std::make_shared<std::vector<Slot>>(capacity);
+    mask = capacity - 1;
+
+    for (const auto& [term, index] : vocabulary) {
+        TermId id = Tokenizer::hashTerm(term);
+
+        size_t pos = slotFor(id);
+        while ((*storage)[pos].index >= 0 && (*storage)[pos].id != id) {
+            pos = (pos + 1) & mask;
+        }
+
+        // A 64-bit collision between two vocabulary terms keeps the first one
+        if ((*storage)[pos].index < 0) {
+            (*storage)[pos].id = id;
+            (*storage)[pos].index = index;
+            ++count;
+        }
+    }
+
+    slots = std::shared_ptr<const Slot>(storage, storage->data());
+}
+
+size_t TermIndex::size() const {
+    return count;
+}
+
+void TermIndex::clear() {
+    slots.reset();
+    mask = 0;
+    count = 0;
+}
+
+std::vector<unsigned char> TermIndex::serialize() const {
+    size_t slotCount = slots ? mask + 1 : 0;
+    std::vector<unsigned char> bytes(slotCount * SERIALIZED_SLOT_SIZE, 0);
+
+    for (size_t i = 0; i < slotCount; ++i) {
+        const Slot& slot = slots.get()[i];
+        unsigned char* out = bytes.data() + i * SERIALIZED_SLOT_SIZE;
+        uint32_t index = static_cast<uint32_t>(slot.index);
+        for (size_t b = 0; b < 8; ++b) {
+            out[b] = static_cast<unsigned char>(slot.id >> (8 * b));
+        }
+        for (size_t b = 0; b < 4; ++b) {
+            out[8 + b] = static_cast<unsigned char>(index >> (8 * b));
+        }
+    }
+
+    return bytes;
+}
+
+bool TermIndex::deserialize(
+    std::span<const unsigned char> bytes,
+    size_t featureCount,
+    std::shared_ptr<const void> owner
+) {
+    clear();
+    if (bytes.empty()) {
+        return true;
+    }
+
+    size_t slotCount = bytes.size() / SERIALIZED_SLOT_SIZE;
+    if (bytes.size() % SERIALIZED_SLOT_SIZE != 0 || (slotCount & (slotCount - 1)) != 0) {
+        return false;
+    }
+
+    bool layoutMatches = std::endian::native == std::endian::little &&
+                         sizeof(Slot) == SERIALIZED_SLOT_SIZE &&
+                         reinterpret_cast<uintptr_t>(bytes.data()) % alignof(Slot) == 0;
+
+    if (layoutMatches) {
+        // Use the serialized slots in place
+        slots = std::shared_ptr<const Slot>(owner, reinterpret_cast<const Slot*>(bytes.data()));
+    } else {
+        auto storage = std::make_shared<std::vector<Slot>>(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) {
+            const unsigned char* in = bytes.data() + i * SERIALIZED_SLOT_SIZE;
+            uint64_t id = 0;
+            uint32_t index = 0;
+            for (size_t b = 0; b < 8; ++b) {
+                id |= static_cast<uint64_t>(in[b]) << (8 * b);
+            }
+            for (size_t b = 0; b < 4; ++b) {
+                index |= static_cast<uint32_t>(in[8 + b]) << (8 * b);
+            }
+            (*storage)[i].id = id;
+            (*storage)[i].index = static_cast<int>(index);
+        }
+        slots = std::shared_ptr<const Slot>(storage, storage->data());
+    }
+
+    mask = slotCount - 1;
+    bool indicesValid = true;
+    for (size_t i = 0; i < slotCount; ++i) {
+        int index = slots.get()[i].index;
+        if (index >= 0) {
+            indicesValid = indicesValid && static_cast<size_t>(index) < featureCount;
+            ++count;
+        }
+    }
+
+    // Probing stops at an empty slot, so a full table would never terminate
+    if (!indicesValid || count == slotCount) {
+        clear();
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace preprocessing
+} // namespace blahajpi
@@ -4,17 +4,222 @@
  */
 
 #include "blahajpi/preprocessing/vectorizer.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include "blahajpi/utils/parallel.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <sstream>
-#include <set>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <numeric>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 
 namespace blahajpi {
 namespace preprocessing {
 
+namespace {
+
+/// File header written by HashingVectorizer::save()
+constexpr char HASHING_MAGIC[8] = {'B', 'P', 'I', 'H', 'S', 'H', '0', '1'};
+
+/// Largest supported hash-bits value (2^30 buckets)
+constexpr size_t MAX_HASH_BITS = 30;
+
+/// Bundle sections written by the vectorizers
+constexpr const char* SECTION_VECTORIZER = "VECT";  ///< Kind and parameters
+constexpr const char* SECTION_DOC_FREQS = "DFRQ";   ///< Document frequency per feature
+constexpr const char* SECTION_IDF = "IDFW";         ///< IDF weight per feature
+constexpr const char* SECTION_TERMS = "TERM";       ///< Term strings by feature index
+constexpr const char* SECTION_TERM_INDEX = "TIDX";  ///< Serialized TermIndex slots
+
+/// Vectorizer kinds recorded in the VECT section
+constexpr uint32_t KIND_TFIDF = 0;
+constexpr uint32_t KIND_HASHING = 1;
+
+/// Documents each fit worker needs before another worker pays off
+constexpr size_t MIN_DOCS_PER_FIT_WORKER = 256;
+
+/// Documents counted per TF-IDF fit round, after which counts are merged and pruned
+constexpr size_t FIT_ROUND_DOCS = 16384;
+
+/**
+ * @brief Scales values to unit L2 norm
+ * @param values Values to normalize in place
+ */
+void l2Normalize(std::vector<double>& values) {
+    double squaredSum = 0.0;
+    for (const auto& val : values) {
+        squaredSum += val * val;
+    }
+    
+    if (squaredSum > 0.0) {
+        double norm = std::sqrt(squaredSum);
+        for (auto& val : values) {
+            val /= norm;
+        }
+    }
+}
+
+/**
+ * @brief Locates an n-gram in the document its words were split from
+ * @param text Document
+ * @param words Words of the document (views into text)
+ * @param start Index of the first word
+ * @param length Number of words
+ * @return Byte span from the first word's start to the last word's end
+ */
+FeatureSpan locateTerm(std::string_view text, const std::vector<std::string_view>& words, size_t start, size_t length) {
+    std::string_view last = words[start + length - 1];
+    size_t begin = static_cast<size_t>(words[start].data() - text.data());
+    size_t end = static_cast<size_t>(last.data() - text.data()) + last.size();
+    return {static_cast<uint32_t>(begin), static_cast<uint32_t>(end - begin)};
+}
+
+/**
+ * @brief Picks the first occurrence of each counted feature
+ * @param located Every hit as (feature, span), in document order (reordered)
+ * @param counts Counted features with ascending indices
+ * @param spans Output span for each entry of counts
+ */
+void firstSpans(
+    std::vector<std::pair<int, FeatureSpan>>& located,
+    const std::vector<FeatureCount>& counts,
+    std::vector<FeatureSpan>& spans
+) {
+    // Stable, so each feature's hits stay in document order
+    std::stable_sort(located.begin(), located.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    spans.clear();
+    size_t hit = 0;
+    for (const auto& entry : counts) {
+        while (located[hit].first < entry.index) {
+            ++hit;
+        }
+        spans.push_back(located[hit].second);
+    }
+}
+
+} // namespace
+
+std::unique_ptr<Vectorizer> Vectorizer::loadFromFile(const std::string& filePath) {
+    // TF-IDF files predate file headers, so anything unrecognized is read as one
+    std::unique_ptr<Vectorizer> vectorizer;
+    if (HashingVectorizer::isVectorizerFile(filePath)) {
+        vectorizer = std::make_unique<HashingVectorizer>();
+    } else {
+        vectorizer = std::make_unique<TfidfVectorizer>();
+    }
+    
+    if (!vectorizer->load(filePath)) {
+        return nullptr;
+    }
+    
+    return vectorizer;
+}
+
+void Vectorizer::setFitThreads(size_t threads) {
+    fitThreads = std::max<size_t>(1, threads);
+}
+
+size_t Vectorizer::fitWorkers(size_t documents) const {
+    return std::clamp<size_t>(documents / MIN_DOCS_PER_FIT_WORKER, 1, fitThreads);
+}
+
+double Vectorizer::termFrequencyWeight(int count, bool sublinearTf) {
+    double tf = static_cast<double>(std::abs(count));
+    if (sublinearTf) {
+        tf = 1.0 + std::log(tf);  // Sublinear scaling
+    }
+    return count < 0 ? -tf : tf;
+}
+
+SparseVector Vectorizer::buildFeatureVector(std::string_view text) const {
+    thread_local std::vector<FeatureCount> counts;
+    countFeatures(text, counts);
+    
+    const std::vector<double>& idf = getIdfWeights();
+    bool sublinearTf = usesSublinearTf();
+    
+    SparseVector featureVector;
+    featureVector.indices.reserve(counts.size());
+    featureVector.values.reserve(counts.size());
+    for (const auto& entry : counts) {
+        featureVector.indices.push_back(entry.index);
+        featureVector.values.push_back(termFrequencyWeight(entry.count, sublinearTf) * idf[entry.index]);
+    }
+    
+    // Normalize the feature vector (L2 norm)
+    l2Normalize(featureVector.values);
+    
+    return featureVector;
+}
+
+std::unique_ptr<Vectorizer> Vectorizer::loadFromBundle(const utils::BundleReader& bundle) {
+    utils::SectionReader header = bundle.reader(SECTION_VECTORIZER);
+    uint32_t kind = header.readU32();
+    if (!header.ok()) {
+        std::cerr << "Error: Model bundle has no vectorizer" << std::endl;
+        return nullptr;
+    }
+    
+    std::unique_ptr<Vectorizer> vectorizer;
+    if (kind == KIND_TFIDF) {
+        vectorizer = std::make_unique<TfidfVectorizer>();
+    } else if (kind == KIND_HASHING) {
+        vectorizer = std::make_unique<HashingVectorizer>();
+    } else {
+        std::cerr << "Error: Unknown vectorizer kind in model bundle: " << kind << std::endl;
+        return nullptr;
+    }
+    
+    if (!vectorizer->readBundle(bundle)) {
+        return nullptr;
+    }
+    
+    return vectorizer;
+}
+
+size_t SparseVector::nonZeroCount() const {
+    return indices.size();
+}
+
+std::vector<double> SparseVector::toDense(size_t dimension) const {
+    std::vector<double> dense(dimension, 0.0);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (static_cast<size_t>(indices[i]) < dimension) {
+            dense[indices[i]] = values[i];
+        }
+    }
+    return dense;
+}
+
+double SparseVector::dot(const std::vector<double>& weights) const {
+    double sum = 0.0;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (static_cast<size_t>(indices[i]) < weights.size()) {
+            sum += values[i] * weights[indices[i]];
+        }
+    }
+    return sum;
+}
+
+std::vector<std::vector<double>> toDenseMatrix(
+    const std::vector<SparseVector>& rows,
+    size_t dimension
+) {
+    std::vector<std::vector<double>> dense;
+    dense.reserve(rows.size());
+    for (const auto& row : rows) {
+        dense.push_back(row.toDense(dimension));
+    }
+    return dense;
+}
+
 TfidfVectorizer::TfidfVectorizer(
     bool sublinearTf,
     double maxDf,
@@ -29,30 +234,25 @@ TfidfVectorizer::TfidfVectorizer(
     totalDocuments(0) {
     
     // Validate parameters
-    if (minNgram < 1) {
-        minNgram = 1;
+    if (this->minNgram < 1) {
+        this->minNgram = 1;
     }
     
-    if (maxNgram < minNgram) {
-        maxNgram = minNgram;
+    if (this->maxNgram < this->minNgram) {
+        this->maxNgram = this->minNgram;
     }
     
     if (maxDf <= 0.0 || maxDf > 1.0) {
         maxDf = 1.0;
     }
+    
+    tokenizer = Tokenizer(this->minNgram, this->maxNgram);
 }
 
 std::vector<std::string> TfidfVectorizer::tokenize(std::string_view text) const {
     // Extract individual words first
-    std::istringstream iss{std::string(text)};
-    std::vector<std::string> words;
-    std::string word;
-
-    while (iss >> word) {
-        if (!word.empty()) {
-            words.push_back(word);
-        }
-    }
+    std::vector<std::string_view> words;
+    Tokenizer::splitWords(text, words);
     
     std::vector<std::string> tokens;
     
@@ -61,57 +261,267 @@ std::vector<std::string> TfidfVectorizer::tokenize(std::string_view text) const
         // Skip if there aren't enough words for this n-gram size
         if (words.size() < n) continue;
         
-        // Generate n-grams of length n
+        // Generate n-grams of length n, joined with underscores
         for (size_t i = 0; i <= words.size() - n; ++i) {
-            std::string ngram = words[i];
-            
-            // Build n-gram by concatenating words with underscores
-            for (size_t j = 1; j < n; ++j) {
-                ngram += "_" + words[i + j];
-            }
-            
-            tokens.push_back(ngram);
+            tokens.push_back(Tokenizer::joinTerm(words, i, n));
         }
     }
     
     return tokens;
 }
 
+void TfidfVectorizer::fit(const std::vector<std::string>& texts) {
+    fit(texts, maxDf, maxFeatures);
+}
+
 void TfidfVectorizer::fit(
     const std::vector<std::string>& texts,
     double maxDf,
     size_t maxFeatures
 ) {
+    // Override parameters if provided
+    if (maxDf > 0.0) {
+        this->maxDf = maxDf;
+    }
+    
+    if (maxFeatures > 0) {
+        this->maxFeatures = maxFeatures;
+    }
+    
+    beginFit();
+    partialFit(texts);
+    finishFit();
+}
+
+void TfidfVectorizer::beginFit() {
     // Reset state
     vocabulary.clear();
     documentFrequencies.clear();
-    totalDocuments = texts.size();
+    idfWeights.clear();
+    termIndex.clear();
+    for (auto& shard : pendingTerms) {
+        shard.clear();
+    }
+    prunedDocFreq = 0;
+    totalDocuments = 0;
+}
+
+void TfidfVectorizer::setMinDf(double minDf) {
+    this->minDf = minDf > 0.0 ? minDf : 1.0;
+}
+
+void TfidfVectorizer::setMaxPendingTerms(size_t maxTerms) {
+    maxPendingTerms = maxTerms;
+}
+
+void TfidfVectorizer::partialFit(const std::vector<std::string>& texts) {
+    totalDocuments += static_cast<int>(texts.size());
+    
+    // Rounds have a fixed size, so pruning sees the same counts for any
+    // thread count and the private counts of the workers stay bounded
+    size_t workers = fitWorkers(texts.size());
+    std::vector<PendingShards> local(workers > 1 ? workers : 0);
+    std::span<const std::string> input(texts);
+    for (size_t roundStart = 0; roundStart < texts.size(); roundStart += FIT_ROUND_DOCS) {
+        auto round = input.subspan(roundStart, std::min(FIT_ROUND_DOCS, texts.size() - roundStart));
+        
+        if (workers == 1) {
+            countDocuments(round, pendingTerms);
+        } else {
+            // Each worker counts one slice of the round into private shards
+            size_t sliceSize = (round.size() + workers - 1) / workers;
+            utils::parallelFor(workers, workers, [&](size_t worker) {
+                size_t begin = std::min(round.size(), worker * sliceSize);
+                size_t end = std::min(round.size(), begin + sliceSize);
+                countDocuments(round.subspan(begin, end - begin), local[worker]);
+            });
+            
+            // Each task owns one shard of the totals; slices are merged in
+            // document order, so a term keeps the text of its first occurrence
+            utils::parallelFor(pendingTerms.size(), workers, [&](size_t shard) {
+                auto& totals = pendingTerms[shard];
+                for (auto& counts : local) {
+                    for (auto& [id, stats] : counts[shard]) {
+                        auto& total = totals[id];
+                        if (total.docFreq == 0) {
+                            total.term = std::move(stats.term);
+                        }
+                        total.docFreq += stats.docFreq;
+                    }
+                    counts[shard].clear();
+                }
+            });
+        }
+        
+        prunePendingTerms(workers);
+    }
+}
+
+void TfidfVectorizer::prunePendingTerms(size_t workers) {
+    if (maxPendingTerms == 0) {
+        return;
+    }
+    
+    size_t pending = 0;
+    for (const auto& shard : pendingTerms) {
+        pending += shard.size();
+    }
+    if (pending <= maxPendingTerms) {
+        return;
+    }
+    
+    // Keep about half the budget so pruning does not run after every round
+    std::vector<int> frequencies;
+    frequencies.reserve(pending);
+    for (const auto& shard : pendingTerms) {
+        for (const auto& [id, stats] : shard) {
+            frequencies.push_back(stats.docFreq);
+        }
+    }
+    size_t keep = std::max<size_t>(maxPendingTerms / 2, 1);
+    std::nth_element(frequencies.begin(), frequencies.begin() + (keep - 1), frequencies.end(), std::greater<int>());
+    int cutoff = frequencies[keep - 1];
+    
+    // Terms tied at the cutoff stay only if they fit in the limit
+    size_t atLeastCutoff = static_cast<size_t>(std::count_if(
+        frequencies.begin(), frequencies.end(), [cutoff](int freq) { return freq >= cutoff; }));
+    int dropAtOrBelow = atLeastCutoff <= maxPendingTerms ? cutoff - 1 : cutoff;
+    prunedDocFreq = std::max(prunedDocFreq, dropAtOrBelow);
+    
+    utils::parallelFor(pendingTerms.size(), workers, [&](size_t shard) {
+        std::erase_if(pendingTerms[shard], [dropAtOrBelow](const auto& entry) {
+            return entry.second.docFreq <= dropAtOrBelow;
+        });
+    });
+}
+
+void TfidfVectorizer::countDocuments(std::span<const std::string> texts, PendingShards& shards) const {
+    // Term occurrences of the current document: ID plus where to find its words
+    struct Occurrence {
+        TermId id;
+        uint32_t start;
+        uint32_t length;
+    };
+    std::vector<Occurrence> occurrences;
+    std::vector<std::string_view> words;
     
+    // Process each document
+    for (const auto& text : texts) {
+        Tokenizer::splitWords(text, words);
+        
+        occurrences.clear();
+        tokenizer.forEachTerm(words, [&occurrences](TermId id, size_t start, size_t length) {
+            occurrences.push_back({id, static_cast<uint32_t>(start), static_cast<uint32_t>(length)});
+        });
+        
+        // Count each term only once per document
+        std::sort(occurrences.begin(), occurrences.end(),
+                  [](const Occurrence& a, const Occurrence& b) { return a.id < b.id; });
+        
+        for (size_t i = 0; i < occurrences.size(); ++i) {
+            if (i > 0 && occurrences[i].id == occurrences[i - 1].id) {
+                continue;
+            }
+            
+            TermId id = occurrences[i].id;
+            auto& stats = shards[id >> (64 - PENDING_SHARD_BITS)][id];
+            if (stats.docFreq++ == 0) {
+                stats.term = Tokenizer::joinTerm(words, occurrences[i].start, occurrences[i].length);
+            }
+        }
+    }
+}
+
+void TfidfVectorizer::finishFit() {
     if (totalDocuments == 0) {
+        for (auto& shard : pendingTerms) {
+            shard.clear();
+        }
         return;  // Nothing to fit
     }
     
-    // Override parameters if provided
-    if (maxDf > 0.0) {
-        this->maxDf = maxDf;
+    // Convert maxDf and minDf from fractions to absolute counts if needed
+    int maxDfCount = (maxDf < 1.0) ? 
+                     static_cast<int>(maxDf * totalDocuments) : 
+                     static_cast<int>(maxDf);
+    int minDfCount = (minDf < 1.0) ?
+                     static_cast<int>(std::ceil(minDf * totalDocuments)) :
+                     static_cast<int>(minDf);
+    
+    // Filter terms by document frequency
+    std::vector<std::pair<std::string, int>> filteredTerms;
+    
+    for (auto& shard : pendingTerms) {
+        for (auto& [id, stats] : shard) {
+            if (stats.docFreq >= minDfCount && stats.docFreq <= maxDfCount) {
+                filteredTerms.emplace_back(std::move(stats.term), stats.docFreq);
+            }
+        }
+        shard.clear();
     }
     
-    if (maxFeatures > 0) {
-        this->maxFeatures = maxFeatures;
+    // Descending frequency for feature selection (ties by term)
+    auto moreFrequent = [](const auto& a, const auto& b) { 
+        return a.second != b.second ? a.second > b.second : a.first < b.first; 
+    };
+    
+    // Select the top maxFeatures, then order only those
+    if (filteredTerms.size() > maxFeatures) {
+        std::nth_element(filteredTerms.begin(), filteredTerms.begin() + maxFeatures, filteredTerms.end(), moreFrequent);
+        filteredTerms.resize(maxFeatures);
     }
+    std::sort(filteredTerms.begin(), filteredTerms.end(), moreFrequent);
     
-    // Tokenize all documents
-    std::vector<std::vector<std::string>> tokenizedDocs(texts.size());
+    // Build vocabulary and document frequency vector
+    vocabulary.clear();
+    documentFrequencies.clear();
+    documentFrequencies.reserve(filteredTerms.size());
     
-    for (size_t i = 0; i < texts.size(); ++i) {
-        tokenizedDocs[i] = tokenize(texts[i]);
+    for (size_t i = 0; i < filteredTerms.size(); ++i) {
+        const auto& [term, freq] = filteredTerms[i];
+        vocabulary[term] = static_cast<int>(i);
+        documentFrequencies.push_back(freq);
     }
     
-    // Build vocabulary and calculate document frequencies
-    buildVocabulary(tokenizedDocs, this->maxDf, this->maxFeatures);
+    termIndex.build(vocabulary);
+    updateIdfWeights();
     
     std::cout << "Built vocabulary with " << vocabulary.size() 
               << " features (n-gram range: " << minNgram << "-" << maxNgram << ")" << std::endl;
+    if (prunedDocFreq > 0) {
+        std::cout << "Pruned rare terms while counting; document frequencies may be undercounted by up to "
+                  << prunedDocFreq << std::endl;
+    }
+}
+
+std::vector<int> TfidfVectorizer::compact(const std::vector<bool>& keep) {
+    if (keep.size() != documentFrequencies.size()) {
+        throw std::invalid_argument("Expected one keep flag per feature");
+    }
+    
+    std::vector<int> newIndex(keep.size(), -1);
+    std::vector<int> keptFrequencies;
+    for (size_t i = 0; i < keep.size(); ++i) {
+        if (keep[i]) {
+            newIndex[i] = static_cast<int>(keptFrequencies.size());
+            keptFrequencies.push_back(documentFrequencies[i]);
+        }
+    }
+    
+    for (auto it = vocabulary.begin(); it != vocabulary.end();) {
+        int index = newIndex[static_cast<size_t>(it->second)];
+        if (index < 0) {
+            it = vocabulary.erase(it);
+        } else {
+            it->second = index;
+            ++it;
+        }
+    }
+    documentFrequencies = std::move(keptFrequencies);
+    
+    termIndex.build(vocabulary);
+    updateIdfWeights();
+    return newIndex;
 }
 
 std::vector<std::vector<double>> TfidfVectorizer::transform(
@@ -125,12 +535,28 @@ std::vector<std::vector<double>> TfidfVectorizer::transform(
     
     // Process each document
     for (size_t i = 0; i < texts.size(); ++i) {
-        featureMatrix[i] = transformSingleDocument(texts[i]);
+        featureMatrix[i] = buildFeatureVector(texts[i]).toDense(vocabulary.size());
     }
     
     return featureMatrix;
 }
 
+std::vector<SparseVector> TfidfVectorizer::transformSparse(
+    const std::vector<std::string>& texts
+) const {
+    if (vocabulary.empty()) {
+        throw std::runtime_error("Vocabulary is empty. Call fit() first.");
+    }
+    
+    std::vector<SparseVector> featureRows(texts.size());
+    
+    for (size_t i = 0; i < texts.size(); ++i) {
+        featureRows[i] = buildFeatureVector(texts[i]);
+    }
+    
+    return featureRows;
+}
+
 std::vector<std::vector<double>> TfidfVectorizer::fitTransform(
     const std::vector<std::string>& texts
 ) {
@@ -239,6 +665,10 @@ bool TfidfVectorizer::load(const std::string& filePath) {
         file.read(reinterpret_cast<char*>(documentFrequencies.data()), 
                  dfSize * sizeof(int));
         
+        tokenizer = Tokenizer(minNgram, maxNgram);
+        termIndex.build(vocabulary);
+        updateIdfWeights();
+        
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error loading vectorizer: " << e.what() << std::endl;
@@ -246,119 +676,187 @@ bool TfidfVectorizer::load(const std::string& filePath) {
     }
 }
 
-std::vector<double> TfidfVectorizer::transformSingleDocument(const std::string& text) const {
-    // Count term frequencies in this document
-    std::unordered_map<std::string, int> termFreqs;
-    for (const auto& token : tokenize(text)) {
-        termFreqs[token]++;
-    }
+void TfidfVectorizer::writeBundle(utils::BundleWriter& bundle) const {
+    auto& header = bundle.addSection(SECTION_VECTORIZER);
+    header.writeU32(KIND_TFIDF);
+    header.writeU8(sublinearTf ? 1 : 0);
+    header.writeF64(maxDf);
+    header.writeU64(maxFeatures);
+    header.writeU32(static_cast<uint32_t>(minNgram));
+    header.writeU32(static_cast<uint32_t>(maxNgram));
+    header.writeI64(totalDocuments);
+    header.writeU64(vocabulary.size());
     
-    // Create and initialize feature vector
-    std::vector<double> featureVector(vocabulary.size(), 0.0);
+    bundle.addSection(SECTION_DOC_FREQS).writeI32Array(documentFrequencies);
+    bundle.addSection(SECTION_IDF).writeF64Array(idfWeights);
     
-    // Calculate TF-IDF for each term in the vocabulary
-    for (const auto& [term, freq] : termFreqs) {
-        // Skip terms not in vocabulary
-        auto it = vocabulary.find(term);
-        if (it == vocabulary.end()) {
-            continue;
-        }
-        
-        // Get the feature index and document frequency
-        int featureIdx = it->second;
-        int docFreq = documentFrequencies[featureIdx];
-        
-        // Calculate TF-IDF
-        double tf = static_cast<double>(freq);
-        if (sublinearTf) {
-            tf = 1.0 + std::log(tf);  // Sublinear scaling
-        }
-        
-        double idf = std::log(static_cast<double>(totalDocuments + 1) / 
-                             (docFreq + 1)) + 1.0;  // Smoothed IDF
-        
-        featureVector[featureIdx] = tf * idf;
+    // Terms ordered by feature index: offsets first, then the string bytes
+    std::vector<std::string_view> terms(vocabulary.size());
+    for (const auto& [term, index] : vocabulary) {
+        terms[index] = term;
     }
     
-    // Normalize the feature vector (L2 norm)
-    normalizeVector(featureVector);
+    auto& termSection = bundle.addSection(SECTION_TERMS);
+    termSection.writeU32(static_cast<uint32_t>(terms.size()));
+    uint32_t offset = 0;
+    termSection.writeU32(offset);
+    for (const auto& term : terms) {
+        offset += static_cast<uint32_t>(term.size());
+        termSection.writeU32(offset);
+    }
+    for (const auto& term : terms) {
+        termSection.writeBytes(term.data(), term.size());
+    }
     
-    return featureVector;
+    std::vector<unsigned char> slots = termIndex.serialize();
+    bundle.addSection(SECTION_TERM_INDEX).writeBytes(slots.data(), slots.size());
 }
 
-void TfidfVectorizer::normalizeVector(std::vector<double>& vector) const {
-    double squaredSum = 0.0;
-    for (const auto& val : vector) {
-        squaredSum += val * val;
+bool TfidfVectorizer::readBundle(const utils::BundleReader& bundle) {
+    utils::SectionReader header = bundle.reader(SECTION_VECTORIZER);
+    uint32_t kind = header.readU32();
+    bool sublinear = header.readU8() != 0;
+    double maxDfValue = header.readF64();
+    uint64_t maxFeatureCount = header.readU64();
+    uint32_t ngramMin = header.readU32();
+    uint32_t ngramMax = header.readU32();
+    int64_t docCount = header.readI64();
+    uint64_t featureCount = header.readU64();
+    
+    if (!header.ok() || kind != KIND_TFIDF || ngramMin < 1 || ngramMax < ngramMin) {
+        std::cerr << "Error: Invalid TF-IDF vectorizer section in model bundle" << std::endl;
+        return false;
     }
     
-    if (squaredSum > 0.0) {
-        double norm = std::sqrt(squaredSum);
-        for (auto& val : vector) {
-            val /= norm;
+    utils::SectionReader freqSection = bundle.reader(SECTION_DOC_FREQS);
+    std::vector<int> frequencies = freqSection.readI32Array(featureCount);
+    
+    // Bundles written before IDF weights were stored get them recomputed
+    bool hasIdf = bundle.hasSection(SECTION_IDF);
+    utils::SectionReader idfSection = bundle.reader(SECTION_IDF);
+    std::vector<double> idf = hasIdf ? idfSection.readF64Array(featureCount) : std::vector<double>();
+    
+    // Term strings are copied into the vocabulary map; offsets are validated first
+    utils::SectionReader termSection = bundle.reader(SECTION_TERMS);
+    uint32_t termCount = termSection.readU32();
+    std::vector<uint32_t> offsets;
+    if (termCount == featureCount) {
+        offsets.reserve(termCount + 1);
+        for (uint32_t i = 0; i <= termCount; ++i) {
+            offsets.push_back(termSection.readU32());
         }
     }
-}
-
-void TfidfVectorizer::buildVocabulary(
-    const std::vector<std::vector<std::string>>& tokenizedDocs,
-    double maxDf,
-    size_t maxFeatures
-) {
-    // Count document frequency for each term
-    std::unordered_map<std::string, int> docFreqs;
+    std::span<const unsigned char> blob = termSection.readBytes(termSection.remaining());
     
-    // Process each document
-    for (const auto& doc : tokenizedDocs) {
-        // Use set to count each term only once per document
-        std::set<std::string> uniqueTerms(doc.begin(), doc.end());
-        
-        // Count document frequency for each unique term
-        for (const auto& term : uniqueTerms) {
-            docFreqs[term]++;
-        }
+    bool termsValid = freqSection.ok() && idfSection.ok() && termSection.ok() && termCount == featureCount &&
+                      !offsets.empty() && offsets.front() == 0 && offsets.back() == blob.size() &&
+                      std::is_sorted(offsets.begin(), offsets.end());
+    if (!termsValid) {
+        std::cerr << "Error: Invalid vocabulary sections in model bundle" << std::endl;
+        return false;
     }
     
-    // Convert maxDf from fraction to absolute count if needed
-    int maxDfCount = (maxDf < 1.0) ? 
-                     static_cast<int>(maxDf * totalDocuments) : 
-                     static_cast<int>(maxDf);
+    std::unordered_map<std::string, int> terms;
+    terms.reserve(termCount);
+    for (uint32_t i = 0; i < termCount; ++i) {
+        const char* begin = reinterpret_cast<const char*>(blob.data()) + offsets[i];
+        terms.emplace(std::string(begin, offsets[i + 1] - offsets[i]), static_cast<int>(i));
+    }
     
-    // Filter terms by document frequency
-    std::vector<std::pair<std::string, int>> filteredTerms;
-    filteredTerms.reserve(docFreqs.size());
+    // The lookup table is used straight from the mapped bundle
+    TermIndex index;
+    if (!index.deserialize(bundle.section(SECTION_TERM_INDEX), featureCount, bundle.getFile()) ||
+        index.size() != termCount) {
+        std::cerr << "Error: Invalid term index in model bundle" << std::endl;
+        return false;
+    }
     
-    for (const auto& [term, freq] : docFreqs) {
-        if (freq <= maxDfCount) {
-            filteredTerms.emplace_back(term, freq);
-        }
+    sublinearTf = sublinear;
+    maxDf = maxDfValue;
+    maxFeatures = maxFeatureCount;
+    minNgram = ngramMin;
+    maxNgram = ngramMax;
+    totalDocuments = static_cast<int>(docCount);
+    vocabulary = std::move(terms);
+    documentFrequencies = std::move(frequencies);
+    idfWeights = std::move(idf);
+    tokenizer = Tokenizer(minNgram, maxNgram);
+    termIndex = std::move(index);
+    if (!hasIdf) {
+        updateIdfWeights();
     }
     
-    // Sort by descending frequency for feature selection
-    std::sort(
-        filteredTerms.begin(), filteredTerms.end(),
-        [](const auto& a, const auto& b) { 
-            return a.second > b.second; 
+    return true;
+}
+
+TermCoverage TfidfVectorizer::countFeatures(
+    std::string_view text,
+    std::vector<FeatureCount>& counts,
+    std::vector<FeatureSpan>* spans
+) const {
+    // Scratch buffers are reused across calls on the same thread
+    thread_local std::vector<std::string_view> words;
+    thread_local std::vector<int> featureHits;
+    thread_local std::vector<std::pair<int, FeatureSpan>> located;
+    
+    Tokenizer::splitWords(text, words);
+    featureHits.clear();
+    located.clear();
+    counts.clear();
+    
+    // Look up each term by its hashed ID; out-of-vocabulary terms are dropped
+    size_t terms = 0;
+    tokenizer.forEachTerm(words, [&](TermId id, size_t start, size_t length) {
+        ++terms;
+        int featureIdx = termIndex.find(id);
+        if (featureIdx >= 0) {
+            featureHits.push_back(featureIdx);
+            if (spans != nullptr) {
+                located.emplace_back(featureIdx, locateTerm(text, words, start, length));
+            }
         }
-    );
+    });
     
-    // Limit to maxFeatures
-    if (filteredTerms.size() > maxFeatures) {
-        filteredTerms.resize(maxFeatures);
+    // Sorting groups repeated terms, so each run gives a term frequency
+    std::sort(featureHits.begin(), featureHits.end());
+    
+    for (size_t i = 0; i < featureHits.size();) {
+        int featureIdx = featureHits[i];
+        size_t runEnd = i + 1;
+        while (runEnd < featureHits.size() && featureHits[runEnd] == featureIdx) {
+            ++runEnd;
+        }
+        counts.push_back({featureIdx, static_cast<int>(runEnd - i)});
+        i = runEnd;
     }
     
-    // Build vocabulary and document frequency vector
-    vocabulary.clear();
-    documentFrequencies.clear();
-    documentFrequencies.reserve(filteredTerms.size());
+    if (spans != nullptr) {
+        firstSpans(located, counts, *spans);
+    }
     
-    for (size_t i = 0; i < filteredTerms.size(); ++i) {
-        const auto& [term, freq] = filteredTerms[i];
-        vocabulary[term] = static_cast<int>(i);
-        documentFrequencies.push_back(freq);
+    return {terms, featureHits.size()};
+}
+
+const std::vector<double>& TfidfVectorizer::getIdfWeights() const {
+    return idfWeights;
+}
+
+bool TfidfVectorizer::usesSublinearTf() const {
+    return sublinearTf;
+}
+
+void TfidfVectorizer::updateIdfWeights() {
+    idfWeights.resize(documentFrequencies.size());
+    for (size_t i = 0; i < documentFrequencies.size(); ++i) {
+        idfWeights[i] = std::log(static_cast<double>(totalDocuments + 1) /
+                                 (documentFrequencies[i] + 1)) + 1.0;  // Smoothed IDF
     }
 }
 
+void TfidfVectorizer::normalizeVector(std::vector<double>& vector) const {
+    l2Normalize(vector);
+}
+
 double TfidfVectorizer::calculateTfIdf(int termFreq, int docFreq, int totalDocs) const {
     double tf = static_cast<double>(termFreq);
     if (sublinearTf) {
@@ -370,5 +868,358 @@ double TfidfVectorizer::calculateTfIdf(int termFreq, int docFreq, int totalDocs)
     return tf * idf;
 }
 
+HashingVectorizer::HashingVectorizer(
+    bool sublinearTf,
+    size_t hashBits,
+    size_t minNgram,
+    size_t maxNgram,
+    bool signedHash,
+    uint64_t seed
+) : sublinearTf(sublinearTf),
+    hashBits(hashBits),
+    minNgram(std::max<size_t>(minNgram, 1)),
+    maxNgram(std::max(maxNgram, std::max<size_t>(minNgram, 1))),
+    signedHash(signedHash),
+    seed(seed),
+    totalDocuments(0),
+    tokenizer(this->minNgram, this->maxNgram) {
+    
+    if (hashBits < 1 || hashBits > MAX_HASH_BITS) {
+        throw std::invalid_argument("hash-bits must be between 1 and " + std::to_string(MAX_HASH_BITS));
+    }
+}
+
+void HashingVectorizer::fit(const std::vector<std::string>& texts) {
+    beginFit();
+    partialFit(texts);
+    finishFit();
+}
+
+void HashingVectorizer::beginFit() {
+    totalDocuments = 0;
+    documentFrequencies.assign(getNumFeatures(), 0);
+    idfWeights.clear();
+}
+
+void HashingVectorizer::partialFit(const std::vector<std::string>& texts) {
+    if (documentFrequencies.size() != getNumFeatures()) {
+        documentFrequencies.assign(getNumFeatures(), 0);
+    }
+    totalDocuments += static_cast<int>(texts.size());
+    
+    size_t mask = getNumFeatures() - 1;
+    size_t workers = fitWorkers(texts.size());
+    size_t sliceSize = (texts.size() + workers - 1) / workers;
+    
+    // Sums do not depend on the order of the increments, so workers add
+    // straight into the shared table
+    utils::parallelFor(workers, workers, [&](size_t worker) {
+        std::vector<std::string_view> words;
+        std::vector<int> buckets;
+        size_t end = std::min(texts.size(), (worker + 1) * sliceSize);
+        
+        for (size_t i = worker * sliceSize; i < end; ++i) {
+            Tokenizer::splitWords(texts[i], words);
+            
+            buckets.clear();
+            tokenizer.forEachTerm(words, [&](TermId id, size_t, size_t) {
+                buckets.push_back(static_cast<int>(mixTerm(id) & mask));
+            });
+            
+            // Count each bucket only once per document
+            std::sort(buckets.begin(), buckets.end());
+            buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+            
+            for (int bucket : buckets) {
+                if (workers == 1) {
+                    documentFrequencies[bucket]++;
+                } else {
+                    std::atomic_ref<int>(documentFrequencies[bucket]).fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    });
+}
+
+void HashingVectorizer::finishFit() {
+    updateIdfWeights();
+    
+    std::cout << "Hashed features into " << getNumFeatures() << " buckets (n-gram range: "
+              << minNgram << "-" << maxNgram << ")" << std::endl;
+}
+
+std::vector<std::vector<double>> HashingVectorizer::transform(
+    const std::vector<std::string>& texts
+) const {
+    std::vector<SparseVector> rows = transformSparse(texts);
+    return toDenseMatrix(rows, getNumFeatures());
+}
+
+std::vector<SparseVector> HashingVectorizer::transformSparse(
+    const std::vector<std::string>& texts
+) const {
+    if (idfWeights.empty()) {
+        throw std::runtime_error("Hashing vectorizer has no IDF table. Call fit() first.");
+    }
+    
+    std::vector<SparseVector> featureRows(texts.size());
+    
+    for (size_t i = 0; i < texts.size(); ++i) {
+        featureRows[i] = buildFeatureVector(texts[i]);
+    }
+    
+    return featureRows;
+}
+
+size_t HashingVectorizer::getNumFeatures() const {
+    return static_cast<size_t>(1) << hashBits;
+}
+
+int HashingVectorizer::getBucket(std::string_view term) const {
+    return static_cast<int>(mixTerm(Tokenizer::hashTerm(term)) & (getNumFeatures() - 1));
+}
+
+const std::vector<int>& HashingVectorizer::getDocumentFrequencies() const {
+    return documentFrequencies;
+}
+
+bool HashingVectorizer::save(const std::string& filePath) const {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for writing: " << filePath << std::endl;
+        return false;
+    }
+    
+    // Fixed-width fields; the file size only depends on hashBits
+    uint8_t sublinear = sublinearTf ? 1 : 0;
+    uint8_t signedFlag = signedHash ? 1 : 0;
+    uint32_t bits = static_cast<uint32_t>(hashBits);
+    uint32_t ngramMin = static_cast<uint32_t>(minNgram);
+    uint32_t ngramMax = static_cast<uint32_t>(maxNgram);
+    int32_t docCount = totalDocuments;
+    
+    std::vector<int32_t> frequencies(getNumFeatures(), 0);
+    std::copy(documentFrequencies.begin(), documentFrequencies.end(), frequencies.begin());
+    
+    file.write(HASHING_MAGIC, sizeof(HASHING_MAGIC));
+    file.write(reinterpret_cast<const char*>(&sublinear), sizeof(sublinear));
+    file.write(reinterpret_cast<const char*>(&signedFlag), sizeof(signedFlag));
+    file.write(reinterpret_cast<const char*>(&bits), sizeof(bits));
+    file.write(reinterpret_cast<const char*>(&ngramMin), sizeof(ngramMin));
+    file.write(reinterpret_cast<const char*>(&ngramMax), sizeof(ngramMax));
+    file.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+    file.write(reinterpret_cast<const char*>(&docCount), sizeof(docCount));
+    file.write(reinterpret_cast<const char*>(frequencies.data()),
+               static_cast<std::streamsize>(frequencies.size() * sizeof(int32_t)));
+    
+    if (!file) {
+        std::cerr << "Error: Failed to write hashing vectorizer: " << filePath << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool HashingVectorizer::load(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file for reading: " << filePath << std::endl;
+        return false;
+    }
+    
+    char magic[sizeof(HASHING_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, HASHING_MAGIC, sizeof(HASHING_MAGIC)) != 0) {
+        std::cerr << "Error: Not a hashing vectorizer file: " << filePath << std::endl;
+        return false;
+    }
+    
+    uint8_t sublinear = 0;
+    uint8_t signedFlag = 0;
+    uint32_t bits = 0;
+    uint32_t ngramMin = 0;
+    uint32_t ngramMax = 0;
+    uint64_t seedValue = 0;
+    int32_t docCount = 0;
+    
+    file.read(reinterpret_cast<char*>(&sublinear), sizeof(sublinear));
+    file.read(reinterpret_cast<char*>(&signedFlag), sizeof(signedFlag));
+    file.read(reinterpret_cast<char*>(&bits), sizeof(bits));
+    file.read(reinterpret_cast<char*>(&ngramMin), sizeof(ngramMin));
+    file.read(reinterpret_cast<char*>(&ngramMax), sizeof(ngramMax));
+    file.read(reinterpret_cast<char*>(&seedValue), sizeof(seedValue));
+    file.read(reinterpret_cast<char*>(&docCount), sizeof(docCount));
+    
+    if (!file || bits < 1 || bits > MAX_HASH_BITS || ngramMin < 1 || ngramMax < ngramMin) {
+        std::cerr << "Error: Corrupt hashing vectorizer header: " << filePath << std::endl;
+        return false;
+    }
+    
+    std::vector<int32_t> frequencies(static_cast<size_t>(1) << bits);
+    file.read(reinterpret_cast<char*>(frequencies.data()),
+              static_cast<std::streamsize>(frequencies.size() * sizeof(int32_t)));
+    
+    if (!file) {
+        std::cerr << "Error: Truncated hashing vectorizer file: " << filePath << std::endl;
+        return false;
+    }
+    
+    sublinearTf = sublinear != 0;
+    signedHash = signedFlag != 0;
+    hashBits = bits;
+    minNgram = ngramMin;
+    maxNgram = ngramMax;
+    seed = seedValue;
+    totalDocuments = docCount;
+    documentFrequencies.assign(frequencies.begin(), frequencies.end());
+    tokenizer = Tokenizer(minNgram, maxNgram);
+    updateIdfWeights();
+    
+    return true;
+}
+
+bool HashingVectorizer::isVectorizerFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    char magic[sizeof(HASHING_MAGIC)];
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, HASHING_MAGIC, sizeof(HASHING_MAGIC)) == 0;
+}
+
+void HashingVectorizer::writeBundle(utils::BundleWriter& bundle) const {
+    auto& header = bundle.addSection(SECTION_VECTORIZER);
+    header.writeU32(KIND_HASHING);
+    header.writeU8(sublinearTf ? 1 : 0);
+    header.writeU8(signedHash ? 1 : 0);
+    header.writeU32(static_cast<uint32_t>(hashBits));
+    header.writeU32(static_cast<uint32_t>(minNgram));
+    header.writeU32(static_cast<uint32_t>(maxNgram));
+    header.writeU64(seed);
+    header.writeI64(totalDocuments);
+    
+    std::vector<int> frequencies(getNumFeatures(), 0);
+    std::copy(documentFrequencies.begin(), documentFrequencies.end(), frequencies.begin());
+    bundle.addSection(SECTION_DOC_FREQS).writeI32Array(frequencies);
+    bundle.addSection(SECTION_IDF).writeF64Array(idfWeights);
+}
+
+bool HashingVectorizer::readBundle(const utils::BundleReader& bundle) {
+    utils::SectionReader header = bundle.reader(SECTION_VECTORIZER);
+    uint32_t kind = header.readU32();
+    bool sublinear = header.readU8() != 0;
+    bool signedFlag = header.readU8() != 0;
+    uint32_t bits = header.readU32();
+    uint32_t ngramMin = header.readU32();
+    uint32_t ngramMax = header.readU32();
+    uint64_t seedValue = header.readU64();
+    int64_t docCount = header.readI64();
+    
+    if (!header.ok() || kind != KIND_HASHING || bits < 1 || bits > MAX_HASH_BITS ||
+        ngramMin < 1 || ngramMax < ngramMin) {
+        std::cerr << "Error: Invalid hashing vectorizer section in model bundle" << std::endl;
+        return false;
+    }
+    
+    size_t bucketCount = static_cast<size_t>(1) << bits;
+    utils::SectionReader freqSection = bundle.reader(SECTION_DOC_FREQS);
+    std::vector<int> frequencies = freqSection.readI32Array(bucketCount);
+    utils::SectionReader idfSection = bundle.reader(SECTION_IDF);
+    std::vector<double> idf = idfSection.readF64Array(bucketCount);
+    
+    if (!freqSection.ok() || !idfSection.ok()) {
+        std::cerr << "Error: Truncated hashing vectorizer sections in model bundle" << std::endl;
+        return false;
+    }
+    
+    sublinearTf = sublinear;
+    signedHash = signedFlag;
+    hashBits = bits;
+    minNgram = ngramMin;
+    maxNgram = ngramMax;
+    seed = seedValue;
+    totalDocuments = static_cast<int>(docCount);
+    documentFrequencies = std::move(frequencies);
+    idfWeights = std::move(idf);
+    tokenizer = Tokenizer(minNgram, maxNgram);
+    
+    return true;
+}
+
+uint64_t HashingVectorizer::mixTerm(TermId id) const {
+    // SplitMix64 finalizer over the seeded term ID
+    uint64_t h = id + seed * 0x9E3779B97F4A7C15ULL;
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+TermCoverage HashingVectorizer::countFeatures(
+    std::string_view text,
+    std::vector<FeatureCount>& counts,
+    std::vector<FeatureSpan>* spans
+) const {
+    // Scratch buffers are reused across calls on the same thread
+    thread_local std::vector<std::string_view> words;
+    thread_local std::vector<std::pair<int, int>> hits;
+    thread_local std::vector<std::pair<int, FeatureSpan>> located;
+    
+    Tokenizer::splitWords(text, words);
+    hits.clear();
+    located.clear();
+    counts.clear();
+    
+    size_t mask = getNumFeatures() - 1;
+    tokenizer.forEachTerm(words, [&](TermId id, size_t start, size_t length) {
+        uint64_t h = mixTerm(id);
+        int sign = (signedHash && (h >> 63)) ? -1 : 1;
+        hits.emplace_back(static_cast<int>(h & mask), sign);
+        if (spans != nullptr) {
+            located.emplace_back(static_cast<int>(h & mask), locateTerm(text, words, start, length));
+        }
+    });
+    
+    // Sorting groups each bucket's contributions together
+    std::sort(hits.begin(), hits.end());
+    
+    for (size_t i = 0; i < hits.size();) {
+        int bucket = hits[i].first;
+        int count = 0;
+        while (i < hits.size() && hits[i].first == bucket) {
+            count += hits[i].second;
+            ++i;
+        }
+        
+        // Opposite-signed collisions cancel out
+        if (count != 0) {
+            counts.push_back({bucket, count});
+        }
+    }
+    
+    if (spans != nullptr) {
+        firstSpans(located, counts, *spans);
+    }
+    
+    return {hits.size(), hits.size()};
+}
+
+const std::vector<double>& HashingVectorizer::getIdfWeights() const {
+    return idfWeights;
+}
+
+bool HashingVectorizer::usesSublinearTf() const {
+    return sublinearTf;
+}
+
+void HashingVectorizer::updateIdfWeights() {
+    idfWeights.resize(documentFrequencies.size());
+    for (size_t i = 0; i < documentFrequencies.size(); ++i) {
+        idfWeights[i] = std::log(static_cast<double>(totalDocuments + 1) /
+                                 (documentFrequencies[i] + 1)) + 1.0;  // Smoothed IDF
+    }
+}
+
 } // namespace preprocessing
 } // namespace blahajpi
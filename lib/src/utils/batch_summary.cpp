@@ -0,0 +1,277 @@
+/**
+ * @file batch_summary.cpp
+ * @brief Implementation of the mergeable batch run summary
+ */
+
+#include "blahajpi/utils/batch_summary.hpp"
+#include "blahajpi/analyzer.hpp"
+#include "blahajpi/evaluation/metrics.hpp"
+#include "blahajpi/utils/static_lexicon.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/// First line of a summary file; the number is the format version
+constexpr const char* SUMMARY_HEADER = "blahajpi-batch-summary 1";
+
+/// Width of the longest bar in the score histogram
+constexpr size_t HISTOGRAM_WIDTH = 40;
+
+} // namespace
+
+size_t shardOf(std::string_view key, size_t shardCount) {
+    return shardCount <= 1 ? 0 : static_cast<size_t>(lexiconHash(key) % shardCount);
+}
+
+BatchSummary::BatchSummary(size_t shardIndex, size_t shardCount) : shardCount(shardCount) {
+    if (shardIndex >= shardCount) {
+        throw std::invalid_argument("Shard index must be below the shard count");
+    }
+    shards.push_back(shardIndex);
+}
+
+void BatchSummary::add(const AnalysisResult& result) {
+    ++files;
+    if (result.sentiment == "Harmful") {
+        ++harmful;
+    }
+    double probability = std::clamp(result.confidence, 0.0, 1.0);
+    size_t bin = std::min(SCORE_BINS - 1, static_cast<size_t>(probability * SCORE_BINS));
+    ++scoreBins[bin];
+    if (result.cluster != 0) {
+        clusters.add(AnalysisResult::formatCluster(result.cluster));
+    }
+}
+
+void BatchSummary::add(const AnalysisResult& result, int label) {
+    add(result);
+    bool predicted = result.sentiment == "Harmful";
+    if (label != 0) {
+        ++(predicted ? tp : fn);
+    } else {
+        ++(predicted ? fp : tn);
+    }
+}
+
+void BatchSummary::addError() {
+    ++files;
+    ++errors;
+}
+
+void BatchSummary::addTerms(const WordCounter& counts) {
+    terms.merge(counts);
+}
+
+void BatchSummary::merge(const BatchSummary& other) {
+    if (other.shardCount != shardCount) {
+        throw std::invalid_argument("Cannot merge summaries of inputs split into " + std::to_string(shardCount) +
+                                    " and " + std::to_string(other.shardCount) + " shards");
+    }
+    for (size_t shard : other.shards) {
+        if (std::binary_search(shards.begin(), shards.end(), shard)) {
+            throw std::invalid_argument("Shard " + std::to_string(shard) + " is already counted");
+        }
+    }
+
+    std::vector<size_t> covered;
+    std::merge(shards.begin(), shards.end(), other.shards.begin(), other.shards.end(), std::back_inserter(covered));
+    shards = std::move(covered);
+    files += other.files;
+    harmful += other.harmful;
+    errors += other.errors;
+    for (size_t i = 0; i < SCORE_BINS; ++i) {
+        scoreBins[i] += other.scoreBins[i];
+    }
+    tn += other.tn;
+    fp += other.fp;
+    fn += other.fn;
+    tp += other.tp;
+    terms.merge(other.terms);
+    clusters.merge(other.clusters);
+}
+
+std::unordered_map<std::string, double> BatchSummary::getMetrics() const {
+    if (getLabeled() == 0) {
+        return {};
+    }
+    return evaluation::Metrics::calculateMetricsFromCounts(static_cast<int>(tn), static_cast<int>(fp),
+                                                           static_cast<int>(fn), static_cast<int>(tp));
+}
+
+std::string BatchSummary::report(size_t topTerms, size_t topClusters) const {
+    std::ostringstream out;
+    out << "Analysis Summary:\n";
+    if (shardCount > 1) {
+        out << "Shards: " << shards.size() << " of " << shardCount;
+        if (!isComplete()) {
+            out << " (partial)";
+        }
+        out << "\n";
+    }
+    out << "Total files: " << files << "\n";
+    out << "Harmful content: " << harmful << " files (" << (files > 0 ? harmful * 100 / files : 0) << "%)\n";
+    out << "Safe content: " << (files - harmful - errors) << " files\n";
+    if (errors > 0) {
+        out << "Errors: " << errors << " files\n";
+    }
+
+    uint64_t scored = files - errors;
+    if (scored > 0) {
+        uint64_t largest = *std::max_element(scoreBins.begin(), scoreBins.end());
+        out << "\nHarm probability distribution:\n";
+        for (size_t i = 0; i < SCORE_BINS; ++i) {
+            size_t bar = static_cast<size_t>((scoreBins[i] * HISTOGRAM_WIDTH + largest - 1) / largest);
+            out << "  " << std::fixed << std::setprecision(1) << static_cast<double>(i) / SCORE_BINS << "-"
+                << static_cast<double>(i + 1) / SCORE_BINS << "  " << std::left << std::setw(HISTOGRAM_WIDTH)
+                << std::string(bar, '#') << std::right << " " << scoreBins[i] << "\n";
+        }
+        out.unsetf(std::ios::fixed);
+        out << std::setprecision(6);
+    }
+
+    auto words = terms.top(topTerms);
+    if (!words.empty()) {
+        out << "\nTop words in harmful content:";
+        for (size_t i = 0; i < words.size(); ++i) {
+            out << (i == 0 ? " " : ", ") << words[i].first << " (" << words[i].second << ")";
+        }
+        out << "\n";
+    }
+
+    // A cluster of one text is not a near duplicate of anything
+    auto largest = clusters.top(topClusters);
+    std::erase_if(largest, [](const auto& cluster) { return cluster.second < 2; });
+    if (!largest.empty()) {
+        out << "\nLargest near-duplicate clusters:";
+        for (size_t i = 0; i < largest.size(); ++i) {
+            out << (i == 0 ? " " : ", ") << largest[i].first << " (" << largest[i].second << " files)";
+        }
+        out << "\n";
+    }
+
+    auto metrics = getMetrics();
+    if (!metrics.empty()) {
+        out << "\nClassification metrics (" << getLabeled() << " labeled files):\n";
+        out << "  Accuracy: " << metrics["accuracy"] << "\n";
+        out << "  Harmful precision: " << metrics["precision_harmful"] << "\n";
+        out << "  Harmful recall: " << metrics["recall_harmful"] << "\n";
+        out << "  Harmful F1: " << metrics["f1_harmful"] << "\n";
+        out << "  Macro F1: " << metrics["macro_f1"] << "\n";
+        out << "  Confusion: TN " << tn << ", FP " << fp << ", FN " << fn << ", TP " << tp << "\n";
+    }
+    return out.str();
+}
+
+bool BatchSummary::save(const std::string& filePath) const {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << SUMMARY_HEADER << "\n";
+    file << "shards " << shardCount;
+    for (size_t shard : shards) {
+        file << " " << shard;
+    }
+    file << "\n";
+    file << "files " << files << "\n";
+    file << "harmful " << harmful << "\n";
+    file << "errors " << errors << "\n";
+    file << "score-bins";
+    for (uint64_t count : scoreBins) {
+        file << " " << count;
+    }
+    file << "\n";
+    file << "confusion " << tn << " " << fp << " " << fn << " " << tp << "\n";
+
+    // Words never contain whitespace, so one word and its count fit a line
+    for (const auto& [word, count] : terms.top(terms.size())) {
+        file << "term " << count << " " << word << "\n";
+    }
+    for (const auto& [cluster, count] : clusters.top(clusters.size())) {
+        file << "cluster " << count << " " << cluster << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool BatchSummary::load(const std::string& filePath) {
+    std::ifstream file(filePath);
+    std::string line;
+    if (!std::getline(file, line) || line != SUMMARY_HEADER) {
+        return false;
+    }
+
+    BatchSummary loaded;
+    loaded.shards.clear();
+    bool sawShards = false;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key.empty()) {
+            continue;
+        }
+
+        if (key == "shards") {
+            size_t shard = 0;
+            fields >> loaded.shardCount;
+            while (fields >> shard) {
+                loaded.shards.push_back(shard);
+            }
+            if (!fields.eof()) {
+                return false;
+            }
+            fields.clear();
+            sawShards = true;
+        } else if (key == "files") {
+            fields >> loaded.files;
+        } else if (key == "harmful") {
+            fields >> loaded.harmful;
+        } else if (key == "errors") {
+            fields >> loaded.errors;
+        } else if (key == "score-bins") {
+            for (uint64_t& count : loaded.scoreBins) {
+                fields >> count;
+            }
+        } else if (key == "confusion") {
+            fields >> loaded.tn >> loaded.fp >> loaded.fn >> loaded.tp;
+        } else if (key == "term") {
+            int64_t count = 0;
+            std::string word;
+            fields >> count >> word;
+            loaded.terms.add(word, count);
+        } else if (key == "cluster") {
+            int64_t count = 0;
+            std::string cluster;
+            fields >> count >> cluster;
+            loaded.clusters.add(cluster, count);
+        } else {
+            return false;
+        }
+        if (fields.fail()) {
+            return false;
+        }
+    }
+
+    // Shards must be distinct, ascending and inside the split
+    if (!sawShards || loaded.shardCount == 0 || loaded.shards.empty() ||
+        !std::is_sorted(loaded.shards.begin(), loaded.shards.end()) ||
+        std::adjacent_find(loaded.shards.begin(), loaded.shards.end()) != loaded.shards.end() ||
+        loaded.shards.back() >= loaded.shardCount ||
+        loaded.harmful + loaded.errors > loaded.files) {
+        return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,462 @@
+/**
+ * @file byte_kernels.cpp
+ * @brief Implementation of the byte-class kernels
+ */
+
+#include "blahajpi/utils/byte_kernels.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+
+// The build can force the scalar kernels with BLAHAJPI_ENABLE_SIMD=0
+#ifndef BLAHAJPI_ENABLE_SIMD
+#define BLAHAJPI_ENABLE_SIMD 1
+#endif
+
+#if BLAHAJPI_ENABLE_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define BLAHAJPI_HAVE_SSE2 1
+#if defined(__GNUC__)
+// AVX2 is compiled per function and only used if the CPU reports it
+#include <immintrin.h>
+#define BLAHAJPI_HAVE_AVX2 1
+#define BLAHAJPI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif BLAHAJPI_ENABLE_SIMD && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define BLAHAJPI_HAVE_NEON 1
+#endif
+
+// The block loops are forced inline into each instruction set's entry
+// points, so the AVX2 ones are compiled for AVX2 even without optimization
+#if defined(__GNUC__)
+#define BLAHAJPI_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define BLAHAJPI_FORCE_INLINE inline
+#endif
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/// ByteClass bits of every byte value
+constexpr std::array<uint8_t, 256> BYTE_CLASSES = [] {
+    std::array<uint8_t, 256> classes{};
+    for (int c = 0; c < 256; ++c) {
+        if (c >= 'A' && c <= 'Z') {
+            classes[c] = BYTE_UPPER;
+        } else if (c >= '0' && c <= '9') {
+            classes[c] = BYTE_DIGIT;
+        } else if ((c >= '\t' && c <= '\r') || c == ' ') {
+            classes[c] = BYTE_SPACE;
+        } else if (c >= 0x80) {
+            classes[c] = BYTE_NON_ASCII;
+        } else if (c > ' ' && c < 0x7F && !(c >= 'a' && c <= 'z')) {
+            classes[c] = BYTE_PUNCT;
+        }
+    }
+    return classes;
+}();
+
+/**
+ * @brief Looks up the class of a byte
+ * @param c Byte to classify
+ * @return ByteClass bit (0 for lowercase letters and control characters)
+ */
+inline uint8_t classOf(char c) {
+    return BYTE_CLASSES[static_cast<unsigned char>(c)];
+}
+
+/**
+ * @brief Maps A-Z to a-z
+ * @param c Byte to map
+ * @return Lowercased byte
+ */
+inline char toLower(char c) {
+    return classOf(c) == BYTE_UPPER ? static_cast<char>(c | 0x20) : c;
+}
+
+/**
+ * @brief Table-only kernels for targets without a vector path
+ */
+struct Scalar {
+    static constexpr size_t WIDTH = 0;  ///< No vector blocks
+};
+
+#ifdef BLAHAJPI_HAVE_SSE2
+/**
+ * @brief 16-byte blocks with SSE2, present on every x86-64 CPU
+ */
+struct Sse2 {
+    using Vec = __m128i;
+    static constexpr size_t WIDTH = 16;
+    static constexpr uint32_t FULL_MASK = 0xFFFF;
+
+    static Vec load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(char* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec splat(char c) { return _mm_set1_epi8(c); }
+    static Vec zero() { return _mm_setzero_si128(); }
+    static Vec bitOr(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec bitAnd(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static Vec andNot(Vec a, Vec b) { return _mm_andnot_si128(b, a); }
+    static Vec equal(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+    static uint32_t movemask(Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+
+    // Both bounds are ASCII, so the signed compares leave out bytes from 0x80 up
+    static Vec inRange(Vec v, char lo, char hi) {
+        return _mm_and_si128(_mm_cmpgt_epi8(v, splat(static_cast<char>(lo - 1))),
+                             _mm_cmplt_epi8(v, splat(static_cast<char>(hi + 1))));
+    }
+    static Vec nonAscii(Vec v) { return _mm_cmplt_epi8(v, zero()); }
+};
+#endif
+
+#ifdef BLAHAJPI_HAVE_AVX2
+/**
+ * @brief 32-byte blocks with AVX2
+ */
+struct Avx2 {
+    using Vec = __m256i;
+    static constexpr size_t WIDTH = 32;
+    static constexpr uint32_t FULL_MASK = 0xFFFFFFFF;
+
+    BLAHAJPI_TARGET_AVX2 static Vec load(const char* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    BLAHAJPI_TARGET_AVX2 static void store(char* p, Vec v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    BLAHAJPI_TARGET_AVX2 static Vec splat(char c) { return _mm256_set1_epi8(c); }
+    BLAHAJPI_TARGET_AVX2 static Vec zero() { return _mm256_setzero_si256(); }
+    BLAHAJPI_TARGET_AVX2 static Vec bitOr(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    BLAHAJPI_TARGET_AVX2 static Vec bitAnd(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    BLAHAJPI_TARGET_AVX2 static Vec andNot(Vec a, Vec b) { return _mm256_andnot_si256(b, a); }
+    BLAHAJPI_TARGET_AVX2 static Vec equal(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+    BLAHAJPI_TARGET_AVX2 static uint32_t movemask(Vec v) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(v));
+    }
+
+    BLAHAJPI_TARGET_AVX2 static Vec inRange(Vec v, char lo, char hi) {
+        return _mm256_and_si256(_mm256_cmpgt_epi8(v, splat(static_cast<char>(lo - 1))),
+                                _mm256_cmpgt_epi8(splat(static_cast<char>(hi + 1)), v));
+    }
+    BLAHAJPI_TARGET_AVX2 static Vec nonAscii(Vec v) { return _mm256_cmpgt_epi8(zero(), v); }
+};
+#endif
+
+#ifdef BLAHAJPI_HAVE_NEON
+/**
+ * @brief 16-byte blocks with NEON, present on every AArch64 CPU
+ */
+struct Neon {
+    using Vec = uint8x16_t;
+    static constexpr size_t WIDTH = 16;
+    static constexpr uint32_t FULL_MASK = 0xFFFF;
+
+    static Vec load(const char* p) { return vld1q_u8(reinterpret_cast<const uint8_t*>(p)); }
+    static void store(char* p, Vec v) { vst1q_u8(reinterpret_cast<uint8_t*>(p), v); }
+    static Vec splat(char c) { return vdupq_n_u8(static_cast<uint8_t>(c)); }
+    static Vec zero() { return vdupq_n_u8(0); }
+    static Vec bitOr(Vec a, Vec b) { return vorrq_u8(a, b); }
+    static Vec bitAnd(Vec a, Vec b) { return vandq_u8(a, b); }
+    static Vec andNot(Vec a, Vec b) { return vbicq_u8(a, b); }
+    static Vec equal(Vec a, Vec b) { return vceqq_u8(a, b); }
+    static Vec inRange(Vec v, char lo, char hi) { return vandq_u8(vcgeq_u8(v, splat(lo)), vcleq_u8(v, splat(hi))); }
+    static Vec nonAscii(Vec v) { return vcgeq_u8(v, vdupq_n_u8(0x80)); }
+
+    // NEON has no movemask: weight each lane by its bit and add up each half
+    static uint32_t movemask(Vec v) {
+        alignas(16) static constexpr uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                                            1, 2, 4, 8, 16, 32, 64, 128};
+        Vec bits = vandq_u8(v, vld1q_u8(weights));
+        return vaddv_u8(vget_low_u8(bits)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+    }
+};
+#endif
+
+// The Avx2 instantiations pass __m256i to the vector helpers, but they only
+// run inlined into the AVX2 entry points and never use the default ABI
+#if defined(BLAHAJPI_HAVE_AVX2) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/**
+ * @brief Finds the bytes of a block that fall in some classes
+ *
+ * Takes the block by reference so no vector crosses a function boundary
+ * of the default target; the AVX2 instantiations inline into AVX2 code.
+ *
+ * @param chunk Block of bytes
+ * @param classes ByteClass bits to look for
+ * @return Bit i set if byte i matches
+ */
+template <typename Isa>
+BLAHAJPI_FORCE_INLINE uint32_t classMask(const typename Isa::Vec& chunk, uint8_t classes) {
+    using Vec = typename Isa::Vec;
+    Vec upper = Isa::inRange(chunk, 'A', 'Z');
+    Vec digit = Isa::inRange(chunk, '0', '9');
+    Vec matches = Isa::zero();
+    if (classes & BYTE_UPPER) {
+        matches = Isa::bitOr(matches, upper);
+    }
+    if (classes & BYTE_DIGIT) {
+        matches = Isa::bitOr(matches, digit);
+    }
+    if (classes & BYTE_SPACE) {
+        matches = Isa::bitOr(matches, Isa::bitOr(Isa::inRange(chunk, '\t', '\r'), Isa::equal(chunk, Isa::splat(' '))));
+    }
+    if (classes & BYTE_NON_ASCII) {
+        matches = Isa::bitOr(matches, Isa::nonAscii(chunk));
+    }
+    if (classes & BYTE_PUNCT) {
+        Vec alnum = Isa::bitOr(Isa::bitOr(upper, digit), Isa::inRange(chunk, 'a', 'z'));
+        matches = Isa::bitOr(matches, Isa::andNot(Isa::inRange(chunk, '!', '~'), alnum));
+    }
+    return Isa::movemask(matches);
+}
+
+/**
+ * @brief Filters and lowercases bytes; out must hold size bytes
+ * @return Bytes written
+ */
+template <typename Isa>
+BLAHAJPI_FORCE_INLINE size_t filterBytes(const char* in, size_t size, char* out, uint8_t dropClasses, bool lowercase) {
+    size_t length = 0;
+    size_t i = 0;
+
+    if constexpr (Isa::WIDTH > 0) {
+        char block[Isa::WIDTH];
+        for (; i + Isa::WIDTH <= size; i += Isa::WIDTH) {
+            auto chunk = Isa::load(in + i);
+            if (lowercase) {
+                chunk = Isa::bitOr(chunk, Isa::bitAnd(Isa::inRange(chunk, 'A', 'Z'), Isa::splat(0x20)));
+            }
+            uint32_t drop = dropClasses != 0 ? classMask<Isa>(chunk, dropClasses) : 0;
+
+            // length never passes i, so a whole block always fits
+            if (drop == 0) {
+                Isa::store(out + length, chunk);
+                length += Isa::WIDTH;
+                continue;
+            }
+            Isa::store(block, chunk);
+            for (uint32_t keep = ~drop & Isa::FULL_MASK; keep != 0; keep &= keep - 1) {
+                out[length++] = block[std::countr_zero(keep)];
+            }
+        }
+    }
+
+    for (; i < size; ++i) {
+        char c = lowercase ? toLower(in[i]) : in[i];
+        if ((classOf(c) & dropClasses) == 0) {
+            out[length++] = c;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Collapses whitespace runs to single spaces; out must hold size bytes
+ * @return Bytes written
+ */
+template <typename Isa>
+BLAHAJPI_FORCE_INLINE size_t collapseWhitespace(const char* in, size_t size, char* out) {
+    size_t length = 0;
+    size_t i = 0;
+    bool lastWasSpace = true;  // Drops leading whitespace
+
+    auto step = [&](char c, bool space) {
+        if (!space) {
+            out[length++] = c;
+        } else if (!lastWasSpace) {
+            out[length++] = ' ';
+        }
+        lastWasSpace = space;
+    };
+
+    if constexpr (Isa::WIDTH > 0) {
+        char block[Isa::WIDTH];
+        for (; i + Isa::WIDTH <= size; i += Isa::WIDTH) {
+            auto chunk = Isa::load(in + i);
+            uint32_t spaces = classMask<Isa>(chunk, BYTE_SPACE);
+            uint32_t blanks = Isa::movemask(Isa::equal(chunk, Isa::splat(' ')));
+
+            // Plain prose (single ' ' between words) is already normalized
+            if (spaces == blanks && (spaces & (spaces >> 1)) == 0 && !(lastWasSpace && (spaces & 1))) {
+                Isa::store(out + length, chunk);
+                length += Isa::WIDTH;
+                lastWasSpace = (spaces >> (Isa::WIDTH - 1)) & 1;
+                continue;
+            }
+            Isa::store(block, chunk);
+            for (size_t j = 0; j < Isa::WIDTH; ++j) {
+                step(block[j], (spaces >> j) & 1);
+            }
+        }
+    }
+
+    for (; i < size; ++i) {
+        step(in[i], classOf(in[i]) == BYTE_SPACE);
+    }
+
+    // Trailing whitespace left at most one space
+    if (length > 0 && out[length - 1] == ' ') {
+        --length;
+    }
+    return length;
+}
+
+/**
+ * @brief Cuts runs of one character to two; out must hold size bytes
+ * @return Bytes written
+ */
+template <typename Isa>
+BLAHAJPI_FORCE_INLINE size_t collapseRepeats(const char* in, size_t size, char* out) {
+    if (size == 0) {
+        return 0;
+    }
+
+    out[0] = in[0];
+    size_t length = 1;
+    size_t i = 1;
+
+    auto step = [&](size_t at) {
+        if (in[at] != in[at - 1] || (length >= 2 && out[length - 1] != out[length - 2])) {
+            out[length++] = in[at];
+        }
+    };
+
+    if constexpr (Isa::WIDTH > 0) {
+        for (; i + Isa::WIDTH <= size; i += Isa::WIDTH) {
+            auto chunk = Isa::load(in + i);
+            uint32_t repeats = Isa::movemask(Isa::equal(chunk, Isa::load(in + i - 1)));
+
+            // Only a byte equal to its predecessor can be dropped
+            if (repeats == 0) {
+                Isa::store(out + length, chunk);
+                length += Isa::WIDTH;
+                continue;
+            }
+            for (size_t j = 0; j < Isa::WIDTH; ++j) {
+                step(i + j);
+            }
+        }
+    }
+
+    for (; i < size; ++i) {
+        step(i);
+    }
+    return length;
+}
+
+/**
+ * @brief Entry points of the kernels for one instruction set
+ */
+template <typename Isa>
+struct Entry {
+    static size_t filter(const char* in, size_t size, char* out, uint8_t dropClasses, bool lowercase) {
+        return filterBytes<Isa>(in, size, out, dropClasses, lowercase);
+    }
+    static size_t whitespace(const char* in, size_t size, char* out) {
+        return collapseWhitespace<Isa>(in, size, out);
+    }
+    static size_t repeats(const char* in, size_t size, char* out) {
+        return collapseRepeats<Isa>(in, size, out);
+    }
+};
+
+#ifdef BLAHAJPI_HAVE_AVX2
+template <>
+struct Entry<Avx2> {
+    BLAHAJPI_TARGET_AVX2 static size_t filter(const char* in, size_t size, char* out, uint8_t dropClasses,
+                                              bool lowercase) {
+        return filterBytes<Avx2>(in, size, out, dropClasses, lowercase);
+    }
+    BLAHAJPI_TARGET_AVX2 static size_t whitespace(const char* in, size_t size, char* out) {
+        return collapseWhitespace<Avx2>(in, size, out);
+    }
+    BLAHAJPI_TARGET_AVX2 static size_t repeats(const char* in, size_t size, char* out) {
+        return collapseRepeats<Avx2>(in, size, out);
+    }
+};
+#endif
+
+/**
+ * @brief Kernels of one instruction set
+ */
+struct Kernels {
+    const char* isa;  ///< Instruction set name
+    size_t (*filter)(const char*, size_t, char*, uint8_t, bool);  ///< filterBytes()
+    size_t (*whitespace)(const char*, size_t, char*);             ///< collapseWhitespace()
+    size_t (*repeats)(const char*, size_t, char*);                ///< collapseRepeats()
+
+    /**
+     * @brief Builds the table of one instruction set
+     * @param name Instruction set name
+     * @return Kernels of Isa
+     */
+    template <typename Isa>
+    static Kernels of(const char* name) {
+        return {name, &Entry<Isa>::filter, &Entry<Isa>::whitespace, &Entry<Isa>::repeats};
+    }
+};
+
+/**
+ * @brief Gets the kernels for the running CPU
+ * @return Kernels chosen on first use
+ */
+const Kernels& kernels() {
+    static const Kernels selected = []() -> Kernels {
+#ifdef BLAHAJPI_HAVE_AVX2
+        if (__builtin_cpu_supports("avx2")) {
+            return Kernels::of<Avx2>("avx2");
+        }
+#endif
+#if defined(BLAHAJPI_HAVE_SSE2)
+        return Kernels::of<Sse2>("sse2");
+#elif defined(BLAHAJPI_HAVE_NEON)
+        return Kernels::of<Neon>("neon");
+#else
+        return Kernels::of<Scalar>("scalar");
+#endif
+    }();
+    return selected;
+}
+
+/**
+ * @brief Runs a kernel into the end of a string
+ * @param text Kernel input
+ * @param output String to append to
+ * @param kernel Callable writing at most text.size() bytes and returning the count
+ */
+template <typename Kernel>
+void appendWith(std::string_view text, std::string& output, Kernel kernel) {
+    size_t start = output.size();
+    output.resize_and_overwrite(start + text.size(), [&](char* buffer, size_t) {
+        return start + kernel(text.data(), text.size(), buffer + start);
+    });
+}
+
+} // namespace
+
+void appendFiltered(std::string_view text, uint8_t dropClasses, bool lowercase, std::string& output) {
+    appendWith(text, output, [&](const char* in, size_t size, char* out) {
+        return kernels().filter(in, size, out, dropClasses, lowercase);
+    });
+}
+
+void appendCollapsedWhitespace(std::string_view text, std::string& output) {
+    appendWith(text, output, kernels().whitespace);
+}
+
+void appendCollapsedRepeats(std::string_view text, std::string& output) {
+    appendWith(text, output, kernels().repeats);
+}
+
+const char* byteKernelIsa() {
+    return kernels().isa;
+}
+
+} // namespace utils
+} // namespace blahajpi
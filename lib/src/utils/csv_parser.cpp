@@ -0,0 +1,147 @@
+/**
+ * @file csv_parser.cpp
+ * @brief Implementation of the zero-copy delimited text parser
+ */
+
+#include "blahajpi/utils/csv_parser.hpp"
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BLAHAJPI_HAVE_SSE2 1
+#endif
+
+namespace blahajpi {
+namespace utils {
+
+std::string DelimitedField::value() const {
+    if (!escaped) {
+        return std::string(raw);
+    }
+
+    std::string result;
+    result.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        result += raw[i];
+        if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"') {
+            ++i;  // Doubled quote
+        }
+    }
+    return result;
+}
+
+const char* findEither(const char* begin, const char* end, char first, char second) {
+#ifdef BLAHAJPI_HAVE_SSE2
+    // Compare 16 bytes at a time; the mask has one bit per matching byte
+    const __m128i firstMask = _mm_set1_epi8(first);
+    const __m128i secondMask = _mm_set1_epi8(second);
+    while (end - begin >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, firstMask), _mm_cmpeq_epi8(chunk, secondMask));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+        if (mask != 0) {
+            return begin + std::countr_zero(mask);
+        }
+        begin += 16;
+    }
+#endif
+
+    for (; begin < end; ++begin) {
+        if (*begin == first || *begin == second) {
+            return begin;
+        }
+    }
+    return end;
+}
+
+DelimitedParser::DelimitedParser(std::string_view data, char delimiter, bool quoting)
+    : data(data), delimiter(delimiter), quoting(quoting) {
+}
+
+bool DelimitedParser::next(std::vector<DelimitedField>& fields) {
+    fields.clear();
+    if (pos >= data.size()) {
+        return false;
+    }
+
+    const char* base = data.data();
+    const char* end = base + data.size();
+    const char* p = base + pos;
+
+    // Strips the CR of a CRLF line ending from an unquoted field
+    auto trimLine = [&](const char* start, const char* stop) {
+        if ((stop == end || *stop == '\n') && stop > start && stop[-1] == '\r') {
+            --stop;
+        }
+        return std::string_view(start, static_cast<size_t>(stop - start));
+    };
+
+    while (true) {
+        DelimitedField field;
+
+        if (quoting && p < end && *p == '"') {
+            // Quoted field: find the closing quote, skipping doubled quotes
+            const char* start = p + 1;
+            const char* close = start;
+            while (true) {
+                const void* found = std::memchr(close, '"', static_cast<size_t>(end - close));
+                close = found ? static_cast<const char*>(found) : end;
+                if (close + 1 < end && close[1] == '"') {
+                    field.escaped = true;
+                    close += 2;
+                    continue;
+                }
+                break;
+            }
+
+            const char* after = close < end ? close + 1 : end;
+            bool atBoundary = after == end || *after == delimiter || *after == '\n' ||
+                              (*after == '\r' && (after + 1 == end || after[1] == '\n'));
+            if (atBoundary) {
+                field.raw = std::string_view(start, static_cast<size_t>(close - start));
+                p = after;
+            } else {
+                // Text after the closing quote: keep the field verbatim
+                const char* stop = findEither(after, end, delimiter, '\n');
+                field.raw = trimLine(p, stop);
+                field.escaped = false;
+                p = stop;
+            }
+        } else {
+            const char* stop = findEither(p, end, delimiter, '\n');
+            field.raw = trimLine(p, stop);
+            p = stop;
+        }
+
+        fields.push_back(field);
+
+        if (p < end && *p == delimiter) {
+            ++p;
+            continue;
+        }
+
+        // End of record
+        if (p < end && *p == '\r') {
+            ++p;
+        }
+        if (p < end && *p == '\n') {
+            ++p;
+        }
+        break;
+    }
+
+    pos = static_cast<size_t>(p - base);
+    return true;
+}
+
+size_t DelimitedParser::position() const {
+    return pos;
+}
+
+void DelimitedParser::seek(size_t offset) {
+    pos = offset < data.size() ? offset : data.size();
+}
+
+} // namespace utils
+} // namespace blahajpi
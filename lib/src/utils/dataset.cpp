@@ -4,6 +4,7 @@
  */
 
 #include "blahajpi/utils/dataset.hpp"
+#include "blahajpi/utils/dataset_reader.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -11,17 +12,29 @@
 #include <random>
 #include <cctype>
 #include <filesystem>
+#include <iterator>
+#include <numeric>
 #include <stdexcept>
 
 namespace blahajpi {
 namespace utils {
 
-Dataset::Dataset(std::vector<std::pair<int, std::string>> data) : data(std::move(data)) {
-    // Extract labels
-    labels.reserve(this->data.size());
-    for (const auto& [label, _] : this->data) {
+namespace {
+
+/// Rows parsed per reader call while loading a whole file
+constexpr size_t LOAD_BATCH_SIZE = 4096;
+
+} // namespace
+
+Dataset::Dataset(std::vector<std::pair<int, std::string>> data) {
+    // Split the samples into columns
+    texts.reserve(data.size());
+    labels.reserve(data.size());
+    for (auto& [label, text] : data) {
         labels.push_back(label);
+        texts.push_back(std::move(text));
     }
+    indexLabels();
 }
 
 bool Dataset::loadFromFile(
@@ -96,9 +109,9 @@ bool Dataset::saveToFile(
                 file << "label,text" << std::endl;
                 
                 // Write data rows
-                for (const auto& [label, text] : data) {
+                for (size_t i = 0; i < texts.size(); ++i) {
                     // Escape text: replace quotes with double quotes
-                    std::string escapedText = text;
+                    std::string escapedText = texts[i];
                     size_t pos = 0;
                     while ((pos = escapedText.find('"', pos)) != std::string::npos) {
                         escapedText.replace(pos, 1, "\"\"");
@@ -106,7 +119,7 @@ bool Dataset::saveToFile(
                     }
                     
                     // Write row with text in quotes
-                    file << label << ",\"" << escapedText << "\"" << std::endl;
+                    file << labels[i] << ",\"" << escapedText << "\"" << std::endl;
                 }
                 break;
                 
@@ -115,13 +128,13 @@ bool Dataset::saveToFile(
                 file << "label\ttext" << std::endl;
                 
                 // Write data rows
-                for (const auto& [label, text] : data) {
+                for (size_t i = 0; i < texts.size(); ++i) {
                     // Escape text: replace tabs with spaces
-                    std::string escapedText = text;
+                    std::string escapedText = texts[i];
                     std::replace(escapedText.begin(), escapedText.end(), '\t', ' ');
                     
                     // Write row
-                    file << label << "\t" << escapedText << std::endl;
+                    file << labels[i] << "\t" << escapedText << std::endl;
                 }
                 break;
                 
@@ -130,11 +143,9 @@ bool Dataset::saveToFile(
                 file << "[\n";
                 
                 // Write data rows
-                for (size_t i = 0; i < data.size(); ++i) {
-                    const auto& [label, text] = data[i];
-                    
+                for (size_t i = 0; i < texts.size(); ++i) {
                     // Escape text for JSON
-                    std::string escapedText = text;
+                    std::string escapedText = texts[i];
                     size_t pos = 0;
                     while ((pos = escapedText.find('"', pos)) != std::string::npos) {
                         escapedText.replace(pos, 1, "\\\"");
@@ -147,10 +158,10 @@ bool Dataset::saveToFile(
                     }
                     
                     // Write JSON object
-                    file << "  {\"label\": " << label << ", \"text\": \"" << escapedText << "\"}";
+                    file << "  {\"label\": " << labels[i] << ", \"text\": \"" << escapedText << "\"}";
                     
                     // Add comma if not the last item
-                    if (i < data.size() - 1) {
+                    if (i < texts.size() - 1) {
                         file << ",";
                     }
                     
@@ -178,11 +189,11 @@ void Dataset::splitTrainTest(
     bool stratify,
     unsigned int randomSeed
 ) {
-    if (data.empty()) {
+    if (texts.empty()) {
         throw std::runtime_error("Dataset is empty. Cannot split.");
     }
     
-    size_t datasetSize = data.size();
+    size_t datasetSize = texts.size();
     size_t testCount;
     
     // Convert testSize to absolute count if it's a fraction
@@ -202,28 +213,19 @@ void Dataset::splitTrainTest(
     if (stratify) {
         // Stratified split to maintain class distribution
         
-        // Get label distribution
-        auto distribution = getLabelDistribution();
-        
         // Create a random engine
         std::mt19937 g(randomSeed);
         
-        // For each label, split proportionally
-        for (const auto& [label, count] : distribution) {
-            // Get indices for this label
-            std::vector<size_t> labelIndices;
-            for (size_t i = 0; i < data.size(); ++i) {
-                if (data[i].first == label) {
-                    labelIndices.push_back(i);
-                }
-            }
-            
+        // For each label, split proportionally; the per-label index lists
+        // were built while loading, so the samples are not rescanned
+        for (const auto& [label, indices] : labelGroups) {
             // Shuffle indices for this label
+            std::vector<size_t> labelIndices = indices;
             std::shuffle(labelIndices.begin(), labelIndices.end(), g);
             
             // Calculate test count for this label
             size_t labelTestCount = static_cast<size_t>(
-                testCount * static_cast<double>(count) / datasetSize
+                testCount * static_cast<double>(labelIndices.size()) / datasetSize
             );
             
             // Ensure at least one test sample if there are samples
@@ -269,14 +271,45 @@ void Dataset::splitTrainTest(
               << testIndices.size() << " test samples" << std::endl;
 }
 
+TextView Dataset::viewTrainTexts() const {
+    return TextView(texts, trainIndices);
+}
+
+LabelView Dataset::viewTrainLabels() const {
+    return LabelView(labels, trainIndices);
+}
+
+TextView Dataset::viewTestTexts() const {
+    return TextView(texts, testIndices);
+}
+
+LabelView Dataset::viewTestLabels() const {
+    return LabelView(labels, testIndices);
+}
+
+TextView Dataset::viewTextsWithLabel(int label) const {
+    auto group = std::lower_bound(labelGroups.begin(), labelGroups.end(), label,
+                                  [](const auto& entry, int value) { return entry.first < value; });
+    if (group == labelGroups.end() || group->first != label) {
+        return {};
+    }
+    return TextView(texts, group->second);
+}
+
+std::span<const std::string> Dataset::textColumn() const {
+    return texts;
+}
+
+std::span<const int> Dataset::labelColumn() const {
+    return labels;
+}
+
 std::vector<std::pair<int, std::string>> Dataset::getTrainData() const {
     std::vector<std::pair<int, std::string>> trainData;
     trainData.reserve(trainIndices.size());
     
     for (size_t idx : trainIndices) {
-        if (idx < data.size()) {
-            trainData.push_back(data[idx]);
-        }
+        trainData.emplace_back(labels[idx], texts[idx]);
     }
     
     return trainData;
@@ -287,87 +320,87 @@ std::vector<std::pair<int, std::string>> Dataset::getTestData() const {
     testData.reserve(testIndices.size());
     
     for (size_t idx : testIndices) {
-        if (idx < data.size()) {
-            testData.push_back(data[idx]);
-        }
+        testData.emplace_back(labels[idx], texts[idx]);
     }
     
     return testData;
 }
 
 std::vector<std::string> Dataset::getTrainTexts() const {
-    std::vector<std::string> trainTexts;
-    trainTexts.reserve(trainIndices.size());
-    
-    for (size_t idx : trainIndices) {
-        if (idx < data.size()) {
-            trainTexts.push_back(data[idx].second);
-        }
-    }
-    
-    return trainTexts;
+    return viewTrainTexts().toVector();
 }
 
 std::vector<std::string> Dataset::getTestTexts() const {
-    std::vector<std::string> testTexts;
-    testTexts.reserve(testIndices.size());
-    
-    for (size_t idx : testIndices) {
-        if (idx < data.size()) {
-            testTexts.push_back(data[idx].second);
-        }
-    }
-    
-    return testTexts;
+    return viewTestTexts().toVector();
 }
 
 std::vector<int> Dataset::getTrainLabels() const {
-    std::vector<int> trainLabels;
-    trainLabels.reserve(trainIndices.size());
-    
-    for (size_t idx : trainIndices) {
-        if (idx < data.size()) {
-            trainLabels.push_back(data[idx].first);
-        }
-    }
-    
-    return trainLabels;
+    return viewTrainLabels().toVector();
 }
 
 std::vector<int> Dataset::getTestLabels() const {
-    std::vector<int> testLabels;
-    testLabels.reserve(testIndices.size());
+    return viewTestLabels().toVector();
+}
+
+std::vector<std::string> Dataset::getTexts() const {
+    return texts;
+}
+
+std::vector<int> Dataset::getLabels() const {
+    return labels;
+}
+
+std::vector<size_t> Dataset::assignFolds(
+    size_t folds,
+    bool stratify,
+    unsigned int randomSeed
+) const {
+    if (folds < 2 || folds > texts.size()) {
+        throw std::invalid_argument("Fold count must be between 2 and the number of samples");
+    }
     
-    for (size_t idx : testIndices) {
-        if (idx < data.size()) {
-            testLabels.push_back(data[idx].first);
+    // Groups of samples dealt out together: one per label, or the whole dataset
+    std::vector<std::vector<size_t>> groups;
+    if (stratify) {
+        // Label groups are sorted so the assignment does not depend on hash map order
+        for (const auto& [label, indices] : labelGroups) {
+            groups.push_back(indices);
         }
+    } else {
+        std::vector<size_t> indices(texts.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        groups.push_back(std::move(indices));
     }
     
-    return testLabels;
-}
-
-std::vector<std::string> Dataset::getTextsWithLabel(int label) const {
-    std::vector<std::string> filteredTexts;
+    std::mt19937 g(randomSeed);
+    std::vector<size_t> assignment(texts.size());
     
-    for (const auto& [dataLabel, text] : data) {
-        if (dataLabel == label) {
-            filteredTexts.push_back(text);
+    // Each group continues where the previous one stopped so the folds stay balanced
+    size_t next = 0;
+    for (auto& group : groups) {
+        std::shuffle(group.begin(), group.end(), g);
+        for (size_t idx : group) {
+            assignment[idx] = next;
+            next = (next + 1) % folds;
         }
     }
     
-    return filteredTexts;
+    return assignment;
+}
+
+std::vector<std::string> Dataset::getTextsWithLabel(int label) const {
+    return viewTextsWithLabel(label).toVector();
 }
 
 size_t Dataset::size() const {
-    return data.size();
+    return texts.size();
 }
 
 std::unordered_map<int, size_t> Dataset::getLabelDistribution() const {
     std::unordered_map<int, size_t> distribution;
     
-    for (const auto& [label, _] : data) {
-        distribution[label]++;
+    for (const auto& [label, indices] : labelGroups) {
+        distribution[label] = indices.size();
     }
     
     return distribution;
@@ -377,7 +410,7 @@ std::unordered_map<std::string, std::string> Dataset::getStatistics() const {
     std::unordered_map<std::string, std::string> stats;
     
     // Basic stats
-    stats["total_samples"] = std::to_string(data.size());
+    stats["total_samples"] = std::to_string(texts.size());
     stats["train_samples"] = std::to_string(trainIndices.size());
     stats["test_samples"] = std::to_string(testIndices.size());
     
@@ -385,18 +418,18 @@ std::unordered_map<std::string, std::string> Dataset::getStatistics() const {
     auto distribution = getLabelDistribution();
     for (const auto& [label, count] : distribution) {
         stats["label_" + std::to_string(label) + "_count"] = std::to_string(count);
-        double percentage = data.empty() ? 0.0 : (static_cast<double>(count) / data.size() * 100.0);
+        double percentage = texts.empty() ? 0.0 : (static_cast<double>(count) / texts.size() * 100.0);
         stats["label_" + std::to_string(label) + "_percentage"] = 
             std::to_string(static_cast<int>(percentage)) + "%";
     }
     
     // Text length stats
-    if (!data.empty()) {
+    if (!texts.empty()) {
         size_t minLength = SIZE_MAX;
         size_t maxLength = 0;
         size_t totalLength = 0;
         
-        for (const auto& [_, text] : data) {
+        for (const auto& text : texts) {
             size_t length = text.size();
             minLength = std::min(minLength, length);
             maxLength = std::max(maxLength, length);
@@ -405,7 +438,7 @@ std::unordered_map<std::string, std::string> Dataset::getStatistics() const {
         
         stats["min_text_length"] = std::to_string(minLength);
         stats["max_text_length"] = std::to_string(maxLength);
-        stats["avg_text_length"] = std::to_string(totalLength / data.size());
+        stats["avg_text_length"] = std::to_string(totalLength / texts.size());
     }
     
     return stats;
@@ -416,158 +449,7 @@ bool Dataset::loadFromCSV(
     const std::string& labelColumn,
     const std::string& textColumn
 ) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file: " << filePath << std::endl;
-        return false;
-    }
-    
-    data.clear();
-    
-    std::string line;
-    std::getline(file, line); // Read header line
-    
-    std::cout << "Raw CSV header: '" << line << "'" << std::endl;
-    
-    // Split the header line directly without using stringstream to avoid issues
-    std::vector<std::string> headers;
-    size_t start = 0;
-    size_t end = 0;
-    bool inQuotes = false;
-    
-    while (end < line.length()) {
-        char c = line[end];
-        
-        if (c == '"') {
-            inQuotes = !inQuotes;
-        } 
-        else if (c == ',' && !inQuotes) {
-            // Found a column separator
-            std::string header = line.substr(start, end - start);
-            
-            // Clean the header: remove quotes, trim whitespace
-            header.erase(std::remove(header.begin(), header.end(), '"'), header.end());
-            header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
-            header.erase(std::remove(header.begin(), header.end(), '\r'), header.end());
-            header.erase(std::remove(header.begin(), header.end(), '\n'), header.end());
-            
-            std::cout << "Extracted header: '" << header << "'" << std::endl;
-            headers.push_back(header);
-            
-            // Move to next column
-            start = end + 1;
-        }
-        
-        end++;
-    }
-    
-    // Add the last column
-    if (start < line.length()) {
-        std::string header = line.substr(start);
-        header.erase(std::remove(header.begin(), header.end(), '"'), header.end());
-        header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
-        header.erase(std::remove(header.begin(), header.end(), '\r'), header.end());
-        header.erase(std::remove(header.begin(), header.end(), '\n'), header.end());
-        
-        std::cout << "Extracted last header: '" << header << "'" << std::endl;
-        headers.push_back(header);
-    }
-    
-    // Use case-insensitive string comparison for header names
-    auto headerMatch = [](const std::string& a, const std::string& b) {
-        if (a.size() != b.size()) return false;
-        
-        for (size_t i = 0; i < a.size(); i++) {
-            if (std::tolower(a[i]) != std::tolower(b[i]))
-                return false;
-        }
-        
-        return true;
-    };
-    
-    // Find column indices
-    int labelIdx = -1;
-    int textIdx = -1;
-    
-    for (size_t i = 0; i < headers.size(); ++i) {
-        std::cout << "Checking header '" << headers[i] << "' against label column '" << labelColumn << "'" << std::endl;
-        if (headerMatch(headers[i], labelColumn)) {
-            labelIdx = static_cast<int>(i);
-            std::cout << "Found label column at index " << labelIdx << std::endl;
-        }
-        
-        std::cout << "Checking header '" << headers[i] << "' against text column '" << textColumn << "'" << std::endl;
-        if (headerMatch(headers[i], textColumn)) {
-            textIdx = static_cast<int>(i);
-            std::cout << "Found text column at index " << textIdx << std::endl;
-        }
-    }
-    
-    if (labelIdx == -1 || textIdx == -1) {
-        std::cerr << "Error: Could not find required columns in CSV file." << std::endl;
-        std::cerr << "Looking for: '" << labelColumn << "' and '" << textColumn << "'" << std::endl;
-        std::cerr << "Available columns: ";
-        for (const auto& h : headers) {
-            std::cerr << "'" << h << "' ";
-        }
-        std::cerr << std::endl;
-        return false;
-    }
-    
-    // Parse data rows manually to handle CSV format issues
-    while (std::getline(file, line)) {
-        std::vector<std::string> values;
-        size_t pos = 0;
-        std::string token;
-        bool inQuotes = false;
-        
-        for (size_t i = 0; i < line.length(); i++) {
-            char c = line[i];
-            
-            if (c == '"') {
-                inQuotes = !inQuotes;
-            } 
-            else if (c == ',' && !inQuotes) {
-                // End of field
-                values.push_back(line.substr(pos, i - pos));
-                pos = i + 1;
-            }
-        }
-        
-        // Add the last field
-        values.push_back(line.substr(pos));
-        
-        // Skip lines with wrong number of columns
-        if (values.size() <= static_cast<size_t>(std::max(labelIdx, textIdx))) {
-            continue;
-        }
-        
-        // Extract label and text
-        try {
-            // Clean up the label value
-            std::string labelStr = values[labelIdx];
-            labelStr.erase(std::remove(labelStr.begin(), labelStr.end(), '"'), labelStr.end());
-            labelStr.erase(std::remove(labelStr.begin(), labelStr.end(), ' '), labelStr.end());
-            
-            int label = std::stoi(labelStr);
-            
-            // Clean up the text value
-            std::string text = values[textIdx];
-            if (!text.empty()) {
-                // Remove surrounding quotes if present
-                if (text.front() == '"' && text.back() == '"') {
-                    text = text.substr(1, text.size() - 2);
-                }
-            }
-            
-            data.emplace_back(label, text);
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Error parsing CSV line: " << e.what() << std::endl;
-        }
-    }
-    
-    std::cout << "Loaded " << data.size() << " samples from " << filePath << std::endl;
-    return !data.empty();
+    return loadDelimited(filePath, Format::CSV, labelColumn, textColumn);
 }
 
 bool Dataset::loadFromTSV(
@@ -575,74 +457,36 @@ bool Dataset::loadFromTSV(
     const std::string& labelColumn,
     const std::string& textColumn
 ) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file: " << filePath << std::endl;
+    return loadDelimited(filePath, Format::TSV, labelColumn, textColumn);
+}
+
+bool Dataset::loadDelimited(
+    const std::string& filePath,
+    Format format,
+    const std::string& labelColumn,
+    const std::string& textColumn
+) {
+    DatasetReader reader;
+    if (!reader.open(filePath, format, labelColumn, textColumn)) {
         return false;
     }
     
-    data.clear();
-    
-    std::string line;
-    std::getline(file, line); // Read header line
-    
-    // Parse header to find column indices
-    std::vector<std::string> headers;
-    std::stringstream headerStream(line);
-    std::string header;
-    
-    while (std::getline(headerStream, header, '\t')) {
-        // Remove whitespace
-        header.erase(std::remove(header.begin(), header.end(), ' '), header.end());
-        headers.push_back(header);
-    }
-    
-    // Find column indices
-    int labelIdx = -1;
-    int textIdx = -1;
+    texts.clear();
+    labels.clear();
     
-    for (size_t i = 0; i < headers.size(); ++i) {
-        if (headers[i] == labelColumn) {
-            labelIdx = static_cast<int>(i);
-        }
-        if (headers[i] == textColumn) {
-            textIdx = static_cast<int>(i);
+    // Rows are parsed in place from the mapped file; only the two
+    // requested columns are copied
+    std::vector<std::pair<int, std::string>> batch;
+    while (reader.readBatch(batch, LOAD_BATCH_SIZE) > 0) {
+        for (auto& [label, text] : batch) {
+            labels.push_back(label);
+            texts.push_back(std::move(text));
         }
     }
+    indexLabels();
     
-    if (labelIdx == -1 || textIdx == -1) {
-        std::cerr << "Error: Could not find required columns in TSV file." << std::endl;
-        return false;
-    }
-    
-    // Parse data rows
-    while (std::getline(file, line)) {
-        std::vector<std::string> values;
-        std::stringstream lineStream(line);
-        std::string value;
-        
-        while (std::getline(lineStream, value, '\t')) {
-            values.push_back(value);
-        }
-        
-        // Skip lines with wrong number of columns
-        if (values.size() <= static_cast<size_t>(std::max(labelIdx, textIdx))) {
-            continue;
-        }
-        
-        // Extract label and text
-        try {
-            int label = std::stoi(values[labelIdx]);
-            std::string text = values[textIdx];
-            
-            data.emplace_back(label, text);
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Error parsing TSV line: " << e.what() << std::endl;
-        }
-    }
-    
-    std::cout << "Loaded " << data.size() << " samples from " << filePath << std::endl;
-    return !data.empty();
+    std::cout << "Loaded " << texts.size() << " samples from " << filePath << std::endl;
+    return !texts.empty();
 }
 
 bool Dataset::loadFromJSON(
@@ -659,7 +503,8 @@ bool Dataset::loadFromJSON(
         return false;
     }
     
-    data.clear();
+    texts.clear();
+    labels.clear();
     
     std::string line;
     bool inArray = false;
@@ -762,14 +607,31 @@ bool Dataset::loadFromJSON(
         // Parse label and add to data
         try {
             int label = std::stoi(labelStr);
-            data.emplace_back(label, unescaped);
+            labels.push_back(label);
+            texts.push_back(std::move(unescaped));
         } catch (const std::exception& e) {
             std::cerr << "Warning: Error parsing JSON: " << e.what() << std::endl;
         }
     }
+    indexLabels();
     
-    std::cout << "Loaded " << data.size() << " samples from " << filePath << std::endl;
-    return !data.empty();
+    std::cout << "Loaded " << texts.size() << " samples from " << filePath << std::endl;
+    return !texts.empty();
+}
+
+void Dataset::indexLabels() {
+    // One pass over the labels; groups are then ordered by label value
+    std::unordered_map<int, std::vector<size_t>> groups;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        groups[labels[i]].push_back(i);
+    }
+    
+    labelGroups.assign(std::make_move_iterator(groups.begin()), std::make_move_iterator(groups.end()));
+    std::sort(labelGroups.begin(), labelGroups.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    trainIndices.clear();
+    testIndices.clear();
 }
 
 } // namespace utils
@@ -0,0 +1,213 @@
+/**
+ * @file dataset_reader.cpp
+ * @brief Implementation of the streaming dataset reader
+ */
+
+#include "blahajpi/utils/dataset_reader.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/**
+ * @brief Trims spaces and line-break characters from both ends
+ * @param value Raw value
+ * @return Trimmed view
+ */
+std::string_view trim(std::string_view value) {
+    constexpr std::string_view blanks = " \t\r\n";
+    size_t first = value.find_first_not_of(blanks);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    size_t last = value.find_last_not_of(blanks);
+    return value.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Normalizes a header name the way the original loaders did
+ *
+ * Spaces and quotes are dropped anywhere in the name, so a column
+ * headed "sentiment label" is found as "sentimentlabel".
+ *
+ * @param raw Raw header field
+ * @return Name to match against
+ */
+std::string headerName(std::string_view raw) {
+    std::string name;
+    name.reserve(raw.size());
+    for (char c : trim(raw)) {
+        if (c != ' ' && c != '"') {
+            name += c;
+        }
+    }
+    return name;
+}
+
+/**
+ * @brief Case-insensitive comparison used for header names
+ */
+bool headerMatch(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+bool DatasetReader::open(
+    const std::string& filePath,
+    Dataset::Format format,
+    const std::string& labelColumn,
+    const std::string& textColumn
+) {
+    file.reset();
+    parser = DelimitedParser({}, ',', true);
+    samplesRead = 0;
+
+    // Auto-detect format from file extension if requested
+    if (format == Dataset::Format::AUTO) {
+        std::string extension = std::filesystem::path(filePath).extension().string();
+        if (extension == ".tsv") {
+            format = Dataset::Format::TSV;
+        } else if (extension == ".json") {
+            format = Dataset::Format::JSON;
+        } else {
+            format = Dataset::Format::CSV;
+        }
+    }
+
+    if (format == Dataset::Format::JSON) {
+        std::cerr << "Error: Streaming is only supported for CSV and TSV files: " << filePath << std::endl;
+        return false;
+    }
+    bool csv = format == Dataset::Format::CSV;
+
+    auto mapped = MappedFile::open(filePath);
+    if (!mapped) {
+        std::cerr << "Error: Could not open file: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string_view contents(reinterpret_cast<const char*>(mapped->data()), mapped->size());
+    parser = DelimitedParser(contents, csv ? ',' : '\t', csv);
+
+    // Read header line
+    std::vector<std::string> headers;
+    if (parser.next(fields)) {
+        for (const auto& field : fields) {
+            headers.push_back(headerName(field.raw));
+        }
+    }
+
+    int foundLabel = -1;
+    int foundText = -1;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (foundLabel < 0 && headerMatch(headers[i], labelColumn)) {
+            foundLabel = static_cast<int>(i);
+        }
+        if (foundText < 0 && headerMatch(headers[i], textColumn)) {
+            foundText = static_cast<int>(i);
+        }
+    }
+
+    if (foundLabel == -1 || foundText == -1) {
+        std::cerr << "Error: Could not find required columns in " << (csv ? "CSV" : "TSV") << " file." << std::endl;
+        std::cerr << "Looking for: '" << labelColumn << "' and '" << textColumn << "'" << std::endl;
+        std::cerr << "Available columns: ";
+        for (const auto& h : headers) {
+            std::cerr << "'" << h << "' ";
+        }
+        std::cerr << std::endl;
+        parser = DelimitedParser({}, ',', true);
+        return false;
+    }
+
+    file = std::move(mapped);
+    labelIdx = static_cast<size_t>(foundLabel);
+    textIdx = static_cast<size_t>(foundText);
+    dataStart = parser.position();
+    return true;
+}
+
+size_t DatasetReader::readBatch(std::vector<std::pair<int, std::string>>& batch, size_t maxSamples) {
+    batch.clear();
+    if (!file) {
+        return 0;
+    }
+
+    std::pair<int, std::string> sample;
+    while (batch.size() < maxSamples && parser.next(fields)) {
+        if (parseRow(sample)) {
+            batch.push_back(std::move(sample));
+        }
+    }
+
+    samplesRead += batch.size();
+    return batch.size();
+}
+
+bool DatasetReader::rewind() {
+    if (!file) {
+        return false;
+    }
+
+    parser.seek(dataStart);
+    samplesRead = 0;
+    return true;
+}
+
+bool DatasetReader::isOpen() const {
+    return file != nullptr;
+}
+
+size_t DatasetReader::getSamplesRead() const {
+    return samplesRead;
+}
+
+bool DatasetReader::isHeldOut(size_t sampleIndex, double testSize, unsigned int seed) {
+    // SplitMix64 finalizer over the index, mapped to [0, 1)
+    uint64_t x = static_cast<uint64_t>(sampleIndex) + 0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(seed) + 1);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+
+    return static_cast<double>(x >> 11) * 0x1.0p-53 < testSize;
+}
+
+bool DatasetReader::parseRow(std::pair<int, std::string>& sample) const {
+    // Skip lines with wrong number of columns
+    if (fields.size() <= std::max(labelIdx, textIdx)) {
+        return false;
+    }
+
+    // Labels are integers read like std::stoi: an optional sign, then digits; anything after (e.g. "4.0") is ignored
+    std::string_view labelText = trim(fields[labelIdx].raw);
+    if (labelText.size() > 1 && labelText[0] == '+' && std::isdigit(static_cast<unsigned char>(labelText[1]))) {
+        labelText.remove_prefix(1);
+    }
+    int label = 0;
+    auto [end, error] = std::from_chars(labelText.data(), labelText.data() + labelText.size(), label);
+    if (error != std::errc() || end == labelText.data()) {
+        return false;
+    }
+
+    sample.first = label;
+    sample.second = fields[textIdx].value();
+    return true;
+}
+
+} // namespace utils
+} // namespace blahajpi
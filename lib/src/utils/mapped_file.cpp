@@ -0,0 +1,86 @@
+/**
+ * @file mapped_file.cpp
+ * @brief Implementation of read-only memory-mapped files
+ */
+
+#include "blahajpi/utils/mapped_file.hpp"
+#include <fstream>
+#include <iostream>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BLAHAJPI_HAVE_MMAP 1
+#endif
+
+namespace blahajpi {
+namespace utils {
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& filePath) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef BLAHAJPI_HAVE_MMAP
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat info {};
+        if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size),
+                                   PROT_READ, MAP_SHARED, fd, 0);
+            if (address != MAP_FAILED) {
+                file->bytes = static_cast<const unsigned char*>(address);
+                file->length = static_cast<size_t>(info.st_size);
+                file->mapped = true;
+            }
+        }
+        ::close(fd);
+
+        if (file->mapped) {
+            return file;
+        }
+    }
+#endif
+
+    // Buffered fallback (also used for empty files, which cannot be mapped)
+    std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) {
+        std::cerr << "Error: Could not open file for reading: " << filePath << std::endl;
+        return nullptr;
+    }
+
+    std::streamsize size = stream.tellg();
+    stream.seekg(0);
+    file->buffer.resize(static_cast<size_t>(size));
+    if (size > 0 && !stream.read(reinterpret_cast<char*>(file->buffer.data()), size)) {
+        std::cerr << "Error: Could not read file: " << filePath << std::endl;
+        return nullptr;
+    }
+
+    file->bytes = file->buffer.data();
+    file->length = file->buffer.size();
+    return file;
+}
+
+MappedFile::~MappedFile() {
+#ifdef BLAHAJPI_HAVE_MMAP
+    if (mapped) {
+        ::munmap(const_cast<unsigned char*>(bytes), length);
+    }
+#endif
+}
+
+const unsigned char* MappedFile::data() const {
+    return bytes;
+}
+
+size_t MappedFile::size() const {
+    return length;
+}
+
+bool MappedFile::isMapped() const {
+    return mapped;
+}
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,432 @@
+/**
+ * @file model_bundle.cpp
+ * @brief Implementation of the model bundle format
+ */
+
+#include "blahajpi/utils/model_bundle.hpp"
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/// First bytes of every bundle
+constexpr char BUNDLE_MAGIC[8] = {'B', 'L', 'A', 'H', 'A', 'J', 'P', 'I'};
+
+/// Size of the fixed header that precedes the section table
+constexpr size_t HEADER_SIZE = 32;
+
+/// Size of one section table entry
+constexpr size_t TABLE_ENTRY_SIZE = 32;
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+template <typename T>
+void appendLittleEndian(std::vector<unsigned char>& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<unsigned char>(value >> (8 * i)));
+    }
+}
+
+template <typename T>
+T decodeLittleEndian(const unsigned char* bytes) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+uint32_t crc32(const unsigned char* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = CRC_TABLE[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// ==========================================
+// SectionWriter
+// ==========================================
+
+void SectionWriter::writeU8(uint8_t value) {
+    buffer.push_back(value);
+}
+
+void SectionWriter::writeU32(uint32_t value) {
+    appendLittleEndian(buffer, value);
+}
+
+void SectionWriter::writeI32(int32_t value) {
+    appendLittleEndian(buffer, static_cast<uint32_t>(value));
+}
+
+void SectionWriter::writeU64(uint64_t value) {
+    appendLittleEndian(buffer, value);
+}
+
+void SectionWriter::writeI64(int64_t value) {
+    appendLittleEndian(buffer, static_cast<uint64_t>(value));
+}
+
+void SectionWriter::writeF64(double value) {
+    appendLittleEndian(buffer, std::bit_cast<uint64_t>(value));
+}
+
+void SectionWriter::writeString(std::string_view value) {
+    writeU32(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+}
+
+void SectionWriter::writeBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void SectionWriter::writeI32Array(const std::vector<int>& values) {
+    buffer.reserve(buffer.size() + values.size() * sizeof(int32_t));
+    for (int value : values) {
+        writeI32(value);
+    }
+}
+
+void SectionWriter::writeF64Array(const std::vector<double>& values) {
+    if constexpr (std::endian::native == std::endian::little) {
+        writeBytes(values.data(), values.size() * sizeof(double));
+    } else {
+        buffer.reserve(buffer.size() + values.size() * sizeof(double));
+        for (double value : values) {
+            writeF64(value);
+        }
+    }
+}
+
+const std::vector<unsigned char>& SectionWriter::bytes() const {
+    return buffer;
+}
+
+// ==========================================
+// SectionReader
+// ==========================================
+
+SectionReader::SectionReader(std::span<const unsigned char> bytes) : data(bytes) {}
+
+const unsigned char* SectionReader::take(size_t size) {
+    if (failed || size > data.size() - position) {
+        failed = true;
+        return nullptr;
+    }
+    const unsigned char* bytes = data.data() + position;
+    position += size;
+    return bytes;
+}
+
+uint8_t SectionReader::readU8() {
+    const unsigned char* bytes = take(1);
+    return bytes ? bytes[0] : 0;
+}
+
+uint32_t SectionReader::readU32() {
+    const unsigned char* bytes = take(sizeof(uint32_t));
+    return bytes ? decodeLittleEndian<uint32_t>(bytes) : 0;
+}
+
+int32_t SectionReader::readI32() {
+    return static_cast<int32_t>(readU32());
+}
+
+uint64_t SectionReader::readU64() {
+    const unsigned char* bytes = take(sizeof(uint64_t));
+    return bytes ? decodeLittleEndian<uint64_t>(bytes) : 0;
+}
+
+int64_t SectionReader::readI64() {
+    return static_cast<int64_t>(readU64());
+}
+
+double SectionReader::readF64() {
+    return std::bit_cast<double>(readU64());
+}
+
+std::string SectionReader::readString() {
+    uint32_t length = readU32();
+    std::span<const unsigned char> bytes = readBytes(length);
+    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+std::span<const unsigned char> SectionReader::readBytes(size_t size) {
+    const unsigned char* bytes = take(size);
+    if (!bytes) {
+        return {};
+    }
+    return std::span<const unsigned char>(bytes, size);
+}
+
+std::vector<int> SectionReader::readI32Array(size_t count) {
+    if (count > remaining() / sizeof(int32_t)) {
+        failed = true;
+        return {};
+    }
+
+    std::vector<int> values(count);
+    for (auto& value : values) {
+        value = readI32();
+    }
+    return values;
+}
+
+std::vector<double> SectionReader::readF64Array(size_t count) {
+    if (count > remaining() / sizeof(double)) {
+        failed = true;
+        return {};
+    }
+
+    std::vector<double> values(count);
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(values.data(), take(count * sizeof(double)), count * sizeof(double));
+    } else {
+        for (auto& value : values) {
+            value = readF64();
+        }
+    }
+    return values;
+}
+
+size_t SectionReader::remaining() const {
+    return data.size() - position;
+}
+
+bool SectionReader::ok() const {
+    return !failed;
+}
+
+// ==========================================
+// BundleWriter
+// ==========================================
+
+SectionWriter& BundleWriter::addSection(const std::string& tag) {
+    if (tag.size() != 4) {
+        throw std::invalid_argument("Bundle section tags must be four characters: " + tag);
+    }
+    for (const auto& [existing, writer] : sections) {
+        if (existing == tag) {
+            throw std::invalid_argument("Duplicate bundle section: " + tag);
+        }
+    }
+
+    sections.emplace_back(tag, SectionWriter());
+    return sections.back().second;
+}
+
+bool BundleWriter::write(const std::string& filePath) const {
+    // Lay out the sections after the header and table
+    size_t tableEnd = HEADER_SIZE + sections.size() * TABLE_ENTRY_SIZE;
+    std::vector<size_t> offsets;
+    size_t fileSize = alignUp(tableEnd, BundleReader::SECTION_ALIGNMENT);
+    for (const auto& [tag, writer] : sections) {
+        offsets.push_back(fileSize);
+        fileSize = alignUp(fileSize + writer.bytes().size(), BundleReader::SECTION_ALIGNMENT);
+    }
+
+    std::vector<unsigned char> table;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const auto& [tag, writer] = sections[i];
+        const auto& payload = writer.bytes();
+        table.insert(table.end(), tag.begin(), tag.end());
+        appendLittleEndian(table, crc32(payload.data(), payload.size()));
+        appendLittleEndian(table, static_cast<uint64_t>(offsets[i]));
+        appendLittleEndian(table, static_cast<uint64_t>(payload.size()));
+        appendLittleEndian(table, static_cast<uint64_t>(0));
+    }
+
+    std::vector<unsigned char> header(BUNDLE_MAGIC, BUNDLE_MAGIC + sizeof(BUNDLE_MAGIC));
+    appendLittleEndian(header, BundleReader::FORMAT_VERSION);
+    appendLittleEndian(header, static_cast<uint32_t>(sections.size()));
+    appendLittleEndian(header, static_cast<uint64_t>(fileSize));
+    appendLittleEndian(header, crc32(table.data(), table.size()));
+    appendLittleEndian(header, static_cast<uint32_t>(0));
+
+    // Write beside the destination and rename, so a reader mapping the
+    // old bundle keeps a consistent view
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file for writing: " << tempPath << std::endl;
+            return false;
+        }
+
+        static const char padding[BundleReader::SECTION_ALIGNMENT] = {};
+        size_t written = 0;
+        auto emit = [&](const void* data, size_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written += size;
+        };
+
+        emit(header.data(), header.size());
+        emit(table.data(), table.size());
+        for (size_t i = 0; i < sections.size(); ++i) {
+            emit(padding, offsets[i] - written);
+            emit(sections[i].second.bytes().data(), sections[i].second.bytes().size());
+        }
+        emit(padding, fileSize - written);
+
+        if (!file) {
+            std::cerr << "Error: Failed to write model bundle: " << tempPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        std::cerr << "Error: Could not move model bundle into place: " << filePath
+                  << " (" << error.message() << ")" << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+// ==========================================
+// BundleReader
+// ==========================================
+
+bool BundleReader::open(const std::string& filePath) {
+    file.reset();
+    sections.clear();
+    version = 0;
+
+    auto mapped = MappedFile::open(filePath);
+    if (!mapped) {
+        return false;
+    }
+
+    const unsigned char* bytes = mapped->data();
+    size_t size = mapped->size();
+
+    if (size < HEADER_SIZE || std::memcmp(bytes, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0) {
+        std::cerr << "Error: Not a model bundle: " << filePath << std::endl;
+        return false;
+    }
+
+    uint32_t fileVersion = decodeLittleEndian<uint32_t>(bytes + 8);
+    uint32_t sectionCount = decodeLittleEndian<uint32_t>(bytes + 12);
+    uint64_t declaredSize = decodeLittleEndian<uint64_t>(bytes + 16);
+    uint32_t tableCrc = decodeLittleEndian<uint32_t>(bytes + 24);
+
+    if (fileVersion == 0 || fileVersion > FORMAT_VERSION) {
+        std::cerr << "Error: Unsupported model bundle version " << fileVersion
+                  << " (this build reads up to " << FORMAT_VERSION << "): " << filePath << std::endl;
+        return false;
+    }
+
+    if (declaredSize != size || sectionCount > (size - HEADER_SIZE) / TABLE_ENTRY_SIZE) {
+        std::cerr << "Error: Truncated model bundle: " << filePath << std::endl;
+        return false;
+    }
+
+    const unsigned char* table = bytes + HEADER_SIZE;
+    if (crc32(table, sectionCount * TABLE_ENTRY_SIZE) != tableCrc) {
+        std::cerr << "Error: Corrupt model bundle section table: " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<Section> parsed;
+    for (uint32_t i = 0; i < sectionCount; ++i) {
+        const unsigned char* entry = table + i * TABLE_ENTRY_SIZE;
+        std::string tag(reinterpret_cast<const char*>(entry), 4);
+        uint32_t checksum = decodeLittleEndian<uint32_t>(entry + 4);
+        uint64_t offset = decodeLittleEndian<uint64_t>(entry + 8);
+        uint64_t length = decodeLittleEndian<uint64_t>(entry + 16);
+
+        if (offset % SECTION_ALIGNMENT != 0 || offset > size || length > size - offset) {
+            std::cerr << "Error: Model bundle section '" << tag << "' is out of bounds: "
+                      << filePath << std::endl;
+            return false;
+        }
+
+        if (crc32(bytes + offset, length) != checksum) {
+            std::cerr << "Error: Checksum mismatch in model bundle section '" << tag << "': "
+                      << filePath << std::endl;
+            return false;
+        }
+
+        parsed.push_back({tag, std::span<const unsigned char>(bytes + offset, length)});
+    }
+
+    file = std::move(mapped);
+    sections = std::move(parsed);
+    version = fileVersion;
+    return true;
+}
+
+bool BundleReader::hasSection(const std::string& tag) const {
+    for (const auto& entry : sections) {
+        if (entry.tag == tag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::span<const unsigned char> BundleReader::section(const std::string& tag) const {
+    for (const auto& entry : sections) {
+        if (entry.tag == tag) {
+            return entry.bytes;
+        }
+    }
+    return {};
+}
+
+SectionReader BundleReader::reader(const std::string& tag) const {
+    return SectionReader(section(tag));
+}
+
+uint32_t BundleReader::getVersion() const {
+    return version;
+}
+
+const std::shared_ptr<const MappedFile>& BundleReader::getFile() const {
+    return file;
+}
+
+bool BundleReader::isBundleFile(const std::string& filePath) {
+    std::ifstream stream(filePath, std::ios::binary);
+    if (!stream.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(BUNDLE_MAGIC)];
+    stream.read(magic, sizeof(magic));
+    return stream && std::memcmp(magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) == 0;
+}
+
+} // namespace utils
+} // namespace blahajpi
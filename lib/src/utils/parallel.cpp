@@ -0,0 +1,91 @@
+/**
+ * @file parallel.cpp
+ * @brief Implementation of the data-parallel helpers
+ */
+
+#include "blahajpi/utils/parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace blahajpi {
+namespace utils {
+
+size_t resolveThreadCount(int requested) {
+    if (requested > 0) {
+        return static_cast<size_t>(requested);
+    }
+    
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+void parallelFor(size_t count, size_t threads, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    
+    threads = std::max<size_t>(1, std::min(threads, count));
+    
+    if (threads == 1) {
+        for (size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+    
+    // Exceptions must not escape a worker, so keep the first one and
+    // make the remaining workers skip their items
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+    std::atomic<bool> failed{false};
+    
+    auto runItem = [&](size_t i) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        try {
+            body(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+            failed.store(true, std::memory_order_relaxed);
+        }
+    };
+    
+#ifdef HAVE_OPENMP
+    const long long total = static_cast<long long>(count);
+    #pragma omp parallel for schedule(dynamic) num_threads(static_cast<int>(threads))
+    for (long long i = 0; i < total; ++i) {
+        runItem(static_cast<size_t>(i));
+    }
+#else
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                runItem(i);
+            }
+        });
+    }
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+#endif
+    
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+} // namespace utils
+} // namespace blahajpi
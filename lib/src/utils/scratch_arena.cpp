@@ -0,0 +1,75 @@
+/**
+ * @file scratch_arena.cpp
+ * @brief Implementation of the per-thread scratch arena
+ */
+
+#include "blahajpi/utils/scratch_arena.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/**
+ * @brief Memory a thread keeps for its arenas
+ */
+struct ThreadBlock {
+    std::unique_ptr<std::byte[]> data;  ///< Block memory (allocated on first use)
+    size_t size = 0;                    ///< Bytes in the block
+    bool inUse = false;                 ///< Whether an arena currently holds the block
+};
+
+/// Block of the current thread
+thread_local ThreadBlock threadBlock;
+
+} // namespace
+
+void* ScratchArena::CountingResource::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void ScratchArena::CountingResource::do_deallocate(void* pointer, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+}
+
+bool ScratchArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+ScratchArena::ScratchArena()
+    : block(claimBlock()),
+      arena(block.data(), block.size(), &upstream) {
+}
+
+ScratchArena::~ScratchArena() {
+    arena.release();
+    if (block.empty()) {
+        return;
+    }
+
+    // Grow the block by what overflowed, so the next arena fits inside it
+    if (upstream.bytes > 0 && threadBlock.size < MAX_BLOCK_BYTES) {
+        size_t grown = std::min(MAX_BLOCK_BYTES, std::max(threadBlock.size * 2, threadBlock.size + upstream.bytes));
+        threadBlock.data = std::make_unique_for_overwrite<std::byte[]>(grown);
+        threadBlock.size = grown;
+    }
+    threadBlock.inUse = false;
+}
+
+std::span<std::byte> ScratchArena::claimBlock() {
+    if (threadBlock.inUse) {
+        return {};
+    }
+    if (!threadBlock.data) {
+        threadBlock.data = std::make_unique_for_overwrite<std::byte[]>(INITIAL_BLOCK_BYTES);
+        threadBlock.size = INITIAL_BLOCK_BYTES;
+    }
+    threadBlock.inUse = true;
+    return {threadBlock.data.get(), threadBlock.size};
+}
+
+} // namespace utils
+} // namespace blahajpi
@@ -0,0 +1,327 @@
+/**
+ * @file stats.cpp
+ * @brief Implementation of the analyzer counters and their exporters
+ */
+
+#include "blahajpi/utils/stats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+
+namespace blahajpi {
+namespace utils {
+
+namespace {
+
+/**
+ * @brief Maps a per-document time to its histogram bucket
+ * @param nanos Time in nanoseconds
+ * @return Bucket index (LATENCY_BUCKETS.size() for the overflow bucket)
+ */
+size_t bucketIndex(uint64_t nanos) {
+    auto it = std::lower_bound(LATENCY_BUCKETS.begin(), LATENCY_BUCKETS.end(), nanos);
+    return static_cast<size_t>(it - LATENCY_BUCKETS.begin());
+}
+
+/**
+ * @brief Raises an atomic maximum
+ * @param target Current maximum
+ * @param value Candidate value
+ */
+void updateMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Converts nanoseconds to seconds
+ */
+double toSeconds(uint64_t nanos) {
+    return static_cast<double>(nanos) * 1e-9;
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Preprocess: return "preprocess";
+        case Stage::NearDuplicates: return "near_duplicates";
+        case Stage::Vectorize: return "vectorize";
+        case Stage::Cascade: return "cascade";
+        case Stage::Score: return "score";
+        case Stage::KeyTerms: return "key_terms";
+        case Stage::Explanation: return "explanation";
+    }
+    return "unknown";
+}
+
+// ==========================================
+// StageStats Implementation
+// ==========================================
+
+double StageStats::meanMicros() const {
+    if (documents == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(totalNanos) / static_cast<double>(documents) * 1e-3;
+}
+
+double StageStats::percentileMicros(double quantile) const {
+    if (documents == 0) {
+        return 0.0;
+    }
+
+    // Smallest bucket whose cumulative count reaches the quantile's rank
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(documents)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS.size(); ++i) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) {
+            return static_cast<double>(std::min(LATENCY_BUCKETS[i], maxNanos)) * 1e-3;
+        }
+    }
+    return static_cast<double>(maxNanos) * 1e-3;
+}
+
+// ==========================================
+// AnalyzerStats Implementation
+// ==========================================
+
+const StageStats& AnalyzerStats::stage(Stage stage) const {
+    return stages[static_cast<size_t>(stage)];
+}
+
+double AnalyzerStats::documentsPerSecond() const {
+    return uptimeSeconds > 0.0 ? static_cast<double>(documents) / uptimeSeconds : 0.0;
+}
+
+double AnalyzerStats::vocabularyHitRate() const {
+    return termsSeen > 0 ? static_cast<double>(termsMatched) / static_cast<double>(termsSeen) : 0.0;
+}
+
+double AnalyzerStats::cacheHitRate() const {
+    uint64_t lookups = cacheHits + cacheMisses;
+    return lookups > 0 ? static_cast<double>(cacheHits) / static_cast<double>(lookups) : 0.0;
+}
+
+double AnalyzerStats::cascadeExitRate() const {
+    return cascadeChecked > 0 ? static_cast<double>(cascadeExits) / static_cast<double>(cascadeChecked) : 0.0;
+}
+
+double AnalyzerStats::nearDuplicateReuseRate() const {
+    return nearDuplicatesChecked > 0
+        ? static_cast<double>(nearDuplicatesReused) / static_cast<double>(nearDuplicatesChecked) : 0.0;
+}
+
+std::string AnalyzerStats::toJson() const {
+    std::ostringstream out;
+    out.precision(9);
+
+    out << "{\"enabled\":" << (enabled ? "true" : "false")
+        << ",\"uptime_seconds\":" << uptimeSeconds
+        << ",\"documents\":" << documents
+        << ",\"bytes\":" << bytes
+        << ",\"documents_per_second\":" << documentsPerSecond()
+        << ",\"vocabulary_hit_rate\":" << vocabularyHitRate()
+        << ",\"cache_hits\":" << cacheHits
+        << ",\"cache_misses\":" << cacheMisses
+        << ",\"cache_hit_rate\":" << cacheHitRate()
+        << ",\"cache_entries\":" << cacheEntries
+        << ",\"cascade_checked\":" << cascadeChecked
+        << ",\"cascade_exits\":" << cascadeExits
+        << ",\"cascade_exit_rate\":" << cascadeExitRate()
+        << ",\"near_duplicates_checked\":" << nearDuplicatesChecked
+        << ",\"near_duplicates_reused\":" << nearDuplicatesReused
+        << ",\"near_duplicate_reuse_rate\":" << nearDuplicateReuseRate()
+        << ",\"model_loads\":" << modelLoads
+        << ",\"model_load_seconds\":" << modelLoadSeconds
+        << ",\"stages\":{";
+
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const StageStats& stats = stages[s];
+        if (s > 0) out << ",";
+        out << "\"" << stageName(static_cast<Stage>(s)) << "\":{"
+            << "\"documents\":" << stats.documents
+            << ",\"total_seconds\":" << toSeconds(stats.totalNanos)
+            << ",\"mean_us\":" << stats.meanMicros()
+            << ",\"p50_us\":" << stats.percentileMicros(0.50)
+            << ",\"p90_us\":" << stats.percentileMicros(0.90)
+            << ",\"p99_us\":" << stats.percentileMicros(0.99)
+            << ",\"max_us\":" << static_cast<double>(stats.maxNanos) * 1e-3
+            << "}";
+    }
+
+    out << "}}";
+    return out.str();
+}
+
+std::string AnalyzerStats::toPrometheus() const {
+    std::ostringstream out;
+    out.precision(9);
+
+    out << "# HELP blahajpi_stage_duration_seconds Per-document time spent in each analysis stage\n";
+    out << "# TYPE blahajpi_stage_duration_seconds histogram\n";
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const StageStats& stats = stages[s];
+        const char* name = stageName(static_cast<Stage>(s));
+
+        // Prometheus buckets are cumulative
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < LATENCY_BUCKETS.size(); ++i) {
+            cumulative += stats.buckets[i];
+            out << "blahajpi_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\""
+                << toSeconds(LATENCY_BUCKETS[i]) << "\"} " << cumulative << "\n";
+        }
+        out << "blahajpi_stage_duration_seconds_bucket{stage=\"" << name << "\",le=\"+Inf\"} "
+            << stats.documents << "\n";
+        out << "blahajpi_stage_duration_seconds_sum{stage=\"" << name << "\"} " << toSeconds(stats.totalNanos) << "\n";
+        out << "blahajpi_stage_duration_seconds_count{stage=\"" << name << "\"} " << stats.documents << "\n";
+    }
+
+    // Name, type, help and value of the scalar metrics
+    struct Metric {
+        const char* name;
+        const char* type;
+        const char* help;
+        double value;
+    };
+    const Metric metrics[] = {
+        {"blahajpi_documents_total", "counter", "Documents analyzed", static_cast<double>(documents)},
+        {"blahajpi_bytes_total", "counter", "Bytes of input text analyzed", static_cast<double>(bytes)},
+        {"blahajpi_vocabulary_terms_total", "counter", "Terms looked up in the vocabulary", static_cast<double>(termsSeen)},
+        {"blahajpi_vocabulary_hits_total", "counter", "Looked-up terms found in the vocabulary", static_cast<double>(termsMatched)},
+        {"blahajpi_cache_hits_total", "counter", "Documents answered from the result cache", static_cast<double>(cacheHits)},
+        {"blahajpi_cache_misses_total", "counter", "Result cache lookups that had to be scored", static_cast<double>(cacheMisses)},
+        {"blahajpi_cache_entries", "gauge", "Results currently cached", static_cast<double>(cacheEntries)},
+        {"blahajpi_cascade_checked_total", "counter", "Documents scored by the first cascade stage", static_cast<double>(cascadeChecked)},
+        {"blahajpi_cascade_exits_total", "counter", "Documents answered by the first cascade stage", static_cast<double>(cascadeExits)},
+        {"blahajpi_near_duplicates_checked_total", "counter", "Documents looked up in the near-duplicate index", static_cast<double>(nearDuplicatesChecked)},
+        {"blahajpi_near_duplicates_reused_total", "counter", "Documents answered with the result of a near duplicate", static_cast<double>(nearDuplicatesReused)},
+        {"blahajpi_model_loads_total", "counter", "Successful model loads", static_cast<double>(modelLoads)},
+        {"blahajpi_model_load_seconds", "gauge", "Duration of the most recent model load", modelLoadSeconds},
+        {"blahajpi_uptime_seconds", "gauge", "Time since the counters were reset", uptimeSeconds},
+        {"blahajpi_stats_enabled", "gauge", "Whether instrumentation was compiled in", enabled ? 1.0 : 0.0},
+    };
+    for (const auto& metric : metrics) {
+        out << "# HELP " << metric.name << " " << metric.help << "\n";
+        out << "# TYPE " << metric.name << " " << metric.type << "\n";
+        out << metric.name << " " << metric.value << "\n";
+    }
+
+    return out.str();
+}
+
+// ==========================================
+// StatsRecorder Implementation
+// ==========================================
+
+StatsRecorder::StatsRecorder() {
+    startNanos.store(now(), std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordStage(Stage stage, uint64_t nanos, uint64_t documents) {
+    if (documents == 0) {
+        return;
+    }
+
+    StageCounters& counters = stages[static_cast<size_t>(stage)];
+    uint64_t perDocument = nanos / documents;
+    counters.documents.fetch_add(documents, std::memory_order_relaxed);
+    counters.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+    counters.buckets[bucketIndex(perDocument)].fetch_add(documents, std::memory_order_relaxed);
+    updateMax(counters.maxNanos, perDocument);
+}
+
+void StatsRecorder::recordDocuments(uint64_t documents, uint64_t bytes) {
+    this->documents.fetch_add(documents, std::memory_order_relaxed);
+    this->bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordTerms(uint64_t seen, uint64_t matched) {
+    termsSeen.fetch_add(seen, std::memory_order_relaxed);
+    termsMatched.fetch_add(matched, std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordCache(uint64_t hits, uint64_t misses) {
+    cacheHits.fetch_add(hits, std::memory_order_relaxed);
+    cacheMisses.fetch_add(misses, std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordCascade(uint64_t checked, uint64_t exits) {
+    cascadeChecked.fetch_add(checked, std::memory_order_relaxed);
+    cascadeExits.fetch_add(exits, std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordNearDuplicates(uint64_t checked, uint64_t reused) {
+    nearDuplicatesChecked.fetch_add(checked, std::memory_order_relaxed);
+    nearDuplicatesReused.fetch_add(reused, std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordModelLoad(uint64_t nanos) {
+    modelLoads.fetch_add(1, std::memory_order_relaxed);
+    lastModelLoadNanos.store(nanos, std::memory_order_relaxed);
+}
+
+AnalyzerStats StatsRecorder::snapshot(bool enabled) const {
+    AnalyzerStats stats;
+    stats.enabled = enabled;
+    stats.uptimeSeconds = toSeconds(now() - startNanos.load(std::memory_order_relaxed));
+    stats.documents = documents.load(std::memory_order_relaxed);
+    stats.bytes = bytes.load(std::memory_order_relaxed);
+    stats.termsSeen = termsSeen.load(std::memory_order_relaxed);
+    stats.termsMatched = termsMatched.load(std::memory_order_relaxed);
+    stats.cacheHits = cacheHits.load(std::memory_order_relaxed);
+    stats.cacheMisses = cacheMisses.load(std::memory_order_relaxed);
+    stats.cascadeChecked = cascadeChecked.load(std::memory_order_relaxed);
+    stats.cascadeExits = cascadeExits.load(std::memory_order_relaxed);
+    stats.nearDuplicatesChecked = nearDuplicatesChecked.load(std::memory_order_relaxed);
+    stats.nearDuplicatesReused = nearDuplicatesReused.load(std::memory_order_relaxed);
+    stats.modelLoads = modelLoads.load(std::memory_order_relaxed);
+    stats.modelLoadSeconds = toSeconds(lastModelLoadNanos.load(std::memory_order_relaxed));
+
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const StageCounters& counters = stages[s];
+        StageStats& out = stats.stages[s];
+        out.documents = counters.documents.load(std::memory_order_relaxed);
+        out.totalNanos = counters.totalNanos.load(std::memory_order_relaxed);
+        out.maxNanos = counters.maxNanos.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < out.buckets.size(); ++i) {
+            out.buckets[i] = counters.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return stats;
+}
+
+void StatsRecorder::reset() {
+    for (auto& counters : stages) {
+        counters.documents.store(0, std::memory_order_relaxed);
+        counters.totalNanos.store(0, std::memory_order_relaxed);
+        counters.maxNanos.store(0, std::memory_order_relaxed);
+        for (auto& bucket : counters.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    documents.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    termsSeen.store(0, std::memory_order_relaxed);
+    termsMatched.store(0, std::memory_order_relaxed);
+    cacheHits.store(0, std::memory_order_relaxed);
+    cacheMisses.store(0, std::memory_order_relaxed);
+    cascadeChecked.store(0, std::memory_order_relaxed);
+    cascadeExits.store(0, std::memory_order_relaxed);
+    nearDuplicatesChecked.store(0, std::memory_order_relaxed);
+    nearDuplicatesReused.store(0, std::memory_order_relaxed);
+    startNanos.store(now(), std::memory_order_relaxed);
+}
+
+uint64_t StatsRecorder::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace utils
+} // namespace blahajpi
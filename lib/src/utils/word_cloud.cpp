@@ -4,6 +4,7 @@
  */
 
 #include "blahajpi/utils/word_cloud.hpp"
+#include "blahajpi/utils/parallel.hpp"
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -16,40 +17,98 @@
 namespace blahajpi {
 namespace utils {
 
-WordCloud::WordCloud() {
-    // Initialize common words
-    commonWords = {
-        "the", "and", "that", "have", "for", "not", "with", "you", "this", "but",
-        "his", "from", "they", "she", "will", "one", "all", "would", "there", "their",
-        "what", "out", "about", "who", "get", "which", "when", "make", "can", "like",
-        "time", "just", "him", "know", "take", "people", "into", "year", "your", "good",
-        "some", "could", "them", "see", "other", "than", "then", "now", "look", "only",
-        "come", "its", "over", "think", "also", "back", "after", "use", "two", "how",
-        "our", "work", "first", "well", "way", "even", "new", "want", "because", "any",
-        "these", "give", "day", "most", "say", "was", "been", "were", "being", "are"
-    };
+namespace {
+
+/// Common words filtered out of the cloud
+constexpr auto COMMON_WORDS = makeWordSet({
+    "the", "and", "that", "have", "for", "not", "with", "you", "this", "but",
+    "his", "from", "they", "she", "will", "one", "all", "would", "there", "their",
+    "what", "out", "about", "who", "get", "which", "when", "make", "can", "like",
+    "time", "just", "him", "know", "take", "people", "into", "year", "your", "good",
+    "some", "could", "them", "see", "other", "than", "then", "now", "look", "only",
+    "come", "its", "over", "think", "also", "back", "after", "use", "two", "how",
+    "our", "work", "first", "well", "way", "even", "new", "want", "because", "any",
+    "these", "give", "day", "most", "say", "was", "been", "were", "being", "are"
+});
+
+/// Words indicating harmful content
+constexpr auto HARMFUL_WORDS = makeWordSet({
+    "hate", "kill", "attack", "terrible", "disgusting", "wrong", "sick", "fake",
+    "evil", "disgusting", "abnormal", "mental", "illness", "disease", "disorder",
+    "freak", "weird", "confused", "delusional", "agenda", "indoctrinate", "recruit",
+    "mutilate", "dangerous", "threat", "groom", "predator", "pervert", "abomination",
+    "unnatural", "deviant", "ridiculous", "stupid", "insane", "crazy", "deny", "erase",
+    "harmful", "violence", "harass", "target", "ban", "illegal", "criminal", "immoral",
+    "sin", "degenerate", "destroy", "ideology", "propaganda", "brainwash", "push"
+});
+
+/// Words indicating safe content
+constexpr auto SAFE_WORDS = makeWordSet({
+    "support", "protect", "rights", "equal", "human", "dignity", "respect", "ally",
+    "affirm", "accept", "valid", "authentic", "real", "true", "health", "care",
+    "help", "safe", "protect", "community", "solidarity", "embrace", "celebrate",
+    "diverse", "diversity", "inclusion", "inclusive", "accept", "acceptance",
+    "understand", "understanding", "empathy", "compassion", "kind", "kindness",
+    "love", "identity", "expression", "self", "represent", "representation",
+    "visibility", "visible", "voice", "justice", "equality", "equity", "freedom"
+});
+
+/// Fewest texts worth counting on a thread of their own
+constexpr size_t MIN_SHARD_TEXTS = 512;
+
+/**
+ * @brief Checks for the separators std::istream word extraction skips
+ * @param c Character
+ * @return True for whitespace
+ */
+bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/**
+ * @brief Counts texts in contiguous shards across worker threads
+ * @tparam Item Element type of the input
+ * @tparam TextOf Callable returning a pointer to an item's text, or nullptr to skip it
+ * @param cloud Word cloud whose word lists weigh the words
+ * @param items Input items
+ * @param threads Worker threads
+ * @param capacity Entries kept per counter
+ * @param textOf Text accessor
+ * @return Merged counts
+ */
+template <typename Item, typename TextOf>
+WordCounter countShards(
+    const WordCloud& cloud,
+    std::span<const Item> items,
+    size_t threads,
+    size_t capacity,
+    TextOf textOf
+) {
+    size_t shards = std::clamp<size_t>(items.size() / MIN_SHARD_TEXTS, 1, std::max<size_t>(1, threads));
+    std::vector<WordCounter> counters(shards, WordCounter(capacity));
     
-    // Initialize words indicating harmful content
-    harmfulWords = {
-        "hate", "kill", "attack", "terrible", "disgusting", "wrong", "sick", "fake",
-        "evil", "disgusting", "abnormal", "mental", "illness", "disease", "disorder",
-        "freak", "weird", "confused", "delusional", "agenda", "indoctrinate", "recruit",
-        "mutilate", "dangerous", "threat", "groom", "predator", "pervert", "abomination",
-        "unnatural", "deviant", "ridiculous", "stupid", "insane", "crazy", "deny", "erase",
-        "harmful", "violence", "harass", "target", "ban", "illegal", "criminal", "immoral",
-        "sin", "degenerate", "destroy", "ideology", "propaganda", "brainwash", "push"
-    };
+    parallelFor(shards, shards, [&](size_t shard) {
+        size_t begin = items.size() * shard / shards;
+        size_t end = items.size() * (shard + 1) / shards;
+        for (size_t i = begin; i < end; ++i) {
+            if (const std::string* text = textOf(items[i])) {
+                cloud.countWords(*text, counters[shard]);
+            }
+        }
+    });
     
-    // Initialize words indicating safe content
-    safeWords = {
-        "support", "protect", "rights", "equal", "human", "dignity", "respect", "ally",
-        "affirm", "accept", "valid", "authentic", "real", "true", "health", "care",
-        "help", "safe", "protect", "community", "solidarity", "embrace", "celebrate",
-        "diverse", "diversity", "inclusion", "inclusive", "accept", "acceptance",
-        "understand", "understanding", "empathy", "compassion", "kind", "kindness",
-        "love", "identity", "expression", "self", "represent", "representation",
-        "visibility", "visible", "voice", "justice", "equality", "equity", "freedom"
-    };
+    for (size_t shard = 1; shard < shards; ++shard) {
+        counters[0].merge(counters[shard]);
+    }
+    return std::move(counters[0]);
+}
+
+} // namespace
+
+WordCloud::WordCloud()
+    : commonWords(COMMON_WORDS.view()),
+      harmfulWords(HARMFUL_WORDS.view()),
+      safeWords(SAFE_WORDS.view()) {
 }
 
 WordCloud::WordCloud(
@@ -83,18 +142,23 @@ std::string WordCloud::generateCustomCloud(
     const CloudConfig& config,
     bool isHarmful
 ) {
-    // Count word frequencies
-    auto wordFreqs = countWordFrequencies(std::span{texts});
-    
+    return generateCustomCloud(countWords(std::span{texts}), config, isHarmful);
+}
+
+std::string WordCloud::generateCustomCloud(
+    const WordCounter& counter,
+    const CloudConfig& config,
+    bool isHarmful
+) {
     // Get top words
-    auto topWords = getTopWords(wordFreqs, config.maxWords);
+    auto topWords = counter.top(config.maxWords);
     
     if (topWords.empty()) {
         return "No words found to create a word cloud.";
     }
     
     // Find the maximum frequency for scaling
-    int maxFreq = topWords[0].second;
+    int64_t maxFreq = topWords[0].second;
     
     // Prepare the output
     std::ostringstream cloud;
@@ -188,79 +252,48 @@ bool WordCloud::saveWordCloud(
     return true;
 }
 
-std::unordered_map<std::string, int> WordCloud::countWordFrequencies(
-    std::span<const std::string> texts
-) {
-    std::unordered_map<std::string, int> wordFreqs;
-    
-    // Process each text
-    for (const auto& text : texts) {
-        std::istringstream iss{text};
-        std::string word;
+void WordCloud::countWords(std::string_view text, WordCounter& counter) const {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        // Split on whitespace without copying the text
+        while (pos < text.size() && isSeparator(text[pos])) {
+            ++pos;
+        }
+        size_t start = pos;
+        while (pos < text.size() && !isSeparator(text[pos])) {
+            ++pos;
+        }
+        std::string_view word = text.substr(start, pos - start);
         
-        // Count each word
-        while (iss >> word) {
-            // Filter out very short words
-            if (word.length() < 3) {
-                continue;
-            }
-            
-            // Skip common words
-            if (commonWords.contains(word)) {
-                continue;
-            }
-            
-            // Check for word categories
-            if (harmfulWords.contains(word)) {
-                // Harmful words get extra weight
-                wordFreqs[word] += 3;
-            }
-            else if (safeWords.contains(word)) {
-                // Safe words get double weight
-                wordFreqs[word] += 2;
-            }
-            else {
-                // Regular words get normal weight
-                wordFreqs[word]++;
-            }
+        // Filter out very short words and common words
+        if (word.length() < 3 || commonWords.contains(word)) {
+            continue;
+        }
+        
+        // Harmful words get extra weight, safe words double weight
+        if (harmfulWords.contains(word)) {
+            counter.add(word, 3);
+        } else if (safeWords.contains(word)) {
+            counter.add(word, 2);
+        } else {
+            counter.add(word, 1);
         }
     }
-    
-    return wordFreqs;
 }
 
-std::vector<std::pair<std::string, int>> WordCloud::getTopWords(
-    const std::unordered_map<std::string, int>& wordFreqs, 
-    size_t maxWords
-) {
-    // Convert map to vector for sorting
-    std::vector<std::pair<std::string, int>> sortedWords;
-    sortedWords.reserve(wordFreqs.size());
-    
-    for (const auto& [word, freq] : wordFreqs) {
-        sortedWords.emplace_back(word, freq);
-    }
-    
-    // Sort by frequency (descending)
-    std::sort(
-        sortedWords.begin(), sortedWords.end(), 
-        [](const auto& a, const auto& b) {
-            return a.second > b.second;
-        }
-    );
-    
-    // Limit to maxWords
-    if (sortedWords.size() > maxWords) {
-        sortedWords.resize(maxWords);
-    }
-    
-    return sortedWords;
+WordCounter WordCloud::countWords(
+    std::span<const std::string> texts,
+    size_t threads,
+    size_t capacity
+) const {
+    return countShards(*this, texts, threads, capacity,
+                       [](const std::string& text) { return &text; });
 }
 
 std::string WordCloud::formatWord(
     const std::string& word, 
-    int freq, 
-    int maxFreq,
+    int64_t freq, 
+    int64_t maxFreq,
     bool isHarmful
 ) {
     std::ostringstream formatted;
@@ -299,8 +332,8 @@ std::string WordCloud::formatWord(
 }
 
 std::string WordCloud::getColorCode(
-    int freq, 
-    int maxFreq, 
+    int64_t freq, 
+    int64_t maxFreq, 
     bool isHarmful, 
     const std::string& word
 ) const {
@@ -359,5 +392,62 @@ std::string WordCloud::resetColor() {
     return "\033[0m";
 }
 
+CloudAggregator::CloudAggregator(
+    bool harmfulOnly,
+    size_t capacity,
+    size_t threads,
+    WordCloud cloud
+) : cloud(std::move(cloud)),
+    harmfulOnly(harmfulOnly),
+    threads(std::max<size_t>(1, threads)),
+    counts(capacity) {
+}
+
+void CloudAggregator::add(const AnalysisResult& result) {
+    add(std::span<const AnalysisResult>(&result, 1));
+}
+
+void CloudAggregator::add(std::span<const AnalysisResult> results) {
+    size_t counted = 0;
+    for (const auto& result : results) {
+        if (!harmfulOnly || result.sentiment == "Harmful") {
+            ++counted;
+        }
+    }
+    if (counted == 0) {
+        return;
+    }
+    
+    // Count outside the lock; only the merge is serialized
+    WordCounter batch = countShards(cloud, results, threads, counts.getCapacity(),
+        [this](const AnalysisResult& result) -> const std::string* {
+            return !harmfulOnly || result.sentiment == "Harmful" ? &result.cleanedText : nullptr;
+        });
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    counts.merge(batch);
+    textCount += counted;
+}
+
+size_t CloudAggregator::getTextCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return textCount;
+}
+
+WordCounter CloudAggregator::getCounts() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counts;
+}
+
+std::string CloudAggregator::render(const CloudConfig& config) {
+    return cloud.generateCustomCloud(getCounts(), config, harmfulOnly);
+}
+
+void CloudAggregator::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    counts.clear();
+    textCount = 0;
+}
+
 } // namespace utils
 } // namespace blahajpi
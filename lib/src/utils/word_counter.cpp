@@ -0,0 +1,95 @@
+/**
+ * @file word_counter.cpp
+ * @brief Implementation of the mergeable word frequency table
+ */
+
+#include "blahajpi/utils/word_counter.hpp"
+#include <algorithm>
+
+namespace blahajpi {
+namespace utils {
+
+WordCounter::WordCounter(size_t capacity) : capacity(capacity) {}
+
+void WordCounter::add(std::string_view word, int64_t weight) {
+    if (weight <= 0) {
+        return;
+    }
+    totalWeight += weight;
+
+    auto it = counts.find(word);
+    if (it != counts.end()) {
+        it->second += weight;
+        return;
+    }
+    counts.emplace(word, weight);
+    prune();
+}
+
+void WordCounter::merge(const WordCounter& other) {
+    totalWeight += other.totalWeight;
+    for (const auto& [word, weight] : other.counts) {
+        auto it = counts.find(std::string_view(word));
+        if (it != counts.end()) {
+            it->second += weight;
+        } else {
+            counts.emplace(word, weight);
+            prune();
+        }
+    }
+}
+
+std::vector<std::pair<std::string, int64_t>> WordCounter::top(size_t maxWords) const {
+    // Rank pointers into the table; only the kept words are copied
+    std::vector<const std::pair<const std::string, int64_t>*> entries;
+    entries.reserve(counts.size());
+    for (const auto& entry : counts) {
+        entries.push_back(&entry);
+    }
+
+    size_t kept = std::min(maxWords, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + kept, entries.end(),
+                      [](const auto* a, const auto* b) {
+                          return a->second != b->second ? a->second > b->second : a->first < b->first;
+                      });
+
+    std::vector<std::pair<std::string, int64_t>> words;
+    words.reserve(kept);
+    for (size_t i = 0; i < kept; ++i) {
+        words.emplace_back(entries[i]->first, entries[i]->second);
+    }
+    return words;
+}
+
+int64_t WordCounter::count(std::string_view word) const {
+    auto it = counts.find(word);
+    return it != counts.end() ? it->second : 0;
+}
+
+void WordCounter::clear() {
+    counts.clear();
+    totalWeight = 0;
+}
+
+void WordCounter::prune() {
+    if (capacity == 0 || counts.size() < 2 * capacity) {
+        return;
+    }
+
+    // At least capacity + 1 entries lose the full cut, which bounds the error per word
+    std::vector<int64_t> weights;
+    weights.reserve(counts.size());
+    for (const auto& entry : counts) {
+        weights.push_back(entry.second);
+    }
+    std::nth_element(weights.begin(), weights.begin() + capacity, weights.end(), std::greater<>());
+    int64_t cut = weights[capacity];
+
+    for (auto it = counts.begin(); it != counts.end();) {
+        it->second -= cut;
+        it = it->second > 0 ? std::next(it) : counts.erase(it);
+    }
+}
+
+} // namespace utils
+} // namespace blahajpi
@@ -12,7 +12,10 @@
 
 #include "blahajpi/analyzer.hpp"
 #include <gtest/gtest.h>
+#include <atomic>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <filesystem>
 #include <fstream>
@@ -321,6 +324,750 @@ TEST_F(AnalyzerTest, BatchAnalysis) {
     EXPECT_TRUE(emptyResults.empty());
 }
 
+/**
+ * @test
+ * @brief Tests parallel batch analysis
+ * 
+ * Verifies that scoring a batch across several worker threads returns
+ * results in input order that match individual analysis.
+ */
+TEST_F(AnalyzerTest, ParallelBatchMatchesSequential) {
+    ASSERT_TRUE(trainTestModel());
+    defaultAnalyzer->setConfig("model-dir", modelDir.string());
+    defaultAnalyzer->setConfig("threads", "4");
+    
+    std::vector<std::string> texts;
+    for (int i = 0; i < 100; ++i) {
+        texts.push_back(i % 2 == 0
+            ? "This has offensive language number " + std::to_string(i)
+            : "Just a regular post about everyday life " + std::to_string(i));
+    }
+    
+    auto results = defaultAnalyzer->analyzeMultiple(texts);
+    ASSERT_EQ(results.size(), texts.size());
+    
+    for (size_t i = 0; i < texts.size(); ++i) {
+        auto single = defaultAnalyzer->analyze(texts[i]);
+        EXPECT_EQ(results[i].text, texts[i]);
+        EXPECT_EQ(results[i].cleanedText, single.cleanedText);
+        EXPECT_DOUBLE_EQ(results[i].harmScore, single.harmScore);
+        EXPECT_EQ(results[i].sentiment, single.sentiment);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests the instrumentation counters
+ * 
+ * Verifies that analysis records documents, bytes and every stage, and
+ * that resetting clears the counters but keeps the model load time.
+ */
+TEST_F(AnalyzerTest, CollectsStats) {
+    ASSERT_TRUE(trainTestModel());
+    ASSERT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    defaultAnalyzer->resetStats();
+    
+    std::vector<std::string> texts = {"First example text", "Second example text", "Third one"};
+    defaultAnalyzer->analyzeMultiple(texts);
+    defaultAnalyzer->analyze("One more text");
+    
+    auto stats = defaultAnalyzer->getStats();
+    if (!stats.enabled) {
+        GTEST_SKIP() << "Built with ENABLE_STATS=OFF";
+    }
+    
+    EXPECT_EQ(stats.documents, 4u);
+    EXPECT_EQ(stats.bytes, 18u + 19u + 9u + 13u);
+    EXPECT_EQ(stats.modelLoads, 1u);
+    EXPECT_GT(stats.termsSeen, 0u);
+    EXPECT_LE(stats.termsMatched, stats.termsSeen);
+    EXPECT_EQ(stats.stage(blahajpi::utils::Stage::Preprocess).documents, 4u);
+    EXPECT_EQ(stats.stage(blahajpi::utils::Stage::Score).documents, 4u);
+    EXPECT_EQ(stats.stage(blahajpi::utils::Stage::Explanation).documents, 4u);
+    EXPECT_NE(stats.toJson().find("\"documents\":4"), std::string::npos);
+    
+    defaultAnalyzer->resetStats();
+    stats = defaultAnalyzer->getStats();
+    EXPECT_EQ(stats.documents, 0u);
+    EXPECT_EQ(stats.stage(blahajpi::utils::Stage::Preprocess).documents, 0u);
+    EXPECT_EQ(stats.modelLoads, 1u);
+}
+
+/**
+ * @test
+ * @brief Tests reloading the model while other threads analyze
+ * 
+ * Verifies that analyses running during repeated reloads all succeed with
+ * consistent scores, that each reload publishes a new model version, and
+ * that a failed reload keeps the current model.
+ */
+TEST_F(AnalyzerTest, HotReloadWhileAnalyzing) {
+    ASSERT_TRUE(trainTestModel());
+    ASSERT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    uint64_t version = defaultAnalyzer->getModelVersion();
+    EXPECT_GT(version, 0u);
+    
+    const std::vector<std::string> texts = {
+        "This has offensive language that should be flagged.",
+        "Just a regular post about everyday life."
+    };
+    auto expected = defaultAnalyzer->analyzeMultiple(texts);
+    
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> failures{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&]() {
+            while (!stop.load()) {
+                try {
+                    auto results = defaultAnalyzer->analyzeMultiple(texts);
+                    if (results[0].harmScore != expected[0].harmScore ||
+                        results[1].harmScore != expected[1].harmScore) {
+                        ++failures;
+                    }
+                } catch (const std::exception&) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    
+    const int reloads = 10;
+    for (int i = 0; i < reloads; ++i) {
+        EXPECT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    }
+    EXPECT_FALSE(defaultAnalyzer->loadModel("non_existent_directory"));
+    
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(defaultAnalyzer->getModelVersion(), version + reloads);
+    EXPECT_DOUBLE_EQ(defaultAnalyzer->analyze(texts[0]).harmScore, expected[0].harmScore);
+}
+
+/**
+ * @test
+ * @brief Tests selecting the sparse neural network through the configuration
+ * 
+ * Verifies that model-type = mlp trains a network, that a fresh analyzer
+ * recognizes it when loading, and that float32 scoring stays close.
+ */
+TEST_F(AnalyzerTest, NeuralNetworkModelType) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "mlp");
+    analyzer.setConfig("hidden-size", "8");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    
+    const std::vector<std::string> texts = {
+        "This has offensive language that should be flagged.",
+        "Just a regular post about everyday life."
+    };
+    auto expected = analyzer.analyzeMultiple(texts);
+    
+    // The model file identifies the network even with the default model-type
+    ASSERT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    auto loaded = defaultAnalyzer->analyzeMultiple(texts);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_DOUBLE_EQ(loaded[i].harmScore, expected[i].harmScore);
+    }
+    
+    defaultAnalyzer->setConfig("nn-float32", "true");
+    ASSERT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    auto single = defaultAnalyzer->analyzeMultiple(texts);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_NEAR(single[i].harmScore, expected[i].harmScore, 1e-4);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests cross-validated tuning
+ * 
+ * Verifies that every grid setting is reported with metrics, best macro
+ * F1 first, and that tuning leaves the model and configuration alone.
+ */
+TEST_F(AnalyzerTest, Tuning) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("cv-folds", "3");
+    uint64_t version = analyzer.getModelVersion();
+    
+    blahajpi::TuningGrid grid;
+    grid.alphas = {0.0001, 0.001};
+    grid.eta0s = {0.01, 0.1};
+    auto results = analyzer.tune(dataPath.string(), grid);
+    
+    ASSERT_EQ(results.size(), 4u);
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].epochs, 5);
+        ASSERT_TRUE(results[i].metrics.count("accuracy"));
+        EXPECT_GE(results[i].metrics.at("accuracy"), 0.0);
+        EXPECT_LE(results[i].metrics.at("accuracy"), 1.0);
+        EXPECT_GE(results[i].accuracyStdDev, 0.0);
+        if (i > 0) {
+            EXPECT_GE(results[i - 1].metrics.at("macro_f1"), results[i].metrics.at("macro_f1"));
+        }
+    }
+    
+    EXPECT_EQ(analyzer.getModelVersion(), version);
+    EXPECT_EQ(analyzer.getConfig()["alpha"], "0.0001");
+    
+    // More folds than samples cannot be split
+    analyzer.setConfig("cv-folds", "10");
+    EXPECT_TRUE(analyzer.tune(dataPath.string(), grid).empty());
+    EXPECT_TRUE(analyzer.tune("non_existent_file.csv", grid).empty());
+}
+
+/**
+ * @test
+ * @brief Tests reusing cached training features
+ * 
+ * Verifies that a second training run with the same dataset and feature
+ * settings reads the cache and trains the same model, and that changing
+ * a feature setting creates a new entry.
+ */
+TEST_F(AnalyzerTest, FeatureCacheReuse) {
+    std::filesystem::path cacheDir = tempDir / "feature_cache";
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    analyzer.setConfig("feature-cache-dir", cacheDir.string());
+    
+    const std::string text = "This has offensive language that should be flagged.";
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    double first = analyzer.analyze(text).harmScore;
+    
+    auto countEntries = [&cacheDir] {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(cacheDir)) {
+            count += entry.path().extension() == ".bpf" ? 1 : 0;
+        }
+        return count;
+    };
+    ASSERT_EQ(countEntries(), 1u);
+    
+    // Model settings are not part of the key
+    analyzer.setConfig("epochs", "5");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    EXPECT_NEAR(analyzer.analyze(text).harmScore, first, 1e-12);
+    EXPECT_EQ(countEntries(), 1u);
+    
+    analyzer.setConfig("max-ngram", "1");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    EXPECT_EQ(countEntries(), 2u);
+}
+
+/**
+ * @test
+ * @brief Tests incremental updates of the live model
+ * 
+ * Verifies that labeled feedback moves the scores of a linear model,
+ * publishes a new model version, and survives saving and loading.
+ */
+TEST_F(AnalyzerTest, IncrementalUpdate) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    
+    const std::string text = "This has offensive language that should be flagged.";
+    double before = analyzer.analyze(text).harmScore;
+    uint64_t version = analyzer.getModelVersion();
+    
+    // Reviewers keep marking the text as safe
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(analyzer.update({text, text}, {0, 0}));
+    }
+    double after = analyzer.analyze(text).harmScore;
+    EXPECT_LT(after, before);
+    EXPECT_EQ(analyzer.getModelVersion(), version + 20);
+    
+    std::filesystem::path updatedDir = tempDir / "updated";
+    ASSERT_TRUE(analyzer.saveModel(updatedDir.string()));
+    blahajpi::Analyzer reloaded(configPath.string());
+    ASSERT_TRUE(reloaded.loadModel(updatedDir.string()));
+    EXPECT_NEAR(reloaded.analyze(text).harmScore, after, 1e-9);
+    
+    EXPECT_THROW(analyzer.update({text}, {0, 4}), std::invalid_argument);
+    
+    // Models trained on dense rows cannot be updated in place
+    ASSERT_TRUE(trainTestModel());
+    ASSERT_TRUE(defaultAnalyzer->loadModel(modelDir.string()));
+    EXPECT_FALSE(defaultAnalyzer->update({text}, {0}));
+}
+
+/**
+ * @test
+ * @brief Tests the result cache for repeated messages
+ * 
+ * Verifies that texts with the same cleaned form are answered from the
+ * cache with their own raw text, that hits and misses are counted, and
+ * that publishing a new model empties the cache.
+ */
+TEST_F(AnalyzerTest, ResultCache) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    
+    const std::string text = "This has offensive language that should be flagged.";
+    const std::string variant = "THIS has offensive language that should be flagged!!!";
+    auto uncached = analyzer.analyze(text);
+    
+    analyzer.setConfig("result-cache-size", "100");
+    analyzer.resetStats();
+    auto first = analyzer.analyze(text);
+    auto second = analyzer.analyze(variant);
+    ASSERT_EQ(first.cleanedText, second.cleanedText);
+    EXPECT_EQ(second.text, variant);
+    EXPECT_DOUBLE_EQ(first.harmScore, uncached.harmScore);
+    EXPECT_DOUBLE_EQ(second.harmScore, first.harmScore);
+    EXPECT_EQ(second.keyTerms, first.keyTerms);
+    EXPECT_EQ(second.explanation, first.explanation);
+    
+    // Duplicates within one batch match the uncached results
+    std::vector<std::string> batch = {text, "A friendly message", variant, "A friendly message"};
+    auto results = analyzer.analyzeMultiple(batch);
+    ASSERT_EQ(results.size(), batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(results[i].text, batch[i]);
+    }
+    EXPECT_DOUBLE_EQ(results[2].harmScore, uncached.harmScore);
+    EXPECT_EQ(results[1].harmScore, results[3].harmScore);
+    
+    auto stats = analyzer.getStats();
+    if (stats.enabled) {
+        EXPECT_EQ(stats.cacheHits + stats.cacheMisses, 6u);
+        EXPECT_GE(stats.cacheHits, 3u);
+        EXPECT_GT(stats.cacheEntries, 0u);
+        EXPECT_NE(stats.toJson().find("\"cache_hits\":"), std::string::npos);
+    }
+    
+    // A new model version must not serve results of the old one
+    ASSERT_TRUE(analyzer.update({text, text, text}, {0, 0, 0}));
+    EXPECT_NE(analyzer.analyze(text).harmScore, first.harmScore);
+}
+
+/**
+ * @test
+ * @brief Tests choosing which result parts are filled in
+ *
+ * Verifies that scores do not depend on the requested fields, that parts
+ * left out stay empty and are left out of serialized forms, and that a
+ * cached reduced result does not answer a request for more fields.
+ */
+TEST_F(AnalyzerTest, ResultFields) {
+    using blahajpi::AnalysisResult;
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    analyzer.setConfig("result-cache-size", "100");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+
+    const std::string text = "This has offensive language that should be flagged.";
+    auto scoresOnly = analyzer.analyze(text, AnalysisResult::SCORES_ONLY);
+    EXPECT_EQ(scoresOnly.fields, AnalysisResult::SCORES_ONLY);
+    EXPECT_TRUE(scoresOnly.text.empty());
+    EXPECT_TRUE(scoresOnly.cleanedText.empty());
+    EXPECT_TRUE(scoresOnly.keyTerms.empty());
+    EXPECT_TRUE(scoresOnly.explanation.empty());
+
+    auto full = analyzer.analyze(text);
+    EXPECT_EQ(full.fields, AnalysisResult::ALL_FIELDS);
+    EXPECT_EQ(full.text, text);
+    EXPECT_FALSE(full.cleanedText.empty());
+    EXPECT_FALSE(full.explanation.empty());
+    EXPECT_EQ(full.sentiment, scoresOnly.sentiment);
+    EXPECT_DOUBLE_EQ(full.harmScore, scoresOnly.harmScore);
+    EXPECT_DOUBLE_EQ(full.confidence, scoresOnly.confidence);
+    EXPECT_EQ(full.makeExplanation(), full.explanation);
+
+    auto explained = analyzer.analyzeMultiple({text}, AnalysisResult::EXPLANATION);
+    ASSERT_EQ(explained.size(), 1u);
+    EXPECT_EQ(explained[0].explanation, full.explanation);
+    EXPECT_TRUE(explained[0].keyTerms.empty());
+    EXPECT_TRUE(explained[0].text.empty());
+
+    std::string json;
+    scoresOnly.appendJson(json, "7");
+    EXPECT_EQ(json.find("\"id\":7,"), 1u);
+    EXPECT_NE(json.find("\"harm_score\":"), std::string::npos);
+    EXPECT_EQ(json.find("\"explanation\""), std::string::npos);
+    EXPECT_EQ(json.find("\"key_terms\""), std::string::npos);
+    json.clear();
+    full.appendJson(json);
+    EXPECT_NE(json.find("\"explanation\":"), std::string::npos);
+    EXPECT_NE(json.find("\"key_terms\":["), std::string::npos);
+
+    auto map = scoresOnly.toMap();
+    EXPECT_EQ(map.count("text"), 0u);
+    EXPECT_EQ(map.count("explanation"), 0u);
+    EXPECT_EQ(AnalysisResult::fromMap(map).fields, AnalysisResult::SCORES_ONLY);
+}
+
+/**
+ * @test
+ * @brief Tests dropping low-weight features from a trained model
+ *
+ * Verifies that compaction shrinks the vocabulary and the bundle, that
+ * the saved model scores like the published one, that training applies
+ * compact-threshold, and that hashed features are refused.
+ */
+TEST_F(AnalyzerTest, Compaction) {
+    auto vocabularySize = [](const std::filesystem::path& dir) {
+        std::ifstream info(dir / "model_info.txt");
+        std::string line;
+        while (std::getline(info, line)) {
+            auto pos = line.find("vocabulary size: ");
+            if (pos != std::string::npos) {
+                return std::stoul(line.substr(pos + 17));
+            }
+        }
+        return 0ul;
+    };
+    
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    size_t original = vocabularySize(modelDir);
+    ASSERT_GT(original, 0u);
+    
+    // Nothing weighs less than 0, so the model stays as it is
+    std::filesystem::path compactDir = tempDir / "compact_model";
+    uint64_t version = analyzer.getModelVersion();
+    EXPECT_FALSE(analyzer.compactModel(compactDir.string(), 0.0));
+    EXPECT_FALSE(analyzer.compactModel(compactDir.string(), 0.0, dataPath.string()));
+    EXPECT_EQ(analyzer.getModelVersion(), version);
+    EXPECT_FALSE(std::filesystem::exists(compactDir));
+    
+    ASSERT_TRUE(analyzer.compactModel(compactDir.string(), 0.01, dataPath.string()));
+    size_t compacted = vocabularySize(compactDir);
+    EXPECT_LT(compacted, original);
+    EXPECT_GT(compacted, 0u);
+    EXPECT_LT(std::filesystem::file_size(compactDir / "model.bpi"), std::filesystem::file_size(modelDir / "model.bpi"));
+    
+    const std::string text = "This has offensive language that should be flagged.";
+    blahajpi::Analyzer reloaded(configPath.string());
+    ASSERT_TRUE(reloaded.loadModel(compactDir.string()));
+    EXPECT_DOUBLE_EQ(reloaded.analyze(text).harmScore, analyzer.analyze(text).harmScore);
+    
+    // Training compacts before saving
+    std::filesystem::path trainedDir = tempDir / "trained_compact";
+    analyzer.setConfig("compact-threshold", "0.01");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), trainedDir.string()));
+    EXPECT_EQ(vocabularySize(trainedDir), compacted);
+    
+    // Hashed features have no vocabulary to prune
+    analyzer.setConfig("compact-threshold", "0");
+    analyzer.setConfig("vectorizer", "hashing");
+    analyzer.setConfig("hash-bits", "10");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), (tempDir / "hashed").string()));
+    EXPECT_FALSE(analyzer.compactModel(compactDir.string(), 0.01));
+}
+
+/**
+ * @test
+ * @brief Tests the two-stage model cascade
+ *
+ * Verifies that texts inside the uncertainty band get the full model's
+ * results, that texts outside it keep the first stage's results, that the
+ * exits are counted, and that a missing first-stage model turns the
+ * cascade off.
+ */
+TEST_F(AnalyzerTest, Cascade) {
+    std::filesystem::path fastDir = tempDir / "fast_model";
+    blahajpi::Analyzer fast(configPath.string());
+    fast.setConfig("model-type", "linear");
+    fast.setConfig("max-ngram", "1");
+    ASSERT_TRUE(fast.trainModel(dataPath.string(), fastDir.string()));
+    
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    
+    std::vector<std::string> texts = {
+        "This has offensive language that should be flagged.",
+        "A friendly message about the weather",
+        "I hate you and everything you stand for",
+        "Thanks for the help yesterday"
+    };
+    auto full = analyzer.analyzeMultiple(texts);
+    auto firstStage = fast.analyzeMultiple(texts);
+    
+    // Nothing is certain enough to exit
+    analyzer.setConfig("cascade-low", "0");
+    analyzer.setConfig("cascade-high", "1");
+    analyzer.setConfig("cascade-model-dir", fastDir.string());
+    analyzer.resetStats();
+    auto results = analyzer.analyzeMultiple(texts);
+    ASSERT_EQ(results.size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_DOUBLE_EQ(results[i].harmScore, full[i].harmScore);
+        EXPECT_EQ(results[i].keyTerms, full[i].keyTerms);
+    }
+    auto stats = analyzer.getStats();
+    if (stats.enabled) {
+        EXPECT_EQ(stats.cascadeChecked, texts.size());
+        EXPECT_EQ(stats.cascadeExits, 0u);
+        EXPECT_NE(stats.toJson().find("\"cascade_exit_rate\":"), std::string::npos);
+    }
+    
+    // Everything exits after the first stage
+    analyzer.setConfig("cascade-low", "0.5");
+    analyzer.setConfig("cascade-high", "0.5");
+    analyzer.resetStats();
+    results = analyzer.analyzeMultiple(texts);
+    ASSERT_EQ(results.size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_DOUBLE_EQ(results[i].harmScore, firstStage[i].harmScore);
+        EXPECT_EQ(results[i].text, texts[i]);
+        EXPECT_EQ(results[i].explanation, firstStage[i].explanation);
+    }
+    stats = analyzer.getStats();
+    if (stats.enabled) {
+        EXPECT_EQ(stats.cascadeExits, texts.size());
+        EXPECT_DOUBLE_EQ(stats.cascadeExitRate(), 1.0);
+    }
+    
+    // A first stage that cannot be loaded leaves the full model alone
+    analyzer.setConfig("cascade-model-dir", (tempDir / "missing").string());
+    analyzer.resetStats();
+    EXPECT_DOUBLE_EQ(analyzer.analyze(texts[0]).harmScore, full[0].harmScore);
+    EXPECT_EQ(analyzer.getStats().cascadeChecked, 0u);
+}
+
+/**
+ * @test
+ * @brief Tests near-duplicate clustering
+ *
+ * Verifies that lightly edited copies of a message share a cluster and
+ * the result of the first copy, keep their own texts, are answered from
+ * the index in later calls, and are counted; texts too short to cluster
+ * are scored on their own.
+ */
+TEST_F(AnalyzerTest, NearDuplicates) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    
+    const std::string message = "Everyone should report this account because these people spread "
+                                "offensive language about groups every single day";
+    std::vector<std::string> texts = {
+        message,
+        "everyone should report this account because those people spread offensive language about groups every single day",
+        "Everyone must report this account because these people spread offensive language about groups every single day",
+        message + " #campaign",
+        "A friendly message about the weather and the lovely garden flowers blooming this spring morning",
+        "Short text"
+    };
+    auto unclustered = analyzer.analyzeMultiple(texts);
+    EXPECT_EQ(unclustered[0].cluster, 0u);
+    
+    analyzer.setConfig("near-duplicates", "true");
+    analyzer.resetStats();
+    auto results = analyzer.analyzeMultiple(texts);
+    ASSERT_EQ(results.size(), texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_EQ(results[i].text, texts[i]);
+        EXPECT_EQ(results[i].cleanedText, unclustered[i].cleanedText);
+    }
+    ASSERT_NE(results[0].cluster, 0u);
+    for (size_t i = 1; i < 4; ++i) {
+        EXPECT_EQ(results[i].cluster, results[0].cluster);
+        EXPECT_DOUBLE_EQ(results[i].harmScore, unclustered[0].harmScore);
+        EXPECT_EQ(results[i].explanation, unclustered[0].explanation);
+    }
+    EXPECT_NE(results[4].cluster, 0u);
+    EXPECT_NE(results[4].cluster, results[0].cluster);
+    EXPECT_DOUBLE_EQ(results[4].harmScore, unclustered[4].harmScore);
+    EXPECT_EQ(results[5].cluster, 0u);
+    EXPECT_DOUBLE_EQ(results[5].harmScore, unclustered[5].harmScore);
+    
+    auto stats = analyzer.getStats();
+    if (stats.enabled) {
+        EXPECT_EQ(stats.nearDuplicatesChecked, 5u);
+        EXPECT_EQ(stats.nearDuplicatesReused, 3u);
+    }
+    
+    // Later copies are answered from the index
+    auto later = analyzer.analyze(message + " today");
+    EXPECT_EQ(later.cluster, results[0].cluster);
+    EXPECT_EQ(later.text, message + " today");
+    EXPECT_EQ(later.toMap()["cluster"], blahajpi::AnalysisResult::formatCluster(later.cluster));
+    std::string json;
+    later.appendJson(json);
+    EXPECT_NE(json.find("\"cluster\":\"" + later.toMap()["cluster"] + "\""), std::string::npos);
+    
+    auto clusters = analyzer.getNearDuplicateClusters();
+    ASSERT_EQ(clusters.size(), 1u);
+    EXPECT_EQ(clusters[0].first, results[0].cluster);
+    EXPECT_EQ(clusters[0].second, 5u);
+    
+    // Clusters start over with the settings
+    analyzer.setConfig("near-duplicate-similarity", "0.9");
+    EXPECT_TRUE(analyzer.getNearDuplicateClusters().empty());
+}
+
+/**
+ * @test
+ * @brief Tests near duplicates first seen by a call asking for scores only
+ *
+ * Verifies that a fuller call on copies of a message whose cluster was
+ * started by scoreBatch() scores one copy for the whole chunk, and that
+ * its result replaces the scores-only one so later fuller calls are
+ * answered from the index.
+ */
+TEST_F(AnalyzerTest, NearDuplicatesUpgradeLeanerResults) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    analyzer.setConfig({{"threads", "1"}, {"near-duplicates", "true"}});
+
+    const std::string message = "Everyone should report this account because these people spread "
+                                "offensive language about groups every single day";
+    std::vector<std::string> texts = {
+        message,
+        "everyone should report this account because those people spread offensive language about groups every single day",
+        "Everyone must report this account because these people spread offensive language about groups every single day",
+        message + " #campaign"
+    };
+    std::vector<std::string_view> views(texts.begin(), texts.end());
+    std::vector<double> scores(views.size());
+    analyzer.scoreBatch(views, scores);
+
+    analyzer.resetStats();
+    auto results = analyzer.analyzeMultiple(texts, blahajpi::AnalysisResult::EXPLANATION);
+    ASSERT_EQ(results.size(), texts.size());
+    ASSERT_NE(results[0].cluster, 0u);
+    EXPECT_FALSE(results[0].explanation.empty());
+    for (size_t i = 1; i < texts.size(); ++i) {
+        EXPECT_EQ(results[i].cluster, results[0].cluster);
+        EXPECT_EQ(results[i].explanation, results[0].explanation);
+    }
+
+    auto later = analyzer.analyzeMultiple({message + " today"}, blahajpi::AnalysisResult::EXPLANATION);
+    EXPECT_EQ(later[0].cluster, results[0].cluster);
+    EXPECT_EQ(later[0].explanation, results[0].explanation);
+
+    auto stats = analyzer.getStats();
+    if (stats.enabled) {
+        EXPECT_EQ(stats.stage(blahajpi::utils::Stage::Score).documents, 1u);
+        EXPECT_EQ(stats.nearDuplicatesReused, texts.size());
+    }
+    auto clusters = analyzer.getNearDuplicateClusters();
+    ASSERT_EQ(clusters.size(), 1u);
+    EXPECT_EQ(clusters[0].second, 2 * texts.size() + 1);
+}
+
+/**
+ * @test
+ * @brief Tests scoring texts held in caller-owned memory
+ * 
+ * Verifies that scoreBatch() writes the same scores as analyzeMultiple()
+ * into the caller's arrays and rejects arrays of the wrong size.
+ */
+TEST_F(AnalyzerTest, ScoreBatch) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    
+    const std::string buffer = "This has offensive language about groupsJust a regular post about life";
+    std::vector<std::string_view> views = {
+        std::string_view(buffer).substr(0, 40),
+        std::string_view(buffer).substr(40),
+        std::string_view()
+    };
+    std::vector<double> scores(views.size());
+    EXPECT_THROW(analyzer.scoreBatch(views, scores), std::runtime_error);
+    
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    std::vector<double> probabilities(views.size());
+    analyzer.scoreBatch(views, scores, probabilities);
+    
+    auto expected = analyzer.analyzeMultiple(
+        {std::string(views[0]), std::string(views[1]), std::string(views[2])},
+        blahajpi::AnalysisResult::SCORES_ONLY);
+    for (size_t i = 0; i < views.size(); ++i) {
+        EXPECT_DOUBLE_EQ(scores[i], expected[i].harmScore);
+        EXPECT_DOUBLE_EQ(probabilities[i], expected[i].confidence);
+    }
+    
+    // Outputs may be left out, but not be the wrong size
+    std::vector<double> onlyProbabilities(views.size());
+    analyzer.scoreBatch(views, {}, onlyProbabilities);
+    EXPECT_EQ(onlyProbabilities, probabilities);
+    std::vector<double> tooShort(1);
+    EXPECT_THROW(analyzer.scoreBatch(views, tooShort), std::invalid_argument);
+    analyzer.scoreBatch({}, {});
+}
+
+/**
+ * @test
+ * @brief Tests that scoreBatch() keeps nothing of earlier texts
+ * 
+ * Scores a text that starts a near-duplicate cluster and then a text too
+ * short to join one on the same thread, and verifies that the short text
+ * is neither cached nor counted with the earlier cluster.
+ */
+TEST_F(AnalyzerTest, ScoreBatchResetsReusedResults) {
+    blahajpi::Analyzer analyzer(configPath.string());
+    analyzer.setConfig("model-type", "linear");
+    ASSERT_TRUE(analyzer.trainModel(dataPath.string(), modelDir.string()));
+    analyzer.setConfig({{"threads", "1"}, {"near-duplicates", "true"}, {"result-cache-size", "100"}});
+    
+    std::vector<std::string_view> longText = {
+        "Everyone should report this account because these people spread offensive language every day"
+    };
+    std::vector<std::string_view> shortText = {"Short text"};
+    std::vector<double> scores(1);
+    analyzer.scoreBatch(longText, scores);
+    analyzer.scoreBatch(shortText, scores);
+    
+    EXPECT_EQ(analyzer.analyze(std::string(shortText[0])).cluster, 0u);
+    EXPECT_TRUE(analyzer.getNearDuplicateClusters().empty());
+}
+
+/**
+ * @test
+ * @brief Tests that configuration changes reload the model only when needed
+ * 
+ * Verifies that training settings and serving settings leave the loaded
+ * model in place, while a new model-dir or a setting read while loading
+ * reloads it once, also when set together with other keys.
+ */
+TEST_F(AnalyzerTest, ConfigChangesReloadOnlyWhenNeeded) {
+    blahajpi::Analyzer trainer(configPath.string());
+    trainer.setConfig("model-type", "linear");
+    ASSERT_TRUE(trainer.trainModel(dataPath.string(), modelDir.string()));
+    
+    blahajpi::Analyzer analyzer;
+    analyzer.setConfig({{"model-type", "linear"}, {"model-dir", modelDir.string()}});
+    uint64_t version = analyzer.getModelVersion();
+    ASSERT_GT(version, 0u);
+    
+    const std::string text = "This has OFFENSIVE language about groups";
+    auto before = analyzer.analyze(text);
+    analyzer.setConfig("alpha", "0.01");
+    analyzer.setConfig("epochs", "3");
+    analyzer.setConfig("threads", "2");
+    analyzer.setConfig("model-type", "linear");
+    analyzer.setConfig({{"label-column", "label"}, {"text-column", "text"}, {"max-features", "50"}});
+    EXPECT_EQ(analyzer.getModelVersion(), version);
+    
+    // Preprocessing changes apply to the loaded model without reading it again
+    analyzer.setConfig("preprocessing-pipeline", "remove_punctuation");
+    EXPECT_EQ(analyzer.getModelVersion(), version);
+    EXPECT_NE(analyzer.analyze(text).cleanedText, before.cleanedText);
+    analyzer.setConfig("preprocessing-pipeline", "");
+    EXPECT_EQ(analyzer.analyze(text).cleanedText, before.cleanedText);
+    
+    // Settings read while loading reload the model, once per change
+    analyzer.setConfig({{"nn-float32", "true"}, {"hidden-size", "8"}, {"seed", "7"}});
+    EXPECT_EQ(analyzer.getModelVersion(), version + 1);
+    analyzer.setConfig("model-dir", (tempDir / "missing").string());
+    EXPECT_EQ(analyzer.getModelVersion(), version + 1);
+    analyzer.setConfig("model-dir", modelDir.string());
+    EXPECT_EQ(analyzer.getModelVersion(), version + 2);
+    EXPECT_DOUBLE_EQ(analyzer.analyze(text).harmScore, before.harmScore);
+}
+
 /**
  * @test
  * @brief Tests visualization generation
@@ -0,0 +1,165 @@
+/**
+ * @file batch_summary_test.cpp
+ * @brief Unit tests for the BatchSummary class
+ * @ingroup tests
+ * @defgroup batch_summary_tests Batch Summary Tests
+ *
+ * Contains tests for shard assignment, merging shard summaries and
+ * saving and loading them.
+ */
+
+#include "blahajpi/utils/batch_summary.hpp"
+#include "blahajpi/analyzer.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using blahajpi::utils::BatchSummary;
+
+/**
+ * @brief Builds a scored result
+ * @param probability Harm probability
+ * @return Result labeled by the probability
+ */
+blahajpi::AnalysisResult makeResult(double probability) {
+    blahajpi::AnalysisResult result;
+    result.confidence = probability;
+    result.sentiment = probability > 0.5 ? "Harmful" : "Safe";
+    return result;
+}
+
+/**
+ * @test
+ * @brief Tests that every input lands in exactly one shard
+ * @ingroup batch_summary_tests
+ */
+TEST(BatchSummaryTest, ShardsPartitionInputs) {
+    std::vector<size_t> perShard(4);
+    for (int i = 0; i < 1000; ++i) {
+        std::string key = "dir/file" + std::to_string(i) + ".txt";
+        size_t shard = blahajpi::utils::shardOf(key, 4);
+        ASSERT_LT(shard, 4u);
+        EXPECT_EQ(blahajpi::utils::shardOf(key, 4), shard);
+        ++perShard[shard];
+    }
+    for (size_t count : perShard) {
+        EXPECT_GT(count, 150u);
+    }
+    EXPECT_EQ(blahajpi::utils::shardOf("anything", 1), 0u);
+}
+
+/**
+ * @test
+ * @brief Tests that merged shard summaries match one summary of everything
+ * @ingroup batch_summary_tests
+ */
+TEST(BatchSummaryTest, MergeMatchesSingleRun) {
+    std::vector<double> probabilities = {0.05, 0.95, 0.5, 0.7, 0.12, 1.0, 0.0, 0.33};
+    std::vector<int> labels = {0, 4, 4, 0, 0, 4, 0, 0};
+
+    BatchSummary whole;
+    std::vector<BatchSummary> shards = {BatchSummary(0, 3), BatchSummary(1, 3), BatchSummary(2, 3)};
+    for (size_t i = 0; i < probabilities.size(); ++i) {
+        whole.add(makeResult(probabilities[i]), labels[i]);
+        shards[i % 3].add(makeResult(probabilities[i]), labels[i]);
+    }
+    whole.addError();
+    shards[1].addError();
+
+    blahajpi::utils::WordCounter words;
+    words.add("awful", 3);
+    whole.addTerms(words);
+    shards[2].addTerms(words);
+
+    BatchSummary merged = shards[2];
+    merged.merge(shards[0]);
+    EXPECT_FALSE(merged.isComplete());
+    merged.merge(shards[1]);
+    EXPECT_TRUE(merged.isComplete());
+    EXPECT_EQ(merged.getShards(), (std::vector<size_t>{0, 1, 2}));
+
+    EXPECT_EQ(merged.getFiles(), 9u);
+    EXPECT_EQ(merged.getHarmful(), 3u);
+    EXPECT_EQ(merged.getErrors(), 1u);
+    EXPECT_EQ(merged.getLabeled(), 8u);
+    EXPECT_EQ(merged.getScoreBins(), whole.getScoreBins());
+    EXPECT_EQ(merged.getScoreBins()[0], 2u);
+    EXPECT_EQ(merged.getScoreBins()[BatchSummary::SCORE_BINS - 1], 2u);
+    EXPECT_EQ(merged.getMetrics(), whole.getMetrics());
+    EXPECT_EQ(merged.getTerms().count("awful"), 3);
+
+    // Only the report's shard line differs from the single run's
+    std::string report = merged.report();
+    EXPECT_NE(report.find("Shards: 3 of 3\n"), std::string::npos);
+    EXPECT_EQ(report.substr(report.find("Total files")), whole.report().substr(whole.report().find("Total files")));
+}
+
+/**
+ * @test
+ * @brief Tests that shards are never counted twice
+ * @ingroup batch_summary_tests
+ */
+TEST(BatchSummaryTest, RefusesOverlappingShards) {
+    BatchSummary first(0, 2);
+    first.add(makeResult(0.9));
+    EXPECT_THROW(first.merge(BatchSummary(0, 2)), std::invalid_argument);
+    EXPECT_THROW(first.merge(BatchSummary(0, 3)), std::invalid_argument);
+    EXPECT_THROW(BatchSummary(2, 2), std::invalid_argument);
+    EXPECT_EQ(first.getFiles(), 1u);
+}
+
+/**
+ * @test
+ * @brief Tests writing and reading back a summary
+ * @ingroup batch_summary_tests
+ */
+TEST(BatchSummaryTest, SaveAndLoad) {
+    std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "blahajpi_tests";
+    std::filesystem::create_directories(tempDir);
+    std::string path = (tempDir / "shard.sum").string();
+
+    BatchSummary summary(1, 4);
+    summary.add(makeResult(0.8), 4);
+    summary.add(makeResult(0.3));
+    summary.addError();
+    for (int i = 0; i < 2; ++i) {
+        auto copy = makeResult(0.7);
+        copy.cluster = 0xabc;
+        summary.add(copy);
+    }
+    blahajpi::utils::WordCounter words;
+    words.add("gross", 2);
+    words.add("awful", 5);
+    summary.addTerms(words);
+    ASSERT_TRUE(summary.save(path));
+
+    BatchSummary loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(loaded.getShardCount(), 4u);
+    EXPECT_EQ(loaded.getShards(), (std::vector<size_t>{1}));
+    EXPECT_EQ(loaded.getFiles(), 5u);
+    EXPECT_EQ(loaded.getHarmful(), 3u);
+    EXPECT_EQ(loaded.getErrors(), 1u);
+    EXPECT_EQ(loaded.getLabeled(), 1u);
+    EXPECT_EQ(loaded.getScoreBins(), summary.getScoreBins());
+    EXPECT_EQ(loaded.getTerms().top(2), summary.getTerms().top(2));
+    EXPECT_EQ(loaded.getClusters().top(1), (std::vector<std::pair<std::string, int64_t>>{{"0000000000000abc", 2}}));
+    EXPECT_EQ(loaded.report(), summary.report());
+    EXPECT_NE(loaded.report().find("Largest near-duplicate clusters: 0000000000000abc (2 files)"), std::string::npos);
+
+    // Anything else is refused and leaves the summary alone
+    std::filesystem::path other = tempDir / "other.txt";
+    std::ofstream(other) << "file,sentiment\n";
+    EXPECT_FALSE(loaded.load(other.string()));
+    EXPECT_FALSE(loaded.load((tempDir / "missing.sum").string()));
+    EXPECT_EQ(loaded.getFiles(), 5u);
+
+    std::filesystem::remove_all(tempDir);
+}
+
+} // namespace
@@ -0,0 +1,173 @@
+/**
+ * @file byte_kernels_test.cpp
+ * @brief Unit tests for the byte-class kernels
+ * @ingroup tests
+ * @defgroup byte_kernels_tests Byte Kernel Tests
+ *
+ * Contains tests that check the vectorized kernels against plain
+ * per-character loops over the <cctype> functions.
+ */
+
+#include "blahajpi/utils/byte_kernels.hpp"
+#include <gtest/gtest.h>
+#include <cctype>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace blahajpi::utils;
+
+/**
+ * @brief Builds texts of every length around the vector block sizes
+ *
+ * Mixes letters, digits, punctuation, whitespace runs, repeated characters
+ * and UTF-8 bytes so every kind of block, clean or not, shows up.
+ *
+ * @return Test inputs
+ */
+std::vector<std::string> sampleTexts() {
+    const std::vector<std::string> pieces = {
+        "Hello", " ", "world", "!!", "  ", "\t", "\n", "123", "soooo", "gooood", "caf\xC3\xA9",
+        "#Tag", "@user", "don't", "...", "A", "zz", "\xF0\x9F\x92\x96", "\r\n", "x", "     "
+    };
+
+    std::mt19937 rng(42);
+    std::vector<std::string> texts = {"", " ", "a", "aaa", "   lead", "trail   "};
+    for (size_t length = 1; length <= 140; ++length) {
+        std::string text;
+        while (text.size() < length) {
+            text += pieces[rng() % pieces.size()];
+        }
+        text.resize(length);
+        texts.push_back(text);
+    }
+
+    // Every byte value, including control characters and 0x80-0xFF
+    std::string allBytes;
+    for (int c = 0; c < 256; ++c) {
+        allBytes.push_back(static_cast<char>(c));
+    }
+    texts.push_back(allBytes + allBytes);
+    return texts;
+}
+
+/**
+ * @brief Reference filter over the <cctype> functions
+ */
+std::string referenceFilter(const std::string& text, uint8_t dropClasses, bool lowercase) {
+    std::string result;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(lowercase ? std::tolower(static_cast<unsigned char>(c)) : c);
+        bool drop = ((dropClasses & BYTE_UPPER) && std::isupper(byte)) ||
+                    ((dropClasses & BYTE_DIGIT) && std::isdigit(byte)) ||
+                    ((dropClasses & BYTE_PUNCT) && std::ispunct(byte)) ||
+                    ((dropClasses & BYTE_SPACE) && std::isspace(byte)) ||
+                    ((dropClasses & BYTE_NON_ASCII) && byte >= 128);
+        if (!drop) {
+            result.push_back(static_cast<char>(byte));
+        }
+    }
+    return result;
+}
+
+/**
+ * @test
+ * @brief Tests filtering and lowercasing against <cctype>
+ * @ingroup byte_kernels_tests
+ */
+TEST(ByteKernelsTest, FilterMatchesCctype) {
+    const std::vector<uint8_t> classSets = {
+        0, BYTE_UPPER, BYTE_DIGIT, BYTE_PUNCT, BYTE_SPACE, BYTE_NON_ASCII,
+        BYTE_PUNCT | BYTE_DIGIT, BYTE_UPPER | BYTE_DIGIT | BYTE_PUNCT | BYTE_SPACE | BYTE_NON_ASCII
+    };
+
+    for (const auto& text : sampleTexts()) {
+        for (uint8_t classes : classSets) {
+            for (bool lowercase : {false, true}) {
+                std::string output;
+                appendFiltered(text, classes, lowercase, output);
+                EXPECT_EQ(output, referenceFilter(text, classes, lowercase))
+                    << "classes " << int(classes) << ", lowercase " << lowercase << ", length " << text.size();
+            }
+        }
+    }
+}
+
+/**
+ * @test
+ * @brief Tests whitespace collapsing against a per-character loop
+ * @ingroup byte_kernels_tests
+ */
+TEST(ByteKernelsTest, CollapseWhitespaceMatchesLoop) {
+    for (const auto& text : sampleTexts()) {
+        std::string expected;
+        bool lastWasSpace = true;
+        for (char c : text) {
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                if (!lastWasSpace) {
+                    expected.push_back(' ');
+                }
+                lastWasSpace = true;
+            } else {
+                expected.push_back(c);
+                lastWasSpace = false;
+            }
+        }
+        if (!expected.empty() && expected.back() == ' ') {
+            expected.pop_back();
+        }
+
+        std::string output;
+        appendCollapsedWhitespace(text, output);
+        EXPECT_EQ(output, expected) << "length " << text.size();
+    }
+}
+
+/**
+ * @test
+ * @brief Tests repeat collapsing against a per-character loop
+ * @ingroup byte_kernels_tests
+ */
+TEST(ByteKernelsTest, CollapseRepeatsMatchesLoop) {
+    std::vector<std::string> texts = sampleTexts();
+    texts.push_back(std::string(100, 'o'));
+    texts.push_back("s" + std::string(37, 'o') + " " + std::string(33, '!') + "good");
+
+    for (const auto& text : texts) {
+        std::string expected;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (i == 0 || text[i] != text[i - 1] ||
+                (expected.size() >= 2 && expected[expected.size() - 1] != expected[expected.size() - 2])) {
+                expected.push_back(text[i]);
+            }
+        }
+
+        std::string output;
+        appendCollapsedRepeats(text, output);
+        EXPECT_EQ(output, expected) << "length " << text.size();
+    }
+}
+
+/**
+ * @test
+ * @brief Tests that the kernels append and leave earlier output alone
+ * @ingroup byte_kernels_tests
+ */
+TEST(ByteKernelsTest, AppendsToOutput) {
+    std::string output = "NOT";
+    appendFiltered("Don't-Stop 4ever", BYTE_PUNCT | BYTE_DIGIT, true, output);
+    EXPECT_EQ(output, "NOTdontstop ever");
+
+    appendCollapsedWhitespace("  a \t b  ", output);
+    EXPECT_EQ(output, "NOTdontstop evera b");
+
+    appendCollapsedRepeats("soooo", output);
+    EXPECT_EQ(output, "NOTdontstop evera bsoo");
+
+    std::string isa = byteKernelIsa();
+    EXPECT_TRUE(isa == "avx2" || isa == "sse2" || isa == "neon" || isa == "scalar") << isa;
+}
+
+} // namespace
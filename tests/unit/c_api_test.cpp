@@ -0,0 +1,148 @@
+/**
+ * @file c_api_test.cpp
+ * @brief Unit tests for the C interface to the analyzer
+ * @ingroup tests
+ * @defgroup c_api_tests C API Tests
+ *
+ * Contains tests for handle lifetime, status codes and batch scoring
+ * from a single buffer.
+ */
+
+#include "blahajpi/c_api.h"
+#include "blahajpi/analyzer.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @class CApiTest
+ * @brief Test fixture with a trained model on disk
+ */
+class CApiTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Writes training data and trains a linear model
+     */
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "blahajpi_c_api_tests";
+        modelDir = tempDir / "models";
+        std::filesystem::create_directories(modelDir);
+
+        std::filesystem::path dataPath = tempDir / "data.csv";
+        std::ofstream dataFile(dataPath);
+        dataFile << "label,text\n"
+                 << "0,This is normal content that should be safe.\n"
+                 << "4,This content contains harmful language that targets people.\n"
+                 << "0,Another example of perfectly acceptable content.\n"
+                 << "4,This has offensive language that should be flagged.\n"
+                 << "0,Just a regular post about everyday life.\n"
+                 << "4,Content with problematic statements about groups.\n";
+        dataFile.close();
+
+        blahajpi::Analyzer trainer;
+        trainer.setConfig("model-type", "linear");
+        ASSERT_TRUE(trainer.trainModel(dataPath.string(), modelDir.string()));
+    }
+
+    /**
+     * @brief Removes the temporary files
+     */
+    void TearDown() override {
+        std::filesystem::remove_all(tempDir);
+    }
+
+    std::filesystem::path tempDir;   ///< Scratch directory
+    std::filesystem::path modelDir;  ///< Trained model
+};
+
+/**
+ * @test
+ * @brief Tests creating handles, configuring them and loading models
+ * @ingroup c_api_tests
+ */
+TEST_F(CApiTest, Lifecycle) {
+    EXPECT_EQ(bpi_abi_version(), static_cast<uint32_t>(BPI_ABI_VERSION));
+
+    EXPECT_EQ(bpi_create((tempDir / "missing.conf").string().c_str()), nullptr);
+    EXPECT_NE(std::string(bpi_last_error()).find("missing.conf"), std::string::npos);
+
+    bpi_analyzer* analyzer = bpi_create(nullptr);
+    ASSERT_NE(analyzer, nullptr);
+    EXPECT_EQ(bpi_model_version(analyzer), 0u);
+    EXPECT_EQ(bpi_set_config(analyzer, "model-type", "linear"), BPI_OK);
+    EXPECT_EQ(bpi_set_config(analyzer, nullptr, "linear"), BPI_INVALID_ARGUMENT);
+
+    EXPECT_EQ(bpi_load_model(analyzer, (tempDir / "missing").string().c_str()), BPI_FAILED);
+    EXPECT_EQ(bpi_model_version(analyzer), 0u);
+    EXPECT_EQ(bpi_load_model(analyzer, modelDir.string().c_str()), BPI_OK);
+    EXPECT_GT(bpi_model_version(analyzer), 0u);
+
+    bpi_destroy(analyzer);
+    bpi_destroy(nullptr);
+    EXPECT_EQ(bpi_model_version(nullptr), 0u);
+}
+
+/**
+ * @test
+ * @brief Tests that batch scores match the C++ interface
+ * @ingroup c_api_tests
+ */
+TEST_F(CApiTest, ScoresBatch) {
+    const std::vector<std::string> texts = {
+        "This has offensive language about groups",
+        "Just a regular post about life",
+        "",
+        "Content with harmful statements"
+    };
+    std::string data;
+    std::vector<uint64_t> offsets = {0};
+    for (const auto& text : texts) {
+        data += text;
+        offsets.push_back(data.size());
+    }
+
+    bpi_analyzer* analyzer = bpi_create(nullptr);
+    ASSERT_NE(analyzer, nullptr);
+    std::vector<double> scores(texts.size());
+    std::vector<double> probabilities(texts.size());
+    std::vector<uint8_t> labels(texts.size());
+    EXPECT_EQ(bpi_score_batch(analyzer, data.data(), offsets.data(), texts.size(),
+                              scores.data(), nullptr, nullptr), BPI_NO_MODEL);
+
+    ASSERT_EQ(bpi_load_model(analyzer, modelDir.string().c_str()), BPI_OK);
+    ASSERT_EQ(bpi_score_batch(analyzer, data.data(), offsets.data(), texts.size(),
+                              scores.data(), probabilities.data(), labels.data()), BPI_OK);
+
+    blahajpi::Analyzer reference;
+    ASSERT_TRUE(reference.loadModel(modelDir.string()));
+    auto expected = reference.analyzeMultiple(texts, blahajpi::AnalysisResult::SCORES_ONLY);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_DOUBLE_EQ(scores[i], expected[i].harmScore);
+        EXPECT_DOUBLE_EQ(probabilities[i], expected[i].confidence);
+        EXPECT_EQ(labels[i], expected[i].sentiment == "Harmful" ? 1 : 0);
+    }
+
+    // Labels alone, and an empty batch
+    std::vector<uint8_t> onlyLabels(texts.size(), 9);
+    EXPECT_EQ(bpi_score_batch(analyzer, data.data(), offsets.data(), texts.size(),
+                              nullptr, nullptr, onlyLabels.data()), BPI_OK);
+    EXPECT_EQ(onlyLabels, labels);
+    EXPECT_EQ(bpi_score_batch(analyzer, nullptr, offsets.data(), 0, nullptr, nullptr, nullptr), BPI_OK);
+
+    // Offsets must not run backwards
+    std::vector<uint64_t> badOffsets = {0, 10, 5};
+    EXPECT_EQ(bpi_score_batch(analyzer, data.data(), badOffsets.data(), 2,
+                              scores.data(), nullptr, nullptr), BPI_INVALID_ARGUMENT);
+    EXPECT_NE(std::string(bpi_last_error()).find("Offsets"), std::string::npos);
+    EXPECT_EQ(bpi_score_batch(nullptr, data.data(), offsets.data(), texts.size(),
+                              scores.data(), nullptr, nullptr), BPI_INVALID_ARGUMENT);
+
+    bpi_destroy(analyzer);
+}
+
+} // namespace
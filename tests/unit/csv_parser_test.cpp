@@ -0,0 +1,129 @@
+/**
+ * @file csv_parser_test.cpp
+ * @brief Unit tests for the delimited text parser
+ * @ingroup tests
+ * @defgroup csv_parser_tests CSV Parser Tests
+ *
+ * Contains tests for RFC 4180 quoting, line endings, TSV splitting and
+ * the vectorized byte search.
+ */
+
+#include "blahajpi/utils/csv_parser.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Parses every record of a buffer into unescaped values
+ * @param data Buffer to parse
+ * @param delimiter Field separator
+ * @param quoting Whether double quotes delimit fields
+ * @return Field values of each record
+ */
+std::vector<std::vector<std::string>> parseAll(const std::string& data, char delimiter, bool quoting) {
+    blahajpi::utils::DelimitedParser parser(data, delimiter, quoting);
+    std::vector<blahajpi::utils::DelimitedField> fields;
+    std::vector<std::vector<std::string>> records;
+    while (parser.next(fields)) {
+        std::vector<std::string> values;
+        for (const auto& field : fields) {
+            values.push_back(field.value());
+        }
+        records.push_back(values);
+    }
+    return records;
+}
+
+/**
+ * @test
+ * @brief Tests RFC 4180 quoting rules
+ * @ingroup csv_parser_tests
+ *
+ * Verifies quoted delimiters, doubled quotes, line breaks inside quotes,
+ * CRLF line endings and a final record without a line break.
+ */
+TEST(CsvParserTest, HandlesQuotedFields) {
+    std::string data =
+        "label,text\r\n"
+        "0,\"a, b\"\r\n"
+        "4,\"she said \"\"hi\"\"\"\n"
+        "0,\"first line\nsecond line\"\n"
+        "4,plain \"quotes\" stay\n"
+        "0,";
+
+    auto records = parseAll(data, ',', true);
+    ASSERT_EQ(records.size(), 6u);
+    EXPECT_EQ(records[0], (std::vector<std::string>{"label", "text"}));
+    EXPECT_EQ(records[1], (std::vector<std::string>{"0", "a, b"}));
+    EXPECT_EQ(records[2], (std::vector<std::string>{"4", "she said \"hi\""}));
+    EXPECT_EQ(records[3], (std::vector<std::string>{"0", "first line\nsecond line"}));
+    EXPECT_EQ(records[4], (std::vector<std::string>{"4", "plain \"quotes\" stay"}));
+    EXPECT_EQ(records[5], (std::vector<std::string>{"0", ""}));
+}
+
+/**
+ * @test
+ * @brief Tests fields with text after the closing quote
+ * @ingroup csv_parser_tests
+ *
+ * Verifies that such fields are kept verbatim and unterminated quotes run
+ * to the end of the buffer.
+ */
+TEST(CsvParserTest, KeepsMalformedQuotesVerbatim) {
+    auto records = parseAll("\"a\"b,c\n\"open", ',', true);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0], (std::vector<std::string>{"\"a\"b", "c"}));
+    EXPECT_EQ(records[1], (std::vector<std::string>{"open"}));
+}
+
+/**
+ * @test
+ * @brief Tests splitting without quoting
+ * @ingroup csv_parser_tests
+ *
+ * Verifies that TSV mode treats quotes as text and that seeking returns
+ * to a record boundary.
+ */
+TEST(CsvParserTest, SplitsTsvAndSeeks) {
+    std::string data = "label\ttext\n4\t\"quoted\" text\n0\tlast\n";
+    blahajpi::utils::DelimitedParser parser(data, '\t', false);
+    std::vector<blahajpi::utils::DelimitedField> fields;
+
+    ASSERT_TRUE(parser.next(fields));
+    size_t firstRow = parser.position();
+    ASSERT_TRUE(parser.next(fields));
+    ASSERT_EQ(fields.size(), 2u);
+    EXPECT_EQ(fields[1].raw, "\"quoted\" text");
+
+    ASSERT_TRUE(parser.next(fields));
+    EXPECT_FALSE(parser.next(fields));
+
+    parser.seek(firstRow);
+    ASSERT_TRUE(parser.next(fields));
+    EXPECT_EQ(fields[0].raw, "4");
+}
+
+/**
+ * @test
+ * @brief Tests the byte search against a scalar scan
+ * @ingroup csv_parser_tests
+ *
+ * Places matches at every offset of a buffer longer than one vector.
+ */
+TEST(CsvParserTest, FindEitherMatchesScalarSearch) {
+    for (size_t length = 0; length < 70; ++length) {
+        for (size_t hit = 0; hit <= length; ++hit) {
+            std::string buffer(length, 'x');
+            if (hit < length) {
+                buffer[hit] = (hit % 2 == 0) ? ',' : '\n';
+            }
+            const char* begin = buffer.data();
+            const char* found = blahajpi::utils::findEither(begin, begin + length, ',', '\n');
+            EXPECT_EQ(static_cast<size_t>(found - begin), hit) << "length " << length;
+        }
+    }
+}
+
+} // namespace
@@ -9,10 +9,14 @@
  */
 
 #include "blahajpi/utils/dataset.hpp"
+#include "blahajpi/utils/dataset_reader.hpp"
 #include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <stdexcept>
 
 namespace {
 
@@ -104,6 +108,97 @@ TEST_F(DatasetTest, TrainTestSplit) {
     EXPECT_EQ(trainData.size() + testData.size(), sampleData.size());
 }
 
+/**
+ * @test
+ * @brief Tests the train, test and per-label views
+ * @ingroup dataset_tests
+ * 
+ * Verifies that the views select the same samples as the copying
+ * getters, that splits partition the dataset and that a stratified split
+ * keeps every label on both sides.
+ */
+TEST_F(DatasetTest, SplitViews) {
+    std::vector<std::pair<int, std::string>> data;
+    for (int i = 0; i < 40; ++i) {
+        data.emplace_back(i % 4 == 0 ? 4 : 0, "sample " + std::to_string(i));
+    }
+    blahajpi::utils::Dataset dataset(data);
+    EXPECT_TRUE(dataset.viewTrainTexts().empty());
+    dataset.splitTrainTest(0.25);
+    
+    auto trainTexts = dataset.viewTrainTexts();
+    auto trainLabels = dataset.viewTrainLabels();
+    auto testTexts = dataset.viewTestTexts();
+    auto testLabels = dataset.viewTestLabels();
+    EXPECT_EQ(trainTexts.toVector(), dataset.getTrainTexts());
+    EXPECT_EQ(testLabels.toVector(), dataset.getTestLabels());
+    ASSERT_EQ(trainTexts.size(), trainLabels.size());
+    EXPECT_EQ(trainTexts.size() + testTexts.size(), data.size());
+    
+    // Views index into the stored columns rather than copying
+    std::vector<bool> seen(data.size(), false);
+    for (auto view : {trainTexts, testTexts}) {
+        for (size_t i = 0; i < view.size(); ++i) {
+            size_t index = view.getIndices()[i];
+            EXPECT_EQ(&view[i], &dataset.textColumn()[index]);
+            EXPECT_FALSE(seen[index]);
+            seen[index] = true;
+        }
+    }
+    
+    size_t harmfulInTest = 0;
+    for (int label : testLabels) {
+        harmfulInTest += label != 0 ? 1 : 0;
+    }
+    EXPECT_GT(harmfulInTest, 0u);
+    EXPECT_LT(harmfulInTest, testLabels.size());
+    
+    auto harmful = dataset.viewTextsWithLabel(4);
+    ASSERT_EQ(harmful.size(), 10u);
+    EXPECT_EQ(harmful[1], "sample 4");
+    EXPECT_TRUE(dataset.viewTextsWithLabel(999).empty());
+    EXPECT_EQ(dataset.labelColumn().size(), data.size());
+}
+
+/**
+ * @test
+ * @brief Tests cross-validation fold assignment
+ * @ingroup dataset_tests
+ * 
+ * Verifies that folds are balanced, stratified by label, reproducible
+ * for a seed, and that invalid fold counts are rejected.
+ */
+TEST_F(DatasetTest, AssignFolds) {
+    std::vector<std::pair<int, std::string>> data;
+    for (int i = 0; i < 30; ++i) {
+        data.emplace_back(i < 10 ? 4 : 0, "sample " + std::to_string(i));
+    }
+    blahajpi::utils::Dataset dataset(data);
+    
+    auto folds = dataset.assignFolds(5);
+    ASSERT_EQ(folds.size(), data.size());
+    EXPECT_EQ(folds, dataset.assignFolds(5));
+    
+    // Six samples per fold, two of them harmful
+    std::vector<size_t> sizes(5, 0);
+    std::vector<size_t> harmful(5, 0);
+    for (size_t i = 0; i < folds.size(); ++i) {
+        ASSERT_LT(folds[i], 5u);
+        ++sizes[folds[i]];
+        harmful[folds[i]] += data[i].first != 0 ? 1 : 0;
+    }
+    for (size_t fold = 0; fold < 5; ++fold) {
+        EXPECT_EQ(sizes[fold], 6u);
+        EXPECT_EQ(harmful[fold], 2u);
+    }
+    
+    EXPECT_EQ(dataset.getLabels().size(), data.size());
+    EXPECT_EQ(dataset.getTexts()[3], data[3].second);
+    
+    EXPECT_THROW(dataset.assignFolds(1), std::invalid_argument);
+    EXPECT_THROW(dataset.assignFolds(31), std::invalid_argument);
+}
+
 /**
  * @test
  * @brief Tests retrieval of texts with specific labels
@@ -196,4 +291,82 @@ TEST_F(DatasetTest, FormatAutoDetection) {
     });
 }
 
+/**
+ * @test
+ * @brief Tests streaming a CSV file in batches
+ * @ingroup dataset_tests
+ * 
+ * Verifies that the reader honors quoting, skips malformed rows, and can
+ * rewind for another pass.
+ */
+TEST_F(DatasetTest, DatasetReaderStreamsBatches) {
+    auto filePath = (std::filesystem::temp_directory_path() / "blahajpi_stream_test.csv").string();
+    {
+        std::ofstream file(filePath);
+        file << "id,Label,text\n";
+        file << "1,0,\"safe, with a comma\"\n";
+        file << "2,4,harmful content\n";
+        file << "3,not-a-number,skipped\n";
+        file << "4\n";
+        file << "5,0,another safe message\n";
+    }
+    
+    blahajpi::utils::DatasetReader reader;
+    ASSERT_TRUE(reader.open(filePath, blahajpi::utils::Dataset::Format::AUTO, "label", "text"));
+    
+    std::vector<std::pair<int, std::string>> batch;
+    EXPECT_EQ(reader.readBatch(batch, 2), 2u);
+    EXPECT_EQ(batch[0], std::make_pair(0, std::string("safe, with a comma")));
+    EXPECT_EQ(batch[1], std::make_pair(4, std::string("harmful content")));
+    EXPECT_EQ(reader.readBatch(batch, 2), 1u);
+    EXPECT_EQ(batch[0].second, "another safe message");
+    EXPECT_EQ(reader.readBatch(batch, 2), 0u);
+    EXPECT_EQ(reader.getSamplesRead(), 3u);
+    
+    ASSERT_TRUE(reader.rewind());
+    EXPECT_EQ(reader.readBatch(batch, 10), 3u);
+    
+    // The held-out split is stable and close to the requested fraction
+    size_t heldOut = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        bool first = blahajpi::utils::DatasetReader::isHeldOut(i, 0.2, 42);
+        EXPECT_EQ(first, blahajpi::utils::DatasetReader::isHeldOut(i, 0.2, 42));
+        heldOut += first ? 1 : 0;
+    }
+    EXPECT_NEAR(static_cast<double>(heldOut) / 10000.0, 0.2, 0.02);
+    
+    EXPECT_FALSE(reader.open(filePath, blahajpi::utils::Dataset::Format::AUTO, "label", "missing"));
+    std::filesystem::remove(filePath);
+}
+
+/**
+ * @test
+ * @brief Tests the header names and labels the original loaders accepted
+ * @ingroup dataset_tests
+ *
+ * Verifies that spaces inside header names are ignored and that labels
+ * may carry a sign.
+ */
+TEST_F(DatasetTest, DatasetReaderAcceptsLegacyInput) {
+    auto filePath = (std::filesystem::temp_directory_path() / "blahajpi_legacy_test.csv").string();
+    {
+        std::ofstream file(filePath);
+        file << "\"sentiment label\", text \n";
+        file << "+4,signed label\n";
+        file << " 0 ,padded label\n";
+        file << "-1,negative label\n";
+        file << "+,skipped\n";
+    }
+
+    blahajpi::utils::DatasetReader reader;
+    ASSERT_TRUE(reader.open(filePath, blahajpi::utils::Dataset::Format::CSV, "sentimentlabel", "text"));
+
+    std::vector<std::pair<int, std::string>> batch;
+    ASSERT_EQ(reader.readBatch(batch, 10), 3u);
+    EXPECT_EQ(batch[0], std::make_pair(4, std::string("signed label")));
+    EXPECT_EQ(batch[1].first, 0);
+    EXPECT_EQ(batch[2].first, -1);
+    std::filesystem::remove(filePath);
+}
+
 } // namespace
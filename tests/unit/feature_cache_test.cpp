@@ -0,0 +1,157 @@
+/**
+ * @file feature_cache_test.cpp
+ * @brief Unit tests for the on-disk feature cache
+ * @ingroup tests
+ * @defgroup feature_cache_tests Feature Cache Tests
+ *
+ * Contains tests for cache keys, round trips of prepared training data,
+ * and the handling of missing and damaged entries.
+ */
+
+#include "blahajpi/preprocessing/feature_cache.hpp"
+#include "toy_corpus.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Test fixture for feature cache tests
+ * @ingroup feature_cache_tests
+ *
+ * Provides a temporary directory, a dataset file and features prepared
+ * from the shared toy corpus.
+ */
+class FeatureCacheTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Set up test data and directories
+     */
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "blahajpi_feature_cache_tests";
+        std::filesystem::create_directories(tempDir);
+        dataPath = (tempDir / "data.csv").string();
+        writeDataset("label,text\n4,awful\n0,lovely\n");
+
+        prepared.trainLabels = blahajpi::test::TOY_LABELS;
+        prepared.testTexts = {"awful gross", "kind people", ""};
+        prepared.testLabels = {4, 0, 0};
+        prepared.vectorizer = std::make_unique<blahajpi::preprocessing::TfidfVectorizer>();
+        prepared.vectorizer->fit(blahajpi::test::TOY_TEXTS);
+        prepared.trainFeatures = prepared.vectorizer->transformSparse(blahajpi::test::TOY_TEXTS);
+        prepared.testFeatures = prepared.vectorizer->transformSparse(prepared.testTexts);
+    }
+
+    /**
+     * @brief Clean up temporary files
+     */
+    void TearDown() override {
+        if (std::filesystem::exists(tempDir)) {
+            std::filesystem::remove_all(tempDir);
+        }
+    }
+
+    /**
+     * @brief Replaces the dataset file
+     * @param contents New file contents
+     */
+    void writeDataset(const std::string& contents) {
+        std::ofstream file(dataPath, std::ios::binary);
+        file << contents;
+    }
+
+    std::filesystem::path tempDir;                      ///< Scratch directory
+    std::string dataPath;                               ///< Dataset file the keys are computed from
+    blahajpi::preprocessing::FeatureSet prepared;       ///< Data to cache
+};
+
+/**
+ * @test
+ * @brief Tests cache keys
+ * @ingroup feature_cache_tests
+ *
+ * Verifies that keys are stable, and change with the dataset contents and
+ * the settings.
+ */
+TEST_F(FeatureCacheTest, KeyTracksContentsAndSettings) {
+    using blahajpi::preprocessing::FeatureCache;
+
+    std::string key = FeatureCache::makeKey(dataPath, "max-features=10\n");
+    EXPECT_EQ(key.size(), 16u);
+    EXPECT_EQ(key, FeatureCache::makeKey(dataPath, "max-features=10\n"));
+    EXPECT_NE(key, FeatureCache::makeKey(dataPath, "max-features=20\n"));
+
+    writeDataset("label,text\n4,awful\n0,lovely!\n");
+    EXPECT_NE(key, FeatureCache::makeKey(dataPath, "max-features=10\n"));
+
+    EXPECT_TRUE(FeatureCache::makeKey((tempDir / "missing.csv").string(), "").empty());
+}
+
+/**
+ * @test
+ * @brief Tests storing and loading prepared data
+ * @ingroup feature_cache_tests
+ *
+ * Verifies that rows, labels, texts and the vectorizer come back unchanged.
+ */
+TEST_F(FeatureCacheTest, RoundTrip) {
+    blahajpi::preprocessing::FeatureCache cache((tempDir / "cache").string());
+    std::string key = blahajpi::preprocessing::FeatureCache::makeKey(dataPath, "");
+
+    blahajpi::preprocessing::FeatureSet loaded;
+    EXPECT_FALSE(cache.load(key, loaded));
+    ASSERT_TRUE(cache.store(key, prepared));
+    ASSERT_TRUE(cache.load(key, loaded));
+
+    ASSERT_EQ(loaded.trainFeatures.size(), prepared.trainFeatures.size());
+    for (size_t i = 0; i < prepared.trainFeatures.size(); ++i) {
+        EXPECT_EQ(loaded.trainFeatures[i].indices, prepared.trainFeatures[i].indices);
+        EXPECT_EQ(loaded.trainFeatures[i].values, prepared.trainFeatures[i].values);
+    }
+    ASSERT_EQ(loaded.testFeatures.size(), prepared.testFeatures.size());
+    for (size_t i = 0; i < prepared.testFeatures.size(); ++i) {
+        EXPECT_EQ(loaded.testFeatures[i].indices, prepared.testFeatures[i].indices);
+        EXPECT_EQ(loaded.testFeatures[i].values, prepared.testFeatures[i].values);
+    }
+    EXPECT_EQ(loaded.trainLabels, prepared.trainLabels);
+    EXPECT_EQ(loaded.testLabels, prepared.testLabels);
+    EXPECT_EQ(loaded.testTexts, prepared.testTexts);
+
+    // The restored vectorizer produces the same features as the fitted one
+    ASSERT_TRUE(loaded.vectorizer);
+    EXPECT_EQ(loaded.vectorizer->getNumFeatures(), prepared.vectorizer->getNumFeatures());
+    auto expected = prepared.vectorizer->transformSparse({"awful lovely people"});
+    auto actual = loaded.vectorizer->transformSparse({"awful lovely people"});
+    EXPECT_EQ(actual[0].indices, expected[0].indices);
+    EXPECT_EQ(actual[0].values, expected[0].values);
+}
+
+/**
+ * @test
+ * @brief Tests damaged and mismatched entries
+ * @ingroup feature_cache_tests
+ *
+ * Verifies that a corrupted entry is treated as a miss and that
+ * inconsistent data is not stored.
+ */
+TEST_F(FeatureCacheTest, RejectsBadEntries) {
+    blahajpi::preprocessing::FeatureCache cache(tempDir.string());
+    std::string key = "0123456789abcdef";
+    ASSERT_TRUE(cache.store(key, prepared));
+
+    {
+        std::fstream file(cache.pathFor(key), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    blahajpi::preprocessing::FeatureSet loaded;
+    EXPECT_FALSE(cache.load(key, loaded));
+
+    prepared.testLabels.pop_back();
+    EXPECT_FALSE(cache.store(key, prepared));
+}
+
+} // namespace
@@ -0,0 +1,238 @@
+/**
+ * @file linear_model_test.cpp
+ * @brief Unit tests for the LinearModel class
+ * @ingroup tests
+ * @defgroup linear_model_tests Linear Model Tests
+ * 
+ * Contains tests for the sparse linear classifier that trains and scores
+ * directly on the vectorizer's sparse output.
+ */
+
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include "toy_corpus.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Test fixture for LinearModel tests
+ * @ingroup linear_model_tests
+ * 
+ * Trains on the shared toy corpus; saved models go to a temporary
+ * directory.
+ */
+class LinearModelTest : public ::testing::Test, protected blahajpi::test::ToyCorpus {
+protected:
+    /**
+     * @brief Set up the temporary directory
+     */
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "blahajpi_tests";
+        std::filesystem::create_directories(tempDir);
+    }
+    
+    /**
+     * @brief Clean up temporary files
+     */
+    void TearDown() override {
+        if (std::filesystem::exists(tempDir)) {
+            std::filesystem::remove_all(tempDir);
+        }
+    }
+    
+    /** Temporary directory for file operations */
+    std::filesystem::path tempDir;
+};
+
+/**
+ * @test
+ * @brief Tests training and prediction on sparse rows
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, LearnsSeparableData) {
+    blahajpi::models::LinearModel model("log", 0.0001, 50, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+    
+    EXPECT_EQ(model.getNumFeatures(), vectorizer.getNumFeatures());
+    EXPECT_DOUBLE_EQ(model.score(features, labels), 1.0);
+    
+    // Predictions use the positive label seen during training
+    auto predictions = model.predict(features);
+    EXPECT_EQ(predictions[0], 4);
+    EXPECT_EQ(predictions[3], 0);
+    
+    auto probabilities = model.predictProbability(features);
+    auto scores = model.decisionFunction(features);
+    for (size_t i = 0; i < probabilities.size(); ++i) {
+        EXPECT_GT(probabilities[i], 0.0);
+        EXPECT_LT(probabilities[i], 1.0);
+        EXPECT_NEAR(probabilities[i], 1.0 / (1.0 + std::exp(-scores[i])), 1e-12);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests renumbering the weights after vocabulary compaction
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, CompactFeaturesFollowsVocabulary) {
+    blahajpi::models::LinearModel model("log", 0.0001, 50, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+    std::vector<double> weights = model.getWeights();
+    
+    // Keep only the words that decide the label
+    std::vector<bool> keep(weights.size());
+    for (const auto& [term, index] : vectorizer.getVocabulary()) {
+        keep[index] = term == "awful" || term == "gross" || term == "lovely" || term == "kind";
+    }
+    blahajpi::preprocessing::TfidfVectorizer compacted = vectorizer;
+    std::vector<int> newIndex = compacted.compact(keep);
+    blahajpi::models::LinearModel compactModel = model;
+    compactModel.compactFeatures(newIndex, compacted.getNumFeatures());
+    
+    ASSERT_EQ(compactModel.getNumFeatures(), 4u);
+    EXPECT_DOUBLE_EQ(compactModel.getBias(), model.getBias());
+    for (const auto& [term, index] : compacted.getVocabulary()) {
+        EXPECT_DOUBLE_EQ(compactModel.getWeights()[index], weights[vectorizer.getVocabulary().at(term)]);
+    }
+    EXPECT_DOUBLE_EQ(compactModel.score(compacted.transformSparse(texts), labels), 1.0);
+    
+    EXPECT_THROW(compactModel.compactFeatures(newIndex, 4), std::invalid_argument);
+}
+
+/**
+ * @test
+ * @brief Tests that sparse scoring matches a dense dot product
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, SparseScoreMatchesDenseDotProduct) {
+    blahajpi::models::LinearModel model("hinge", 0.001, 10, 0.1);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+    
+    auto dense = vectorizer.transform(texts);
+    const auto& weights = model.getWeights();
+    
+    for (size_t i = 0; i < dense.size(); ++i) {
+        double expected = model.getBias();
+        for (size_t j = 0; j < weights.size(); ++j) {
+            expected += weights[j] * dense[i][j];
+        }
+        EXPECT_NEAR(model.decision(features[i]), expected, 1e-12);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests training one batch at a time
+ * @ingroup linear_model_tests
+ * 
+ * Verifies that repeated passes of partialFit() over two batches learn
+ * the training data, and that the feature dimension cannot change.
+ */
+TEST_F(LinearModelTest, PartialFitLearnsAcrossBatches) {
+    std::vector<blahajpi::preprocessing::SparseVector> firstRows(features.begin(), features.begin() + 4);
+    std::vector<blahajpi::preprocessing::SparseVector> secondRows(features.begin() + 4, features.end());
+    std::vector<int> firstLabels(labels.begin(), labels.begin() + 4);
+    std::vector<int> secondLabels(labels.begin() + 4, labels.end());
+    
+    blahajpi::models::LinearModel model("log", 0.0001, 1, 0.5);
+    for (int epoch = 0; epoch < 50; ++epoch) {
+        model.partialFit(firstRows, firstLabels, vectorizer.getNumFeatures());
+        model.partialFit(secondRows, secondLabels, vectorizer.getNumFeatures());
+    }
+    
+    EXPECT_EQ(model.getNumFeatures(), vectorizer.getNumFeatures());
+    EXPECT_DOUBLE_EQ(model.score(features, labels), 1.0);
+    EXPECT_EQ(model.predict(features)[0], 4);
+    
+    EXPECT_THROW(model.partialFit(firstRows, firstLabels, vectorizer.getNumFeatures() + 1),
+                 std::invalid_argument);
+}
+
+/**
+ * @test
+ * @brief Tests multi-threaded mini-batch training
+ * @ingroup linear_model_tests
+ * 
+ * Verifies that mini-batches learn the training data and that the
+ * weights do not depend on the number of threads.
+ */
+TEST_F(LinearModelTest, MiniBatchTrainingIgnoresThreadCount) {
+    blahajpi::models::LinearModel serial("log", 0.0001, 100, 0.5);
+    serial.setTrainingOptions({.batchSize = 3, .threads = 1});
+    serial.fit(features, labels, vectorizer.getNumFeatures());
+   
+    blahajpi::models::LinearModel parallel("log", 0.0001, 100, 0.5);
+    parallel.setTrainingOptions({.batchSize = 3, .threads = 4});
+    parallel.fit(features, labels, vectorizer.getNumFeatures());
+   
+    EXPECT_DOUBLE_EQ(serial.score(features, labels), 1.0);
+    EXPECT_EQ(parallel.getWeights(), serial.getWeights());
+    EXPECT_DOUBLE_EQ(parallel.getBias(), serial.getBias());
+}
+
+/**
+ * @test
+ * @brief Tests early stopping on a held-out split
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, EarlyStoppingEndsTraining) {
+    blahajpi::models::LinearModel model("log", 0.0001, 500, 0.5);
+    model.setTrainingOptions({.validationFraction = 0.25, .patience = 3, .tolerance = 0.01});
+    model.fit(features, labels, vectorizer.getNumFeatures());
+   
+    EXPECT_GT(model.getEpochsRun(), 3);
+    EXPECT_LT(model.getEpochsRun(), 500);
+   
+    blahajpi::models::LinearModel full("log", 0.0001, 20, 0.5);
+    full.fit(features, labels, vectorizer.getNumFeatures());
+    EXPECT_EQ(full.getEpochsRun(), 20);
+   
+    EXPECT_THROW(model.setTrainingOptions({.validationFraction = 1.0}), std::invalid_argument);
+}
+
+/**
+ * @test
+ * @brief Tests serialization and deserialization
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, SaveAndLoad) {
+    blahajpi::models::LinearModel model("log", 0.0001, 20, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+    
+    std::string filePath = (tempDir / "linear_model.bin").string();
+    ASSERT_TRUE(model.save(filePath));
+    EXPECT_TRUE(blahajpi::models::LinearModel::isModelFile(filePath));
+    
+    blahajpi::models::LinearModel loaded;
+    ASSERT_TRUE(loaded.load(filePath));
+    EXPECT_EQ(loaded.predict(features), model.predict(features));
+    EXPECT_DOUBLE_EQ(loaded.getBias(), model.getBias());
+    EXPECT_EQ(loaded.getWeights(), model.getWeights());
+}
+
+/**
+ * @test
+ * @brief Tests error handling for invalid input
+ * @ingroup linear_model_tests
+ */
+TEST_F(LinearModelTest, RejectsInvalidInput) {
+    EXPECT_THROW(blahajpi::models::LinearModel("squared"), std::invalid_argument);
+    
+    blahajpi::models::LinearModel model;
+    EXPECT_THROW(model.fit(features, {0, 4}, vectorizer.getNumFeatures()), std::invalid_argument);
+    
+    std::string garbagePath = (tempDir / "garbage.bin").string();
+    std::ofstream(garbagePath) << "not a model";
+    EXPECT_FALSE(blahajpi::models::LinearModel::isModelFile(garbagePath));
+    EXPECT_FALSE(model.load(garbagePath));
+}
+
+} // namespace
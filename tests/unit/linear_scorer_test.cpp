@@ -0,0 +1,297 @@
+/**
+ * @file linear_scorer_test.cpp
+ * @brief Unit tests for the LinearScorer class
+ * @ingroup tests
+ * @defgroup linear_scorer_tests Linear Scorer Tests
+ *
+ * Contains tests checking that fused scoring matches scoring the
+ * vectorizer's feature vectors, and that classifier weights can be probed.
+ */
+
+#include "blahajpi/models/linear_scorer.hpp"
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/models/sgd.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include "toy_corpus.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Test fixture for LinearScorer tests
+ * @ingroup linear_scorer_tests
+ *
+ * Provides the shared toy corpus and queries with unseen terms and
+ * repeated words.
+ */
+class LinearScorerTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Set up test data
+     */
+    void SetUp() override {
+        queries = texts;
+        queries.push_back("awful awful awful lovely");
+        queries.push_back("completely unseen words");
+        queries.push_back("");
+    }
+
+    /**
+     * @brief Checks fused scores against the model on transformSparse() output
+     * @param vectorizer Fitted vectorizer
+     */
+    void expectMatchesSparseScoring(const blahajpi::preprocessing::Vectorizer& vectorizer) {
+        auto features = vectorizer.transformSparse(texts);
+        blahajpi::models::LinearModel model("log", 0.001, 20, 0.5);
+        model.fit(features, labels, vectorizer.getNumFeatures());
+
+        blahajpi::models::LinearScorer scorer;
+        ASSERT_TRUE(scorer.build(vectorizer, model.getWeights(), model.getBias()));
+
+        auto queryFeatures = vectorizer.transformSparse(queries);
+        auto probabilities = model.predictProbability(queryFeatures);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            double fused = scorer.decision(queries[i]);
+            EXPECT_NEAR(fused, model.decision(queryFeatures[i]), 1e-9) << queries[i];
+            EXPECT_NEAR(blahajpi::models::LinearScorer::logistic(fused), probabilities[i], 1e-9);
+        }
+    }
+
+    std::vector<std::string> texts = blahajpi::test::TOY_TEXTS;
+    std::vector<int> labels = blahajpi::test::TOY_LABELS;
+    std::vector<std::string> queries;
+};
+
+/**
+ * @test
+ * @brief Tests fused scoring with a TF-IDF vectorizer
+ * @ingroup linear_scorer_tests
+ *
+ * Verifies that the fused score equals the linear model's score on the
+ * normalized TF-IDF vector, including out-of-vocabulary and empty input.
+ */
+TEST_F(LinearScorerTest, MatchesTfidfScoring) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+
+    // The stored IDF table matches the smoothed IDF formula
+    const auto& idf = vectorizer.getIdfWeights();
+    const auto& frequencies = vectorizer.getDocumentFrequencies();
+    ASSERT_EQ(idf.size(), frequencies.size());
+    for (size_t i = 0; i < idf.size(); ++i) {
+        EXPECT_DOUBLE_EQ(idf[i], std::log((texts.size() + 1.0) / (frequencies[i] + 1.0)) + 1.0);
+    }
+
+    expectMatchesSparseScoring(vectorizer);
+}
+
+/**
+ * @test
+ * @brief Tests fused scoring with a signed hashing vectorizer
+ * @ingroup linear_scorer_tests
+ *
+ * Verifies that signed term counts are handled like transformSparse().
+ */
+TEST_F(LinearScorerTest, MatchesHashingScoring) {
+    blahajpi::preprocessing::HashingVectorizer vectorizer(true, 4, 1, 2, true, 3);
+    vectorizer.fit(texts);
+    expectMatchesSparseScoring(vectorizer);
+}
+
+/**
+ * @test
+ * @brief Tests key terms picked from weighted feature contributions
+ * @ingroup linear_scorer_tests
+ *
+ * Verifies that explain() returns the same score as decision() and the
+ * strongest contributions toward the predicted class, each equal to the
+ * feature value times its weight and pointing at the term in the text.
+ */
+TEST_F(LinearScorerTest, ExplainsWithContributions) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+    auto features = vectorizer.transformSparse(texts);
+    blahajpi::models::LinearModel model("log", 0.001, 20, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    blahajpi::models::LinearScorer scorer;
+    ASSERT_TRUE(scorer.build(vectorizer, model.getWeights(), model.getBias()));
+    const auto& vocabulary = vectorizer.getVocabulary();
+
+    std::vector<blahajpi::models::TermContribution> terms;
+    for (const auto& query : queries) {
+        double score = scorer.explain(query, 3, terms);
+        EXPECT_NEAR(score, scorer.decision(query), 1e-12) << query;
+        ASSERT_LE(terms.size(), 3u);
+
+        // Every contribution toward the predicted class, strongest first
+        auto row = vectorizer.transformSparse({query})[0];
+        std::vector<double> expected;
+        for (size_t i = 0; i < row.indices.size(); ++i) {
+            double contribution = row.values[i] * model.getWeights()[row.indices[i]];
+            if (score > 0.0 ? contribution > 0.0 : contribution < 0.0) {
+                expected.push_back(std::abs(contribution));
+            }
+        }
+        std::sort(expected.rbegin(), expected.rend());
+        ASSERT_EQ(terms.size(), std::min<size_t>(3, expected.size())) << query;
+
+        for (size_t i = 0; i < terms.size(); ++i) {
+            EXPECT_NEAR(std::abs(terms[i].contribution), expected[i], 1e-12);
+            EXPECT_EQ(terms[i].contribution > 0.0, score > 0.0);
+
+            // Terms are slices of the query; vocabulary n-grams join words with underscores
+            ASSERT_GE(terms[i].term.data(), query.data());
+            ASSERT_LE(terms[i].term.data() + terms[i].term.size(), query.data() + query.size());
+            std::string key(terms[i].term);
+            std::replace(key.begin(), key.end(), ' ', '_');
+            ASSERT_EQ(vocabulary.count(key), 1u) << key;
+            int index = vocabulary.at(key);
+            for (size_t j = 0; j < row.indices.size(); ++j) {
+                if (row.indices[j] == index) {
+                    EXPECT_NEAR(terms[i].contribution, row.values[j] * model.getWeights()[index], 1e-12);
+                }
+            }
+        }
+    }
+
+    double score = scorer.explain("awful awful awful lovely", 1, terms);
+    ASSERT_GT(score, 0.0);
+    ASSERT_EQ(terms.size(), 1u);
+    EXPECT_EQ(terms[0].term.find("awful"), 0u);
+
+    // Hashed features have no vocabulary, but still point back at the text
+    blahajpi::preprocessing::HashingVectorizer hashing(true, 8, 1, 2, true, 3);
+    hashing.fit(texts);
+    auto hashed = hashing.transformSparse(texts);
+    model.fit(hashed, labels, hashing.getNumFeatures());
+    ASSERT_TRUE(scorer.build(hashing, model.getWeights(), model.getBias()));
+    std::string query = "gross awful content";
+    EXPECT_NEAR(scorer.explain(query, 5, terms), scorer.decision(query), 1e-12);
+    EXPECT_FALSE(terms.empty());
+    for (const auto& term : terms) {
+        EXPECT_NE(query.find(term.term), std::string::npos);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests that build() rejects mismatched weights
+ * @ingroup linear_scorer_tests
+ */
+TEST_F(LinearScorerTest, RejectsMismatchedWeights) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+
+    blahajpi::models::LinearScorer scorer;
+    EXPECT_FALSE(scorer.build(vectorizer, std::vector<double>(vectorizer.getNumFeatures() + 1, 0.0), 0.0));
+    EXPECT_FALSE(scorer.isReady());
+}
+
+/**
+ * @test
+ * @brief Tests probing the weights of an SGD classifier
+ * @ingroup linear_scorer_tests
+ *
+ * Verifies that probed weights reproduce the classifier's scores and
+ * survive a round trip through a model bundle.
+ */
+TEST_F(LinearScorerTest, ProbesSgdClassifier) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+    auto features = vectorizer.transformSparse(texts);
+
+    blahajpi::models::SGDClassifier model("log", 0.001, 20, 0.5);
+    model.fit(blahajpi::preprocessing::toDenseMatrix(features, vectorizer.getNumFeatures()), labels);
+
+    std::vector<double> weights;
+    double bias = 0.0;
+    ASSERT_TRUE(blahajpi::models::LinearScorer::extractWeights(
+        model, vectorizer.getNumFeatures(), weights, bias));
+
+    blahajpi::models::LinearScorer scorer;
+    ASSERT_TRUE(scorer.build(vectorizer, weights, bias));
+
+    auto queryFeatures = vectorizer.transformSparse(queries);
+    auto expected = model.decisionFunction(
+        blahajpi::preprocessing::toDenseMatrix(queryFeatures, vectorizer.getNumFeatures()));
+    for (size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_NEAR(scorer.decision(queries[i]), expected[i], 1e-9);
+    }
+
+    auto bundlePath = (std::filesystem::temp_directory_path() / "blahajpi_scorer_test.bpi").string();
+    blahajpi::utils::BundleWriter writer;
+    vectorizer.writeBundle(writer);
+    scorer.writeBundle(writer);
+    ASSERT_TRUE(writer.write(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+    auto loadedVectorizer = blahajpi::preprocessing::Vectorizer::loadFromBundle(reader);
+    ASSERT_NE(loadedVectorizer, nullptr);
+
+    blahajpi::models::LinearScorer loaded;
+    ASSERT_TRUE(loaded.readBundle(reader, *loadedVectorizer));
+    for (const auto& query : queries) {
+        EXPECT_DOUBLE_EQ(loaded.decision(query), scorer.decision(query));
+    }
+    std::filesystem::remove(bundlePath);
+}
+
+/**
+ * @test
+ * @brief Tests scoring and bundles with quantized weights
+ * @ingroup linear_scorer_tests
+ *
+ * Verifies that int8 and float16 folded weights stay close to double
+ * scoring, and that a quantized linear model bundle restores the same
+ * scores and precision.
+ */
+TEST_F(LinearScorerTest, QuantizedWeights) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+    auto features = vectorizer.transformSparse(texts);
+    blahajpi::models::LinearModel model("log", 0.001, 20, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    blahajpi::models::LinearScorer exact;
+    ASSERT_TRUE(exact.build(vectorizer, model.getWeights(), model.getBias()));
+
+    for (auto precision : {blahajpi::models::WeightPrecision::Float16, blahajpi::models::WeightPrecision::Int8}) {
+        blahajpi::models::LinearScorer scorer;
+        ASSERT_TRUE(scorer.build(vectorizer, model.getWeights(), model.getBias(), precision));
+        EXPECT_EQ(scorer.getPrecision(), precision);
+        for (const auto& query : queries) {
+            EXPECT_NEAR(scorer.decision(query), exact.decision(query), 0.05) << query;
+            EXPECT_EQ(scorer.decision(query) > 0.0, exact.decision(query) > 0.0) << query;
+        }
+    }
+
+    blahajpi::models::LinearModel quantized = model;
+    quantized.setWeightPrecision(blahajpi::models::WeightPrecision::Int8);
+
+    auto bundlePath = (std::filesystem::temp_directory_path() / "blahajpi_quantized_test.bpi").string();
+    blahajpi::utils::BundleWriter writer;
+    vectorizer.writeBundle(writer);
+    quantized.writeBundle(writer);
+    ASSERT_TRUE(writer.write(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+    EXPECT_FALSE(reader.hasSection("WGHT"));
+
+    blahajpi::models::LinearModel loaded;
+    ASSERT_TRUE(loaded.readBundle(reader));
+    EXPECT_EQ(loaded.getWeightPrecision(), blahajpi::models::WeightPrecision::Int8);
+    EXPECT_EQ(loaded.getWeights(), quantized.getWeights());
+    EXPECT_EQ(loaded.predict(features), model.predict(features));
+    std::filesystem::remove(bundlePath);
+}
+
+} // namespace
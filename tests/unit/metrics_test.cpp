@@ -13,6 +13,8 @@
 #include <vector>
 #include <unordered_map>
 #include <cmath>
+#include <random>
+#include <stdexcept>
 
 namespace {
 
@@ -136,4 +138,151 @@ TEST_F(MetricsTest, EmptyInputHandling) {
     });
 }
 
+/**
+ * @test
+ * @brief Tests the single-sweep evaluation
+ * @ingroup metrics_tests
+ * 
+ * Verifies the AUC, the best threshold and the confusion matrix at it on
+ * a small hand-checked example, and that the older functions agree.
+ */
+TEST_F(MetricsTest, Evaluate) {
+    using blahajpi::evaluation::Metrics;
+    std::vector<int> yTrue = {0, 0, 4, 4, 0, 4};
+    std::vector<double> scores = {0.1, 0.4, 0.35, 0.8, 0.5, 0.9};
+
+    auto result = Metrics::evaluate(yTrue, scores);
+    EXPECT_NEAR(result.auc, 7.0 / 9.0, 1e-12);
+    EXPECT_DOUBLE_EQ(result.threshold, 0.5);
+    EXPECT_NEAR(result.thresholdMetric, 0.8, 1e-12);
+    std::vector<std::vector<int>> expectedConfusion = {{3, 0}, {1, 2}};
+    EXPECT_EQ(result.confusion, expectedConfusion);
+    EXPECT_NEAR(result.metrics["f1_harmful"], 0.8, 1e-12);
+    EXPECT_DOUBLE_EQ(result.precisionAtRecall[0.5], 1.0);
+    EXPECT_DOUBLE_EQ(result.precisionAtRecall[0.95], 0.6);
+
+    EXPECT_DOUBLE_EQ(Metrics::areaUnderROC(yTrue, scores), result.auc);
+    EXPECT_DOUBLE_EQ(Metrics::findOptimalThreshold(yTrue, scores), result.threshold);
+    EXPECT_EQ(Metrics::precisionRecallCurve(yTrue, scores, {0.5, 0.95}).at(0.95), 0.6);
+
+    // One class only
+    auto oneClass = Metrics::evaluate({0, 0, 0}, {0.1, 0.2, 0.3});
+    EXPECT_DOUBLE_EQ(oneClass.auc, 0.5);
+    EXPECT_TRUE(oneClass.precisionAtRecall.empty());
+}
+
+/**
+ * @test
+ * @brief Tests the AUC against a hand count with several negatives
+ * @ingroup metrics_tests
+ * 
+ * Ranked by score the labels read P N P N N P N, so the positives
+ * outrank 4, 3 and 1 of the 4 negatives: 8 of 12 pairs. The AUC used to
+ * subtract a negative count from a rate and came out as -61/6 here.
+ */
+TEST_F(MetricsTest, AreaUnderROCSeveralNegatives) {
+    using blahajpi::evaluation::Metrics;
+    std::vector<int> yTrue = {4, 0, 4, 0, 0, 4, 0};
+    std::vector<double> scores = {0.9, 0.8, 0.7, 0.6, 0.5, 0.4, 0.3};
+
+    EXPECT_NEAR(Metrics::areaUnderROC(yTrue, scores), 8.0 / 12.0, 1e-12);
+
+    // Input order does not matter
+    std::vector<int> shuffledTrue = {0, 4, 0, 4, 0, 0, 4};
+    std::vector<double> shuffledScores = {0.3, 0.4, 0.5, 0.7, 0.6, 0.8, 0.9};
+    EXPECT_NEAR(Metrics::areaUnderROC(shuffledTrue, shuffledScores), 8.0 / 12.0, 1e-12);
+}
+
+/**
+ * @test
+ * @brief Tests tied scores and the parallel sort
+ * @ingroup metrics_tests
+ * 
+ * Verifies that the AUC counts tied pairs as half, matching the pairwise
+ * definition, and that sorting with several threads changes nothing.
+ */
+TEST_F(MetricsTest, EvaluateTiesAndThreads) {
+    using blahajpi::evaluation::Metrics;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coarse(0, 20);
+
+    std::vector<int> yTrue(400);
+    std::vector<double> scores(400);
+    for (size_t i = 0; i < yTrue.size(); ++i) {
+        yTrue[i] = (rng() % 3 == 0) ? 4 : 0;
+        scores[i] = coarse(rng) / 20.0 + (yTrue[i] != 0 ? 0.1 : 0.0);
+    }
+
+    double wins = 0.0;
+    double pairs = 0.0;
+    for (size_t i = 0; i < yTrue.size(); ++i) {
+        for (size_t j = 0; j < yTrue.size(); ++j) {
+            if (yTrue[i] != 0 && yTrue[j] == 0) {
+                wins += scores[i] > scores[j] ? 1.0 : (scores[i] == scores[j] ? 0.5 : 0.0);
+                pairs += 1.0;
+            }
+        }
+    }
+    EXPECT_NEAR(Metrics::evaluate(yTrue, scores).auc, wins / pairs, 1e-12);
+
+    // Large enough to be split across sort workers
+    std::uniform_real_distribution<double> noise(0.0, 1.0);
+    yTrue.resize(300000);
+    scores.resize(300000);
+    for (size_t i = 0; i < yTrue.size(); ++i) {
+        yTrue[i] = (i % 5 < 2) ? 4 : 0;
+        scores[i] = noise(rng) + (yTrue[i] != 0 ? 0.2 : 0.0);
+    }
+    auto serial = Metrics::evaluate(yTrue, scores, "accuracy", {0.5}, 1);
+    auto parallel = Metrics::evaluate(yTrue, scores, "accuracy", {0.5}, 4);
+    EXPECT_EQ(serial.auc, parallel.auc);
+    EXPECT_EQ(serial.threshold, parallel.threshold);
+    EXPECT_EQ(serial.confusion, parallel.confusion);
+    EXPECT_EQ(serial.precisionAtRecall, parallel.precisionAtRecall);
+}
+
+/**
+ * @test
+ * @brief Tests the binned approximate evaluation
+ * @ingroup metrics_tests
+ * 
+ * Verifies that a histogram filled in two parts and merged approximates
+ * the exact AUC, and that mismatched histograms cannot be merged.
+ */
+TEST_F(MetricsTest, ScoreHistogram) {
+    using blahajpi::evaluation::Metrics;
+    using blahajpi::evaluation::ScoreHistogram;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> noise(0.0, 0.8);
+
+    std::vector<int> yTrue(20000);
+    std::vector<double> scores(20000);
+    for (size_t i = 0; i < yTrue.size(); ++i) {
+        yTrue[i] = (i % 3 == 0) ? 4 : 0;
+        scores[i] = noise(rng) + (yTrue[i] != 0 ? 0.2 : 0.0);
+    }
+
+    ScoreHistogram first;
+    ScoreHistogram second;
+    for (size_t i = 0; i < yTrue.size(); ++i) {
+        (i % 2 == 0 ? first : second).add(yTrue[i], scores[i]);
+    }
+    first.merge(second);
+    EXPECT_EQ(first.size(), yTrue.size());
+
+    auto exact = Metrics::evaluate(yTrue, scores);
+    auto approximate = first.evaluate();
+    EXPECT_NEAR(approximate.auc, exact.auc, 1e-3);
+    EXPECT_NEAR(approximate.thresholdMetric, exact.thresholdMetric, 1e-2);
+    EXPECT_NEAR(approximate.threshold, exact.threshold, 0.05);
+
+    // Out-of-range scores land in the end bins
+    ScoreHistogram clamped(0.0, 1.0, 4);
+    clamped.add({0, 4}, {-3.0, 7.0});
+    EXPECT_DOUBLE_EQ(clamped.evaluate().auc, 1.0);
+
+    EXPECT_THROW(first.merge(ScoreHistogram(0.0, 1.0, 16)), std::invalid_argument);
+    EXPECT_THROW(ScoreHistogram(1.0, 1.0), std::invalid_argument);
+}
+
 } // namespace
@@ -0,0 +1,145 @@
+/**
+ * @file mlp_model_test.cpp
+ * @brief Unit tests for the MlpModel class
+ * @ingroup tests
+ * @defgroup mlp_model_tests Sparse Neural Network Tests
+ *
+ * Contains tests for the neural network that trains and scores directly
+ * on the vectorizer's sparse output.
+ */
+
+#include "blahajpi/models/mlp_model.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include "toy_corpus.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Test fixture for MlpModel tests
+ * @ingroup mlp_model_tests
+ *
+ * Uses the shared toy corpus and a scratch directory for saved
+ * networks.
+ */
+class MlpModelTest : public ::testing::Test, protected blahajpi::test::ToyCorpus {
+protected:
+    /**
+     * @brief Set up the temporary directory
+     */
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "blahajpi_tests";
+        std::filesystem::create_directories(tempDir);
+    }
+
+    /**
+     * @brief Clean up temporary files
+     */
+    void TearDown() override {
+        if (std::filesystem::exists(tempDir)) {
+            std::filesystem::remove_all(tempDir);
+        }
+    }
+
+    /** Temporary directory for file operations */
+    std::filesystem::path tempDir;
+};
+
+/**
+ * @test
+ * @brief Tests training and prediction on sparse rows
+ * @ingroup mlp_model_tests
+ */
+TEST_F(MlpModelTest, LearnsSeparableData) {
+    blahajpi::models::MlpModel model(2, 8, 200, 0.05);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    EXPECT_EQ(model.getNumFeatures(), vectorizer.getNumFeatures());
+    EXPECT_DOUBLE_EQ(model.score(features, labels), 1.0);
+    EXPECT_EQ(model.predict(features)[0], 4);
+    EXPECT_EQ(model.predict(features)[3], 0);
+
+    auto probabilities = model.predictProbability(features);
+    auto scores = model.decisionFunction(features);
+    for (size_t i = 0; i < probabilities.size(); ++i) {
+        EXPECT_NEAR(probabilities[i], 1.0 / (1.0 + std::exp(-scores[i])), 1e-12);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests that block scoring matches scoring one row at a time
+ * @ingroup mlp_model_tests
+ *
+ * Also checks that the float32 path stays close to double precision.
+ */
+TEST_F(MlpModelTest, BatchScoringMatchesSingleRows) {
+    blahajpi::models::MlpModel model(2, 8, 20, 0.05);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    // More rows than one inference block
+    std::vector<blahajpi::preprocessing::SparseVector> rows;
+    for (int copy = 0; copy < 20; ++copy) {
+        rows.insert(rows.end(), features.begin(), features.end());
+    }
+
+    auto batch = model.decisionFunction(rows);
+    ASSERT_EQ(batch.size(), rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_DOUBLE_EQ(batch[i], model.decisionFunction({rows[i]})[0]);
+    }
+
+    model.setFloat32(true);
+    EXPECT_TRUE(model.usesFloat32());
+    auto single = model.decisionFunction(rows);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_NEAR(single[i], batch[i], 1e-4);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests serialization and deserialization
+ * @ingroup mlp_model_tests
+ */
+TEST_F(MlpModelTest, SaveAndLoad) {
+    blahajpi::models::MlpModel model(2, 8, 20, 0.05);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    std::string filePath = (tempDir / "mlp_model.bin").string();
+    ASSERT_TRUE(model.save(filePath));
+    EXPECT_TRUE(blahajpi::models::MlpModel::isModelFile(filePath));
+
+    blahajpi::models::MlpModel loaded;
+    ASSERT_TRUE(loaded.load(filePath));
+    EXPECT_EQ(loaded.getHiddenLayers(), 2);
+    EXPECT_EQ(loaded.getHiddenSize(), 8);
+    EXPECT_EQ(loaded.decisionFunction(features), model.decisionFunction(features));
+    EXPECT_EQ(loaded.predict(features), model.predict(features));
+}
+
+/**
+ * @test
+ * @brief Tests error handling for invalid input
+ * @ingroup mlp_model_tests
+ */
+TEST_F(MlpModelTest, RejectsInvalidInput) {
+    EXPECT_THROW(blahajpi::models::MlpModel(0, 8), std::invalid_argument);
+    EXPECT_THROW(blahajpi::models::MlpModel(1, 0), std::invalid_argument);
+
+    blahajpi::models::MlpModel model;
+    EXPECT_THROW(model.fit(features, {0, 4}, vectorizer.getNumFeatures()), std::invalid_argument);
+
+    std::string garbagePath = (tempDir / "garbage.bin").string();
+    std::ofstream(garbagePath) << "not a model";
+    EXPECT_FALSE(blahajpi::models::MlpModel::isModelFile(garbagePath));
+    EXPECT_FALSE(model.load(garbagePath));
+}
+
+} // namespace
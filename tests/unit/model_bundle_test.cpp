@@ -0,0 +1,234 @@
+/**
+ * @file model_bundle_test.cpp
+ * @brief Unit tests for the model bundle format
+ * @ingroup tests
+ * @defgroup model_bundle_tests Model Bundle Tests
+ *
+ * Contains tests for the section writer and reader, integrity checks, and
+ * round trips of vectorizers and linear models through a bundle.
+ */
+
+#include "blahajpi/utils/model_bundle.hpp"
+#include "blahajpi/models/linear_model.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include "toy_corpus.hpp"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Test fixture for model bundle tests
+ * @ingroup model_bundle_tests
+ *
+ * Provides a temporary directory and the shared toy corpus.
+ */
+class ModelBundleTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Set up test data and directories
+     */
+    void SetUp() override {
+        tempDir = std::filesystem::temp_directory_path() / "blahajpi_bundle_tests";
+        std::filesystem::create_directories(tempDir);
+        bundlePath = (tempDir / "model.bpi").string();
+    }
+
+    /**
+     * @brief Clean up temporary files
+     */
+    void TearDown() override {
+        if (std::filesystem::exists(tempDir)) {
+            std::filesystem::remove_all(tempDir);
+        }
+    }
+
+    /**
+     * @brief Overwrites one byte of the bundle file
+     * @param offset Byte offset
+     * @param value New value
+     */
+    void patchByte(size_t offset, char value) {
+        std::fstream file(bundlePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.put(value);
+    }
+
+    std::filesystem::path tempDir;
+    std::string bundlePath;
+    std::vector<std::string> texts = blahajpi::test::TOY_TEXTS;
+    std::vector<int> labels = blahajpi::test::TOY_LABELS;
+};
+
+/**
+ * @test
+ * @brief Tests the CRC-32 implementation
+ * @ingroup model_bundle_tests
+ *
+ * Verifies the standard check value of CRC-32/IEEE.
+ */
+TEST_F(ModelBundleTest, Crc32CheckValue) {
+    std::string input = "123456789";
+    EXPECT_EQ(blahajpi::utils::crc32(reinterpret_cast<const unsigned char*>(input.data()), input.size()),
+              0xCBF43926u);
+}
+
+/**
+ * @test
+ * @brief Tests writing and reading sections
+ * @ingroup model_bundle_tests
+ *
+ * Verifies that values round-trip, sections are aligned, and reads past
+ * the end of a section are reported.
+ */
+TEST_F(ModelBundleTest, SectionRoundTrip) {
+    blahajpi::utils::BundleWriter writer;
+    auto& first = writer.addSection("TST1");
+    first.writeU32(42);
+    first.writeI64(-7);
+    first.writeF64(0.25);
+    first.writeString("hello");
+    writer.addSection("TST2").writeF64Array({1.5, -2.5, 3.5});
+
+    EXPECT_THROW(writer.addSection("TST1"), std::invalid_argument);
+    EXPECT_THROW(writer.addSection("TOOLONG"), std::invalid_argument);
+    ASSERT_TRUE(writer.write(bundlePath));
+    EXPECT_FALSE(std::filesystem::exists(bundlePath + ".tmp"));
+
+    ASSERT_TRUE(blahajpi::utils::BundleReader::isBundleFile(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+    EXPECT_EQ(reader.getVersion(), blahajpi::utils::BundleReader::FORMAT_VERSION);
+    EXPECT_TRUE(reader.hasSection("TST1"));
+    EXPECT_FALSE(reader.hasSection("NONE"));
+
+    auto section = reader.section("TST2");
+    auto offset = section.data() - reader.getFile()->data();
+    EXPECT_EQ(offset % blahajpi::utils::BundleReader::SECTION_ALIGNMENT, 0);
+
+    auto values = reader.reader("TST1");
+    EXPECT_EQ(values.readU32(), 42u);
+    EXPECT_EQ(values.readI64(), -7);
+    EXPECT_DOUBLE_EQ(values.readF64(), 0.25);
+    EXPECT_EQ(values.readString(), "hello");
+    EXPECT_TRUE(values.ok());
+    EXPECT_EQ(values.remaining(), 0u);
+
+    values.readU32();
+    EXPECT_FALSE(values.ok());
+
+    auto arrays = reader.reader("TST2");
+    EXPECT_EQ(arrays.readF64Array(3), (std::vector<double>{1.5, -2.5, 3.5}));
+    EXPECT_TRUE(arrays.readF64Array(1).empty());
+    EXPECT_FALSE(arrays.ok());
+}
+
+/**
+ * @test
+ * @brief Tests that damaged bundles are rejected
+ * @ingroup model_bundle_tests
+ *
+ * Verifies that a flipped payload byte and an unsupported version both
+ * make open() fail.
+ */
+TEST_F(ModelBundleTest, RejectsCorruptBundles) {
+    blahajpi::utils::BundleWriter writer;
+    writer.addSection("DATA").writeString("payload bytes");
+    ASSERT_TRUE(writer.write(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+    size_t payloadOffset = reader.section("DATA").data() - reader.getFile()->data();
+
+    patchByte(payloadOffset + 6, 'X');
+    EXPECT_FALSE(reader.open(bundlePath));
+
+    ASSERT_TRUE(writer.write(bundlePath));
+    patchByte(8, 99);  // Format version
+    EXPECT_FALSE(reader.open(bundlePath));
+
+    std::ofstream(bundlePath, std::ios::trunc) << "not a bundle";
+    EXPECT_FALSE(reader.open(bundlePath));
+}
+
+/**
+ * @test
+ * @brief Tests storing a TF-IDF vectorizer and linear model in a bundle
+ * @ingroup model_bundle_tests
+ *
+ * Verifies that the restored vectorizer and model reproduce the original
+ * features and scores.
+ */
+TEST_F(ModelBundleTest, TfidfAndLinearModelRoundTrip) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+    vectorizer.fit(texts);
+    auto features = vectorizer.transformSparse(texts);
+
+    blahajpi::models::LinearModel model("log", 0.001, 20, 0.5);
+    model.fit(features, labels, vectorizer.getNumFeatures());
+
+    blahajpi::utils::BundleWriter writer;
+    vectorizer.writeBundle(writer);
+    model.writeBundle(writer);
+    ASSERT_TRUE(writer.write(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+
+    auto loadedVectorizer = blahajpi::preprocessing::Vectorizer::loadFromBundle(reader);
+    ASSERT_NE(loadedVectorizer, nullptr);
+    auto* tfidf = dynamic_cast<blahajpi::preprocessing::TfidfVectorizer*>(loadedVectorizer.get());
+    ASSERT_NE(tfidf, nullptr);
+    EXPECT_EQ(tfidf->getVocabulary(), vectorizer.getVocabulary());
+    EXPECT_EQ(tfidf->getDocumentFrequencies(), vectorizer.getDocumentFrequencies());
+
+    blahajpi::models::LinearModel loadedModel;
+    ASSERT_TRUE(loadedModel.readBundle(reader));
+
+    auto loadedFeatures = loadedVectorizer->transformSparse(texts);
+    ASSERT_EQ(loadedFeatures.size(), features.size());
+    for (size_t i = 0; i < features.size(); ++i) {
+        EXPECT_EQ(loadedFeatures[i].indices, features[i].indices);
+        EXPECT_EQ(loadedFeatures[i].values, features[i].values);
+        EXPECT_DOUBLE_EQ(loadedModel.decision(loadedFeatures[i]), model.decision(features[i]));
+    }
+}
+
+/**
+ * @test
+ * @brief Tests storing a hashing vectorizer in a bundle
+ * @ingroup model_bundle_tests
+ *
+ * Verifies that the bundle restores the hashing vectorizer kind and its
+ * per-bucket statistics.
+ */
+TEST_F(ModelBundleTest, HashingVectorizerRoundTrip) {
+    blahajpi::preprocessing::HashingVectorizer vectorizer(true, 12, 1, 3, true, 5);
+    vectorizer.fit(texts);
+
+    blahajpi::utils::BundleWriter writer;
+    vectorizer.writeBundle(writer);
+    ASSERT_TRUE(writer.write(bundlePath));
+
+    blahajpi::utils::BundleReader reader;
+    ASSERT_TRUE(reader.open(bundlePath));
+    EXPECT_FALSE(reader.hasSection("LMOD"));
+
+    auto loaded = blahajpi::preprocessing::Vectorizer::loadFromBundle(reader);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_NE(dynamic_cast<blahajpi::preprocessing::HashingVectorizer*>(loaded.get()), nullptr);
+    EXPECT_EQ(loaded->getNumFeatures(), 4096u);
+
+    auto expected = vectorizer.transformSparse(texts);
+    auto actual = loaded->transformSparse(texts);
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].indices, expected[i].indices);
+        EXPECT_EQ(actual[i].values, expected[i].values);
+    }
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+/**
+ * @file near_duplicate_index_test.cpp
+ * @brief Unit tests for the MinHash signatures and the near-duplicate index
+ * @ingroup tests
+ * @defgroup near_duplicate_index_tests Near-Duplicate Index Tests
+ *
+ * Contains tests for similarity estimates, banded lookup, member counts
+ * and eviction.
+ */
+
+#include "blahajpi/utils/near_duplicate_index.hpp"
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace blahajpi::utils;
+
+/**
+ * @brief Builds the signature of a range of term hashes
+ * @param first First term
+ * @param count Number of terms
+ * @return Signature of the terms first to first + count - 1
+ */
+MinHashSignature termRange(uint64_t first, size_t count) {
+    std::vector<uint64_t> terms(count);
+    std::iota(terms.begin(), terms.end(), first);
+    return minHash(terms);
+}
+
+/**
+ * @test
+ * @brief Tests that signatures estimate the overlap of term sets
+ * @ingroup near_duplicate_index_tests
+ */
+TEST(NearDuplicateIndexTest, EstimatesSimilarity) {
+    auto signature = termRange(0, 100);
+    EXPECT_EQ(termRange(0, 100), signature);
+    EXPECT_DOUBLE_EQ(similarity(signature, signature), 1.0);
+
+    // Repeats do not change a set
+    std::vector<uint64_t> repeated(200);
+    std::iota(repeated.begin(), repeated.begin() + 100, 0);
+    std::iota(repeated.begin() + 100, repeated.end(), 0);
+    EXPECT_EQ(minHash(repeated), signature);
+
+    // Jaccard 90/110 and 0
+    EXPECT_NEAR(similarity(signature, termRange(10, 100)), 90.0 / 110.0, 0.15);
+    EXPECT_LT(similarity(signature, termRange(1000, 100)), 0.1);
+}
+
+/**
+ * @test
+ * @brief Tests that similar signatures are found and different ones are not
+ * @ingroup near_duplicate_index_tests
+ */
+TEST(NearDuplicateIndexTest, FindsSimilar) {
+    NearDuplicateIndex<std::string> index(100, 0.7);
+    auto signature = termRange(0, 40);
+    uint64_t id = index.insert(signature, "first");
+    EXPECT_EQ(id, NearDuplicateIndex<std::string>::clusterId(signature));
+    EXPECT_NE(id, 0u);
+
+    std::string value;
+    uint64_t cluster = 0;
+    ASSERT_TRUE(index.find(termRange(1, 40), value, cluster));
+    EXPECT_EQ(value, "first");
+    EXPECT_EQ(cluster, id);
+    EXPECT_FALSE(index.find(termRange(20, 40), value, cluster));
+    EXPECT_FALSE(index.find(termRange(500, 40), value, cluster));
+
+    // Thresholds are clamped
+    EXPECT_DOUBLE_EQ(NearDuplicateIndex<int>(1, 2.0).getThreshold(), 1.0);
+}
+
+/**
+ * @test
+ * @brief Tests member counts and joining an existing cluster
+ * @ingroup near_duplicate_index_tests
+ */
+TEST(NearDuplicateIndexTest, CountsMembers) {
+    NearDuplicateIndex<int> index(10, 0.7);
+    uint64_t id = index.insert(termRange(0, 50), 1, 3);
+    index.insert(termRange(1000, 50), 2);
+
+    int value = 0;
+    uint64_t cluster = 0;
+    ASSERT_TRUE(index.find(termRange(1, 50), value, cluster));
+    EXPECT_EQ(cluster, id);
+
+    // Similar enough to join, replacing the value
+    EXPECT_EQ(index.insert(termRange(2, 50), 5, 2), id);
+    ASSERT_TRUE(index.find(termRange(0, 50), value, cluster));
+    EXPECT_EQ(value, 5);
+    index.addMembers(id, 10);
+    index.addMembers(12345, 10);
+
+    // Values are replaced in place by cluster ID
+    EXPECT_TRUE(index.update(id, 7, 4));
+    EXPECT_FALSE(index.update(12345, 7, 4));
+    ASSERT_TRUE(index.find(termRange(0, 50), value, cluster));
+    EXPECT_EQ(value, 7);
+
+    auto clusters = index.clusters(10);
+    ASSERT_EQ(clusters.size(), 1u);
+    EXPECT_EQ(clusters[0].id, id);
+    EXPECT_EQ(clusters[0].members, 3u + 1 + 2 + 1 + 10 + 4 + 1);
+    EXPECT_EQ(index.clusters(10, 1).size(), 2u);
+    EXPECT_EQ(index.size(), 2u);
+}
+
+/**
+ * @test
+ * @brief Tests that the least recently matched cluster is dropped
+ * @ingroup near_duplicate_index_tests
+ */
+TEST(NearDuplicateIndexTest, EvictsLeastRecentlyMatched) {
+    NearDuplicateIndex<int> index(2, 0.7);
+    index.insert(termRange(0, 30), 1);
+    index.insert(termRange(1000, 30), 2);
+
+    int value = 0;
+    uint64_t cluster = 0;
+    ASSERT_TRUE(index.find(termRange(0, 30), value, cluster));
+    index.insert(termRange(2000, 30), 3);
+
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.getEvictions(), 1u);
+    EXPECT_TRUE(index.find(termRange(0, 30), value, cluster));
+    EXPECT_FALSE(index.find(termRange(1000, 30), value, cluster));
+    EXPECT_TRUE(index.find(termRange(2000, 30), value, cluster));
+    EXPECT_EQ(value, 3);
+}
+
+} // namespace
@@ -0,0 +1,140 @@
+/**
+ * @file quantization_test.cpp
+ * @brief Unit tests for reduced-precision weight tensors
+ * @ingroup tests
+ * @defgroup quantization_tests Weight Quantization Tests
+ *
+ * Contains tests for half-precision conversion, int8 quantization error
+ * and the bundle encoding of quantized tensors.
+ */
+
+#include "blahajpi/models/quantization.hpp"
+#include "blahajpi/utils/model_bundle.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+using blahajpi::models::QuantizedWeights;
+using blahajpi::models::WeightPrecision;
+
+/**
+ * @brief Draws weights spread over several orders of magnitude
+ * @return Random weights, including zero and a few large values
+ */
+std::vector<double> sampleWeights() {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> dist(0.0, 1.5);
+    std::vector<double> weights(1000);
+    for (auto& w : weights) {
+        w = dist(rng);
+    }
+    weights[0] = 0.0;
+    weights[1] = -6.25;
+    weights[2] = 1e-7;
+    return weights;
+}
+
+/**
+ * @test
+ * @brief Tests conversions to and from half precision
+ * @ingroup quantization_tests
+ */
+TEST(QuantizationTest, HalfPrecisionConversion) {
+    EXPECT_EQ(QuantizedWeights::toHalf(0.0), 0x0000);
+    EXPECT_EQ(QuantizedWeights::toHalf(-0.0), 0x8000);
+    EXPECT_EQ(QuantizedWeights::toHalf(1.0), 0x3C00);
+    EXPECT_EQ(QuantizedWeights::toHalf(-2.0), 0xC000);
+    EXPECT_EQ(QuantizedWeights::toHalf(65504.0), 0x7BFF);
+    EXPECT_EQ(QuantizedWeights::toHalf(1e6), 0x7C00);
+    EXPECT_EQ(QuantizedWeights::toHalf(std::ldexp(1.0, -24)), 0x0001);
+    EXPECT_EQ(QuantizedWeights::toHalf(std::ldexp(1.0, -14)), 0x0400);
+
+    // Ties round to the even mantissa
+    EXPECT_EQ(QuantizedWeights::toHalf(1.0 + std::ldexp(1.0, -11)), 0x3C00);
+    EXPECT_EQ(QuantizedWeights::toHalf(1.0 + 3 * std::ldexp(1.0, -11)), 0x3C02);
+
+    EXPECT_TRUE(std::isnan(QuantizedWeights::fromHalf(QuantizedWeights::toHalf(std::nan("")))));
+    EXPECT_TRUE(std::isinf(QuantizedWeights::fromHalf(0xFC00)));
+
+    // Every finite half survives a round trip through double
+    for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+        if ((bits & 0x7C00) == 0x7C00) {
+            continue;
+        }
+        double value = QuantizedWeights::fromHalf(static_cast<uint16_t>(bits));
+        EXPECT_EQ(QuantizedWeights::toHalf(value), bits) << value;
+    }
+}
+
+/**
+ * @test
+ * @brief Tests the error bound and size of each precision
+ * @ingroup quantization_tests
+ */
+TEST(QuantizationTest, QuantizationErrorIsBounded) {
+    std::vector<double> weights = sampleWeights();
+    double maxAbs = 0.0;
+    for (double w : weights) {
+        maxAbs = std::max(maxAbs, std::abs(w));
+    }
+
+    auto int8 = QuantizedWeights::quantize(weights, WeightPrecision::Int8);
+    EXPECT_EQ(int8.size(), weights.size());
+    EXPECT_EQ(int8.byteSize(), weights.size());
+    EXPECT_DOUBLE_EQ(int8.getScale(), maxAbs / 127.0);
+    EXPECT_EQ(int8.value(0), 0.0);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_LE(std::abs(int8.value(i) - weights[i]), int8.getScale() / 2 + 1e-12);
+    }
+
+    auto half = QuantizedWeights::quantize(weights, WeightPrecision::Float16);
+    EXPECT_EQ(half.byteSize(), weights.size() * 2);
+    for (size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_LE(std::abs(half.value(i) - weights[i]), std::abs(weights[i]) * std::ldexp(1.0, -11) + std::ldexp(1.0, -25));
+    }
+
+    auto full = QuantizedWeights::quantize(weights, WeightPrecision::Double);
+    EXPECT_EQ(full.dequantize(), weights);
+
+    // An all-zero tensor stays exact
+    auto zeros = QuantizedWeights::quantize(std::vector<double>(4, 0.0), WeightPrecision::Int8);
+    EXPECT_EQ(zeros.dequantize(), std::vector<double>(4, 0.0));
+}
+
+/**
+ * @test
+ * @brief Tests writing and reading quantized tensors in a section
+ * @ingroup quantization_tests
+ */
+TEST(QuantizationTest, SectionRoundTrip) {
+    std::vector<double> weights = sampleWeights();
+
+    for (auto precision : {WeightPrecision::Double, WeightPrecision::Float16, WeightPrecision::Int8}) {
+        auto original = QuantizedWeights::quantize(weights, precision);
+        blahajpi::utils::SectionWriter writer;
+        original.write(writer);
+
+        blahajpi::utils::SectionReader reader(writer.bytes());
+        QuantizedWeights loaded;
+        ASSERT_TRUE(loaded.read(reader));
+        EXPECT_EQ(loaded.getPrecision(), precision);
+        EXPECT_EQ(loaded.dequantize(), original.dequantize());
+        EXPECT_EQ(reader.remaining(), 0u);
+
+        // A truncated tensor is rejected
+        std::vector<unsigned char> truncated(writer.bytes().begin(), writer.bytes().end() - 1);
+        blahajpi::utils::SectionReader shortReader(truncated);
+        EXPECT_FALSE(QuantizedWeights().read(shortReader));
+    }
+
+    EXPECT_EQ(blahajpi::models::parseWeightPrecision("int8"), WeightPrecision::Int8);
+    EXPECT_EQ(blahajpi::models::parseWeightPrecision("float16"), WeightPrecision::Float16);
+    EXPECT_FALSE(blahajpi::models::parseWeightPrecision("int4").has_value());
+    EXPECT_EQ(blahajpi::models::weightPrecisionName(WeightPrecision::Float16), "float16");
+}
+
+} // namespace
@@ -0,0 +1,124 @@
+/**
+ * @file result_cache_test.cpp
+ * @brief Unit tests for the ResultCache class
+ * @ingroup tests
+ * @defgroup result_cache_tests Result Cache Tests
+ *
+ * Contains tests for LRU eviction, TTL expiry and concurrent use of the
+ * sharded result cache.
+ */
+
+#include "blahajpi/utils/result_cache.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Cache = blahajpi::utils::ResultCache<int>;
+
+/**
+ * @test
+ * @brief Tests lookups, replacement and clearing
+ * @ingroup result_cache_tests
+ */
+TEST(ResultCacheTest, StoresAndReplacesValues) {
+    Cache cache(10);
+    int value = 0;
+    EXPECT_FALSE(cache.find("a", value));
+
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    ASSERT_TRUE(cache.find("a", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.insert("a", 3);
+    ASSERT_TRUE(cache.find("a", value));
+    EXPECT_EQ(value, 3);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.find("b", value));
+}
+
+/**
+ * @test
+ * @brief Tests that the least recently used entry is evicted first
+ * @ingroup result_cache_tests
+ */
+TEST(ResultCacheTest, EvictsLeastRecentlyUsed) {
+    Cache cache(3);
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    cache.insert("c", 3);
+
+    // Touching "a" leaves "b" as the oldest entry
+    int value = 0;
+    ASSERT_TRUE(cache.find("a", value));
+    cache.insert("d", 4);
+
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.getEvictions(), 1u);
+    EXPECT_FALSE(cache.find("b", value));
+    EXPECT_TRUE(cache.find("a", value));
+    EXPECT_TRUE(cache.find("c", value));
+    EXPECT_TRUE(cache.find("d", value));
+
+    // Sharded caches never exceed their capacity either
+    Cache sharded(1024);
+    for (int i = 0; i < 5000; ++i) {
+        sharded.insert("key" + std::to_string(i), i);
+    }
+    EXPECT_LE(sharded.size(), 1024u);
+    EXPECT_GT(sharded.getEvictions(), 0u);
+}
+
+/**
+ * @test
+ * @brief Tests that entries expire after the TTL
+ * @ingroup result_cache_tests
+ */
+TEST(ResultCacheTest, ExpiresEntries) {
+    Cache cache(10, std::chrono::milliseconds(20));
+    cache.insert("a", 1);
+
+    int value = 0;
+    EXPECT_TRUE(cache.find("a", value));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_FALSE(cache.find("a", value));
+    EXPECT_EQ(cache.getExpirations(), 1u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+/**
+ * @test
+ * @brief Tests concurrent lookups and inserts
+ * @ingroup result_cache_tests
+ */
+TEST(ResultCacheTest, ConcurrentAccess) {
+    Cache cache(128);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&cache, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                std::string key = "key" + std::to_string((i * 7 + t) % 200);
+                int value = 0;
+                if (cache.find(key, value)) {
+                    EXPECT_EQ("key" + std::to_string(value), key);
+                } else {
+                    cache.insert(key, (i * 7 + t) % 200);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_LE(cache.size(), 128u);
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+/**
+ * @file scratch_arena_test.cpp
+ * @brief Unit tests for the ScratchArena class
+ * @ingroup tests
+ * @defgroup scratch_arena_tests Scratch Arena Tests
+ *
+ * Contains tests for block reuse, block growth after an overflow and
+ * nested arenas.
+ */
+
+#include "blahajpi/utils/scratch_arena.hpp"
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using blahajpi::utils::ScratchArena;
+
+/**
+ * @test
+ * @brief Tests that small workloads stay inside the thread's block
+ * @ingroup scratch_arena_tests
+ */
+TEST(ScratchArenaTest, SmallWorkFitsTheBlock) {
+    for (int round = 0; round < 3; ++round) {
+        ScratchArena arena;
+        std::pmr::vector<std::pmr::string> words(arena.resource());
+        for (int i = 0; i < 100; ++i) {
+            words.emplace_back("a word long enough to need its own buffer " + std::to_string(i));
+        }
+        EXPECT_EQ(words[42].get_allocator().resource(), arena.resource());
+        EXPECT_EQ(arena.overflowBytes(), 0u);
+    }
+}
+
+/**
+ * @test
+ * @brief Tests that the block grows after an overflow
+ * @ingroup scratch_arena_tests
+ *
+ * Runs on its own thread so the block starts at its initial size.
+ */
+TEST(ScratchArenaTest, BlockGrowsAfterOverflow) {
+    std::thread worker([]() {
+        const size_t count = ScratchArena::INITIAL_BLOCK_BYTES / sizeof(double) * 2;
+        {
+            ScratchArena arena;
+            std::pmr::vector<double> values(count, 1.0, arena.resource());
+            EXPECT_GT(arena.overflowBytes(), 0u);
+        }
+        {
+            ScratchArena arena;
+            std::pmr::vector<double> values(count, 1.0, arena.resource());
+            EXPECT_EQ(arena.overflowBytes(), 0u);
+        }
+    });
+    worker.join();
+}
+
+/**
+ * @test
+ * @brief Tests an arena created while another one is alive
+ * @ingroup scratch_arena_tests
+ */
+TEST(ScratchArenaTest, NestedArenas) {
+    ScratchArena outer;
+    std::pmr::vector<int> outerValues({1, 2, 3}, outer.resource());
+    {
+        ScratchArena inner;
+        std::pmr::vector<int> innerValues({4, 5, 6}, inner.resource());
+        EXPECT_GT(inner.overflowBytes(), 0u);
+        EXPECT_EQ(innerValues[2], 6);
+    }
+    EXPECT_EQ(outer.overflowBytes(), 0u);
+    EXPECT_EQ(outerValues[2], 3);
+}
+
+} // namespace
@@ -0,0 +1,110 @@
+/**
+ * @file static_lexicon_test.cpp
+ * @brief Unit tests for the compile-time lexicon tables
+ * @ingroup tests
+ * @defgroup static_lexicon_tests Static Lexicon Tests
+ *
+ * Contains tests for the perfect-hash StaticLexicon and for WordList,
+ * which layers runtime additions over a built-in lexicon.
+ */
+
+#include "blahajpi/utils/static_lexicon.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace {
+
+using blahajpi::utils::WordList;
+
+/// Small word set with a duplicate entry
+constexpr auto COLORS = blahajpi::utils::makeWordSet({"blue", "pink", "white", "pink"});
+
+/// Small word map
+constexpr auto EXPANSIONS = blahajpi::utils::makeWordMap({
+    {"brb", "be right back"},
+    {"u", "you"},
+    {"u", "ewe"}
+});
+
+// Lookups work in constant expressions
+static_assert(COLORS.contains("pink"));
+static_assert(!COLORS.contains("green"));
+static_assert(COLORS.size() == 3);
+
+/**
+ * @test
+ * @brief Tests membership and value lookup
+ * @ingroup static_lexicon_tests
+ */
+TEST(StaticLexiconTest, FindsExactlyTheKeys) {
+    EXPECT_TRUE(COLORS.contains("blue"));
+    EXPECT_TRUE(COLORS.contains(std::string("white")));
+    EXPECT_FALSE(COLORS.contains(""));
+    EXPECT_FALSE(COLORS.contains("blu"));
+    EXPECT_FALSE(COLORS.contains("blues"));
+
+    ASSERT_NE(EXPANSIONS.find("brb"), nullptr);
+    EXPECT_EQ(*EXPANSIONS.find("brb"), "be right back");
+    EXPECT_EQ(EXPANSIONS.find("b"), nullptr);
+
+    // The first of several duplicate keys wins
+    ASSERT_NE(EXPANSIONS.find("u"), nullptr);
+    EXPECT_EQ(*EXPANSIONS.find("u"), "you");
+    EXPECT_EQ(EXPANSIONS.size(), 2);
+}
+
+/**
+ * @test
+ * @brief Tests a larger table against a reference set
+ * @ingroup static_lexicon_tests
+ */
+TEST(StaticLexiconTest, LargeTableMatchesReference) {
+    static constexpr std::string_view words[] = {
+        "a", "b", "c", "d", "e", "f", "g", "h", "i", "j", "k", "l", "m",
+        "n", "o", "p", "q", "r", "s", "t", "u", "v", "w", "x", "y", "z",
+        "aa", "ab", "ac", "ad", "ae", "af", "ag", "ah", "ai", "aj", "ak",
+        "ba", "bb", "bc", "bd", "be", "bf", "bg", "bh", "bi", "bj", "bk",
+        "abc", "abd", "abe", "abf", "abg", "abh", "abi", "abj", "abk", "abl"
+    };
+    static constexpr auto table = blahajpi::utils::makeWordSet(words);
+    std::unordered_set<std::string_view> reference(std::begin(words), std::end(words));
+
+    EXPECT_EQ(table.size(), reference.size());
+    for (char first = 'a'; first <= 'c'; ++first) {
+        for (char second = 'a'; second <= 'z'; ++second) {
+            for (std::string key : {std::string(1, first) + second, std::string("ab") + second, std::string(1, second)}) {
+                EXPECT_EQ(table.contains(key), reference.count(key) > 0) << key;
+            }
+        }
+    }
+}
+
+/**
+ * @test
+ * @brief Tests runtime additions over a built-in lexicon
+ * @ingroup static_lexicon_tests
+ */
+TEST(StaticLexiconTest, WordListOverlaysRuntimeWords) {
+    WordList list(COLORS.view());
+    EXPECT_TRUE(list.contains("blue"));
+    EXPECT_FALSE(list.contains("green"));
+    EXPECT_EQ(list.size(), 3);
+
+    list.insert("green");
+    list.insert("blue");
+    EXPECT_TRUE(list.contains("green"));
+    EXPECT_TRUE(list.contains(std::string_view("green")));
+    EXPECT_EQ(list.size(), 4);
+
+    WordList runtimeOnly(std::unordered_set<std::string>{"shark"});
+    EXPECT_TRUE(runtimeOnly.contains("shark"));
+    EXPECT_FALSE(runtimeOnly.contains("blue"));
+
+    WordList empty;
+    EXPECT_FALSE(empty.contains(""));
+    EXPECT_EQ(empty.size(), 0);
+}
+
+} // namespace
@@ -0,0 +1,92 @@
+/**
+ * @file stats_test.cpp
+ * @brief Unit tests for the analyzer instrumentation counters
+ * @ingroup tests
+ * @defgroup stats_tests Stats Tests
+ *
+ * Contains tests for histogram bucketing, percentile estimates and the
+ * JSON and Prometheus exporters.
+ */
+
+#include "blahajpi/utils/stats.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+using blahajpi::utils::Stage;
+using blahajpi::utils::StatsRecorder;
+
+/**
+ * @test
+ * @brief Tests stage recording and percentile estimates
+ * @ingroup stats_tests
+ *
+ * Verifies that groups are bucketed by their per-document average and
+ * that percentiles report bucket upper bounds capped by the maximum.
+ */
+TEST(StatsTest, RecordsStageHistograms) {
+    StatsRecorder recorder;
+    recorder.recordStage(Stage::Preprocess, 90 * 2'000, 90);   // 2us each
+    recorder.recordStage(Stage::Preprocess, 10 * 40'000, 10);  // 40us each
+    recorder.recordStage(Stage::Score, 0, 0);
+
+    auto stats = recorder.snapshot(true);
+    const auto& preprocess = stats.stage(Stage::Preprocess);
+    EXPECT_EQ(preprocess.documents, 100u);
+    EXPECT_EQ(preprocess.totalNanos, 580'000u);
+    EXPECT_EQ(preprocess.maxNanos, 40'000u);
+    EXPECT_DOUBLE_EQ(preprocess.meanMicros(), 5.8);
+    EXPECT_DOUBLE_EQ(preprocess.percentileMicros(0.5), 2.5);
+    EXPECT_DOUBLE_EQ(preprocess.percentileMicros(0.99), 40.0);
+    EXPECT_EQ(stats.stage(Stage::Score).documents, 0u);
+    EXPECT_DOUBLE_EQ(stats.stage(Stage::Score).percentileMicros(0.99), 0.0);
+
+    recorder.reset();
+    EXPECT_EQ(recorder.snapshot(true).stage(Stage::Preprocess).documents, 0u);
+}
+
+/**
+ * @test
+ * @brief Tests the text exporters
+ * @ingroup stats_tests
+ *
+ * Verifies throughput ratios and that both formats carry the counters,
+ * with cumulative Prometheus buckets.
+ */
+TEST(StatsTest, ExportsJsonAndPrometheus) {
+    StatsRecorder recorder;
+    recorder.recordDocuments(3, 120);
+    recorder.recordTerms(10, 8);
+    recorder.recordModelLoad(5'000'000);
+    recorder.recordStage(Stage::KeyTerms, 3 * 1'500, 3);
+    recorder.recordCascade(4, 1);
+    recorder.recordNearDuplicates(10, 9);
+
+    auto stats = recorder.snapshot(true);
+    EXPECT_DOUBLE_EQ(stats.vocabularyHitRate(), 0.8);
+    EXPECT_DOUBLE_EQ(stats.cascadeExitRate(), 0.25);
+    EXPECT_DOUBLE_EQ(stats.nearDuplicateReuseRate(), 0.9);
+    EXPECT_DOUBLE_EQ(stats.modelLoadSeconds, 0.005);
+
+    std::string json = stats.toJson();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"documents\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"vocabulary_hit_rate\":0.8"), std::string::npos);
+    EXPECT_NE(json.find("\"key_terms\":{\"documents\":3"), std::string::npos);
+    EXPECT_NE(json.find("\"cascade_exit_rate\":0.25"), std::string::npos);
+    EXPECT_NE(json.find("\"near_duplicates_reused\":9"), std::string::npos);
+
+    std::string metrics = stats.toPrometheus();
+    EXPECT_NE(metrics.find("blahajpi_documents_total 3\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_bytes_total 120\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_cascade_exits_total 1\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_near_duplicates_checked_total 10\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_stage_duration_seconds_bucket{stage=\"key_terms\",le=\"1e-06\"} 0\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_stage_duration_seconds_bucket{stage=\"key_terms\",le=\"2.5e-06\"} 3\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_stage_duration_seconds_bucket{stage=\"key_terms\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(metrics.find("blahajpi_stage_duration_seconds_count{stage=\"key_terms\"} 3\n"), std::string::npos);
+}
+
+} // namespace
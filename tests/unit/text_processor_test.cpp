@@ -14,9 +14,46 @@
 #include <vector>
 #include <unordered_set>
 #include <algorithm> // Added for std::all_of
+#include <random>
+#include <regex>
 
 namespace {
 
+/**
+ * @brief Regex the remove_urls step used to be implemented with
+ * @ingroup text_processor_tests
+ */
+const std::regex REFERENCE_URL_PATTERN(R"((https?://)?([a-zA-Z0-9]+\.)+[a-zA-Z0-9]{2,}(/[a-zA-Z0-9_./?=%&-]*)?)");
+
+/**
+ * @brief Regex the remove_mentions step used to be implemented with
+ * @ingroup text_processor_tests
+ */
+const std::regex REFERENCE_MENTION_PATTERN(R"(@[a-zA-Z0-9_]+)");
+
+/**
+ * @brief Draws a string from characters that are significant to the scanners
+ * @ingroup text_processor_tests
+ * @param rng Random generator
+ * @return Random text of up to 24 characters
+ */
+std::string randomScannerInput(std::mt19937& rng) {
+    static const std::string alphabet = "abhtpsAB1_.:/@# -?=";
+    std::uniform_int_distribution<size_t> length(0, 24);
+    std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+    
+    std::string text(length(rng), ' ');
+    for (char& c : text) {
+        c = alphabet[pick(rng)];
+    }
+    
+    // Seed some inputs with a scheme so the https?:// branch is exercised
+    if (!text.empty() && text.size() % 3 == 0) {
+        text.insert(pick(rng) % text.size(), pick(rng) % 2 ? "https://" : "http://");
+    }
+    return text;
+}
+
 /**
  * @brief Test fixture for TextProcessor tests
  * @ingroup text_processor_tests
@@ -142,4 +179,136 @@ TEST_F(TextProcessorTest, FullPreprocessingPipeline) {
                            [](unsigned char c){ return !std::isupper(c); })); // All lowercase
 }
 
+/**
+ * @test
+ * @brief Tests the compiled default pipeline against step-by-step processing
+ * @ingroup text_processor_tests
+ * 
+ * Verifies that the fused single-pass stage produces exactly the output of
+ * running the default steps one after another.
+ */
+TEST_F(TextProcessorTest, FusedPipelineMatchesSequentialSteps) {
+    auto functions = defaultProcessor->getPreprocessingFunctions();
+    const auto& steps = blahajpi::preprocessing::TextProcessor::getDefaultPipeline();
+    
+    std::vector<std::string> inputs = {
+        "",
+        "   ",
+        "Hello, WORLD! This is a test.",
+        "I don't like this at all!!! Soooo bad",
+        "aaah lol u r gr8 idk what 2 say",
+        "Check https://example.com/path?a=1 @user #TransRights are human rights",
+        "not 123 !!! the end",
+        "I'm not w/ u, it's never gonna happen tbh",
+        "Cooool   stuff\tand\nmore    ",
+        "remember: nobody !!! 42 wins"
+    };
+    
+    std::string buffer;
+    for (const auto& input : inputs) {
+        std::string expected = input;
+        for (const auto& step : steps) {
+            expected = functions[step](expected);
+        }
+        
+        EXPECT_EQ(defaultProcessor->preprocess(input), expected) << "input: " << input;
+        
+        defaultProcessor->preprocessInto(input, buffer);
+        EXPECT_EQ(buffer, expected) << "input: " << input;
+    }
+}
+
+/**
+ * @test
+ * @brief Tests selecting a custom pipeline
+ * @ingroup text_processor_tests
+ * 
+ * Verifies that setPipeline() changes the steps used by preprocess()
+ * and that overriding a step disables the fused stage.
+ */
+TEST_F(TextProcessorTest, CustomPipelineSelection) {
+    blahajpi::preprocessing::TextProcessor processor;
+    
+    processor.setPipeline({"lowercase", "remove_punctuation"});
+    EXPECT_EQ(processor.getPipeline().size(), 2);
+    EXPECT_EQ(processor.preprocess("Hello,  World!"), "hello  world");
+    
+    // Explicit steps still take precedence over the active pipeline
+    EXPECT_EQ(processor.preprocess("Hello, World!", {"lowercase"}), "hello, world!");
+    
+    // An overridden built-in step must be honored by the compiled pipeline
+    processor.setPipeline({});
+    processor.addPreprocessingStep("remove_stopwords", [](std::string_view text) {
+        return std::string(text);
+    });
+    EXPECT_EQ(processor.preprocess("the cat"), "the cat");
+}
+
+/**
+ * @test
+ * @brief Tests the URL, mention and hashtag scanners
+ * @ingroup text_processor_tests
+ * 
+ * Verifies the scanners on typical social media text and checks that
+ * they remove exactly what the original regular expressions matched.
+ */
+TEST_F(TextProcessorTest, SocialMediaScannersMatchRegex) {
+    auto& processor = *defaultProcessor;
+    
+    EXPECT_EQ(processor.preprocess("see https://example.com/a?b=1 now", {"remove_urls"}), "see  now");
+    EXPECT_EQ(processor.preprocess("visit www.example.org.", {"remove_urls"}), "visit .");
+    EXPECT_EQ(processor.preprocess("hi @user_1, @ alone", {"remove_mentions"}), "hi , @ alone");
+    EXPECT_EQ(processor.preprocess("#TransRights and #pride", {"process_hashtags"}), "trans rights and pride");
+    
+    std::vector<std::string> inputs = {
+        "", "a.b", "a.bc", "a.bc.d", "a.b.cd", "ab.c.d", "ab.cd.e", "a..bc", "..ab.cd",
+        "xhttp://a.com", "http://a.b", "https://a.b.cd", "https://", "http://.com",
+        "hhttps://ab.cd/x", "ahttps://a.b", "e.g. done", "v1.2.3", "x.co/path_a/b?c=d&e=%20-",
+        "@a.co_x", "mail@host.com", "##Foo", "#fooBar #foo", "#foo #fooBar", "#_A1b", "#"
+    };
+    std::mt19937 rng(42);
+    for (int i = 0; i < 2000; ++i) {
+        inputs.push_back(randomScannerInput(rng));
+    }
+    
+    for (const auto& input : inputs) {
+        EXPECT_EQ(processor.preprocess(input, {"remove_urls"}),
+                  std::regex_replace(input, REFERENCE_URL_PATTERN, "")) << input;
+        EXPECT_EQ(processor.preprocess(input, {"remove_mentions"}),
+                  std::regex_replace(input, REFERENCE_MENTION_PATTERN, "")) << input;
+    }
+    
+    // Hashtags are camelCase-split in place; the hand-written scanner keeps the rest untouched
+    EXPECT_EQ(processor.preprocess("##Foo", {"process_hashtags"}), "#foo");
+    EXPECT_EQ(processor.preprocess("#fooBar #foo", {"process_hashtags"}), "foo bar foo");
+    EXPECT_EQ(processor.preprocess("a#b_C #", {"process_hashtags"}), "ab_ c #");
+    
+    // Each occurrence is processed where it is; the regex version searched the output
+    // for the tag again, processed the first "##tag" twice and left the last one alone
+    EXPECT_EQ(processor.preprocess("##tag,#a ##tag", {"process_hashtags"}), "#tag,a #tag");
+}
+
+/**
+ * @test
+ * @brief Tests adding words on top of the built-in lists
+ * @ingroup text_processor_tests
+ * 
+ * Verifies that words added at runtime are honored alongside the
+ * built-in stopwords and negations, by both the single steps and the
+ * fused pipeline.
+ */
+TEST_F(TextProcessorTest, RuntimeWordsExtendBuiltinLists) {
+    blahajpi::preprocessing::TextProcessor processor;
+    EXPECT_EQ(processor.preprocess("the shark swims", {"remove_stopwords"}), "shark swims");
+    
+    processor.addStopwords({"shark", "the"});
+    processor.addNegationWords({"hardly"});
+    EXPECT_EQ(processor.preprocess("the shark swims", {"remove_stopwords"}), "swims");
+    EXPECT_EQ(processor.preprocess("hardly any fish", {"handle_negations"}), "hardly NOT_any NOT_fish");
+    EXPECT_EQ(processor.preprocess("The shark hardly swims"), "hardly NOTswims");
+    
+    // Custom lists replace the built-in ones entirely
+    EXPECT_EQ(customProcessor->preprocess("you and me", {"remove_stopwords"}), "you me");
+}
+
 } // namespace
@@ -0,0 +1,147 @@
+/**
+ * @file tokenizer_test.cpp
+ * @brief Unit tests for the Tokenizer and TermIndex classes
+ * @ingroup tests
+ * @defgroup tokenizer_tests Tokenizer Tests
+ *
+ * Contains tests for whitespace splitting, rolling n-gram hashes and
+ * integer-keyed vocabulary lookup.
+ */
+
+#include "blahajpi/preprocessing/tokenizer.hpp"
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+using blahajpi::preprocessing::TermId;
+using blahajpi::preprocessing::TermIndex;
+using blahajpi::preprocessing::Tokenizer;
+
+/**
+ * @test
+ * @brief Tests splitting text into word views
+ * @ingroup tokenizer_tests
+ *
+ * Verifies that any run of whitespace separates words and that the
+ * words are views into the original text.
+ */
+TEST(TokenizerTest, SplitWords) {
+    std::string text = "  this\tis \n a   test  ";
+    std::vector<std::string_view> words;
+    Tokenizer::splitWords(text, words);
+
+    ASSERT_EQ(words.size(), 4);
+    EXPECT_EQ(words[0], "this");
+    EXPECT_EQ(words[1], "is");
+    EXPECT_EQ(words[2], "a");
+    EXPECT_EQ(words[3], "test");
+    EXPECT_EQ(words[0].data(), text.data() + 2);
+
+    Tokenizer::splitWords("   ", words);
+    EXPECT_TRUE(words.empty());
+}
+
+/**
+ * @test
+ * @brief Tests that rolling n-gram hashes match hashes of joined terms
+ * @ingroup tokenizer_tests
+ *
+ * Verifies that the identifier produced while scanning equals hashTerm()
+ * of the underscore-joined n-gram, so stored vocabulary strings can be
+ * looked up by identifier.
+ */
+TEST(TokenizerTest, RollingHashMatchesJoinedTerm) {
+    Tokenizer tokenizer(1, 3);
+    std::vector<std::string_view> words;
+    Tokenizer::splitWords("the quick brown fox", words);
+
+    size_t termCount = 0;
+    tokenizer.forEachTerm(words, [&](TermId id, size_t start, size_t length) {
+        std::string term = Tokenizer::joinTerm(words, start, length);
+        EXPECT_EQ(id, Tokenizer::hashTerm(term)) << term;
+        ++termCount;
+    });
+
+    // 4 unigrams + 3 bigrams + 2 trigrams
+    EXPECT_EQ(termCount, 9);
+
+    // The minimum length excludes shorter n-grams
+    Tokenizer bigramsOnly(2, 2);
+    termCount = 0;
+    bigramsOnly.forEachTerm(words, [&](TermId, size_t, size_t length) {
+        EXPECT_EQ(length, 2);
+        ++termCount;
+    });
+    EXPECT_EQ(termCount, 3);
+}
+
+/**
+ * @test
+ * @brief Tests vocabulary lookup by term identifier
+ * @ingroup tokenizer_tests
+ *
+ * Verifies that every vocabulary term is found at its feature index and
+ * that unknown terms are reported as missing.
+ */
+TEST(TokenizerTest, TermIndexLookup) {
+    std::unordered_map<std::string, int> vocabulary;
+    for (int i = 0; i < 1000; ++i) {
+        vocabulary["term" + std::to_string(i)] = i;
+    }
+
+    TermIndex index;
+    EXPECT_EQ(index.find(Tokenizer::hashTerm("term0")), -1);
+
+    index.build(vocabulary);
+    EXPECT_EQ(index.size(), vocabulary.size());
+
+    for (const auto& [term, featureIdx] : vocabulary) {
+        EXPECT_EQ(index.find(Tokenizer::hashTerm(term)), featureIdx);
+    }
+    EXPECT_EQ(index.find(Tokenizer::hashTerm("missing")), -1);
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find(Tokenizer::hashTerm("term1")), -1);
+}
+
+/**
+ * @test
+ * @brief Tests that hashed counting in the vectorizer matches string tokens
+ * @ingroup tokenizer_tests
+ *
+ * Verifies that the features produced by transformSparse() agree with
+ * term frequencies counted from the string tokens of tokenize().
+ */
+TEST(TokenizerTest, VectorizerCountsMatchStringTokens) {
+    blahajpi::preprocessing::TfidfVectorizer vectorizer(false, 0.9, 1000, 1, 2);
+    std::vector<std::string> texts = {
+        "good good day", "bad day", "good bad good", "another day another story"
+    };
+    vectorizer.fit(texts, 0.9, 1000);
+
+    const auto& vocabulary = vectorizer.getVocabulary();
+    auto rows = vectorizer.transformSparse(texts);
+
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::unordered_map<int, int> expectedCounts;
+        for (const auto& token : vectorizer.tokenize(texts[i])) {
+            auto it = vocabulary.find(token);
+            if (it != vocabulary.end()) {
+                expectedCounts[it->second]++;
+            }
+        }
+
+        EXPECT_EQ(rows[i].nonZeroCount(), expectedCounts.size());
+        for (int featureIdx : rows[i].indices) {
+            EXPECT_TRUE(expectedCounts.count(featureIdx)) << "feature " << featureIdx;
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,47 @@
+/**
+ * @file toy_corpus.hpp
+ * @brief Toy labeled corpus shared by the model unit tests
+ * @ingroup tests
+ *
+ * Insults and compliments whose label depends on single words, small
+ * enough for every model to fit exactly.
+ */
+
+#pragma once
+
+#include "blahajpi/preprocessing/vectorizer.hpp"
+#include <string>
+#include <vector>
+
+namespace blahajpi {
+namespace test {
+
+/// Texts of the toy corpus
+inline const std::vector<std::string> TOY_TEXTS = {
+    "you are awful and gross", "awful people everywhere", "gross awful content",
+    "you are lovely and kind", "lovely people everywhere", "kind lovely content",
+    "awful awful day", "lovely kind day"
+};
+
+/// Labels of TOY_TEXTS using the dataset convention (0 = safe, 4 = harmful)
+inline const std::vector<int> TOY_LABELS = {4, 4, 4, 0, 0, 0, 4, 0};
+
+/**
+ * @brief Toy corpus vectorized into sparse rows
+ *
+ * Fixtures derive from it to get the corpus and its features as members.
+ */
+struct ToyCorpus {
+    std::vector<std::string> texts = TOY_TEXTS;  ///< Raw training texts
+    std::vector<int> labels = TOY_LABELS;        ///< Labels of the texts
+    preprocessing::TfidfVectorizer vectorizer{true, 0.9, 100, 1, 1}; ///< Unigram TF-IDF fitted on the texts
+    std::vector<preprocessing::SparseVector> features;             ///< Sparse rows of the texts
+
+    ToyCorpus() {
+        vectorizer.fit(texts, 0.9, 100);
+        features = vectorizer.transformSparse(texts);
+    }
+};
+
+} // namespace test
+} // namespace blahajpi
@@ -1,6 +1,6 @@
 /**
  * @file vectorizer_test.cpp
- * @brief Unit tests for the TfidfVectorizer class
+ * @brief Unit tests for the TfidfVectorizer and HashingVectorizer classes
  * @ingroup tests
  * @defgroup vectorizer_tests Vectorizer Tests
  * 
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <stdexcept>
 
 namespace {
 
@@ -215,4 +216,293 @@ TEST_F(TfidfVectorizerTest, SaveAndLoad) {
    }
 }
 
+/**
+ * @test
+ * @brief Tests sparse transformation
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that the sparse output holds exactly the non-zero entries of
+ * the dense feature vectors, with ascending indices.
+ */
+TEST_F(TfidfVectorizerTest, TransformSparseMatchesDense) {
+   blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 2);
+   vectorizer.fit(simpleDocs);
+   
+   auto dense = vectorizer.transform(simpleDocs);
+   auto sparse = vectorizer.transformSparse(simpleDocs);
+   
+   ASSERT_EQ(sparse.size(), dense.size());
+   
+   for (size_t i = 0; i < sparse.size(); ++i) {
+       const auto& row = sparse[i];
+       ASSERT_EQ(row.indices.size(), row.values.size());
+       EXPECT_TRUE(std::is_sorted(row.indices.begin(), row.indices.end()));
+       
+       size_t denseNonZeros = std::count_if(dense[i].begin(), dense[i].end(),
+                                            [](double v) { return v != 0.0; });
+       EXPECT_EQ(row.nonZeroCount(), denseNonZeros);
+       
+       auto expanded = row.toDense(vectorizer.getNumFeatures());
+       EXPECT_TRUE(areFeaturesEqual({expanded}, {dense[i]}, 1e-12));
+   }
+   
+   // A document without known terms has no entries at all
+   auto empty = vectorizer.transformSparse({"zebra"});
+   ASSERT_EQ(empty.size(), 1);
+   EXPECT_EQ(empty[0].nonZeroCount(), 0);
+}
+
+/**
+ * @test
+ * @brief Tests hashed feature extraction
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that the hashing vectorizer has a fixed feature space, places
+ * terms in their hashed buckets and produces unit-length rows.
+ */
+TEST_F(TfidfVectorizerTest, HashingVectorizerTransform) {
+   blahajpi::preprocessing::HashingVectorizer vectorizer(true, 10, 1, 2, true, 7);
+   EXPECT_EQ(vectorizer.getNumFeatures(), 1024);
+   
+   // Transforming before fit() has no IDF table to use
+   EXPECT_THROW(vectorizer.transformSparse(simpleDocs), std::runtime_error);
+   
+   vectorizer.fit(simpleDocs);
+   EXPECT_EQ(vectorizer.getDocumentFrequencies().size(), 1024);
+   EXPECT_EQ(vectorizer.getDocumentFrequencies()[vectorizer.getBucket("this")], 3);
+   
+   auto rows = vectorizer.transformSparse(simpleDocs);
+   auto dense = vectorizer.transform(simpleDocs);
+   ASSERT_EQ(rows.size(), simpleDocs.size());
+   
+   for (size_t i = 0; i < rows.size(); ++i) {
+       EXPECT_TRUE(std::is_sorted(rows[i].indices.begin(), rows[i].indices.end()));
+       
+       double norm = 0.0;
+       for (double v : rows[i].values) {
+           norm += v * v;
+       }
+       EXPECT_NEAR(norm, 1.0, 1e-9);
+       
+       EXPECT_TRUE(areFeaturesEqual({rows[i].toDense(1024)}, {dense[i]}, 1e-12));
+   }
+   
+   // Unseen terms still map to a bucket
+   auto unseen = vectorizer.transformSparse({"zebra"});
+   ASSERT_EQ(unseen[0].nonZeroCount(), 1);
+   EXPECT_EQ(unseen[0].indices[0], vectorizer.getBucket("zebra"));
+   
+   EXPECT_THROW(blahajpi::preprocessing::HashingVectorizer(true, 0), std::invalid_argument);
+}
+
+/**
+ * @test
+ * @brief Tests loading either vectorizer kind from a file
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that Vectorizer::loadFromFile() recognizes hashing vectorizer
+ * files and reads everything else as TF-IDF.
+ */
+TEST_F(TfidfVectorizerTest, LoadFromFileDetectsKind) {
+   blahajpi::preprocessing::HashingVectorizer hashing(true, 8, 1, 2);
+   hashing.fit(simpleDocs);
+   std::string hashingPath = (tempDir / "hashing.bin").string();
+   ASSERT_TRUE(hashing.save(hashingPath));
+   
+   // Hashed files have a fixed size that does not depend on the corpus
+   EXPECT_GT(std::filesystem::file_size(hashingPath), 256 * sizeof(int32_t));
+   
+   blahajpi::preprocessing::TfidfVectorizer tfidf(true, 0.9, 100, 1, 1);
+   tfidf.fit(simpleDocs);
+   std::string tfidfPath = (tempDir / "tfidf.bin").string();
+   ASSERT_TRUE(tfidf.save(tfidfPath));
+   
+   auto loadedHashing = blahajpi::preprocessing::Vectorizer::loadFromFile(hashingPath);
+   ASSERT_NE(loadedHashing, nullptr);
+   EXPECT_NE(dynamic_cast<blahajpi::preprocessing::HashingVectorizer*>(loadedHashing.get()), nullptr);
+   EXPECT_TRUE(areFeaturesEqual(loadedHashing->transform(simpleDocs), hashing.transform(simpleDocs), 1e-12));
+   
+   auto loadedTfidf = blahajpi::preprocessing::Vectorizer::loadFromFile(tfidfPath);
+   ASSERT_NE(loadedTfidf, nullptr);
+   EXPECT_NE(dynamic_cast<blahajpi::preprocessing::TfidfVectorizer*>(loadedTfidf.get()), nullptr);
+   EXPECT_EQ(loadedTfidf->getNumFeatures(), tfidf.getNumFeatures());
+}
+
+/**
+ * @test
+ * @brief Tests fitting incrementally over batches
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that beginFit(), partialFit() per batch and finishFit() learn
+ * the same statistics as fit() on the whole corpus.
+ */
+TEST_F(TfidfVectorizerTest, IncrementalFitMatchesFit) {
+   std::vector<std::string> firstBatch(simpleDocs.begin(), simpleDocs.begin() + 2);
+   std::vector<std::string> secondBatch(simpleDocs.begin() + 2, simpleDocs.end());
+   
+   blahajpi::preprocessing::TfidfVectorizer full(true, 0.9, 100, 1, 2);
+   full.fit(simpleDocs);
+   blahajpi::preprocessing::TfidfVectorizer incremental(true, 0.9, 100, 1, 2);
+   incremental.beginFit();
+   incremental.partialFit(firstBatch);
+   incremental.partialFit(secondBatch);
+   incremental.finishFit();
+   
+   EXPECT_EQ(incremental.getVocabulary(), full.getVocabulary());
+   EXPECT_EQ(incremental.getDocumentFrequencies(), full.getDocumentFrequencies());
+   EXPECT_EQ(incremental.getIdfWeights(), full.getIdfWeights());
+   
+   blahajpi::preprocessing::HashingVectorizer fullHashing(true, 8, 1, 2);
+   fullHashing.fit(simpleDocs);
+   blahajpi::preprocessing::HashingVectorizer incrementalHashing(true, 8, 1, 2);
+   incrementalHashing.beginFit();
+   incrementalHashing.partialFit(firstBatch);
+   incrementalHashing.partialFit(secondBatch);
+   incrementalHashing.finishFit();
+   
+   EXPECT_EQ(incrementalHashing.getDocumentFrequencies(), fullHashing.getDocumentFrequencies());
+   EXPECT_EQ(incrementalHashing.getIdfWeights(), fullHashing.getIdfWeights());
+}
+
+/**
+ * @test
+ * @brief Tests fitting on several threads
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that a parallel fit learns the same vocabulary, feature
+ * indices and document frequencies as a serial fit, for both vectorizers.
+ */
+TEST_F(TfidfVectorizerTest, ParallelFitMatchesSerial) {
+   // Enough documents for every worker, with many tied frequencies
+   std::vector<std::string> corpus;
+   for (int i = 0; i < 3000; ++i) {
+       corpus.push_back("word" + std::to_string(i % 97) + " term" + std::to_string(i % 13) +
+                        " token" + std::to_string((i * 7) % 211) + " common");
+   }
+   
+   blahajpi::preprocessing::TfidfVectorizer serial(true, 0.9, 500, 1, 2);
+   serial.fit(corpus);
+   blahajpi::preprocessing::TfidfVectorizer parallel(true, 0.9, 500, 1, 2);
+   parallel.setFitThreads(4);
+   parallel.fit(corpus);
+   
+   EXPECT_EQ(parallel.getNumFeatures(), 500u);
+   EXPECT_EQ(parallel.getVocabulary(), serial.getVocabulary());
+   EXPECT_EQ(parallel.getDocumentFrequencies(), serial.getDocumentFrequencies());
+   EXPECT_EQ(parallel.getIdfWeights(), serial.getIdfWeights());
+   
+   blahajpi::preprocessing::HashingVectorizer serialHashing(true, 10, 1, 2);
+   serialHashing.fit(corpus);
+   blahajpi::preprocessing::HashingVectorizer parallelHashing(true, 10, 1, 2);
+   parallelHashing.setFitThreads(4);
+   parallelHashing.fit(corpus);
+   
+   EXPECT_EQ(parallelHashing.getDocumentFrequencies(), serialHashing.getDocumentFrequencies());
+}
+
+/**
+ * @test
+ * @brief Tests vocabulary selection thresholds and tie order
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that min-df drops rare terms, that maxFeatures keeps the most
+ * frequent ones, and that equally frequent terms are indexed in text order.
+ */
+TEST_F(TfidfVectorizerTest, SelectsTopTermsDeterministically) {
+   std::vector<std::string> corpus = {
+       "delta alpha rare1", "charlie alpha rare2", "bravo alpha", "delta charlie bravo"
+   };
+   
+   blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 1);
+   vectorizer.setMinDf(2);
+   vectorizer.fit(corpus);
+   
+   // alpha (3) first, then the terms seen twice in text order; singletons are gone
+   const auto& vocabulary = vectorizer.getVocabulary();
+   ASSERT_EQ(vocabulary.size(), 4u);
+   EXPECT_EQ(vocabulary.at("alpha"), 0);
+   EXPECT_EQ(vocabulary.at("bravo"), 1);
+   EXPECT_EQ(vocabulary.at("charlie"), 2);
+   EXPECT_EQ(vocabulary.at("delta"), 3);
+   
+   blahajpi::preprocessing::TfidfVectorizer limited(true, 0.9, 2, 1, 1);
+   limited.fit(corpus);
+   ASSERT_EQ(limited.getNumFeatures(), 2u);
+   EXPECT_EQ(limited.getVocabulary().at("alpha"), 0);
+   EXPECT_EQ(limited.getVocabulary().at("bravo"), 1);
+   
+   // A fraction is relative to the number of documents
+   blahajpi::preprocessing::TfidfVectorizer fractional(true, 0.9, 100, 1, 1);
+   fractional.setMinDf(0.6);
+   fractional.fit(corpus);
+   EXPECT_EQ(fractional.getNumFeatures(), 1u);
+}
+
+/**
+ * @test
+ * @brief Tests removing vocabulary terms
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that kept terms are renumbered in their old order with their
+ * IDF weights unchanged, and that removed terms no longer match.
+ */
+TEST_F(TfidfVectorizerTest, CompactRenumbersKeptTerms) {
+   std::vector<std::string> corpus = {
+       "delta alpha", "charlie alpha", "bravo alpha", "delta charlie bravo"
+   };
+   
+   blahajpi::preprocessing::TfidfVectorizer vectorizer(true, 0.9, 100, 1, 1);
+   vectorizer.fit(corpus);
+   ASSERT_EQ(vectorizer.getNumFeatures(), 4u);
+   std::vector<double> idf = vectorizer.getIdfWeights();
+   
+   // Drop bravo (1) and delta (3)
+   std::vector<int> newIndex = vectorizer.compact({true, false, true, false});
+   EXPECT_EQ(newIndex, (std::vector<int>{0, -1, 1, -1}));
+   ASSERT_EQ(vectorizer.getNumFeatures(), 2u);
+   EXPECT_EQ(vectorizer.getVocabulary().at("alpha"), 0);
+   EXPECT_EQ(vectorizer.getVocabulary().at("charlie"), 1);
+   EXPECT_EQ(vectorizer.getVocabulary().count("bravo"), 0u);
+   EXPECT_DOUBLE_EQ(vectorizer.getIdfWeights()[0], idf[0]);
+   EXPECT_DOUBLE_EQ(vectorizer.getIdfWeights()[1], idf[2]);
+   
+   auto features = vectorizer.transformSparse({"delta bravo charlie"});
+   EXPECT_EQ(features[0].indices, (std::vector<int>{1}));
+   EXPECT_DOUBLE_EQ(features[0].values[0], 1.0);
+   
+   EXPECT_THROW(vectorizer.compact({true}), std::invalid_argument);
+}
+
+/**
+ * @test
+ * @brief Tests bounded-memory counting
+ * @ingroup vectorizer_tests
+ * 
+ * Verifies that pruning rare terms while counting still finds the
+ * frequent terms and gives the same vocabulary for any thread count.
+ */
+TEST_F(TfidfVectorizerTest, PrunedFitKeepsFrequentTerms) {
+   // A few frequent words plus a unique word per document
+   std::vector<std::string> corpus;
+   for (int i = 0; i < 40000; ++i) {
+       corpus.push_back("frequent" + std::to_string(i % 5) + " unique" + std::to_string(i));
+   }
+   
+   blahajpi::preprocessing::TfidfVectorizer exact(true, 0.9, 5, 1, 1);
+   exact.fit(corpus);
+   blahajpi::preprocessing::TfidfVectorizer pruned(true, 0.9, 5, 1, 1);
+   pruned.setMaxPendingTerms(1000);
+   pruned.fit(corpus);
+   blahajpi::preprocessing::TfidfVectorizer prunedParallel(true, 0.9, 5, 1, 1);
+   prunedParallel.setMaxPendingTerms(1000);
+   prunedParallel.setFitThreads(4);
+   prunedParallel.fit(corpus);
+   
+   EXPECT_EQ(pruned.getVocabulary(), exact.getVocabulary());
+   EXPECT_EQ(pruned.getDocumentFrequencies(), exact.getDocumentFrequencies());
+   EXPECT_EQ(prunedParallel.getVocabulary(), pruned.getVocabulary());
+   EXPECT_EQ(prunedParallel.getDocumentFrequencies(), pruned.getDocumentFrequencies());
+}
+
 } // namespace
+
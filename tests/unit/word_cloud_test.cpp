@@ -17,6 +17,7 @@
 #include <vector>
 #include <unordered_set>
 #include <sstream>
+#include <thread>
 
 namespace {
 
@@ -225,4 +226,87 @@ TEST_F(WordCloudTest, EmptyInput) {
     EXPECT_FALSE(cloud.empty());
 }
 
+/**
+ * @test
+ * @brief Tests exact and bounded word counting
+ * @ingroup word_cloud_tests
+ * 
+ * Verifies word weights, that sharded counting matches one pass, and that
+ * a bounded counter stays small while keeping the heavy hitters.
+ */
+TEST_F(WordCloudTest, WordCounting) {
+    blahajpi::utils::WordCloud wordCloud;
+    
+    blahajpi::utils::WordCounter counter;
+    wordCloud.countWords("the hate support\tcommunity  go hate", counter);
+    EXPECT_EQ(counter.count("hate"), 6);
+    EXPECT_EQ(counter.count("support"), 2);
+    EXPECT_EQ(counter.count("community"), 2);
+    EXPECT_EQ(counter.count("the"), 0);
+    EXPECT_EQ(counter.count("go"), 0);
+    auto top = counter.top(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].first, "hate");
+    EXPECT_EQ(top[1].first, "community");
+    
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < 5000; ++i) {
+        texts.push_back("frequent message number" + std::to_string(i) + (i % 2 ? " common" : ""));
+    }
+    auto sequential = wordCloud.countWords(texts);
+    auto sharded = wordCloud.countWords(texts, 4);
+    EXPECT_EQ(sharded.size(), sequential.size());
+    EXPECT_EQ(sharded.total(), sequential.total());
+    EXPECT_EQ(sharded.top(3), sequential.top(3));
+    
+    auto bounded = wordCloud.countWords(texts, 4, 8);
+    EXPECT_LT(bounded.size(), 16u);
+    EXPECT_EQ(bounded.total(), sequential.total());
+    auto heavy = bounded.top(3);
+    ASSERT_GE(heavy.size(), 3u);
+    EXPECT_EQ(heavy[0].first, "frequent");
+    EXPECT_EQ(heavy[1].first, "message");
+    EXPECT_EQ(heavy[2].first, "common");
+    EXPECT_GE(heavy[0].second, 5000 - sequential.total() / 9);
+}
+
+/**
+ * @test
+ * @brief Tests incremental aggregation of analysis results
+ * @ingroup word_cloud_tests
+ * 
+ * Verifies that results fed one at a time from several threads give the
+ * same cloud as the whole set at once, and that safe results are skipped.
+ */
+TEST_F(WordCloudTest, Aggregator) {
+    blahajpi::utils::CloudAggregator whole(true);
+    whole.add(std::span{analysisResults});
+    EXPECT_EQ(whole.getTextCount(), harmfulTexts.size());
+    EXPECT_EQ(whole.getCounts().count("harmful"), 3);
+    EXPECT_EQ(whole.getCounts().count("safe"), 0);
+    
+    blahajpi::utils::CloudAggregator incremental(true);
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < 4; ++t) {
+        producers.emplace_back([&, t]() {
+            for (size_t i = t; i < analysisResults.size(); i += 4) {
+                incremental.add(analysisResults[i]);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_EQ(incremental.getTextCount(), whole.getTextCount());
+    EXPECT_EQ(incremental.getCounts().top(10), whole.getCounts().top(10));
+    
+    blahajpi::utils::CloudConfig config;
+    config.useColor = false;
+    EXPECT_EQ(incremental.render(config), whole.render(config));
+    
+    incremental.clear();
+    EXPECT_EQ(incremental.getTextCount(), 0u);
+    EXPECT_EQ(incremental.getCounts().size(), 0u);
+}
+
 } // namespace